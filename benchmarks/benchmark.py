@@ -277,3 +277,213 @@ class Benchmark:
                 print()
 
         return times
+
+    def _find_computes(self):
+        """Find the freud computes held by this benchmark.
+
+        Returns:
+            dict: The :class:`freud.util._Compute` attributes, by name.
+        """
+        return {
+            name: value
+            for name, value in vars(self).items()
+            if isinstance(value, freud.util._Compute)
+        }
+
+    def run_phase_profile(self, N, number=1, num_threads=0):
+        """Measure the time spent in the phases of the benchmarked computes.
+
+        The computes must have been built with the ENABLE_PROFILING option,
+        otherwise only the time of the compute and output calls is measured.
+
+        Args:
+            N (int):
+                Size of the input.
+            number (int):
+                Number of times to call :py:meth:`~.bench_run`
+                (Default value = 1).
+            num_threads (int):
+                Number of threads to use. If 0, use all avaliable threads
+                (Default value = 0).
+
+        Returns:
+            dict: The average time per call of :py:meth:`~.bench_run` of each
+                phase, by the name of the compute attribute and the phase (in
+                seconds).
+        """
+        was_enabled = freud.util.is_profiling_enabled()
+        freud.util.set_profiling_enabled()
+        try:
+            self.bench_setup(N)
+            for _ in range(number):
+                self.bench_run_parallel(N, num_threads)
+        finally:
+            freud.util.set_profiling_enabled(was_enabled)
+
+        phases = {}
+        for name, compute in self._find_computes().items():
+            for phase, entry in compute.profile.items():
+                if entry["time"]:
+                    phases[f"{name}.{phase}"] = entry["time"] / number
+        return phases
+
+    def run_scaling_benchmark(
+        self,
+        N_list,
+        mode="strong",
+        threads=None,
+        number=1000,
+        print_stats=True,
+        repeat=1,
+    ):
+        """Strong or weak scaling benchmark.
+
+        Strong scaling runs each problem size :math:`N` with every number of
+        threads :math:`p`, and the parallel efficiency is
+        :math:`t_1 / (p t_p)`. Weak scaling grows the problem size with the
+        number of threads to :math:`p N`, and the parallel efficiency is
+        :math:`t_1 / t_p`. Besides the runtime, the peak resident set size of
+        every run and the time spent in the phases of the benchmarked computes
+        (see :py:meth:`~.run_phase_profile`) are recorded.
+
+        Like the size scaling benchmark, number is autoscaled down linearly
+        with problem size (down to a minimum of 1).
+
+        Args:
+            N_list (list of ints):
+                List of problem sizes :math:`N` to run.
+            mode (str):
+                Either :code:`'strong'` or :code:`'weak'`
+                (Default value = :code:`'strong'`).
+            threads (list of ints):
+                Numbers of threads to run, which must start with 1. If
+                :code:`None`, use the powers of two up to the number of cores,
+                or up to :code:`BENCHMARK_NPROC` if it is set
+                (Default value = :code:`None`).
+            number (int):
+                Number of times to call :py:meth:`~.bench_run` in case one run
+                takes too little time to be significant (Default value = 1000).
+            print_stats (bool):
+                Print stats to stdout (Default value = :code:`True`).
+            repeat (int):
+                Number of times to repeat time measurement of
+                :py:meth:`~.bench_run` (Default value = 1).
+
+        Returns:
+            list of dict: One result per number of threads and problem size,
+                with the keys :code:`threads`, :code:`base_N`, :code:`N`,
+                :code:`time` (in seconds), :code:`speedup`, :code:`efficiency`,
+                :code:`peak_rss` (in bytes, or :code:`None` if unknown) and
+                :code:`phases`.
+        """
+        if len(N_list) == 0:
+            raise TypeError("N_list must be iterable")
+        if mode not in ("strong", "weak"):
+            raise ValueError("mode must be either 'strong' or 'weak'")
+        if threads is None:
+            nprocs = int(os.environ.get("BENCHMARK_NPROC", multiprocessing.cpu_count()))
+            threads = [2**i for i in range(nprocs.bit_length())]
+            if threads[-1] != nprocs:
+                threads.append(nprocs)
+        if threads[0] != 1:
+            raise ValueError("threads must start with 1")
+
+        # compute benchmark size
+        size = number * N_list[0]
+
+        if print_stats:
+            print(f"{mode.capitalize()} scaling")
+            print("Threads ", end="")
+            for N in N_list:
+                print(f"{N:^28d}", end=" | ")
+            print()
+
+        results = []
+        serial_times = {}
+        for num_threads in threads:
+            if print_stats:
+                print(f"{num_threads:7d}", end=" ")
+
+            for base_N in N_list:
+                N = base_N * num_threads if mode == "weak" else base_N
+                current_number = max(int(size // N), 1)
+
+                _reset_peak_rss()
+                t = self.run_benchmark(
+                    N,
+                    number=current_number,
+                    print_stats=False,
+                    repeat=repeat,
+                    num_threads=num_threads,
+                )
+                peak_rss = _get_peak_rss()
+                phases = self.run_phase_profile(N, num_threads=num_threads)
+
+                if num_threads == 1:
+                    serial_times[base_N] = t
+                speedup = serial_times[base_N] / t
+                if mode == "strong":
+                    efficiency = speedup / num_threads
+                else:
+                    efficiency = speedup
+                results.append(
+                    {
+                        "threads": num_threads,
+                        "base_N": base_N,
+                        "N": N,
+                        "time": t,
+                        "speedup": speedup,
+                        "efficiency": efficiency,
+                        "peak_rss": peak_rss,
+                        "phases": phases,
+                    }
+                )
+
+                if print_stats:
+                    print(
+                        f"{t * 1000:8.3f} ms {speedup:7.2f}x {efficiency:7.1%}",
+                        end=" | ",
+                    )
+                    sys.stdout.flush()
+
+            if print_stats:
+                print()
+
+        return results
+
+
+def _reset_peak_rss():
+    """Reset the peak resident set size of this process, where supported.
+
+    Linux resets the peak when "5" is written to /proc/self/clear_refs, which
+    lets every run of a scaling benchmark report its own peak rather than the
+    largest peak of the process so far.
+    """
+    try:
+        with open("/proc/self/clear_refs", "w") as f:
+            f.write("5")
+    except OSError:
+        pass
+
+
+def _get_peak_rss():
+    """Get the peak resident set size of this process.
+
+    Returns:
+        int: The peak resident set size (in bytes), or :code:`None` if it
+            cannot be determined on this platform.
+    """
+    try:
+        with open("/proc/self/status") as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1]) * 1024
+    except OSError:
+        pass
+    try:
+        import resource
+    except ImportError:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # ru_maxrss is in bytes on macOS and in kilobytes elsewhere.
+    return peak if sys.platform == "darwin" else peak * 1024
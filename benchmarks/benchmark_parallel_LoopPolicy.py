@@ -0,0 +1,63 @@
+import numpy as np
+from benchmark import Benchmark
+from benchmarker import run_benchmarks
+
+import freud
+
+
+class BenchmarkParallelLoopPolicy(Benchmark):
+    def __init__(self, partitioner, grain_size, r_max, diameter):
+        self.partitioner = partitioner
+        self.grain_size = grain_size
+        self.r_max = r_max
+        self.diameter = diameter
+
+    def bench_setup(self, N):
+        # An interface between a dense slab holding most of the points and a
+        # dilute gas, so that the numbers of neighbors of the points in the
+        # loop of LocalDensity are very uneven.
+        self.box_size = self.r_max * 6
+        np.random.seed(0)
+        self.points = (
+            np.random.random_sample((N, 3)).astype(np.float32) * self.box_size
+            - self.box_size / 2
+        )
+        num_dense = 9 * N // 10
+        self.points[:num_dense, 0] *= 0.1
+        self.points = self.points[np.argsort(self.points[:, 2])]
+        self.box = freud.box.Box.cube(self.box_size)
+        self.ld = freud.density.LocalDensity(self.r_max, self.diameter)
+        self.nq = freud.locality.AABBQuery(self.box, self.points)
+
+    def bench_run(self, N):
+        restore_policy = freud.parallel.get_loop_policy()
+        freud.parallel.set_loop_policy(self.partitioner, self.grain_size)
+        try:
+            self.ld.compute(self.nq)
+        finally:
+            freud.parallel.set_loop_policy(*restore_policy)
+
+
+def run(partitioner="simple", grain_size=16):
+    Ns = [1000, 10000]
+    r_max = 2.0
+    diameter = 1.0
+    number = 100
+    name = "freud.parallel.set_loop_policy"
+    classobj = BenchmarkParallelLoopPolicy
+
+    return run_benchmarks(
+        name,
+        Ns,
+        number,
+        classobj,
+        partitioner=partitioner,
+        grain_size=grain_size,
+        r_max=r_max,
+        diameter=diameter,
+    )
+
+
+if __name__ == "__main__":
+    for partitioner, grain_size in [("auto", 1), ("simple", 16), ("static", 1)]:
+        run(partitioner, grain_size)
@@ -6,6 +6,11 @@ import sys
 
 import git
 
+# Options of the scaling subcommand. When set, run_benchmarks runs a scaling
+# benchmark with these options instead of the size and thread scaling
+# benchmarks.
+_scaling_options = None
+
 
 def get_report_filename(filename):
     """Function to get the directory to save benchmark report.
@@ -88,6 +93,26 @@ def run_benchmarks(name, Ns, number, classobj, print_stats=True, **kwargs):
 
     # run benchmark with repeat
     repeat = 5
+    if _scaling_options is not None:
+        scaling = b.run_scaling_benchmark(
+            Ns,
+            number=number,
+            print_stats=print_stats,
+            repeat=repeat,
+            **_scaling_options,
+        )
+
+        if print_stats:
+            print("\n ----------------")
+
+        return {
+            "name": name,
+            "params": kwargs,
+            "Ns": Ns,
+            "mode": _scaling_options["mode"],
+            "scaling": scaling,
+        }
+
     ssr = b.run_size_scaling_benchmark(Ns, number, print_stats, repeat)
     tsr = b.run_thread_scaling_benchmark(Ns, number, print_stats, repeat)
 
@@ -137,6 +162,26 @@ def print_benchmark_results_in_human_readable_way(data):
         bdesc = benchmark_desc(bresult["name"], bresult["params"])
         print(bdesc)
 
+        # print scaling benchmark
+        if "scaling" in bresult:
+            print("{} scaling".format(bresult["mode"].capitalize()))
+            print("Threads ", end="")
+            for N in bresult["Ns"]:
+                print(f"{N:^28d}", end=" | ")
+            print()
+            for r in bresult["scaling"]:
+                if r["base_N"] == bresult["Ns"][0]:
+                    print("{:7d}".format(r["threads"]), end=" ")
+                print(
+                    "{:8.3f} ms {:7.2f}x {:7.1%}".format(
+                        r["time"] / 1e-3, r["speedup"], r["efficiency"]
+                    ),
+                    end=" | ",
+                )
+                if r["base_N"] == bresult["Ns"][-1]:
+                    print()
+            continue
+
         # print size scaling benchmark
         for N, r in bresult["size_scale"].items():
             N = int(N)
@@ -263,6 +308,25 @@ def main_run(args):
     save_benchmark_result(results, args.output)
 
 
+def main_scaling(args):
+    """Function to run scaling benchmarks.
+
+    Run the benchmarks of :func:`main_run` as strong or weak scaling
+    benchmarks.
+
+    """
+    global _scaling_options
+    _scaling_options = {"mode": args.mode, "threads": args.threads}
+
+    # The benchmark modules call run_benchmarks of the benchmarker module,
+    # which is a different module object than this script when it is run
+    # directly.
+    if __name__ == "__main__":
+        importlib.import_module("benchmarker")._scaling_options = _scaling_options
+
+    main_run(args)
+
+
 def main_compare(args):
     """Function to compare benchmark results.
 
@@ -339,6 +403,24 @@ def main_compare(args):
                 )
                 print()
 
+                # compare scaling behavior
+                if "scaling" in this_res:
+                    if this_res.get("mode") != other_res.get("mode"):
+                        print("Scaling modes differ, not comparing")
+                        continue
+                    other_times = {
+                        (r["threads"], r["base_N"]): r["time"]
+                        for r in other_res["scaling"]
+                    }
+                    for r in this_res["scaling"]:
+                        key = (r["threads"], r["base_N"])
+                        if key in other_times:
+                            compare_helper(
+                                r["time"], other_times[key], r["N"], r["threads"]
+                            )
+                    print("\n ----------------")
+                    continue
+
                 # compare size scaling behavior
                 for N in this_res["Ns"]:
                     N = str(N)
@@ -388,6 +470,39 @@ if __name__ == "__main__":
     )
     parser_run.set_defaults(func=main_run)
 
+    parser_scaling = subparsers.add_parser(
+        name="scaling",
+        description="Execute strong or weak scaling tests, recording the "
+        "parallel efficiency, the peak memory usage and the time spent in the "
+        "phases of the computes. Phase timings require freud to be built with "
+        "the ENABLE_PROFILING option.",
+    )
+    parser_scaling.add_argument(
+        "-o",
+        "--output",
+        nargs="?",
+        default="scaling.json",
+        help="Specify which collection file to store results "
+        "to, default='scaling.json'.",
+    )
+    parser_scaling.add_argument(
+        "-m",
+        "--mode",
+        choices=["strong", "weak"],
+        default="strong",
+        help="Keep the problem size fixed (strong) or grow it with the "
+        "number of threads (weak), default='strong'.",
+    )
+    parser_scaling.add_argument(
+        "-t",
+        "--threads",
+        type=int,
+        nargs="+",
+        help="Numbers of threads to run, starting with 1, default are the "
+        "powers of two up to the number of cores.",
+    )
+    parser_scaling.set_defaults(func=main_scaling)
+
     parser_report = subparsers.add_parser(
         name="report", description="Display results from previous runs."
     )
@@ -0,0 +1,119 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BENCHMARK_SYSTEM_H
+#define BENCHMARK_SYSTEM_H
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Box.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+#include "tbb_config.h"
+
+/*! \file BenchmarkSystem.h
+    \brief Systems and parameters shared by the C++ microbenchmarks.
+
+    The benchmark arguments are integers, so fractional parameters are
+    passed in hundredths: a density argument of 50 is a number density of
+    0.5 and a cutoff argument of 250 is a cutoff of 2.5.
+*/
+
+namespace freud { namespace benchmarks {
+
+//! Convert an argument given in hundredths into its value.
+inline float fromHundredths(int64_t argument)
+{
+    return static_cast<float>(argument) / float(100.0);
+}
+
+//! Uniformly random points in a periodic cubic box.
+struct RandomSystem
+{
+    //! Constructor
+    /*! \param num_points Number of points.
+     *  \param density Number density of the points.
+     *  \param seed Seed of the random number generator.
+     */
+    RandomSystem(unsigned int num_points, float density, unsigned int seed = 0)
+        : box(std::cbrt(static_cast<float>(num_points) / density)), points(num_points)
+    {
+        std::mt19937 rng(seed);
+        const float half_length = box.getLx() / float(2.0);
+        std::uniform_real_distribution<float> position(-half_length, half_length);
+        for (auto& point : points)
+        {
+            point = vec3<float>(position(rng), position(rng), position(rng));
+        }
+    }
+
+    box::Box box;                    //!< Simulation box
+    std::vector<vec3<float>> points; //!< Positions of the points
+};
+
+//! Query arguments of a ball query that excludes the query points themselves.
+inline locality::QueryArgs ballQuery(float r_max)
+{
+    locality::QueryArgs qargs;
+    qargs.mode = locality::QueryType::ball;
+    qargs.r_max = r_max;
+    qargs.exclude_ii = true;
+    return qargs;
+}
+
+//! Limits the number of threads of freud for the lifetime of this object.
+class ThreadLimit
+{
+public:
+    //! Constructor
+    /*! \param num_threads Number of threads, or 0 for all threads.
+     */
+    explicit ThreadLimit(int64_t num_threads)
+    {
+        parallel::setNumThreads(static_cast<unsigned int>(num_threads));
+    }
+
+    //! Destructor, restores the default number of threads.
+    ~ThreadLimit()
+    {
+        parallel::setNumThreads(0);
+    }
+
+    ThreadLimit(const ThreadLimit&) = delete;
+    ThreadLimit& operator=(const ThreadLimit&) = delete;
+};
+
+//! Numbers of threads of all benchmarks, where 0 is all threads of the machine.
+const std::vector<int64_t> THREAD_COUNTS = {1, 0};
+
+//! Numbers of points of all benchmarks.
+const std::vector<int64_t> POINT_COUNTS = {1000, 10000, 100000};
+
+//! Number densities of all benchmarks, in hundredths.
+const std::vector<int64_t> DENSITIES = {10, 100};
+
+//! Arguments: number of points, density, cutoff and number of threads.
+inline void neighborQueryArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"N", "density", "r_max", "threads"})
+        ->ArgsProduct({POINT_COUNTS, DENSITIES, {150, 300}, THREAD_COUNTS})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+}
+
+//! Arguments: number of points, density and number of threads.
+inline void systemArguments(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"N", "density", "threads"})
+        ->ArgsProduct({POINT_COUNTS, DENSITIES, THREAD_COUNTS})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+}
+
+}; }; // end namespace freud::benchmarks
+
+#endif // BENCHMARK_SYSTEM_H
@@ -0,0 +1,37 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include "AABBQuery.h"
+#include "BenchmarkSystem.h"
+#include "Cluster.h"
+
+/*! \file benchmark_cluster.cc
+    \brief Benchmarks of the cluster finding.
+*/
+
+namespace freud { namespace benchmarks {
+
+namespace {
+
+//! Find the clusters of points closer than the cutoff.
+void BM_Cluster(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    cluster::Cluster cluster;
+    for (auto _ : state)
+    {
+        cluster.compute(&aq, nullptr, ballQuery(r_max));
+        benchmark::DoNotOptimize(cluster.getNumClusters());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["clusters"] = static_cast<double>(cluster.getNumClusters());
+}
+
+}; // end anonymous namespace
+
+BENCHMARK(BM_Cluster)->Apply(neighborQueryArguments);
+
+}; }; // end namespace freud::benchmarks
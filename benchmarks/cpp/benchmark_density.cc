@@ -0,0 +1,82 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include "AABBQuery.h"
+#include "BenchmarkSystem.h"
+#include "GaussianDensity.h"
+#include "RDF.h"
+
+/*! \file benchmark_density.cc
+    \brief Benchmarks of the bond histogram accumulation and reduction of RDF and of GaussianDensity.
+*/
+
+namespace freud { namespace benchmarks {
+
+namespace {
+
+//! Number of bins of the RDF histograms
+constexpr unsigned int RDF_BINS = 100;
+
+//! Accumulate the bonds of one frame into the histogram of an RDF.
+void BM_RDFAccumulate(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    density::RDF rdf(RDF_BINS, r_max);
+    for (auto _ : state)
+    {
+        rdf.accumulate(&aq, system.points.data(), system.points.size(), nullptr, ballQuery(r_max));
+    }
+    benchmark::DoNotOptimize(rdf.getBinCounts().get());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Reduce the thread local histograms of an RDF after accumulating one frame.
+void BM_RDFReduce(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), float(1.0));
+    const auto bins = static_cast<unsigned int>(state.range(1));
+    const ThreadLimit threads(state.range(2));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    const float r_max(2.0);
+    density::RDF rdf(bins, r_max);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        rdf.reset();
+        rdf.accumulate(&aq, system.points.data(), system.points.size(), nullptr, ballQuery(r_max));
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(rdf.getRDF().get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+//! Compute a GaussianDensity on a grid of 64 cells per side.
+void BM_GaussianDensity(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    density::GaussianDensity gd(vec3<unsigned int>(64, 64, 64), r_max, r_max / float(3.0));
+    for (auto _ : state)
+    {
+        gd.compute(&aq);
+        benchmark::DoNotOptimize(gd.getDensity().get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}; // end anonymous namespace
+
+BENCHMARK(BM_RDFAccumulate)->Apply(neighborQueryArguments);
+BENCHMARK(BM_RDFReduce)
+    ->ArgNames({"N", "bins", "threads"})
+    ->ArgsProduct({POINT_COUNTS, {100, 10000}, THREAD_COUNTS})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_GaussianDensity)->Apply(neighborQueryArguments);
+
+}; }; // end namespace freud::benchmarks
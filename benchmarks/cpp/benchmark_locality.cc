@@ -0,0 +1,88 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+
+#include "AABBQuery.h"
+#include "BenchmarkSystem.h"
+#include "LinkCell.h"
+#include "Voronoi.h"
+
+/*! \file benchmark_locality.cc
+    \brief Benchmarks of building and querying neighbor queries and of the Voronoi diagram.
+*/
+
+namespace freud { namespace benchmarks {
+
+namespace {
+
+//! Build a LinkCell with cells as wide as the cutoff.
+void BM_LinkCellBuild(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    for (auto _ : state)
+    {
+        locality::LinkCell lc(system.box, system.points.data(), system.points.size(), r_max);
+        benchmark::DoNotOptimize(lc.getNumCells());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Build an AABBQuery.
+void BM_AABBQueryBuild(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const ThreadLimit threads(state.range(2));
+    for (auto _ : state)
+    {
+        locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+        benchmark::DoNotOptimize(&aq);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Find the NeighborList of all points with a ball query.
+template<typename NeighborQueryType> void BM_BallQuery(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    const NeighborQueryType nq(system.box, system.points.data(), system.points.size());
+    size_t num_bonds = 0;
+    for (auto _ : state)
+    {
+        std::unique_ptr<locality::NeighborList> nlist(
+            nq.query(system.points.data(), system.points.size(), ballQuery(r_max))->toNeighborList());
+        num_bonds = nlist->getNumBonds();
+        benchmark::DoNotOptimize(num_bonds);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bonds"] = static_cast<double>(num_bonds);
+}
+
+//! Compute the Voronoi diagram.
+void BM_Voronoi(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const ThreadLimit threads(state.range(2));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    locality::Voronoi voronoi;
+    for (auto _ : state)
+    {
+        voronoi.compute(&aq, false);
+        benchmark::DoNotOptimize(voronoi.getVolumes().get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}; // end anonymous namespace
+
+BENCHMARK(BM_LinkCellBuild)->Apply(neighborQueryArguments);
+BENCHMARK(BM_AABBQueryBuild)->Apply(systemArguments);
+BENCHMARK_TEMPLATE(BM_BallQuery, locality::LinkCell)->Apply(neighborQueryArguments);
+BENCHMARK_TEMPLATE(BM_BallQuery, locality::AABBQuery)->Apply(neighborQueryArguments);
+BENCHMARK(BM_Voronoi)->Apply(systemArguments);
+
+}; }; // end namespace freud::benchmarks
@@ -0,0 +1,37 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include "AABBQuery.h"
+#include "BenchmarkSystem.h"
+#include "Steinhardt.h"
+
+/*! \file benchmark_order.cc
+    \brief Benchmarks of the Steinhardt order parameters.
+*/
+
+namespace freud { namespace benchmarks {
+
+namespace {
+
+//! Compute the Steinhardt q6 order parameter, or w6 if the template argument is true.
+template<bool wl> void BM_Steinhardt(benchmark::State& state)
+{
+    const RandomSystem system(state.range(0), fromHundredths(state.range(1)));
+    const float r_max = fromHundredths(state.range(2));
+    const ThreadLimit threads(state.range(3));
+    const locality::AABBQuery aq(system.box, system.points.data(), system.points.size());
+    order::Steinhardt steinhardt(std::vector<unsigned int> {6}, false, wl);
+    for (auto _ : state)
+    {
+        steinhardt.compute(nullptr, &aq, ballQuery(r_max));
+        benchmark::DoNotOptimize(steinhardt.getQl().get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}; // end anonymous namespace
+
+BENCHMARK_TEMPLATE(BM_Steinhardt, false)->Apply(neighborQueryArguments);
+BENCHMARK_TEMPLATE(BM_Steinhardt, true)->Apply(neighborQueryArguments);
+
+}; }; // end namespace freud::benchmarks
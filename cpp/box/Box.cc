@@ -0,0 +1,283 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Box.h"
+
+/*! \file Box.cc
+    \brief Batched kernels for wrapping vectors into simulation boxes.
+*/
+
+namespace freud { namespace box {
+
+//! Compute util::modulusPositive(a, 1) with operations that vectorize
+/*! Both fmod operations of modulusPositive reduce to subtracting the
+ *  truncated value, which is exact in floating point arithmetic, so the
+ *  result is identical. The truncation requires |a| < 2^31.
+ */
+inline float wrapUnit(float a)
+{
+    a -= static_cast<float>(static_cast<int>(a));
+    a += float(1.0);
+    return a - static_cast<float>(static_cast<int>(a));
+}
+
+//! Wrap vectors into the box, with the periodicity fixed at compile time
+/*! The operations match Box::makeFractional and Box::makeAbsolute as used by
+ *  Box::wrap, so the results are identical to wrapping each vector on its own.
+ */
+template<bool periodic_x, bool periodic_y, bool periodic_z, bool is2D>
+inline void wrapKernel(float* __restrict x, float* __restrict y, float* __restrict z, size_t n,
+                       const vec3<float> lo, const vec3<float> L, const float xy, const float xz,
+                       const float yz)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const float vx = x[i];
+        const float vy = y[i];
+        const float vz = z[i];
+
+        float fx = vx - lo.x;
+        float fy = vy - lo.y;
+        fx -= (xz - yz * xy) * vz + xy * vy;
+        fy -= yz * vz;
+        fx = fx / L.x;
+        fy = fy / L.y;
+        float fz = is2D ? float(0.0) : (vz - lo.z) / L.z;
+
+        if (periodic_x)
+        {
+            fx = wrapUnit(fx);
+        }
+        if (periodic_y)
+        {
+            fy = wrapUnit(fy);
+        }
+        if (periodic_z && !is2D)
+        {
+            fz = wrapUnit(fz);
+        }
+
+        float ax = lo.x + fx * L.x;
+        float ay = lo.y + fy * L.y;
+        const float az = lo.z + fz * L.z;
+        ax += xy * ay + xz * az;
+        ay += yz * az;
+
+        x[i] = ax;
+        y[i] = ay;
+        z[i] = is2D ? float(0.0) : az;
+    }
+}
+
+template<bool periodic_x, bool periodic_y>
+inline void wrapKernel(bool periodic_z, bool is2D, float* x, float* y, float* z, size_t n,
+                       const vec3<float>& lo, const vec3<float>& L, float xy, float xz, float yz)
+{
+    if (is2D)
+    {
+        wrapKernel<periodic_x, periodic_y, false, true>(x, y, z, n, lo, L, xy, xz, yz);
+    }
+    else if (periodic_z)
+    {
+        wrapKernel<periodic_x, periodic_y, true, false>(x, y, z, n, lo, L, xy, xz, yz);
+    }
+    else
+    {
+        wrapKernel<periodic_x, periodic_y, false, false>(x, y, z, n, lo, L, xy, xz, yz);
+    }
+}
+
+FREUD_SIMD_CLONES
+void wrapBatchKernel(const vec3<bool> periodic, bool is2D, float* x, float* y, float* z, size_t n,
+                     const vec3<float> lo, const vec3<float> L, float xy, float xz, float yz)
+{
+    if (periodic.x)
+    {
+        if (periodic.y)
+        {
+            wrapKernel<true, true>(periodic.z, is2D, x, y, z, n, lo, L, xy, xz, yz);
+        }
+        else
+        {
+            wrapKernel<true, false>(periodic.z, is2D, x, y, z, n, lo, L, xy, xz, yz);
+        }
+    }
+    else
+    {
+        if (periodic.y)
+        {
+            wrapKernel<false, true>(periodic.z, is2D, x, y, z, n, lo, L, xy, xz, yz);
+        }
+        else
+        {
+            wrapKernel<false, false>(periodic.z, is2D, x, y, z, n, lo, L, xy, xz, yz);
+        }
+    }
+}
+
+void Box::wrapBatch(float* x, float* y, float* z, size_t n) const
+{
+    // Return quickly if the box is aperiodic
+    if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+    {
+        return;
+    }
+    wrapBatchKernel(m_periodic, m_2d, x, y, z, n, m_lo, m_L, m_xy, m_xz, m_yz);
+}
+
+namespace {
+
+//! Number of vectors wrapped at once by wrapFrames
+constexpr size_t WRAP_TILE_SIZE = 256;
+
+//! Apply a function to every vector of a stack of frames in parallel
+/*! The parallel loop runs over all vectors of all frames, and each block is
+ *  split at the boundaries of the frames so that the box of a frame is copied
+ *  once per block rather than once per vector.
+ *
+ *  \param boxes The box of each frame.
+ *  \param Nframes Number of frames.
+ *  \param Nvecs Number of vectors in each frame.
+ *  \param body An object with operator()(const Box& box, size_t i), where i
+ *              is the index of the vector in the whole stack.
+ */
+template<typename Body>
+void forEachFrameVector(const Box* boxes, unsigned int Nframes, unsigned int Nvecs, const Body& body)
+{
+    if (Nvecs == 0)
+    {
+        return;
+    }
+    util::forLoopWrapper(0, static_cast<size_t>(Nframes) * Nvecs, [&](size_t begin, size_t end) {
+        while (begin < end)
+        {
+            const size_t frame = begin / Nvecs;
+            const size_t frame_end = std::min(end, (frame + 1) * Nvecs);
+            const Box box(boxes[frame]);
+            for (size_t i = begin; i < frame_end; ++i)
+            {
+                body(box, i);
+            }
+            begin = frame_end;
+        }
+    });
+}
+
+//! Round a difference of fractional coordinates to the nearest number of boxes
+inline int countImages(float delta)
+{
+    return static_cast<int>(std::round(delta));
+}
+
+}; // end anonymous namespace
+
+void makeAbsoluteFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                        vec3<float>* out)
+{
+    forEachFrameVector(boxes, Nframes, Nvecs,
+                       [=](const Box& box, size_t i) { out[i] = box.makeAbsolute(vecs[i]); });
+}
+
+void makeFractionalFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                          vec3<float>* out)
+{
+    forEachFrameVector(boxes, Nframes, Nvecs,
+                       [=](const Box& box, size_t i) { out[i] = box.makeFractional(vecs[i]); });
+}
+
+void getImagesFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                     vec3<int>* res)
+{
+    forEachFrameVector(boxes, Nframes, Nvecs,
+                       [=](const Box& box, size_t i) { box.getImage(vecs[i], res[i]); });
+}
+
+void wrapFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                vec3<float>* out)
+{
+    if (Nvecs == 0)
+    {
+        return;
+    }
+    // The vectors are copied into coordinate arrays in small tiles so that
+    // they can be wrapped by the vectorized kernel of Box::wrapBatch.
+    util::forLoopWrapper(0, static_cast<size_t>(Nframes) * Nvecs, [&](size_t begin, size_t end) {
+        float x[WRAP_TILE_SIZE];
+        float y[WRAP_TILE_SIZE];
+        float z[WRAP_TILE_SIZE];
+        while (begin < end)
+        {
+            const size_t frame = begin / Nvecs;
+            const size_t tile_end = std::min({end, (frame + 1) * Nvecs, begin + WRAP_TILE_SIZE});
+            const size_t n = tile_end - begin;
+            for (size_t j = 0; j < n; ++j)
+            {
+                x[j] = vecs[begin + j].x;
+                y[j] = vecs[begin + j].y;
+                z[j] = vecs[begin + j].z;
+            }
+            boxes[frame].wrapBatch(x, y, z, n);
+            for (size_t j = 0; j < n; ++j)
+            {
+                out[begin + j] = vec3<float>(x[j], y[j], z[j]);
+            }
+            begin = tile_end;
+        }
+    });
+}
+
+void unwrapFrames(const Box* boxes, const vec3<float>* vecs, const vec3<int>* images, unsigned int Nframes,
+                  unsigned int Nvecs, vec3<float>* out)
+{
+    forEachFrameVector(boxes, Nframes, Nvecs,
+                       [=](const Box& box, size_t i) { out[i] = box.unwrap(vecs[i], images[i]); });
+}
+
+void unwrapTrajectory(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                      const vec3<int>* initial_images, vec3<int>* images, vec3<float>* out)
+{
+    if (Nframes == 0)
+    {
+        return;
+    }
+    util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            // The fractional coordinates, image flags and unwrapped vector of
+            // each frame are found in one pass, so every vector is only read
+            // once and every output is only written once.
+            vec3<int> image = initial_images == nullptr ? vec3<int>(0, 0, 0) : initial_images[i];
+            vec3<float> last_frac = boxes[0].makeFractional(vecs[i]);
+            images[i] = image;
+            out[i] = boxes[0].unwrap(vecs[i], image);
+
+            for (size_t frame = 1; frame < Nframes; ++frame)
+            {
+                const Box& box = boxes[frame];
+                const size_t idx = frame * Nvecs + i;
+                const vec3<float> frac = box.makeFractional(vecs[idx]);
+                const vec3<bool> periodic = box.getPeriodic();
+                if (periodic.x)
+                {
+                    image.x -= countImages(frac.x - last_frac.x);
+                }
+                if (periodic.y)
+                {
+                    image.y -= countImages(frac.y - last_frac.y);
+                }
+                if (periodic.z && !box.is2D())
+                {
+                    image.z -= countImages(frac.z - last_frac.z);
+                }
+                images[idx] = image;
+                out[idx] = box.unwrap(vecs[idx], image);
+                last_frac = frac;
+            }
+        }
+    });
+}
+
+}; }; // end namespace freud::box
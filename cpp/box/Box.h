@@ -9,6 +9,7 @@
 #include <complex>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include "VectorMath.h"
 
@@ -332,6 +333,34 @@ public:
         return makeAbsolute(v_frac);
     }
 
+    //! Wrap a vector in the plane of a 2D box back into the box
+    /*! The result is identical to wrapping vec3<float>(v.x, v.y, 0), but the
+     *  terms of the z component are skipped. Must only be called on 2D boxes.
+     *
+     *  \param v Vector to wrap, updated to the minimum image obeying the periodic settings
+     *  \returns Wrapped vector
+     */
+    vec2<float> wrap(const vec2<float>& v) const
+    {
+        // Return quickly if the box is aperiodic, like the 3D wrap
+        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        {
+            return v;
+        }
+
+        vec2<float> f((v.x - m_lo.x - m_xy * v.y) / m_L.x, (v.y - m_lo.y) / m_L.y);
+        if (m_periodic.x)
+        {
+            f.x = util::modulusPositive(f.x, float(1.0));
+        }
+        if (m_periodic.y)
+        {
+            f.y = util::modulusPositive(f.y, float(1.0));
+        }
+        const float y = m_lo.y + f.y * m_L.y;
+        return {m_lo.x + f.x * m_L.x + m_xy * y, y};
+    }
+
     //! Wrap vectors back into the box in place
     /*! \param vecs Vectors to wrap, updated to the minimum image obeying the periodic settings
      *  \param Nvecs Number of vectors
@@ -347,6 +376,34 @@ public:
         });
     }
 
+    //! Wrap vectors stored as separate coordinate arrays back into the box in place
+    /*! The vectors are processed by a kernel compiled for the widest vector
+     *  instruction set supported by the running CPU, with results identical
+     *  to calling wrap on each vector. Unlike the other array methods, this
+     *  method runs serially so that it can be called inside parallel loops.
+     *
+     *  \param x Array of x coordinates, updated to the minimum image obeying the periodic settings
+     *  \param y Array of y coordinates, updated to the minimum image obeying the periodic settings
+     *  \param z Array of z coordinates, updated to the minimum image obeying the periodic settings
+     *  \param Nvecs Number of vectors
+     */
+    void wrapBatch(float* x, float* y, float* z, size_t Nvecs) const;
+
+    //! Unwrap a single vector to its absolute location
+    /*! \param v Vector of coordinates to unwrap
+     *  \param image Image flags of the vector
+     *  \returns The unwrapped vector
+     */
+    vec3<float> unwrap(const vec3<float>& v, const vec3<int>& image) const
+    {
+        vec3<float> out = v + getLatticeVector(0) * float(image.x) + getLatticeVector(1) * float(image.y);
+        if (!m_2d)
+        {
+            out += getLatticeVector(2) * float(image.z);
+        }
+        return out;
+    }
+
     //! Unwrap given positions to their absolute location in place
     /*! \param vecs Vectors of coordinates to unwrap
      *  \param images images flags for this point
@@ -358,12 +415,7 @@ public:
         util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
-                out[i] = vecs[i] + getLatticeVector(0) * float(images[i].x)
-                    + getLatticeVector(1) * float(images[i].y);
-                if (!m_2d)
-                {
-                    out[i] += getLatticeVector(2) * float(images[i].z);
-                }
+                out[i] = unwrap(vecs[i], images[i]);
             }
         });
     }
@@ -438,10 +490,17 @@ public:
             throw std::invalid_argument("The number of query points and points must match.");
         }
         util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            std::vector<float> x(end - begin);
+            std::vector<float> y(end - begin);
+            std::vector<float> z(end - begin);
             for (size_t i = begin; i < end; ++i)
             {
-                distances[i] = computeDistance(query_points[i], points[i]);
+                const vec3<float> r_ij = points[i] - query_points[i];
+                x[i - begin] = r_ij.x;
+                y[i - begin] = r_ij.y;
+                z[i - begin] = r_ij.z;
             }
+            computeBatchDistances(x.data(), y.data(), z.data(), end - begin, &distances[begin]);
         });
     }
 
@@ -458,12 +517,20 @@ public:
     {
         util::forLoopWrapper2D(
             0, n_query_points, 0, n_points, [&](size_t begin_n, size_t end_n, size_t begin_m, size_t end_m) {
+                std::vector<float> x(end_m - begin_m);
+                std::vector<float> y(end_m - begin_m);
+                std::vector<float> z(end_m - begin_m);
                 for (size_t i = begin_n; i < end_n; ++i)
                 {
                     for (size_t j = begin_m; j < end_m; ++j)
                     {
-                        distances[i * n_points + j] = computeDistance(query_points[i], points[j]);
+                        const vec3<float> r_ij = points[j] - query_points[i];
+                        x[j - begin_m] = r_ij.x;
+                        y[j - begin_m] = r_ij.y;
+                        z[j - begin_m] = r_ij.z;
                     }
+                    computeBatchDistances(x.data(), y.data(), z.data(), end_m - begin_m,
+                                          &distances[i * n_points + begin_m]);
                 }
             });
     }
@@ -600,6 +667,22 @@ public:
     }
 
 private:
+    //! Compute the minimum image lengths of vectors stored as separate coordinate arrays
+    /*! \param x Array of x coordinates, overwritten with the wrapped vectors
+     *  \param y Array of y coordinates, overwritten with the wrapped vectors
+     *  \param z Array of z coordinates, overwritten with the wrapped vectors
+     *  \param Nvecs Number of vectors
+     *  \param distances Array in which to place the lengths of the wrapped vectors
+     */
+    void computeBatchDistances(float* x, float* y, float* z, size_t Nvecs, float* distances) const
+    {
+        wrapBatch(x, y, z, Nvecs);
+        for (size_t i = 0; i < Nvecs; ++i)
+        {
+            distances[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        }
+    }
+
     vec3<float> m_lo;      //!< Minimum coords in the box
     vec3<float> m_hi;      //!< Maximum coords in the box
     vec3<float> m_L;       //!< L precomputed (used to avoid subtractions in boundary conditions)
@@ -611,6 +694,61 @@ private:
     bool m_2d;             //!< Specify whether box is 2D.
 };
 
+//! \name Operations on stacks of frames
+/*! These functions apply the array methods of Box to a stack of frames, each
+ *  with its own box. The vectors of frame f are vecs[f * Nvecs] through
+ *  vecs[(f + 1) * Nvecs - 1], and all vectors of all frames are processed in
+ *  a single parallel loop, so short frames do not limit the parallelism.
+ *  \param boxes The box of each frame.
+ *  \param Nframes Number of frames.
+ *  \param Nvecs Number of vectors in each frame.
+ */
+//!@{
+
+//! Convert the fractional coordinates of a stack of frames into absolute coordinates
+void makeAbsoluteFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                        vec3<float>* out);
+
+//! Convert the absolute coordinates of a stack of frames into fractional coordinates
+void makeFractionalFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                          vec3<float>* out);
+
+//! Get the periodic images of the vectors of a stack of frames
+void getImagesFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                     vec3<int>* res);
+
+//! Wrap the vectors of a stack of frames back into their boxes
+void wrapFrames(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                vec3<float>* out);
+
+//! Unwrap the vectors of a stack of frames with their image flags
+void unwrapFrames(const Box* boxes, const vec3<float>* vecs, const vec3<int>* images, unsigned int Nframes,
+                  unsigned int Nvecs, vec3<float>* out);
+
+//! Unwrap a trajectory by tracking the image flags of each vector across frames
+/*! The image flags of a vector change between consecutive frames whenever
+ *  its fractional coordinates jump by more than half of the box in a
+ *  periodic direction, which is taken as a crossing of that boundary of the
+ *  box. The fractional coordinates of each frame are computed in its own
+ *  box, so boxes which change shape between frames are supported as long as
+ *  no vector moves by half of the box between consecutive frames. Each vector
+ *  is processed through all frames by one thread, and the vectors are
+ *  processed in parallel.
+ *
+ *  \param boxes The box of each frame.
+ *  \param vecs Vectors of each frame, usually wrapped into the box.
+ *  \param Nframes Number of frames.
+ *  \param Nvecs Number of vectors in each frame.
+ *  \param initial_images Image flags of the vectors of the first frame, or
+ *                        nullptr if they are all zero.
+ *  \param images Array in which to place the image flags of each frame.
+ *  \param out Array in which to place the unwrapped vectors of each frame.
+ */
+void unwrapTrajectory(const Box* boxes, const vec3<float>* vecs, unsigned int Nframes, unsigned int Nvecs,
+                      const vec3<int>* initial_images, vec3<int>* images, vec3<float>* out);
+
+//!@}
+
 }; }; // end namespace freud::box
 
 #endif // BOX_H
@@ -2,16 +2,22 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <cstdint>
 #include <numeric>
+#include <tbb/parallel_sort.h>
 
 #include "Cluster.h"
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
 #include "dset/dset.h"
+#include "utils.h"
 
 //! Finds clusters using a network of neighbors.
 namespace freud { namespace cluster {
 
+//! Number of sorted points in each block of the prefix sum over clusters
+constexpr size_t CLUSTER_BLOCK_SIZE = 4096;
+
 void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
                       freud::locality::QueryArgs qargs, const unsigned int* keys)
 {
@@ -19,6 +25,8 @@ void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::loc
     m_cluster_idx.prepare(num_points);
     DisjointSets dj(num_points);
 
+    // The disjoint set supports concurrent calls to unite, so bonds are
+    // merged in parallel.
     freud::locality::loopOverNeighbors(
         nq, nq->getPoints(), num_points, qargs, nlist,
         [&dj](const freud::locality::NeighborBond& neighbor_bond) {
@@ -28,66 +36,140 @@ void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::loc
                 dj.unite(neighbor_bond.point_idx, neighbor_bond.query_point_idx);
             }
         });
+    labelClusters(dj, num_points, keys);
+}
 
-    // Done looping over points. All clusters are now determined.
-    // Next, we renumber clusters from zero to num_clusters-1.
-    // These new cluster indexes are then sorted by cluster size from largest
-    // to smallest, with equally-sized clusters sorted based on their minimum
-    // point index.
-    std::vector<size_t> cluster_label(num_points, num_points);
-    std::vector<size_t> cluster_label_count(num_points);
-    std::vector<size_t> cluster_min_id(num_points, num_points);
+freud::locality::FrameTask Cluster::makeFrameTask(unsigned int neighbors, const unsigned int* keys)
+{
+    return [this, neighbors, keys](const freud::locality::FrameContext& context) {
+        compute(context.neighbor_query, context.getNeighborList(neighbors), freud::locality::QueryArgs(),
+                keys);
+    };
+}
 
-    // Loop over every point.
-    m_num_clusters = 0;
-    for (size_t i = 0; i < num_points; i++)
-    {
-        size_t s = dj.find(i);
+void Cluster::computeFiltered(unsigned int num_points, const freud::locality::NeighborList* nlist,
+                              const bool* bond_filter, const unsigned int* keys)
+{
+    m_cluster_idx.prepare(num_points);
+    DisjointSets dj(num_points);
 
-        // Label this cluster if we haven't seen it yet.
-        if (cluster_label[s] == num_points)
+    const unsigned int* neighbors = nlist->getNeighbors().get();
+    util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
         {
-            // Label this cluster uniquely.
-            cluster_label[s] = m_num_clusters;
-            // Track the smallest point index in this cluster.
-            cluster_min_id[cluster_label[s]] = i;
-            // Increment the count of unique clusters.
-            m_num_clusters++;
+            const unsigned int i = neighbors[2 * bond];
+            const unsigned int j = neighbors[2 * bond + 1];
+            if (bond_filter[bond] && !dj.same(i, j))
+            {
+                dj.unite(i, j);
+            }
         }
+    });
+    labelClusters(dj, num_points, keys);
+}
 
-        // Increment the counter for this cluster label.
-        cluster_label_count[cluster_label[s]]++;
-    }
+void Cluster::labelClusters(const DisjointSets& dj, unsigned int num_points, const unsigned int* keys)
+{
+    // All clusters are now determined. Each point is packed with the root of
+    // its set into a single integer, so that sorting groups the points of
+    // each cluster in order of point index.
+    std::vector<uint64_t> sorted_points(num_points);
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            sorted_points[i] = (static_cast<uint64_t>(dj.find(i)) << 32) | i;
+        }
+    });
+    tbb::parallel_sort(sorted_points.begin(), sorted_points.end());
+    auto root_of = [&sorted_points](size_t p) { return sorted_points[p] >> 32; };
+    auto point_of = [&sorted_points](size_t p) { return static_cast<unsigned int>(sorted_points[p]); };
+
+    // Next, we renumber clusters from zero to num_clusters-1 in order of
+    // their set roots, using a prefix sum over the blocks of the number of
+    // clusters starting in each block. These labels are intermediate: the
+    // final order is set by the later sort by size and minimum point index.
+    const size_t num_blocks = (num_points + CLUSTER_BLOCK_SIZE - 1) / CLUSTER_BLOCK_SIZE;
+    std::vector<size_t> block_offsets(num_blocks + 1, 0);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t block_end = std::min((block + 1) * CLUSTER_BLOCK_SIZE, size_t(num_points));
+            for (size_t p = block * CLUSTER_BLOCK_SIZE; p < block_end; ++p)
+            {
+                if (p == 0 || root_of(p) != root_of(p - 1))
+                {
+                    ++block_offsets[block + 1];
+                }
+            }
+        }
+    });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+    m_num_clusters = block_offsets[num_blocks];
+
+    // The points of cluster i are found between cluster_starts i and i + 1
+    // of the sorted points.
+    std::vector<size_t> cluster_starts(m_num_clusters + 1, num_points);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            size_t cluster = block_offsets[block];
+            const size_t block_end = std::min((block + 1) * CLUSTER_BLOCK_SIZE, size_t(num_points));
+            for (size_t p = block * CLUSTER_BLOCK_SIZE; p < block_end; ++p)
+            {
+                if (p == 0 || root_of(p) != root_of(p - 1))
+                {
+                    cluster_starts[cluster++] = p;
+                }
+            }
+        }
+    });
 
-    // Resize label counts and min ids to the number of unique clusters found.
-    cluster_label_count.resize(m_num_clusters);
-    cluster_label_count.shrink_to_fit();
-    cluster_min_id.resize(m_num_clusters);
-    cluster_min_id.shrink_to_fit();
+    // These new cluster indexes are then sorted by cluster size from largest
+    // to smallest, with equally-sized clusters sorted based on their minimum
+    // point index.
+    std::vector<size_t> cluster_label_count(m_num_clusters);
+    std::vector<size_t> cluster_min_id(m_num_clusters);
+    util::forLoopWrapper(0, m_num_clusters, [&](size_t begin, size_t end) {
+        for (size_t cluster = begin; cluster < end; ++cluster)
+        {
+            cluster_label_count[cluster] = cluster_starts[cluster + 1] - cluster_starts[cluster];
+            cluster_min_id[cluster] = point_of(cluster_starts[cluster]);
+        }
+    });
 
     // Get a permutation that reorders clusters, largest to smallest.
     std::vector<size_t> cluster_reindex = sort_indexes_inverse(cluster_label_count, cluster_min_id);
 
-    // Clear the cluster keys
-    m_cluster_keys = std::vector<std::vector<unsigned int>>(m_num_clusters, std::vector<unsigned int>());
+    // The keys of each cluster are stored contiguously, in the new order of
+    // the clusters.
+    std::vector<size_t> cluster_sizes(m_num_clusters);
+    for (size_t cluster = 0; cluster < m_num_clusters; ++cluster)
+    {
+        cluster_sizes[cluster_reindex[cluster]] = cluster_label_count[cluster];
+    }
+    m_cluster_keys.prepare(cluster_sizes);
 
-    /* Loop over all points, set their cluster ids and add them to a list of
-     * sets. Each set contains all the keys that are part of that cluster. If
-     * no keys are provided, the keys use point ids. Get the computed list
-     * with getClusterKeys().
+    /* Loop over all points, set their cluster ids and add their keys to the
+     * keys of their cluster. If no keys are provided, the keys use point ids.
+     * Get the computed list with getClusterKeys().
      */
-    for (size_t i = 0; i < num_points; i++)
-    {
-        size_t s = dj.find(i);
-        size_t cluster_idx = cluster_reindex[cluster_label[s]];
-        m_cluster_idx[i] = cluster_idx;
-        unsigned int key = i;
-        if (keys != nullptr)
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        // Find the cluster of the first sorted point of this range.
+        size_t cluster = std::upper_bound(cluster_starts.begin(), cluster_starts.end(), begin)
+            - cluster_starts.begin() - 1;
+        for (size_t p = begin; p < end; ++p)
         {
-            key = keys[i];
+            while (p >= cluster_starts[cluster + 1])
+            {
+                ++cluster;
+            }
+            const unsigned int i = point_of(p);
+            const size_t cluster_idx = cluster_reindex[cluster];
+            m_cluster_idx[i] = cluster_idx;
+            m_cluster_keys.getSegment(cluster_idx)[p - cluster_starts[cluster]]
+                = (keys != nullptr) ? keys[i] : i;
         }
-        m_cluster_keys[cluster_idx].push_back(key);
-    }
+    });
 }
 
 // Returns inverse permutation of cluster indexes, sorted from largest to smallest.
@@ -99,8 +181,9 @@ std::vector<size_t> Cluster::sort_indexes_inverse(const std::vector<size_t>& cou
     std::vector<size_t> idx(counts.size());
     std::iota(idx.begin(), idx.end(), 0);
 
-    // Sort indexes based on comparing values in counts, min_ids.
-    std::sort(idx.begin(), idx.end(), [&counts, &min_ids](size_t i1, size_t i2) {
+    // Sort indexes based on comparing values in counts, min_ids. Since the
+    // minimum point ids are unique, the order is unique as well.
+    tbb::parallel_sort(idx.begin(), idx.end(), [&counts, &min_ids](size_t i1, size_t i2) {
         if (counts[i1] != counts[i2])
         {
             // If the counts are unequal, return the largest cluster first.
@@ -113,10 +196,12 @@ std::vector<size_t> Cluster::sort_indexes_inverse(const std::vector<size_t>& cou
 
     // Invert the permutation.
     std::vector<size_t> inv_idx(idx.size());
-    for (size_t i = 0; i < idx.size(); i++)
-    {
-        inv_idx[idx[i]] = i;
-    }
+    util::forLoopWrapper(0, idx.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            inv_idx[idx[i]] = i;
+        }
+    });
     return inv_idx;
 }
 
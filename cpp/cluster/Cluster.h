@@ -6,15 +6,19 @@
 
 #include <vector>
 
+#include "AnalysisGraph.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "RaggedArray.h"
 #include "VectorMath.h"
 
 /*! \file Cluster.h
     \brief Routines for clustering points.
 */
 
+class DisjointSets;
+
 namespace freud { namespace cluster {
 //! Finds clusters using a network of neighbors.
 /*! Given a set of points and their neighbors, freud.cluster.Cluster will
@@ -36,6 +40,12 @@ namespace freud { namespace cluster {
  *  cluster_keys, as a list of lists. If keys are not provided, every point is
  *  assigned a key corresponding to its index, and cluster_keys contains the
  *  point ids present in each cluster.
+ *
+ *  All steps of the computation run in parallel. Bonds are merged
+ *  concurrently into a lock-free disjoint set, and the points are then sorted
+ *  by the root of their set, which groups the points of each cluster in order
+ *  of point index. Clusters are labeled by a prefix sum over the boundaries
+ *  of these groups, and their keys are stored in a RaggedArray.
  */
 class Cluster
 {
@@ -47,6 +57,26 @@ public:
     void compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs, const unsigned int* keys = nullptr);
 
+    //! Get a task computing the clusters formed by a neighbor node of an AnalysisGraph
+    /*! \param neighbors The neighbor node of the bonds.
+     *  \param keys The key of each point, or NULL to use point ids. The keys
+     *              are used for every frame, which must all have as many
+     *              points as there are keys.
+     */
+    freud::locality::FrameTask makeFrameTask(unsigned int neighbors, const unsigned int* keys = nullptr);
+
+    //! Compute the point clusters formed by the bonds of a NeighborList that pass a filter.
+    /*! The bonds are merged directly from the NeighborList, so no filtered
+     *  NeighborList is built.
+     *
+     *  \param num_points The number of points.
+     *  \param nlist The NeighborList of the bonds.
+     *  \param bond_filter Whether each bond of nlist joins the clusters of its points.
+     *  \param keys The key of each point, or NULL to use point ids.
+     */
+    void computeFiltered(unsigned int num_points, const freud::locality::NeighborList* nlist,
+                         const bool* bond_filter, const unsigned int* keys = nullptr);
+
     //! Get the total number of clusters.
     unsigned int getNumClusters() const
     {
@@ -59,16 +89,19 @@ public:
         return m_cluster_idx;
     }
 
-    //! Get a reference to the cluster keys.
-    const std::vector<std::vector<unsigned int>>& getClusterKeys() const
+    //! Get a reference to the keys in each cluster.
+    const util::RaggedArray<unsigned int>& getClusterKeys() const
     {
         return m_cluster_keys;
     }
 
 private:
-    unsigned int m_num_clusters;                           //!< Number of clusters found
-    util::ManagedArray<unsigned int> m_cluster_idx;        //!< Cluster index for each point
-    std::vector<std::vector<unsigned int>> m_cluster_keys; //!< List of keys in each cluster
+    unsigned int m_num_clusters;                   //!< Number of clusters found
+    util::ManagedArray<unsigned int> m_cluster_idx; //!< Cluster index for each point
+    util::RaggedArray<unsigned int> m_cluster_keys; //!< List of keys in each cluster
+
+    //! Number the clusters of the merged sets of the points and store their keys.
+    void labelClusters(const DisjointSets& dj, unsigned int num_points, const unsigned int* keys);
 
     // Returns inverse permutation of cluster indices, sorted from largest to
     // smallest. Adapted from
@@ -1,10 +1,17 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <tbb/parallel_sort.h>
 #include <vector>
 
 #include "ClusterProperties.h"
 #include "NeighborComputeFunctional.h"
+#include "SmallTensor.h"
+#include "utils.h"
 
 /*! \file ClusterProperties.cc
     \brief Routines for computing properties of point clusters.
@@ -12,81 +19,279 @@
 
 namespace freud { namespace cluster {
 
-/*! \param nq NeighborQuery containing the points making up the clusters
-    \param cluster_idx Index of which cluster each point belongs to
+namespace {
 
-    compute loops over all points in the given array and determines the center
-    of mass of the cluster as well as the gyration tensor. These can be
-    accessed after the call to compute with getClusterCenters() and
-    getClusterGyrations().
-*/
+//! Number of sorted points in each chunk of the segmented reductions
+constexpr size_t CLUSTER_PROPERTIES_CHUNK_SIZE = 1024;
+
+//! Sum the contributions of the points of each cluster
+/*! The points are sorted by cluster, so the points of each cluster form a
+ *  contiguous segment. Chunks of sorted points are processed in parallel, and
+ *  the sums of segments that lie entirely within a chunk are written directly.
+ *  Each chunk also keeps the partial sums of the segments that cross its
+ *  boundaries, which are added to the results after the parallel loop.
+ *
+ *  \param sorted_clusters Cluster index of each sorted point.
+ *  \param num_clusters Number of clusters.
+ *  \param contribute Function (begin, end, contributions) that writes the
+ *                    contributions of the sorted points in [begin, end).
+ */
+template<size_t K, typename ContributionFunc>
+std::vector<util::SmallTensor<float, K>> segmentedSum(const std::vector<unsigned int>& sorted_clusters,
+                                               unsigned int num_clusters, const ContributionFunc& contribute)
+{
+    using Sum = util::SmallTensor<float, K>;
+    constexpr size_t chunk_size = CLUSTER_PROPERTIES_CHUNK_SIZE;
+    const size_t n = sorted_clusters.size();
+    const size_t num_chunks = (n + chunk_size - 1) / chunk_size;
+
+    std::vector<Sum> sums(num_clusters, Sum {});
+    std::vector<Sum> first_partial(num_chunks, Sum {});
+    std::vector<Sum> last_partial(num_chunks, Sum {});
+    std::vector<char> has_first_partial(num_chunks, 0);
+    std::vector<char> has_last_partial(num_chunks, 0);
+
+    util::forLoopWrapper(0, num_chunks, [&](size_t chunk_begin, size_t chunk_end) {
+        std::vector<Sum> contributions(chunk_size);
+        for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk)
+        {
+            const size_t begin = chunk * chunk_size;
+            const size_t end = std::min(begin + chunk_size, n);
+            contribute(begin, end, contributions.data());
+
+            size_t p = begin;
+            while (p < end)
+            {
+                const unsigned int c = sorted_clusters[p];
+                Sum sum {};
+                size_t q = p;
+                for (; q < end && sorted_clusters[q] == c; ++q)
+                {
+                    for (size_t k = 0; k < K; ++k)
+                    {
+                        sum[k] += contributions[q - begin][k];
+                    }
+                }
+                if (p == begin && p > 0 && sorted_clusters[p - 1] == c)
+                {
+                    // This segment started in an earlier chunk.
+                    first_partial[chunk] = sum;
+                    has_first_partial[chunk] = 1;
+                }
+                else if (q < n && sorted_clusters[q] == c)
+                {
+                    // This segment continues in a later chunk.
+                    last_partial[chunk] = sum;
+                    has_last_partial[chunk] = 1;
+                }
+                else
+                {
+                    sums[c] = sum;
+                }
+                p = q;
+            }
+        }
+    });
+
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        const size_t begin = chunk * chunk_size;
+        const size_t end = std::min(begin + chunk_size, n);
+        for (size_t k = 0; k < K; ++k)
+        {
+            if (has_first_partial[chunk] != 0)
+            {
+                sums[sorted_clusters[begin]][k] += first_partial[chunk][k];
+            }
+            if (has_last_partial[chunk] != 0)
+            {
+                sums[sorted_clusters[end - 1]][k] += last_partial[chunk][k];
+            }
+        }
+    }
+    return sums;
+}
+
+//! Compute a center from the sums of exp(2 pi i f) over fractional coordinates f
+vec3<float> centerFromPhases(const box::Box& box, const float* phase_sums)
+{
+    // This follows Box::centerOfMass.
+    const vec3<float> phase(std::atan2(phase_sums[1], phase_sums[0]),
+                            std::atan2(phase_sums[3], phase_sums[2]),
+                            std::atan2(phase_sums[5], phase_sums[4]));
+    return box.wrap(box.makeAbsolute(phase / constants::TWO_PI));
+}
+
+//! Index of each of the six unique elements of a symmetric tensor
+constexpr unsigned int TENSOR_ROWS[6] = {0, 0, 0, 1, 1, 2};
+constexpr unsigned int TENSOR_COLS[6] = {0, 1, 2, 1, 2, 2};
+
+}; // end anonymous namespace
 
-void ClusterProperties::compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx)
+/*! compute sorts the points by cluster and then determines the center and
+    center of mass of each cluster in a first segmented reduction, followed by
+    the gyration and inertia tensors in a second segmented reduction. These
+    can be accessed after the call to compute with getClusterCenters(),
+    getClusterCentersOfMass(), getClusterGyrations() and
+    getClusterInertiaTensors().
+*/
+void ClusterProperties::compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx,
+                                const float* masses)
 {
+    const unsigned int num_points = nq->getNPoints();
+    const box::Box& box = nq->getBox();
+
     // determine the number of clusters
-    const unsigned int* max_cluster_id = std::max_element(cluster_idx, cluster_idx + nq->getNPoints());
+    const unsigned int* max_cluster_id = std::max_element(cluster_idx, cluster_idx + num_points);
     const unsigned int num_clusters = *max_cluster_id + 1;
 
     // allocate memory for the cluster properties and temporary arrays
     // initialize arrays to 0
     m_cluster_centers.prepare(num_clusters);
+    m_cluster_centers_of_mass.prepare(num_clusters);
     m_cluster_gyrations.prepare({num_clusters, 3, 3});
+    m_cluster_inertia_tensors.prepare({num_clusters, 3, 3});
     m_cluster_sizes.prepare(num_clusters);
+    m_cluster_masses.prepare(num_clusters);
 
-    // Create a vector to store cluster points, used to compute center of mass
-    std::vector<std::vector<vec3<float>>> cluster_points(num_clusters, std::vector<vec3<float>>());
+    // Sort the points by cluster, keeping the points of each cluster in order
+    // of point index.
+    std::vector<uint64_t> sorted(num_points);
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            sorted[i] = (static_cast<uint64_t>(cluster_idx[i]) << 32) | i;
+        }
+    });
+    tbb::parallel_sort(sorted.begin(), sorted.end());
+    std::vector<unsigned int> sorted_clusters(num_points);
+    std::vector<unsigned int> sorted_points(num_points);
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p)
+        {
+            sorted_clusters[p] = static_cast<unsigned int>(sorted[p] >> 32);
+            sorted_points[p] = static_cast<unsigned int>(sorted[p]);
+        }
+    });
 
-    // Start by determining the center of mass of each cluster. Since we are
-    // given an array of points, the easiest way to do this is to loop over
-    // all points and add the appropriate information to m_cluster_centers as
-    // we go.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        const unsigned int c = cluster_idx[i];
-        cluster_points[c].push_back((*nq)[i]);
-        m_cluster_sizes[c]++;
-    }
+    // The cluster sizes follow from the boundaries of the segments.
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const auto segment = std::equal_range(sorted_clusters.begin(), sorted_clusters.end(),
+                                                  static_cast<unsigned int>(c));
+            m_cluster_sizes[c] = static_cast<unsigned int>(segment.second - segment.first);
+        }
+    });
 
-    // Now that we have located all of the cluster vectors, compute the centers
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        m_cluster_centers[c] = nq->getBox().centerOfMass(cluster_points[c].data(), m_cluster_sizes[c]);
-    }
+    // Start by determining the center of each cluster from the mean of the
+    // phases exp(2 pi i f) of the fractional coordinates f of its points.
+    // The first six sums are unweighted and the next six are mass-weighted,
+    // followed by the total mass.
+    const auto phase_sums
+        = segmentedSum<13>(sorted_clusters, num_clusters, [&](size_t begin, size_t end, auto* contributions) {
+              for (size_t p = begin; p < end; ++p)
+              {
+                  const unsigned int i = sorted_points[p];
+                  const vec3<float> phase(constants::TWO_PI * box.makeFractional((*nq)[i]));
+                  const float mass = (masses != nullptr) ? masses[i] : float(1.0);
+                  auto& contribution = contributions[p - begin];
+                  contribution[0] = std::cos(phase.x);
+                  contribution[1] = std::sin(phase.x);
+                  contribution[2] = std::cos(phase.y);
+                  contribution[3] = std::sin(phase.y);
+                  contribution[4] = std::cos(phase.z);
+                  contribution[5] = std::sin(phase.z);
+                  for (size_t k = 0; k < 6; ++k)
+                  {
+                      contribution[6 + k] = mass * contribution[k];
+                  }
+                  contribution[12] = mass;
+              }
+          });
 
-    // Now that we have determined the centers of mass for each cluster, tally
-    // up the gyration tensor. This has to be done in a loop over the points.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        unsigned int c = cluster_idx[i];
-        vec3<float> pos = (*nq)[i];
-        vec3<float> delta = nq->getBox().wrap(pos - m_cluster_centers[c]);
-
-        // get the start pointer for our 3x3 matrix
-        m_cluster_gyrations(c, 0, 0) += delta.x * delta.x;
-        m_cluster_gyrations(c, 0, 1) += delta.x * delta.y;
-        m_cluster_gyrations(c, 0, 2) += delta.x * delta.z;
-        m_cluster_gyrations(c, 1, 0) += delta.y * delta.x;
-        m_cluster_gyrations(c, 1, 1) += delta.y * delta.y;
-        m_cluster_gyrations(c, 1, 2) += delta.y * delta.z;
-        m_cluster_gyrations(c, 2, 0) += delta.z * delta.x;
-        m_cluster_gyrations(c, 2, 1) += delta.z * delta.y;
-        m_cluster_gyrations(c, 2, 2) += delta.z * delta.z;
-    }
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            m_cluster_centers[c] = centerFromPhases(box, &phase_sums[c][0]);
+            m_cluster_centers_of_mass[c] = centerFromPhases(box, &phase_sums[c][6]);
+            m_cluster_masses[c] = phase_sums[c][12];
+        }
+    });
 
-    // Normalize by the cluster size.
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        auto s = static_cast<float>(m_cluster_sizes[c]);
-        m_cluster_gyrations(c, 0, 0) /= s;
-        m_cluster_gyrations(c, 0, 1) /= s;
-        m_cluster_gyrations(c, 0, 2) /= s;
-        m_cluster_gyrations(c, 1, 0) /= s;
-        m_cluster_gyrations(c, 1, 1) /= s;
-        m_cluster_gyrations(c, 1, 2) /= s;
-        m_cluster_gyrations(c, 2, 0) /= s;
-        m_cluster_gyrations(c, 2, 1) /= s;
-        m_cluster_gyrations(c, 2, 2) /= s;
-    }
+    // Now that we have determined the centers of each cluster, tally up the
+    // second moments of the displacements of the points from the center for
+    // the gyration tensor, and from the center of mass for the inertia
+    // tensor. The displacements of each chunk are wrapped as a batch.
+    const auto moment_sums
+        = segmentedSum<12>(sorted_clusters, num_clusters, [&](size_t begin, size_t end, auto* contributions) {
+              const size_t count = end - begin;
+              std::vector<float> x(2 * count);
+              std::vector<float> y(2 * count);
+              std::vector<float> z(2 * count);
+              for (size_t p = begin; p < end; ++p)
+              {
+                  const unsigned int c = sorted_clusters[p];
+                  const vec3<float> pos = (*nq)[sorted_points[p]];
+                  const vec3<float> delta = pos - m_cluster_centers[c];
+                  const vec3<float> delta_com = pos - m_cluster_centers_of_mass[c];
+                  x[p - begin] = delta.x;
+                  y[p - begin] = delta.y;
+                  z[p - begin] = delta.z;
+                  x[count + p - begin] = delta_com.x;
+                  y[count + p - begin] = delta_com.y;
+                  z[count + p - begin] = delta_com.z;
+              }
+              box.wrapBatch(x.data(), y.data(), z.data(), 2 * count);
+
+              for (size_t p = begin; p < end; ++p)
+              {
+                  const size_t j = p - begin;
+                  const float mass = (masses != nullptr) ? masses[sorted_points[p]] : float(1.0);
+                  const float delta[3] = {x[j], y[j], z[j]};
+                  const float delta_com[3] = {x[count + j], y[count + j], z[count + j]};
+                  auto& contribution = contributions[j];
+                  for (size_t k = 0; k < 6; ++k)
+                  {
+                      contribution[k] = delta[TENSOR_ROWS[k]] * delta[TENSOR_COLS[k]];
+                      contribution[6 + k] = mass * delta_com[TENSOR_ROWS[k]] * delta_com[TENSOR_COLS[k]];
+                  }
+              }
+          });
+
+    // Normalize the gyration tensors by the cluster size, and convert the
+    // mass-weighted second moments M into inertia tensors I = tr(M) - M.
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const auto s = static_cast<float>(m_cluster_sizes[c]);
+            const auto& sums = moment_sums[c];
+            const float trace = sums[6] + sums[9] + sums[11];
+            for (size_t k = 0; k < 6; ++k)
+            {
+                const unsigned int row = TENSOR_ROWS[k];
+                const unsigned int col = TENSOR_COLS[k];
+                const float gyration = sums[k] / s;
+                const float inertia = ((row == col) ? trace : float(0.0)) - sums[6 + k];
+                m_cluster_gyrations(c, row, col) = gyration;
+                m_cluster_gyrations(c, col, row) = gyration;
+                m_cluster_inertia_tensors(c, row, col) = inertia;
+                m_cluster_inertia_tensors(c, col, row) = inertia;
+            }
+        }
+    });
+}
+
+freud::locality::FrameTask ClusterProperties::makeFrameTask(unsigned int clusters)
+{
+    return [this, clusters](const freud::locality::FrameContext& context) {
+        const util::ManagedArray<unsigned int>* cluster_idx = context.graph->getPointLabels(clusters);
+        if (cluster_idx == nullptr)
+        {
+            throw std::invalid_argument("ClusterProperties requires a node that computes cluster indices.");
+        }
+        compute(context.neighbor_query, cluster_idx->get());
+    };
 }
 
 }; }; // end namespace freud::cluster
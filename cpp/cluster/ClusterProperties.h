@@ -4,6 +4,7 @@
 #ifndef CLUSTER_PROPERTIES_H
 #define CLUSTER_PROPERTIES_H
 
+#include "AnalysisGraph.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
 
@@ -17,13 +18,28 @@ namespace freud { namespace cluster {
 /*! Given a set of points and \a cluster_idx (from Cluster, or some other
     source), ClusterProperties determines the following properties for each
     cluster:
+     - Center
      - Center of mass
      - Gyration tensor
+     - Moment of inertia tensor
+     - Size
+     - Mass
 
-    m_cluster_centers stores the computed center of mass for each cluster,
-    properly handling periodic boundary conditions.
-    m_cluster_gyrations stores a 3x3 gyration tensor for each cluster. The
-    tensors are symmetric.
+    m_cluster_centers stores the computed center of each cluster, properly
+    handling periodic boundary conditions, and m_cluster_centers_of_mass
+    stores the mass-weighted center of each cluster.
+    m_cluster_gyrations stores a 3x3 gyration tensor about the center of each
+    cluster and m_cluster_inertia_tensors stores a 3x3 moment of inertia
+    tensor about the center of mass of each cluster. The tensors are
+    symmetric. If no masses are given, all points have unit mass.
+
+    The points are sorted by cluster so that the points of each cluster are
+    contiguous, and all properties are then computed by segmented reductions
+    over chunks of the sorted points in parallel: each chunk sums the clusters
+    that lie entirely within it, and the partial sums of the clusters that
+    cross chunk boundaries are combined afterwards. The displacements of the
+    points of a chunk from their cluster centers are wrapped together in a
+    single batch.
 */
 class ClusterProperties
 {
@@ -32,7 +48,18 @@ public:
     ClusterProperties() = default;
 
     //! Compute properties of the point clusters
-    void compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx);
+    /*! \param nq NeighborQuery containing the points making up the clusters
+     *  \param cluster_idx Index of which cluster each point belongs to
+     *  \param masses Optional array of the mass of each point
+     */
+    void compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx,
+                 const float* masses = nullptr);
+
+    //! Get a task computing the properties of the clusters found by a node of an AnalysisGraph
+    /*! \param clusters The task node whose point labels are the cluster
+     *                  index of each point.
+     */
+    freud::locality::FrameTask makeFrameTask(unsigned int clusters);
 
     //! Get a reference to the last computed cluster centers
     const util::ManagedArray<vec3<float>>& getClusterCenters() const
@@ -40,24 +67,47 @@ public:
         return m_cluster_centers;
     }
 
+    //! Get a reference to the last computed cluster centers of mass
+    const util::ManagedArray<vec3<float>>& getClusterCentersOfMass() const
+    {
+        return m_cluster_centers_of_mass;
+    }
+
     //! Get a reference to the last computed cluster gyration tensors
     const util::ManagedArray<float>& getClusterGyrations() const
     {
         return m_cluster_gyrations;
     }
 
+    //! Get a reference to the last computed cluster moment of inertia tensors
+    const util::ManagedArray<float>& getClusterInertiaTensors() const
+    {
+        return m_cluster_inertia_tensors;
+    }
+
     //! Get a reference to the last computed cluster size
     const util::ManagedArray<unsigned int>& getClusterSizes() const
     {
         return m_cluster_sizes;
     }
 
+    //! Get a reference to the last computed cluster masses
+    const util::ManagedArray<float>& getClusterMasses() const
+    {
+        return m_cluster_masses;
+    }
+
 private:
     util::ManagedArray<vec3<float>>
-        m_cluster_centers; //!< Center of mass computed for each cluster (length: m_num_clusters)
+        m_cluster_centers; //!< Center computed for each cluster (length: m_num_clusters)
+    util::ManagedArray<vec3<float>>
+        m_cluster_centers_of_mass; //!< Center of mass computed for each cluster (length: m_num_clusters)
     util::ManagedArray<float>
         m_cluster_gyrations; //!< Gyration tensor computed for each cluster (m_num_clusters x 3 x 3 array)
+    util::ManagedArray<float>
+        m_cluster_inertia_tensors; //!< Inertia tensor computed for each cluster (m_num_clusters x 3 x 3)
     util::ManagedArray<unsigned int> m_cluster_sizes; //!< Size per cluster
+    util::ManagedArray<float> m_cluster_masses;       //!< Mass per cluster
 };
 
 }; }; // end namespace freud::cluster
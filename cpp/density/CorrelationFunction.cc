@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <complex>
 #include <stdexcept>
 #ifdef __SSE2__
@@ -17,8 +18,16 @@
 
 namespace freud { namespace density {
 
+namespace {
+
+//! Number of fields whose products are accumulated together
+constexpr unsigned int CF_FIELD_BLOCK_SIZE = 16;
+
+}; // end anonymous namespace
+
 template<typename T>
-CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : BondHistogramCompute()
+CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max, unsigned int num_fields)
+    : BondHistogramCompute(), m_num_fields(num_fields)
 {
     if (bins == 0)
     {
@@ -28,6 +37,10 @@ CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : Bo
     {
         throw std::invalid_argument("CorrelationFunction requires r_max to be positive.");
     }
+    if (num_fields == 0)
+    {
+        throw std::invalid_argument("CorrelationFunction requires a nonzero number of fields.");
+    }
 
     // We must construct two separate histograms, one for the counts and one
     // for the actual correlation function. The counts are used to normalize
@@ -36,9 +49,16 @@ CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : Bo
     axes.push_back(std::make_shared<util::RegularAxis>(bins, 0, r_max));
     m_histogram = util::Histogram<unsigned int>(axes);
     m_local_histograms = util::Histogram<unsigned int>::ThreadLocalHistogram(m_histogram);
+    m_distance_sq_bins = util::SquaredBinTable(*axes[0]);
 
+    // Multiple fields are stored in a second axis, so the fields of each
+    // distance bin are contiguous.
     typename util::Histogram<T>::Axes axes_rdf;
     axes_rdf.push_back(std::make_shared<util::RegularAxis>(bins, 0, r_max));
+    if (m_num_fields > 1)
+    {
+        axes_rdf.push_back(std::make_shared<util::RegularAxis>(m_num_fields, 0, m_num_fields));
+    }
     m_correlation_function = util::Histogram<T>(axes_rdf);
     m_local_correlation_function = CFThreadHistogram(m_correlation_function);
 }
@@ -47,16 +67,16 @@ CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : Bo
 //! helper function to reduce the thread specific arrays into one array
 template<typename T> void CorrelationFunction<T>::reduce()
 {
-    m_histogram.prepare(getAxisSizes()[0]);
-    m_correlation_function.prepare(getAxisSizes()[0]);
+    m_correlation_function.prepare(m_correlation_function.shape());
 
     // Reduce the bin counts over all threads, then use them to normalize the
     // RDF when computing.
-    m_histogram.reduceOverThreads(m_local_histograms);
+    reduceBinCounts([](size_t /*i*/) {});
     m_correlation_function.reduceOverThreadsPerBin(m_local_correlation_function, [&](size_t i) {
-        if (m_histogram[i])
+        const std::uint64_t count = getBinCount(i / m_num_fields);
+        if (count != 0)
         {
-            m_correlation_function[i] /= m_histogram[i];
+            m_correlation_function[i] /= static_cast<double>(count);
         }
     });
 }
@@ -71,9 +91,11 @@ template<typename T> void CorrelationFunction<T>::reset()
 }
 
 // Define an overloaded pair of product functions to deal with complex conjugation if necessary.
+// The complex product is written out so that it is vectorized across fields
+// instead of calling the library routine that handles infinite and NaN parts.
 inline std::complex<double> product(std::complex<double> x, std::complex<double> y)
 {
-    return std::conj(x) * y;
+    return {x.real() * y.real() + x.imag() * y.imag(), x.real() * y.imag() - x.imag() * y.real()};
 }
 
 inline double product(double x, double y)
@@ -88,15 +110,36 @@ void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* ne
                                         const freud::locality::NeighborList* nlist,
                                         freud::locality::QueryArgs qargs)
 {
+    const unsigned int num_fields = m_num_fields;
     accumulateGeneral(
         neighbor_query, query_points, n_query_points, nlist, qargs,
         [=](const freud::locality::NeighborBond& neighbor_bond) {
-            size_t value_bin = m_histogram.bin({neighbor_bond.distance});
+            // The bonds hold squared distances, which are binned without square roots.
+            size_t value_bin = m_distance_sq_bins.bin(neighbor_bond.distance);
+            if (value_bin == util::Axis::OVERFLOW_BIN)
+            {
+                return;
+            }
             m_local_histograms.increment(value_bin);
-            m_local_correlation_function.increment(
-                value_bin,
-                product(values[neighbor_bond.point_idx], query_values[neighbor_bond.query_point_idx]));
-        });
+
+            // The products of all fields of the bond are accumulated into
+            // consecutive bins, in blocks of fields.
+            const T* point_values = values + static_cast<size_t>(neighbor_bond.point_idx) * num_fields;
+            const T* query_point_values
+                = query_values + static_cast<size_t>(neighbor_bond.query_point_idx) * num_fields;
+            T products[CF_FIELD_BLOCK_SIZE];
+            for (unsigned int block = 0; block < num_fields; block += CF_FIELD_BLOCK_SIZE)
+            {
+                const unsigned int block_size = std::min(CF_FIELD_BLOCK_SIZE, num_fields - block);
+                for (unsigned int field = 0; field < block_size; ++field)
+                {
+                    products[field] = product(point_values[block + field], query_point_values[block + field]);
+                }
+                m_local_correlation_function.incrementBins(value_bin * num_fields + block, products,
+                                                           block_size);
+            }
+        },
+        true);
 }
 
 template class CorrelationFunction<std::complex<double>>;
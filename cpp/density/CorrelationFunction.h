@@ -42,12 +42,19 @@ namespace freud { namespace density {
     for both points and ref_points, we omit accumulating the
     self-correlation value in the first bin.
 
+    <b>Multiple fields:</b><br>
+    Several fields can be correlated in one pass over the bonds. The
+    values are then given as row-major arrays of shape (N, num_fields),
+    each field of the points is correlated with the same field of the
+    query points, and the correlation function has shape
+    (bins, num_fields). The bin counts are shared by all fields.
+
 */
 template<typename T> class CorrelationFunction : public locality::BondHistogramCompute
 {
 public:
     //! Constructor
-    CorrelationFunction(unsigned int bins, float r_max);
+    CorrelationFunction(unsigned int bins, float r_max, unsigned int num_fields = 1);
 
     //! Destructor
     ~CorrelationFunction() override = default;
@@ -64,6 +71,12 @@ public:
     //! helper function to reduce the thread specific arrays into one array
     void reduce() override;
 
+    //! Get the number of fields correlated together
+    unsigned int getNumFields() const
+    {
+        return m_num_fields;
+    }
+
     //! Get a reference to the last computed correlation function.
     const util::ManagedArray<T>& getCorrelation()
     {
@@ -74,8 +87,10 @@ private:
     // Typedef thread local histogram type for use in code.
     using CFThreadHistogram = typename util::Histogram<T>::ThreadLocalHistogram;
 
+    unsigned int m_num_fields;                      //!< Number of fields correlated together
     util::Histogram<T> m_correlation_function;      //!< The correlation function
     CFThreadHistogram m_local_correlation_function; //!< Thread local copy of the correlation function
+    util::SquaredBinTable m_distance_sq_bins;       //!< Bins of the squared bond distances
 };
 
 }; }; // end namespace freud::density
@@ -1,10 +1,15 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
+#include "FFT.h"
 #include "GaussianDensity.h"
+#include "NeighborComputeFunctional.h"
 
 /*! \file GaussianDensity.cc
     \brief Routines for computing Gaussian smeared densities from points.
@@ -12,8 +17,8 @@
 
 namespace freud { namespace density {
 
-GaussianDensity::GaussianDensity(vec3<unsigned int> width, float r_max, float sigma)
-    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_has_computed(false)
+GaussianDensity::GaussianDensity(vec3<unsigned int> width, float r_max, float sigma, bool fft)
+    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_fft(fft), m_has_computed(false)
 {
     if (r_max <= 0)
     {
@@ -35,6 +40,79 @@ vec3<unsigned int> GaussianDensity::getWidth()
 
 //! Compute the density array.
 void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const float* values)
+{
+    computeGrid(nq, values, nullptr, nullptr, 0);
+}
+
+//! Compute the density array with adaptive widths.
+void GaussianDensity::computeAdaptive(const freud::locality::NeighborQuery* nq, const float* values,
+                                      unsigned int num_neighbors)
+{
+    if (m_fft)
+    {
+        throw std::invalid_argument(
+            "The FFT mode of GaussianDensity cannot adapt the widths of the Gaussians.");
+    }
+    if (num_neighbors == 0)
+    {
+        throw std::invalid_argument("The adaptive GaussianDensity requires a nonzero number of neighbors.");
+    }
+
+    // Widths narrower than half a grid cell cannot be resolved by the grid.
+    const box::Box& box = nq->getBox();
+    const vec3<float> L = box.getL();
+    float min_sigma = std::min(L.x / static_cast<float>(m_width.x), L.y / static_cast<float>(m_width.y));
+    if (!box.is2D())
+    {
+        min_sigma = std::min(min_sigma, L.z / static_cast<float>(m_width.z));
+    }
+    min_sigma = std::min(min_sigma / float(2.0), m_sigma);
+
+    // Neighbors beyond sigma cannot widen the Gaussians, so the neighbors of
+    // each point are found by a single k-nearest query capped at sigma.
+    freud::locality::QueryArgs qargs;
+    qargs.mode = freud::locality::QueryType::nearest;
+    qargs.num_neighbors = num_neighbors;
+    qargs.r_max = m_sigma;
+    qargs.r_guess = m_sigma;
+    qargs.exclude_ii = true;
+
+    const unsigned int n_points = nq->getNPoints();
+    m_sigma_array.prepare(n_points);
+    freud::locality::loopOverNeighborsIterator(
+        nq, nq->getPoints(), n_points, qargs, nullptr,
+        [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
+            unsigned int found = 0;
+            float r_far = 0;
+            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            {
+                ++found;
+                r_far = std::max(r_far, nb.distance);
+            }
+            m_sigma_array[i]
+                = found < num_neighbors ? m_sigma : std::min(std::max(r_far, min_sigma), m_sigma);
+        });
+    computeGrid(nq, values, m_sigma_array.get(), nullptr, 0);
+}
+
+//! Compute the density array and write it to a file.
+void GaussianDensity::computeToFile(const freud::locality::NeighborQuery* nq, const float* values,
+                                    const std::string& filename, unsigned int slab_width)
+{
+    if (m_fft)
+    {
+        throw std::invalid_argument("The FFT mode of GaussianDensity cannot write the density to a file.");
+    }
+    if (nq->getBox().is2D())
+    {
+        m_width.z = 1;
+    }
+    GridFileWriter writer(filename, m_width, sizeof(float));
+    computeGrid(nq, values, nullptr, &writer, slab_width);
+}
+
+void GaussianDensity::computeGrid(const freud::locality::NeighborQuery* nq, const float* values,
+                                  const float* sigmas, GridFileWriter* writer, unsigned int slab_width)
 {
     // set the number of dimensions for the calculation the first time it is done
     if (!m_has_computed || nq->getBox().is2D() == m_box.is2D())
@@ -49,8 +127,6 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
                                     "number of dimensions.");
     }
 
-    auto n_points = nq->getNPoints();
-
     // if the user gives a single number for width, but the nq box is 2D, and
     // we want a 2D calculation
     if (m_box.is2D())
@@ -58,8 +134,106 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
         m_width.z = 1;
     }
 
-    m_density_array.prepare({m_width.x, m_width.y, m_width.z});
-    util::ThreadStorage<float> local_bin_counts({m_width.x, m_width.y, m_width.z});
+    if (writer == nullptr)
+    {
+        m_density_array.prepare({m_width.x, m_width.y, m_width.z});
+    }
+
+    const bool orthorhombic
+        = m_box.getTiltFactorXY() == 0 && m_box.getTiltFactorXZ() == 0 && m_box.getTiltFactorYZ() == 0;
+    if (m_fft)
+    {
+        const vec3<bool> periodic = m_box.getPeriodic();
+        if (!orthorhombic || !periodic.x || !periodic.y || (!m_box.is2D() && !periodic.z))
+        {
+            throw std::invalid_argument("The FFT mode of GaussianDensity requires a periodic, "
+                                        "orthorhombic box.");
+        }
+        computeFFT(nq, values);
+    }
+    else if (orthorhombic)
+    {
+        if (m_box.is2D())
+        {
+            computeSeparable<true>(nq, values, sigmas, writer, slab_width);
+        }
+        else
+        {
+            computeSeparable<false>(nq, values, sigmas, writer, slab_width);
+        }
+    }
+    else
+    {
+        if (m_box.is2D())
+        {
+            computeDirect<true>(nq, values, sigmas, writer, slab_width);
+        }
+        else
+        {
+            computeDirect<false>(nq, values, sigmas, writer, slab_width);
+        }
+    }
+}
+
+//! Normalization of a Gaussian of width sigma in two or three dimensions
+inline float gaussianNormalization(float sigma, bool is2D)
+{
+    const float sigmasq = sigma * sigma;
+    const float normalization_base = float(1.0) / std::sqrt(constants::TWO_PI * sigmasq);
+    const float dimensions = is2D ? float(2.0) : float(3.0);
+    return std::pow(normalization_base, dimensions);
+}
+
+float GaussianDensity::getNormalization() const
+{
+    return gaussianNormalization(m_sigma, m_box.is2D());
+}
+
+//! Gaussian deposited by one point onto the grid
+struct PointGaussian
+{
+    float r_max;         //!< Distance within which the Gaussian is evaluated
+    float sigmasq;       //!< Squared width of the Gaussian
+    float normalization; //!< Normalization of the Gaussian
+    vec3<int> bin_cut;   //!< Number of cells within r_max on either side of the cell of the point
+};
+
+//! Make the Gaussian of a point
+/*! \param sigma The width of the Gaussian.
+ *  \param r_max The distance within which the Gaussian is evaluated.
+ *  \param is2D Whether the box is 2D, in which case no cells along z are within r_max.
+ *  \param grid_size The size of the grid cells along each axis.
+ */
+inline PointGaussian makePointGaussian(float sigma, float r_max, bool is2D, const vec3<float>& grid_size)
+{
+    const vec3<int> bin_cut(int(r_max / grid_size.x), int(r_max / grid_size.y),
+                            is2D ? 0 : int(r_max / grid_size.z));
+    return {r_max, sigma * sigma, gaussianNormalization(sigma, is2D), bin_cut};
+}
+
+//! Squared minimum image distance of a vector, with the dimensionality of the box fixed at compile time
+/*! 2D boxes wrap only the components in the plane, which gives the same
+ *  result as wrapping the vector with a z component of zero.
+ */
+template<bool is2D> inline float wrappedDistanceSquared(const box::Box& box, float dx, float dy, float dz);
+
+template<> inline float wrappedDistanceSquared<true>(const box::Box& box, float dx, float dy, float /*dz*/)
+{
+    const vec2<float> delta = box.wrap(vec2<float>(dx, dy));
+    return dot(delta, delta);
+}
+
+template<> inline float wrappedDistanceSquared<false>(const box::Box& box, float dx, float dy, float dz)
+{
+    const vec3<float> delta = box.wrap(vec3<float>(dx, dy, dz));
+    return dot(delta, delta);
+}
+
+template<bool is2D>
+void GaussianDensity::computeDirect(const freud::locality::NeighborQuery* nq, const float* values,
+                                    const float* sigmas, GridFileWriter* writer, unsigned int slab_width)
+{
+    auto n_points = nq->getNPoints();
 
     // set up some constants first
     const float Lx = m_box.getLx();
@@ -69,59 +243,73 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
 
     const float grid_size_x = Lx / static_cast<float>(m_width.x);
     const float grid_size_y = Ly / static_cast<float>(m_width.y);
-    const float grid_size_z = m_box.is2D() ? 0 : Lz / static_cast<float>(m_width.z);
+    const float grid_size_z = is2D ? 0 : Lz / static_cast<float>(m_width.z);
 
     // Find the number of bins within r_max
-    const int bin_cut_x = int(m_r_max / grid_size_x);
-    const int bin_cut_y = int(m_r_max / grid_size_y);
-    const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
-    const float r_max_sq = m_r_max * m_r_max;
-    const float sigmasq = m_sigma * m_sigma;
-    const float normalization_base = float(1.0) / std::sqrt(constants::TWO_PI * sigmasq);
-    const float dimensions = m_box.is2D() ? float(2.0) : float(3.0);
-    const float normalization = std::pow(normalization_base, dimensions);
+    const vec3<float> grid_size(grid_size_x, grid_size_y, grid_size_z);
+    const PointGaussian fixed = makePointGaussian(m_sigma, m_r_max, is2D, grid_size);
+    const float r_max_per_sigma = m_r_max / m_sigma;
+    const auto point_gaussian = [&](size_t idx) {
+        return sigmas == nullptr
+            ? fixed
+            : makePointGaussian(sigmas[idx], sigmas[idx] * r_max_per_sigma, is2D, grid_size);
+    };
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
-        // for each reference point
-        for (size_t idx = begin; idx < end; ++idx)
+    GridTiling tiling(m_width, periodic, fixed.bin_cut);
+    tiling.assign(n_points, [&](size_t idx, vec3<int>& first, vec3<int>& last) {
+        const vec3<float> point = (*nq)[idx];
+        const vec3<int> bin_cut = point_gaussian(idx).bin_cut;
+        const int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
+        const int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
+        first = vec3<int>(bin_x - bin_cut.x, bin_y - bin_cut.y, 0);
+        last = vec3<int>(bin_x + bin_cut.x, bin_y + bin_cut.y, 0);
+    });
+
+    const auto fill_tile = [&](const GridTile& tile, const TilePoints& points,
+                               unsigned int x_begin) {
+        for (const unsigned int idx : points)
         {
             const vec3<float> point = (*nq)[idx];
             const float value = (values != nullptr) ? values[idx] : 1.0f;
+            const PointGaussian gaussian_params = point_gaussian(idx);
+            const vec3<int> bin_cut = gaussian_params.bin_cut;
+            const float r_max_sq = gaussian_params.r_max * gaussian_params.r_max;
 
             // Find which bin the particle is in
             int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
             int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
-            int bin_z = int((point.z + Lz / float(2.0)) / grid_size_z);
-
             // In 2D, only loop over the z=0 plane
-            if (m_box.is2D())
-            {
-                bin_z = 0;
-            }
+            const int bin_z = is2D ? 0 : int((point.z + Lz / float(2.0)) / grid_size_z);
 
             // Reject bins that are outside the box in aperiodic directions
             // Only evaluate over bins that are within the cutoff
-            for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+            for (int k = bin_z - bin_cut.z; k <= bin_z + bin_cut.z; k++)
             {
-                if (!periodic.z && (k < 0 || k >= int(m_width.z)))
+                if (!is2D && !periodic.z && (k < 0 || k >= int(m_width.z)))
                 {
                     continue;
                 }
-                const float dz = (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0)) - point.z
-                    - (Lz / float(2.0));
+                // The z component is never used by the 2D kernel
+                const float dz = is2D ? float(0)
+                                      : (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0))
+                                          - point.z - (Lz / float(2.0));
 
-                for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+                for (int j = bin_y - bin_cut.y; j <= bin_y + bin_cut.y; j++)
                 {
-                    if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                    // Assure that out of range indices are corrected for storage
+                    // in the array i.e. bin -1 is actually bin 29 for nbins = 30
+                    const unsigned int nj = (j + m_width.y) % m_width.y;
+                    if ((!periodic.y && (j < 0 || j >= int(m_width.y))) || !tile.containsY(nj))
                     {
                         continue;
                     }
                     const float dy = (grid_size_y * static_cast<float>(j)) + (grid_size_y / float(2.0))
                         - point.y - (Ly / float(2.0));
 
-                    for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
+                    for (int i = bin_x - bin_cut.x; i <= bin_x + bin_cut.x; i++)
                     {
-                        if (!periodic.x && (i < 0 || i >= int(m_width.x)))
+                        const unsigned int ni = (i + m_width.x) % m_width.x;
+                        if ((!periodic.x && (i < 0 || i >= int(m_width.x))) || !tile.containsX(ni))
                         {
                             continue;
                         }
@@ -129,34 +317,314 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
                             - point.x - (Lx / float(2.0));
 
                         // Calculate the distance from the particle to the grid cell
-                        const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
-
-                        const float r_sq = dot(delta, delta);
+                        const float r_sq = wrappedDistanceSquared<is2D>(m_box, dx, dy, dz);
 
                         // Check to see if this distance is within the specified r_max
                         if (r_sq < r_max_sq)
                         {
                             // Evaluate the gaussian
-                            const float gaussian
-                                = value * normalization * std::exp(-r_sq / (float(2.0) * sigmasq));
+                            const float gaussian = value * gaussian_params.normalization
+                                * std::exp(-r_sq / (float(2.0) * gaussian_params.sigmasq));
 
-                            // Assure that out of range indices are corrected for storage
-                            // in the array i.e. bin -1 is actually bin 29 for nbins = 30
-                            const unsigned int ni = (i + m_width.x) % m_width.x;
-                            const unsigned int nj = (j + m_width.y) % m_width.y;
-                            const unsigned int nk = (k + m_width.z) % m_width.z;
+                            const unsigned int nk = is2D ? 0 : (k + m_width.z) % m_width.z;
 
-                            // Store the gaussian contribution
-                            local_bin_counts.local()(ni, nj, nk) += gaussian;
+                            // Store the gaussian contribution. Only this tile
+                            // writes to the grid cell.
+                            m_density_array(ni - x_begin, nj, nk) += gaussian;
                         }
                     }
                 }
             }
         }
+    };
+    fillGridSlabs(tiling, m_density_array, m_width, writer, slab_width, fill_tile);
+}
+
+//! Grid cells along one box axis within the cutoff of a point
+struct AxisTable
+{
+    std::vector<unsigned int> bins; //!< Index of each grid cell along the axis
+    std::vector<float> r_sq;        //!< Squared distance to each grid cell along the axis
+    std::vector<float> gaussian;    //!< Factor of the Gaussian along the axis for each grid cell
+};
+
+//! Tabulate the Gaussian along one axis of an orthorhombic box
+/*! The distances are computed the same way as in
+ *  GaussianDensity::computeDirect, wrapping only the component along the axis,
+ *  which is exact because the axes of an orthorhombic box are independent.
+ *
+ *  \param box The box containing the point.
+ *  \param axis The index of the axis (0, 1, or 2).
+ *  \param coordinate The coordinate of the point along the axis.
+ *  \param width The number of grid cells along the axis.
+ *  \param r_max The cutoff distance.
+ *  \param sigmasq The squared width of the Gaussian.
+ *  \param table The table to fill.
+ */
+inline void fillAxisTable(const box::Box& box, unsigned int axis, float coordinate, unsigned int width,
+                          float r_max, float sigmasq, AxisTable& table)
+{
+    const vec3<float> box_L = box.getL();
+    const vec3<bool> box_periodic = box.getPeriodic();
+    const float L = (axis == 0) ? box_L.x : ((axis == 1) ? box_L.y : box_L.z);
+    const bool periodic = (axis == 0) ? box_periodic.x : ((axis == 1) ? box_periodic.y : box_periodic.z);
+    const float grid_size = L / static_cast<float>(width);
+    const int bin_cut = int(r_max / grid_size);
+    const int bin = int((coordinate + L / float(2.0)) / grid_size);
+
+    table.bins.clear();
+    table.r_sq.clear();
+    table.gaussian.clear();
+    for (int i = bin - bin_cut; i <= bin + bin_cut; i++)
+    {
+        if (!periodic && (i < 0 || i >= int(width)))
+        {
+            continue;
+        }
+        const float d
+            = (grid_size * static_cast<float>(i)) + (grid_size / float(2.0)) - coordinate - (L / float(2.0));
+        const vec3<float> wrapped
+            = box.wrap(vec3<float>(axis == 0 ? d : 0, axis == 1 ? d : 0, axis == 2 ? d : 0));
+        const float delta = (axis == 0) ? wrapped.x : ((axis == 1) ? wrapped.y : wrapped.z);
+        const float r_sq = delta * delta;
+
+        table.bins.push_back((i + width) % width);
+        table.r_sq.push_back(r_sq);
+        table.gaussian.push_back(std::exp(-r_sq / (float(2.0) * sigmasq)));
+    }
+}
+
+template<bool is2D>
+void GaussianDensity::computeSeparable(const freud::locality::NeighborQuery* nq, const float* values,
+                                       const float* sigmas, GridFileWriter* writer, unsigned int slab_width)
+{
+    auto n_points = nq->getNPoints();
+
+    const float Lx = m_box.getLx();
+    const float Ly = m_box.getLy();
+    const float grid_size_x = Lx / static_cast<float>(m_width.x);
+    const float grid_size_y = Ly / static_cast<float>(m_width.y);
+    const float grid_size_z = is2D ? 0 : m_box.getLz() / static_cast<float>(m_width.z);
+    const vec3<float> grid_size(grid_size_x, grid_size_y, grid_size_z);
+    const PointGaussian fixed = makePointGaussian(m_sigma, m_r_max, is2D, grid_size);
+    const float r_max_per_sigma = m_r_max / m_sigma;
+    const auto point_gaussian = [&](size_t idx) {
+        return sigmas == nullptr
+            ? fixed
+            : makePointGaussian(sigmas[idx], sigmas[idx] * r_max_per_sigma, is2D, grid_size);
+    };
+
+    GridTiling tiling(m_width, m_box.getPeriodic(), vec3<int>(fixed.bin_cut.x, fixed.bin_cut.y, 0));
+    tiling.assign(n_points, [&](size_t idx, vec3<int>& first, vec3<int>& last) {
+        const vec3<float> point = (*nq)[idx];
+        const vec3<int> bin_cut = point_gaussian(idx).bin_cut;
+        const int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
+        const int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
+        first = vec3<int>(bin_x - bin_cut.x, bin_y - bin_cut.y, 0);
+        last = vec3<int>(bin_x + bin_cut.x, bin_y + bin_cut.y, 0);
     });
 
-    // Parallel reduction over thread storage
-    local_bin_counts.reduceInto(m_density_array);
+    const auto fill_tile = [&](const GridTile& tile, const TilePoints& points,
+                               unsigned int x_begin) {
+        float* bin_counts = m_density_array.get();
+        AxisTable table_x;
+        AxisTable table_y;
+        AxisTable table_z;
+        for (const unsigned int idx : points)
+        {
+            const vec3<float> point = (*nq)[idx];
+            const float value = (values != nullptr) ? values[idx] : 1.0f;
+            const PointGaussian gaussian_params = point_gaussian(idx);
+            const float r_max = gaussian_params.r_max;
+            const float sigmasq = gaussian_params.sigmasq;
+            const float r_max_sq = r_max * r_max;
+
+            fillAxisTable(m_box, 0, point.x, m_width.x, r_max, sigmasq, table_x);
+            fillAxisTable(m_box, 1, point.y, m_width.y, r_max, sigmasq, table_y);
+            if (!is2D)
+            {
+                fillAxisTable(m_box, 2, point.z, m_width.z, r_max, sigmasq, table_z);
+            }
+
+            // Accumulate the outer product of the tables over the grid cells of
+            // the tile within the cutoff. Only this tile writes to these cells.
+            const float prefactor = value * gaussian_params.normalization;
+            for (unsigned int a = 0; a < table_x.bins.size(); ++a)
+            {
+                if (!tile.containsX(table_x.bins[a]))
+                {
+                    continue;
+                }
+                const float gaussian_x = prefactor * table_x.gaussian[a];
+                for (unsigned int b = 0; b < table_y.bins.size(); ++b)
+                {
+                    if (!tile.containsY(table_y.bins[b]))
+                    {
+                        continue;
+                    }
+                    const float gaussian_xy = gaussian_x * table_y.gaussian[b];
+                    const float r_sq_xy = table_x.r_sq[a] + table_y.r_sq[b];
+                    float* row = bin_counts
+                        + ((table_x.bins[a] - x_begin) * m_width.y + table_y.bins[b]) * m_width.z;
+                    if (is2D)
+                    {
+                        // In 2D, only the z=0 plane is filled.
+                        if (r_sq_xy < r_max_sq)
+                        {
+                            row[0] += gaussian_xy;
+                        }
+                        continue;
+                    }
+                    for (unsigned int c = 0; c < table_z.bins.size(); ++c)
+                    {
+                        if (r_sq_xy + table_z.r_sq[c] < r_max_sq)
+                        {
+                            row[table_z.bins[c]] += gaussian_xy * table_z.gaussian[c];
+                        }
+                    }
+                }
+            }
+        }
+    };
+    fillGridSlabs(tiling, m_density_array, m_width, writer, slab_width, fill_tile);
 }
 
+//! Find the two grid cells sharing the cloud-in-cell weight of a coordinate along one axis
+/*! \param coordinate The coordinate, in units of the grid spacing and relative to the first cell center.
+ *  \param width The number of grid cells along the axis.
+ *  \param bins The indices of the two grid cells.
+ *  \param weights The weights of the two grid cells.
+ */
+inline void cloudInCell(float coordinate, unsigned int width, unsigned int* bins, float* weights)
+{
+    const float lower = std::floor(coordinate);
+    const int bin = static_cast<int>(lower);
+    const int n = static_cast<int>(width);
+    bins[0] = static_cast<unsigned int>(((bin % n) + n) % n);
+    bins[1] = static_cast<unsigned int>((((bin + 1) % n) + n) % n);
+    weights[1] = coordinate - lower;
+    weights[0] = float(1.0) - weights[1];
+}
+
+void GaussianDensity::computeFFT(const freud::locality::NeighborQuery* nq, const float* values)
+{
+    auto n_points = nq->getNPoints();
+    const std::vector<size_t> shape {m_width.x, m_width.y, m_width.z};
+    const size_t n_bins = m_density_array.size();
+
+    const bool is2D = m_box.is2D();
+    const vec3<float> L = m_box.getL();
+    const vec3<float> grid_size(L.x / static_cast<float>(m_width.x), L.y / static_cast<float>(m_width.y),
+                                is2D ? 0 : L.z / static_cast<float>(m_width.z));
+
+    // Deposit the values of the points onto the grid.
+    auto cell_coordinate = [&](const vec3<float>& point) {
+        return vec3<float>((point.x + L.x / float(2.0)) / grid_size.x - float(0.5),
+                           (point.y + L.y / float(2.0)) / grid_size.y - float(0.5),
+                           is2D ? 0 : (point.z + L.z / float(2.0)) / grid_size.z - float(0.5));
+    };
+    GridTiling tiling(m_width, m_box.getPeriodic(), vec3<int>(1, 1, 0));
+    tiling.assign(n_points, [&](size_t idx, vec3<int>& first, vec3<int>& last) {
+        const vec3<float> coordinate = cell_coordinate((*nq)[idx]);
+        first = vec3<int>(static_cast<int>(std::floor(coordinate.x)),
+                          static_cast<int>(std::floor(coordinate.y)), 0);
+        last = vec3<int>(first.x + 1, first.y + 1, 0);
+    });
+    float* bin_counts = m_density_array.get();
+    tiling.forEachTile([&](const GridTile& tile, const TilePoints& points) {
+        for (const unsigned int idx : points)
+        {
+            const vec3<float> coordinate = cell_coordinate((*nq)[idx]);
+            const float value = (values != nullptr) ? values[idx] : 1.0f;
+            unsigned int bins_x[2];
+            unsigned int bins_y[2];
+            unsigned int bins_z[2] = {0, 0};
+            float weights_x[2];
+            float weights_y[2];
+            float weights_z[2] = {1, 0};
+            cloudInCell(coordinate.x, m_width.x, bins_x, weights_x);
+            cloudInCell(coordinate.y, m_width.y, bins_y, weights_y);
+            if (!is2D)
+            {
+                cloudInCell(coordinate.z, m_width.z, bins_z, weights_z);
+            }
+            for (unsigned int a = 0; a < 2; ++a)
+            {
+                if (!tile.containsX(bins_x[a]))
+                {
+                    continue;
+                }
+                for (unsigned int b = 0; b < 2; ++b)
+                {
+                    if (!tile.containsY(bins_y[b]))
+                    {
+                        continue;
+                    }
+                    for (unsigned int c = 0; c < (is2D ? 1 : 2); ++c)
+                    {
+                        bin_counts[(bins_x[a] * m_width.y + bins_y[b]) * m_width.z + bins_z[c]]
+                            += value * weights_x[a] * weights_y[b] * weights_z[c];
+                    }
+                }
+            }
+        }
+    });
+
+    // The transform of the Gaussian only depends on the grid, so it is reused
+    // until the box or the grid changes.
+    if (m_kernel_fft.size() != n_bins || m_kernel_box != m_box || m_kernel_width.x != m_width.x
+        || m_kernel_width.y != m_width.y || m_kernel_width.z != m_width.z)
+    {
+        const float r_max_sq = m_r_max * m_r_max;
+        const float sigmasq = m_sigma * m_sigma;
+        const float normalization = getNormalization();
+        const int bin_cut_x = int(m_r_max / grid_size.x);
+        const int bin_cut_y = int(m_r_max / grid_size.y);
+        const int bin_cut_z = is2D ? 0 : int(m_r_max / grid_size.z);
+
+        m_kernel_fft.assign(n_bins, 0);
+        for (int i = -bin_cut_x; i <= bin_cut_x; i++)
+        {
+            const unsigned int ni = ((i % int(m_width.x)) + m_width.x) % m_width.x;
+            for (int j = -bin_cut_y; j <= bin_cut_y; j++)
+            {
+                const unsigned int nj = ((j % int(m_width.y)) + m_width.y) % m_width.y;
+                for (int k = -bin_cut_z; k <= bin_cut_z; k++)
+                {
+                    const unsigned int nk = ((k % int(m_width.z)) + m_width.z) % m_width.z;
+                    const vec3<float> delta = m_box.wrap(
+                        vec3<float>(grid_size.x * static_cast<float>(i), grid_size.y * static_cast<float>(j),
+                                    grid_size.z * static_cast<float>(k)));
+                    const float r_sq = dot(delta, delta);
+                    if (r_sq < r_max_sq)
+                    {
+                        m_kernel_fft[(ni * m_width.y + nj) * m_width.z + nk]
+                            += normalization * std::exp(-r_sq / (float(2.0) * sigmasq));
+                    }
+                }
+            }
+        }
+        util::fftn(m_kernel_fft.data(), shape);
+        m_kernel_box = m_box;
+        m_kernel_width = m_width;
+    }
+
+    // Convolve the deposited values with the Gaussian.
+    std::vector<std::complex<double>> grid(n_bins);
+    for (size_t i = 0; i < n_bins; ++i)
+    {
+        grid[i] = m_density_array[i];
+    }
+    util::fftn(grid.data(), shape);
+    for (size_t i = 0; i < n_bins; ++i)
+    {
+        grid[i] *= m_kernel_fft[i];
+    }
+    util::fftn(grid.data(), shape, true);
+    const double scale = 1.0 / static_cast<double>(n_bins);
+    for (size_t i = 0; i < n_bins; ++i)
+    {
+        m_density_array[i] = static_cast<float>(grid[i].real() * scale);
+    }
+}
 }; }; // end namespace freud::density
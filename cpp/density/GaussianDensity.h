@@ -4,10 +4,14 @@
 #ifndef GAUSSIAN_DENSITY_H
 #define GAUSSIAN_DENSITY_H
 
+#include <complex>
+#include <string>
+#include <vector>
+
 #include "Box.h"
+#include "GridFile.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
-#include "ThreadStorage.h"
 #include "VectorMath.h"
 
 /*! \file GaussianDensity.h
@@ -20,12 +24,38 @@ namespace freud { namespace density {
 /*! Replaces particle positions with a gaussian and calculates the
         contribution from the grid based upon the distance of the grid cell
         from the center of the Gaussian.
+
+    In orthorhombic boxes the Gaussian factorizes along the box axes, so the
+    contribution of each point is accumulated from one dimensional tables of
+    the Gaussian along each axis. Triclinic boxes evaluate the Gaussian at
+    every grid cell. Alternatively, the points can be deposited onto the grid
+    with cloud-in-cell weights and convolved with the Gaussian using fast
+    Fourier transforms, which costs O(n log n) in the number of grid cells
+    independently of r_max, at the price of a discretization error of order
+    (grid spacing / sigma)^2. The FFT mode requires a periodic orthorhombic box.
+
+    Grids too large to be held in memory can be written to a file instead,
+    in slabs of consecutive cells along x, so that only one slab is held in
+    memory at a time. The FFT mode transforms the whole grid at once and
+    cannot be written to a file.
+
+    In the adaptive mode, the width of the Gaussian of each point is the
+    distance to its kth nearest neighbor, capped at sigma, and the Gaussian is
+    cut off at the same multiple of its width as r_max is of sigma. Points in
+    dense regions then deposit narrow Gaussians onto few grid cells, so the
+    mode smooths sparse regions more than a fixed width would while costing no
+    more per point.
 */
 class GaussianDensity
 {
 public:
     //! Constructor
-    GaussianDensity(vec3<unsigned int> width, float r_max, float sigma);
+    /*! \param width Number of bins in the grid in each dimension.
+     *  \param r_max Max distance at which to compute density.
+     *  \param sigma Gaussian width sigma.
+     *  \param fft If true, compute the density by convolving with fast Fourier transforms.
+     */
+    GaussianDensity(vec3<unsigned int> width, float r_max, float sigma, bool fft = false);
 
     // Destructor
     ~GaussianDensity() = default;
@@ -48,22 +78,92 @@ public:
         return m_r_max;
     }
 
+    //! Return whether the density is computed with fast Fourier transforms.
+    bool getFFT() const
+    {
+        return m_fft;
+    }
+
     //! Compute the density.
     void compute(const freud::locality::NeighborQuery* nq, const float* values = nullptr);
 
+    //! Compute the density with the width of each Gaussian adapted to the distances to its neighbors.
+    /*! The neighbors of each point are found with a nearest neighbor query on
+     *  nq within sigma. Points with fewer than num_neighbors neighbors within
+     *  sigma use a width of sigma, and widths are at least half of the
+     *  smallest grid spacing, which the grid cannot resolve anyway.
+     *
+     *  \param nq NeighborQuery of the points.
+     *  \param values The value of each point, or nullptr to use a value of 1.
+     *  \param num_neighbors The number of neighbors whose farthest member sets the width.
+     */
+    void computeAdaptive(const freud::locality::NeighborQuery* nq, const float* values,
+                         unsigned int num_neighbors);
+
+    //! Get the width of the Gaussian of each point in the last adaptive computation.
+    const util::ManagedArray<float>& getSigmas() const
+    {
+        return m_sigma_array;
+    }
+
+    //! Compute the density and write it to a file instead of holding it in memory.
+    /*! The file is written by a GridFileWriter, and getDensity returns an
+     *  empty array afterwards.
+     *
+     *  \param nq NeighborQuery of the points.
+     *  \param values The value of each point, or nullptr to use a value of 1.
+     *  \param filename Path of the file.
+     *  \param slab_width Number of cells along x of the slabs held in memory,
+     *         rounded up to the width of the tiles that are filled in parallel.
+     */
+    void computeToFile(const freud::locality::NeighborQuery* nq, const float* values,
+                       const std::string& filename, unsigned int slab_width = 0);
+
     //! Get a reference to the last computed density.
     const util::ManagedArray<float>& getDensity() const;
 
     vec3<unsigned int> getWidth();
 
 private:
+    //! Compute the density in memory, or in slabs written to a file if a writer is given
+    /*! The Gaussians have the width sigma unless sigmas gives the width of
+     *  each point.
+     */
+    void computeGrid(const freud::locality::NeighborQuery* nq, const float* values, const float* sigmas,
+                     GridFileWriter* writer, unsigned int slab_width);
+
+    //! Evaluate the Gaussian at every grid cell within r_max of each point
+    /*! The kernel is instantiated for 2D and 3D boxes, so that the 2D kernel
+     *  only loops over the z=0 plane and computes distances in the plane.
+     */
+    template<bool is2D>
+    void computeDirect(const freud::locality::NeighborQuery* nq, const float* values, const float* sigmas,
+                       GridFileWriter* writer, unsigned int slab_width);
+
+    //! Accumulate the Gaussian of each point from tables along each axis of an orthorhombic box
+    template<bool is2D>
+    void computeSeparable(const freud::locality::NeighborQuery* nq, const float* values,
+                          const float* sigmas, GridFileWriter* writer, unsigned int slab_width);
+
+    //! Convolve the points deposited onto the grid with the Gaussian
+    void computeFFT(const freud::locality::NeighborQuery* nq, const float* values);
+
+    //! Get the normalization of the Gaussian in the dimensionality of the box
+    float getNormalization() const;
+
     box::Box m_box;             //!< Simulation box containing the points.
     vec3<unsigned int> m_width; //!< Number of bins in the grid in each dimension.
     float m_r_max;              //!< Max distance at which to compute density.
     float m_sigma;              //!< Gaussian width sigma.
+    bool m_fft;                 //!< Whether to compute the density with fast Fourier transforms.
     bool m_has_computed;        //!< Tracks whether a call to compute has been made.
 
     util::ManagedArray<float> m_density_array; //! Computed density array.
+    util::ManagedArray<float> m_sigma_array;   //! Widths of the Gaussians of the last adaptive computation.
+
+    box::Box m_kernel_box; //!< Box for which the transform of the Gaussian was computed.
+    vec3<unsigned int> m_kernel_width {0, 0, 0};    //!< Grid width of the transform of the Gaussian.
+    std::vector<std::complex<double>> m_kernel_fft; //!< Transform of the Gaussian on the grid.
 };
 
 }; }; // end namespace freud::density
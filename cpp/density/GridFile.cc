@@ -0,0 +1,79 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+
+#include "GridFile.h"
+
+/*! \file GridFile.cc
+    \brief Grids written to binary files in slabs, for grids too large to be held in memory.
+*/
+
+namespace freud { namespace density {
+
+GridFileWriter::GridFileWriter(const std::string& filename, const vec3<unsigned int>& width,
+                               size_t element_size)
+    : m_filename(filename), m_file(std::fopen(filename.c_str(), "wb")), m_width(width),
+      m_element_size(element_size)
+{
+    if (m_file == nullptr)
+    {
+        throw std::runtime_error("Failed to open grid file " + filename + ".");
+    }
+}
+
+GridFileWriter::~GridFileWriter()
+{
+    if (m_file != nullptr)
+    {
+        discard();
+    }
+}
+
+void GridFileWriter::discard()
+{
+    std::fclose(m_file);
+    m_file = nullptr;
+    std::remove(m_filename.c_str());
+}
+
+void GridFileWriter::writeSlab(const void* data, unsigned int x_begin, unsigned int x_end)
+{
+    if (m_file == nullptr)
+    {
+        throw std::runtime_error("The grid file " + m_filename + " is already closed.");
+    }
+    if (x_begin != m_x_written || x_end < x_begin || x_end > m_width.x)
+    {
+        throw std::invalid_argument("The slabs of a grid file must be written in order.");
+    }
+    const size_t count = static_cast<size_t>(x_end - x_begin) * m_width.y * m_width.z;
+    if (count != 0 && std::fwrite(data, m_element_size, count, m_file) != count)
+    {
+        discard();
+        throw std::runtime_error("Failed to write grid file " + m_filename + ".");
+    }
+    m_x_written = x_end;
+}
+
+void GridFileWriter::close()
+{
+    if (m_file == nullptr)
+    {
+        return;
+    }
+    if (m_x_written != m_width.x)
+    {
+        discard();
+        throw std::runtime_error("The grid file " + m_filename + " was closed before it was complete.");
+    }
+    const int result = std::fclose(m_file);
+    m_file = nullptr;
+    if (result != 0)
+    {
+        std::remove(m_filename.c_str());
+        throw std::runtime_error("Failed to write grid file " + m_filename + ".");
+    }
+}
+
+}; }; // end namespace freud::density
@@ -0,0 +1,118 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef GRID_FILE_H
+#define GRID_FILE_H
+
+#include <cstdio>
+#include <string>
+
+#include "GridTiling.h"
+#include "ManagedArray.h"
+#include "VectorMath.h"
+
+/*! \file GridFile.h
+    \brief Grids written to binary files in slabs, for grids too large to be held in memory.
+*/
+
+namespace freud { namespace density {
+
+//! Write a grid to a binary file in slabs of consecutive cells along x.
+/*! The file contains the elements of the grid in C order, indexed by (x, y,
+ *  z) like the grids held in memory, in the native byte order and without a
+ *  header, so that it can be memory mapped directly, for instance with
+ *  numpy.memmap. Since x is the slowest index, each slab is a contiguous
+ *  range of the file and the slabs are appended in order, so only one slab
+ *  needs to be held in memory at a time. The file is removed if the writer is
+ *  destroyed before all slabs were written, for instance because the compute
+ *  filling it threw an exception.
+ */
+class GridFileWriter
+{
+public:
+    //! Constructor, creates the file.
+    /*! \param filename Path of the file.
+     *  \param width Number of grid cells in each dimension.
+     *  \param element_size Size in bytes of each element of the grid.
+     */
+    GridFileWriter(const std::string& filename, const vec3<unsigned int>& width, size_t element_size);
+
+    //! Destructor, removes the file if it was not closed.
+    ~GridFileWriter();
+
+    GridFileWriter(const GridFileWriter&) = delete;
+    GridFileWriter& operator=(const GridFileWriter&) = delete;
+
+    //! Append a slab of the grid.
+    /*! \param data The elements of the slab in C order.
+     *  \param x_begin First cell of the slab along x, which must be one past
+     *         the last cell of the previous slab.
+     *  \param x_end One past the last cell of the slab along x.
+     */
+    void writeSlab(const void* data, unsigned int x_begin, unsigned int x_end);
+
+    //! Close the file, checking that every slab was written.
+    void close();
+
+private:
+    //! Close and remove the file.
+    void discard();
+
+    std::string m_filename;       //!< Path of the file
+    std::FILE* m_file;            //!< The file
+    vec3<unsigned int> m_width;   //!< Number of grid cells in each dimension
+    size_t m_element_size;        //!< Size in bytes of each element of the grid
+    unsigned int m_x_written {0}; //!< Number of cells along x written so far
+};
+
+//! Fill a grid in slabs along x, one tile of the slab per task.
+/*! Without a writer, the whole grid is filled as a single slab in the grid
+ *  array, which must already be prepared with the shape of the grid.
+ *  Otherwise, the grid array is prepared with the shape of one slab, filled
+ *  and appended to the file for each slab in turn, so only one slab is held
+ *  in memory. The points of each tile are assigned once by the tiling, and
+ *  include those within the halo of the tile, so every slab is complete once
+ *  its tiles are processed.
+ *
+ *  \param tiling The tiling of the grid, with the points assigned to its tiles.
+ *  \param grid Array receiving the cells of each slab.
+ *  \param width Number of grid cells in each dimension.
+ *  \param writer File receiving the slabs, or nullptr to fill the whole grid in memory.
+ *  \param slab_width Number of cells of each slab along x, rounded up to a
+ *         whole number of tiles.
+ *  \param body Function taking a GridTile, the vector of indices of the
+ *         points assigned to it, and the first cell of the slab along x, which
+ *         must be subtracted from the x index of the cells it writes.
+ */
+template<typename T, typename Body>
+void fillGridSlabs(const GridTiling& tiling, util::ManagedArray<T>& grid, const vec3<unsigned int>& width,
+                   GridFileWriter* writer, unsigned int slab_width, const Body& body)
+{
+    if (writer == nullptr)
+    {
+        tiling.forEachTile([&](const GridTile& tile, const TilePoints& points) {
+            body(tile, points, 0);
+        });
+        return;
+    }
+
+    slab_width = tiling.slabWidth(slab_width);
+    for (unsigned int x_begin = 0; x_begin < width.x; x_begin += slab_width)
+    {
+        const unsigned int x_end = std::min(x_begin + slab_width, width.x);
+        grid.prepare({x_end - x_begin, width.y, width.z});
+        tiling.forEachTile(x_begin, x_end,
+                           [&](const GridTile& tile, const TilePoints& points) {
+                               body(tile, points, x_begin);
+                           });
+        writer->writeSlab(grid.get(), x_begin, x_end);
+    }
+    writer->close();
+
+    // Release the memory of the last slab.
+    grid = util::ManagedArray<T>();
+}
+
+}; }; // end namespace freud::density
+
+#endif // GRID_FILE_H
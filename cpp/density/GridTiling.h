@@ -0,0 +1,301 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef GRID_TILING_H
+#define GRID_TILING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "VectorMath.h"
+#include "utils.h"
+
+/*! \file GridTiling.h
+    \brief Decomposition of a grid into tiles that are filled independently.
+*/
+
+namespace freud { namespace density {
+
+//! Number of points per chunk when assigning points to tiles.
+constexpr size_t GRID_TILING_CHUNK_SIZE = 16384;
+
+//! Largest number of counts per tile and chunk held while assigning points to tiles.
+constexpr size_t GRID_TILING_MAX_COUNTS = size_t(1) << 22;
+
+//! A block of grid cells spanning the whole grid along z
+struct GridTile
+{
+    unsigned int x_begin; //!< First cell of the tile along x
+    unsigned int x_end;   //!< One past the last cell of the tile along x
+    unsigned int y_begin; //!< First cell of the tile along y
+    unsigned int y_end;   //!< One past the last cell of the tile along y
+
+    //! Return whether the tile contains a cell along x
+    bool containsX(unsigned int x) const
+    {
+        return x >= x_begin && x < x_end;
+    }
+
+    //! Return whether the tile contains a cell along y
+    bool containsY(unsigned int y) const
+    {
+        return y >= y_begin && y < y_end;
+    }
+};
+
+//! The indices of the points assigned to a tile, in increasing order
+struct TilePoints
+{
+    const unsigned int* first; //!< First point index of the tile
+    const unsigned int* last;  //!< One past the last point index of the tile
+
+    const unsigned int* begin() const
+    {
+        return first;
+    }
+
+    const unsigned int* end() const
+    {
+        return last;
+    }
+
+    size_t size() const
+    {
+        return last - first;
+    }
+};
+
+//! Decomposes a grid into tiles in the xy plane and assigns points to the tiles they contribute to
+/*! Computes that deposit each point onto the grid cells near it can fill the
+ *  tiles in parallel, with each task owning one tile and processing every
+ *  point that contributes to it. Since no two tasks write to the same grid
+ *  cell, all tasks write directly into the output grid, so the memory used
+ *  scales with the size of the grid rather than with the size of the grid
+ *  times the number of threads. The points of each tile are processed in
+ *  order, so the results do not depend on the number of threads.
+ *
+ *  The tiles are about as wide as the range of cells that a point contributes
+ *  to, so that each point is processed by at most a few tiles, but they are
+ *  narrow enough that there are at least a few dozen tiles to balance the load.
+ */
+class GridTiling
+{
+public:
+    //! Constructor
+    /*! \param width Number of grid cells in each dimension.
+     *  \param periodic Periodicity of the grid in each dimension.
+     *  \param bin_cut Number of cells on either side of its own cell that a point contributes to.
+     */
+    GridTiling(const vec3<unsigned int>& width, const vec3<bool>& periodic, const vec3<int>& bin_cut)
+        : m_width(width), m_periodic(periodic),
+          m_tile_width(tileWidth(width.x, bin_cut.x), tileWidth(width.y, bin_cut.y), 1),
+          m_num_tiles((width.x + m_tile_width.x - 1) / m_tile_width.x,
+                      (width.y + m_tile_width.y - 1) / m_tile_width.y, 1),
+          m_tile_offsets(m_num_tiles.x * m_num_tiles.y + 1, 0)
+    {}
+
+    //! Assign points to the tiles containing the cells they contribute to
+    /*! \param n_points The number of points.
+     *  \param cell_range Function taking a point index and setting the first
+     *         and last cells along x and y that the point contributes to. The
+     *         cells may lie outside of the grid, in which case they are wrapped
+     *         in periodic dimensions and ignored in aperiodic dimensions.
+     */
+    template<typename CellRange> void assign(size_t n_points, const CellRange& cell_range)
+    {
+        // The points are assigned with a parallel counting sort: the points
+        // of each chunk are counted per tile, the counts are summed into the
+        // offsets of the tiles, and the chunks then scatter their points to
+        // the tiles. The chunks do not depend on the number of threads and
+        // are scattered into consecutive ranges of each tile, so the points
+        // of each tile are in increasing order. The number of chunks is
+        // limited so that the counts of all chunks fit in a bounded buffer.
+        const size_t n_tiles = m_tile_offsets.size() - 1;
+        const size_t n_chunks
+            = std::max(size_t(1), std::min((n_points + GRID_TILING_CHUNK_SIZE - 1) / GRID_TILING_CHUNK_SIZE,
+                                           GRID_TILING_MAX_COUNTS / n_tiles));
+        const size_t chunk_size = (n_points + n_chunks - 1) / n_chunks;
+        std::vector<unsigned int> counts(n_chunks * n_tiles, 0);
+
+        // Call body(tile) for every tile that a point contributes to.
+        const auto for_each_tile = [&](size_t idx, std::vector<unsigned int>& tiles_x,
+                                       std::vector<unsigned int>& tiles_y, const auto& body) {
+            vec3<int> first;
+            vec3<int> last;
+            cell_range(idx, first, last);
+            overlappedTiles(first.x, last.x, m_width.x, m_periodic.x, m_tile_width.x, tiles_x);
+            overlappedTiles(first.y, last.y, m_width.y, m_periodic.y, m_tile_width.y, tiles_y);
+            for (const unsigned int tile_x : tiles_x)
+            {
+                for (const unsigned int tile_y : tiles_y)
+                {
+                    body(tile_x * m_num_tiles.y + tile_y);
+                }
+            }
+        };
+
+        util::forLoopWrapper(0, n_chunks, [&](size_t begin, size_t end) {
+            std::vector<unsigned int> tiles_x;
+            std::vector<unsigned int> tiles_y;
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                unsigned int* chunk_counts = counts.data() + chunk * n_tiles;
+                const size_t last_idx = std::min((chunk + 1) * chunk_size, n_points);
+                for (size_t idx = chunk * chunk_size; idx < last_idx; ++idx)
+                {
+                    for_each_tile(idx, tiles_x, tiles_y, [&](size_t tile) { ++chunk_counts[tile]; });
+                }
+            }
+        });
+
+        // Replace the counts by the offsets of the chunks within each tile.
+        util::forLoopWrapper(0, n_tiles, [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; ++tile)
+            {
+                unsigned int offset = 0;
+                for (size_t chunk = 0; chunk < n_chunks; ++chunk)
+                {
+                    const unsigned int count = counts[chunk * n_tiles + tile];
+                    counts[chunk * n_tiles + tile] = offset;
+                    offset += count;
+                }
+                m_tile_offsets[tile + 1] = offset;
+            }
+        });
+        m_tile_offsets[0] = 0;
+        for (size_t tile = 0; tile < n_tiles; ++tile)
+        {
+            m_tile_offsets[tile + 1] += m_tile_offsets[tile];
+        }
+
+        m_point_indices.resize(m_tile_offsets[n_tiles]);
+        util::forLoopWrapper(0, n_chunks, [&](size_t begin, size_t end) {
+            std::vector<unsigned int> tiles_x;
+            std::vector<unsigned int> tiles_y;
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                unsigned int* chunk_offsets = counts.data() + chunk * n_tiles;
+                const size_t last_idx = std::min((chunk + 1) * chunk_size, n_points);
+                for (size_t idx = chunk * chunk_size; idx < last_idx; ++idx)
+                {
+                    for_each_tile(idx, tiles_x, tiles_y, [&](size_t tile) {
+                        m_point_indices[m_tile_offsets[tile] + chunk_offsets[tile]++]
+                            = static_cast<unsigned int>(idx);
+                    });
+                }
+            }
+        });
+    }
+
+    //! Process the tiles in parallel
+    /*! \param body Function taking a GridTile and the TilePoints of the
+     *         points assigned to it.
+     */
+    template<typename Body> void forEachTile(const Body& body) const
+    {
+        forEachTile(0, m_width.x, body);
+    }
+
+    //! Process the tiles covering a range of cells along x in parallel
+    /*! \param x_begin First cell of the range along x, which must be the
+     *         first cell of a tile.
+     *  \param x_end One past the last cell of the range along x.
+     *  \param body Function taking a GridTile and the TilePoints of the
+     *         points assigned to it.
+     */
+    template<typename Body> void forEachTile(unsigned int x_begin, unsigned int x_end, const Body& body) const
+    {
+        const unsigned int tile_x_begin = x_begin / m_tile_width.x;
+        const unsigned int tile_x_end
+            = std::min((x_end + m_tile_width.x - 1) / m_tile_width.x, m_num_tiles.x);
+        const size_t begin = static_cast<size_t>(tile_x_begin) * m_num_tiles.y;
+        const size_t end = static_cast<size_t>(std::max(tile_x_begin, tile_x_end)) * m_num_tiles.y;
+        util::forLoopWrapper(begin, end, [&](size_t range_begin, size_t range_end) {
+            for (size_t t = range_begin; t < range_end; ++t)
+            {
+                const unsigned int tile_x = t / m_num_tiles.y;
+                const unsigned int tile_y = t % m_num_tiles.y;
+                const GridTile tile {tile_x * m_tile_width.x,
+                                     std::min((tile_x + 1) * m_tile_width.x, m_width.x),
+                                     tile_y * m_tile_width.y,
+                                     std::min((tile_y + 1) * m_tile_width.y, m_width.y)};
+                const TilePoints points {m_point_indices.data() + m_tile_offsets[t],
+                                         m_point_indices.data() + m_tile_offsets[t + 1]};
+                body(tile, points);
+            }
+        });
+    }
+
+    //! Round a number of cells along x up to a whole number of tiles
+    unsigned int slabWidth(unsigned int cells) const
+    {
+        const unsigned int tiles = std::max(1U, (cells + m_tile_width.x - 1) / m_tile_width.x);
+        return std::min(tiles * m_tile_width.x, m_num_tiles.x * m_tile_width.x);
+    }
+
+private:
+    //! Choose the width of the tiles along one dimension
+    static unsigned int tileWidth(unsigned int width, int bin_cut)
+    {
+        const unsigned int max_tile_width = (width + 7) / 8;
+        return std::max(1U, std::min(static_cast<unsigned int>(2 * bin_cut + 1), max_tile_width));
+    }
+
+    //! Find the tiles along one dimension that contain any cell of a range
+    static void overlappedTiles(int first, int last, unsigned int width, bool periodic,
+                                unsigned int tile_width, std::vector<unsigned int>& tiles)
+    {
+        tiles.clear();
+        const int n = static_cast<int>(width);
+        auto add_range = [&](int begin, int end) {
+            for (int tile = begin / static_cast<int>(tile_width); tile <= end / static_cast<int>(tile_width);
+                 ++tile)
+            {
+                tiles.push_back(tile);
+            }
+        };
+
+        if (!periodic)
+        {
+            first = std::max(first, 0);
+            last = std::min(last, n - 1);
+            if (first <= last)
+            {
+                add_range(first, last);
+            }
+            return;
+        }
+
+        if (last - first + 1 >= n)
+        {
+            add_range(0, n - 1);
+            return;
+        }
+        first = ((first % n) + n) % n;
+        last = ((last % n) + n) % n;
+        if (first <= last)
+        {
+            add_range(first, last);
+        }
+        else
+        {
+            // The range wraps around the periodic boundary.
+            add_range(0, last);
+            add_range(first, n - 1);
+            std::sort(tiles.begin(), tiles.end());
+            tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+        }
+    }
+
+    vec3<unsigned int> m_width;                //!< Number of grid cells in each dimension
+    vec3<bool> m_periodic;                     //!< Periodicity of the grid in each dimension
+    vec3<unsigned int> m_tile_width;           //!< Number of cells of each tile in each dimension
+    vec3<unsigned int> m_num_tiles;            //!< Number of tiles in each dimension
+    std::vector<size_t> m_tile_offsets;        //!< Offsets of the points of each tile, and their total
+    std::vector<unsigned int> m_point_indices; //!< Indices of the points of all tiles, tile by tile
+};
+
+}; }; // end namespace freud::density
+
+#endif // GRID_TILING_H
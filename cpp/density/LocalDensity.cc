@@ -1,6 +1,9 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "LocalDensity.h"
 #include "NeighborComputeFunctional.h"
 
@@ -11,8 +14,22 @@
 namespace freud { namespace density {
 
 LocalDensity::LocalDensity(float r_max, float diameter)
-    : m_box(box::Box()), m_r_max(r_max), m_diameter(diameter)
-{}
+    : m_box(box::Box()), m_r_max(r_max), m_diameter(diameter), m_r_full(r_max - diameter / float(2.0)),
+      m_overlap_offset(0), m_overlap_slope(0)
+{
+    // Particles that intersect the r_max sphere are counted by the fraction
+    // (r_max + diameter / 2 - distance) / diameter of their diameter inside it.
+    if (diameter > 0)
+    {
+        m_overlap_offset = (r_max + diameter / float(2.0)) / diameter;
+        m_overlap_slope = float(1.0) / diameter;
+    }
+}
+
+float LocalDensity::unitSphereInverseMeasure() const
+{
+    return m_box.is2D() ? static_cast<float>(1.0 / M_PI) : static_cast<float>(3.0 / (4.0 * M_PI));
+}
 
 void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
                            const vec3<float>* query_points, unsigned int n_query_points,
@@ -23,17 +40,19 @@ void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
     m_density_array.prepare(n_query_points);
     m_num_neighbors_array.prepare(n_query_points);
 
-    const float area = M_PI * m_r_max * m_r_max;
-    const float volume = static_cast<float>(4.0 / 3.0 * M_PI) * m_r_max * m_r_max * m_r_max;
+    // local density is area (volume) of particles divided by the area (volume) of the circle (sphere)
+    const float r_max_measure = m_box.is2D() ? m_r_max * m_r_max : m_r_max * m_r_max * m_r_max;
+    const float density_scale = unitSphereInverseMeasure() / r_max_measure;
     // compute the local density
-    freud::locality::loopOverNeighborsIterator(
+    freud::locality::loopOverNeighborSegments(
         neighbor_query, query_points, n_query_points, qargs, nlist,
-        [=](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
+        [=](const freud::locality::NeighborSegment& segment) {
             float num_neighbors = 0;
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            for (unsigned int j = 0; j < segment.num_bonds; ++j)
             {
+                const float distance = segment.distances[j];
                 // count particles that are fully in the r_max sphere
-                if (nb.distance < (m_r_max - m_diameter / float(2.0)))
+                if (distance < m_r_full)
                 {
                     num_neighbors += float(1.0);
                 }
@@ -43,21 +62,46 @@ void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
                     // this is not particularly accurate for a single particle, but works well on average for
                     // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
                     // that obscure data
-                    num_neighbors
-                        += float(1.0) + (m_r_max - (nb.distance + m_diameter / float(2.0))) / m_diameter;
-                }
-                m_num_neighbors_array[i] = num_neighbors;
-                if (m_box.is2D())
-                {
-                    // local density is area of particles divided by the area of the circle
-                    m_density_array[i] = m_num_neighbors_array[i] / area;
-                }
-                else
-                {
-                    // local density is volume of particles divided by the volume of the sphere
-                    m_density_array[i] = m_num_neighbors_array[i] / volume;
+                    num_neighbors += m_overlap_offset - m_overlap_slope * distance;
                 }
             }
+            m_num_neighbors_array[segment.query_point_idx] = num_neighbors;
+            m_density_array[segment.query_point_idx] = num_neighbors * density_scale;
+        });
+}
+
+void LocalDensity::computeAdaptive(const freud::locality::NeighborQuery* neighbor_query,
+                                   const vec3<float>* query_points, unsigned int n_query_points,
+                                   freud::locality::QueryArgs qargs)
+{
+    if (qargs.mode != freud::locality::QueryType::nearest)
+    {
+        throw std::invalid_argument("The adaptive local density requires a nearest neighbor query.");
+    }
+    m_box = neighbor_query->getBox();
+
+    m_density_array.prepare(n_query_points);
+    m_num_neighbors_array.prepare(n_query_points);
+
+    const bool is2D = m_box.is2D();
+    const float unit_scale = unitSphereInverseMeasure();
+    freud::locality::loopOverNeighborsIterator(
+        neighbor_query, query_points, n_query_points, qargs, nullptr,
+        [=](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
+            unsigned int num_neighbors = 0;
+            float r_far = 0;
+            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            {
+                ++num_neighbors;
+                r_far = std::max(r_far, nb.distance);
+            }
+            m_num_neighbors_array[i] = static_cast<float>(num_neighbors);
+            // the density is undefined if all neighbors coincide with the query point
+            if (r_far > 0)
+            {
+                const float r_far_measure = is2D ? r_far * r_far : r_far * r_far * r_far;
+                m_density_array[i] = static_cast<float>(num_neighbors) * unit_scale / r_far_measure;
+            }
         });
 }
 
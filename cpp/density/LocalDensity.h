@@ -17,7 +17,15 @@
 namespace freud { namespace density {
 
 //! Compute the local density at each point
-/*!
+/*! Each neighbor counts fully if it lies within r_max - diameter / 2 of the
+ *  query point and linearly less up to r_max + diameter / 2. The
+ *  coefficients of this overlap function and the normalization by the area
+ *  or volume of the r_max sphere are computed at construction.
+ *
+ *  In the adaptive mode, the density around each query point is instead the
+ *  number of its nearest neighbors divided by the area or volume of the
+ *  sphere that reaches the farthest of them, so the radius adapts to the
+ *  local density.
  */
 class LocalDensity
 {
@@ -51,6 +59,19 @@ public:
                  unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs);
 
+    //! Compute the local density from the distances to a fixed number of nearest neighbors
+    /*! The neighbors of each query point are accumulated directly from the
+     *  query iterators, without building a NeighborList.
+     *
+     *  \param neighbor_query NeighborQuery object to find neighbors with.
+     *  \param query_points Query points to compute the density around.
+     *  \param n_query_points Number of query_points.
+     *  \param qargs Query arguments of a nearest neighbor query.
+     */
+    void computeAdaptive(const freud::locality::NeighborQuery* neighbor_query,
+                         const vec3<float>* query_points, unsigned int n_query_points,
+                         freud::locality::QueryArgs qargs);
+
     //! Get a reference to the last computed density
     const util::ManagedArray<float>& getDensity() const
     {
@@ -64,9 +85,15 @@ public:
     }
 
 private:
-    box::Box m_box;   //!< Simulation box where the particles belong
-    float m_r_max;    //!< Maximum neighbor distance
-    float m_diameter; //!< Diameter of the particles
+    //! Compute the inverse area or volume of spheres of unit radius in the box
+    float unitSphereInverseMeasure() const;
+
+    box::Box m_box;         //!< Simulation box where the particles belong
+    float m_r_max;          //!< Maximum neighbor distance
+    float m_diameter;       //!< Diameter of the particles
+    float m_r_full;         //!< Distance within which neighbors are counted fully
+    float m_overlap_offset; //!< Overlap of a neighbor at zero distance, extrapolated linearly
+    float m_overlap_slope;  //!< Decrease of the overlap per unit distance
 
     util::ManagedArray<float> m_density_array;       //!< density array computed
     util::ManagedArray<float> m_num_neighbors_array; //!< number of neighbors array computed
@@ -0,0 +1,140 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "PartialRDF.h"
+
+/*! \file PartialRDF.cc
+    \brief Routines for computing the radial density functions of all pairs of types.
+*/
+
+namespace freud { namespace density {
+
+PartialRDF::PartialRDF(unsigned int bins, float r_max, unsigned int n_types, float r_min)
+    : BondHistogramCompute(), m_n_types(n_types), m_query_type_counts(n_types, 0),
+      m_pair_densities(static_cast<size_t>(n_types) * n_types, 0)
+{
+    if (bins == 0)
+    {
+        throw std::invalid_argument("PartialRDF requires a nonzero number of bins.");
+    }
+    if (n_types == 0)
+    {
+        throw std::invalid_argument("PartialRDF requires a nonzero number of types.");
+    }
+    if (r_max <= 0)
+    {
+        throw std::invalid_argument("PartialRDF requires r_max to be positive.");
+    }
+    if (r_max <= r_min)
+    {
+        throw std::invalid_argument("PartialRDF requires that r_max must be greater than r_min.");
+    }
+
+    // The types are binned by unit width axes, so that the first two indices
+    // of a bin are the types of the query point and the point of a bond.
+    BHAxes axes;
+    axes.push_back(std::make_shared<util::RegularAxis>(n_types, 0, static_cast<float>(n_types)));
+    axes.push_back(std::make_shared<util::RegularAxis>(n_types, 0, static_cast<float>(n_types)));
+    axes.push_back(std::make_shared<util::RegularAxis>(bins, r_min, r_max));
+    m_histogram = BondHistogram(axes);
+    m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+
+    // Precompute the cell volumes to speed up later calculations.
+    m_vol_array2D.resize(bins);
+    m_vol_array3D.resize(bins);
+    float volume_prefactor = (float(4.0) / float(3.0)) * M_PI;
+    std::vector<float> bin_boundaries = getBinEdges()[2];
+
+    for (unsigned int i = 0; i < bins; i++)
+    {
+        float r = bin_boundaries[i];
+        float nextr = bin_boundaries[i + 1];
+        m_vol_array2D[i] = M_PI * (nextr * nextr - r * r);
+        m_vol_array3D[i] = volume_prefactor * (nextr * nextr * nextr - r * r * r);
+    }
+}
+
+void PartialRDF::reset()
+{
+    BondHistogramCompute::reset();
+    std::fill(m_query_type_counts.begin(), m_query_type_counts.end(), 0);
+    std::fill(m_pair_densities.begin(), m_pair_densities.end(), 0);
+}
+
+void PartialRDF::reduce()
+{
+    const std::vector<size_t> shape = m_histogram.shape();
+    const size_t bins = shape[2];
+    m_pcf.prepare(shape);
+    m_N_r.prepare(shape);
+
+    const std::vector<float>& vol_array = m_box.is2D() ? m_vol_array2D : m_vol_array3D;
+    reduceBinCounts([&](size_t i) {
+        const double pair_density = m_pair_densities[i / bins];
+        m_pcf[i] = pair_density == 0
+            ? float(0)
+            : static_cast<float>(static_cast<double>(getBinCount(i)) / (pair_density * vol_array[i % bins]));
+    });
+
+    // The accumulation of the cumulative density must be performed in
+    // sequence, so it is done after the reduction.
+    for (size_t pair = 0; pair < m_pair_densities.size(); ++pair)
+    {
+        const double query_count = m_query_type_counts[pair / m_n_types];
+        double n_r = 0;
+        for (size_t i = pair * bins; i < (pair + 1) * bins; ++i)
+        {
+            n_r += query_count == 0 ? 0 : static_cast<double>(getBinCount(i)) / query_count;
+            m_N_r[i] = static_cast<float>(n_r);
+        }
+    }
+}
+
+void PartialRDF::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                            const unsigned int* point_types, const vec3<float>* query_points,
+                            const unsigned int* query_point_types, unsigned int n_query_points,
+                            const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+{
+    std::vector<double> point_type_counts(m_n_types, 0);
+    std::vector<double> query_type_counts(m_n_types, 0);
+    for (unsigned int i = 0; i < neighbor_query->getNPoints(); ++i)
+    {
+        if (point_types[i] >= m_n_types)
+        {
+            throw std::invalid_argument("PartialRDF point types must be less than the number of types.");
+        }
+        ++point_type_counts[point_types[i]];
+    }
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        if (query_point_types[i] >= m_n_types)
+        {
+            throw std::invalid_argument(
+                "PartialRDF query point types must be less than the number of types.");
+        }
+        ++query_type_counts[query_point_types[i]];
+    }
+
+    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                      [=](const freud::locality::NeighborBond& neighbor_bond) {
+                          const unsigned int query_type = query_point_types[neighbor_bond.query_point_idx];
+                          const unsigned int point_type = point_types[neighbor_bond.point_idx];
+                          m_local_histograms(static_cast<float>(query_type), static_cast<float>(point_type),
+                                             neighbor_bond.distance);
+                      });
+
+    const double volume = m_box.getVolume();
+    for (unsigned int a = 0; a < m_n_types; ++a)
+    {
+        m_query_type_counts[a] += query_type_counts[a];
+        for (unsigned int b = 0; b < m_n_types; ++b)
+        {
+            m_pair_densities[a * m_n_types + b] += query_type_counts[a] * point_type_counts[b] / volume;
+        }
+    }
+}
+
+}; }; // end namespace freud::density
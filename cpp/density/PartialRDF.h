@@ -0,0 +1,96 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PARTIAL_RDF_H
+#define PARTIAL_RDF_H
+
+#include <vector>
+
+#include "BondHistogramCompute.h"
+#include "Box.h"
+#include "Histogram.h"
+
+/*! \file PartialRDF.h
+    \brief Routines for computing the radial density functions of all pairs of types.
+*/
+
+namespace freud { namespace density {
+
+//! Compute the partial RDFs of all pairs of types of a mixture.
+/*! The bonds of all pairs of types are found by a single query over all
+ *  points, and each bond is binned into a histogram of shape (n_types,
+ *  n_types, bins) by the type of its query point, the type of its point and
+ *  its distance.
+ */
+class PartialRDF : public locality::BondHistogramCompute
+{
+public:
+    //! Constructor
+    PartialRDF(unsigned int bins, float r_max, unsigned int n_types, float r_min = 0);
+
+    //! Destructor
+    ~PartialRDF() override = default;
+
+    //! Reset the histogram and the numbers of points of each type to all zeros
+    void reset() override;
+
+    //! Compute the partial RDFs
+    /*! Accumulate the given points to the histogram. Accumulation is performed
+     * in parallel on thread-local copies of the data, which are reduced into
+     * the primary data arrays when the user requests outputs.
+     *
+     * \param neighbor_query NeighborQuery of the points.
+     * \param point_types The type of each point.
+     * \param query_points The query points.
+     * \param query_point_types The type of each query point.
+     * \param n_query_points The number of query points.
+     * \param nlist NeighborList to use, or nullptr to query neighbor_query.
+     * \param qargs The query arguments.
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const unsigned int* point_types,
+                    const vec3<float>* query_points, const unsigned int* query_point_types,
+                    unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                    freud::locality::QueryArgs qargs);
+
+    //! Reduce thread-local arrays onto the primary data arrays.
+    void reduce() override;
+
+    //! Get the number of types
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get the partial pair correlation functions, of shape (n_types, n_types, bins).
+    /*! Element (a, b, i) is the RDF of the points of type b around the query
+     * points of type a.
+     */
+    const util::ManagedArray<float>& getRDF()
+    {
+        return reduceAndReturn(m_pcf);
+    }
+
+    //! Get the cumulative bin sums, of shape (n_types, n_types, bins).
+    /*! Element (a, b, i) is the average number of points of type b contained
+     * within a ball of radius getBinEdges()[2][i+1] centered at a query point
+     * of type a.
+     */
+    const util::ManagedArray<float>& getNr()
+    {
+        return reduceAndReturn(m_N_r);
+    }
+
+private:
+    unsigned int m_n_types;                  //!< Number of types
+    std::vector<double> m_query_type_counts; //!< Query points of each type summed over frames
+    std::vector<double> m_pair_densities;    //!< Numbers of query points times number densities of the
+                                             //!< points of each pair of types summed over frames
+    util::ManagedArray<float> m_pcf;         //!< The computed partial pair correlation functions.
+    util::ManagedArray<float> m_N_r;         //!< Cumulative bin sums N(r) of each pair of types.
+    std::vector<float> m_vol_array2D;        //!< Areas of the rings of the histogram bins in 2D.
+    std::vector<float> m_vol_array3D;        //!< Volumes of the shells of the histogram bins in 3D.
+};
+
+}; }; // end namespace freud::density
+
+#endif // PARTIAL_RDF_H
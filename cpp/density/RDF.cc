@@ -1,6 +1,9 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 #include "RDF.h"
@@ -11,8 +14,8 @@
 
 namespace freud { namespace density {
 
-RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
-    : BondHistogramCompute(), m_normalize(normalize)
+RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize, unsigned int block_size)
+    : BondHistogramCompute(), m_normalize(normalize), m_block_size(block_size)
 {
     if (bins == 0)
     {
@@ -32,6 +35,7 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     axes.push_back(std::make_shared<util::RegularAxis>(bins, r_min, r_max));
     m_histogram = BondHistogram(axes);
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+    m_distance_sq_bins = util::SquaredBinTable(*axes[0]);
 
     // Precompute the cell volumes to speed up later calculations.
     m_vol_array2D.prepare(bins);
@@ -46,12 +50,29 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
         m_vol_array2D[i] = M_PI * (nextr * nextr - r * r);
         m_vol_array3D[i] = volume_prefactor * (nextr * nextr * nextr - r * r * r);
     }
+
+    if (m_block_size != 0)
+    {
+        m_block_start.resize(bins, 0);
+        m_block_moment_mean.resize(bins, 0);
+        m_block_moment_m2.resize(bins, 0);
+    }
+}
+
+void RDF::reset()
+{
+    BondHistogramCompute::reset();
+    m_n_blocks = 0;
+    m_block_frames = 0;
+    m_block_pair_density = 0;
+    std::fill(m_block_start.begin(), m_block_start.end(), 0);
+    std::fill(m_block_moment_mean.begin(), m_block_moment_mean.end(), 0);
+    std::fill(m_block_moment_m2.begin(), m_block_moment_m2.end(), 0);
 }
 
 void RDF::reduce()
 {
     m_pcf.prepare(getAxisSizes()[0]);
-    m_histogram.prepare(getAxisSizes()[0]);
     m_N_r.prepare(getAxisSizes()[0]);
 
     // Define prefactors with appropriate types to simplify and speed later code.
@@ -65,28 +86,121 @@ void RDF::reduce()
     float prefactor = float(1.0) / (np * number_density * nf);
 
     util::ManagedArray<float> vol_array = m_box.is2D() ? m_vol_array2D : m_vol_array3D;
-    m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &vol_array](size_t i) {
-        m_pcf[i] = m_histogram[i] * prefactor / vol_array[i];
+    reduceBinCounts([this, &prefactor, &vol_array](size_t i) {
+        m_pcf[i] = static_cast<float>(getBinCount(i)) * prefactor / vol_array[i];
     });
 
     // The accumulation of the cumulative density must be performed in
     // sequence, so it is done after the reduction.
     prefactor = float(1.0) / (np * static_cast<float>(m_frame_counter));
-    m_N_r[0] = m_histogram[0] * prefactor;
+    m_N_r[0] = static_cast<float>(getBinCount(0)) * prefactor;
     for (unsigned int i = 1; i < getAxisSizes()[0]; i++)
     {
-        m_N_r[i] = m_N_r[i - 1] + m_histogram[i] * prefactor;
+        m_N_r[i] = m_N_r[i - 1] + static_cast<float>(getBinCount(i)) * prefactor;
+    }
+
+    if (m_block_size != 0)
+    {
+        const auto n_blocks = static_cast<double>(m_n_blocks);
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        m_block_mean.prepare(getAxisSizes()[0]);
+        m_block_error.prepare(getAxisSizes()[0]);
+        for (unsigned int i = 0; i < getAxisSizes()[0]; i++)
+        {
+            m_block_mean[i] = m_n_blocks == 0 ? nan : static_cast<float>(m_block_moment_mean[i]);
+            m_block_error[i] = m_n_blocks < 2
+                ? nan
+                : static_cast<float>(std::sqrt(m_block_moment_m2[i] / ((n_blocks - 1) * n_blocks)));
+        }
     }
 }
 
+void RDF::addBlock()
+{
+    // The counts of the block are the differences between the total counts
+    // and the counts at the end of the previous block. With 32 bit counts the
+    // totals are only held by the thread local histograms, so they are
+    // reduced once per block rather than once per frame.
+    const size_t bins = m_histogram.size();
+    if (m_precision == util::CountPrecision::uint32)
+    {
+        m_frame_counts.prepareUninitialized(bins);
+        m_local_histograms.reduceInto(m_frame_counts);
+    }
+
+    // The blocks are averaged with Welford's algorithm.
+    ++m_n_blocks;
+    const util::ManagedArray<float>& vol_array = m_box.is2D() ? m_vol_array2D : m_vol_array3D;
+    for (size_t i = 0; i < bins; ++i)
+    {
+        const std::uint64_t total
+            = m_precision == util::CountPrecision::uint32 ? m_frame_counts[i] : m_wide_totals[i];
+        const double block_rdf
+            = static_cast<double>(total - m_block_start[i]) / (m_block_pair_density * vol_array[i]);
+        const double delta = block_rdf - m_block_moment_mean[i];
+        m_block_moment_mean[i] += delta / static_cast<double>(m_n_blocks);
+        m_block_moment_m2[i] += delta * (block_rdf - m_block_moment_mean[i]);
+        m_block_start[i] = total;
+    }
+    m_block_frames = 0;
+    m_block_pair_density = 0;
+}
+
 void RDF::accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                      unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                      freud::locality::QueryArgs qargs)
 {
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          m_local_histograms(neighbor_bond.distance);
-                      });
+    // The bonds hold squared distances, which are binned without square roots.
+    accumulateGeneral(
+        neighbor_query, query_points, n_query_points, nlist, qargs,
+        [=](const freud::locality::NeighborBond& neighbor_bond) {
+            m_local_histograms.increment(m_distance_sq_bins.bin(neighbor_bond.distance));
+        },
+        true);
+    addFrameToBlock(neighbor_query->getNPoints(), n_query_points);
+}
+
+void RDF::addFrameToBlock(unsigned int n_points, unsigned int n_query_points)
+{
+    if (m_block_size != 0)
+    {
+        // The same normalization as in reduce, summed over the frames of the block.
+        const auto nq = static_cast<double>(m_normalize ? n_query_points - 1 : n_query_points);
+        m_block_pair_density += static_cast<double>(n_points) * nq / m_box.getVolume();
+        if (++m_block_frames == m_block_size)
+        {
+            addBlock();
+        }
+    }
+}
+
+void RDF::accumulateTrajectory(const locality::FrameSource& source, freud::locality::QueryArgs qargs)
+{
+    locality::processTrajectory(source,
+                                [&](size_t /*index*/, const locality::NeighborQuery* neighbor_query,
+                                    const locality::TrajectoryFrame& frame) {
+                                    accumulate(neighbor_query, frame.points, frame.n_points, nullptr, qargs);
+                                });
+}
+
+void RDF::accumulateSlabs(const box::Box& box, const locality::SlabSource& source, unsigned int n_slabs,
+                          freud::locality::QueryArgs qargs, const locality::SlabDomain& domain)
+{
+    const unsigned int n_points = BondHistogramCompute::accumulateSlabs(
+        box, source, n_slabs, qargs,
+        [=](const freud::locality::NeighborBond& neighbor_bond) {
+            m_local_histograms.increment(m_distance_sq_bins.bin(neighbor_bond.distance));
+        },
+        domain, true);
+    addFrameToBlock(n_points, n_points);
+}
+
+locality::FrameTask RDF::makeFrameTask(unsigned int neighbors)
+{
+    return [this, neighbors](const locality::FrameContext& context) {
+        accumulate(context.neighbor_query, context.frame->points, context.frame->n_points,
+                   context.getNeighborList(neighbors), locality::QueryArgs());
+    };
 }
 
 }; }; // end namespace freud::density
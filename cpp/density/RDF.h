@@ -4,24 +4,42 @@
 #ifndef RDF_H
 #define RDF_H
 
+#include <cstdint>
+#include <vector>
+
+#include "AnalysisGraph.h"
 #include "BondHistogramCompute.h"
 #include "Box.h"
 #include "Histogram.h"
+#include "SlabStream.h"
+#include "TrajectoryPipeline.h"
 
 /*! \file RDF.h
     \brief Routines for computing radial density functions.
 */
 
 namespace freud { namespace density {
+
+//! Compute the radial distribution function
+/*! With a nonzero block size, the frames are also averaged in blocks of
+ *  block_size consecutive frames. The RDF of each block is computed from the
+ *  bin counts of the block when its last frame is accumulated, and added to
+ *  running moments, from which the mean and standard error of the mean of
+ *  the blocks are computed. The frames of an incomplete last block only
+ *  contribute to the RDF of all frames.
+ */
 class RDF : public locality::BondHistogramCompute
 {
 public:
     //! Constructor
-    RDF(unsigned int bins, float r_max, float r_min = 0, bool normalize = false);
+    RDF(unsigned int bins, float r_max, float r_min = 0, bool normalize = false, unsigned int block_size = 0);
 
     //! Destructor
     ~RDF() override = default;
 
+    //! Reset the histogram and the blocks to all zeros
+    void reset() override;
+
     //! Compute the RDF
     /*! Accumulate the given points to the histogram. Accumulation is performed
      * in parallel on thread-local copies of the data, which are reduced into
@@ -31,6 +49,33 @@ public:
                     unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                     freud::locality::QueryArgs qargs);
 
+    //! Compute the RDF of every frame of a trajectory
+    /*! Accumulate the bonds between the points of each frame to the
+     * histogram. The neighbor queries of the following frames are built
+     * while the bonds of each frame are binned, see
+     * locality::processTrajectory.
+     */
+    void accumulateTrajectory(const locality::FrameSource& source, freud::locality::QueryArgs qargs);
+
+    //! Compute the RDF of a system streamed in slabs
+    /*! Accumulate the bonds between the points of a system that does not fit
+     * in memory to the histogram as a single frame, loading one slab of the
+     * system and the halo around it at a time, see locality::processSlabs.
+     * The query arguments must set a finite r_max, which is the width of the
+     * halos. In a domain decomposition, each process accumulates the slabs
+     * of its domain and the counts are summed over the processes with the
+     * reducer of the domain, so every process holds the RDF of the whole
+     * system.
+     */
+    void accumulateSlabs(const box::Box& box, const locality::SlabSource& source, unsigned int n_slabs,
+                         freud::locality::QueryArgs qargs,
+                         const locality::SlabDomain& domain = locality::SlabDomain());
+
+    //! Get a task accumulating the bonds of a neighbor node of an AnalysisGraph
+    /*! \param neighbors The neighbor node of the bonds.
+     */
+    locality::FrameTask makeFrameTask(unsigned int neighbors);
+
     //! Reduce thread-local arrays onto the primary data arrays.
     void reduce() override;
 
@@ -50,7 +95,37 @@ public:
         return reduceAndReturn(m_N_r);
     }
 
+    //! Get the number of frames of each block, or 0 if blocks are not computed
+    unsigned int getBlockSize() const
+    {
+        return m_block_size;
+    }
+
+    //! Get the number of complete blocks accumulated since the last reset
+    unsigned int getNumBlocks() const
+    {
+        return m_n_blocks;
+    }
+
+    //! Get the mean of the RDFs of the blocks, or NaN if there are none.
+    const util::ManagedArray<float>& getBlockMean()
+    {
+        return reduceAndReturn(m_block_mean);
+    }
+
+    //! Get the standard error of the mean of the RDFs of the blocks, or NaN if there are fewer than two.
+    const util::ManagedArray<float>& getBlockStandardError()
+    {
+        return reduceAndReturn(m_block_error);
+    }
+
 private:
+    //! Add an accumulated frame to the current block, completing the block if it is full
+    void addFrameToBlock(unsigned int n_points, unsigned int n_query_points);
+
+    //! Add the RDF of the frames accumulated since the last block to the moments of the blocks
+    void addBlock();
+
     bool m_normalize;                //!< Whether to enforce that the RDF should tend to 1 (instead of
                                      //!< num_query_points/num_points).
     util::ManagedArray<float> m_pcf; //!< The computed pair correlation function.
@@ -60,6 +135,18 @@ private:
         m_vol_array2D; //!< Areas of concentric rings corresponding to the histogram bins in 2D.
     util::ManagedArray<float>
         m_vol_array3D; //!< Areas of concentric spherical shells corresponding to the histogram bins in 3D.
+    util::SquaredBinTable m_distance_sq_bins; //!< Bins of the squared bond distances.
+
+    unsigned int m_block_size;                //!< Number of frames of each block, 0 without blocks.
+    unsigned int m_n_blocks {0};              //!< Number of complete blocks.
+    unsigned int m_block_frames {0};          //!< Number of frames of the current block.
+    double m_block_pair_density {0};          //!< Sum over the frames of the current block of the
+                                              //!< number of points times the query point density.
+    std::vector<std::uint64_t> m_block_start; //!< Bin counts before the current block.
+    std::vector<double> m_block_moment_mean;  //!< Running mean of the RDFs of the blocks.
+    std::vector<double> m_block_moment_m2;    //!< Running sum of squared deviations from the mean.
+    util::ManagedArray<float> m_block_mean;   //!< Mean of the RDFs of the blocks.
+    util::ManagedArray<float> m_block_error;  //!< Standard error of the mean of the RDFs of the blocks.
 };
 
 }; }; // end namespace freud::density
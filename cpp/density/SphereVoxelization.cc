@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "SphereVoxelization.h"
 
@@ -35,6 +36,24 @@ vec3<unsigned int> SphereVoxelization::getWidth() const
 
 //! Compute the voxels array.
 void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
+{
+    computeGrid(nq, nullptr, 0);
+}
+
+//! Compute the voxels array and write it to a file.
+void SphereVoxelization::computeToFile(const freud::locality::NeighborQuery* nq, const std::string& filename,
+                                       unsigned int slab_width)
+{
+    if (nq->getBox().is2D())
+    {
+        m_width.z = 1;
+    }
+    GridFileWriter writer(filename, m_width, sizeof(unsigned int));
+    computeGrid(nq, &writer, slab_width);
+}
+
+void SphereVoxelization::computeGrid(const freud::locality::NeighborQuery* nq, GridFileWriter* writer,
+                                     unsigned int slab_width)
 {
     // Set the number of dimensions for the calculation the first time it is done.
     if (!m_has_computed || nq->getBox().is2D() == m_box.is2D())
@@ -58,7 +77,10 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
         m_width.z = 1;
     }
 
-    m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+    if (writer == nullptr)
+    {
+        m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+    }
 
     // set up some constants first
     const float Lx = m_box.getLx();
@@ -76,9 +98,18 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
     const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
     const float r_max_sq = m_r_max * m_r_max;
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
-        // for each reference point
-        for (size_t idx = begin; idx < end; ++idx)
+    GridTiling tiling(m_width, periodic, vec3<int>(bin_cut_x, bin_cut_y, bin_cut_z));
+    tiling.assign(n_points, [&](size_t idx, vec3<int>& first, vec3<int>& last) {
+        const vec3<float> point = (*nq)[idx];
+        const int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
+        const int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
+        first = vec3<int>(bin_x - bin_cut_x, bin_y - bin_cut_y, 0);
+        last = vec3<int>(bin_x + bin_cut_x, bin_y + bin_cut_y, 0);
+    });
+
+    const auto fill_tile = [&](const GridTile& tile, const TilePoints& points,
+                               unsigned int x_begin) {
+        for (const unsigned int idx : points)
         {
             const vec3<float> point = (*nq)[idx];
             // Find which bin the particle is in
@@ -88,7 +119,7 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
             const int bin_z = m_box.is2D() ? 0 : int((point.z + Lz / float(2.0)) / grid_size_z);
 
             // Only evaluate over bins that are within the cutoff, rejecting bins
-            // that are outside the box in aperiodic directions.
+            // that are outside the box in aperiodic directions or outside the tile.
             for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
             {
                 if (!periodic.z && (k < 0 || k >= int(m_width.z)))
@@ -100,7 +131,10 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
 
                 for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
                 {
-                    if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                    // Assure that out of range indices are corrected for storage
+                    // in the array i.e. bin -1 is actually bin 29 for nbins = 30
+                    const unsigned int nj = (j + m_width.y) % m_width.y;
+                    if ((!periodic.y && (j < 0 || j >= int(m_width.y))) || !tile.containsY(nj))
                     {
                         continue;
                     }
@@ -109,7 +143,8 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
 
                     for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
                     {
-                        if (!periodic.x && (i < 0 || i >= int(m_width.x)))
+                        const unsigned int ni = (i + m_width.x) % m_width.x;
+                        if ((!periodic.x && (i < 0 || i >= int(m_width.x))) || !tile.containsX(ni))
                         {
                             continue;
                         }
@@ -124,21 +159,17 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
                         // Check to see if this distance is within the specified r_max
                         if (r_sq < r_max_sq)
                         {
-                            // Assure that out of range indices are corrected for storage
-                            // in the array i.e. bin -1 is actually bin 29 for nbins = 30
-                            const unsigned int ni = (i + m_width.x) % m_width.x;
-                            const unsigned int nj = (j + m_width.y) % m_width.y;
                             const unsigned int nk = (k + m_width.z) % m_width.z;
 
-                            // This array value could be written by multiple threads in parallel.
-                            // This is only safe because all threads are writing the same value (1).
-                            m_voxels_array(ni, nj, nk) = 1;
+                            // Only this tile writes to the grid cell.
+                            m_voxels_array(ni - x_begin, nj, nk) = 1;
                         }
                     }
                 }
             }
         }
-    });
+    };
+    fillGridSlabs(tiling, m_voxels_array, m_width, writer, slab_width, fill_tile);
 }
 
 }; }; // end namespace freud::density
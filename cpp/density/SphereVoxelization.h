@@ -4,7 +4,10 @@
 #ifndef SPHERE_VOXELIZATION_H
 #define SPHERE_VOXELIZATION_H
 
+#include <string>
+
 #include "Box.h"
+#include "GridFile.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
@@ -22,6 +25,10 @@ namespace freud { namespace density {
     otherwise. The dimensions of the grid are set in the constructor, and can
     either be set equally for all dimensions or for each dimension
     independently.
+
+    Grids too large to be held in memory can be written to a file instead,
+    in slabs of consecutive cells along x, so that only one slab is held in
+    memory at a time.
 */
 class SphereVoxelization
 {
@@ -47,12 +54,28 @@ public:
     //! Compute the voxelization.
     void compute(const freud::locality::NeighborQuery* nq);
 
+    //! Compute the voxelization and write it to a file instead of holding it in memory.
+    /*! The file is written by a GridFileWriter, and getVoxels returns an
+     *  empty array afterwards.
+     *
+     *  \param nq NeighborQuery of the points.
+     *  \param filename Path of the file.
+     *  \param slab_width Number of cells along x of the slabs held in memory,
+     *         rounded up to the width of the tiles that are filled in parallel.
+     */
+    void computeToFile(const freud::locality::NeighborQuery* nq, const std::string& filename,
+                       unsigned int slab_width = 0);
+
     //! Get a reference to the last computed voxels.
     const util::ManagedArray<unsigned int>& getVoxels() const;
 
     vec3<unsigned int> getWidth() const;
 
 private:
+    //! Compute the voxelization in memory, or in slabs written to a file if a writer is given
+    void computeGrid(const freud::locality::NeighborQuery* nq, GridFileWriter* writer,
+                     unsigned int slab_width);
+
     box::Box m_box;             //!< Simulation box containing the points.
     vec3<unsigned int> m_width; //!< Number of bins in the grid in each dimension.
     float m_r_max;              //!< Sphere radius used for voxelization.
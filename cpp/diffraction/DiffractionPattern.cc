@@ -0,0 +1,255 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "DiffractionPattern.h"
+#include "utils.h"
+
+/*! \file DiffractionPattern.cc
+    \brief Computes 2D diffraction patterns.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Get the box matrix, whose columns are the box vectors
+inline void getBoxMatrix(const box::Box& box, double matrix[3][3])
+{
+    const vec3<double> L(box.getL());
+    const double rows[3][3] = {{L.x, box.getTiltFactorXY() * L.y, box.getTiltFactorXZ() * L.z},
+                               {0, L.y, box.getTiltFactorYZ() * L.z},
+                               {0, 0, L.z}};
+    std::copy(&rows[0][0], &rows[0][0] + 9, &matrix[0][0]);
+}
+
+//! Get the largest element of the box matrix, which sets the scale of the k-vectors
+inline double getBoxScale(const double matrix[3][3])
+{
+    return *std::max_element(&matrix[0][0], &matrix[0][0] + 9);
+}
+
+DiffractionPattern::DiffractionPattern(unsigned int grid_size, unsigned int output_size)
+    : m_grid_size(grid_size), m_output_size(output_size),
+      m_fft_plan(std::vector<size_t> {std::max(grid_size, 1U), std::max(grid_size, 1U)}),
+      m_local_bins({grid_size, grid_size}), m_grid(size_t(grid_size) * grid_size),
+      m_intensity(size_t(grid_size) * grid_size), m_sum(size_t(output_size) * output_size, 0)
+{
+    if (grid_size == 0 || output_size == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires a positive grid_size and output_size.");
+    }
+}
+
+void DiffractionPattern::reset()
+{
+    std::fill(m_sum.begin(), m_sum.end(), 0);
+    m_num_views = 0;
+}
+
+void DiffractionPattern::accumulate(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                    const quat<float>* views, unsigned int n_views, double zoom,
+                                    double peak_width)
+{
+    if (n_points == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires at least one point.");
+    }
+    if (n_views == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires at least one view orientation.");
+    }
+
+    for (unsigned int v = 0; v < n_views; ++v)
+    {
+        accumulateView(box, points, n_points, quat<double>(views[v]), zoom, peak_width);
+    }
+    m_num_views += n_views;
+
+    // The outputs are prepared rather than updated in place, so arrays that
+    // were returned for earlier computes are left unchanged.
+    const size_t n_out = m_output_size;
+    m_diffraction.prepare({n_out, n_out});
+    const double inv_num_views = 1.0 / static_cast<double>(m_num_views);
+    for (size_t i = 0; i < m_sum.size(); ++i)
+    {
+        m_diffraction[i] = m_sum[i] * inv_num_views;
+    }
+
+    double box_matrix[3][3];
+    getBoxMatrix(box, box_matrix);
+    const double k_scale = 2 * M_PI * static_cast<double>(n_out) / (getBoxScale(box_matrix) * zoom);
+    m_k_values.prepare(n_out);
+    for (size_t i = 0; i < n_out; ++i)
+    {
+        // The frequencies of a transform of length n_out, shifted so that the
+        // zero frequency is at index n_out / 2.
+        m_k_values[i] = (static_cast<double>(i) - static_cast<double>(n_out / 2))
+            / static_cast<double>(n_out) * k_scale;
+    }
+
+    const quat<double> last_view(views[n_views - 1]);
+    m_k_vectors.prepare({n_out, n_out});
+    util::forLoopWrapper(0, n_out, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (size_t j = 0; j < n_out; ++j)
+            {
+                m_k_vectors[i * n_out + j]
+                    = rotate(last_view, vec3<double>(m_k_values[i], m_k_values[j], 0));
+            }
+        }
+    });
+}
+
+void DiffractionPattern::accumulateView(const box::Box& box, const vec3<float>* points,
+                                        unsigned int n_points, const quat<double>& view, double zoom,
+                                        double peak_width)
+{
+    const size_t n_grid = m_grid_size;
+    const size_t n_out = m_output_size;
+
+    // Rotate each row of the box matrix by the view orientation.
+    double box_matrix[3][3];
+    getBoxMatrix(box, box_matrix);
+    double rotated[3][3];
+    for (unsigned int row = 0; row < 3; ++row)
+    {
+        const vec3<double> v
+            = rotate(view, vec3<double>(box_matrix[row][0], box_matrix[row][1], box_matrix[row][2]));
+        rotated[row][0] = v.x;
+        rotated[row][1] = v.y;
+        rotated[row][2] = v.z;
+    }
+
+    // Project onto the box face whose area projected along the view axis is
+    // largest. The normal of the face opposite to column c of the box matrix
+    // is the cross product of the other two columns.
+    unsigned int best_axis = 0;
+    double best_projection = -1;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+        const unsigned int prev = (c + 2) % 3;
+        const unsigned int next = (c + 1) % 3;
+        const double projection
+            = std::abs(rotated[0][prev] * rotated[1][next] - rotated[1][prev] * rotated[0][next]);
+        if (projection > best_projection)
+        {
+            best_projection = projection;
+            best_axis = c;
+        }
+    }
+    const unsigned int axis_a = (best_axis + 1) % 3;
+    const unsigned int axis_b = (best_axis + 2) % 3;
+    const double shear[2][2] = {{rotated[0][axis_a], rotated[0][axis_b]},
+                                {rotated[1][axis_a], rotated[1][axis_b]}};
+    const double det = shear[0][0] * shear[1][1] - shear[0][1] * shear[1][0];
+    const double inv_shear[2][2]
+        = {{shear[1][1] / det, -shear[0][1] / det}, {-shear[1][0] / det, shear[0][0] / det}};
+
+    // Bin the fractional coordinates of the projected points.
+    m_local_bins.reset();
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        util::ManagedArray<unsigned int>& bins = m_local_bins.local();
+        unsigned int* counts = bins.get();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<double> r = rotate(view, vec3<double>(points[i]));
+            double x = inv_shear[0][0] * r.x + inv_shear[0][1] * r.y + 0.5;
+            double y = inv_shear[1][0] * r.x + inv_shear[1][1] * r.y + 0.5;
+            x -= std::floor(x);
+            y -= std::floor(y);
+            const size_t bin_x = std::min(static_cast<size_t>(x * static_cast<double>(n_grid)), n_grid - 1);
+            const size_t bin_y = std::min(static_cast<size_t>(y * static_cast<double>(n_grid)), n_grid - 1);
+            ++counts[bin_x * n_grid + bin_y];
+        }
+    });
+    const unsigned int* counts = m_local_bins.reduceInPlace().get();
+    util::forLoopWrapper(0, n_grid * n_grid, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_grid[i] = static_cast<double>(counts[i]);
+        }
+    });
+    m_fft_plan.forward(m_grid.data());
+
+    // Convolve with the Gaussian by multiplying the transform by the Gaussian
+    // exp(-2 pi^2 sigma^2 f^2) of each frequency f along each axis, measured
+    // in cycles per cell. The intensities are written with the zero frequency
+    // moved to index n_grid / 2 along each axis.
+    const double sigma = peak_width / zoom;
+    std::vector<double> gaussian(n_grid);
+    for (size_t i = 0; i < n_grid; ++i)
+    {
+        const double k = (i < (n_grid + 1) / 2) ? static_cast<double>(i)
+                                                : static_cast<double>(i) - static_cast<double>(n_grid);
+        const double f = k / static_cast<double>(n_grid);
+        gaussian[i] = std::exp(-2 * M_PI * M_PI * sigma * sigma * f * f);
+    }
+    util::forLoopWrapper(0, n_grid, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const size_t shifted_i = (i + n_grid / 2) % n_grid;
+            for (size_t j = 0; j < n_grid; ++j)
+            {
+                const size_t shifted_j = (j + n_grid / 2) % n_grid;
+                const double g = gaussian[i] * gaussian[j];
+                m_intensity[shifted_i * n_grid + shifted_j] = std::norm(m_grid[i * n_grid + j]) * g * g;
+            }
+        }
+    });
+
+    // The output image is sheared from the reciprocal grid by the inverse
+    // shear of the projected box and zoomed, with the zero frequency of both
+    // kept at the center of a pixel so that the k = 0 peak is always at
+    // (n_out / 2, n_out / 2). Each output pixel maps back to a point of the
+    // intensity grid through the inverse of the affine transform
+    // zoom * (shear * (grid - center) + output_center).
+    const double center = static_cast<double>(n_grid / 2);
+    const double output_center = static_cast<double>(n_out / 2) / zoom;
+    const double box_scale = getBoxScale(box_matrix);
+    const double forward[2][2] = {{zoom * box_scale * inv_shear[1][0], zoom * box_scale * inv_shear[0][0]},
+                                  {zoom * box_scale * inv_shear[1][1], zoom * box_scale * inv_shear[0][1]}};
+    const double offset[2]
+        = {zoom * (output_center - center * (box_scale * inv_shear[1][0] + box_scale * inv_shear[0][0])),
+           zoom * (output_center - center * (box_scale * inv_shear[1][1] + box_scale * inv_shear[0][1]))};
+    const double forward_det = forward[0][0] * forward[1][1] - forward[0][1] * forward[1][0];
+    const double inverse[2][2] = {{forward[1][1] / forward_det, -forward[0][1] / forward_det},
+                                  {-forward[1][0] / forward_det, forward[0][0] / forward_det}};
+
+    // Intensities are normalized so that S(k = 0) = 1.
+    const double normalization = 1.0 / (static_cast<double>(n_points) * static_cast<double>(n_points));
+    const double max_index = static_cast<double>(n_grid - 1);
+    util::forLoopWrapper(0, n_out, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (size_t j = 0; j < n_out; ++j)
+            {
+                const double di = static_cast<double>(i) - offset[0];
+                const double dj = static_cast<double>(j) - offset[1];
+                const double u = inverse[0][0] * di + inverse[0][1] * dj;
+                const double v = inverse[1][0] * di + inverse[1][1] * dj;
+
+                // Pixels that map outside of the intensity grid are zero.
+                if (!(u >= 0 && u <= max_index && v >= 0 && v <= max_index))
+                {
+                    continue;
+                }
+                const size_t u0 = std::min(static_cast<size_t>(u), n_grid - 1);
+                const size_t v0 = std::min(static_cast<size_t>(v), n_grid - 1);
+                const size_t u1 = std::min(u0 + 1, n_grid - 1);
+                const size_t v1 = std::min(v0 + 1, n_grid - 1);
+                const double wu = u - static_cast<double>(u0);
+                const double wv = v - static_cast<double>(v0);
+                const double* row0 = &m_intensity[u0 * n_grid];
+                const double* row1 = &m_intensity[u1 * n_grid];
+                const double value = (1 - wu) * ((1 - wv) * row0[v0] + wv * row0[v1])
+                    + wu * ((1 - wv) * row1[v0] + wv * row1[v1]);
+                m_sum[i * n_out + j] += value * normalization;
+            }
+        }
+    });
+}
+
+}; }; // end namespace freud::diffraction
@@ -0,0 +1,120 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef DIFFRACTION_PATTERN_H
+#define DIFFRACTION_PATTERN_H
+
+#include <complex>
+#include <vector>
+
+#include "Box.h"
+#include "FFT.h"
+#include "ManagedArray.h"
+#include "ThreadStorage.h"
+#include "VectorMath.h"
+
+/*! \file DiffractionPattern.h
+    \brief Computes 2D diffraction patterns.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Computes the 2D diffraction pattern of a system viewed along one or more directions
+/*! For each view, the points are rotated by the view orientation, projected
+ *  onto the face of the box whose normal is closest to the view axis, and
+ *  binned in fractional coordinates on a grid of grid_size x grid_size cells.
+ *  The squared modulus of the Fourier transform of the grid, multiplied by the
+ *  transform of a Gaussian of width peak_width / zoom (in grid cells), is the
+ *  structure factor S(k) on the reciprocal lattice of the projected box. It is
+ *  resampled with bilinear interpolation onto a square output_size x
+ *  output_size grid of k-vectors that is sheared and zoomed from the
+ *  reciprocal grid, and added directly to the accumulated pattern.
+ *
+ *  The FFT plan for the grid and all work buffers are allocated once and
+ *  reused for every view, so computing many views in one call costs one FFT
+ *  and two passes over the grid per view.
+ */
+class DiffractionPattern
+{
+public:
+    //! Constructor
+    /*! \param grid_size Resolution of the diffraction grid.
+     *  \param output_size Resolution of the output diffraction image.
+     */
+    DiffractionPattern(unsigned int grid_size, unsigned int output_size);
+
+    //! Destructor
+    virtual ~DiffractionPattern() = default;
+
+    //! Discard all accumulated views
+    void reset();
+
+    //! Compute the diffraction pattern of a system for each view and add it to the accumulated pattern
+    /*! \param box Simulation box.
+     *  \param points Positions of the points.
+     *  \param n_points Number of points.
+     *  \param views View orientations as quaternions.
+     *  \param n_views Number of view orientations.
+     *  \param zoom Scaling factor for incident wavevectors.
+     *  \param peak_width Width of the Gaussian convolved with the points, in system length units.
+     */
+    void accumulate(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                    const quat<float>* views, unsigned int n_views, double zoom, double peak_width);
+
+    //! Get the diffraction pattern averaged over all accumulated views
+    const util::ManagedArray<double>& getDiffraction() const
+    {
+        return m_diffraction;
+    }
+
+    //! Get the k-values along each axis of the diffraction pattern
+    const util::ManagedArray<double>& getKValues() const
+    {
+        return m_k_values;
+    }
+
+    //! Get the k-vectors of the diffraction pattern for the last view
+    const util::ManagedArray<vec3<double>>& getKVectors() const
+    {
+        return m_k_vectors;
+    }
+
+    //! Get the number of views accumulated since the last reset
+    unsigned int getNumViews() const
+    {
+        return m_num_views;
+    }
+
+    //! Get the resolution of the diffraction grid
+    unsigned int getGridSize() const
+    {
+        return m_grid_size;
+    }
+
+    //! Get the resolution of the output diffraction image
+    unsigned int getOutputSize() const
+    {
+        return m_output_size;
+    }
+
+private:
+    //! Bin the projected points, transform them and add the resampled intensities of one view
+    void accumulateView(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                        const quat<double>& view, double zoom, double peak_width);
+
+    unsigned int m_grid_size;                                 //!< Resolution of the diffraction grid
+    unsigned int m_output_size;                               //!< Resolution of the output image
+    unsigned int m_num_views {0};                             //!< Number of accumulated views
+    util::FFTNPlan m_fft_plan;                                //!< FFT plan for the diffraction grid
+    util::ThreadStorage<unsigned int> m_local_bins;           //!< Thread local point counts of the grid
+    std::vector<std::complex<double>> m_grid;                 //!< Transformed diffraction grid
+    std::vector<double> m_intensity;                          //!< Centered intensities of the grid
+    std::vector<double> m_sum;                                //!< Sum of the resampled intensities
+    util::ManagedArray<double> m_diffraction;                 //!< Averaged diffraction pattern
+    util::ManagedArray<double> m_k_values;                    //!< k-values along each axis
+    util::ManagedArray<vec3<double>> m_k_vectors;             //!< k-vectors of the last view
+};
+
+}; }; // end namespace freud::diffraction
+
+#endif // DIFFRACTION_PATTERN_H
@@ -0,0 +1,185 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+#include "StaticStructureFactorDirect.h"
+#include "utils.h"
+
+/*! \file StaticStructureFactorDirect.cc
+    \brief Computes the static structure factor by summing over wavevectors.
+*/
+
+namespace freud { namespace diffraction {
+
+StaticStructureFactorDirect::StaticStructureFactorDirect(unsigned int bins, float k_max, float k_min)
+    : BondHistogramCompute()
+{
+    if (bins == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorDirect requires a nonzero number of bins.");
+    }
+    if (k_max <= 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorDirect requires k_max to be positive.");
+    }
+    if (k_min < 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorDirect requires k_min to be non-negative.");
+    }
+    if (k_max <= k_min)
+    {
+        throw std::invalid_argument(
+            "StaticStructureFactorDirect requires that k_max must be greater than k_min.");
+    }
+
+    // The histogram counts the wavevectors in each bin of magnitudes.
+    m_k_axis = std::make_shared<util::RegularAxis>(bins, k_min, k_max);
+    BHAxes axes;
+    axes.push_back(m_k_axis);
+    m_histogram = BondHistogram(axes);
+    m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+    m_local_sums.resize(bins);
+}
+
+void StaticStructureFactorDirect::reset()
+{
+    BondHistogramCompute::reset();
+    m_local_sums.reset();
+}
+
+void StaticStructureFactorDirect::updateKLines(const box::Box& box)
+{
+    if (m_k_lines_valid && box == m_k_lines_box && box.is2D() == m_k_lines_box.is2D())
+    {
+        return;
+    }
+    m_k_lines_box = box;
+    m_k_lines_valid = true;
+    m_k_lines.clear();
+
+    // The reciprocal lattice vectors satisfy a_i . b_j = 2 pi delta_ij.
+    const bool is_2d = box.is2D();
+    const vec3<double> a_1(box.getLatticeVector(0));
+    const vec3<double> a_2(box.getLatticeVector(1));
+    const vec3<double> a_3 = is_2d ? vec3<double>(0, 0, 1) : vec3<double>(box.getLatticeVector(2));
+    const double volume = dot(a_1, cross(a_2, a_3));
+    const double prefactor = 2 * M_PI / volume;
+    m_b_1 = prefactor * cross(a_2, a_3);
+    const vec3<double> b_2 = prefactor * cross(a_3, a_1);
+    const vec3<double> b_3 = prefactor * cross(a_1, a_2);
+
+    double min_valid_k = std::min(std::sqrt(dot(m_b_1, m_b_1)), std::sqrt(dot(b_2, b_2)));
+    if (!is_2d)
+    {
+        min_valid_k = std::min(min_valid_k, std::sqrt(dot(b_3, b_3)));
+    }
+    m_min_valid_k = static_cast<float>(min_valid_k);
+
+    // Since k . a_i = 2 pi n_i for the wavevector with indices n_i, the
+    // indices of wavevectors shorter than k_max are bounded by
+    // k_max |a_i| / (2 pi).
+    const double k_max = m_k_axis->getMax();
+    auto max_index = [k_max](const vec3<double>& a) {
+        return static_cast<int>(std::floor(k_max * std::sqrt(dot(a, a)) / (2 * M_PI)));
+    };
+    const int max_h = max_index(a_1);
+    const int max_m = max_index(a_2);
+    const int max_l = is_2d ? 0 : max_index(a_3);
+    const double k_max_sq = k_max * k_max;
+
+    // Only one of each pair of wavevectors k and -k is kept, so the lines
+    // have l > 0, or l = 0 and m > 0, or l = m = 0 and h > 0.
+    for (int l = 0; l <= max_l; ++l)
+    {
+        for (int m = (l == 0 ? 0 : -max_m); m <= max_m; ++m)
+        {
+            const vec3<double> k_0 = double(m) * b_2 + double(l) * b_3;
+            int h_begin = (l == 0 && m == 0) ? 1 : -max_h;
+            int h_end = max_h + 1;
+            auto k_sq = [&](int h) {
+                const vec3<double> k = k_0 + double(h) * m_b_1;
+                return dot(k, k);
+            };
+            while (h_begin < h_end && k_sq(h_begin) >= k_max_sq)
+            {
+                ++h_begin;
+            }
+            while (h_end > h_begin && k_sq(h_end - 1) >= k_max_sq)
+            {
+                --h_end;
+            }
+            if (h_begin < h_end)
+            {
+                m_k_lines.push_back({k_0, h_begin, h_end});
+            }
+        }
+    }
+}
+
+void StaticStructureFactorDirect::accumulate(const locality::NeighborQuery* neighbor_query)
+{
+    const box::Box& box = neighbor_query->getBox();
+    const vec3<float>* points = neighbor_query->getPoints();
+    const unsigned int n_points = neighbor_query->getNPoints();
+    updateKLines(box);
+
+    const double inv_n_points = 1.0 / static_cast<double>(n_points);
+    util::forLoopWrapper(0, m_k_lines.size(), [&](size_t begin, size_t end) {
+        std::vector<std::complex<double>> densities;
+        auto& local_sums = m_local_sums.local();
+        for (size_t line_index = begin; line_index < end; ++line_index)
+        {
+            const KLine& line = m_k_lines[line_index];
+            const vec3<double> k_begin = line.k_0 + double(line.h_begin) * m_b_1;
+            densities.assign(line.h_end - line.h_begin, 0);
+            for (unsigned int j = 0; j < n_points; ++j)
+            {
+                const vec3<double> r(points[j]);
+                std::complex<double> term = std::polar(1.0, dot(k_begin, r));
+                const std::complex<double> step = std::polar(1.0, dot(m_b_1, r));
+                for (auto& density : densities)
+                {
+                    density += term;
+                    term *= step;
+                }
+            }
+
+            for (int h = line.h_begin; h < line.h_end; ++h)
+            {
+                const vec3<double> k = line.k_0 + double(h) * m_b_1;
+                const size_t bin = m_k_axis->bin(static_cast<float>(std::sqrt(dot(k, k))));
+                if (bin != util::Axis::OVERFLOW_BIN)
+                {
+                    local_sums[bin] += std::norm(densities[h - line.h_begin]) * inv_n_points;
+                    m_local_histograms.increment(bin);
+                }
+            }
+        }
+    });
+
+    m_box = box;
+    m_frame_counter++;
+    m_n_points = n_points;
+    m_n_query_points = n_points;
+    m_reduce_counts = true;
+    m_reduce = true;
+}
+
+void StaticStructureFactorDirect::reduce()
+{
+    const size_t bins = getAxisSizes()[0];
+    m_structure_factor.prepare(bins);
+
+    util::ManagedArray<double> sums(bins);
+    m_local_sums.reduceInto(sums);
+    reduceBinCounts([this, &sums](size_t i) {
+        const std::uint64_t count = getBinCount(i);
+        m_structure_factor[i] = count == 0 ? 0 : static_cast<float>(sums[i] / static_cast<double>(count));
+    });
+}
+
+}; }; // end namespace freud::diffraction
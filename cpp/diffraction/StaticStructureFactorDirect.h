@@ -0,0 +1,101 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef STATIC_STRUCTURE_FACTOR_DIRECT_H
+#define STATIC_STRUCTURE_FACTOR_DIRECT_H
+
+#include <memory>
+#include <vector>
+
+#include "BondHistogramCompute.h"
+#include "Box.h"
+#include "Histogram.h"
+#include "ManagedArray.h"
+#include "NeighborQuery.h"
+#include "ThreadStorage.h"
+#include "VectorMath.h"
+
+/*! \file StaticStructureFactorDirect.h
+    \brief Computes the static structure factor by summing over wavevectors.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Computes the static structure factor S(k) from the density at each wavevector of the reciprocal lattice
+/*! For each wavevector k of the reciprocal lattice of the box with k_min <=
+ *  |k| < k_max, the structure factor
+ *  S(k) = |sum_j exp(i k . r_j)|^2 / N
+ *  is computed directly from the points, and S(k) is averaged over the
+ *  wavevectors whose magnitudes fall in each bin.
+ *
+ *  The wavevectors are processed in parallel along lines k_0 + h b_1 of the
+ *  reciprocal lattice, where b_1 is the first reciprocal lattice vector.
+ *  Along a line, exp(i k . r_j) is updated for consecutive h by multiplying
+ *  it with exp(i b_1 . r_j), so only two trigonometric functions are
+ *  evaluated per point and line rather than per point and wavevector. Since
+ *  S(k) = S(-k), only one of each pair of opposite wavevectors is computed.
+ *
+ *  The histogram of the BondHistogramCompute counts the number of
+ *  wavevectors in each bin, and the structure factor is reduced from the
+ *  thread local sums when requested, so frames are accumulated like the
+ *  bonds of other histogram computes.
+ */
+class StaticStructureFactorDirect : public locality::BondHistogramCompute
+{
+public:
+    //! Constructor
+    /*! \param bins Number of bins of wavevector magnitudes.
+     *  \param k_max Largest wavevector magnitude.
+     *  \param k_min Smallest wavevector magnitude.
+     */
+    StaticStructureFactorDirect(unsigned int bins, float k_max, float k_min = 0);
+
+    //! Destructor
+    ~StaticStructureFactorDirect() override = default;
+
+    //! Reset the structure factor to zero frames
+    void reset() override;
+
+    //! Compute the structure factor of the points and add it to the accumulated frames
+    void accumulate(const locality::NeighborQuery* neighbor_query);
+
+    //! Reduce thread-local arrays onto the primary data arrays.
+    void reduce() override;
+
+    //! Get the structure factor of each bin
+    const util::ManagedArray<float>& getStructureFactor()
+    {
+        return reduceAndReturn(m_structure_factor);
+    }
+
+    //! Get the smallest nonzero wavevector magnitude of the reciprocal lattice of the last box
+    float getMinValidK() const
+    {
+        return m_min_valid_k;
+    }
+
+private:
+    //! A line of wavevectors k_0 + h b_1 of the reciprocal lattice
+    struct KLine
+    {
+        vec3<double> k_0; //!< Wavevector at h = 0
+        int h_begin;      //!< First index along the line
+        int h_end;        //!< One past the last index along the line
+    };
+
+    //! Find the lines of wavevectors within the range of magnitudes for a box
+    void updateKLines(const box::Box& box);
+
+    std::shared_ptr<util::RegularAxis> m_k_axis;  //!< Axis of wavevector magnitudes
+    util::ThreadStorage<double> m_local_sums;     //!< Thread local sums of S(k) in each bin
+    util::ManagedArray<float> m_structure_factor; //!< Structure factor of each bin
+    box::Box m_k_lines_box;                       //!< Box of the current wavevector lines
+    bool m_k_lines_valid {false};                 //!< Whether the wavevector lines are up to date
+    std::vector<KLine> m_k_lines;                 //!< Lines of wavevectors in the range of magnitudes
+    vec3<double> m_b_1;                           //!< First reciprocal lattice vector
+    float m_min_valid_k {0};                      //!< Smallest nonzero wavevector magnitude
+};
+
+}; }; // end namespace freud::diffraction
+
+#endif // STATIC_STRUCTURE_FACTOR_DIRECT_H
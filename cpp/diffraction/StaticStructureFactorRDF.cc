@@ -0,0 +1,132 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <stdexcept>
+
+#include "StaticStructureFactorRDF.h"
+#include "utils.h"
+
+/*! \file StaticStructureFactorRDF.cc
+    \brief Computes the static structure factor from the histogram of pair distances.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Evaluate the polynomial sum_i coefficients[i] y^i
+template<size_t N> inline double evaluatePolynomial(const double (&coefficients)[N], double y)
+{
+    double result = 0;
+    for (size_t i = N; i > 0; --i)
+    {
+        result = result * y + coefficients[i - 1];
+    }
+    return result;
+}
+
+//! Evaluate the Bessel function J_0 with the approximations of Abramowitz and Stegun 9.4.1 and 9.4.3
+inline double besselJ0(double x)
+{
+    x = std::abs(x);
+    if (x <= 3)
+    {
+        static const double series[] = {1,          -2.2499997, 1.2656208, -0.3163866,
+                                        0.0444479, -0.0039444, 0.0002100};
+        return evaluatePolynomial(series, (x / 3) * (x / 3));
+    }
+    static const double modulus[] = {0.79788456,  -0.00000077, -0.00552740, -0.00009512,
+                                     0.00137237, -0.00072805, 0.00014476};
+    static const double phase[] = {-0.78539816, -0.04166397, -0.00003954, 0.00262573,
+                                   -0.00054125, -0.00029333, 0.00013558};
+    const double y = 3 / x;
+    return evaluatePolynomial(modulus, y) * std::cos(x + evaluatePolynomial(phase, y)) / std::sqrt(x);
+}
+
+StaticStructureFactorRDF::StaticStructureFactorRDF(unsigned int bins, float k_max, float k_min,
+                                                   unsigned int r_bins, float r_max, bool lorch_window)
+    : BondHistogramCompute(), m_lorch_window(lorch_window)
+{
+    if (bins == 0 || r_bins == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorRDF requires a nonzero number of bins.");
+    }
+    if (k_max <= 0 || r_max <= 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorRDF requires k_max and r_max to be positive.");
+    }
+    if (k_min < 0)
+    {
+        throw std::invalid_argument("StaticStructureFactorRDF requires k_min to be non-negative.");
+    }
+    if (k_max <= k_min)
+    {
+        throw std::invalid_argument(
+            "StaticStructureFactorRDF requires that k_max must be greater than k_min.");
+    }
+
+    // The histogram counts the pair distances, as in the RDF.
+    BHAxes axes;
+    axes.push_back(std::make_shared<util::RegularAxis>(r_bins, 0, r_max));
+    m_histogram = BondHistogram(axes);
+    m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+    m_k_axis = std::make_shared<util::RegularAxis>(bins, k_min, k_max);
+}
+
+void StaticStructureFactorRDF::accumulate(const locality::NeighborQuery* neighbor_query,
+                                          const vec3<float>* query_points, unsigned int n_query_points,
+                                          const locality::NeighborList* nlist, locality::QueryArgs qargs)
+{
+    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                      [=](const locality::NeighborBond& neighbor_bond) {
+                          m_local_histograms(neighbor_bond.distance);
+                      });
+}
+
+void StaticStructureFactorRDF::reduce()
+{
+    const size_t r_bins = getAxisSizes()[0];
+    reduceBinCounts([](size_t /*i*/) {});
+
+    const std::vector<float> r_centers = getBinCenters()[0];
+    const std::vector<float> k_centers = getKBinCenters();
+    const bool is_2d = m_box.is2D();
+    const double r_max = getBounds()[0].second;
+    const double n_points = m_n_query_points;
+    // A point has N - 1 other points, so the background density excludes it.
+    const double density = (n_points - 1) / m_box.getVolume();
+    const double prefactor = 1.0 / (n_points * static_cast<double>(m_frame_counter));
+
+    // The number of pairs in each bin minus the number expected at the
+    // background density. The Lorch window sinc(pi r / r_max) damps the
+    // ripples in S(k) caused by truncating the pairs at r_max.
+    const std::vector<float> r_edges = getBinEdges()[0];
+    std::vector<double> excess(r_bins);
+    for (size_t b = 0; b < r_bins; ++b)
+    {
+        const double r_lo = r_edges[b];
+        const double r_hi = r_edges[b + 1];
+        const double shell = is_2d ? M_PI * (r_hi * r_hi - r_lo * r_lo)
+                                   : 4 * M_PI / 3 * (r_hi * r_hi * r_hi - r_lo * r_lo * r_lo);
+        const double x = M_PI * r_centers[b] / r_max;
+        const double window = m_lorch_window ? std::sin(x) / x : 1;
+        excess[b] = (static_cast<double>(getBinCount(b)) * prefactor - density * shell) * window;
+    }
+
+    m_structure_factor.prepare(k_centers.size());
+    util::forLoopWrapper(0, k_centers.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const double k = k_centers[i];
+            double sum = 0;
+            for (size_t b = 0; b < r_bins; ++b)
+            {
+                const double kr = k * r_centers[b];
+                const double kernel = is_2d ? besselJ0(kr) : (kr == 0 ? 1 : std::sin(kr) / kr);
+                sum += excess[b] * kernel;
+            }
+            m_structure_factor[i] = static_cast<float>(1 + sum);
+        }
+    });
+}
+
+}; }; // end namespace freud::diffraction
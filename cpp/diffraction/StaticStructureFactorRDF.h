@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef STATIC_STRUCTURE_FACTOR_RDF_H
+#define STATIC_STRUCTURE_FACTOR_RDF_H
+
+#include <memory>
+#include <vector>
+
+#include "BondHistogramCompute.h"
+#include "Box.h"
+#include "Histogram.h"
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+
+/*! \file StaticStructureFactorRDF.h
+    \brief Computes the static structure factor from the histogram of pair distances.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Computes the static structure factor S(k) by Fourier transforming the histogram of pair distances
+/*! The distances between pairs of points closer than r_max are binned as in
+ *  the RDF, and the structure factor is the radial Fourier transform of the
+ *  pair correlation function,
+ *  S(k) = 1 + sum_b (n_b / N - rho V_b) W(r_b) sinc(k r_b)
+ *  in 3D, where n_b is the number of pairs in the bin at distance r_b, V_b is
+ *  the volume of its spherical shell and rho = (N - 1) / V is the background
+ *  density. In 2D, sinc(k r) is replaced by the Bessel function J_0(k r) and
+ *  the shells by rings. The optional Lorch window W(r) = sinc(pi r / r_max)
+ *  damps the ripples caused by truncating the pairs at r_max, at the cost of
+ *  broadening the peaks.
+ *
+ *  The cost of the transform is independent of the number of points, so this
+ *  method is much faster than summing over wavevectors for large systems,
+ *  but S(k) is only accurate for wavelengths shorter than about r_max.
+ */
+class StaticStructureFactorRDF : public locality::BondHistogramCompute
+{
+public:
+    //! Constructor
+    /*! \param bins Number of bins of wavevector magnitudes.
+     *  \param k_max Largest wavevector magnitude.
+     *  \param k_min Smallest wavevector magnitude.
+     *  \param r_bins Number of bins of the histogram of pair distances.
+     *  \param r_max Largest pair distance.
+     *  \param lorch_window Whether to apply the Lorch window to the pair correlation function.
+     */
+    StaticStructureFactorRDF(unsigned int bins, float k_max, float k_min, unsigned int r_bins, float r_max,
+                             bool lorch_window = true);
+
+    //! Destructor
+    ~StaticStructureFactorRDF() override = default;
+
+    //! Bin the distances between pairs of points and add them to the accumulated frames
+    /*! The structure factor is computed for a single set of points, so the
+     *  query points are expected to be the points of the neighbor query, with
+     *  the pairs of each point with itself excluded.
+     */
+    void accumulate(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                    unsigned int n_query_points, const locality::NeighborList* nlist,
+                    locality::QueryArgs qargs);
+
+    //! Reduce thread-local arrays onto the primary data arrays.
+    void reduce() override;
+
+    //! Get the structure factor at each wavevector bin center
+    const util::ManagedArray<float>& getStructureFactor()
+    {
+        return reduceAndReturn(m_structure_factor);
+    }
+
+    //! Return whether the Lorch window is applied
+    bool getLorchWindow() const
+    {
+        return m_lorch_window;
+    }
+
+    //! Return the edges of the wavevector bins.
+    std::vector<float> getKBinEdges() const
+    {
+        return m_k_axis->getBinEdges();
+    }
+
+    //! Return the centers of the wavevector bins.
+    std::vector<float> getKBinCenters() const
+    {
+        return m_k_axis->getBinCenters();
+    }
+
+private:
+    bool m_lorch_window;                          //!< Whether the Lorch window is applied
+    std::shared_ptr<util::RegularAxis> m_k_axis;  //!< Axis of wavevector magnitudes
+    util::ManagedArray<float> m_structure_factor; //!< Structure factor at each wavevector bin center
+};
+
+}; }; // end namespace freud::diffraction
+
+#endif // STATIC_STRUCTURE_FACTOR_RDF_H
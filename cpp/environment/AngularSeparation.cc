@@ -1,6 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "AngularSeparation.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -11,17 +15,32 @@
 
 namespace freud { namespace environment {
 
+namespace {
+
+//! Number of global orientations whose candidates are compared with each chunk of points together
+constexpr unsigned int ANGULAR_SEPARATION_BLOCK_SIZE = 256;
+
+//! Convert the largest overlap q1 . q2 of two orientations into their separation angle
+inline float overlapToAngle(float overlap)
+{
+    return float(2.0 * std::acos(util::clamp(overlap, -1, 1)));
+}
+
+}; // end anonymous namespace
+
 float computeSeparationAngle(const quat<float>& ref_q, const quat<float>& q)
 {
-    quat<float> R = q * conj(ref_q);
-    auto theta = float(2.0 * std::acos(util::clamp(R.s, -1, 1)));
-    return theta;
+    return overlapToAngle(dot(q, ref_q));
 }
 
 // The set of all equivalent quaternions equiv_qs is the set that takes the particle as it
 // is defined to some global reference orientation. Thus, to be safe, we must include
 // a rotation by qconst as defined below when doing the calculation.
 // Important: equiv_qs must include both q and -q, for all included quaternions
+//
+// The separation angle 2 acos(s) decreases with the scalar part s of q * conj(ref_q),
+// which is the four-dimensional dot product of q and ref_q, so the smallest angle is
+// found from the largest dot product with a single acos.
 float computeMinSeparationAngle(const quat<float>& ref_q, const quat<float>& q, const quat<float>* equiv_qs,
                                 unsigned int n_equiv_quats)
 {
@@ -30,7 +49,7 @@ float computeMinSeparationAngle(const quat<float>& ref_q, const quat<float>& q,
     quat<float> qtemp = q * conj(qconst);
 
     // start with the quaternion before it has been rotated by equivalent rotations
-    float min_angle = computeSeparationAngle(ref_q, q);
+    float max_overlap = dot(q, ref_q);
 
     // loop through all equivalent rotations and see if they have smaller angles with ref_q
     for (unsigned int i = 0; i < n_equiv_quats; ++i)
@@ -38,15 +57,10 @@ float computeMinSeparationAngle(const quat<float>& ref_q, const quat<float>& q,
         quat<float> qe = equiv_qs[i];
         quat<float> qtest = qtemp * qe;
 
-        float angle_test = computeSeparationAngle(ref_q, qtest);
-
-        if (angle_test < min_angle)
-        {
-            min_angle = angle_test;
-        }
+        max_overlap = std::max(max_overlap, dot(qtest, ref_q));
     }
 
-    return min_angle;
+    return overlapToAngle(max_overlap);
 }
 
 void AngularSeparationNeighbor::compute(const locality::NeighborQuery* nq, const quat<float>* orientations,
@@ -83,22 +97,96 @@ void AngularSeparationNeighbor::compute(const locality::NeighborQuery* nq, const
 void AngularSeparationGlobal::compute(const quat<float>* global_orientations, unsigned int n_global,
                                       const quat<float>* orientations, unsigned int n_points,
                                       const quat<float>* equiv_orientations,
-                                      unsigned int n_equiv_orientations)
+                                      unsigned int n_equiv_orientations, bool max_only)
 {
-    m_angles.prepare({n_points, n_global});
+    // Every element of the outputs is written below.
+    m_angles.prepareUninitialized({max_only ? 0 : n_points, n_global});
+    m_min_angles.prepareUninitialized(n_points);
+    m_min_indices.prepareUninitialized(n_points);
+
+    // Every global orientation g has the candidates g and g * conj(e_0) * e_k
+    // for each equivalent orientation e_k, the same candidates that
+    // computeMinSeparationAngle generates. They are stored once, as separate
+    // components ordered by candidate and then by global orientation, so the
+    // overlaps of a point with a block of global orientations are contiguous
+    // dot products.
+    const unsigned int n_candidates = n_equiv_orientations + 1;
+    const size_t candidates_size = static_cast<size_t>(n_candidates) * n_global;
+    std::vector<float> candidate_s(candidates_size);
+    std::vector<float> candidate_x(candidates_size);
+    std::vector<float> candidate_y(candidates_size);
+    std::vector<float> candidate_z(candidates_size);
+    util::forLoopWrapper(0, n_global, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j)
+        {
+            const quat<float> qtemp = global_orientations[j] * conj(equiv_orientations[0]);
+            for (unsigned int k = 0; k < n_candidates; ++k)
+            {
+                const quat<float> candidate
+                    = (k == 0) ? global_orientations[j] : qtemp * equiv_orientations[k - 1];
+                const size_t index = static_cast<size_t>(k) * n_global + j;
+                candidate_s[index] = candidate.s;
+                candidate_x[index] = candidate.v.x;
+                candidate_y[index] = candidate.v.y;
+                candidate_z[index] = candidate.v.z;
+            }
+        }
+    });
 
-    util::forLoopWrapper(0, n_points, [=](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        std::vector<float> max_overlaps(ANGULAR_SEPARATION_BLOCK_SIZE);
+        std::vector<float> best_overlaps(end - begin, -std::numeric_limits<float>::infinity());
+        std::vector<unsigned int> best_indices(end - begin, 0);
+
+        // Each block of global orientations is compared with all points of
+        // the chunk while its candidates are in cache.
+        for (unsigned int block_begin = 0; block_begin < n_global;
+             block_begin += ANGULAR_SEPARATION_BLOCK_SIZE)
         {
-            quat<float> q = orientations[i];
-            for (unsigned int j = 0; j < n_global; j++)
+            const unsigned int block_size = std::min(ANGULAR_SEPARATION_BLOCK_SIZE, n_global - block_begin);
+            for (size_t i = begin; i < end; ++i)
             {
-                quat<float> global_q = global_orientations[j];
-                float theta
-                    = computeMinSeparationAngle(q, global_q, equiv_orientations, n_equiv_orientations);
-                m_angles(i, j) = theta;
+                const quat<float> q = orientations[i];
+                std::fill(max_overlaps.begin(), max_overlaps.begin() + block_size,
+                          -std::numeric_limits<float>::infinity());
+                for (unsigned int k = 0; k < n_candidates; ++k)
+                {
+                    const size_t offset = static_cast<size_t>(k) * n_global + block_begin;
+                    const float* s = candidate_s.data() + offset;
+                    const float* x = candidate_x.data() + offset;
+                    const float* y = candidate_y.data() + offset;
+                    const float* z = candidate_z.data() + offset;
+                    for (unsigned int j = 0; j < block_size; ++j)
+                    {
+                        const float overlap = q.s * s[j] + q.v.x * x[j] + q.v.y * y[j] + q.v.z * z[j];
+                        max_overlaps[j] = std::max(max_overlaps[j], overlap);
+                    }
+                }
+
+                for (unsigned int j = 0; j < block_size; ++j)
+                {
+                    if (max_overlaps[j] > best_overlaps[i - begin])
+                    {
+                        best_overlaps[i - begin] = max_overlaps[j];
+                        best_indices[i - begin] = block_begin + j;
+                    }
+                }
+                if (!max_only)
+                {
+                    float* angles = m_angles.get() + i * n_global + block_begin;
+                    for (unsigned int j = 0; j < block_size; ++j)
+                    {
+                        angles[j] = overlapToAngle(max_overlaps[j]);
+                    }
+                }
             }
         }
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_min_angles[i] = overlapToAngle(best_overlaps[i - begin]);
+            m_min_indices[i] = best_indices[i - begin];
+        }
     });
 }
 
@@ -31,9 +31,13 @@ public:
     ~AngularSeparationGlobal() = default;
 
     //! Compute the angular separation with respect to global orientation
+    /*! \param max_only If true, only the closest global orientation of each
+     *         point is found, and the array of all angles is left empty.
+     */
     void compute(const quat<float>* global_orientations, unsigned int n_global,
                  const quat<float>* orientations, unsigned int n_points,
-                 const quat<float>* equiv_orientations, unsigned int n_equiv_orientations);
+                 const quat<float>* equiv_orientations, unsigned int n_equiv_orientations,
+                 bool max_only = false);
 
     //! Returns the last computed global angle array
     const util::ManagedArray<float>& getAngles() const
@@ -41,8 +45,22 @@ public:
         return m_angles;
     }
 
+    //! Returns the angle between each point and its closest global orientation
+    const util::ManagedArray<float>& getMinAngles() const
+    {
+        return m_min_angles;
+    }
+
+    //! Returns the index of the closest global orientation of each point
+    const util::ManagedArray<unsigned int>& getMinIndices() const
+    {
+        return m_min_indices;
+    }
+
 private:
-    util::ManagedArray<float> m_angles; //!< Global angle array computed
+    util::ManagedArray<float> m_angles;             //!< Global angle array computed
+    util::ManagedArray<float> m_min_angles;         //!< Angle to the closest global orientation
+    util::ManagedArray<unsigned int> m_min_indices; //!< Index of the closest global orientation
 };
 
 //! Compute the difference in orientation between pairs of points.
@@ -3,9 +3,7 @@
 
 #include <cmath>
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
+#include <utility>
 
 #include "BondOrder.h"
 #include "NeighborComputeFunctional.h"
@@ -17,6 +15,57 @@
 
 namespace freud { namespace environment {
 
+namespace {
+
+//! Number of cells of the tables of an EdgeLookup per bin
+constexpr unsigned int LOOKUP_CELLS_PER_BIN = 4;
+
+//! Compute a pseudo-angle in [0, 4) that increases with the angle of (x, y) from the x axis in [0, 2 pi)
+/*! The pseudo-angle is the distance travelled counterclockwise from (1, 0)
+ *  along the unit diamond |x| + |y| = 1 to the direction of (x, y).
+ */
+template<typename Real> Real pseudoAngle(Real x, Real y)
+{
+    if (x == 0 && y == 0)
+    {
+        return 0;
+    }
+    if (y >= 0)
+    {
+        return x >= 0 ? y / (x + y) : 1 - x / (y - x);
+    }
+    return x < 0 ? 2 - y / (-x - y) : 3 + x / (x - y);
+}
+
+//! Square a value, keeping its sign, which preserves the order of values
+template<typename Real> Real signedSquare(Real value)
+{
+    return value * std::abs(value);
+}
+
+}; // end anonymous namespace
+
+EdgeLookup::EdgeLookup(std::vector<float> edges, unsigned int cells_per_bin)
+    : m_edges(std::move(edges)), m_num_bins(static_cast<unsigned int>(m_edges.size() - 1))
+{
+    const unsigned int num_cells = m_num_bins * cells_per_bin;
+    const float cell_width = (m_edges.back() - m_edges.front()) / static_cast<float>(num_cells);
+    m_inverse_cell_width = float(1.0) / cell_width;
+    m_cells.resize(num_cells);
+    unsigned int bin = 0;
+    for (unsigned int cell = 0; cell < num_cells; ++cell)
+    {
+        // Start half a cell below the cell, so that values which are rounded
+        // into the cell never start above their bin.
+        const float lower = m_edges.front() + (static_cast<float>(cell) - float(0.5)) * cell_width;
+        while (bin + 1 < m_num_bins && lower >= m_edges[bin + 1])
+        {
+            ++bin;
+        }
+        m_cells[cell] = bin;
+    }
+}
+
 BondOrder::BondOrder(unsigned int n_bins_theta, unsigned int n_bins_phi, BondOrderMode mode)
     : BondHistogramCompute(), m_mode(mode)
 {
@@ -45,17 +94,39 @@ BondOrder::BondOrder(unsigned int n_bins_theta, unsigned int n_bins_phi, BondOrd
         throw std::invalid_argument("PI must be greater than dp");
     }
 
-    // precompute the surface area array
-    m_sa_array.prepare({n_bins_theta, n_bins_phi});
+    // precompute the inverse surface area array
+    m_inv_sa_array.prepare({n_bins_theta, n_bins_phi});
     for (unsigned int i = 0; i < n_bins_theta; i++)
     {
         for (unsigned int j = 0; j < n_bins_phi; j++)
         {
             float phi = (float) j * dp;
             float sa = dt * (std::cos(phi) - std::cos(phi + dp));
-            m_sa_array(i, j) = sa;
+            m_inv_sa_array(i, j) = float(1.0) / sa;
         }
     }
+
+    // The azimuthal bins are found from the pseudo-angles of their edges, and
+    // the polar bins from the signed squares of the negated cosines of their
+    // edges, which both increase with the angles. The edges are computed in
+    // double precision so that bonds on an edge are binned like their angles.
+    std::vector<float> theta_edges(n_bins_theta + 1);
+    for (unsigned int i = 0; i < n_bins_theta; i++)
+    {
+        const double theta = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n_bins_theta);
+        theta_edges[i] = static_cast<float>(pseudoAngle(std::cos(theta), std::sin(theta)));
+    }
+    theta_edges[n_bins_theta] = 4;
+    std::vector<float> phi_edges(n_bins_phi + 1);
+    for (unsigned int j = 0; j <= n_bins_phi; j++)
+    {
+        const double phi = M_PI * static_cast<double>(j) / static_cast<double>(n_bins_phi);
+        phi_edges[j] = static_cast<float>(signedSquare(-std::cos(phi)));
+    }
+    m_theta_lookup = EdgeLookup(theta_edges, LOOKUP_CELLS_PER_BIN);
+    m_phi_lookup = EdgeLookup(phi_edges, LOOKUP_CELLS_PER_BIN);
+    m_n_bins_phi = n_bins_phi;
+
     BHAxes axes;
     axes.push_back(std::make_shared<util::RegularAxis>(n_bins_theta, 0, constants::TWO_PI));
     axes.push_back(std::make_shared<util::RegularAxis>(n_bins_phi, 0, M_PI));
@@ -66,11 +137,11 @@ BondOrder::BondOrder(unsigned int n_bins_theta, unsigned int n_bins_phi, BondOrd
 
 void BondOrder::reduce()
 {
-    m_histogram.prepare(m_histogram.shape());
     m_bo_array.prepare(m_histogram.shape());
 
-    m_histogram.reduceOverThreadsPerBin(m_local_histograms, [&](size_t i) {
-        m_bo_array[i] = m_histogram[i] / m_sa_array[i] / static_cast<float>(m_frame_counter);
+    const float inv_num_frames = float(1.0) / static_cast<float>(m_frame_counter);
+    reduceBinCounts([&](size_t i) {
+        m_bo_array[i] = static_cast<float>(getBinCount(i)) * m_inv_sa_array[i] * inv_num_frames;
     });
 }
 
@@ -84,48 +155,80 @@ void BondOrder::accumulate(const locality::NeighborQuery* neighbor_query, quat<f
                            unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                            freud::locality::QueryArgs qargs)
 {
+    setOrientations(orientations, query_orientations);
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          const quat<float>& ref_q(orientations[neighbor_bond.point_idx]);
-                          vec3<float> v(bondVector(neighbor_bond, neighbor_query, query_points));
-                          const quat<float>& q = query_orientations[neighbor_bond.query_point_idx];
-                          if (m_mode == obcd)
-                          {
-                              // give bond directions of neighboring particles rotated by the matrix
-                              // that takes the orientation of particle neighbor_bond.id to the orientation of
-                              // particle neighbor_bond.ref_id.
-                              v = rotate(conj(ref_q), v);
-                              v = rotate(q, v);
-                          }
-                          else if (m_mode == lbod)
-                          {
-                              // give bond directions of neighboring particles rotated into the
-                              // local orientation of the central particle.
-                              v = rotate(conj(ref_q), v);
-                          }
-                          else if (m_mode == oocd)
-                          {
-                              // give the directors of neighboring particles rotated into the local
-                              // orientation of the central particle. pick a (random vector)
-                              vec3<float> z(0, 0, 1);
-                              // rotate that vector by the orientation of the neighboring particle
-                              z = rotate(q, z);
-                              // get the direction of this vector with respect to the orientation of
-                              // the central particle
-                              v = rotate(conj(ref_q), z);
-                          }
-
-                          // NOTE that angles are defined in the "mathematical" way, rather than how
-                          // most physics textbooks do it. get theta (azimuthal angle), phi (polar
-                          // angle)
-                          float theta = std::atan2(v.y, v.x); //-Pi..Pi
-                          theta = util::modulusPositive(theta, constants::TWO_PI);
-
-                          // NOTE that the below has replaced the commented out expression for phi.
-                          float phi = std::acos(v.z / std::sqrt(dot(v, v))); // 0..Pi
-
-                          m_local_histograms(theta, phi);
+                          accumulateBond(neighbor_bond,
+                                         bondVector(neighbor_bond, neighbor_query, query_points));
                       });
 }
 
+void BondOrder::prepare(const locality::NeighborQuery* neighbor_query, const vec3<float>* /*query_points*/,
+                        unsigned int n_query_points, const locality::NeighborList* nlist,
+                        locality::QueryArgs qargs)
+{
+    beginAccumulate(neighbor_query, n_query_points, nlist, qargs);
+}
+
+void BondOrder::computePoint(size_t /*query_point_idx*/, const locality::PointBonds& point_bonds)
+{
+    for (size_t bond = 0; bond < point_bonds.bonds.size(); ++bond)
+    {
+        accumulateBond(point_bonds.bonds[bond], point_bonds.deltas[bond]);
+    }
+}
+
+void BondOrder::finish(const locality::NeighborQuery* neighbor_query, const vec3<float>* /*query_points*/,
+                       unsigned int n_query_points, const locality::NeighborList* /*nlist*/,
+                       locality::QueryArgs /*qargs*/)
+{
+    endAccumulate(neighbor_query, n_query_points);
+}
+
+void BondOrder::accumulateBond(const locality::NeighborBond& neighbor_bond, vec3<float> v)
+{
+    const quat<float>& ref_q(m_orientations[neighbor_bond.point_idx]);
+    const quat<float>& q = m_query_orientations[neighbor_bond.query_point_idx];
+    if (m_mode == obcd)
+    {
+        // give bond directions of neighboring particles rotated by the matrix
+        // that takes the orientation of particle neighbor_bond.id to the orientation of
+        // particle neighbor_bond.ref_id.
+        v = rotate(conj(ref_q), v);
+        v = rotate(q, v);
+    }
+    else if (m_mode == lbod)
+    {
+        // give bond directions of neighboring particles rotated into the
+        // local orientation of the central particle.
+        v = rotate(conj(ref_q), v);
+    }
+    else if (m_mode == oocd)
+    {
+        // give the directors of neighboring particles rotated into the local
+        // orientation of the central particle. pick a (random vector)
+        vec3<float> z(0, 0, 1);
+        // rotate that vector by the orientation of the neighboring particle
+        z = rotate(q, z);
+        // get the direction of this vector with respect to the orientation of
+        // the central particle
+        v = rotate(conj(ref_q), z);
+    }
+
+    // NOTE that angles are defined in the "mathematical" way, rather than how
+    // most physics textbooks do it. theta is the azimuthal angle in 0..2Pi
+    // and phi the polar angle in 0..Pi, which are binned through quantities
+    // that increase with them.
+    const float r_sq = dot(v, v);
+    // bonds of zero length have no direction
+    if (r_sq == 0)
+    {
+        return;
+    }
+    const unsigned int theta_bin = m_theta_lookup.bin(pseudoAngle(v.x, v.y));
+    const unsigned int phi_bin = m_phi_lookup.bin(-signedSquare(v.z) / r_sq);
+
+    m_local_histograms.increment(static_cast<size_t>(theta_bin) * m_n_bins_phi + phi_bin);
+}
+
 }; }; // end namespace freud::environment
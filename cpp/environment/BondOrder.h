@@ -4,7 +4,11 @@
 #ifndef BOND_ORDER_H
 #define BOND_ORDER_H
 
+#include <algorithm>
+#include <vector>
+
 #include "BondHistogramCompute.h"
+#include "BondKernel.h"
 #include "Box.h"
 #include "Histogram.h"
 #include "ManagedArray.h"
@@ -27,10 +31,58 @@ typedef enum // NOLINT(modernize-use-using)
     oocd = 3
 } BondOrderMode;
 
+//! Bin values among increasing bin edges without searching all edges
+/*! A uniform table over the range of the edges stores the bin of the lower
+ *  end of each of its cells, from which the bin of a value in the cell is
+ *  found by comparing the value with the following edges. With a few cells
+ *  per bin, this takes about one comparison per value, so nonlinear
+ *  coordinates can be binned by monotonic functions of them that are cheap
+ *  to compute, without evaluating the coordinates themselves.
+ */
+class EdgeLookup
+{
+public:
+    EdgeLookup() = default;
+
+    //! Constructor
+    /*! \param edges The increasing edges of the bins, from the lowest to the highest value.
+     *  \param cells_per_bin The number of cells of the table per bin.
+     */
+    EdgeLookup(std::vector<float> edges, unsigned int cells_per_bin);
+
+    //! Find the bin of a value, clamping values outside the edges into the first or last bin.
+    unsigned int bin(float value) const
+    {
+        const float position = (value - m_edges.front()) * m_inverse_cell_width;
+        const unsigned int cell = position <= 0
+            ? 0
+            : std::min(static_cast<unsigned int>(position), static_cast<unsigned int>(m_cells.size() - 1));
+        unsigned int bin = m_cells[cell];
+        while (bin + 1 < m_num_bins && value >= m_edges[bin + 1])
+        {
+            ++bin;
+        }
+        return bin;
+    }
+
+private:
+    std::vector<float> m_edges;        //!< The edges of the bins.
+    std::vector<unsigned int> m_cells; //!< The bin of the lower end of each cell.
+    unsigned int m_num_bins {0};       //!< The number of bins.
+    float m_inverse_cell_width {0};    //!< The inverse of the width of the cells.
+};
+
 //! Compute the bond order parameter for a set of points
-/*!
+/*! The bond order can also be accumulated as a locality::BondKernel, in the
+ *  same pass over the bonds as other bond order parameters, after the
+ *  orientations of the points are set with setOrientations.
+ *
+ *  Bonds are binned without trigonometric functions: the azimuthal bin is
+ *  found from a pseudo-angle of the bond that increases with the azimuthal
+ *  angle, and the polar bin from the normalized z component of the bond,
+ *  both through EdgeLookups of the corresponding bin edges.
  */
-class BondOrder : public locality::BondHistogramCompute
+class BondOrder : public locality::BondHistogramCompute, public locality::BondKernel
 {
 public:
     //! Constructor
@@ -44,6 +96,26 @@ public:
                     vec3<float>* query_points, quat<float>* query_orientations, unsigned int n_query_points,
                     const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Set the orientations used when the bond order is accumulated as a bond kernel
+    void setOrientations(const quat<float>* orientations, const quat<float>* query_orientations)
+    {
+        m_orientations = orientations;
+        m_query_orientations = query_orientations;
+    }
+
+    //! Prepare to accumulate the bonds of a frame
+    void prepare(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                 unsigned int n_query_points, const locality::NeighborList* nlist,
+                 locality::QueryArgs qargs) override;
+
+    //! Accumulate the bonds of a query point
+    void computePoint(size_t query_point_idx, const locality::PointBonds& point_bonds) override;
+
+    //! Record that the bonds of a frame have been accumulated
+    void finish(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                unsigned int n_query_points, const locality::NeighborList* nlist,
+                locality::QueryArgs qargs) override;
+
     void reduce() override;
 
     //! Get a reference to the last computed bond order
@@ -55,9 +127,17 @@ public:
     }
 
 private:
-    util::ManagedArray<float> m_bo_array; //!< bond order array computed
-    util::ManagedArray<float> m_sa_array; //!< surface area array computed
-    BondOrderMode m_mode;                 //!< The mode to calculate with.
+    //! Add a bond with bond vector v to the histogram
+    void accumulateBond(const locality::NeighborBond& neighbor_bond, vec3<float> v);
+
+    util::ManagedArray<float> m_bo_array;              //!< bond order array computed
+    util::ManagedArray<float> m_inv_sa_array;          //!< inverse surface area of each bin
+    BondOrderMode m_mode;                              //!< The mode to calculate with.
+    unsigned int m_n_bins_phi;                         //!< Number of bins of the polar angle.
+    EdgeLookup m_theta_lookup;                         //!< Azimuthal bins of pseudo-angles of bonds.
+    EdgeLookup m_phi_lookup;                           //!< Polar bins of negated z components of unit bonds.
+    const quat<float>* m_orientations {nullptr};       //!< Orientations of the points
+    const quat<float>* m_query_orientations {nullptr}; //!< Orientations of the query points
 };
 
 }; }; // end namespace freud::environment
@@ -1,6 +1,11 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is part of the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
 #include "LocalBondProjection.h"
 #include "NeighborComputeFunctional.h"
 
@@ -11,6 +16,13 @@
 
 namespace freud { namespace environment {
 
+namespace {
+
+//! Number of bonds whose projections are computed together
+constexpr size_t BOND_BLOCK_SIZE = 64;
+
+}; // end anonymous namespace
+
 // The set of all equivalent quaternions equiv_qs is the set that takes the particle as it
 // is defined to some global reference orientation. Thus, to be safe, we must include
 // a rotation by qconst as defined below when doing the calculation.
@@ -61,29 +73,92 @@ void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<
     m_local_bond_proj.prepare({tot_num_neigh, n_proj});
     m_local_bond_proj_norm.prepare({tot_num_neigh, n_proj});
 
-    // compute the order parameter
-    util::forLoopWrapper(0, n_query_points, [=](size_t begin, size_t end) {
-        size_t bond(m_nlist.find_first_index(begin));
-        for (size_t i = begin; i < end; ++i)
+    // Find the symmetrically equivalent vectors of each projection vector once, see computeMaxProjection.
+    // The vectors are stored by component, with the projection vector itself first followed by its
+    // n_equiv_orientations rotations, so that the projections of a block of bonds onto them form a small
+    // matrix product.
+    std::vector<quat<float>> equiv_rotations(n_equiv_orientations);
+    multiplyBatch(conj(equiv_orientations[0]), equiv_orientations, equiv_rotations.data(),
+                  n_equiv_orientations);
+    const unsigned int n_candidates = n_equiv_orientations + 1;
+    const size_t n_columns = static_cast<size_t>(n_proj) * n_candidates;
+    std::vector<float> column_x(n_columns);
+    std::vector<float> column_y(n_columns);
+    std::vector<float> column_z(n_columns);
+    std::vector<vec3<float>> equiv_proj_vecs(n_equiv_orientations);
+    for (unsigned int k = 0; k < n_proj; k++)
+    {
+        rotateBatch(equiv_rotations.data(), proj_vecs[k], equiv_proj_vecs.data(), n_equiv_orientations);
+        for (unsigned int e = 0; e < n_candidates; e++)
         {
-            for (; bond < tot_num_neigh && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+            const vec3<float>& v = (e == 0) ? proj_vecs[k] : equiv_proj_vecs[e - 1];
+            column_x[k * n_candidates + e] = v.x;
+            column_y[k * n_candidates + e] = v.y;
+            column_z[k * n_candidates + e] = v.z;
+        }
+    }
+
+    // Convert the inverse of the orientation of each point to a matrix once, rather than rotating each
+    // bond by the quaternion.
+    const unsigned int n_points = nq->getNPoints();
+    std::vector<rotmat3<float>> rotations(n_points);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        inverseRotationMatrices(orientations + begin, rotations.data() + begin, end - begin);
+    });
+
+    // compute the order parameter over blocks of bonds
+    util::forLoopWrapper(0, tot_num_neigh, [&](size_t begin, size_t end) {
+        std::array<float, BOND_BLOCK_SIZE> bond_x;
+        std::array<float, BOND_BLOCK_SIZE> bond_y;
+        std::array<float, BOND_BLOCK_SIZE> bond_z;
+        std::array<float, BOND_BLOCK_SIZE> inv_bond_len;
+        std::vector<float> max_proj(static_cast<size_t>(n_proj) * BOND_BLOCK_SIZE);
+
+        for (size_t block_begin = begin; block_begin < end; block_begin += BOND_BLOCK_SIZE)
+        {
+            const size_t block_size = std::min(BOND_BLOCK_SIZE, end - block_begin);
+
+            // compute the bond vectors of the block and rotate them into the local frame of each neighbor
+            for (size_t b = 0; b < block_size; ++b)
             {
+                const size_t bond = block_begin + b;
+                const size_t i(m_nlist.getNeighbors()(bond, 0));
                 const size_t j(m_nlist.getNeighbors()(bond, 1));
+                const vec3<float> local_bond(rotations[j]
+                                             * bondVector(locality::NeighborBond(i, j), nq, query_points));
+                bond_x[b] = local_bond.x;
+                bond_y[b] = local_bond.y;
+                bond_z[b] = local_bond.z;
+                inv_bond_len[b] = float(1.0) / std::sqrt(dot(local_bond, local_bond));
+            }
 
-                // compute bond vector between the two particles
-                vec3<float> local_bond(bondVector(locality::NeighborBond(i, j), nq, query_points));
-                // rotate bond vector into the local frame of particle p
-                local_bond = rotate(conj(orientations[j]), local_bond);
-                // store the length of this local bond
-                float local_bond_len = std::sqrt(dot(local_bond, local_bond));
+            // project the block onto every equivalent vector of every projection vector, keeping the
+            // maximum for each projection vector
+            for (unsigned int k = 0; k < n_proj; k++)
+            {
+                float* block_max = &max_proj[k * BOND_BLOCK_SIZE];
+                std::fill(block_max, block_max + block_size, -std::numeric_limits<float>::infinity());
+                for (size_t c = k * n_candidates; c < (k + 1) * n_candidates; c++)
+                {
+                    const float cx(column_x[c]);
+                    const float cy(column_y[c]);
+                    const float cz(column_z[c]);
+                    for (size_t b = 0; b < block_size; ++b)
+                    {
+                        block_max[b]
+                            = std::max(block_max[b], cx * bond_x[b] + cy * bond_y[b] + cz * bond_z[b]);
+                    }
+                }
+            }
 
+            for (size_t b = 0; b < block_size; ++b)
+            {
+                const size_t bond = block_begin + b;
                 for (unsigned int k = 0; k < n_proj; k++)
                 {
-                    vec3<float> proj_vec = proj_vecs[k];
-                    float max_proj = computeMaxProjection(proj_vec, local_bond, equiv_orientations,
-                                                          n_equiv_orientations);
-                    m_local_bond_proj(bond, k) = max_proj;
-                    m_local_bond_proj_norm(bond, k) = max_proj / local_bond_len;
+                    const float proj = max_proj[k * BOND_BLOCK_SIZE + b];
+                    m_local_bond_proj(bond, k) = proj;
+                    m_local_bond_proj_norm(bond, k) = proj * inv_bond_len[b];
                 }
             }
         }
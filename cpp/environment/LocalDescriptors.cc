@@ -1,11 +1,15 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include "LocalDescriptors.h"
 #include "NeighborComputeFunctional.h"
+#include "SphericalHarmonics.h"
 #include "diagonalize.h"
+#include "utils.h"
 
 /*! \file LocalDescriptors.cc
   \brief Computes local descriptors.
@@ -15,9 +19,50 @@ namespace freud { namespace environment {
 
 LocalDescriptors::LocalDescriptors(unsigned int l_max, bool negative_m,
                                    LocalDescriptorOrientation orientation)
-    : m_l_max(l_max), m_negative_m(negative_m), m_nSphs(0), m_orientation(orientation)
+    : m_l_max(l_max), m_negative_m(negative_m), m_nSphs(0), m_orientation(orientation),
+      m_sph_evaluators(util::SphericalHarmonicsEvaluator(l_max))
 {}
 
+namespace {
+
+//! Compute the principal axes of the moment of inertia tensor of a set of bond vectors
+/*! The six unique elements of the tensor are summed over the bonds stored as
+ *  separate arrays of components, then the tensor is diagonalized in closed
+ *  form by diagonalize33SymmetricMatrices. The eigenvectors are returned as the rows of the rotation, in
+ *  increasing order of their eigenvalues.
+ */
+void principalAxes(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z,
+                   vec3<float>& rotation_0, vec3<float>& rotation_1, vec3<float>& rotation_2)
+{
+    float xx(0);
+    float xy(0);
+    float xz(0);
+    float yy(0);
+    float yz(0);
+    float zz(0);
+    for (size_t k = 0; k < x.size(); ++k)
+    {
+        xx += x[k] * x[k];
+        xy += x[k] * y[k];
+        xz += x[k] * z[k];
+        yy += y[k] * y[k];
+        yz += y[k] * z[k];
+        zz += z[k] * z[k];
+    }
+    const float r_sq(xx + yy + zz);
+
+    const std::array<float, 9> inertia_tensor {r_sq - xx, -xy, -xz, -xy, r_sq - yy, -yz, -xz, -yz, r_sq - zz};
+    std::array<float, 3> eigenvalues {};
+    std::array<float, 9> eigenvectors {};
+    util::diagonalize33SymmetricMatrices(inertia_tensor.data(), eigenvalues.data(), eigenvectors.data(), 1);
+
+    rotation_0 = vec3<float>(eigenvectors[0], eigenvectors[1], eigenvectors[2]);
+    rotation_1 = vec3<float>(eigenvectors[3], eigenvectors[4], eigenvectors[5]);
+    rotation_2 = vec3<float>(eigenvectors[6], eigenvectors[7], eigenvectors[8]);
+}
+
+}; // end anonymous namespace
+
 void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<float>* query_points,
                                unsigned int n_query_points, const quat<float>* orientations,
                                const freud::locality::NeighborList* nlist, locality::QueryArgs qargs,
@@ -33,12 +78,38 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
     m_sphArray.prepare({m_nlist.getNumBonds(), getSphWidth()});
 
     util::forLoopWrapper(0, nq->getNPoints(), [=](size_t begin, size_t end) {
-        fsph::PointSPHEvaluator<float> sph_eval(m_l_max);
-
+        // The harmonics of all bonds of a point are evaluated together, with
+        // one evaluator per thread that keeps its buffers between points.
+        util::SphericalHarmonicsEvaluator& sph_eval = m_sph_evaluators.local();
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        const size_t num_bonds(m_nlist.getNumBonds());
+        const size_t sph_width(getSphWidth());
+
+        size_t bond(m_nlist.find_first_index(begin));
         for (size_t i = begin; i < end; ++i)
         {
-            size_t bond(m_nlist.find_first_index(i));
-            unsigned int neighbor_count(0);
+            // Find the bonds of this point that are used, so the loops over
+            // them below need no further checks.
+            const size_t first_bond(bond);
+            while (bond < num_bonds && m_nlist.getNeighbors()(bond, 0) == i)
+            {
+                ++bond;
+            }
+            const size_t last_bond(std::min(bond, first_bond + max_num_neighbors));
+
+            x.resize(last_bond - first_bond);
+            y.resize(last_bond - first_bond);
+            z.resize(last_bond - first_bond);
+            for (size_t k = first_bond; k < last_bond; ++k)
+            {
+                const size_t j(m_nlist.getNeighbors()(k, 1));
+                const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
+                x[k - first_bond] = r_ij.x;
+                y[k - first_bond] = r_ij.y;
+                z[k - first_bond] = r_ij.z;
+            }
 
             vec3<float> rotation_0;
             vec3<float> rotation_1;
@@ -46,40 +117,7 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
 
             if (m_orientation == LocalNeighborhood)
             {
-                util::ManagedArray<float> inertiaTensor = util::ManagedArray<float>({3, 3});
-
-                for (size_t bond_copy(bond); bond_copy < m_nlist.getNumBonds()
-                     && m_nlist.getNeighbors()(bond_copy, 0) == i && neighbor_count < max_num_neighbors;
-                     ++bond_copy, ++neighbor_count)
-                {
-                    const size_t j(m_nlist.getNeighbors()(bond_copy, 1));
-                    const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
-                    const float r_sq(dot(r_ij, r_ij));
-
-                    for (size_t ii(0); ii < 3; ++ii)
-                    {
-                        inertiaTensor(ii, ii) += r_sq;
-                    }
-
-                    inertiaTensor(0, 0) -= r_ij.x * r_ij.x;
-                    inertiaTensor(0, 1) -= r_ij.x * r_ij.y;
-                    inertiaTensor(0, 2) -= r_ij.x * r_ij.z;
-                    inertiaTensor(1, 0) -= r_ij.x * r_ij.y;
-                    inertiaTensor(1, 1) -= r_ij.y * r_ij.y;
-                    inertiaTensor(1, 2) -= r_ij.y * r_ij.z;
-                    inertiaTensor(2, 0) -= r_ij.x * r_ij.z;
-                    inertiaTensor(2, 1) -= r_ij.y * r_ij.z;
-                    inertiaTensor(2, 2) -= r_ij.z * r_ij.z;
-                }
-
-                util::ManagedArray<float> eigenvalues = util::ManagedArray<float>(3);
-                util::ManagedArray<float> eigenvectors = util::ManagedArray<float>({3, 3});
-
-                freud::util::diagonalize33SymmetricMatrix(inertiaTensor, eigenvalues, eigenvectors);
-
-                rotation_0 = vec3<float>(eigenvectors(0, 0), eigenvectors(0, 1), eigenvectors(0, 2));
-                rotation_1 = vec3<float>(eigenvectors(1, 0), eigenvectors(1, 1), eigenvectors(1, 2));
-                rotation_2 = vec3<float>(eigenvectors(2, 0), eigenvectors(2, 1), eigenvectors(2, 2));
+                principalAxes(x, y, z, rotation_0, rotation_1, rotation_2);
             }
             else if (m_orientation == ParticleLocal)
             {
@@ -99,38 +137,17 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
                 throw std::runtime_error("Uncaught orientation mode in LocalDescriptors::compute");
             }
 
-            neighbor_count = 0;
-            for (; bond < m_nlist.getNumBonds() && m_nlist.getNeighbors()(bond, 0) == i
-                 && neighbor_count < max_num_neighbors;
-                 ++bond, ++neighbor_count)
+            // The harmonics of all bonds of the point are evaluated together
+            // and then copied to the rows of their bonds.
+            sph_eval.clear();
+            for (size_t k = 0; k < x.size(); ++k)
             {
-                const unsigned int sphCount(bond * getSphWidth());
-                const size_t j(m_nlist.getNeighbors()(bond, 1));
-                const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
-                const float r_sq(dot(r_ij, r_ij));
-                const vec3<float> bond_ij(dot(rotation_0, r_ij), dot(rotation_1, r_ij),
-                                          dot(rotation_2, r_ij));
-
-                const float magR(std::sqrt(r_sq));
-
-                // Wrap theta into [0, 2*pi]
-                float theta(std::atan2(bond_ij.y, bond_ij.x));
-                theta = util::modulusPositive(theta, constants::TWO_PI);
-
-                // Phi in [0, pi]
-                float phi(std::acos(bond_ij.z / magR));
-
-                // catch cases where bond_ij.z/magR falls outside [-1, 1]
-                // due to numerical issues
-                if (std::isnan(phi))
-                {
-                    phi = bond_ij.z > 0 ? 0 : M_PI;
-                }
-
-                sph_eval.compute(phi, theta);
-
-                std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), &m_sphArray[sphCount]);
+                const vec3<float> r_ij(x[k], y[k], z[k]);
+                sph_eval.addBond(
+                    vec3<float>(dot(rotation_0, r_ij), dot(rotation_1, r_ij), dot(rotation_2, r_ij)));
             }
+            sph_eval.evaluate();
+            sph_eval.copyBonds(m_negative_m, &m_sphArray[first_bond * sph_width], sph_width);
         }
     });
 
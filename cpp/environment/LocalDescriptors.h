@@ -5,13 +5,14 @@
 #define LOCAL_DESCRIPTORS_H
 
 #include <complex>
+#include <tbb/enumerable_thread_specific.h>
 
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "SphericalHarmonics.h"
 #include "VectorMath.h"
-#include "fsph/src/spherical_harmonics.hpp"
 
 /*! \file LocalDescriptors.h
   \brief Computes local descriptors.
@@ -66,7 +67,8 @@ public:
     //! Return the number of spherical harmonics that will be computed for each bond.
     unsigned int getSphWidth() const
     {
-        return fsph::sphCount(m_l_max) + (m_l_max > 0 && m_negative_m ? fsph::sphCount(m_l_max - 1) : 0);
+        return util::SphericalHarmonicsEvaluator::sphCount(m_l_max)
+            + (m_l_max > 0 && m_negative_m ? util::SphericalHarmonicsEvaluator::sphCount(m_l_max - 1) : 0);
     }
 
     //! Return a pointer to the NeighborList used in the last call to compute.
@@ -94,6 +96,8 @@ private:
 
     //! Spherical harmonics for each neighbor
     util::ManagedArray<std::complex<float>> m_sphArray;
+    tbb::enumerable_thread_specific<util::SphericalHarmonicsEvaluator>
+        m_sph_evaluators; //!< Thread local evaluators of the bond spherical harmonics
 };
 
 }; }; // end namespace freud::environment
@@ -1,141 +1,92 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <tbb/task_arena.h>
 
 #include "MatchEnv.h"
 
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
+#include "utils.h"
 
 namespace freud { namespace environment {
 
 /*****************
  * EnvDisjoinSet *
  *****************/
-EnvDisjointSet::EnvDisjointSet(unsigned int Np) : rank(std::vector<unsigned int>(Np, 0)), m_max_num_neigh(0)
-{}
-
-void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
-                           BiMap<unsigned int, unsigned int> vec_map, rotmat3<float>& rotation)
+EnvDisjointSet::EnvDisjointSet(unsigned int Np)
+    : rank(std::vector<unsigned int>(Np, 0)), members(Np), m_max_num_neigh(0)
 {
-    // if tree heights are equal, merge b to a
-    if (rank[s[a].env_ind] == rank[s[b].env_ind])
+    for (unsigned int i = 0; i < Np; i++)
     {
-        // Get the ENTIRE set that corresponds to head_b.
-        unsigned int head_b = find(b);
-        std::vector<unsigned int> m_set = findSet(head_b);
-        for (unsigned int node : m_set)
-        {
-            // Go through the entire tree/set.
-            // Make a copy of the old set of vector indices for this
-            // particular node.
-            std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
-
-            // Set the vector indices properly.
-            // Take the LEFT MAP view of the proper_a<->proper_b bimap.
-            // Iterate over the values of proper_a_ind IN ORDER, find the
-            // value of proper_b_ind that corresponds to each proper_a_ind,
-            // and set it properly.
-            for (unsigned int proper_a_ind = 0; proper_a_ind < vec_map.size(); proper_a_ind++)
-            {
-                unsigned int proper_b_ind = vec_map.left[proper_a_ind];
-
-                // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
-                s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
-            }
-
-            // set the environment index properly
-            s[node].env_ind = s[a].env_ind;
+        members[i].push_back(i);
+    }
+}
 
-            // set the proper orientation. ORDER MATTERS since rotations
-            // don't commute in 3D.
-            s[node].proper_rot = rotation * s[node].proper_rot;
+void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
+                           const BiMap<unsigned int, unsigned int>& vec_map, const rotmat3<float>& rotation)
+{
+    const unsigned int head_a = find(a);
+    const unsigned int head_b = find(b);
 
-            // we've added another leaf to the tree or whatever the lingo is.
-            rank[s[a].env_ind]++;
-        }
+    // merge the shorter tree to the taller one. if tree heights are equal,
+    // merge b to a
+    std::vector<unsigned int> proper_a_inds(vec_map.size());
+    std::vector<unsigned int> proper_b_inds(vec_map.size());
+    for (const auto* proper_pair : vec_map)
+    {
+        proper_a_inds[proper_pair->second] = proper_pair->first;
+        proper_b_inds[proper_pair->first] = proper_pair->second;
+    }
+    if (rank[head_a] >= rank[head_b])
+    {
+        // For each proper_a_ind IN ORDER, the proper_b_ind that corresponds to it.
+        mergeInto(head_a, head_b, proper_b_inds, rotation);
     }
     else
     {
-        // merge the shorter tree to the taller one
-        if (rank[s[a].env_ind] > rank[s[b].env_ind])
-        {
-            // Get the ENTIRE set that corresponds to head_b.
-            unsigned int head_b = find(b);
-            std::vector<unsigned int> m_set = findSet(head_b);
-            for (unsigned int node : m_set)
-            {
-                // Go through the entire tree/set.
-                // Make a copy of the old set of vector indices for this
-                // particular node. This is complicated and weird.
-                std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
-
-                // Set the vector indices properly.
-                // Take the LEFT MAP view of the proper_a<->proper_b bimap.
-                // Iterate over the values of proper_a_ind IN ORDER, find the
-                // value of proper_b_ind that corresponds to each proper_a_ind,
-                // and set it properly.
-                for (unsigned int proper_a_ind = 0; proper_a_ind < vec_map.size(); proper_a_ind++)
-                {
-                    unsigned int proper_b_ind = vec_map.left[proper_a_ind];
-
-                    // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
-                    s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
-                }
-                // set the environment index properly
-                s[node].env_ind = s[a].env_ind;
+        // For each proper_b_ind IN ORDER, the proper_a_ind that corresponds
+        // to it. Note that here we are rotating vector set proper_a such
+        // that it matches vector set proper_b, so we need to multiply by the
+        // INVERSE (transpose) of the matrix rotation.
+        mergeInto(head_b, head_a, proper_a_inds, transpose(rotation));
+    }
+}
 
-                // set the proper orientation. ORDER MATTERS since rotations
-                // don't commute in 3D.
-                s[node].proper_rot = rotation * s[node].proper_rot;
+void EnvDisjointSet::mergeInto(const unsigned int head, const unsigned int other_head,
+                               const std::vector<unsigned int>& other_inds, const rotmat3<float>& rotation)
+{
+    for (unsigned int node : members[other_head])
+    {
+        // Go through the entire tree/set.
+        // Make a copy of the old set of vector indices for this
+        // particular node.
+        const std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
 
-                // we've added another leaf to the tree or whatever the lingo is.
-                rank[s[a].env_ind]++;
-            }
-        }
-        else
+        // Set the vector indices properly.
+        for (unsigned int proper_ind = 0; proper_ind < other_inds.size(); proper_ind++)
         {
-            rotmat3<float> rotationT = transpose(rotation);
-            // Get the ENTIRE set that corresponds to head_a.
-            unsigned int head_a = find(a);
-            std::vector<unsigned int> m_set = findSet(head_a);
-            for (unsigned int node : m_set)
-            {
-                // Go through the entire tree/set.
-                // Make a copy of the old set of vector indices for this
-                // particular node. This is complicated and weird.
-                std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
-
-                // Set the vector indices properly.
-                // Take the RIGHT MAP view of the proper_a<->proper_b bimap.
-                // Iterate over the values of proper_b_ind IN ORDER, find the
-                // value of proper_a_ind that corresponds to each proper_b_ind,
-                // and set it properly.
-                for (unsigned int proper_b_ind = 0; proper_b_ind < vec_map.size(); proper_b_ind++)
-                {
-                    unsigned int proper_a_ind = vec_map.right[proper_b_ind];
-
-                    // old_node_vec_ind[proper_a_ind] is "relative_a_ind"
-                    s[node].vec_ind[proper_b_ind] = old_node_vec_ind[proper_a_ind];
-                }
+            // old_node_vec_ind[other_inds[proper_ind]] is the relative index
+            s[node].vec_ind[proper_ind] = old_node_vec_ind[other_inds[proper_ind]];
+        }
 
-                // set the environment index properly
-                s[node].env_ind = s[b].env_ind;
+        // set the environment index properly
+        s[node].env_ind = head;
 
-                // set the proper orientation. ORDER MATTERS since rotations
-                // don't commute in 3D.
-                // note that here we are rotating vector set proper_a such
-                // that it matches vector set proper_b, so we need to multiply
-                // by the INVERSE (transpose) of the matrix rotation.
-                s[node].proper_rot = rotationT * s[node].proper_rot;
+        // set the proper orientation. ORDER MATTERS since rotations
+        // don't commute in 3D.
+        s[node].proper_rot = rotation * s[node].proper_rot;
 
-                // we've added another leaf to the tree or whatever the lingo is.
-                rank[s[b].env_ind]++;
-            }
-        }
+        // we've added another leaf to the tree or whatever the lingo is.
+        rank[head]++;
     }
+    members[head].insert(members[head].end(), members[other_head].begin(), members[other_head].end());
+    members[other_head].clear();
+    members[other_head].shrink_to_fit();
 }
 
 unsigned int EnvDisjointSet::find(const unsigned int c)
@@ -161,30 +112,17 @@ unsigned int EnvDisjointSet::find(const unsigned int c)
 
 std::vector<unsigned int> EnvDisjointSet::findSet(const unsigned int m)
 {
-    bool invalid_ind = true;
-
-    std::vector<unsigned int> m_set;
-
-    // this is wildly inefficient
-    for (unsigned int i = 0; i < s.size(); i++)
-    {
-        // get the head environment index
-        unsigned int head_env = find(s[i].env_ind);
-        // if we are part of the environment m, add the vectors to m_set
-        if (head_env == m)
-        {
-            m_set.push_back(i);
-            invalid_ind = false;
-        }
-    }
-
-    if (invalid_ind)
+    if (m >= s.size() || s[m].env_ind != m)
     {
         std::ostringstream msg;
         msg << "Index " << m << " must be a head index in the environment set!" << std::endl;
         throw std::invalid_argument(msg.str());
     }
 
+    // the members of every set are stored in order of merging, so sort them
+    // into order of environment index
+    std::vector<unsigned int> m_set = members[m];
+    std::sort(m_set.begin(), m_set.end());
     return m_set;
 }
 
@@ -196,26 +134,21 @@ std::vector<vec3<float>> EnvDisjointSet::getAvgEnv(const unsigned int m)
     unsigned int N = 0;
 
     // loop over all the environments in the set
-    for (auto& i : s)
+    for (unsigned int node : findSet(m))
     {
+        const Environment& i = s[node];
         // if this environment is NOT a ghost (i.e. non-physical):
         if (!i.ghost)
         {
-            // get the head environment index
-            unsigned int head_env = find(i.env_ind);
-            // if we are part of the environment m, add the vectors to env
-            if (head_env == m)
+            // loop through the vectors, getting them properly indexed
+            // add them to env
+            for (unsigned int proper_ind = 0; proper_ind < i.vecs.size(); proper_ind++)
             {
-                // loop through the vectors, getting them properly indexed
-                // add them to env
-                for (unsigned int proper_ind = 0; proper_ind < i.vecs.size(); proper_ind++)
-                {
-                    unsigned int relative_ind = i.vec_ind[proper_ind];
-                    env[proper_ind] += i.proper_rot * i.vecs[relative_ind];
-                }
-                ++N;
-                invalid_ind = false;
+                unsigned int relative_ind = i.vec_ind[proper_ind];
+                env[proper_ind] += i.proper_rot * i.vecs[relative_ind];
             }
+            ++N;
+            invalid_ind = false;
         }
     }
 
@@ -262,11 +195,80 @@ std::vector<vec3<float>> EnvDisjointSet::getIndividualEnv(const unsigned int m)
     return env;
 }
 
+/**************************
+ * EnvironmentFingerprint *
+ **************************/
+namespace {
+
+//! Relative slack on the bounds of fingerprints, which covers single precision rounding
+constexpr float FINGERPRINT_TOLERANCE = 1e-3;
+
+}; // end anonymous namespace
+
+EnvironmentFingerprint::EnvironmentFingerprint(const Environment& env) : sorted_lengths(env.vecs.size())
+{
+    vec3<double> sum(0, 0, 0);
+    double outer[3][3] = {}; // NOLINT(modernize-avoid-c-arrays)
+    for (unsigned int m = 0; m < env.vecs.size(); m++)
+    {
+        const vec3<double> v(env.vecs[m].x, env.vecs[m].y, env.vecs[m].z);
+        const double v_array[3] = {v.x, v.y, v.z}; // NOLINT(modernize-avoid-c-arrays)
+        sorted_lengths[m] = std::sqrt(dot(v, v));
+        length_sum += sorted_lengths[m];
+        sum += v;
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            for (unsigned int col = 0; col < 3; col++)
+            {
+                outer[row][col] += v_array[row] * v_array[col];
+            }
+        }
+    }
+    std::sort(sorted_lengths.begin(), sorted_lengths.end());
+
+    double outer_norm_sq = 0;
+    for (auto& row : outer)
+    {
+        for (const double element : row)
+        {
+            outer_norm_sq += element * element;
+        }
+    }
+    dipole = std::sqrt(dot(sum, sum));
+    quadrupole = std::sqrt(outer_norm_sq);
+}
+
+bool EnvironmentFingerprint::mayMatch(const EnvironmentFingerprint& other, float threshold) const
+{
+    if (sorted_lengths.size() != other.sorted_lengths.size())
+    {
+        return false;
+    }
+    const float max_delta = threshold * (float(1.0) + FINGERPRINT_TOLERANCE);
+    for (unsigned int m = 0; m < sorted_lengths.size(); m++)
+    {
+        if (std::abs(sorted_lengths[m] - other.sorted_lengths[m]) > max_delta)
+        {
+            return false;
+        }
+    }
+    const auto num_vecs = static_cast<float>(sorted_lengths.size());
+    if (std::abs(dipole - other.dipole) > num_vecs * max_delta)
+    {
+        return false;
+    }
+    // The quadrupole bound is relative to the sum of the lengths, so its
+    // rounding error scales with the square of the lengths.
+    const float quadrupole_slack = FINGERPRINT_TOLERANCE * (quadrupole + other.quadrupole);
+    return std::abs(quadrupole - other.quadrupole)
+        <= max_delta * (length_sum + other.length_sum) + quadrupole_slack;
+}
+
 /*************************
  * Convenience functions *
  *************************/
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
-                                                                       float threshold_sq, bool registration)
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+isSimilar(const Environment& e1, const Environment& e2, float threshold_sq, bool registration)
 {
     BiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
@@ -399,8 +401,8 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
     return std::pair<Environment, Environment>(e0, e1);
 }
 
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
-                                                                          float& min_rmsd, bool registration)
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+minimizeRMSD(const Environment& e1, const Environment& e2, float& min_rmsd, bool registration)
 {
     BiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
@@ -484,6 +486,15 @@ MatchEnv::~MatchEnv() = default;
 /**********************
  * EnvironmentCluster *
  **********************/
+namespace {
+
+//! Smallest number of pairs of environments compared in parallel before merging, per thread
+constexpr size_t ENV_CLUSTER_MIN_BATCH_SIZE_PER_THREAD = 4;
+
+//! Largest number of pairs of environments compared in parallel before merging
+constexpr size_t ENV_CLUSTER_MAX_BATCH_SIZE = 4096;
+
+}; // end anonymous namespace
 
 EnvironmentCluster::~EnvironmentCluster() = default;
 
@@ -527,7 +538,6 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
 
     nlist.validate(Np, Np);
     env_nlist.validate(Np, Np);
-    size_t env_bond(0);
     const size_t env_num_bonds(env_nlist.getNumBonds());
 
     // create a disjoint set where all particles belong in their own cluster
@@ -537,44 +547,124 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
     // take care, here: set things up s.t. the env_ind of every environment
     // matches its location in the disjoint set.
     // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
+    dj.s.resize(Np);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        size_t env_bond(env_nlist.find_first_index(begin));
+        for (size_t i = begin; i < end; i++)
+        {
+            dj.s[i] = buildEnv(nq, &env_nlist, env_num_bonds, env_bond, i, i);
+        }
+    });
+    for (const auto& ei : dj.s)
     {
-        Environment ei = buildEnv(nq, &env_nlist, env_num_bonds, env_bond, i, i);
-        dj.s.push_back(ei);
         dj.m_max_num_neigh = std::max(dj.m_max_num_neigh, ei.num_vecs);
-        ;
     }
 
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, dj.m_max_num_neigh});
 
-    size_t bond(0);
+    // Compute the fingerprint of every environment once, so that pairs of
+    // environments that cannot match are skipped without registration.
+    std::vector<EnvironmentFingerprint> fingerprints(Np);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            fingerprints[i] = EnvironmentFingerprint(dj.s[i]);
+        }
+    });
+
+    // Pairs of environments are compared in parallel in batches, and the
+    // matching pairs of each batch are then merged in order. Since merges
+    // reorder and rotate the environments in the set, the comparisons use
+    // the environments as they were built, and each mapping is converted to
+    // the current ordering and orientation of the pair when it is merged.
+    // Pairs whose environments were joined by an earlier merge of the same
+    // batch are compared needlessly, so the batch shrinks while many pairs
+    // are wasted, which is typical of large clusters forming, and grows
+    // again when few are.
+    const std::vector<Environment> built_envs(dj.s);
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    std::vector<std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>> mappings;
+    const size_t min_batch_size = ENV_CLUSTER_MIN_BATCH_SIZE_PER_THREAD
+        * static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+    size_t batch_size = min_batch_size;
+
+    auto mergeBatch = [&]() {
+        mappings.resize(pairs.size());
+        util::forLoopWrapper(0, pairs.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++)
+            {
+                mappings[k] = isSimilar(built_envs[pairs[k].first], built_envs[pairs[k].second],
+                                        m_threshold_sq, registration);
+            }
+        });
+        size_t num_wasted = 0;
+        for (size_t k = 0; k < pairs.size(); k++)
+        {
+            const unsigned int i = pairs[k].first;
+            const unsigned int j = pairs[k].second;
+            const BiMap<unsigned int, unsigned int>& built_vec_map = mappings[k].second;
+            // if the mapping between the vectors of the environments is NOT
+            // empty, then the environments are similar, so merge them unless
+            // an earlier pair of the batch already did.
+            if (dj.find(i) == dj.find(j))
+            {
+                num_wasted++;
+                continue;
+            }
+            if (built_vec_map.empty())
+            {
+                continue;
+            }
+            const Environment& ei = dj.s[i];
+            const Environment& ej = dj.s[j];
+            std::vector<unsigned int> ej_proper_inds(ej.vec_ind.size());
+            for (unsigned int proper_ind = 0; proper_ind < ej.vec_ind.size(); proper_ind++)
+            {
+                ej_proper_inds[ej.vec_ind[proper_ind]] = proper_ind;
+            }
+            BiMap<unsigned int, unsigned int> vec_map;
+            for (unsigned int proper_ind = 0; proper_ind < ei.vec_ind.size(); proper_ind++)
+            {
+                vec_map.emplace(proper_ind, ej_proper_inds[built_vec_map.left[ei.vec_ind[proper_ind]]]);
+            }
+            const rotmat3<float> rotation = ei.proper_rot * mappings[k].first * transpose(ej.proper_rot);
+            dj.merge(i, j, vec_map, rotation);
+        }
+        if (4 * num_wasted > pairs.size())
+        {
+            batch_size = std::max(min_batch_size, batch_size / 2);
+        }
+        else
+        {
+            batch_size = std::min(ENV_CLUSTER_MAX_BATCH_SIZE, 2 * batch_size);
+        }
+        pairs.clear();
+    };
+
+    // Environments that already belong to the same set are never merged, so
+    // they are not compared either.
+    auto addPair = [&](unsigned int i, unsigned int j) {
+        if (fingerprints[i].mayMatch(fingerprints[j], threshold) && dj.find(i) != dj.find(j))
+        {
+            pairs.emplace_back(i, j);
+            if (pairs.size() >= batch_size)
+            {
+                mergeBatch();
+            }
+        }
+    };
+
     // loop through points
     for (unsigned int i = 0; i < Np; i++)
     {
         if (!global)
         {
             // loop over the neighbors
-            for (; bond < nlist.getNumBonds() && nlist.getNeighbors()(bond, 0) == i; ++bond)
+            for (size_t bond = nlist.find_first_index(i);
+                 bond < nlist.getNumBonds() && nlist.getNeighbors()(bond, 0) == i; ++bond)
             {
-                const size_t j(nlist.getNeighbors()(bond, 1));
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-                    = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-                // if the mapping between the vectors of the environments
-                // is NOT empty, then the environments are similar, so
-                // merge them.
-                if (!vec_map.empty())
-                {
-                    // merge the two sets using the disjoint set
-                    unsigned int a = dj.find(i);
-                    unsigned int b = dj.find(j);
-                    if (a != b)
-                    {
-                        dj.merge(i, j, vec_map, rotation);
-                    }
-                }
+                addPair(i, nlist.getNeighbors()(bond, 1));
             }
         }
         else
@@ -582,33 +672,18 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
             // loop over all other particles
             for (unsigned int j = i + 1; j < Np; j++)
             {
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-                    = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-                // if the mapping between the vectors of the environments
-                // is NOT empty, then the environments are similar, so
-                // merge them.
-                if (!vec_map.empty())
-                {
-                    // merge the two sets using the disjoint set
-                    unsigned int a = dj.find(i);
-                    unsigned int b = dj.find(j);
-                    if (a != b)
-                    {
-                        dj.merge(i, j, vec_map, rotation);
-                    }
-                }
+                addPair(i, j);
             }
         }
     }
+    mergeBatch();
 
     // done looping over points. All clusters are now determined. Renumber
     // them from zero to num_clusters-1.
     m_num_clusters = populateEnv(dj);
 }
 
-unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet dj)
+unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet& dj)
 {
     std::map<unsigned int, unsigned int> label_map;
     std::map<unsigned int, std::vector<vec3<float>>> cluster_env;
@@ -652,10 +727,15 @@ unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet dj)
     }
 
     // Now update the vector of environments from the map.
-    m_cluster_environments.resize(cluster_env.size());
+    std::vector<size_t> env_sizes(cluster_env.size());
+    for (const auto& it : cluster_env)
+    {
+        env_sizes[it.first] = it.second.size();
+    }
+    m_cluster_environments.prepare(env_sizes);
     for (const auto& it : cluster_env)
     {
-        m_cluster_environments[it.first] = it.second;
+        std::copy(it.second.begin(), it.second.end(), m_cluster_environments.getSegment(it.first));
     }
 
     // specify the number of cluster environments
@@ -665,6 +745,53 @@ unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet dj)
 /*************************
  * EnvironmentMotifMatch *
  *************************/
+namespace {
+
+//! Build the environment characterized by a motif
+/*! The IGNORE flag is set to true, since this is not an environment we have
+ *  actually encountered in the simulation. All the vectors are wrapped back
+ *  into the box, since all the vectors that are added to actual particle
+ *  environments are wrapped into the box as well.
+ */
+Environment makeMotifEnvironment(const box::Box& box, const vec3<float>* motif, unsigned int motif_size)
+{
+    Environment e0 = Environment(true);
+    for (unsigned int i = 0; i < motif_size; i++)
+    {
+        e0.addVec(box.wrap(motif[i]));
+    }
+    return e0;
+}
+
+//! Write the vectors of the environment of point i, ordered and rotated to match the motif
+/*! If the vector mapping is empty, the environment does not match the motif
+ *  and its vectors are written in their original order and orientation.
+ */
+void writePointEnvironment(util::ManagedArray<vec3<float>>& point_environments, unsigned int i,
+                           const Environment& ei, const rotmat3<float>& rotation,
+                           const BiMap<unsigned int, unsigned int>& vec_map, unsigned int motif_size)
+{
+    const unsigned int num_vecs = std::min(static_cast<unsigned int>(ei.vecs.size()), motif_size);
+    for (unsigned int m = 0; m < num_vecs; m++)
+    {
+        if (vec_map.empty())
+        {
+            point_environments(i, m) = ei.vecs[m];
+        }
+        else
+        {
+            point_environments(i, m) = rotation * ei.vecs[vec_map.left[m]];
+        }
+    }
+}
+
+}; // end anonymous namespace
+
+/*! Every environment is only compared against the motif, so the points are
+ *  processed in parallel and the ordered, rotated vectors of each environment
+ *  are written directly, rather than merging every matching environment into
+ *  the set of the motif.
+ */
 void EnvironmentMotifMatch::compute(const freud::locality::NeighborQuery* nq,
                                     const freud::locality::NeighborList* nlist_arg, locality::QueryArgs qargs,
                                     const vec3<float>* motif, unsigned int motif_size, float threshold,
@@ -678,73 +805,42 @@ void EnvironmentMotifMatch::compute(const freud::locality::NeighborQuery* nq,
 
     nlist.validate(Np, Np);
 
-    // create a disjoint set where all particles belong in their own cluster.
-    // this has to have ONE MORE environment than there are actual particles,
-    // because we're inserting the motif into it.
-    EnvDisjointSet dj(Np + 1);
-    dj.m_max_num_neigh = motif_size;
-
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, motif_size});
 
     // create the environment characterized by motif. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we have
-    // actually encountered in the simulation.
-    Environment e0 = Environment(true);
-
-    // loop through all the vectors in motif and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since
-    // all the vectors that will be added to actual particle environments will
-    // be wrapped into the box as well.
-    for (unsigned int i = 0; i < motif_size; i++)
-    {
-        vec3<float> p = nq->getBox().wrap(motif[i]);
-        e0.addVec(p);
-    }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
+    Environment e0 = makeMotifEnvironment(nq->getBox(), motif, motif_size);
+    const EnvironmentFingerprint motif_fingerprint(e0);
 
-    size_t bond(0);
     const size_t num_bonds(nlist.getNumBonds());
 
     m_matches.prepare(Np);
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment
-    // matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
-    {
-        unsigned int dummy = i + 1;
-        Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, dummy);
-        dj.s.push_back(ei);
-
-        // if the environment matches e0, merge it into the e0 environment set
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-            = isSimilar(dj.s[0], dj.s[dummy], m_threshold_sq, registration);
-        rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-        // if the mapping between the vectors of the environments is NOT empty,
-        // then the environments are similar.
-        if (!vec_map.empty())
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        size_t bond(nlist.find_first_index(begin));
+        for (size_t i = begin; i < end; i++)
         {
-            dj.merge(0, dummy, vec_map, rotation);
-            m_matches[i] = true;
-        }
-        // grab the set of vectors that define this individual environment
-        std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(dummy);
+            Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, i + 1);
 
-        for (unsigned int m = 0; m < part_vecs.size(); m++)
-        {
-            m_point_environments(i, m) = part_vecs[m];
+            // if the mapping between the vectors of the environments is NOT
+            // empty, then the environment matches the motif.
+            std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping;
+            if (motif_fingerprint.mayMatch(EnvironmentFingerprint(ei), threshold))
+            {
+                mapping = isSimilar(e0, ei, m_threshold_sq, registration);
+            }
+            m_matches[i] = !mapping.second.empty();
+            writePointEnvironment(m_point_environments, i, ei, mapping.first, mapping.second, motif_size);
         }
-    }
+    });
 }
 
 /****************************
  * EnvironmentRMSDMinimizer *
  ****************************/
+/*! Like EnvironmentMotifMatch::compute, the environments of all points are
+ *  registered to the motif in parallel.
+ */
 void EnvironmentRMSDMinimizer::compute(const freud::locality::NeighborQuery* nq,
                                        const freud::locality::NeighborList* nlist_arg,
                                        locality::QueryArgs qargs, const vec3<float>* motif,
@@ -755,74 +851,31 @@ void EnvironmentRMSDMinimizer::compute(const freud::locality::NeighborQuery* nq,
 
     unsigned int Np = nq->getNPoints();
 
-    // create a disjoint set where all particles belong in their own cluster.
-    // this has to have ONE MORE environment than there are actual particles,
-    // because we're inserting the motif into it.
-    EnvDisjointSet dj(Np + 1);
-    dj.m_max_num_neigh = motif_size;
-
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, motif_size});
 
     // create the environment characterized by motif. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we
-    // have actually encountered in the simulation.
-    Environment e0 = Environment(true);
-
-    // loop through all the vectors in motif and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since
-    // all the vectors that will be added to actual particle environments will
-    // be wrapped into the box as well.
-    for (unsigned int i = 0; i < motif_size; i++)
-    {
-        vec3<float> p = nq->getBox().wrap(motif[i]);
-        e0.addVec(p);
-    }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
+    Environment e0 = makeMotifEnvironment(nq->getBox(), motif, motif_size);
 
-    size_t bond(0);
     const size_t num_bonds(nlist.getNumBonds());
 
     m_rmsds.prepare(Np);
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment
-    // matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
-    {
-        unsigned int dummy = i + 1;
-        Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, dummy);
-        dj.s.push_back(ei);
-
-        // if the environment matches e0, merge it into the e0 environment set
-        float min_rmsd = -1.0;
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-            = minimizeRMSD(dj.s[0], dj.s[dummy], min_rmsd, registration);
-        rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-        // populate the min_rmsd vector
-        m_rmsds[i] = min_rmsd;
-
-        // if the mapping between the vectors of the environments is NOT
-        // empty, then the environments are similar.
-        // minimizeRMSD should always return a non-empty vec_map, except if
-        // e0 and e1 have different numbers of vectors.
-        if (!vec_map.empty())
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        size_t bond(nlist.find_first_index(begin));
+        for (size_t i = begin; i < end; i++)
         {
-            dj.merge(0, dummy, vec_map, rotation);
+            Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, i + 1);
+
+            // minimizeRMSD should always return a non-empty vec_map, except if
+            // e0 and ei have different numbers of vectors.
+            float min_rmsd = -1.0;
+            std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+                = minimizeRMSD(e0, ei, min_rmsd, registration);
+            m_rmsds[i] = min_rmsd;
+            writePointEnvironment(m_point_environments, i, ei, mapping.first, mapping.second, motif_size);
         }
-
-        // grab the set of vectors that define this individual environment
-        std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(dummy);
-
-        for (unsigned int m = 0; m < part_vecs.size(); m++)
-        {
-            m_point_environments(i, m) = part_vecs[m];
-        }
-    }
+    });
 }
 
 }; }; // end namespace freud::environment
@@ -12,6 +12,7 @@
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "RaggedArray.h"
 #include "Registration.h"
 #include "VectorMath.h"
 
@@ -61,17 +62,17 @@ struct EnvDisjointSet
      * the right. The rotation must take the set of PROPERLY ROTATED vectors b
      * and rotate them to match the set of PROPERLY ROTATED vectors a
      */
-    void merge(const unsigned int a, const unsigned int b, BiMap<unsigned int, unsigned int> vec_map,
-               rotmat3<float>& rotation);
+    void merge(const unsigned int a, const unsigned int b, const BiMap<unsigned int, unsigned int>& vec_map,
+               const rotmat3<float>& rotation);
 
     //! Find the set with a given element (taken mostly from Cluster.cc).
     unsigned int find(const unsigned int c);
 
     //! Return ALL nodes in the tree that correspond to the head index m
-    /*! Return ALL nodes in the tree that correspond to the head index m.
-     * Values returned: the actual locations of the nodes in s. (i.e. if i is
-     * returned, the node is accessed by s[i]). If environment m doesn't exist
-     * as a HEAD in the set, throw an error.
+    /*! Return ALL nodes in the tree that correspond to the head index m, in
+     * ascending order. Values returned: the actual locations of the nodes in
+     * s. (i.e. if i is returned, the node is accessed by s[i]). If environment
+     * m doesn't exist as a HEAD in the set, throw an error.
      */
     std::vector<unsigned int> findSet(const unsigned int m);
 
@@ -88,7 +89,50 @@ struct EnvDisjointSet
 
     std::vector<Environment> s;     //!< The disjoint set data
     std::vector<unsigned int> rank; //!< The rank of each tree in the set
-    unsigned int m_max_num_neigh;   //!< The maximum number of neighbors in any environment in the set
+    //! The nodes of the set of each head index, in order of merging
+    std::vector<std::vector<unsigned int>> members;
+    unsigned int m_max_num_neigh; //!< The maximum number of neighbors in any environment in the set
+
+private:
+    //! Reorder and rotate every node of the set other_head to match head, and move it into head
+    /*! \param head Head index of the set that is merged into.
+     *  \param other_head Head index of the set that is merged.
+     *  \param other_inds The proper index in other_head that corresponds to each proper index in head.
+     *  \param rotation Rotation that takes the properly rotated vectors of other_head to those of head.
+     */
+    void mergeInto(const unsigned int head, const unsigned int other_head,
+                   const std::vector<unsigned int>& other_inds, const rotmat3<float>& rotation);
+};
+
+//! Rotation-invariant summary of an environment used to rule out matches cheaply
+/*! Two environments can only match if there is a one-to-one mapping between
+ * their vectors under which every pair of vectors differs by less than the
+ * threshold, after any rotation when registering. Since rotations preserve
+ * lengths, the lengths of mapped vectors then also differ by less than the
+ * threshold, and so do the lengths matched in sorted order, because the
+ * sorted matching minimizes the largest difference. The same mapping bounds
+ * the difference of the magnitudes of the sum of the vectors (the dipole
+ * moment) by the number of vectors times the threshold, and the difference
+ * of the Frobenius norms of the sum of their outer products (the quadrupole
+ * moment) by the threshold times the sum of all lengths. Environments whose
+ * fingerprints violate any of these bounds are therefore never similar, and
+ * their comparison can be skipped without changing any result.
+ */
+struct EnvironmentFingerprint
+{
+    //! Constructor for an empty environment.
+    EnvironmentFingerprint() = default;
+
+    //! Compute the fingerprint of the vectors of an environment.
+    explicit EnvironmentFingerprint(const Environment& env);
+
+    //! Whether environments with these fingerprints can match within the threshold.
+    bool mayMatch(const EnvironmentFingerprint& other, float threshold) const;
+
+    std::vector<float> sorted_lengths; //!< The lengths of the vectors in ascending order
+    float length_sum {0};              //!< The sum of the lengths of the vectors
+    float dipole {0};                  //!< The magnitude of the sum of the vectors
+    float quadrupole {0};              //!< The Frobenius norm of the sum of the outer products of the vectors
 };
 
 /*****************************************************************************
@@ -121,8 +165,8 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
  *                     orient the second set of vectors such that it
  *                     minimizes the RMSD between the two sets
  */
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
-                                                                          float& min_rmsd, bool registration);
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+minimizeRMSD(const Environment& e1, const Environment& e2, float& min_rmsd, bool registration);
 
 //! Overload of the above minimizeRMSD function that provides an easier interface to Python.
 /*! Construct the environments accordingly, and utilize minimizeRMSD() as
@@ -163,8 +207,8 @@ std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec
  *                     orient the second set of vectors such that it
  *                     minimizes the RMSD between the two sets
  */
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
-                                                                       float threshold_sq, bool registration);
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+isSimilar(const Environment& e1, const Environment& e2, float threshold_sq, bool registration);
 
 //! Overload of the above isSimilar function that provides an easier interface to Python.
 /*! If the two environments correspond, returns a std::pair of the rotation matrix that takes the
@@ -279,8 +323,8 @@ public:
         return m_env_index;
     }
 
-    //! Get a reference to the particles, indexed into clusters according to their matching local environments
-    std::vector<std::vector<vec3<float>>> getClusterEnvironments()
+    //! Get a reference to the environment vectors of each cluster
+    const util::RaggedArray<vec3<float>>& getClusterEnvironments() const
     {
         return m_cluster_environments;
     }
@@ -307,12 +351,11 @@ private:
      *                with that environment (which defines the cluster).
      * \return The number of clusters found.
      */
-    unsigned int populateEnv(EnvDisjointSet dj);
+    unsigned int populateEnv(EnvDisjointSet& dj);
 
-    unsigned int m_num_clusters {0};              //!< Last number of local environments computed
-    util::ManagedArray<unsigned int> m_env_index; //!< Cluster index determined for each particle
-    std::vector<std::vector<vec3<float>>>
-        m_cluster_environments; //!< Dictionary of (cluster id, vectors) pairs
+    unsigned int m_num_clusters {0};                       //!< Last number of local environments computed
+    util::ManagedArray<unsigned int> m_env_index;          //!< Cluster index determined for each particle
+    util::RaggedArray<vec3<float>> m_cluster_environments; //!< Environment vectors of each cluster
 };
 
 //! Match local point environments to a specific motif.
@@ -4,6 +4,7 @@
 #ifndef REGISTRATION_H
 #define REGISTRATION_H
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <random>
@@ -27,15 +28,16 @@
 namespace freud { namespace environment {
 
 using matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+//! A set of points, one per row
+using point_matrix = Eigen::Matrix<double, Eigen::Dynamic, 3>;
+//! A rotation of three-dimensional points
+using rotation_matrix = Eigen::Matrix3d;
 
-inline matrix makeEigenMatrix(const std::vector<vec3<float>>& vecs)
+inline point_matrix makeEigenMatrix(const std::vector<vec3<float>>& vecs)
 {
     // build the Eigen matrix
-    matrix mat;
-    unsigned int size = vecs.size();
-    // we know the dimension is 3 bc we're dealing with a vector of vec3's.
-    mat.resize(size, 3);
-    for (unsigned int i = 0; i < size; i++)
+    point_matrix mat(vecs.size(), 3);
+    for (unsigned int i = 0; i < vecs.size(); i++)
     {
         mat(i, 0) = vecs[i].x;
         mat(i, 1) = vecs[i].y;
@@ -66,57 +68,44 @@ inline std::vector<vec3<float>> makeVec3Matrix(const matrix& m)
     return vecs;
 }
 
-inline matrix CenterOfMass(const matrix& P)
+inline Eigen::RowVector3d CenterOfMass(const point_matrix& P)
 {
     // Assumes that P = (v^T) if v is a column vector.
     // In other notation, P = [x1, y1, z1; ...]
     // p.size = (N rows, 3 cols)
-    matrix cm(1, P.cols());
-    for (int i = 0; i < P.cols(); i++)
-    {
-        cm(0, i) = P.col(i).sum() / double(P.rows());
-    }
-
-    return cm;
+    return P.colwise().mean();
 }
 
-inline matrix Translate(const matrix& vec, const matrix& P)
+inline point_matrix Translate(const Eigen::RowVector3d& vec, const point_matrix& P)
 {
-    matrix trans = matrix::Zero(P.rows(), P.cols());
-    for (int i = 0; i < P.rows(); i++)
-    {
-        trans.row(i) = P.row(i) + vec;
-    }
-    return trans;
+    return P.rowwise() + vec;
 }
 
-inline matrix Rotate(const matrix& R, const matrix& P)
+inline Eigen::Matrix<double, 3, Eigen::Dynamic> Rotate(const rotation_matrix& R,
+                                                       const Eigen::Matrix<double, 3, Eigen::Dynamic>& P)
 {
-    // Assume the matrix P is a 3xN matrix.
-    // Then make sure that matrix R is ready to act on it
-    if (R.cols() != P.rows())
-    {
-        std::ostringstream msg;
-        msg << "Rotation matrix has " << R.cols() << " columns and point matrix has " << P.rows()
-            << " rows. These must be equal to perform the rotation." << std::endl;
-        throw std::invalid_argument(msg.str());
-    }
-    // Apply the rotation R.
+    // The matrix P is a 3xN matrix, so the rotation R acts on it directly.
     return R * P;
 }
 
 // some helpful references:
 // http://cnx.org/contents/HV-RsdwL@23/Molecular-Distance-Measures
 // http://btk.sourceforge.net/html_docs/0.8.1/rmsd_theory.html
-inline void KabschAlgorithm(const matrix& P, const matrix& Q, matrix& Rotation)
+/*! The point sets may have any number of rows, but their cross-covariance is
+ *  always a 3x3 matrix, so the SVD uses fixed-size matrices that Eigen
+ *  decomposes without any heap allocation.
+ */
+template<typename MatrixP, typename MatrixQ>
+inline void KabschAlgorithm(const Eigen::MatrixBase<MatrixP>& P, const Eigen::MatrixBase<MatrixQ>& Q,
+                            rotation_matrix& Rotation)
 {
     // Preconditions: P and Q have been translated to have the same center of mass.
-    matrix A = P.transpose() * Q;
+    const Eigen::Matrix3d A = P.transpose() * Q;
     // singular value decomposition (~ eigen decomposition)
-    Eigen::JacobiSVD<matrix> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
     // A = USV^T
-    matrix U = svd.matrixU();
-    matrix V = svd.matrixV();
+    const Eigen::Matrix3d& U = svd.matrixU();
+    Eigen::Matrix3d V = svd.matrixV();
 
     double det = (V * U.transpose()).determinant();
 
@@ -124,18 +113,18 @@ inline void KabschAlgorithm(const matrix& P, const matrix& Q, matrix& Rotation)
     // (proper) rotation by reflecting the smallest principal axis in rot:
     if (det < 0)
     {
-        V.col(V.cols() - 1) *= -1.0;
+        V.col(2) *= -1.0;
     }
     // This is the rotation matrix that minimizes the MSD between all pairs of points P and Q.
     Rotation = V * U.transpose();
 }
 
-inline void AlignVectorSets(matrix& P, matrix& Q, matrix* pRotation = nullptr)
+inline void AlignVectorSets(point_matrix& P, point_matrix& Q, rotation_matrix* pRotation = nullptr)
 {
     // Aligns p with q.
     // both p and q will be changed in this operation.
 
-    matrix rotation;
+    rotation_matrix rotation;
     // Translate both p,q to origin.
     P = Translate(-CenterOfMass(P), P);
     Q = Translate(-CenterOfMass(Q), Q);
@@ -152,22 +141,29 @@ inline void AlignVectorSets(matrix& P, matrix& Q, matrix* pRotation = nullptr)
     }
 }
 
+//! Finds the rotation and permutation of a set of points that best match a set of reference points
+/*! Candidate rotations are found by aligning triplets of points to a random
+ *  triplet of reference points with the Kabsch algorithm. The candidate
+ *  triplets, cross-covariances and rotations all have at most three rows, so
+ *  they are stored in fixed-size Eigen matrices, and the buffers used to rotate
+ *  and assign the points are reused across candidates and calls to Fit. Each
+ *  thread seeds a single random number generator on first use, so a
+ *  RegisterBruteForce is cheap to construct for every pair of environments
+ *  that is compared.
+ */
 class RegisterBruteForce
 {
 public:
-    explicit RegisterBruteForce(std::vector<vec3<float>>& vecs) : m_ref_points(makeEigenMatrix(vecs)) {};
+    explicit RegisterBruteForce(std::vector<vec3<float>>& vecs)
+        : m_ref_points(makeEigenMatrix(vecs)), m_ref_vecs(vecs) {};
 
     ~RegisterBruteForce() = default;
 
     void Fit(std::vector<vec3<float>>& pts)
     {
-        matrix points;
-        matrix p;
-        matrix q;
-        matrix r;
         // make the Eigen matrix from pts
-        points = makeEigenMatrix(pts);
-        int num_pts;
+        const point_matrix points = makeEigenMatrix(pts);
+        const Eigen::Matrix<double, 3, Eigen::Dynamic> points_T = points.transpose();
 
         int N = points.rows();
         if (N != m_ref_points.rows())
@@ -179,7 +175,19 @@ public:
             throw std::invalid_argument(msg.str());
         }
 
-        RandomNumber<std::mt19937_64> rng;
+        // Seeding from std::random_device is expensive, so each thread seeds
+        // its generator only once.
+        static thread_local RandomNumber<std::mt19937_64> rng;
+
+        // Triplets of points have at most three rows.
+        using triplet_matrix = Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor, 3, 3>;
+        const int num_pts = std::min(N, 3);
+        triplet_matrix p(num_pts, 3);
+        triplet_matrix q(num_pts, 3);
+        rotation_matrix r;
+        Eigen::Matrix<double, 3, Eigen::Dynamic> rot_points(3, N);
+        std::vector<unsigned int> best_assignment;
+
         double rmsd_min = -1.0;
         for (size_t shuffles = 0; shuffles < m_shuffles; shuffles++)
         {
@@ -212,48 +220,18 @@ public:
             // arrays, but we need to be careful to preserve the right behavior
             // (particularly wrt NextCombination).
             size_t comb[3] = {0, 1, 2}; // NOLINT(modernize-avoid-c-arrays)
-            if (N == 2)
-            {
-                num_pts = 2;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            else if (N == int(1))
+            const int ref_rows[3] = {p0, p1, p2}; // NOLINT(modernize-avoid-c-arrays)
+            for (int k = 0; k < num_pts; k++)
             {
-                num_pts = 1;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            else
-            {
-                num_pts = 3;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                p.row(2) = m_ref_points.row(p2);
-                q.resize(num_pts, m_ref_points.cols());
+                p.row(k) = m_ref_points.row(ref_rows[k]);
             }
             do
             {
                 do
                 {
-                    if (N == int(2))
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                    }
-                    else if (N == int(1))
+                    for (int k = 0; k < num_pts; k++)
                     {
-                        q.row(0) = points.row(comb[0]);
-                    }
-                    else
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                        q.row(2) = points.row(comb[2]);
+                        q.row(k) = points.row(comb[k]);
                     }
 
                     // finds the optimal rotation of the FIRST input set
@@ -263,38 +241,25 @@ public:
 
                     // The rotation that we've found from the
                     // KabschAlgorithm actually acts on P^T.
-                    matrix rot_points = Rotate(r, points.transpose());
+                    rot_points.noalias() = r * points_T;
 
-                    // feed back in the TRANSPOSE of rot_points such that
-                    // the input matrix is (Nx3).
-                    BiMap<unsigned int, unsigned int> vec_map;
-                    float rmsd = AlignedRMSDTree(rot_points.transpose(), vec_map);
+                    float rmsd = alignedRMSD(rot_points);
                     if (rmsd < rmsd_min || rmsd_min < 0.0)
                     {
                         m_rmsd = rmsd;
                         m_rotation = r;
-                        m_vec_map = vec_map;
+                        best_assignment = m_assignment;
                         rmsd_min = m_rmsd;
                         if (rmsd_min < m_tol)
                         {
-                            // The rotation that we've found from the KabschAlgorithm
-                            // actually acts on P^T.
-                            matrix ptsT = Rotate(m_rotation, points.transpose());
-                            // Then we have to take the transpose again to get our matrix
-                            // back to its original dimensionality.
-                            pts = makeVec3Matrix(ptsT.transpose());
+                            finishFit(points_T, best_assignment, pts);
                             return;
                         }
                     }
                 } while (std::next_permutation(comb, comb + num_pts));
             } while (NextCombination(comb, N, num_pts));
         } // end for loop over shuffles
-        // The rotation that we've found from the KabschAlgorithm
-        // actually acts on P^T.
-        matrix ptsT = Rotate(m_rotation, points.transpose());
-        // Then we have to take the transpose again to get our matrix
-        // back to its original dimensionality.
-        pts = makeVec3Matrix(ptsT.transpose());
+        finishFit(points_T, best_assignment, pts);
     }
 
     std::vector<vec3<float>> getRotation()
@@ -337,68 +302,86 @@ public:
     // set, the vector set used in the argument below.
     // To fully solve this, we need to use the Hungarian algorithm or some
     // other way of solving the so-called assignment problem.
-    float AlignedRMSDTree(const matrix& points, BiMap<unsigned int, unsigned int>& m)
+    float AlignedRMSDTree(const point_matrix& points, BiMap<unsigned int, unsigned int>& m)
     {
-        // Also brute force.
-        float rmsd = 0.0;
+        float rmsd = alignedRMSD(points.transpose());
 
         // a mapping between the vectors of m_ref_points and the vectors of points
         BiMap<unsigned int, unsigned int> vec_map;
+        for (unsigned int r = 0; r < m_assignment.size(); r++)
+        {
+            vec_map.emplace(m_assignment[r], r);
+        }
+        m = vec_map;
+        return rmsd;
+    }
+
+private:
+    //! Greedily assign each point to its nearest unused reference point
+    /*! The points are the columns of points_T. The index of the reference
+     *  point assigned to each point is stored in m_assignment.
+     *
+     *  \return The RMSD of the assignment.
+     */
+    float alignedRMSD(const Eigen::Matrix<double, 3, Eigen::Dynamic>& points_T)
+    {
+        const unsigned int num_refs = m_ref_vecs.size();
+        float rmsd = 0.0;
 
         // keeps track of whether m_ref_points have been matched to any point in points
         // guarantees 1-1 mapping
-        std::set<unsigned int> unused_indices;
-        for (int i = 0; i < m_ref_points.rows(); i++)
-        {
-            unused_indices.insert(i);
-        }
+        m_used.assign(num_refs, 0);
+        m_assignment.resize(points_T.cols());
 
         // loop through all the points
-        for (int r = 0; r < points.rows(); r++)
+        for (unsigned int r = 0; r < points_T.cols(); r++)
         {
             // get the rotated point
-            vec3<float> pfit = make_point(points.row(r));
-            // compute squared distances to all unused reference points
-            std::vector<std::pair<unsigned int, float>> ref_distances;
-            for (auto ref_index : unused_indices)
+            const vec3<float> pfit(points_T(0, r), points_T(1, r), points_T(2, r));
+            // find the nearest unused reference point and mark it as used
+            unsigned int nearest = num_refs;
+            float nearest_r_sq = 0;
+            for (unsigned int ref_index = 0; ref_index < num_refs; ref_index++)
             {
-                vec3<float> ref_point = make_point(m_ref_points.row(ref_index));
-                vec3<float> delta = ref_point - pfit;
-                float r_sq = dot(delta, delta);
-                ref_distances.emplace_back(ref_index, r_sq);
+                if (m_used[ref_index] != 0)
+                {
+                    continue;
+                }
+                const vec3<float> delta = m_ref_vecs[ref_index] - pfit;
+                const float r_sq = dot(delta, delta);
+                if (nearest == num_refs || r_sq < nearest_r_sq)
+                {
+                    nearest = ref_index;
+                    nearest_r_sq = r_sq;
+                }
             }
-            // sort the ref_distances from nearest to farthest
-            sort(ref_distances.begin(), ref_distances.end(), compare_ref_distances);
-            // take the first (nearest) ref_point found and mark it as used
-            unused_indices.erase(ref_distances[0].first);
+            m_used[nearest] = 1;
             // add this pairing to the mapping between vectors
-            vec_map.emplace(ref_distances[0].first, r);
+            m_assignment[r] = nearest;
             // add this squared distance to the rmsd
-            rmsd += ref_distances[0].second;
+            rmsd += nearest_r_sq;
         }
 
-        m = vec_map;
-        return std::sqrt(rmsd / static_cast<float>(points.rows()));
+        return std::sqrt(rmsd / static_cast<float>(points_T.cols()));
     }
 
-private:
-    static vec3<float> make_point(const Eigen::VectorXd& row)
+    //! Store the mapping of the best assignment and rotate the points by the best rotation
+    void finishFit(const Eigen::Matrix<double, 3, Eigen::Dynamic>& points_T,
+                   const std::vector<unsigned int>& best_assignment, std::vector<vec3<float>>& pts)
     {
-        if (row.rows() == 2)
-        {
-            return vec3<float>(row[0], row[1], 0.0);
-        }
-        if (row.rows() == 3)
+        BiMap<unsigned int, unsigned int> vec_map;
+        for (unsigned int r = 0; r < best_assignment.size(); r++)
         {
-            return vec3<float>(row[0], row[1], row[2]);
+            vec_map.emplace(best_assignment[r], r);
         }
-        throw(std::runtime_error("points must 2 or 3 dimensions"));
-    }
+        m_vec_map = vec_map;
 
-    static bool compare_ref_distances(const std::pair<unsigned int, float>& a,
-                                      const std::pair<unsigned int, float>& b)
-    {
-        return (a.second < b.second);
+        // The rotation that we've found from the KabschAlgorithm
+        // actually acts on P^T.
+        const Eigen::Matrix<double, 3, Eigen::Dynamic> ptsT = Rotate(m_rotation, points_T);
+        // Then we have to take the transpose again to get our matrix
+        // back to its original dimensionality.
+        pts = makeVec3Matrix(ptsT.transpose());
     }
 
     static inline bool NextCombination(size_t* comb, int N, int k)
@@ -465,9 +448,12 @@ private:
         RNG m_generator;
     };
 
-    matrix m_ref_points;
-    matrix m_rotation;
+    point_matrix m_ref_points;
+    std::vector<vec3<float>> m_ref_vecs;
+    rotation_matrix m_rotation {rotation_matrix::Identity()};
     matrix m_translation;
+    std::vector<unsigned int> m_assignment; //!< Reference point assigned to each point by alignedRMSD
+    std::vector<char> m_used;               //!< Whether each reference point has been assigned
     float m_rmsd {0.0};
     double m_tol {1e-6};
     size_t m_shuffles {1};
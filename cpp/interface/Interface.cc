@@ -0,0 +1,111 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "Interface.h"
+#include "NeighborComputeFunctional.h"
+#include "utils.h"
+
+/*! \file Interface.cc
+    \brief Find the points at the interface between two sets of points.
+*/
+
+namespace freud { namespace interface {
+
+namespace {
+
+//! Number of mask entries per block of the parallel compaction of the masks
+constexpr size_t COMPACTION_BLOCK_SIZE = 16384;
+
+//! Allocate a byte mask with all entries cleared.
+std::unique_ptr<std::atomic<unsigned char>[]> makeMask(unsigned int size)
+{
+    std::unique_ptr<std::atomic<unsigned char>[]> mask(new std::atomic<unsigned char>[size]);
+    util::forLoopWrapper(0, size, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            mask[i].store(0, std::memory_order_relaxed);
+        }
+    });
+    return mask;
+}
+
+//! Mark an entry of a mask.
+/*! The entry is read first, so points in many bonds do not keep writing to
+ *  a cache line shared between threads.
+ */
+inline void mark(std::atomic<unsigned char>& entry)
+{
+    if (entry.load(std::memory_order_relaxed) == 0)
+    {
+        entry.store(1, std::memory_order_relaxed);
+    }
+}
+
+}; // end anonymous namespace
+
+void Interface::compute(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                        unsigned int n_query_points, const locality::NeighborList* nlist,
+                        locality::QueryArgs qargs)
+{
+    const unsigned int n_points = neighbor_query->getNPoints();
+    const Mask point_mask = makeMask(n_points);
+    const Mask query_point_mask = makeMask(n_query_points);
+
+    std::atomic<unsigned char>* points_marked = point_mask.get();
+    std::atomic<unsigned char>* query_points_marked = query_point_mask.get();
+    locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                [=](const locality::NeighborBond& nb) {
+                                    mark(points_marked[nb.point_idx]);
+                                    mark(query_points_marked[nb.query_point_idx]);
+                                });
+
+    // The parallel loop ends with a barrier, so all marks are visible here.
+    compactMask(points_marked, n_points, m_point_ids);
+    compactMask(query_points_marked, n_query_points, m_query_point_ids);
+}
+
+void Interface::compactMask(const std::atomic<unsigned char>* mask, unsigned int size,
+                            util::ManagedArray<unsigned int>& ids)
+{
+    const size_t num_blocks = (size + COMPACTION_BLOCK_SIZE - 1) / COMPACTION_BLOCK_SIZE;
+
+    // Count the marked entries of each block, then write their indices at
+    // offsets given by a prefix sum over the block counts.
+    std::vector<unsigned int> block_offsets(num_blocks + 1, 0);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t last = std::min(size_t(size), (block + 1) * COMPACTION_BLOCK_SIZE);
+            unsigned int num_marked = 0;
+            for (size_t i = block * COMPACTION_BLOCK_SIZE; i < last; ++i)
+            {
+                num_marked += mask[i].load(std::memory_order_relaxed);
+            }
+            block_offsets[block + 1] = num_marked;
+        }
+    });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+    ids.prepareUninitialized(block_offsets.back());
+    unsigned int* out = ids.get();
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t last = std::min(size_t(size), (block + 1) * COMPACTION_BLOCK_SIZE);
+            unsigned int offset = block_offsets[block];
+            for (size_t i = block * COMPACTION_BLOCK_SIZE; i < last; ++i)
+            {
+                if (mask[i].load(std::memory_order_relaxed) != 0)
+                {
+                    out[offset++] = static_cast<unsigned int>(i);
+                }
+            }
+        }
+    });
+}
+
+}; }; // end namespace freud::interface
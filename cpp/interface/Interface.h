@@ -0,0 +1,85 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include <atomic>
+#include <memory>
+
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+
+/*! \file Interface.h
+    \brief Find the points at the interface between two sets of points.
+*/
+
+namespace freud { namespace interface {
+
+//! Find the points at the interface between two sets of points.
+/*! A point or query point is at the interface if it takes part in any bond.
+ *  The bonds are visited in parallel without building a NeighborList, and
+ *  each bond marks its point and query point in byte masks with relaxed
+ *  atomic stores, since many bonds may mark the same point. The sorted
+ *  indices of the marked points are then compacted from the masks in
+ *  parallel blocks.
+ */
+class Interface
+{
+public:
+    //! Constructor
+    Interface() = default;
+
+    //! Destructor
+    ~Interface() = default;
+
+    //! Compute the points at the interface.
+    /*! \param neighbor_query NeighborQuery of the points.
+     *  \param query_points The query points.
+     *  \param n_query_points The number of query points.
+     *  \param nlist NeighborList to use, or nullptr to query neighbor_query.
+     *  \param qargs The query arguments.
+     */
+    void compute(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                 unsigned int n_query_points, const locality::NeighborList* nlist, locality::QueryArgs qargs);
+
+    //! Get the number of points at the interface
+    unsigned int getPointCount() const
+    {
+        return static_cast<unsigned int>(m_point_ids.size());
+    }
+
+    //! Get the indices of the points at the interface, in increasing order
+    const util::ManagedArray<unsigned int>& getPointIds() const
+    {
+        return m_point_ids;
+    }
+
+    //! Get the number of query points at the interface
+    unsigned int getQueryPointCount() const
+    {
+        return static_cast<unsigned int>(m_query_point_ids.size());
+    }
+
+    //! Get the indices of the query points at the interface, in increasing order
+    const util::ManagedArray<unsigned int>& getQueryPointIds() const
+    {
+        return m_query_point_ids;
+    }
+
+private:
+    //! Byte mask that can be marked concurrently
+    using Mask = std::unique_ptr<std::atomic<unsigned char>[]>;
+
+    //! Get the indices of the marked entries of a mask, in increasing order.
+    static void compactMask(const std::atomic<unsigned char>* mask, unsigned int size,
+                            util::ManagedArray<unsigned int>& ids);
+
+    util::ManagedArray<unsigned int> m_point_ids;       //!< Indices of the points at the interface
+    util::ManagedArray<unsigned int> m_query_point_ids; //!< Indices of the query points at the interface
+};
+
+}; }; // end namespace freud::interface
+
+#endif // INTERFACE_H
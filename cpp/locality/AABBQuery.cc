@@ -2,16 +2,123 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <stdexcept>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
 
 #include "AABBQuery.h"
+#include "NeighborHeap.h"
+#include "utils.h"
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Ratio of the initial search radius of a nearest neighbor query to the distance of the k-th neighbor of the
+//! previous query point
+constexpr float AABB_NEAREST_GUESS_MARGIN = 1.1;
+
+//! Ratio of the sum of the leaf extents of a refit tree to that of the built tree above which it is rebuilt
+constexpr float AABB_REFIT_MAX_GROWTH = 1.5;
+
+//! Margin in fractional coordinates by which the balls of periodic images are widened when selecting them
+constexpr float AABB_IMAGE_MARGIN = 1e-5;
+
+//! Sum the edge lengths of the AABBs of all leaves of a tree
+float sumLeafExtents(const AABBTree& tree)
+{
+    return tbb::parallel_reduce(
+        tbb::blocked_range<unsigned int>(0, tree.getNumNodes()), float(0),
+        [&](const tbb::blocked_range<unsigned int>& r, float sum) {
+            for (unsigned int node = r.begin(); node != r.end(); ++node)
+            {
+                if (tree.isNodeLeaf(node))
+                {
+                    const AABB& aabb = tree.getNodeAABB(node);
+                    const vec3<float> extent = aabb.getUpper() - aabb.getLower();
+                    sum += extent.x + extent.y + extent.z;
+                }
+            }
+            return sum;
+        },
+        [](float left, float right) { return left + right; });
+}
+
+//! Entry of the stack of a wide tree traversal
+struct WideStackEntry
+{
+    unsigned int child; //!< Wide node index, or leaf node index combined with AABB_WIDE_LEAF
+    float d_sq;         //!< Squared distance from the query point to the bounds of the child
+};
+
+//! Visit the leaves of a tree that are within a distance of a point
+/*! The wide nodes of the tree are traversed depth first with a stack of the
+ *  size given by the tree, whose storage is reused across calls, so leaves are
+ *  visited in the same order as by the skips of the binary tree. Stacked
+ *  entries are tested again when they are popped, so the search radius may
+ *  shrink during the traversal.
+ *
+ *  \param tree The tree.
+ *  \param point The query point.
+ *  \param r_sq The initial squared search radius.
+ *  \param stack Storage for the stack of at least tree.getWideStackSize() entries.
+ *  \param visit_leaf Function (leaf node index) called for each leaf, which
+ *                    returns the squared search radius of the rest of the traversal.
+ */
+template<typename VisitLeaf>
+void forEachLeafInRange(const AABBTree& tree, const vec3<float>& point, float r_sq,
+                        std::vector<WideStackEntry>& stack, const VisitLeaf& visit_leaf)
+{
+    if (tree.getNumWideNodes() == 0)
+    {
+        return;
+    }
+
+    // Many searches, such as those of most periodic images, miss the tree
+    // entirely, which is checked against its bounds before testing children.
+    const AABB& root = tree.getNodeAABB(0);
+    const vec3<float> below = root.getLower() - point;
+    const vec3<float> above = point - root.getUpper();
+    const float dx = std::max(below.x, float(0)) + std::max(above.x, float(0));
+    const float dy = std::max(below.y, float(0)) + std::max(above.y, float(0));
+    const float dz = std::max(below.z, float(0)) + std::max(above.z, float(0));
+    std::array<float, AABB_WIDE_NODE_WIDTH> d_sq;
+    unsigned int top = 0;
+    stack[top++] = {0, dx * dx + dy * dy + dz * dz};
+    while (top > 0)
+    {
+        const WideStackEntry entry = stack[--top];
+        if (entry.d_sq > r_sq)
+        {
+            continue;
+        }
+        if ((entry.child & AABB_WIDE_LEAF) != 0)
+        {
+            r_sq = visit_leaf(entry.child & ~AABB_WIDE_LEAF);
+            continue;
+        }
+        const AABBWideNode& node = tree.getWideNode(entry.child);
+        const unsigned int mask = overlapMask(node, point, r_sq, d_sq.data());
+        // Children are pushed in reverse to be visited in order.
+        for (unsigned int c = node.num_children; c-- > 0;)
+        {
+            if ((mask & (1U << c)) != 0)
+            {
+                stack[top++] = {node.children[c], d_sq[c]};
+            }
+        }
+    }
+}
+
+}; // end anonymous namespace
+
 AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points)
     : NeighborQuery(box, points, n_points)
 {
     // Allocate memory and create image vectors
+    updateImages();
     setupTree(m_n_points);
 
     // Build the tree
@@ -43,90 +150,392 @@ void AABBQuery::setupTree(unsigned int Np)
     m_aabbs.resize(Np);
 }
 
-void AABBQuery::buildTree(const vec3<float>* points, unsigned int Np)
+void AABBQuery::computeAABBs(const vec3<float>* points, unsigned int Np)
 {
     // Construct a point AABB for each point
-    for (unsigned int i = 0; i < Np; ++i)
-    {
-        // Make a point AABB
-        vec3<float> my_pos(points[i]);
-        if (m_box.is2D())
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            my_pos.z = 0;
+            vec3<float> my_pos(points[i]);
+            if (m_box.is2D())
+            {
+                my_pos.z = 0;
+            }
+            m_aabbs[i] = AABB(my_pos, static_cast<unsigned int>(i));
         }
-        m_aabbs[i] = AABB(my_pos, i);
-    }
+    });
+}
+
+void AABBQuery::buildTree(const vec3<float>* points, unsigned int Np)
+{
+    computeAABBs(points, Np);
 
     // Call the tree build routine, one tree per type
     m_aabb_tree.buildTree(m_aabbs.data(), Np);
+    m_built_leaf_extent = sumLeafExtents(m_aabb_tree);
+
+    gatherLeafPoints(points);
 }
 
-void AABBIterator::updateImageVectors(float r_max, bool _check_r_max)
+void AABBQuery::update(const box::Box& box, const vec3<float>* points, unsigned int n_points)
 {
-    box::Box box = m_neighbor_query->getBox();
-    vec3<float> nearest_plane_distance = box.getNearestPlaneDistance();
-    vec3<bool> periodic = box.getPeriodic();
-    if (_check_r_max)
+    validatePoints(box, points, n_points);
+
+    const bool rebuild = (n_points != m_n_points) || (box.is2D() != m_box.is2D());
+    m_box = box;
+    m_points = points;
+    m_n_points = n_points;
+    updateImages();
+    if (getSortQueryPoints())
     {
-        if ((periodic.x && nearest_plane_distance.x <= r_max * 2.0)
-            || (periodic.y && nearest_plane_distance.y <= r_max * 2.0)
-            || (!box.is2D() && periodic.z && nearest_plane_distance.z <= r_max * 2.0))
-        {
-            throw std::runtime_error("The AABBQuery r_max is too large for this box.");
-        }
+        m_point_order
+            = std::make_shared<const std::vector<unsigned int>>(mortonOrder(m_box, points, n_points));
+    }
+
+    if (rebuild)
+    {
+        setupTree(m_n_points);
+        buildTree(m_points, m_n_points);
+        return;
     }
 
-    // Now compute the image vectors
-    // Each dimension increases by one power of 3
-    unsigned int n_dim_periodic = static_cast<unsigned int>(periodic.x)
-        + static_cast<unsigned int>(periodic.y)
-        + static_cast<unsigned int>(!box.is2D()) * static_cast<unsigned int>(periodic.z);
-    m_n_images = 1;
-    for (unsigned int dim = 0; dim < n_dim_periodic; ++dim)
+    computeAABBs(m_points, m_n_points);
+    m_aabb_tree.refit(m_aabbs.data());
+    if (sumLeafExtents(m_aabb_tree) > AABB_REFIT_MAX_GROWTH * m_built_leaf_extent)
+    {
+        buildTree(m_points, m_n_points);
+        return;
+    }
+    gatherLeafPoints(m_points);
+}
+
+void AABBQuery::gatherLeafPoints(const vec3<float>* points)
+{
+    const unsigned int num_nodes = m_aabb_tree.getNumNodes();
+    m_leaf_slot.assign(num_nodes, 0);
+    unsigned int num_leaves = 0;
+    for (unsigned int node = 0; node < num_nodes; ++node)
     {
-        m_n_images *= 3;
+        if (m_aabb_tree.isNodeLeaf(node))
+        {
+            m_leaf_slot[node] = num_leaves * NODE_CAPACITY;
+            ++num_leaves;
+        }
     }
 
-    // Reallocate memory if necessary
-    if (m_n_images > m_image_list.size())
+    m_leaf_points.resize(num_leaves * NODE_CAPACITY);
+    util::forLoopWrapper(0, num_nodes, [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; ++node)
+        {
+            if (!m_aabb_tree.isNodeLeaf(node))
+            {
+                continue;
+            }
+            for (unsigned int ref_p = 0; ref_p < m_aabb_tree.getNodeNumParticles(node); ++ref_p)
+            {
+                vec3<float> pos_j(points[m_aabb_tree.getNodeParticleTag(node, ref_p)]);
+                if (m_box.is2D())
+                {
+                    pos_j.z = 0;
+                }
+                m_leaf_points.set(m_leaf_slot[node] + ref_p, pos_j);
+            }
+        }
+    });
+}
+
+const std::vector<vec3<float>>& AABBQuery::getImageVectors(float r_max, bool check_r_max) const
+{
+    if (check_r_max)
     {
-        m_image_list.resize(m_n_images);
+        const vec3<bool> periodic = m_box.getPeriodic();
+        if ((periodic.x && m_plane_distance.x <= r_max * 2.0)
+            || (periodic.y && m_plane_distance.y <= r_max * 2.0)
+            || (!m_box.is2D() && periodic.z && m_plane_distance.z <= r_max * 2.0))
+        {
+            throw std::runtime_error("The AABBQuery r_max is too large for this box.");
+        }
     }
+    return m_image_list;
+}
 
-    vec3<float> latt_a = vec3<float>(box.getLatticeVector(0));
-    vec3<float> latt_b = vec3<float>(box.getLatticeVector(1));
+void AABBQuery::updateImages()
+{
+    m_plane_distance = m_box.getNearestPlaneDistance();
+    const vec3<bool> periodic = m_box.getPeriodic();
+
+    vec3<float> latt_a = vec3<float>(m_box.getLatticeVector(0));
+    vec3<float> latt_b = vec3<float>(m_box.getLatticeVector(1));
     vec3<float> latt_c = vec3<float>(0.0, 0.0, 0.0);
-    if (!box.is2D())
+    if (!m_box.is2D())
     {
-        latt_c = vec3<float>(box.getLatticeVector(2));
+        latt_c = vec3<float>(m_box.getLatticeVector(2));
     }
 
     // There is always at least 1 image, which we put as our first thing to look at
-    m_image_list[0] = vec3<float>(0.0, 0.0, 0.0);
+    m_image_list.assign(1, vec3<float>(0.0, 0.0, 0.0));
+    m_image_shifts.assign(1, vec3<float>(0.0, 0.0, 0.0));
 
     // Iterate over all other combinations of images
-    unsigned int n_images = 1;
-    for (int i = -1; i <= 1 && n_images < m_n_images; ++i)
+    for (int i = -1; i <= 1; ++i)
     {
-        for (int j = -1; j <= 1 && n_images < m_n_images; ++j)
+        for (int j = -1; j <= 1; ++j)
         {
-            for (int k = -1; k <= 1 && n_images < m_n_images; ++k)
+            for (int k = -1; k <= 1; ++k)
             {
                 if (!(i == 0 && j == 0 && k == 0))
                 {
                     // Skip any periodic images if we don't have periodicity
                     if ((i != 0 && !periodic.x) || (j != 0 && !periodic.y)
-                        || (k != 0 && (box.is2D() || !periodic.z)))
+                        || (k != 0 && (m_box.is2D() || !periodic.z)))
                     {
                         continue;
                     }
 
-                    m_image_list[n_images] = float(i) * latt_a + float(j) * latt_b + float(k) * latt_c;
-                    ++n_images;
+                    m_image_list.push_back(float(i) * latt_a + float(j) * latt_b + float(k) * latt_c);
+                    m_image_shifts.emplace_back(float(i), float(j), float(k));
+                }
+            }
+        }
+    }
+
+    // The points need not be wrapped into the box, so the images are
+    // selected against the range of their fractional coordinates.
+    const float inf = std::numeric_limits<float>::infinity();
+    m_fraction_lower = vec3<float>(inf, inf, inf);
+    m_fraction_upper = vec3<float>(-inf, -inf, -inf);
+    for (unsigned int i = 0; i < m_n_points; ++i)
+    {
+        const vec3<float> f = m_box.makeFractional(m_points[i]);
+        m_fraction_lower = vec3<float>(std::min(m_fraction_lower.x, f.x), std::min(m_fraction_lower.y, f.y),
+                                       std::min(m_fraction_lower.z, f.z));
+        m_fraction_upper = vec3<float>(std::max(m_fraction_upper.x, f.x), std::max(m_fraction_upper.y, f.y),
+                                       std::max(m_fraction_upper.z, f.z));
+    }
+}
+
+unsigned int AABBQuery::selectImages(const vec3<float>& query_point, float r_max, ImageList& images) const
+{
+    // The fractional coordinates within the ball of each image, padded
+    // against the rounding of the fractional coordinates.
+    const vec3<float> f = m_box.makeFractional(query_point);
+    const vec3<float> reach(r_max / m_plane_distance.x + AABB_IMAGE_MARGIN,
+                            r_max / m_plane_distance.y + AABB_IMAGE_MARGIN,
+                            r_max / m_plane_distance.z + AABB_IMAGE_MARGIN);
+    auto reaches = [](float center, float half_width, float lower, float upper) {
+        return center + half_width >= lower && center - half_width <= upper;
+    };
+
+    const bool is2D = m_box.is2D();
+    unsigned int n_images = 0;
+    for (size_t image = 0; image < m_image_list.size(); ++image)
+    {
+        const vec3<float>& shift = m_image_shifts[image];
+        if (reaches(f.x + shift.x, reach.x, m_fraction_lower.x, m_fraction_upper.x)
+            && reaches(f.y + shift.y, reach.y, m_fraction_lower.y, m_fraction_upper.y)
+            && (is2D || reaches(f.z + shift.z, reach.z, m_fraction_lower.z, m_fraction_upper.z)))
+        {
+            images[n_images++] = m_image_list[image];
+        }
+    }
+    return n_images;
+}
+
+void AABBQuery::queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end,
+                           QueryArgs args, BondSink& sink) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::nearest)
+    {
+        queryNearestBatch(query_points, nullptr, begin, end, args, sink);
+    }
+    else if (args.mode == QueryType::ball)
+    {
+        queryBallBatch(query_points, nullptr, begin, end, args, sink);
+    }
+    else
+    {
+        NeighborQuery::queryBatch(query_points, begin, end, args, sink);
+    }
+}
+
+void AABBQuery::queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                             unsigned int n, QueryArgs args, BondSink& sink) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::nearest)
+    {
+        queryNearestBatch(query_points, query_point_indices, 0, n, args, sink);
+    }
+    else if (args.mode == QueryType::ball)
+    {
+        queryBallBatch(query_points, query_point_indices, 0, n, args, sink);
+    }
+    else
+    {
+        NeighborQuery::queryIndexed(query_points, query_point_indices, n, args, sink);
+    }
+}
+
+void AABBQuery::queryBallBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                               unsigned int begin, unsigned int end, const QueryArgs& args,
+                               BondSink& sink) const
+{
+    const float r_max_sq = args.r_max * args.r_max;
+    const float r_min_sq = args.r_min * args.r_min;
+    const bool is2D = m_box.is2D();
+    getImageVectors(args.r_max);
+    ImageList images;
+    std::vector<WideStackEntry> stack(m_aabb_tree.getWideStackSize());
+    std::array<float, NODE_CAPACITY> r_sq;
+
+    for (unsigned int k = begin; k < end; ++k)
+    {
+        const unsigned int i = (query_point_indices != nullptr) ? query_point_indices[k] : k;
+        vec3<float> pos_i(query_points[i]);
+        if (is2D)
+        {
+            pos_i.z = 0;
+        }
+
+        const unsigned int n_images = selectImages(pos_i, args.r_max, images);
+        for (unsigned int image = 0; image < n_images; ++image)
+        {
+            const vec3<float> pos_i_image = pos_i + images[image];
+            forEachLeafInRange(m_aabb_tree, pos_i_image, r_max_sq, stack, [&](unsigned int node) {
+                // Unused slots of the leaf are infinitely far away, so the
+                // distances to a full leaf can always be computed.
+                const unsigned int first = m_leaf_slot[node];
+                m_leaf_points.computeDistancesSq(pos_i_image, first, first + NODE_CAPACITY, r_sq.data());
+                for (unsigned int ref_p = 0; ref_p < m_aabb_tree.getNodeNumParticles(node); ++ref_p)
+                {
+                    const unsigned int j = m_aabb_tree.getNodeParticleTag(node, ref_p);
+                    if (r_sq[ref_p] < r_max_sq && r_sq[ref_p] >= r_min_sq && !(args.exclude_ii && i == j))
+                    {
+                        sink.emitSquared(i, j, r_sq[ref_p]);
+                    }
+                }
+                return r_max_sq;
+            });
+        }
+    }
+}
+
+void AABBQuery::queryNearestBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                                  unsigned int begin, unsigned int end, const QueryArgs& args,
+                                  BondSink& sink) const
+{
+    if (args.num_neighbors == 0)
+    {
+        return;
+    }
+    const float r_min_sq = args.r_min * args.r_min;
+    const bool is2D = m_box.is2D();
+    const vec3<float> plane_distance = m_box.getNearestPlaneDistance();
+    float min_plane_distance = std::min(plane_distance.x, plane_distance.y);
+    if (!is2D)
+    {
+        min_plane_distance = std::min(min_plane_distance, plane_distance.z);
+    }
+    ImageList images;
+    std::vector<WideStackEntry> stack(m_aabb_tree.getWideStackSize());
+    std::array<float, NODE_CAPACITY> r_sq;
+    NeighborHeap heap(args.num_neighbors);
+
+    // Collect the nearest points closer than radius into the heap. Once the
+    // heap is full, the search sphere shrinks to the farthest kept point.
+    auto searchBall = [&](unsigned int i, const vec3<float>& pos_i, float radius) {
+        const float radius_sq = radius * radius;
+        heap.clear();
+        float search_r_sq = radius_sq;
+        const unsigned int n_images = selectImages(pos_i, radius, images);
+        for (unsigned int image = 0; image < n_images; ++image)
+        {
+            const vec3<float> pos_i_image = pos_i + images[image];
+            forEachLeafInRange(m_aabb_tree, pos_i_image, search_r_sq, stack, [&](unsigned int node) {
+                const unsigned int first = m_leaf_slot[node];
+                m_leaf_points.computeDistancesSq(pos_i_image, first, first + NODE_CAPACITY, r_sq.data());
+                for (unsigned int ref_p = 0; ref_p < m_aabb_tree.getNodeNumParticles(node); ++ref_p)
+                {
+                    const unsigned int j = m_aabb_tree.getNodeParticleTag(node, ref_p);
+                    if (r_sq[ref_p] < radius_sq && r_sq[ref_p] >= r_min_sq && !(args.exclude_ii && i == j))
+                    {
+                        heap.push(r_sq[ref_p], j);
+                    }
+                }
+                if (heap.full())
+                {
+                    search_r_sq = std::min(radius_sq, heap.getMaxDistanceSq());
+                }
+                return search_r_sq;
+            });
+        }
+    };
+
+    // The first search radius is estimated from the density, and later
+    // query points start from the distance of the k-th neighbor of the
+    // previous query point, which is nearby.
+    float r_guess = args.r_guess;
+    auto findNearest = [&](unsigned int i, std::vector<NeighborBond>& bonds) {
+        vec3<float> pos_i(query_points[i]);
+        if (is2D)
+        {
+            pos_i.z = 0;
+        }
+        float r_cur = r_guess;
+        while (true)
+        {
+            const float radius = std::min(r_cur, args.r_max);
+            if (2 * radius >= min_plane_distance)
+            {
+                // Several images of a point may be in range of larger balls,
+                // which AABBQueryIterator accounts for.
+                AABBQueryIterator it(this, query_points[i], i, args.num_neighbors, r_cur, args.r_max,
+                                     args.r_min, args.scale, args.exclude_ii);
+                for (NeighborBond nb = it.next(); !it.end(); nb = it.next())
+                {
+                    bonds.push_back(nb);
                 }
+                return;
+            }
+
+            // A full heap holds the nearest neighbors because every point
+            // closer than radius was searched.
+            searchBall(i, pos_i, radius);
+            if (heap.full() || radius >= args.r_max)
+            {
+                break;
             }
+            r_cur *= args.scale;
+        }
+        if (heap.full())
+        {
+            r_guess = std::sqrt(heap.getMaxDistanceSq()) * AABB_NEAREST_GUESS_MARGIN;
+        }
+        heap.appendSorted(i, bonds, sink.squared_distances);
+    };
+
+    if (query_point_indices != nullptr)
+    {
+        for (unsigned int k = begin; k < end; ++k)
+        {
+            findNearest(query_point_indices[k], sink.bonds);
         }
+        return;
+    }
+    const std::vector<unsigned int> order = spatialQueryOrder(m_box, query_points, begin, end, r_guess);
+    queryInOrder(order, begin, end, sink, findNearest);
+}
+
+void AABBIterator::updateImageVectors(float r_max, bool _check_r_max)
+{
+    m_aabb_query->getImageVectors(r_max, _check_r_max);
+    vec3<float> pos_i(m_query_point);
+    if (m_neighbor_query->getBox().is2D())
+    {
+        pos_i.z = 0;
     }
+    m_n_images = m_aabb_query->selectImages(pos_i, r_max, m_image_list);
 }
 
 NeighborBond AABBQueryBallIterator::next()
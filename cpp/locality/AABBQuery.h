@@ -4,6 +4,7 @@
 #ifndef AABBQUERY_H
 #define AABBQUERY_H
 
+#include <array>
 #include <cmath>
 #include <map>
 #include <memory>
@@ -13,16 +14,19 @@
 #include "AABBTree.h"
 #include "Box.h"
 #include "NeighborQuery.h"
+#include "SoAPoints.h"
 
 /*! \file AABBQuery.h
  *  \brief Build an AABB tree from points and query it for neighbors.
  * A bounding volume hierarchy (BVH) tree is a binary search tree. It is
  * constructed from axis-aligned bounding boxes (AABBs). The AABB for a node in
  * the tree encloses all child AABBs. A leaf AABB holds multiple particles. The
- * tree is constructed in a balanced way using a heuristic to minimize AABB
- * volume. We build one tree per particle type, and use point AABBs for the
+ * tree is constructed in parallel as a linear BVH from the Morton codes of the
+ * points, and can be refit when the points move. We use point AABBs for the
  * particles. The neighbor list is built by traversing down the tree with an
- * AABB that encloses the pairwise cutoff for the particle. Periodic boundaries
+ * AABB that encloses the pairwise cutoff for the particle. Batched queries
+ * traverse a wide form of the tree with quantized nodes of eight children,
+ * which are tested against the query together. Periodic boundaries
  * are treated by translating the query AABB by all possible image vectors,
  * many of which are trivially rejected for not intersecting the root node.
  */
@@ -49,6 +53,71 @@ public:
     std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
 
+    //! Implementation of batched queries for AABBQuery (see NeighborQuery.h for documentation).
+    /*! Ball queries traverse the tree directly without constructing per-point
+     *  iterators, and the periodic image vectors are computed once per batch.
+     *  The distances to all points of a leaf are computed at once from the
+     *  structure-of-arrays copy of the points. Nearest neighbor queries keep
+     *  the nearest candidates of each query point in a bounded heap, shrinking
+     *  the search sphere as the heap fills, and process the query points in
+     *  spatial order so that each query can start from the distance of the
+     *  k-th neighbor of the previous one. Queries that must search beyond half
+     *  of the box fall back to AABBQueryIterator.
+     */
+    void queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end, QueryArgs args,
+                    BondSink& sink) const override;
+
+    //! Implementation of indexed queries for AABBQuery (see NeighborQuery.h for documentation).
+    /*! The query points are searched like in queryBatch, but in the order of
+     *  the list.
+     */
+    void queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                      unsigned int n, QueryArgs args, BondSink& sink) const override;
+
+    //! Maximum number of periodic images searched for a query point
+    static constexpr unsigned int MAX_IMAGES = 27;
+
+    //! The periodic images searched for a query point, see selectImages
+    using ImageList = std::array<vec3<float>, MAX_IMAGES>;
+
+    //! Get the periodic image vectors of the box.
+    /*! The image vectors are computed once for each box, with the primary
+     *  image first.
+     *
+     *  \param r_max The cutoff distance of the query.
+     *  \param check_r_max If true, throw if r_max is too large for the box.
+     */
+    const std::vector<vec3<float>>& getImageVectors(float r_max, bool check_r_max = true) const;
+
+    //! Select the periodic images that must be searched for a query point.
+    /*! The ball of an image of the query point can only contain points if it
+     *  reaches the range of the fractional coordinates of the points along
+     *  every axis, which within the ball of radius r_max vary by r_max divided
+     *  by the distance between the planes of the box. Query points farther
+     *  than r_max from the faces of the box therefore only search the primary
+     *  image.
+     *
+     *  \param query_point The query point.
+     *  \param r_max The radius of the ball searched around each image.
+     *  \param images Receives the selected image vectors, primary image first.
+     *  \returns The number of selected images.
+     */
+    unsigned int selectImages(const vec3<float>& query_point, float r_max, ImageList& images) const;
+
+    //! Update the tree for new point positions.
+    /*! The tree is refit to the new positions, keeping its topology, which is
+     *  much cheaper than building a new tree when points move little between
+     *  frames. Refitting keeps the tree valid for any motion, but leaves whose
+     *  points spread apart grow, so the tree is rebuilt once the leaves have
+     *  grown too much. The tree is also rebuilt if the number of points or the
+     *  dimensionality of the box changes.
+     *
+     *  \param box The box containing the new points.
+     *  \param points The new point coordinates.
+     *  \param n_points The number of points.
+     */
+    void update(const box::Box& box, const vec3<float>* points, unsigned int n_points);
+
     AABBTree m_aabb_tree; //!< AABB tree of points
 
 protected:
@@ -110,7 +179,41 @@ private:
     //! Driver to build AABB trees
     void buildTree(const vec3<float>* points, unsigned int N);
 
-    std::vector<AABB> m_aabbs; //!< Flat array of AABBs of all types
+    //! Copy the points of every leaf into a block of the leaf-ordered point arrays
+    void gatherLeafPoints(const vec3<float>* points);
+
+    //! Compute the image vectors of the box and the range of the fractional coordinates of the points
+    void updateImages();
+
+    //! Find the neighbors within a ball of a range of query points (see queryBatch)
+    /*! \param query_points The points to find neighbors for.
+     *  \param query_point_indices The indices of the query points to process,
+     *                             or nullptr to process the query points in
+     *                             order of index.
+     *  \param begin The first position to process.
+     *  \param end One past the last position to process.
+     *  \param args The validated query arguments.
+     *  \param sink The destination for the bonds that are found.
+     */
+    void queryBallBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                        unsigned int begin, unsigned int end, const QueryArgs& args, BondSink& sink) const;
+
+    //! Find the nearest neighbors of a range of query points (see queryBallBatch)
+    void queryNearestBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                           unsigned int begin, unsigned int end, const QueryArgs& args, BondSink& sink) const;
+
+    //! Fill the point AABBs from the point positions
+    void computeAABBs(const vec3<float>* points, unsigned int N);
+
+    std::vector<AABB> m_aabbs;               //!< Flat array of AABBs of all types
+    std::vector<unsigned int> m_leaf_slot;   //!< Offset of the points of each leaf node in m_leaf_points
+    SoAPoints m_leaf_points;                 //!< Point positions in leaf order, NODE_CAPACITY slots per leaf
+    float m_built_leaf_extent {0};           //!< Sum of the leaf extents when the tree was last built
+    std::vector<vec3<float>> m_image_list;   //!< Image vectors of the box, primary image first
+    std::vector<vec3<float>> m_image_shifts; //!< Lattice coefficients of each image vector
+    vec3<float> m_plane_distance;            //!< Distances between the opposite planes of the box
+    vec3<float> m_fraction_lower;            //!< Lower bounds of the fractional coordinates of the points
+    vec3<float> m_fraction_upper;            //!< Upper bounds of the fractional coordinates of the points
 };
 
 //! Parent class of AABB iterators that knows how to traverse general AABB tree structures.
@@ -128,13 +231,13 @@ public:
     //! Empty Destructor
     ~AABBIterator() override = default;
 
-    //! Computes the image vectors to query for
+    //! Selects the image vectors to query for
     void updateImageVectors(float r_max, bool _check_r_max = true);
 
 protected:
-    const AABBQuery* m_aabb_query;         //!< Link to the AABBQuery object
-    std::vector<vec3<float>> m_image_list; //!< List of translation vectors
-    unsigned int m_n_images {0};           //!< The number of image vectors to check
+    const AABBQuery* m_aabb_query;     //!< Link to the AABBQuery object
+    AABBQuery::ImageList m_image_list; //!< List of translation vectors
+    unsigned int m_n_images {0};       //!< The number of image vectors to check
 };
 
 //! Iterator that gets a specified number of nearest neighbors from AABB tree structures.
@@ -148,9 +251,7 @@ public:
         : AABBIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii), m_count(0),
           m_num_neighbors(num_neighbors), m_search_extended(false), m_r_cur(r_guess), m_scale(scale),
           m_all_distances(), m_query_points_below_r_min()
-    {
-        updateImageVectors(0);
-    }
+    {}
 
     //! Empty Destructor
     ~AABBQueryIterator() override = default;
@@ -0,0 +1,53 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <array>
+
+#include "AABBTree.h"
+
+/*! \file AABBTree.cc
+    \brief Vectorized tests of the children of wide AABB tree nodes.
+*/
+
+namespace freud { namespace locality {
+
+FREUD_SIMD_CLONES
+unsigned int overlapMask(const AABBWideNode& node, const vec3<float>& point, float r_sq, float* d_sq)
+{
+    // The bounds are widened to floats in a separate loop, and the inputs and
+    // outputs are copied to local variables that cannot alias, so that both
+    // loops are vectorized over all children.
+    std::array<float, 6 * AABB_WIDE_NODE_WIDTH> bounds;
+    for (unsigned int k = 0; k < 6 * AABB_WIDE_NODE_WIDTH; ++k)
+    {
+        bounds[k] = static_cast<float>(node.bounds[k]);
+    }
+    const vec3<float> origin = node.origin;
+    const vec3<float> scale = node.scale;
+    const vec3<float> p = point;
+    std::array<float, AABB_WIDE_NODE_WIDTH> dist_sq;
+    for (unsigned int c = 0; c < AABB_WIDE_NODE_WIDTH; ++c)
+    {
+        const float lower_x = origin.x + bounds[c] * scale.x;
+        const float lower_y = origin.y + bounds[AABB_WIDE_NODE_WIDTH + c] * scale.y;
+        const float lower_z = origin.z + bounds[2 * AABB_WIDE_NODE_WIDTH + c] * scale.z;
+        const float upper_x = origin.x + bounds[3 * AABB_WIDE_NODE_WIDTH + c] * scale.x;
+        const float upper_y = origin.y + bounds[4 * AABB_WIDE_NODE_WIDTH + c] * scale.y;
+        const float upper_z = origin.z + bounds[5 * AABB_WIDE_NODE_WIDTH + c] * scale.z;
+        const float dx = std::max(lower_x - p.x, float(0)) + std::max(p.x - upper_x, float(0));
+        const float dy = std::max(lower_y - p.y, float(0)) + std::max(p.y - upper_y, float(0));
+        const float dz = std::max(lower_z - p.z, float(0)) + std::max(p.z - upper_z, float(0));
+        dist_sq[c] = dx * dx + dy * dy + dz * dz;
+    }
+
+    unsigned int mask = 0;
+    for (unsigned int c = 0; c < AABB_WIDE_NODE_WIDTH; ++c)
+    {
+        mask |= static_cast<unsigned int>(dist_sq[c] <= r_sq) << c;
+        d_sq[c] = dist_sq[c];
+    }
+    return mask & ((1U << node.num_children) - 1);
+}
+
+}; }; // end namespace freud::locality
@@ -4,14 +4,24 @@
 #ifndef AABB_TREE_H
 #define AABB_TREE_H
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <stack>
 #include <stdexcept>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+#include <utility>
 #include <vector>
 
 #include "AABB.h"
+#include "MortonOrder.h"
 #include "VectorMath.h"
+#include "utils.h"
 
 /*! \file AABBTree.h
     \brief AABBTree build and query methods
@@ -30,6 +40,10 @@ namespace freud { namespace locality {
 
 constexpr unsigned int NODE_CAPACITY = 16;        //!< Maximum number of particles in a node
 constexpr unsigned int INVALID_NODE = 0xffffffff; //!< Invalid node index sentinel
+constexpr unsigned int AABB_TREE_PARALLEL_BUILD_SIZE
+    = 4096; //!< Number of particles above which the two subtrees of a node are built in parallel
+constexpr unsigned int AABB_WIDE_NODE_WIDTH = 8;  //!< Maximum number of children of a wide node
+constexpr unsigned int AABB_WIDE_LEAF = 0x80000000; //!< Flag marking the leaf children of wide nodes
 
 //! Node in an AABBTree
 /*! Stores data for a node in the AABB tree
@@ -56,6 +70,37 @@ struct CACHE_ALIGN AABBNode
     unsigned int num_particles; //!< Number of particles contained in the node
 };
 
+//! Node in the wide form of an AABBTree
+/*! A wide node holds up to AABB_WIDE_NODE_WIDTH children, each of which is either another wide node or a leaf
+   node of the binary tree. The bounds of the children are stored as separate arrays of 8 bit integers on a
+   grid whose origin is the lower corner of the node. The grid spacing along each axis is a power of two, so
+   that the bounds are recovered exactly, with or without fused multiply-adds, and the quantized bounds
+   always enclose those of the children. All children of a node can therefore be tested against a query by a
+   single vectorized loop in overlapMask.
+ */
+struct AABBWideNode
+{
+    vec3<float> origin; //!< Lower corner of the node
+    vec3<float> scale;  //!< Grid spacing of the child bounds along each axis
+
+    //! Quantized bounds of the children, as arrays of lower x, y, and z bounds followed by upper x, y, and z
+    //! bounds
+    std::array<uint8_t, 6 * AABB_WIDE_NODE_WIDTH> bounds;
+
+    //! Index of each wide child node, or index of each leaf node combined with AABB_WIDE_LEAF
+    std::array<unsigned int, AABB_WIDE_NODE_WIDTH> children;
+    unsigned int num_children; //!< Number of children
+};
+
+//! Find the children of a wide node that overlap a sphere
+/*! \param node The wide node.
+    \param point The center of the sphere.
+    \param r_sq The squared radius of the sphere.
+    \param d_sq Output array of AABB_WIDE_NODE_WIDTH squared distances from the point to the children.
+    \returns A mask with bit i set if child i is no farther than the radius from the point.
+*/
+unsigned int overlapMask(const AABBWideNode& node, const vec3<float>& point, float r_sq, float* d_sq);
+
 //! AABB Tree
 /*! An AABBTree stores a binary tree of AABBs. A leaf node stores up to NODE_CAPACITY particles by index. The
    bounding box of a leaf node surrounds all the bounding boxes of its contained particles. Internal nodes
@@ -67,15 +112,27 @@ struct CACHE_ALIGN AABBNode
    tree topology is left unchanged. Runs in O(log N) time. AABBs are not saved for all particles, so an update
    will only increase the volume of nodes. The tree should be rebuilt periodically instead of continually
    updated.
+    - Refit : Recompute the AABBs of all nodes for a new set of particle AABBs, keeping the tree topology.
+   Unlike update, the node AABBs may shrink, so the tree remains tight as long as the particles of each leaf
+   stay close together.
     - buildTree : build an efficiently arranged tree given a complete set of AABBs, one for each particle.
 
     **Implementation details**
 
-    AABBTree stores all nodes in a flat array managed by std::vector. To easily locate particle leaf nodes for
-   update, a reverse mapping is stored to locate the leaf node containing a particle. m_root tracks the index
-   of the root node as the tree is built. The nodes store the indices of their left and right children along
-   with their AABB. Nodes are allocated as needed with allocate(). With multiple particles per leaf node, the
-   total number of internal nodes needed is not known (but can be estimated) until build time.
+    AABBTree stores all nodes in a flat array. To easily locate particle leaf nodes for update, a reverse
+   mapping is stored to locate the leaf node containing a particle. m_root tracks the index of the root node.
+   The nodes store the indices of their left and right children along with their AABB.
+
+    The tree is built as a linear bounding volume hierarchy (LBVH): the particles are sorted by the Morton
+   codes of their positions, and each node splits its range of sorted particles where the highest bit that
+   differs within the range changes. The leaves are found in a first pass over this hierarchy. A subtree
+   with L leaves has 2L - 1 nodes, so the position of every node in the depth-first layout follows from the
+   leaves it contains, and the nodes are then emitted with the subtrees built in parallel.
+
+    After each build or refit, the binary tree is also collapsed into a tree of wide nodes, each of which
+   takes the place of up to three levels of the binary tree. Batched queries traverse the wide tree with a
+   stack of bounded size, testing all children of a node at once, while the per-point iterators, which must
+   be able to resume their traversal, use the skips of the binary tree.
 
     For performance, no recursive calls are used. Instead, each function is either turned into a loop if it
    uses tail recursion, or it uses a local stack to traverse the tree. The stack is cached between calls to
@@ -99,7 +156,8 @@ public:
     //! Copy constructor
     AABBTree(const AABBTree& from)
         : m_num_nodes(from.m_num_nodes), m_node_capacity(from.m_node_capacity), m_root(from.m_root),
-          m_mapping(from.m_mapping)
+          m_mapping(from.m_mapping), m_wide_nodes(from.m_wide_nodes),
+          m_wide_stack_size(from.m_wide_stack_size)
     {
         if (from.m_nodes != nullptr)
         {
@@ -131,6 +189,8 @@ public:
         m_node_capacity = from.m_node_capacity;
         m_root = from.m_root;
         m_mapping = from.m_mapping;
+        m_wide_nodes = from.m_wide_nodes;
+        m_wide_stack_size = from.m_wide_stack_size;
 
         if (m_nodes != nullptr)
         {
@@ -164,6 +224,9 @@ public:
     //! Update the AABB of a particle
     inline void update(unsigned int idx, const AABB& aabb);
 
+    //! Recompute the AABBs of all nodes, keeping the tree topology
+    inline void refit(const AABB* aabbs);
+
     //! Get the height of a given particle's leaf node
     inline unsigned int height(unsigned int idx);
 
@@ -238,25 +301,65 @@ public:
         return (m_nodes[node].particle_tags[j]);
     }
 
+    //! Get the number of wide nodes
+    inline unsigned int getNumWideNodes() const
+    {
+        return static_cast<unsigned int>(m_wide_nodes.size());
+    }
+
+    //! Get a wide node
+    /*! \param node Index of the wide node. The root is node 0.
+     */
+    inline const AABBWideNode& getWideNode(unsigned int node) const
+    {
+        return m_wide_nodes[node];
+    }
+
+    //! Get the number of stack entries that suffice for a depth-first traversal of the wide nodes
+    inline unsigned int getWideStackSize() const
+    {
+        return m_wide_stack_size;
+    }
+
 private:
     AABBNode* m_nodes {nullptr};         //!< The nodes of the tree
     unsigned int m_num_nodes {0};        //!< Number of nodes
     unsigned int m_node_capacity {0};    //!< Capacity of the nodes array
     unsigned int m_root {0};             //!< Index to the root node of the tree
     std::vector<unsigned int> m_mapping; //!< Reverse mapping to find node given a particle index
+    std::vector<AABBWideNode> m_wide_nodes; //!< The nodes of the wide form of the tree
+    unsigned int m_wide_stack_size {0};     //!< Stack size needed to traverse the wide nodes
 
     //! Initialize the tree to hold N particles
     inline void init(unsigned int N);
 
-    //! Build a node of the tree recursively
-    inline unsigned int buildNode(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
-                                  unsigned int len, unsigned int parent);
+    //! Find the number of particles in the left subtree of a range of sorted particles
+    static inline unsigned int findSplit(const std::vector<uint64_t>& codes, unsigned int start,
+                                         unsigned int len);
+
+    //! Mark the first particle of every leaf in a range of sorted particles
+    static inline void markLeaves(const std::vector<uint64_t>& codes, unsigned int start, unsigned int len,
+                                  std::vector<char>& leaf_start);
+
+    //! Build the subtree of a range of leaves
+    inline void buildNode(const AABB* aabbs, const std::vector<uint64_t>& codes,
+                          const std::vector<unsigned int>& order,
+                          const std::vector<unsigned int>& leaf_starts, unsigned int first_leaf,
+                          unsigned int num_leaves, unsigned int node, unsigned int parent);
+
+    //! Allocate memory for a number of nodes
+    inline void allocateNodes(unsigned int num_nodes);
 
-    //! Allocate a new node
-    inline unsigned int allocateNode();
+    //! Collapse the binary tree into wide nodes
+    inline void buildWideNodes();
 
-    //! Update the skip value for a node
-    inline unsigned int updateSkip(unsigned int idx);
+    //! Build the wide node of the subtree of a node of the binary tree
+    inline unsigned int buildWideNode(unsigned int node, unsigned int& height);
+
+    //! Quantize the bounds of the children of a wide node
+    inline void quantizeWideNode(AABBWideNode& wide_node,
+                                 const std::array<unsigned int, AABB_WIDE_NODE_WIDTH>& children,
+                                 unsigned int num_children) const;
 };
 
 /*! \param N Number of particles to allocate space for
@@ -376,244 +479,430 @@ inline unsigned int AABBTree::height(unsigned int idx)
     return height;
 }
 
+/*! \param aabbs List of AABBs for each particle
+
+    Refitting recomputes the AABB of every leaf from the AABBs of its particles, and then the AABBs of the
+   internal nodes from those of their children. Since children follow their parent in the depth-first layout,
+   the internal nodes are processed in reverse order.
+*/
+inline void AABBTree::refit(const AABB* aabbs)
+{
+    util::forLoopWrapper(0, m_num_nodes, [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; ++node)
+        {
+            AABBNode& leaf = m_nodes[node];
+            if (leaf.left != INVALID_NODE)
+            {
+                continue;
+            }
+            AABB leaf_aabb = aabbs[leaf.particles[0]];
+            for (unsigned int i = 1; i < leaf.num_particles; ++i)
+            {
+                leaf_aabb = merge(leaf_aabb, aabbs[leaf.particles[i]]);
+            }
+            leaf.aabb = leaf_aabb;
+        }
+    });
+
+    for (unsigned int node = m_num_nodes; node-- > 0;)
+    {
+        if (!isNodeLeaf(node))
+        {
+            m_nodes[node].aabb = merge(m_nodes[m_nodes[node].left].aabb, m_nodes[m_nodes[node].right].aabb);
+        }
+    }
+    buildWideNodes();
+}
+
 /*! \param aabbs List of AABBs for each particle (must be 32-byte aligned)
     \param N Number of AABBs in the list
 
-    Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs will be modified
-   during the construction process.
+    Builds a tree from a given list of AABBs for each particle. The Morton codes of the particle positions
+   are computed relative to the bounds of all positions and sorted in parallel, after which the nodes are
+   emitted by buildNode.
 */
 inline void AABBTree::buildTree(AABB* aabbs, unsigned int N)
 {
     init(N);
+    if (N == 0)
+    {
+        m_num_nodes = 0;
+        buildWideNodes();
+        return;
+    }
 
-    std::vector<unsigned int> idx;
-    for (unsigned int i = 0; i < N; i++)
+    const AABB bounds = tbb::parallel_reduce(
+        tbb::blocked_range<unsigned int>(0, N), aabbs[0],
+        [&](const tbb::blocked_range<unsigned int>& r, AABB partial) {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+                partial = merge(partial, aabbs[i]);
+            }
+            return partial;
+        },
+        [](const AABB& left, const AABB& right) { return merge(left, right); });
+
+    // Quantize the positions to the bits of the Morton codes. Flat dimensions
+    // are mapped to zero.
+    constexpr auto num_bins = static_cast<float>(uint64_t(1) << MORTON_BITS);
+    constexpr uint64_t max_bin = (uint64_t(1) << MORTON_BITS) - 1;
+    const vec3<float> lower = bounds.getLower();
+    const vec3<float> extent = bounds.getUpper() - lower;
+    auto scale = [&](float length) { return (length > 0) ? num_bins / length : float(0); };
+    const vec3<float> bin_scale(scale(extent.x), scale(extent.y), scale(extent.z));
+    auto bin = [&](float x) { return std::min(static_cast<uint64_t>(std::max(x, float(0))), max_bin); };
+
+    std::vector<std::pair<uint64_t, unsigned int>> keys(N);
+    util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<float> x = aabbs[i].getPosition() - lower;
+            const uint64_t code = detail::spreadBits(bin(x.x * bin_scale.x))
+                | (detail::spreadBits(bin(x.y * bin_scale.y)) << 1)
+                | (detail::spreadBits(bin(x.z * bin_scale.z)) << 2);
+            keys[i] = {code, static_cast<unsigned int>(i)};
+        }
+    });
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    std::vector<uint64_t> codes(N);
+    std::vector<unsigned int> order(N);
+    util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            codes[i] = keys[i].first;
+            order[i] = keys[i].second;
+        }
+    });
+
+    std::vector<char> leaf_start(N, 0);
+    markLeaves(codes, 0, N, leaf_start);
+    std::vector<unsigned int> leaf_starts;
+    for (unsigned int i = 0; i < N; ++i)
     {
-        idx.push_back(i);
+        if (leaf_start[i] != 0)
+        {
+            leaf_starts.push_back(i);
+        }
     }
+    const auto num_leaves = static_cast<unsigned int>(leaf_starts.size());
+    leaf_starts.push_back(N);
 
-    m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
-    updateSkip(m_root);
+    allocateNodes(2 * num_leaves - 1);
+    m_root = 0;
+    buildNode(aabbs, codes, order, leaf_starts, 0, num_leaves, m_root, INVALID_NODE);
+    buildWideNodes();
 }
 
-/*! \param aabbs List of AABBs
-    \param idx List of indices
-    \param start Start point in aabbs and idx to examine
-    \param len Number of aabbs to examine
-    \param parent Index of the parent node
-
-    buildNode is the main driver of the smart AABB tree build algorithm. Each call produces a node, given a
-   set of AABBs. If there are fewer AABBs than fit in a leaf, a leaf is generated. If there are too many, the
-   total AABB is computed and split on the largest length axis. The total tree is built by recursive
-   splitting.
+/*! \param codes Sorted Morton codes of the particles
+    \param start Start of the range of sorted particles
+    \param len Number of particles in the range, which must be at least 2
+    \returns The number of particles in the left subtree, which is positive and smaller than len.
 
-    The aabbs and idx lists are passed in by reference. Each node is given a subrange of the list to own
-   (start to start + len). When building the node, it partitions its subrange into two sides (like quick
-   sort).
+    The codes of the range share all bits above the highest bit in which the first and last code differ, so
+   the range is split where that bit changes. Ranges of identical codes are split in half.
 */
-inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
-                                        unsigned int len, unsigned int parent)
+inline unsigned int AABBTree::findSplit(const std::vector<uint64_t>& codes, unsigned int start,
+                                        unsigned int len)
 {
-    // merge all the AABBs into one
-    AABB my_aabb = aabbs[start];
-    for (unsigned int i = 1; i < len; i++)
+    const uint64_t diff = codes[start] ^ codes[start + len - 1];
+    unsigned int split = len / 2;
+    if (diff != 0)
     {
-        my_aabb = merge(my_aabb, aabbs[start + i]);
+        uint64_t mask = uint64_t(1) << 63;
+        while ((diff & mask) == 0)
+        {
+            mask >>= 1;
+        }
+        const auto first = codes.begin() + start;
+        split = static_cast<unsigned int>(
+            std::partition_point(first, first + len, [=](uint64_t code) { return (code & mask) == 0; })
+            - first);
     }
-    vec3<float> my_radius = my_aabb.getUpper() - my_aabb.getLower();
+    return split;
+}
 
-    // handle the case of a leaf node creation
+/*! \param codes Sorted Morton codes of the particles
+    \param start Start of the range of sorted particles
+    \param len Number of particles in the range
+    \param leaf_start Flags that are set for the first particle of each leaf
+
+    The range is split by findSplit until it fits in a leaf.
+*/
+inline void AABBTree::markLeaves(const std::vector<uint64_t>& codes, unsigned int start, unsigned int len,
+                                 std::vector<char>& leaf_start)
+{
     if (len <= NODE_CAPACITY)
     {
-        unsigned int new_node = allocateNode();
-        m_nodes[new_node].aabb = my_aabb;
-        m_nodes[new_node].parent = parent;
-        m_nodes[new_node].num_particles = len;
+        leaf_start[start] = 1;
+        return;
+    }
+    const unsigned int split = findSplit(codes, start, len);
+    auto markLeft = [&]() { markLeaves(codes, start, split, leaf_start); };
+    auto markRight = [&]() { markLeaves(codes, start + split, len - split, leaf_start); };
+    if (len > AABB_TREE_PARALLEL_BUILD_SIZE)
+    {
+        tbb::parallel_invoke(markLeft, markRight);
+    }
+    else
+    {
+        markLeft();
+        markRight();
+    }
+}
+
+/*! \param aabbs List of AABBs
+    \param codes Sorted Morton codes of the particles
+    \param order Indices of the particles in Morton order
+    \param leaf_starts Index of the first sorted particle of each leaf, followed by the number of particles
+    \param first_leaf First leaf of the range
+    \param num_leaves Number of leaves in the range
+    \param node Index of the node to build
+    \param parent Index of the parent node
+
+    buildNode is the main driver of the tree build algorithm. Each call produces a node for a range of
+   leaves. A single leaf is filled with its particles. Otherwise the particles of the range are split by
+   findSplit, which splits them between two leaves just as in markLeaves, and the left and right subtrees
+   are stored directly after the node, so the skip of the node is the size of its subtree less one. Large
+   subtrees are built in parallel.
+*/
+inline void AABBTree::buildNode(const AABB* aabbs, const std::vector<uint64_t>& codes,
+                                const std::vector<unsigned int>& order,
+                                const std::vector<unsigned int>& leaf_starts, unsigned int first_leaf,
+                                unsigned int num_leaves, unsigned int node, unsigned int parent)
+{
+    AABBNode& current_node = m_nodes[node];
+    current_node = AABBNode();
+    current_node.parent = parent;
+    const unsigned int start = leaf_starts[first_leaf];
+    const unsigned int len = leaf_starts[first_leaf + num_leaves] - start;
 
+    // handle the case of a leaf node creation
+    if (num_leaves == 1)
+    {
+        AABB leaf_aabb = aabbs[order[start]];
         for (unsigned int i = 0; i < len; i++)
         {
             // assign the particle indices into the leaf node
-            m_nodes[new_node].particles[i] = idx[start + i];
-            m_nodes[new_node].particle_tags[i] = aabbs[start + i].tag;
+            const unsigned int idx = order[start + i];
+            leaf_aabb = merge(leaf_aabb, aabbs[idx]);
+            current_node.particles[i] = idx;
+            current_node.particle_tags[i] = aabbs[idx].tag;
 
             // assign the reverse mapping from particle indices to leaf node indices
-            m_mapping[idx[start + i]] = new_node;
+            m_mapping[idx] = node;
         }
+        current_node.aabb = leaf_aabb;
+        current_node.num_particles = len;
+        return;
+    }
 
-        return new_node;
+    const unsigned int split = findSplit(codes, start, len);
+    const auto first = leaf_starts.begin() + first_leaf;
+    const auto num_left_leaves
+        = static_cast<unsigned int>(std::lower_bound(first, first + num_leaves, start + split) - first);
+    const unsigned int left = node + 1;
+    const unsigned int right = left + 2 * num_left_leaves - 1;
+    auto buildLeft = [&]() {
+        buildNode(aabbs, codes, order, leaf_starts, first_leaf, num_left_leaves, left, node);
+    };
+    auto buildRight = [&]() {
+        buildNode(aabbs, codes, order, leaf_starts, first_leaf + num_left_leaves,
+                  num_leaves - num_left_leaves, right, node);
+    };
+    if (len > AABB_TREE_PARALLEL_BUILD_SIZE)
+    {
+        tbb::parallel_invoke(buildLeft, buildRight);
+    }
+    else
+    {
+        buildLeft();
+        buildRight();
     }
 
-    // otherwise, we are creating an internal node - allocate an index
-    unsigned int my_idx = allocateNode();
+    current_node.aabb = merge(m_nodes[left].aabb, m_nodes[right].aabb);
+    current_node.left = left;
+    current_node.right = right;
+    current_node.skip = 2 * num_leaves - 2;
+}
 
-    // need to split the list of aabbs into two sets for left and right
-    unsigned int start_left = 0;
-    unsigned int start_right = len;
+/*! \param num_nodes Number of nodes of the tree
 
-    // if there are only 2 aabbs, put one on each side
-    // cppcheck knows that NODE_CAPACITY is defined as 16, so it sees this
-    // check as redundant. However, if we ever defined NODE_CAPACITY to be 1
-    // then this check would be meaningful, so it's safer to leave it.
-    // cppcheck-suppress knownConditionTrueFalse
-    if (len != 2)
+    Allocates memory for num_nodes nodes, reusing the current allocation if it is large enough.
+ */
+inline void AABBTree::allocateNodes(unsigned int num_nodes)
+{
+    if (num_nodes > m_node_capacity)
     {
-        // otherwise, we need to split them based on a heuristic. split the longest dimension in half
-        if (my_radius.x > my_radius.y && my_radius.x > my_radius.z)
-        {
-            // split on x direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().x < my_aabb.getPosition().x)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
-        }
-        else if (my_radius.y > my_radius.z)
+        AABBNode* new_nodes = nullptr;
+        // cppcheck-suppress AssignmentAddressToInteger
+        int retval = posix_memalign((void**) &new_nodes, 32, num_nodes * sizeof(AABBNode));
+        if (retval != 0)
         {
-            // split on y direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().y < my_aabb.getPosition().y)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
+            throw std::runtime_error("Error allocating AABBTree memory");
         }
-        else
+        if (m_nodes != nullptr)
         {
-            // split on z direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().z < my_aabb.getPosition().z)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
+            posix_memalign_free(m_nodes);
         }
+        m_nodes = new_nodes;
+        m_node_capacity = num_nodes;
     }
+    m_num_nodes = num_nodes;
+}
 
-    // sanity check. The left or right tree may have ended up empty. If so, just borrow one particle from it
-    if (start_right == len)
-    {
-        start_right = len - 1;
-    }
-    if (start_right == 0)
+/*! The stack of a depth-first traversal holds fewer than AABB_WIDE_NODE_WIDTH entries for each level of
+   the wide tree, so its size is bounded by the height of the tree.
+ */
+inline void AABBTree::buildWideNodes()
+{
+    m_wide_nodes.clear();
+    m_wide_stack_size = 0;
+    if (m_num_nodes == 0)
     {
-        start_right = 1;
+        return;
     }
-
-    // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine
-    // the left and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
-    unsigned int new_left = buildNode(aabbs, idx, start + start_left, start_right - start_left, my_idx);
-    unsigned int new_right = buildNode(aabbs, idx, start + start_right, len - start_right, my_idx);
-
-    // now, create the children and connect them up
-    m_nodes[my_idx].aabb = my_aabb;
-    m_nodes[my_idx].parent = parent;
-    m_nodes[my_idx].left = new_left;
-    m_nodes[my_idx].right = new_right;
-
-    return my_idx;
+    unsigned int height = 0;
+    buildWideNode(m_root, height);
+    m_wide_stack_size = AABB_WIDE_NODE_WIDTH * height + 1;
 }
 
-/*! \param idx Index of the node to update
+/*! \param node Index of the node of the binary tree
+    \param height Output height of the wide subtree
+    \returns The index of the wide node
 
-    updateSkip() updates the skip field of every node in the tree. The skip field is used in the stackless
-    implementation of query. Each node's skip field lists the number of nodes that are children to this node.
-   Because of the order in which nodes are built in buildNode(), this number is the number of elements to skip
-   in a search if a box-box test does not overlap.
+    The children of a wide node are found by repeatedly replacing the internal node with the largest AABB
+   among them by its two children, in place, so that the leaves remain in the order of the binary tree.
+   Wide nodes are stored in depth-first order starting from the root.
 */
-inline unsigned int AABBTree::updateSkip(unsigned int idx)
+inline unsigned int AABBTree::buildWideNode(unsigned int node, unsigned int& height)
 {
-    // leaf nodes have no nodes under them
-    if (isNodeLeaf(idx))
+    auto size = [&](unsigned int child) {
+        const AABB& aabb = m_nodes[child].aabb;
+        const vec3<float> extent = aabb.getUpper() - aabb.getLower();
+        return extent.x + extent.y + extent.z;
+    };
+
+    std::array<unsigned int, AABB_WIDE_NODE_WIDTH> children {};
+    unsigned int num_children = 1;
+    children[0] = node;
+    while (num_children < AABB_WIDE_NODE_WIDTH)
     {
-        return 1;
+        unsigned int expand = INVALID_NODE;
+        for (unsigned int c = 0; c < num_children; ++c)
+        {
+            if (!isNodeLeaf(children[c])
+                && (expand == INVALID_NODE || size(children[c]) > size(children[expand])))
+            {
+                expand = c;
+            }
+        }
+        if (expand == INVALID_NODE)
+        {
+            break;
+        }
+        std::copy_backward(children.begin() + expand + 1, children.begin() + num_children,
+                           children.begin() + num_children + 1);
+        const unsigned int expanded = children[expand];
+        children[expand] = m_nodes[expanded].left;
+        children[expand + 1] = m_nodes[expanded].right;
+        ++num_children;
     }
-    // node idx needs to skip all the nodes underneath it (determined recursively)
-    unsigned int left_idx = m_nodes[idx].left;
-    unsigned int right_idx = m_nodes[idx].right;
 
-    unsigned int skip = updateSkip(left_idx) + updateSkip(right_idx);
-    m_nodes[idx].skip = skip;
-    return skip + 1;
-}
+    const auto wide_node = static_cast<unsigned int>(m_wide_nodes.size());
+    m_wide_nodes.emplace_back();
+    quantizeWideNode(m_wide_nodes[wide_node], children, num_children);
 
-/*! Allocates a new node in the tree and return its index.
- */
-inline unsigned int AABBTree::allocateNode()
-{
-    // grow the memory if needed
-    if (m_num_nodes >= m_node_capacity)
+    unsigned int child_height = 0;
+    for (unsigned int c = 0; c < num_children; ++c)
     {
-        // determine new capacity
-        AABBNode* m_new_nodes = nullptr;
-        unsigned int m_new_node_capacity = m_node_capacity * 2;
-        if (m_new_node_capacity == 0)
+        unsigned int child = AABB_WIDE_LEAF | children[c];
+        if (!isNodeLeaf(children[c]))
         {
-            m_new_node_capacity = 16;
+            unsigned int subtree_height = 0;
+            child = buildWideNode(children[c], subtree_height);
+            child_height = std::max(child_height, subtree_height);
         }
+        m_wide_nodes[wide_node].children[c] = child;
+    }
+    m_wide_nodes[wide_node].num_children = num_children;
+    height = child_height + 1;
+    return wide_node;
+}
 
-        // allocate new memory
-        // cppcheck-suppress AssignmentAddressToInteger
-        int retval = posix_memalign((void**) &m_new_nodes, 32, m_new_node_capacity * sizeof(AABBNode));
-        if (retval != 0)
+/*! \param wide_node The wide node
+    \param children Indices of the nodes of the binary tree that are the children of the wide node
+    \param num_children Number of children
+
+    Each axis uses the smallest power of two spacing for which the grid spans the node. The lower bounds are
+   rounded down and the upper bounds up, and if rounding leaves a bound outside the grid, the spacing is
+   doubled. Unused children have empty bounds.
+*/
+inline void AABBTree::quantizeWideNode(AABBWideNode& wide_node,
+                                       const std::array<unsigned int, AABB_WIDE_NODE_WIDTH>& children,
+                                       unsigned int num_children) const
+{
+    constexpr unsigned int max_bin = 255;
+    std::array<vec3<float>, AABB_WIDE_NODE_WIDTH> lower;
+    std::array<vec3<float>, AABB_WIDE_NODE_WIDTH> upper;
+    AABB bounds = m_nodes[children[0]].aabb;
+    for (unsigned int c = 0; c < num_children; ++c)
+    {
+        lower[c] = m_nodes[children[c]].aabb.getLower();
+        upper[c] = m_nodes[children[c]].aabb.getUpper();
+        bounds = merge(bounds, m_nodes[children[c]].aabb);
+    }
+
+    auto quantizeAxis = [&](float origin, float extent, float vec3<float>::*axis, unsigned int dim) {
+        uint8_t* q_lower = wide_node.bounds.data() + dim * AABB_WIDE_NODE_WIDTH;
+        uint8_t* q_upper = wide_node.bounds.data() + (dim + 3) * AABB_WIDE_NODE_WIDTH;
+        int exponent = 0;
+        std::frexp(extent / static_cast<float>(max_bin), &exponent);
+        float scale = (extent > 0) ? std::ldexp(float(1), exponent) : float(1);
+        auto dequantize = [&](unsigned int q) { return origin + static_cast<float>(q) * scale; };
+        while (true)
         {
-            throw std::runtime_error("Error allocating AABBTree memory");
+            bool fits = true;
+            for (unsigned int c = 0; c < num_children && fits; ++c)
+            {
+                const float lo = lower[c].*axis;
+                const float hi = upper[c].*axis;
+                auto q_lo = static_cast<unsigned int>(
+                    std::min(std::max(std::floor((lo - origin) / scale), float(0)), float(max_bin)));
+                while (q_lo > 0 && dequantize(q_lo) > lo)
+                {
+                    --q_lo;
+                }
+                auto q_hi = static_cast<unsigned int>(
+                    std::min(std::max(std::ceil((hi - origin) / scale), float(0)), float(max_bin)));
+                while (q_hi < max_bin && dequantize(q_hi) < hi)
+                {
+                    ++q_hi;
+                }
+                fits = dequantize(q_lo) <= lo && dequantize(q_hi) >= hi;
+                q_lower[c] = static_cast<uint8_t>(q_lo);
+                q_upper[c] = static_cast<uint8_t>(q_hi);
+            }
+            if (fits)
+            {
+                break;
+            }
+            scale *= 2;
         }
-
-        // if we have old memory, copy it over
-        if (m_nodes != nullptr)
+        for (unsigned int c = num_children; c < AABB_WIDE_NODE_WIDTH; ++c)
         {
-            // cppcheck doesn't recognize that posix_memalign allocates memory for m_new_nodes above.
-            // cppcheck-suppress nullPointer
-            std::memcpy((void*) m_new_nodes, (void*) m_nodes, sizeof(AABBNode) * m_num_nodes);
-            posix_memalign_free(m_nodes);
+            q_lower[c] = max_bin;
+            q_upper[c] = 0;
         }
-        m_nodes = m_new_nodes;
-        m_node_capacity = m_new_node_capacity;
-    }
-
-    m_nodes[m_num_nodes] = AABBNode();
-    m_num_nodes++;
-    return m_num_nodes - 1;
+        return scale;
+    };
+
+    const vec3<float> origin = bounds.getLower();
+    const vec3<float> extent = bounds.getUpper() - origin;
+    wide_node.origin = origin;
+    wide_node.scale.x = quantizeAxis(origin.x, extent.x, &vec3<float>::x, 0);
+    wide_node.scale.y = quantizeAxis(origin.y, extent.y, &vec3<float>::y, 1);
+    wide_node.scale.z = quantizeAxis(origin.z, extent.z, &vec3<float>::z, 2);
 }
 
 }; }; // end namespace freud::locality
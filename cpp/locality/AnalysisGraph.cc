@@ -0,0 +1,145 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+#include <tbb/flow_graph.h>
+
+#include "AnalysisGraph.h"
+
+/*! \file AnalysisGraph.cc
+    \brief Run a graph of dependent computes on every frame of a trajectory.
+*/
+
+namespace freud { namespace locality {
+
+const NeighborList* FrameContext::getNeighborList(unsigned int node) const
+{
+    return neighbor_plan->getNeighborList(graph->getNeighborIndex(node)).get();
+}
+
+const AnalysisGraph::Node& AnalysisGraph::getNode(unsigned int node) const
+{
+    if (node >= m_nodes.size())
+    {
+        throw std::invalid_argument("The node is not part of the analysis graph.");
+    }
+    return m_nodes[node];
+}
+
+unsigned int AnalysisGraph::getNeighborIndex(unsigned int node) const
+{
+    const Node& neighbor_node = getNode(node);
+    if (neighbor_node.neighbor_idx == NOT_NEIGHBOR_NODE)
+    {
+        throw std::invalid_argument("The node is not a neighbor node.");
+    }
+    return neighbor_node.neighbor_idx;
+}
+
+unsigned int AnalysisGraph::addNeighbors(const QueryArgs& qargs)
+{
+    Node node;
+    node.neighbor_idx = static_cast<unsigned int>(m_neighbor_args.size());
+    m_neighbor_args.push_back(qargs);
+    m_nodes.push_back(std::move(node));
+    return getNumNodes() - 1;
+}
+
+unsigned int AnalysisGraph::addTask(FrameTask task, const std::vector<unsigned int>& dependencies,
+                                    const util::ManagedArray<unsigned int>* point_labels)
+{
+    Node node;
+    node.task = std::move(task);
+    node.point_labels = point_labels;
+    for (const unsigned int dependency : dependencies)
+    {
+        if (dependency >= m_nodes.size())
+        {
+            throw std::invalid_argument("A node can only depend on nodes added before it.");
+        }
+        node.dependencies.push_back(dependency);
+    }
+    std::sort(node.dependencies.begin(), node.dependencies.end());
+    node.dependencies.erase(std::unique(node.dependencies.begin(), node.dependencies.end()),
+                            node.dependencies.end());
+    m_nodes.push_back(std::move(node));
+    return getNumNodes() - 1;
+}
+
+void AnalysisGraph::run(const FrameSource& source, size_t max_frames_in_flight)
+{
+    using tbb::flow::continue_msg;
+    using FlowNode = tbb::flow::continue_node<continue_msg>;
+
+    // The neighbors of all neighbor nodes are found by one node of the flow
+    // graph, since the plan shares queries between them.
+    FrameContext context;
+    context.neighbor_plan = &m_neighbor_plan;
+    context.graph = this;
+
+    tbb::flow::graph flow_graph;
+    tbb::flow::broadcast_node<continue_msg> start(flow_graph);
+    FlowNode neighbors(flow_graph, [&](const continue_msg&) {
+        m_neighbor_plan.compute(context.neighbor_query, context.frame->points, context.frame->n_points,
+                                m_neighbor_args);
+    });
+    if (!m_neighbor_args.empty())
+    {
+        tbb::flow::make_edge(start, neighbors);
+    }
+
+    std::vector<std::unique_ptr<FlowNode>> task_nodes(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const Node& node = m_nodes[i];
+        if (node.neighbor_idx != NOT_NEIGHBOR_NODE)
+        {
+            continue;
+        }
+        const FrameTask& task = node.task;
+        task_nodes[i] = std::make_unique<FlowNode>(flow_graph,
+                                                   [&task, &context](const continue_msg&) { task(context); });
+
+        // The neighbor nodes of the dependencies all wait for the same node.
+        bool depends_on_neighbors = false;
+        for (const unsigned int dependency : node.dependencies)
+        {
+            if (m_nodes[dependency].neighbor_idx != NOT_NEIGHBOR_NODE)
+            {
+                depends_on_neighbors = true;
+            }
+            else
+            {
+                tbb::flow::make_edge(*task_nodes[dependency], *task_nodes[i]);
+            }
+        }
+        if (depends_on_neighbors)
+        {
+            tbb::flow::make_edge(neighbors, *task_nodes[i]);
+        }
+        if (node.dependencies.empty())
+        {
+            tbb::flow::make_edge(start, *task_nodes[i]);
+        }
+    }
+
+    m_num_frames = 0;
+    processTrajectory(
+        source,
+        [&](size_t index, const NeighborQuery* neighbor_query, const TrajectoryFrame& frame) {
+            context.index = index;
+            context.frame = &frame;
+            context.neighbor_query = neighbor_query;
+            start.try_put(continue_msg());
+            flow_graph.wait_for_all();
+            ++m_num_frames;
+            if (m_callback != nullptr && !m_callback(index, m_callback_data))
+            {
+                throw std::runtime_error("The frame callback stopped the analysis.");
+            }
+        },
+        max_frames_in_flight);
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,156 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef ANALYSIS_GRAPH_H
+#define ANALYSIS_GRAPH_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "NeighborQueryPlan.h"
+#include "TrajectoryPipeline.h"
+
+/*! \file AnalysisGraph.h
+    \brief Run a graph of dependent computes on every frame of a trajectory.
+*/
+
+namespace freud { namespace locality {
+
+class AnalysisGraph;
+
+//! The data of the frame being processed by an AnalysisGraph.
+struct FrameContext
+{
+    size_t index {0};                                 //!< Index of the frame in the trajectory
+    const TrajectoryFrame* frame {nullptr};           //!< The frame
+    const NeighborQuery* neighbor_query {nullptr};    //!< NeighborQuery of the points of the frame
+    const NeighborQueryPlan* neighbor_plan {nullptr}; //!< The neighbors of every neighbor node
+    const AnalysisGraph* graph {nullptr};             //!< The graph processing the frame
+
+    //! Get the NeighborList of a neighbor node of the graph for this frame
+    const NeighborList* getNeighborList(unsigned int node) const;
+};
+
+//! Function computing the results of a node of an AnalysisGraph for one frame.
+using FrameTask = std::function<void(const FrameContext&)>;
+
+//! Function called after all nodes have processed a frame, returning false to stop the analysis.
+using FrameCallback = bool (*)(size_t, void*);
+
+//! A graph of computes that is run on every frame of a trajectory.
+/*! The graph has two kinds of nodes. Neighbor nodes hold query arguments, and
+ *  the neighbors of all neighbor nodes are found together by a
+ *  NeighborQueryPlan, which shares queries between them and keeps its
+ *  NeighborLists alive between frames. Task nodes run a compute on the frame,
+ *  after all of the nodes they depend on. Nodes are numbered in the order in
+ *  which they are added, and may only depend on nodes that were added before
+ *  them, so the graph is always acyclic.
+ *
+ *  The frames are processed with processTrajectory, so the NeighborQuery of
+ *  the following frames is built while the nodes process the current one. The
+ *  nodes of a frame are scheduled as a TBB flow graph, so nodes that do not
+ *  depend on each other run concurrently. Frames are processed one at a time
+ *  and in order, so a node sees the results its dependencies computed for the
+ *  same frame, and each compute holds the results of the last frame once the
+ *  graph has run.
+ */
+class AnalysisGraph
+{
+public:
+    //! Constructor
+    AnalysisGraph() = default;
+
+    //! Add a neighbor node
+    /*! \param qargs The query arguments of the neighbors of the points of
+     *               each frame.
+     *  \returns The index of the node.
+     */
+    unsigned int addNeighbors(const QueryArgs& qargs);
+
+    //! Add a task node
+    /*! \param task The function computing the node for a frame.
+     *  \param dependencies The nodes that must process a frame before this
+     *                      node does.
+     *  \param point_labels A per-point labeling, such as cluster indices, that
+     *                      the task computes for other nodes to use, or
+     *                      nullptr if the task computes none.
+     *  \returns The index of the node.
+     */
+    unsigned int addTask(FrameTask task, const std::vector<unsigned int>& dependencies,
+                         const util::ManagedArray<unsigned int>* point_labels = nullptr);
+
+    //! Set a function that is called after all nodes have processed a frame
+    /*! The callback is called with the index of the frame and the given data,
+     *  in order of frame index. If it returns false, the analysis stops with
+     *  an exception.
+     */
+    void setFrameCallback(FrameCallback callback, void* data)
+    {
+        m_callback = callback;
+        m_callback_data = data;
+    }
+
+    //! Process every frame of a trajectory
+    /*! \param source The source of the frames.
+     *  \param max_frames_in_flight The number of frames whose neighbor queries
+     *         may exist at the same time.
+     */
+    void run(const FrameSource& source, size_t max_frames_in_flight = 2);
+
+    //! Get the number of nodes
+    unsigned int getNumNodes() const
+    {
+        return static_cast<unsigned int>(m_nodes.size());
+    }
+
+    //! Get whether a node is a neighbor node
+    bool isNeighborNode(unsigned int node) const
+    {
+        return getNode(node).neighbor_idx != NOT_NEIGHBOR_NODE;
+    }
+
+    //! Get the per-point labels computed by a task node, or nullptr if it computes none
+    const util::ManagedArray<unsigned int>* getPointLabels(unsigned int node) const
+    {
+        return getNode(node).point_labels;
+    }
+
+    //! Get the index of a neighbor node in the queries of the neighbor plan
+    unsigned int getNeighborIndex(unsigned int node) const;
+
+    //! Get the number of frames processed by the last run
+    size_t getNumFrames() const
+    {
+        return m_num_frames;
+    }
+
+private:
+    static constexpr unsigned int NOT_NEIGHBOR_NODE = 0xffffffff;
+
+    //! A node of the graph
+    struct Node
+    {
+        unsigned int neighbor_idx {NOT_NEIGHBOR_NODE};                  //!< Query of a neighbor node
+        FrameTask task;                                                 //!< Function of a task node
+        std::vector<unsigned int> dependencies;                         //!< Nodes this node waits for
+        const util::ManagedArray<unsigned int>* point_labels {nullptr}; //!< Labels computed by the task
+    };
+
+    //! Get a node, checking that it exists
+    const Node& getNode(unsigned int node) const;
+
+    std::vector<Node> m_nodes;              //!< The nodes of the graph
+    std::vector<QueryArgs> m_neighbor_args; //!< Query arguments of the neighbor nodes
+    NeighborQueryPlan m_neighbor_plan;      //!< Finds the neighbors of all neighbor nodes
+    FrameCallback m_callback {nullptr};     //!< Function called after each frame
+    void* m_callback_data {nullptr};        //!< Data passed to the callback
+    size_t m_num_frames {0};                //!< Number of frames processed by the last run
+};
+
+}; }; // end namespace freud::locality
+
+#endif // ANALYSIS_GRAPH_H
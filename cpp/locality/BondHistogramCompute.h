@@ -1,10 +1,19 @@
 #ifndef BOND_HISTOGRAM_COMPUTE_H
 #define BOND_HISTOGRAM_COMPUTE_H
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
 #include "Box.h"
 #include "Histogram.h"
 #include "NeighborComputeFunctional.h"
 #include "NeighborQuery.h"
+#include "SlabStream.h"
 
 namespace freud { namespace locality {
 
@@ -30,10 +39,37 @@ public:
     {
         m_local_histograms.reset();
         m_frame_counter = 0;
+        m_reduce_counts = true;
         m_reduce = true;
     }
 
-    //! Reduce thread-local arrays onto the primary data arrays.
+    //! Set the precision of the bin counts accumulated over frames.
+    /*! With 32 bit counts, the bonds of all frames are counted in the thread
+     *  local histograms, whose counts overflow after 2^32 bonds in a bin. With
+     *  64 bit counts, the thread local histograms count the bonds of one frame
+     *  and are added to 64 bit totals after each frame, so only the counts of a
+     *  single frame are limited to 32 bits, at the cost of a pass over the bins
+     *  after each frame. The bonds are binned in the same way in both cases.
+     *  The precision takes effect at the first accumulation
+     *  after the next reset, or at the next accumulation if nothing has been
+     *  accumulated yet.
+     */
+    void setCountPrecision(util::CountPrecision precision)
+    {
+        m_requested_precision = precision;
+    }
+
+    //! Get the precision of the bin counts accumulated over frames.
+    util::CountPrecision getCountPrecision() const
+    {
+        return m_frame_counter == 0 ? m_requested_precision : m_precision;
+    }
+
+    //! Compute the derived outputs from the bin counts.
+    /*! Computes reduce the bin counts with reduceBinCounts, which only reduces
+     *  the thread local histograms if the counts have not already been
+     *  reduced since the last accumulation.
+     */
     virtual void reduce() = 0;
 
     //! Get the simulation box
@@ -42,21 +78,83 @@ public:
         return m_box;
     }
 
-    //! Return thing_to_return after reducing if necessary.
+    //! Return a derived output after computing the derived outputs if necessary.
+    /*! The derived outputs are computed at most once between accumulations,
+     *  however many of them are read.
+     */
     template<typename U> U& reduceAndReturn(U& thing_to_return)
     {
         if (m_reduce)
         {
+            FREUD_PROFILE_SCOPE("reduction");
+            const auto start = std::chrono::steady_clock::now();
             reduce();
+            m_reduce_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         }
         m_reduce = false;
         return thing_to_return;
     }
 
+    //! Return the bin counts or an array holding them after reducing the counts if necessary.
+    /*! Reading the counts does not compute the derived outputs, which are
+     *  only computed once one of them is read.
+     */
+    template<typename U> U& reduceCountsAndReturn(U& thing_to_return)
+    {
+        if (m_reduce_counts)
+        {
+            FREUD_PROFILE_SCOPE("reduction");
+            const auto start = std::chrono::steady_clock::now();
+            reduceCounts();
+            m_reduce_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return thing_to_return;
+    }
+
+    //! Set the strategy used to accumulate the histogram from many threads.
+    /*! The strategy takes effect at the first accumulation after the next
+     *  reset, or at the next accumulation if nothing has been accumulated yet.
+     *  With the automatic strategy, the strategy is chosen from the number of
+     *  bins of the histogram and the estimated number of bonds of that
+     *  accumulation.
+     */
+    void setAccumulationStrategy(util::AccumulationStrategy strategy)
+    {
+        m_requested_strategy = strategy;
+    }
+
+    //! Get the strategy used to accumulate the histogram.
+    /*! This is the strategy chosen for the data accumulated since the last
+     *  reset, or the requested strategy if no data has been accumulated.
+     */
+    util::AccumulationStrategy getAccumulationStrategy() const
+    {
+        return m_frame_counter == 0 ? m_requested_strategy : m_local_histograms.getStrategy();
+    }
+
+    //! Get the wall time in seconds taken by the most recent reduction.
+    /*! This includes both the reduction over the thread local histograms and
+     *  the computation of any normalized quantities.
+     */
+    double getReduceTime() const
+    {
+        return m_reduce_time;
+    }
+
     //! Get a reference to the bin counts array
+    /*! With 64 bit counts, counts that do not fit in 32 bits are saturated.
+     */
     const util::ManagedArray<unsigned int>& getBinCounts()
     {
-        return reduceAndReturn(m_histogram.getBinCounts());
+        return reduceCountsAndReturn(m_histogram.getBinCounts());
+    }
+
+    //! Get a reference to the 64 bit bin counts array
+    /*! This array is only computed with 64 bit counts.
+     */
+    const util::ManagedArray<std::uint64_t>& getWideBinCounts()
+    {
+        return reduceCountsAndReturn(m_wide_counts);
     }
 
     //! Return the bin centers.
@@ -96,26 +194,361 @@ public:
            appropriately with given qargs.
         \param qargs Query arguments
         \param cf An object with operator(NeighborBond) as input.
+        \param squared_distances If true, the bonds passed to cf hold their
+           squared distances, which computes bin with a util::SquaredBinTable.
     */
     template<typename Func>
     void accumulateGeneral(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                            unsigned int n_query_points, const locality::NeighborList* nlist,
-                           locality::QueryArgs qargs, Func cf)
+                           locality::QueryArgs qargs, Func cf, bool squared_distances = false)
+    {
+        beginAccumulate(neighbor_query, n_query_points, nlist, qargs);
+        locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf, true,
+                                    m_loop_policy, squared_distances);
+        // Histograms are normalized by the query points that were queried.
+        endAccumulate(neighbor_query,
+                      nlist == nullptr
+                          ? neighbor_query->countQueryPoints(query_points, n_query_points, qargs.region)
+                          : n_query_points);
+    }
+
+    //! \internal
+    // Wrapper to accumulate the bonds of a system streamed in slabs as a single frame.
+    /*! The slabs are processed with locality::processSlabs, with halos as
+     *  wide as the query distance, so the bonds are those that
+     *  accumulateGeneral would find with all points in memory. Only the
+     *  slabs of the domain are processed, and if the domain has a reducer,
+     *  the bin counts of the frame and its numbers of points are summed over
+     *  the processes of the domain decomposition before they are added to
+     *  the histogram, so every process holds the histogram of the whole
+     *  system.
+     *
+     *  \param box Box of the system
+     *  \param source Source of the points of the system, which are both the
+     *         points and the query points
+     *  \param n_slabs Number of slabs
+     *  \param qargs Query arguments, which must set a finite r_max
+     *  \param cf An object with operator(NeighborBond) as input.
+     *  \param domain The slabs processed by this process, and the reducer
+     *         of the counts of the processes.
+     *  \param squared_distances If true, the bonds passed to cf hold their
+     *         squared distances, as in accumulateGeneral.
+     *  \returns The number of points of the system, summed over the processes.
+     */
+    template<typename Func>
+    unsigned int accumulateSlabs(const box::Box& box, const locality::SlabSource& source,
+                                 unsigned int n_slabs, locality::QueryArgs qargs, Func cf,
+                                 const locality::SlabDomain& domain = locality::SlabDomain(),
+                                 bool squared_distances = false)
+    {
+        if (!(qargs.r_max > 0) || !std::isfinite(qargs.r_max))
+        {
+            throw std::invalid_argument("Streaming a system in slabs requires a positive and finite r_max.");
+        }
+        m_box = box;
+
+        // The counts accumulated before this frame, which are not reduced.
+        std::vector<std::uint64_t> previous_counts;
+        if (domain.reducer && m_frame_counter != 0)
+        {
+            previous_counts = getAccumulatedCounts();
+        }
+
+        bool begun = false;
+        size_t n_points = 0;
+        size_t n_query_points = 0;
+        locality::processSlabs(
+            box, source, n_slabs, domain.first_slab, std::min(domain.last_slab, n_slabs), qargs.r_max,
+            [&](const locality::NeighborQuery* neighbor_query, const locality::Slab& slab) {
+                if (!begun)
+                {
+                    beginAccumulate(neighbor_query, slab.n_slab_points, nullptr, qargs);
+                    begun = true;
+                }
+                locality::loopOverNeighbors(neighbor_query, slab.points.data(), slab.n_slab_points, qargs,
+                                            nullptr, cf, true, m_loop_policy, squared_distances);
+                // Only the counts of a single slab are limited to 32 bits.
+                if (m_precision == util::CountPrecision::uint64)
+                {
+                    addFrameToTotals();
+                }
+                n_points += slab.n_slab_points;
+                n_query_points
+                    += neighbor_query->countQueryPoints(slab.points.data(), slab.n_slab_points, qargs.region);
+            });
+        if (!begun && m_frame_counter == 0)
+        {
+            beginFirstFrame(0);
+        }
+
+        if (domain.reducer)
+        {
+            // The counts of this frame, followed by the numbers of points.
+            std::vector<std::uint64_t> counts = getAccumulatedCounts();
+            for (size_t i = 0; i < previous_counts.size(); ++i)
+            {
+                counts[i] -= previous_counts[i];
+            }
+            counts.push_back(n_points);
+            counts.push_back(n_query_points);
+            const std::vector<std::uint64_t> local_counts(counts);
+            if (!domain.reducer(counts.data(), counts.size()))
+            {
+                throw std::runtime_error("The counts could not be reduced over the processes.");
+            }
+            addOtherCounts(counts, local_counts);
+            n_points = counts[m_histogram.size()];
+            n_query_points = counts[m_histogram.size() + 1];
+        }
+
+        if (n_points > std::numeric_limits<unsigned int>::max())
+        {
+            throw std::overflow_error("A system streamed in slabs may have at most 2^32 - 1 points.");
+        }
+        endAccumulate(static_cast<unsigned int>(n_points), static_cast<unsigned int>(n_query_points));
+        return static_cast<unsigned int>(n_points);
+    }
+
+protected:
+    //! Prepare to accumulate the bonds of a frame.
+    /*! Computes that find their bonds without accumulateGeneral call this
+     *  before accumulating any bond of the frame.
+     */
+    void beginAccumulate(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points,
+                         const locality::NeighborList* nlist, locality::QueryArgs qargs)
     {
         m_box = neighbor_query->getBox();
-        locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf);
+        if (m_frame_counter == 0)
+        {
+            beginFirstFrame(estimateNumBonds(neighbor_query, n_query_points, nlist, qargs));
+        }
+    }
+
+    //! Choose the strategy and precision of the frames accumulated since the reset.
+    /*! \param n_bonds The estimated number of bonds of the first frame.
+     */
+    void beginFirstFrame(size_t n_bonds)
+    {
+        // The thread local histograms are empty, so the strategy may change.
+        util::AccumulationStrategy strategy = m_requested_strategy;
+        if (strategy == util::AccumulationStrategy::automatic)
+        {
+            strategy = BondHistogram::ThreadLocalHistogram::chooseStrategy(m_histogram.size(), n_bonds);
+        }
+        m_local_histograms.setStrategy(strategy);
+
+        m_precision = m_requested_precision;
+        if (m_precision == util::CountPrecision::uint64)
+        {
+            m_wide_totals.prepare(m_histogram.size());
+        }
+    }
+
+    //! Get the bin counts accumulated since the reset.
+    /*! With 64 bit counts, the thread local histograms must have been added
+     *  to the totals.
+     */
+    std::vector<std::uint64_t> getAccumulatedCounts()
+    {
+        if (m_precision == util::CountPrecision::uint64)
+        {
+            return std::vector<std::uint64_t>(m_wide_totals.get(),
+                                              m_wide_totals.get() + m_wide_totals.size());
+        }
+        m_frame_counts.prepareUninitialized(m_histogram.size());
+        m_local_histograms.reduceInto(m_frame_counts);
+        return std::vector<std::uint64_t>(m_frame_counts.get(), m_frame_counts.get() + m_frame_counts.size());
+    }
+
+    //! Add the bin counts of the other processes of a domain decomposition to the accumulated counts.
+    /*! \param counts The bin counts summed over all processes.
+     *  \param local_counts The bin counts of this process.
+     */
+    void addOtherCounts(const std::vector<std::uint64_t>& counts,
+                        const std::vector<std::uint64_t>& local_counts)
+    {
+        const size_t bins = m_histogram.size();
+        if (m_precision == util::CountPrecision::uint64)
+        {
+            for (size_t i = 0; i < bins; ++i)
+            {
+                m_wide_totals[i] += counts[i] - local_counts[i];
+            }
+            return;
+        }
+        std::vector<unsigned int> other_counts(bins);
+        for (size_t i = 0; i < bins; ++i)
+        {
+            other_counts[i] = static_cast<unsigned int>(counts[i] - local_counts[i]);
+        }
+        m_local_histograms.incrementBins(0, other_counts.data(), bins);
+    }
+
+    //! Record that the bonds of a frame have been accumulated.
+    void endAccumulate(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points)
+    {
+        endAccumulate(neighbor_query->getNPoints(), n_query_points);
+    }
+
+    //! Record that the bonds of a frame with the given numbers of points have been accumulated.
+    void endAccumulate(unsigned int n_points, unsigned int n_query_points)
+    {
+        if (m_precision == util::CountPrecision::uint64)
+        {
+            addFrameToTotals();
+        }
         m_frame_counter++;
-        m_n_points = neighbor_query->getNPoints();
+        m_n_points = n_points;
         m_n_query_points = n_query_points;
+        m_reduce_counts = true;
         m_reduce = true;
     }
 
-protected:
+    //! Reduce the bin counts over all threads and frames.
+    /*! Computes whose bin counts are not just the counts of the thread local
+     *  histograms override this, and must then also reduce the counts in
+     *  reduce if countsReduced returns false.
+     */
+    virtual void reduceCounts()
+    {
+        reduceBinCounts([](size_t /*i*/) {});
+    }
+
+    //! Return whether the bin counts have been reduced since the last accumulation.
+    bool countsReduced() const
+    {
+        return !m_reduce_counts;
+    }
+
+    //! Reduce the bin counts over all threads and frames if necessary and apply a function to each bin.
+    /*! Computes call this from reduce instead of reducing m_local_histograms
+     *  into m_histogram themselves, and read the reduced counts with
+     *  getBinCount, so that the counts have the precision that was set. If
+     *  the counts were already reduced since the last accumulation, for
+     *  instance because they were read, the function is only applied to the
+     *  reduced counts.
+     *
+     *  \param cf The function to apply to each bin, must have signature (size_t i) {...}
+     */
+    template<typename ComputeFunction> void reduceBinCounts(const ComputeFunction& cf)
+    {
+        if (!m_reduce_counts)
+        {
+            util::forLoopWrapper(0, m_histogram.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    cf(i);
+                }
+            });
+            return;
+        }
+        m_reduce_counts = false;
+
+        if (m_precision == util::CountPrecision::uint32)
+        {
+            m_histogram.prepare(m_histogram.shape());
+            m_histogram.reduceOverThreadsPerBin(m_local_histograms, cf);
+            return;
+        }
+
+        // The thread local histograms are empty after each frame, so the
+        // counts are the totals.
+        m_histogram.prepare(m_histogram.shape());
+        m_wide_counts.prepare(m_histogram.shape());
+        const bool has_totals = m_wide_totals.size() == m_histogram.size();
+        util::forLoopWrapper(0, m_histogram.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_wide_counts[i] = has_totals ? m_wide_totals[i] : 0;
+                m_histogram[i] = saturateCount(m_wide_counts[i]);
+                cf(i);
+            }
+        });
+    }
+
+    //! Get the count of a bin after reduceBinCounts.
+    std::uint64_t getBinCount(size_t i) const
+    {
+        return m_precision == util::CountPrecision::uint64 ? m_wide_counts[i] : m_histogram[i];
+    }
+
+    //! Add to the count of a bin after reduceBinCounts.
+    void addToBinCount(size_t i, std::uint64_t count)
+    {
+        if (m_precision == util::CountPrecision::uint64)
+        {
+            m_wide_counts[i] += count;
+            m_histogram[i] = saturateCount(m_wide_counts[i]);
+        }
+        else
+        {
+            m_histogram[i] += static_cast<unsigned int>(count);
+        }
+    }
+
+    //! Convert a 64 bit count to a 32 bit count, saturating counts that do not fit.
+    static unsigned int saturateCount(std::uint64_t count)
+    {
+        return static_cast<unsigned int>(
+            std::min<std::uint64_t>(count, std::numeric_limits<unsigned int>::max()));
+    }
+
+    //! Add the counts of the thread local histograms to the 64 bit totals and empty them.
+    void addFrameToTotals()
+    {
+        m_frame_counts.prepareUninitialized(m_histogram.size());
+        m_local_histograms.reduceInto(m_frame_counts);
+        util::forLoopWrapper(0, m_frame_counts.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_wide_totals[i] += m_frame_counts[i];
+            }
+        });
+        m_local_histograms.reset();
+    }
+
+    //! Estimate the number of bonds found by a neighbor query.
+    /*! Ball queries are assumed to find points at the average density of the
+     *  system.
+     */
+    static size_t estimateNumBonds(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points,
+                                   const locality::NeighborList* nlist, locality::QueryArgs qargs)
+    {
+        if (nlist != nullptr)
+        {
+            return nlist->getNumBonds();
+        }
+        if (qargs.mode == locality::QueryType::nearest)
+        {
+            return static_cast<size_t>(n_query_points) * qargs.num_neighbors;
+        }
+        const box::Box& box = neighbor_query->getBox();
+        const float r_max = qargs.r_max;
+        const float ball_volume = box.is2D() ? static_cast<float>(M_PI) * r_max * r_max
+                                             : float(4.0 / 3.0 * M_PI) * r_max * r_max * r_max;
+        const float fraction = std::min(ball_volume / box.getVolume(), float(1.0));
+        return static_cast<size_t>(fraction * static_cast<float>(neighbor_query->getNPoints())
+                                   * static_cast<float>(n_query_points));
+    }
+
     box::Box m_box;
     unsigned int m_frame_counter {0};  //!< Number of frames calculated.
     unsigned int m_n_points {0};       //!< The number of points.
     unsigned int m_n_query_points {0}; //!< The number of query points.
-    bool m_reduce {true};              //!< Whether or not the histogram needs to be reduced.
+    bool m_reduce_counts {true};       //!< Whether or not the histogram needs to be reduced.
+    bool m_reduce {true};              //!< Whether or not the derived outputs need to be computed.
+    double m_reduce_time {0};          //!< Wall time of the most recent reduction in seconds.
+    util::AccumulationStrategy m_requested_strategy {
+        util::AccumulationStrategy::automatic}; //!< Strategy used to accumulate the histogram.
+    util::LoopPolicy m_loop_policy {
+        util::LoopPartitioner::affinity}; //!< Keeps the threads of each part of the loop between frames.
+    util::CountPrecision m_requested_precision {
+        util::CountPrecision::uint32}; //!< Precision of the counts requested by the user.
+    util::CountPrecision m_precision {
+        util::CountPrecision::uint32};               //!< Precision of the counts accumulated since the reset.
+    util::ManagedArray<std::uint64_t> m_wide_totals; //!< 64 bit counts of all frames since the reset.
+    util::ManagedArray<std::uint64_t> m_wide_counts; //!< Reduced 64 bit counts, with any additions.
+    util::ManagedArray<unsigned int> m_frame_counts; //!< Scratch counts of the most recent frame.
 
     util::Histogram<unsigned int> m_histogram; //!< Histogram of interparticle distances (bond lengths).
     util::Histogram<unsigned int>::ThreadLocalHistogram
@@ -0,0 +1,57 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include "BondKernel.h"
+#include "NeighborComputeFunctional.h"
+
+/*! \file BondKernel.cc
+    \brief Computes several per-point quantities in one pass over the bonds of each point.
+*/
+
+namespace freud { namespace locality {
+
+void loopOverBondKernels(const std::vector<BondKernel*>& kernels, const NeighborQuery* neighbor_query,
+                         const vec3<float>* query_points, unsigned int n_query_points,
+                         const NeighborList* nlist, QueryArgs qargs)
+{
+    {
+        FREUD_PROFILE_SCOPE("prepare");
+        for (BondKernel* kernel : kernels)
+        {
+            kernel->prepare(neighbor_query, query_points, n_query_points, nlist, qargs);
+        }
+    }
+
+    // Each thread gathers the bonds of a point into buffers that are kept
+    // between points.
+    const box::Box& box = neighbor_query->getBox();
+    tbb::enumerable_thread_specific<PointBonds> local_point_bonds;
+    loopOverNeighborsIterator(
+        neighbor_query, query_points, n_query_points, qargs, nlist,
+        [&](size_t i, const std::shared_ptr<NeighborPerPointIterator>& ppiter) {
+            PointBonds& point_bonds = local_point_bonds.local();
+            point_bonds.bonds.clear();
+            point_bonds.deltas.clear();
+            for (NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            {
+                point_bonds.bonds.push_back(nb);
+                point_bonds.deltas.push_back(box.wrap((*neighbor_query)[nb.point_idx] - query_points[i]));
+            }
+            FREUD_PROFILE_COUNT("bonds", point_bonds.bonds.size());
+            FREUD_PROFILE_FINE_SCOPE("point kernels");
+            for (BondKernel* kernel : kernels)
+            {
+                kernel->computePoint(i, point_bonds);
+            }
+        });
+
+    FREUD_PROFILE_SCOPE("finish");
+    for (BondKernel* kernel : kernels)
+    {
+        kernel->finish(neighbor_query, query_points, n_query_points, nlist, qargs);
+    }
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,78 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BOND_KERNEL_H
+#define BOND_KERNEL_H
+
+#include <vector>
+
+#include "NeighborBond.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file BondKernel.h
+    \brief Computes several per-point quantities in one pass over the bonds of each point.
+*/
+
+namespace freud { namespace locality {
+
+//! The bonds of a query point and the vectors of those bonds
+/*! The bond vectors point from the query point to the point, wrapped into the
+ *  box, like those of bondVector.
+ */
+struct PointBonds
+{
+    std::vector<NeighborBond> bonds; //!< The bonds of the query point
+    std::vector<vec3<float>> deltas; //!< The bond vector of each bond
+};
+
+//! A computation over the bonds of each query point
+/*! Computes that accumulate a quantity from the bonds of each query point
+ *  implement this interface so that several of them can run together with
+ *  loopOverBondKernels, which finds the bonds of each query point and computes
+ *  their bond vectors once for all kernels.
+ */
+class BondKernel
+{
+public:
+    //! Destructor
+    virtual ~BondKernel() = default;
+
+    //! Prepare the outputs before any point is computed
+    virtual void prepare(const NeighborQuery* /*neighbor_query*/, const vec3<float>* /*query_points*/,
+                         unsigned int /*n_query_points*/, const NeighborList* /*nlist*/, QueryArgs /*qargs*/)
+    {}
+
+    //! Compute the quantities of a query point from its bonds
+    /*! This is called for many query points concurrently, so it must only
+     *  write outputs of its query point or thread local data.
+     */
+    virtual void computePoint(size_t query_point_idx, const PointBonds& point_bonds) = 0;
+
+    //! Finish the outputs after all points are computed
+    virtual void finish(const NeighborQuery* /*neighbor_query*/, const vec3<float>* /*query_points*/,
+                        unsigned int /*n_query_points*/, const NeighborList* /*nlist*/, QueryArgs /*qargs*/)
+    {}
+};
+
+//! Run several bond kernels in one pass over the bonds of each query point
+/*! The bonds of each query point are found from the NeighborList if it is
+ *  not NULL and with the NeighborQuery otherwise, and their bond vectors are
+ *  computed once and passed to every kernel in turn.
+ *
+ *  \param kernels The kernels to run.
+ *  \param neighbor_query NeighborQuery object to iterate over.
+ *  \param query_points Query points to perform computation on.
+ *  \param n_query_points Number of query_points.
+ *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
+ *               given qargs.
+ *  \param qargs Query arguments.
+ */
+void loopOverBondKernels(const std::vector<BondKernel*>& kernels, const NeighborQuery* neighbor_query,
+                         const vec3<float>* query_points, unsigned int n_query_points,
+                         const NeighborList* nlist, QueryArgs qargs);
+
+}; }; // end namespace freud::locality
+
+#endif // BOND_KERNEL_H
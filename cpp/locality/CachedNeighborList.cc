@@ -0,0 +1,123 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "CachedNeighborList.h"
+#include "utils.h"
+
+/*! \file CachedNeighborList.cc
+    \brief Reuses a skin-buffered neighbor list across frames.
+*/
+
+namespace freud { namespace locality {
+
+//! Return the largest minimum image displacement between two sets of positions
+inline float maxDisplacement(const box::Box& box, const vec3<float>* current,
+                             const std::vector<vec3<float>>& reference, float bound)
+{
+    float max_dr_sq(0);
+    const float bound_sq(bound * bound);
+    for (unsigned int i = 0; i < reference.size(); ++i)
+    {
+        const vec3<float> delta = box.wrap(current[i] - reference[i]);
+        max_dr_sq = std::max(max_dr_sq, dot(delta, delta));
+        // Exceeding the bound is enough to force a rebuild, stop early.
+        if (max_dr_sq > bound_sq)
+        {
+            break;
+        }
+    }
+    return std::sqrt(max_dr_sq);
+}
+
+CachedNeighborList::CachedNeighborList(float r_max, float skin)
+    : m_r_max(r_max), m_skin(skin), m_neighbor_list(std::make_shared<NeighborList>())
+{
+    if (r_max <= 0)
+    {
+        throw std::invalid_argument("CachedNeighborList requires r_max to be positive.");
+    }
+    if (skin < 0)
+    {
+        throw std::invalid_argument("CachedNeighborList requires skin to be non-negative.");
+    }
+}
+
+bool CachedNeighborList::needsRebuild(const NeighborQuery* nq, const vec3<float>* query_points,
+                                      unsigned int n_query_points, bool exclude_ii) const
+{
+    if (!m_valid || nq->getBox() != m_box || nq->getNPoints() != m_points.size()
+        || n_query_points != m_query_points.size() || exclude_ii != m_exclude_ii)
+    {
+        return true;
+    }
+
+    // A bond can cross r_max without having been cached only if the two
+    // endpoints together moved more than the skin since the build.
+    const float dr_points = maxDisplacement(m_box, nq->getPoints(), m_points, m_skin);
+    if (dr_points > m_skin)
+    {
+        return true;
+    }
+    const float dr_query_points = maxDisplacement(m_box, query_points, m_query_points, m_skin - dr_points);
+    return dr_points + dr_query_points > m_skin;
+}
+
+void CachedNeighborList::rebuild(const NeighborQuery* nq, const vec3<float>* query_points,
+                                 unsigned int n_query_points, bool exclude_ii)
+{
+    QueryArgs qargs;
+    qargs.mode = QueryType::ball;
+    qargs.r_max = m_r_max + m_skin;
+    qargs.exclude_ii = exclude_ii;
+    std::unique_ptr<NeighborList> nlist(nq->query(query_points, n_query_points, qargs)->toNeighborList());
+    m_cached_list.copy(*nlist);
+
+    m_box = nq->getBox();
+    m_points.assign(nq->getPoints(), nq->getPoints() + nq->getNPoints());
+    m_query_points.assign(query_points, query_points + n_query_points);
+    m_exclude_ii = exclude_ii;
+    m_valid = true;
+    ++m_num_builds;
+}
+
+void CachedNeighborList::compute(const NeighborQuery* nq, const vec3<float>* query_points,
+                                 unsigned int n_query_points, bool exclude_ii)
+{
+    if (needsRebuild(nq, query_points, n_query_points, exclude_ii))
+    {
+        // Invalidate first so that a failed query cannot leave a stale cache.
+        m_valid = false;
+        rebuild(nq, query_points, n_query_points, exclude_ii);
+    }
+
+    // Refresh the cached distances from the current positions. Bonds are
+    // kept by comparing squared distances, as the queries themselves do, so
+    // that bonds right at the cutoff are treated identically.
+    const unsigned int num_bonds = m_cached_list.getNumBonds();
+    const vec3<float>* points = nq->getPoints();
+    const unsigned int* neighbors = m_cached_list.getNeighbors().get();
+    float* distances = m_cached_list.getDistances().get();
+    const box::Box& box = m_box;
+    const float r_max_sq = m_r_max * m_r_max;
+    std::unique_ptr<bool[]> keep(new bool[num_bonds]);
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            const vec3<float> delta
+                = box.wrap(points[neighbors[2 * bond + 1]] - query_points[neighbors[2 * bond]]);
+            const float r_sq = dot(delta, delta);
+            distances[bond] = std::sqrt(r_sq);
+            keep[bond] = r_sq < r_max_sq;
+        }
+    });
+
+    m_neighbor_list->copy(m_cached_list);
+    m_neighbor_list->filter(keep.get());
+}
+
+}; }; // end namespace freud::locality
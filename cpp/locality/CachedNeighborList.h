@@ -0,0 +1,103 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef CACHED_NEIGHBOR_LIST_H
+#define CACHED_NEIGHBOR_LIST_H
+
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file CachedNeighborList.h
+    \brief Reuses a skin-buffered neighbor list across frames.
+*/
+
+namespace freud { namespace locality {
+
+//! Neighbor list that is rebuilt only when points move far enough
+/*! The first call to compute performs a ball query with a cutoff of
+ *  r_max + skin and caches the resulting bonds along with the positions used
+ *  to find them. Subsequent calls recompute the distances of the cached bonds
+ *  from the current positions and filter them down to r_max, which yields
+ *  exactly the bonds a fresh query at r_max would find as long as the largest
+ *  point displacement plus the largest query point displacement since the
+ *  build does not exceed the skin (for a single set of points, as long as no
+ *  point has moved more than skin/2). Once that bound is exceeded, or if the
+ *  box, the number of points, or exclude_ii change, the cache is rebuilt.
+ */
+class CachedNeighborList
+{
+public:
+    //! Constructor
+    /*! \param r_max The cutoff distance of the neighbor list.
+     *  \param skin The extra distance searched when the list is built.
+     */
+    CachedNeighborList(float r_max, float skin);
+
+    //! Compute the neighbor list, reusing the cached bonds if possible
+    /*! \param nq NeighborQuery containing the current points.
+     *  \param query_points The current query points.
+     *  \param n_query_points The number of query points.
+     *  \param exclude_ii Whether to exclude bonds between a point and itself.
+     */
+    void compute(const NeighborQuery* nq, const vec3<float>* query_points, unsigned int n_query_points,
+                 bool exclude_ii);
+
+    //! Discard the cached bonds so that the next compute rebuilds them
+    void reset()
+    {
+        m_valid = false;
+    }
+
+    //! Get the cutoff distance
+    float getRMax() const
+    {
+        return m_r_max;
+    }
+
+    //! Get the skin distance
+    float getSkin() const
+    {
+        return m_skin;
+    }
+
+    //! Get the number of times the cached bonds have been rebuilt
+    unsigned int getNumBuilds() const
+    {
+        return m_num_builds;
+    }
+
+    //! Get the neighbor list filtered to r_max
+    std::shared_ptr<NeighborList> getNeighborList() const
+    {
+        return m_neighbor_list;
+    }
+
+private:
+    //! Decide whether the cached bonds can be reused for the given positions
+    bool needsRebuild(const NeighborQuery* nq, const vec3<float>* query_points, unsigned int n_query_points,
+                      bool exclude_ii) const;
+
+    //! Rebuild the cached bonds with a query at r_max + skin
+    void rebuild(const NeighborQuery* nq, const vec3<float>* query_points, unsigned int n_query_points,
+                 bool exclude_ii);
+
+    float m_r_max;                                 //!< Cutoff distance of the neighbor list
+    float m_skin;                                  //!< Extra distance searched when building
+    bool m_valid {false};                          //!< Whether the cached bonds may be reused
+    bool m_exclude_ii {false};                     //!< Whether self bonds were excluded
+    unsigned int m_num_builds {0};                 //!< Number of times the cache was rebuilt
+    box::Box m_box;                                //!< Box used to build the cache
+    std::vector<vec3<float>> m_points;             //!< Point positions at build time
+    std::vector<vec3<float>> m_query_points;       //!< Query point positions at build time
+    NeighborList m_cached_list;                    //!< Bonds within r_max + skin at build time
+    std::shared_ptr<NeighborList> m_neighbor_list; //!< Bonds within r_max for the current positions
+};
+
+}; }; // end namespace freud::locality
+
+#endif // CACHED_NEIGHBOR_LIST_H
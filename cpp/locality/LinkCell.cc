@@ -2,10 +2,15 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
 
 #include "LinkCell.h"
+#include "NeighborHeap.h"
 
 /*! \file LinkCell.cc
     \brief Build a cell list from a set of points.
@@ -204,6 +209,44 @@ void IteratorCellShell::reset(unsigned int range)
     }
 }
 
+/***************
+ * CellStencil *
+ ***************/
+
+CellStencil::CellStencil(const vec3<unsigned int>& celldim, unsigned int max_range, bool is2D)
+    : m_celldim(celldim)
+{
+    const int shift = static_cast<int>(max_range);
+    m_shell_starts.push_back(0);
+    for (unsigned int range = 0; range <= max_range; ++range)
+    {
+        const IteratorCellShell shell_end(range + 1, is2D);
+        for (IteratorCellShell shell(range, is2D); shell != shell_end; ++shell)
+        {
+            const vec3<int> offset = *shell;
+            m_offsets.emplace_back(offset.x + shift, offset.y + shift, offset.z + shift);
+        }
+        m_shell_starts.push_back(static_cast<unsigned int>(m_offsets.size()));
+    }
+
+    // A shifted coordinate is a cell coordinate plus a shifted offset, so it
+    // lies in [0, dim + 2 * max_range) and may wrap around more than once
+    // when the stencil is wider than the cell list.
+    auto fillWrapTable = [shift](unsigned int dim, std::vector<unsigned int>& table) {
+        const int width = static_cast<int>(dim);
+        table.resize(dim + 2 * static_cast<size_t>(shift));
+        for (int coord = 0; coord < static_cast<int>(table.size()); ++coord)
+        {
+            int wrapped = (coord - shift) % width;
+            wrapped += (wrapped < 0 ? width : 0);
+            table[coord] = static_cast<unsigned int>(wrapped);
+        }
+    };
+    fillWrapTable(celldim.x, m_wrap_x);
+    fillWrapTable(celldim.y, m_wrap_y);
+    fillWrapTable(celldim.z, m_wrap_z);
+}
+
 /********************
  * LinkCell *
  ********************/
@@ -227,17 +270,23 @@ LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int
         m_cell_width = std::cbrtf(box.getVolume() / static_cast<float>(desired_num_cells));
     }
 
-    m_celldim = computeDimensions(box, m_cell_width);
+    computeCellDimensions();
+    computeCellList(points, n_points);
+}
+
+void LinkCell::computeCellDimensions()
+{
+    m_celldim = computeDimensions(m_box, m_cell_width);
 
     // Check if box is too small!
-    vec3<float> nearest_plane_distance = box.getNearestPlaneDistance();
+    vec3<float> nearest_plane_distance = m_box.getNearestPlaneDistance();
     if ((m_cell_width * 2.0 > nearest_plane_distance.x) || (m_cell_width * 2.0 > nearest_plane_distance.y)
-        || (!box.is2D() && m_cell_width * 2.0 > nearest_plane_distance.z))
+        || (!m_box.is2D() && m_cell_width * 2.0 > nearest_plane_distance.z))
     {
         throw std::runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
     }
     // Only 1 cell deep in 2D
-    if (box.is2D())
+    if (m_box.is2D())
     {
         m_celldim.z = 1;
     }
@@ -248,7 +297,8 @@ LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int
         throw std::runtime_error("At least one cell must be present.");
     }
 
-    computeCellList(points, n_points);
+    // The cells adjacent to a cell only depend on the cell dimensions.
+    m_neighbor_stencil = CellStencil(m_celldim, 1, m_box.is2D());
 }
 
 unsigned int LinkCell::getCellIndex(const vec3<int> cellCoord) const
@@ -309,42 +359,312 @@ void LinkCell::computeCellList(const vec3<float>* points, unsigned int n_points)
 {
     // determine the number of cells and allocate memory
     unsigned int Nc = getNumCells();
-    m_cell_list.prepare(n_points + Nc);
     m_n_points = n_points;
 
-    // initialize memory
-    for (unsigned int cell = 0; cell < Nc; cell++)
+    m_point_cells.prepare(n_points);
+    unsigned int* point_cells = m_point_cells.get();
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            point_cells[i] = getCell(points[i]);
+        }
+    });
+
+    computeSortedLayout(points);
+
+    // Derive the linked list from the sorted layout. The points of each cell
+    // are linked in increasing order of index.
+    m_cell_list.prepare(n_points + Nc);
+    unsigned int* cell_list = m_cell_list.get();
+    const unsigned int* cell_starts = m_cell_starts.get();
+    const unsigned int* sorted_indices = m_sorted_indices.get();
+    util::forLoopWrapper(0, Nc, [&](size_t begin, size_t end) {
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            const unsigned int start = cell_starts[cell];
+            const unsigned int stop = cell_starts[cell + 1];
+            cell_list[n_points + cell] = (start == stop) ? LINK_CELL_TERMINATOR : sorted_indices[start];
+            for (unsigned int k = start; k < stop; ++k)
+            {
+                cell_list[sorted_indices[k]] = (k + 1 < stop) ? sorted_indices[k + 1] : LINK_CELL_TERMINATOR;
+            }
+        }
+    });
+}
+
+void LinkCell::computeSortedLayout(const vec3<float>* points)
+{
+    const unsigned int Nc = getNumCells();
+    const unsigned int* point_cells = m_point_cells.get();
+
+    // Count the points in each cell.
+    std::unique_ptr<std::atomic<unsigned int>[]> cell_counters( // NOLINT(modernize-avoid-c-arrays)
+        new std::atomic<unsigned int>[Nc]);
+    util::forLoopWrapper(0, Nc, [&](size_t begin, size_t end) {
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            cell_counters[cell].store(0, std::memory_order_relaxed);
+        }
+    });
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            cell_counters[point_cells[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Convert the counts into offsets, and reuse the counters as the next
+    // free position in each cell.
+    m_cell_starts.prepare(Nc + 1);
+    unsigned int* cell_starts = m_cell_starts.get();
+    unsigned int offset = 0;
+    for (unsigned int cell = 0; cell < Nc; ++cell)
     {
-        m_cell_list[n_points + cell] = LINK_CELL_TERMINATOR;
+        cell_starts[cell] = offset;
+        offset += cell_counters[cell].load(std::memory_order_relaxed);
+        cell_counters[cell].store(cell_starts[cell], std::memory_order_relaxed);
     }
+    cell_starts[Nc] = offset;
+
+    // Scatter the points into their cells, then sort each cell by index so
+    // that the layout does not depend on thread scheduling.
+    m_sorted_indices.prepare(m_n_points);
+    unsigned int* sorted_indices = m_sorted_indices.get();
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            sorted_indices[cell_counters[point_cells[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+        }
+    });
+    util::forLoopWrapper(0, Nc, [&](size_t begin, size_t end) {
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            std::sort(sorted_indices + cell_starts[cell], sorted_indices + cell_starts[cell + 1]);
+        }
+    });
+
+    gatherSortedPoints(points);
+}
+
+void LinkCell::gatherSortedPoints(const vec3<float>* points)
+{
+    m_sorted_points.prepare(m_n_points);
+    m_sorted_soa_points.resize(m_n_points);
+    vec3<float>* sorted_points = m_sorted_points.get();
+    const unsigned int* sorted_indices = m_sorted_indices.get();
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k)
+        {
+            sorted_points[k] = points[sorted_indices[k]];
+            m_sorted_soa_points.set(k, sorted_points[k]);
+        }
+    });
+}
 
-    // Generate the cell list.
-    for (unsigned int i = n_points - 1; i != static_cast<unsigned int>(-1); --i)
+void LinkCell::update(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+{
+    validatePoints(box, points, n_points);
+
+    const vec3<unsigned int> old_celldim = m_celldim;
+    if (box != m_box)
     {
-        unsigned int cell = getCell(points[i]);
-        m_cell_list[i] = m_cell_list[n_points + cell];
-        m_cell_list[n_points + cell] = i;
+        const box::Box old_box = m_box;
+        m_box = box;
+        try
+        {
+            computeCellDimensions();
+        }
+        catch (...)
+        {
+            // Leave the existing cell list untouched if the new box is invalid.
+            m_box = old_box;
+            m_celldim = old_celldim;
+            throw;
+        }
+    }
+    m_points = points;
+    if (getSortQueryPoints())
+    {
+        m_point_order
+            = std::make_shared<const std::vector<unsigned int>>(mortonOrder(m_box, points, n_points));
+    }
+
+    const bool celldim_changed
+        = (m_celldim.x != old_celldim.x) || (m_celldim.y != old_celldim.y) || (m_celldim.z != old_celldim.z);
+    if (celldim_changed || n_points != m_n_points)
+    {
+        computeCellList(points, n_points);
+        return;
+    }
+
+    // Find the points that moved to a different cell.
+    std::vector<unsigned int> new_cells(n_points);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            new_cells[i] = getCell(points[i]);
+        }
+    });
+
+    unsigned int* point_cells = m_point_cells.get();
+    std::vector<unsigned int> moved_points;
+    std::mutex moved_points_mutex;
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> local_moved_points;
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (new_cells[i] != point_cells[i])
+            {
+                local_moved_points.push_back(i);
+            }
+        }
+        const std::lock_guard<std::mutex> lock(moved_points_mutex);
+        moved_points.insert(moved_points.end(), local_moved_points.begin(), local_moved_points.end());
+    });
+
+    // Patching the sorted layout touches every cell between the first and
+    // last affected cell, so once a large fraction of the points has moved a
+    // full rebuild is cheaper.
+    if (moved_points.size() > n_points / 4)
+    {
+        computeCellList(points, n_points);
+        return;
+    }
+
+    // If no point changed cells, the sorted layout only needs new positions.
+    if (moved_points.empty())
+    {
+        gatherSortedPoints(points);
+        return;
+    }
+
+    // The arrivals of each cell, ordered by cell and then by index, and the
+    // sorted list of cells that lost or gained points.
+    std::vector<std::pair<unsigned int, unsigned int>> arrivals;
+    arrivals.reserve(moved_points.size());
+    std::vector<unsigned int> affected_cells;
+    affected_cells.reserve(2 * moved_points.size());
+    for (const unsigned int i : moved_points)
+    {
+        arrivals.emplace_back(new_cells[i], i);
+        affected_cells.push_back(point_cells[i]);
+        affected_cells.push_back(new_cells[i]);
+    }
+    std::sort(arrivals.begin(), arrivals.end());
+    std::sort(affected_cells.begin(), affected_cells.end());
+    affected_cells.erase(std::unique(affected_cells.begin(), affected_cells.end()), affected_cells.end());
+    const size_t n_affected = affected_cells.size();
+
+    // The start of every cell after affected_cells[j - 1] up to and including
+    // affected_cells[j] shifts by shifts[j], the net change in count of the
+    // affected cells before affected_cells[j]. Points
+    // are only moved between cells, so the cells outside of the span of the
+    // affected cells keep their ranges.
+    std::vector<int> shifts(n_affected + 1, 0);
+    for (const unsigned int i : moved_points)
+    {
+        const auto old_it = std::lower_bound(affected_cells.begin(), affected_cells.end(), point_cells[i]);
+        const auto new_it = std::lower_bound(affected_cells.begin(), affected_cells.end(), new_cells[i]);
+        --shifts[old_it - affected_cells.begin() + 1];
+        ++shifts[new_it - affected_cells.begin() + 1];
+    }
+    for (size_t j = 0; j < n_affected; ++j)
+    {
+        shifts[j + 1] += shifts[j];
     }
+
+    // Rewrite the sorted indices of the span in a scratch buffer: each
+    // affected cell merges its remaining points with its arrivals, and the
+    // cells in between copy their ranges to the shifted positions.
+    unsigned int* cell_starts = m_cell_starts.get();
+    unsigned int* sorted_indices = m_sorted_indices.get();
+    const unsigned int span_begin = cell_starts[affected_cells.front()];
+    const unsigned int span_end = cell_starts[affected_cells.back() + 1];
+    std::vector<unsigned int> span_indices(span_end - span_begin);
+    util::forLoopWrapper(0, n_affected, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j)
+        {
+            const unsigned int cell = affected_cells[j];
+            unsigned int* out = span_indices.data() + (cell_starts[cell] + shifts[j] - span_begin);
+            for (unsigned int k = cell_starts[cell]; k < cell_starts[cell + 1]; ++k)
+            {
+                if (new_cells[sorted_indices[k]] == cell)
+                {
+                    *out++ = sorted_indices[k];
+                }
+            }
+            const auto cell_arrivals = std::equal_range(
+                arrivals.begin(), arrivals.end(), std::make_pair(cell, 0U),
+                [](const std::pair<unsigned int, unsigned int>& a,
+                   const std::pair<unsigned int, unsigned int>& b) { return a.first < b.first; });
+            for (auto it = cell_arrivals.first; it != cell_arrivals.second; ++it)
+            {
+                *out++ = it->second;
+            }
+            std::inplace_merge(span_indices.data() + (cell_starts[cell] + shifts[j] - span_begin),
+                               out - (cell_arrivals.second - cell_arrivals.first), out);
+
+            if (j + 1 < n_affected)
+            {
+                const unsigned int gap_begin = cell_starts[cell + 1];
+                const unsigned int gap_end = cell_starts[affected_cells[j + 1]];
+                std::copy(sorted_indices + gap_begin, sorted_indices + gap_end,
+                          span_indices.data() + (gap_begin + shifts[j + 1] - span_begin));
+            }
+        }
+    });
+
+    // Shift the starts of the cells in the span now that the old ranges have
+    // been read, then copy the span back and relink the affected cells.
+    util::forLoopWrapper(1, n_affected, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j)
+        {
+            for (unsigned int cell = affected_cells[j - 1] + 1; cell <= affected_cells[j]; ++cell)
+            {
+                cell_starts[cell] += shifts[j];
+            }
+        }
+    });
+    std::copy(span_indices.begin(), span_indices.end(), sorted_indices + span_begin);
+
+    unsigned int* cell_list = m_cell_list.get();
+    util::forLoopWrapper(0, n_affected, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j)
+        {
+            const unsigned int cell = affected_cells[j];
+            const unsigned int start = cell_starts[cell];
+            const unsigned int stop = cell_starts[cell + 1];
+            cell_list[n_points + cell] = (start == stop) ? LINK_CELL_TERMINATOR : sorted_indices[start];
+            for (unsigned int k = start; k < stop; ++k)
+            {
+                cell_list[sorted_indices[k]] = (k + 1 < stop) ? sorted_indices[k + 1] : LINK_CELL_TERMINATOR;
+            }
+        }
+    });
+
+    util::forLoopWrapper(0, moved_points.size(), [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m)
+        {
+            point_cells[moved_points[m]] = new_cells[moved_points[m]];
+        }
+    });
+
+    gatherSortedPoints(points);
 }
 
 vec3<unsigned int> LinkCell::indexToCoord(unsigned int x) const
 {
-    std::vector<size_t> coord
-        = util::ManagedArray<unsigned int>::getMultiIndex({m_celldim.x, m_celldim.y, m_celldim.z}, x);
-    // For backwards compatibility with the Index1D layout, the indices and
-    // the dimensions are passed in reverse to the indexer. Changing this would
-    // also require updating the logic in IteratorCellShell.
-    return vec3<unsigned int>(coord[2], coord[1], coord[0]);
+    // This is the inverse of coordToIndex, in which x varies fastest.
+    return vec3<unsigned int>(x % m_celldim.x, (x / m_celldim.x) % m_celldim.y,
+                              x / (m_celldim.x * m_celldim.y));
 }
 
 unsigned int LinkCell::coordToIndex(unsigned int x, unsigned int y, unsigned int z) const
 {
-    // For backwards compatibility with the Index1D layout, the indices and
-    // the dimensions are passed in reverse to the indexer. Changing this would
-    // also require updating the logic in IteratorCellShell.
-    return util::ManagedArray<unsigned int>::getIndex(
-        {m_celldim.z, m_celldim.y, m_celldim.x},
-        {static_cast<unsigned int>(z), static_cast<unsigned int>(y), static_cast<unsigned int>(x)});
+    // For backwards compatibility with the Index1D layout, x varies fastest.
+    // Changing this would also require updating the logic in
+    // IteratorCellShell and CellStencil.
+    return (z * m_celldim.y + y) * m_celldim.x + x;
 }
 
 vec3<unsigned int> LinkCell::getCellCoord(const vec3<float>& p) const
@@ -360,131 +680,259 @@ vec3<unsigned int> LinkCell::getCellCoord(const vec3<float>& p) const
     return c;
 }
 
-const std::vector<unsigned int>& LinkCell::getCellNeighbors(unsigned int cell) const
+std::vector<unsigned int> LinkCell::getCellNeighbors(unsigned int cell) const
 {
-    // check if the list of neighbors has been already computed
-    // return the list if it has
-    // otherwise, compute it and return
-    CellNeighbors::const_accessor a;
-    if (m_cell_neighbors.find(a, cell))
+    // Cell lists less than three cells wide reach the same cell through
+    // several offsets, which are only listed once.
+    const vec3<unsigned int> coord = indexToCoord(cell);
+    std::vector<unsigned int> neighbor_cells(m_neighbor_stencil.size());
+    for (unsigned int offset = 0; offset < m_neighbor_stencil.size(); ++offset)
     {
-        return a->second;
+        neighbor_cells[offset] = m_neighbor_stencil.getCell(coord, offset);
     }
-    return computeCellNeighbors(cell);
+    std::sort(neighbor_cells.begin(), neighbor_cells.end());
+    neighbor_cells.erase(std::unique(neighbor_cells.begin(), neighbor_cells.end()), neighbor_cells.end());
+    return neighbor_cells;
 }
 
-const std::vector<unsigned int>& LinkCell::computeCellNeighbors(unsigned int cur_cell) const
+std::shared_ptr<NeighborQueryPerPointIterator>
+LinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const
 {
-    std::vector<unsigned int> neighbor_cells;
-    vec3<unsigned int> l_idx = indexToCoord(cur_cell);
-    const int i = static_cast<int>(l_idx.x);
-    const int j = static_cast<int>(l_idx.y);
-    const int k = static_cast<int>(l_idx.z);
-
-    // loop over the neighbor cells
-    int starti;
-    int startj;
-    int startk;
-    int endi;
-    int endj;
-    int endk;
-    if (m_celldim.x < 3)
-    {
-        starti = i;
-    }
-    else
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::ball)
     {
-        starti = i - 1;
+        return std::make_shared<LinkCellQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
+                                                           args.r_min, args.exclude_ii);
     }
-    if (m_celldim.y < 3)
+    if (args.mode == QueryType::nearest)
     {
-        startj = j;
+        return std::make_shared<LinkCellQueryIterator>(this, query_point, query_point_idx, args.num_neighbors,
+                                                       args.r_max, args.r_min, args.exclude_ii);
     }
-    else
+    throw std::runtime_error("Invalid query mode provided to generic query function.");
+}
+
+void LinkCell::queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end,
+                          QueryArgs args, BondSink& sink) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::nearest)
     {
-        startj = j - 1;
+        queryNearestBatch(query_points, nullptr, begin, end, args, sink);
     }
-    if (m_celldim.z < 3)
+    else if (args.mode == QueryType::ball)
     {
-        startk = k;
+        queryBallBatch(query_points, nullptr, begin, end, args, sink);
     }
     else
     {
-        startk = k - 1;
+        NeighborQuery::queryBatch(query_points, begin, end, args, sink);
     }
+}
 
-    if (m_celldim.x < 2)
-    {
-        endi = i;
-    }
-    else
+void LinkCell::queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                            unsigned int n, QueryArgs args, BondSink& sink) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::nearest)
     {
-        endi = i + 1;
+        queryNearestBatch(query_points, query_point_indices, 0, n, args, sink);
     }
-    if (m_celldim.y < 2)
+    else if (args.mode == QueryType::ball)
     {
-        endj = j;
+        queryBallBatch(query_points, query_point_indices, 0, n, args, sink);
     }
     else
     {
-        endj = j + 1;
-    }
-    if (m_celldim.z < 2)
-    {
-        endk = k;
+        NeighborQuery::queryIndexed(query_points, query_point_indices, n, args, sink);
     }
-    else
+}
+
+void LinkCell::queryBallBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                              unsigned int begin, unsigned int end, const QueryArgs& args,
+                              BondSink& sink) const
+{
+    const float r_max_sq = args.r_max * args.r_max;
+    const float r_min_sq = args.r_min * args.r_min;
+    const bool is2D = m_box.is2D();
+
+    // Search the same shells as LinkCellQueryBallIterator. Once a shell is
+    // wider than the cell list in every dimension no new cells are found, so
+    // the search range can be capped there.
+    const int extra_search_width = (args.r_max == m_cell_width) ? 0 : 1;
+    const unsigned int max_dim = std::max(std::max(m_celldim.x, m_celldim.y), m_celldim.z);
+    unsigned int max_range = 0;
+    while ((max_range <= max_dim / 2)
+           && (static_cast<float>(static_cast<int>(max_range + 1) - extra_search_width) * m_cell_width
+               <= args.r_max))
     {
-        endk = k + 1;
+        ++max_range;
     }
-    if (m_box.is2D())
+    const CellStencil stencil(m_celldim, max_range, is2D);
+
+    const unsigned int* cell_starts = m_cell_starts.get();
+    const unsigned int* sorted_indices = m_sorted_indices.get();
+    std::vector<unsigned int> search_cells;
+    std::vector<unsigned int> candidates;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> r_sq;
+    for (unsigned int k = begin; k < end; ++k)
     {
-        startk = endk = k;
-    }
+        const unsigned int i = (query_point_indices != nullptr) ? query_point_indices[k] : k;
+        const vec3<float> query_point = query_points[i];
+        const vec3<unsigned int> point_cell(getCellCoord(query_point));
+
+        // Small cell lists can map several shell offsets onto the same cell,
+        // so duplicates are removed before searching.
+        search_cells.resize(stencil.size());
+        for (unsigned int offset = 0; offset < stencil.size(); ++offset)
+        {
+            search_cells[offset] = stencil.getCell(point_cell, offset);
+        }
+        std::sort(search_cells.begin(), search_cells.end());
+        search_cells.erase(std::unique(search_cells.begin(), search_cells.end()), search_cells.end());
 
-    for (int neighk = startk; neighk <= endk; neighk++)
-    {
-        for (int neighj = startj; neighj <= endj; neighj++)
+        // Compute the bond vectors to all points in the searched cells so
+        // that they can be wrapped into the box in a single batch.
+        unsigned int n_candidates = 0;
+        for (const unsigned int cell : search_cells)
+        {
+            n_candidates += cell_starts[cell + 1] - cell_starts[cell];
+        }
+        candidates.resize(n_candidates);
+        x.resize(n_candidates);
+        y.resize(n_candidates);
+        z.resize(n_candidates);
+        r_sq.resize(n_candidates);
+        unsigned int offset = 0;
+        for (const unsigned int cell : search_cells)
+        {
+            const unsigned int first = cell_starts[cell];
+            const unsigned int last = cell_starts[cell + 1];
+            std::copy(sorted_indices + first, sorted_indices + last, candidates.begin() + offset);
+            m_sorted_soa_points.computeDifferences(query_point, first, last, x.data() + offset,
+                                                   y.data() + offset, z.data() + offset);
+            offset += last - first;
+        }
+        m_box.wrapBatch(x.data(), y.data(), z.data(), n_candidates);
+        for (unsigned int c = 0; c < n_candidates; ++c)
+        {
+            r_sq[c] = x[c] * x[c] + y[c] * y[c] + z[c] * z[c];
+        }
+
+        for (unsigned int c = 0; c < n_candidates; ++c)
         {
-            for (int neighi = starti; neighi <= endi; neighi++)
+            if (r_sq[c] < r_max_sq && r_sq[c] >= r_min_sq && !(args.exclude_ii && i == candidates[c]))
             {
-                // wrap back into the box
-                unsigned int wrapi = (m_celldim.x + neighi) % m_celldim.x;
-                unsigned int wrapj = (m_celldim.y + neighj) % m_celldim.y;
-                unsigned int wrapk = (m_celldim.z + neighk) % m_celldim.z;
-
-                unsigned int neigh_cell = coordToIndex(wrapi, wrapj, wrapk);
-                // add to the list
-                neighbor_cells.push_back(neigh_cell);
+                sink.emitSquared(i, candidates[c], r_sq[c]);
             }
         }
     }
-
-    // sort the list
-    std::sort(neighbor_cells.begin(), neighbor_cells.end());
-
-    // add the vector of neighbor cells to the hash table
-    CellNeighbors::accessor a;
-    m_cell_neighbors.insert(a, cur_cell);
-    a->second = neighbor_cells;
-    return a->second;
 }
 
-std::shared_ptr<NeighborQueryPerPointIterator>
-LinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const
+void LinkCell::queryNearestBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                                 unsigned int begin, unsigned int end, const QueryArgs& args,
+                                 BondSink& sink) const
 {
-    this->validateQueryArgs(args);
-    if (args.mode == QueryType::ball)
+    if (args.num_neighbors == 0)
     {
-        return std::make_shared<LinkCellQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
-                                                           args.r_min, args.exclude_ii);
+        return;
     }
-    if (args.mode == QueryType::nearest)
+    const float r_max_sq = args.r_max * args.r_max;
+    const float r_min_sq = args.r_min * args.r_min;
+    const bool is2D = m_box.is2D();
+
+    // Search the same shells as LinkCellQueryIterator.
+    const vec3<float> plane_distance = m_box.getNearestPlaneDistance();
+    float min_plane_distance = std::min(plane_distance.x, plane_distance.y);
+    if (!is2D)
     {
-        return std::make_shared<LinkCellQueryIterator>(this, query_point, query_point_idx, args.num_neighbors,
-                                                       args.r_max, args.r_min, args.exclude_ii);
+        min_plane_distance = std::min(min_plane_distance, plane_distance.z);
     }
-    throw std::runtime_error("Invalid query mode provided to generic query function.");
+    const unsigned int max_range
+        = static_cast<unsigned int>(std::ceil(min_plane_distance / (2 * m_cell_width))) + 1;
+    const CellStencil stencil(m_celldim, max_range - 1, is2D);
+
+    const unsigned int* cell_starts = m_cell_starts.get();
+    const unsigned int* sorted_indices = m_sorted_indices.get();
+    NeighborHeap heap(args.num_neighbors);
+    std::vector<unsigned int> searched_cells;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    auto findNearest = [&](unsigned int i, std::vector<NeighborBond>& bonds) {
+        const vec3<float> query_point = query_points[i];
+        const vec3<unsigned int> point_cell(getCellCoord(query_point));
+        searched_cells.clear();
+        for (unsigned int range = 0; range < max_range; ++range)
+        {
+            // Shells that are wider than the cell list visit some cells more
+            // than once.
+            const unsigned int width = 2 * range + 1;
+            const bool may_repeat
+                = width > m_celldim.x || width > m_celldim.y || (!is2D && width > m_celldim.z);
+            for (unsigned int offset = stencil.getShellBegin(range); offset < stencil.getShellEnd(range);
+                 ++offset)
+            {
+                const unsigned int cell = stencil.getCell(point_cell, offset);
+                if (may_repeat
+                    && std::find(searched_cells.begin(), searched_cells.end(), cell) != searched_cells.end())
+                {
+                    continue;
+                }
+                searched_cells.push_back(cell);
+
+                const unsigned int first = cell_starts[cell];
+                const unsigned int last = cell_starts[cell + 1];
+                const unsigned int n_candidates = last - first;
+                if (x.size() < n_candidates)
+                {
+                    x.resize(n_candidates);
+                    y.resize(n_candidates);
+                    z.resize(n_candidates);
+                }
+                m_sorted_soa_points.computeDifferences(query_point, first, last, x.data(), y.data(),
+                                                       z.data());
+                m_box.wrapBatch(x.data(), y.data(), z.data(), n_candidates);
+                for (unsigned int c = 0; c < n_candidates; ++c)
+                {
+                    const float r_sq = x[c] * x[c] + y[c] * y[c] + z[c] * z[c];
+                    const unsigned int j = sorted_indices[first + c];
+                    if (r_sq < r_max_sq && r_sq >= r_min_sq && !(args.exclude_ii && i == j))
+                    {
+                        heap.push(r_sq, j);
+                    }
+                }
+            }
+
+            // All points that have not been searched are at least range cell
+            // widths away.
+            const float searched_distance = static_cast<float>(range) * m_cell_width;
+            if (searched_distance >= args.r_max
+                || (heap.full() && heap.getMaxDistanceSq() < searched_distance * searched_distance))
+            {
+                break;
+            }
+        }
+        heap.appendSorted(i, bonds, sink.squared_distances);
+    };
+
+    if (query_point_indices != nullptr)
+    {
+        for (unsigned int k = begin; k < end; ++k)
+        {
+            findNearest(query_point_indices[k], sink.bonds);
+        }
+        return;
+    }
+
+    // Query points in the same cell search the same cells, so they are
+    // processed together.
+    const std::vector<unsigned int> order = spatialQueryOrder(m_box, query_points, begin, end, m_cell_width);
+    queryInOrder(order, begin, end, sink, findNearest);
 }
 
 NeighborBond LinkCellQueryBallIterator::next()
@@ -500,18 +948,22 @@ NeighborBond LinkCellQueryBallIterator::next()
     // Loop over cell list neighbor shells relative to this point's cell.
     while (true)
     {
-        // Iterate over the particles in that cell. Using a local counter
-        // variable is safe, because the IteratorLinkCell object is keeping
-        // track between calls to next.
-        for (unsigned int j = m_cell_iter.next(); !m_cell_iter.atEnd(); j = m_cell_iter.next())
+        // Scan the particles in that cell. The scan position is a member so
+        // that it is kept between calls to next.
+        const unsigned int* sorted_indices = m_linkcell->getSortedIndices().get();
+        const vec3<float>* sorted_points = m_linkcell->getSortedPoints().get();
+        while (m_cell_pos < m_cell_end)
         {
+            const unsigned int k = m_cell_pos++;
+            const unsigned int j = sorted_indices[k];
+
             // Skip ii matches immediately if requested.
             if (m_exclude_ii && m_query_point_idx == j)
             {
                 continue;
             }
 
-            const vec3<float> r_ij(m_neighbor_query->getBox().wrap((*m_linkcell)[j] - m_query_point));
+            const vec3<float> r_ij(m_neighbor_query->getBox().wrap(sorted_points[k] - m_query_point));
             const float r_sq(dot(r_ij, r_ij));
 
             if (r_sq < r_max_sq && r_sq >= r_min_sq)
@@ -547,7 +999,7 @@ NeighborBond LinkCellQueryBallIterator::next()
                 // This cell has not been searched yet, so we will iterate
                 // over its contents. Otherwise, we loop back, increment
                 // the cell shell iterator, and try the next one.
-                m_cell_iter = m_linkcell->itercell(neighbor_cell_index);
+                setCell(neighbor_cell_index);
                 break;
             }
         }
@@ -583,29 +1035,27 @@ NeighborBond LinkCellQueryIterator::next()
     // Loop over cell list neighbor shells relative to this point's cell.
     if (m_current_neighbors.empty())
     {
+        const unsigned int* sorted_indices = m_linkcell->getSortedIndices().get();
+        const vec3<float>* sorted_points = m_linkcell->getSortedPoints().get();
         // Expand search cell radius until termination conditions are met.
         while (m_neigh_cell_iter != IteratorCellShell(max_range, m_neighbor_query->getBox().is2D()))
         {
-            // Iterate over the particles in that cell. Using a local counter
-            // variable is safe, because the IteratorLinkCell object is keeping
-            // track between calls to next. However, we have to add an extra
-            // check outside to proof ourselves against returning after
-            // previous calls to next that have not yet reset the iterator.
-            if (!m_cell_iter.atEnd())
+            // Scan the particles in that cell.
+            for (; m_cell_pos < m_cell_end; ++m_cell_pos)
             {
-                for (unsigned int j = m_cell_iter.next(); !m_cell_iter.atEnd(); j = m_cell_iter.next())
+                const unsigned int j = sorted_indices[m_cell_pos];
+
+                // Skip ii matches immediately if requested.
+                if (m_exclude_ii && m_query_point_idx == j)
                 {
-                    // Skip ii matches immediately if requested.
-                    if (m_exclude_ii && m_query_point_idx == j)
-                    {
-                        continue;
-                    }
-                    const vec3<float> r_ij(m_neighbor_query->getBox().wrap((*m_linkcell)[j] - m_query_point));
-                    const float r_sq(dot(r_ij, r_ij));
-                    if (r_sq < r_max_sq && r_sq >= r_min_sq)
-                    {
-                        m_current_neighbors.emplace_back(m_query_point_idx, j, std::sqrt(r_sq));
-                    }
+                    continue;
+                }
+                const vec3<float> r_ij(
+                    m_neighbor_query->getBox().wrap(sorted_points[m_cell_pos] - m_query_point));
+                const float r_sq(dot(r_ij, r_ij));
+                if (r_sq < r_max_sq && r_sq >= r_min_sq)
+                {
+                    m_current_neighbors.emplace_back(m_query_point_idx, j, std::sqrt(r_sq));
                 }
             }
 
@@ -629,7 +1079,7 @@ NeighborBond LinkCellQueryIterator::next()
                     // iterate over its contents. Otherwise, we loop back,
                     // increment the cell shell iterator, and try the next
                     // one.
-                    m_cell_iter = m_linkcell->itercell(neighbor_cell_index);
+                    setCell(neighbor_cell_index);
                     break;
                 }
             }
@@ -5,13 +5,14 @@
 #define LINKCELL_H
 
 #include <memory>
-#include <tbb/concurrent_hash_map.h>
+#include <utility>
 #include <unordered_set>
 #include <vector>
 
 #include "Box.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "SoAPoints.h"
 
 /*! \file LinkCell.h
     \brief Build a cell list from a set of points.
@@ -147,6 +148,66 @@ private:
     bool m_is2D;     //!< true if the cell list is 2D
 };
 
+//! Precomputed offsets of the cells within a number of shells of a cell
+/*! The offsets of shells 0 through max_range are listed once, in the order in
+ *  which IteratorCellShell visits them, and the periodic wrap of the cell
+ *  coordinates along each axis is looked up in a table. The cells near any
+ *  cell of a cell list can then be found without modulo operations, heap
+ *  allocations or shared state, so a stencil built once can be used by all
+ *  threads of a query.
+ */
+class CellStencil
+{
+public:
+    //! Null Constructor
+    CellStencil() = default;
+
+    //! Constructor
+    /*! \param celldim The dimensions of the cell list.
+     *  \param max_range The largest shell of the stencil.
+     *  \param is2D Whether the cell list is 2D, in which case the shells are
+     *              only listed in the plane.
+     */
+    CellStencil(const vec3<unsigned int>& celldim, unsigned int max_range, bool is2D);
+
+    //! Get the number of offsets in the stencil
+    unsigned int size() const
+    {
+        return static_cast<unsigned int>(m_offsets.size());
+    }
+
+    //! Get the position of the first offset of a shell
+    unsigned int getShellBegin(unsigned int range) const
+    {
+        return m_shell_starts[range];
+    }
+
+    //! Get one past the position of the last offset of a shell
+    unsigned int getShellEnd(unsigned int range) const
+    {
+        return m_shell_starts[range + 1];
+    }
+
+    //! Get the index of the cell at an offset of the stencil from a cell
+    /*! \param cell The coordinates of the cell, within the cell list.
+     *  \param offset The position of the offset in the stencil.
+     */
+    unsigned int getCell(const vec3<unsigned int>& cell, unsigned int offset) const
+    {
+        const vec3<unsigned int>& delta = m_offsets[offset];
+        return (m_wrap_z[cell.z + delta.z] * m_celldim.y + m_wrap_y[cell.y + delta.y]) * m_celldim.x
+            + m_wrap_x[cell.x + delta.x];
+    }
+
+private:
+    vec3<unsigned int> m_celldim {0, 0, 0};   //!< Dimensions of the cell list
+    std::vector<vec3<unsigned int>> m_offsets; //!< Offsets of all shells, shifted by the largest range
+    std::vector<unsigned int> m_shell_starts; //!< Position of the first offset of each shell
+    std::vector<unsigned int> m_wrap_x;       //!< Wrapped x coordinate of each shifted x coordinate
+    std::vector<unsigned int> m_wrap_y;       //!< Wrapped y coordinate of each shifted y coordinate
+    std::vector<unsigned int> m_wrap_z;       //!< Wrapped z coordinate of each shifted z coordinate
+};
+
 //! Computes a cell id for each particle and a link cell data structure for iterating through it
 /*! For simplicity in only needing a small number of arrays, the link cell
  *  algorithm is used to generate and store the cell list data for particles.
@@ -165,8 +226,12 @@ private:
  *  an arbitrary point.
 
  *  <b>Data structures:</b><br>
- *  The internal data structure used in LinkCell is a linked list of particle
- *  indices. See IteratorLinkCell for information on how to iterate through these.
+ *  Points are sorted by cell with a parallel counting sort. The offset of the
+ *  first point of each cell is stored in a cell starts array, and the indices
+ *  and positions of the points are stored contiguously in cell order, so the
+ *  points of a cell can be scanned linearly. A linked list of particle indices
+ *  is derived from this layout for IteratorLinkCell. See IteratorLinkCell for
+ *  information on how to iterate through it.
 
  *  <b>2D:</b><br>
  *  LinkCell properly handles 2D boxes. When a 2D box is handed to LinkCell,
@@ -209,7 +274,7 @@ public:
         return coordToIndex(c.x, c.y, c.z);
     }
 
-    //! Convert xyz coordinates to a linear index.
+    //! Convert a linear index to xyz coordinates.
     vec3<unsigned int> indexToCoord(unsigned int x) const;
 
     //! Convert xyz coordinates to a linear index.
@@ -224,12 +289,53 @@ public:
         return IteratorLinkCell(m_cell_list, m_n_points, getNumCells(), cell);
     }
 
-    //! Get a list of neighbors to a cell
-    const std::vector<unsigned int>& getCellNeighbors(unsigned int cell) const;
+    //! Get the range of positions in the cell-sorted arrays occupied by a cell
+    std::pair<unsigned int, unsigned int> getCellRange(unsigned int cell) const
+    {
+        const unsigned int* cell_starts = m_cell_starts.get();
+        return {cell_starts[cell], cell_starts[cell + 1]};
+    }
+
+    //! Get the offset of the first point of each cell in the cell-sorted arrays
+    /*! The array has getNumCells() + 1 elements, the last of which is the
+     *  number of points.
+     */
+    const util::ManagedArray<unsigned int>& getCellStarts() const
+    {
+        return m_cell_starts;
+    }
+
+    //! Get the original indices of the points in cell-sorted order
+    const util::ManagedArray<unsigned int>& getSortedIndices() const
+    {
+        return m_sorted_indices;
+    }
+
+    //! Get the positions of the points in cell-sorted order
+    const util::ManagedArray<vec3<float>>& getSortedPoints() const
+    {
+        return m_sorted_points;
+    }
+
+    //! Get a sorted list of the cells adjacent to a cell, including the cell itself
+    std::vector<unsigned int> getCellNeighbors(unsigned int cell) const;
 
     //! Compute the cell list
     void computeCellList(const vec3<float>* points, unsigned int n_points);
 
+    //! Update the cell list for new point positions.
+    /*! Only the cells that points moved out of or into are re-sorted, and the
+     *  cells between them are shifted, so no full sort is needed when few
+     *  points changed cells. The positions are always regathered. The cell
+     *  width is kept fixed. If the new box or number of points changes the
+     *  dimensions of the cell list, the cell list is rebuilt.
+     *
+     *  \param box The box containing the new points.
+     *  \param points The new point coordinates.
+     *  \param n_points The number of points.
+     */
+    void update(const box::Box& box, const vec3<float>* points, unsigned int n_points);
+
     //! Implementation of per-particle query for LinkCell (see NeighborQuery.h for documentation).
     /*! \param query_point The point to find neighbors for.
      *  \param n_query_points The number of query points.
@@ -238,17 +344,63 @@ public:
     std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
 
+    //! Implementation of batched queries for LinkCell (see NeighborQuery.h for documentation).
+    /*! Ball queries loop directly over the cell list without constructing
+     *  per-point iterators, computing the bond vectors to all points of a cell
+     *  at once from the structure-of-arrays copy of the sorted points.
+     *  Nearest neighbor queries search the same cell shells as
+     *  LinkCellQueryIterator, keeping the nearest candidates of each query
+     *  point in a bounded heap, and the query points are processed in cell
+     *  order.
+     */
+    void queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end, QueryArgs args,
+                    BondSink& sink) const override;
+
+    //! Implementation of indexed queries for LinkCell (see NeighborQuery.h for documentation).
+    /*! The query points are searched like in queryBatch, but in the order of
+     *  the list.
+     */
+    void queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                      unsigned int n, QueryArgs args, BondSink& sink) const override;
+
 private:
-    //! Helper function to compute cell neighbors
-    const std::vector<unsigned int>& computeCellNeighbors(unsigned int cell) const;
+    //! Find the neighbors within a ball of a range of query points (see queryBatch)
+    /*! \param query_points The points to find neighbors for.
+     *  \param query_point_indices The indices of the query points to process,
+     *                             or nullptr to process the query points in
+     *                             order of index.
+     *  \param begin The first position to process.
+     *  \param end One past the last position to process.
+     *  \param args The validated query arguments.
+     *  \param sink The destination for the bonds that are found.
+     */
+    void queryBallBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                        unsigned int begin, unsigned int end, const QueryArgs& args, BondSink& sink) const;
+
+    //! Find the nearest neighbors of a range of query points (see queryBallBatch)
+    void queryNearestBatch(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                           unsigned int begin, unsigned int end, const QueryArgs& args, BondSink& sink) const;
+
+    //! Compute the cell dimensions from the current box and cell width
+    void computeCellDimensions();
+
+    //! Sort the points by their cell into the packed cell layout
+    void computeSortedLayout(const vec3<float>* points);
+
+    //! Copy the point positions into the cell-sorted positions array
+    void gatherSortedPoints(const vec3<float>* points);
 
     float m_cell_width {0};                 //!< Minimum necessary cell width cutoff
     vec3<unsigned int> m_celldim {0, 0, 0}; //!< Cell dimensions
     unsigned int m_size {0};                //!< The size of cell list.
 
-    util::ManagedArray<unsigned int> m_cell_list; //!< The cell list last computed
-    using CellNeighbors = tbb::concurrent_hash_map<unsigned int, std::vector<unsigned int>>;
-    mutable CellNeighbors m_cell_neighbors; //!< Hash map of cell neighbors for each cell
+    util::ManagedArray<unsigned int> m_cell_list;      //!< The cell list last computed
+    util::ManagedArray<unsigned int> m_point_cells;    //!< The cell containing each point
+    util::ManagedArray<unsigned int> m_cell_starts;    //!< Offset of each cell in the sorted arrays
+    util::ManagedArray<unsigned int> m_sorted_indices; //!< Point indices sorted by cell
+    util::ManagedArray<vec3<float>> m_sorted_points;   //!< Point positions sorted by cell
+    SoAPoints m_sorted_soa_points;                     //!< Point positions sorted by cell, as arrays
+    CellStencil m_neighbor_stencil;                    //!< Stencil of the cells adjacent to each cell
 };
 
 //! Parent class of LinkCell iterators that knows how to traverse general cell-linked list structures.
@@ -263,18 +415,28 @@ public:
                      unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii)
         : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min,
                                         exclude_ii),
-          m_linkcell(neighbor_query), m_neigh_cell_iter(0, neighbor_query->getBox().is2D()),
-          m_cell_iter(m_linkcell->itercell(m_linkcell->getCell(m_query_point)))
-    {}
+          m_linkcell(neighbor_query), m_neigh_cell_iter(0, neighbor_query->getBox().is2D())
+    {
+        setCell(m_linkcell->getCell(m_query_point));
+    }
 
     //! Empty Destructor
     ~LinkCellIterator() override = default;
 
 protected:
+    //! Start scanning the points of a new cell.
+    void setCell(unsigned int cell)
+    {
+        const std::pair<unsigned int, unsigned int> range = m_linkcell->getCellRange(cell);
+        m_cell_pos = range.first;
+        m_cell_end = range.second;
+    }
+
     const LinkCell* m_linkcell; //!< Link to the LinkCell object
     IteratorCellShell
-        m_neigh_cell_iter;        //!< The shell iterator indicating how far out we're currently searching.
-    IteratorLinkCell m_cell_iter; //!< The cell iterator indicating which cell we're currently searching.
+        m_neigh_cell_iter;       //!< The shell iterator indicating how far out we're currently searching.
+    unsigned int m_cell_pos {0}; //!< Position of the next point to check in the cell-sorted arrays.
+    unsigned int m_cell_end {0}; //!< One past the last position of the current cell in the sorted arrays.
     std::unordered_set<unsigned int>
         m_searched_cells; //!< Set of cells that have already been searched by the cell shell iterator.
 };
@@ -0,0 +1,99 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef MORTON_ORDER_H
+#define MORTON_ORDER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tbb/parallel_sort.h>
+#include <utility>
+#include <vector>
+
+#include "Box.h"
+#include "VectorMath.h"
+#include "utils.h"
+
+/*! \file MortonOrder.h
+    \brief Orders points along a Morton (Z-order) space filling curve.
+*/
+
+namespace freud { namespace locality {
+
+//! Number of bits of each coordinate in a Morton key
+constexpr unsigned int MORTON_BITS = 21;
+
+namespace detail {
+
+//! Spread the lowest MORTON_BITS bits of x so that each is followed by two zero bits
+inline uint64_t spreadBits(uint64_t x)
+{
+    x &= (uint64_t(1) << MORTON_BITS) - 1;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+}
+
+}; // end namespace detail
+
+//! Compute the Morton key of a point
+/*! The fractional coordinates of the point are wrapped into the box and
+ *  quantized to MORTON_BITS bits, which are then interleaved so that points
+ *  with close keys are close in space.
+ *
+ *  \param box The box containing the point.
+ *  \param point The point.
+ *  \returns The Morton key of the point.
+ */
+inline uint64_t mortonKey(const box::Box& box, const vec3<float>& point)
+{
+    constexpr auto num_bins = static_cast<float>(uint64_t(1) << MORTON_BITS);
+    constexpr uint64_t max_bin = (uint64_t(1) << MORTON_BITS) - 1;
+    auto bin = [&](float frac) {
+        const float wrapped = frac - std::floor(frac);
+        return std::min(static_cast<uint64_t>(wrapped * num_bins), max_bin);
+    };
+    const vec3<float> frac = box.makeFractional(point);
+    const uint64_t z = box.is2D() ? 0 : bin(frac.z);
+    return detail::spreadBits(bin(frac.x)) | (detail::spreadBits(bin(frac.y)) << 1)
+        | (detail::spreadBits(z) << 2);
+}
+
+//! Order points along a Morton curve
+/*! The keys are computed and sorted in parallel. Points with equal keys are
+ *  kept in order of index, so the order is deterministic.
+ *
+ *  \param box The box containing the points.
+ *  \param points The points.
+ *  \param n_points The number of points.
+ *  \returns The indices of the points in Morton order.
+ */
+inline std::vector<unsigned int> mortonOrder(const box::Box& box, const vec3<float>* points,
+                                             unsigned int n_points)
+{
+    std::vector<std::pair<uint64_t, unsigned int>> keys(n_points);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            keys[i] = {mortonKey(box, points[i]), static_cast<unsigned int>(i)};
+        }
+    });
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    std::vector<unsigned int> order(n_points);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            order[i] = keys[i].second;
+        }
+    });
+    return order;
+}
+
+}; }; // end namespace freud::locality
+
+#endif // MORTON_ORDER_H
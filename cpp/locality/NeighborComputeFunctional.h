@@ -1,7 +1,9 @@
 #ifndef NEIGHBOR_COMPUTE_FUNCTIONAL_H
 #define NEIGHBOR_COMPUTE_FUNCTIONAL_H
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "AABBQuery.h"
 #include "NeighborList.h"
@@ -15,6 +17,9 @@
 
 namespace freud { namespace locality {
 
+//! Number of query points whose bonds loopOverNeighbors finds in one batched query
+constexpr unsigned int NEIGHBOR_LOOP_BLOCK_SIZE = 256;
+
 //! Make a default NeighborList object to use.
 /*! This function makes a NeighborList from the provided NeighborQuery object
  * if the provided NeighborList is NULL. Otherwise, it simply returns a copy of
@@ -35,24 +40,50 @@ inline vec3<float> bondVector(const NeighborBond& nb, const NeighborQuery* nq,
     return nq->getBox().wrap((*nq)[nb.point_idx] - query_points[nb.query_point_idx]);
 }
 
+//! Compute the in-plane bond vector of a neighbor bond in a 2D box.
+/*! This function gives the same result as bondVector for 2D boxes, but only
+ * wraps the components in the plane. The box of nq must be 2D.
+ */
+inline vec2<float> bondVector2D(const NeighborBond& nb, const NeighborQuery* nq,
+                                const vec3<float>* query_points)
+{
+    const vec3<float> delta = (*nq)[nb.point_idx] - query_points[nb.query_point_idx];
+    return nq->getBox().wrap(vec2<float>(delta.x, delta.y));
+}
+
 //! Implementation of per-point finding logic for NeighborList objects.
 /*! This class provides a concrete implementation of the per-point neighbor
  *  finding interface specified by the NeighborPerPointIterator. In particular,
  *  it includes the logic for finding neighbors within a NeighborList by using
  *  the find_first_index method to initialize a start index and looping over all
  *  neighbors in the NeighborList.
+ *
+ *  If the counts and segments of the NeighborList are up to date, which
+ *  loopOverNeighborsIterator ensures before its loop, the bonds of the query
+ *  point are read directly from its segment, without a search for its first
+ *  bond or a check of the query point index of every bond.
  */
 class NeighborListPerPointIterator : public NeighborPerPointIterator
 {
 public:
     NeighborListPerPointIterator(const NeighborList* nlist, size_t point_index)
-        : NeighborPerPointIterator(point_index), m_nlist(nlist)
+        : NeighborPerPointIterator(point_index), m_bonds(nlist->getBondData())
     {
-        m_current_index = m_nlist->find_first_index(point_index);
-        m_finished = m_current_index == m_nlist->getNumBonds();
+        if (m_bonds.counts != nullptr && point_index < nlist->getNumQueryPoints())
+        {
+            m_current_index = m_bonds.segments[point_index];
+            m_end_index = m_current_index + m_bonds.counts[point_index];
+            m_check_query_point = false;
+        }
+        else
+        {
+            m_current_index = nlist->find_first_index(point_index);
+            m_end_index = nlist->getNumBonds();
+        }
+        m_finished = m_current_index == m_end_index;
         if (!m_finished)
         {
-            m_returned_point_index = m_nlist->getNeighbors()(m_current_index, 0);
+            m_returned_point_index = queryPointIndex(m_current_index);
         }
     }
 
@@ -60,15 +91,14 @@ public:
 
     NeighborBond next() override
     {
-        if (m_current_index == m_nlist->getNumBonds())
+        if (m_current_index == m_end_index)
         {
             m_finished = true;
             return ITERATOR_TERMINATOR;
         }
 
-        NeighborBond nb = NeighborBond(
-            m_nlist->getNeighbors()(m_current_index, 0), m_nlist->getNeighbors()(m_current_index, 1),
-            m_nlist->getDistances()[m_current_index], m_nlist->getWeights()[m_current_index]);
+        NeighborBond nb = NeighborBond(queryPointIndex(m_current_index), m_bonds.pointIndex(m_current_index),
+                                       m_bonds.distance(m_current_index), m_bonds.weight(m_current_index));
         ++m_current_index;
         m_returned_point_index = nb.query_point_idx;
         return nb;
@@ -80,8 +110,19 @@ public:
     }
 
 private:
-    const NeighborList* m_nlist; //! The NeighborList being iterated over.
-    size_t m_current_index;      //! The row of m_nlist where the iterator is currently located.
+    //! Get the query point index of a bond.
+    /*! When the bonds are read from the segment of the query point of this
+     *  iterator, every bond belongs to it.
+     */
+    size_t queryPointIndex(size_t bond) const
+    {
+        return m_check_query_point ? m_bonds.neighbors[2 * bond] : m_query_point_idx;
+    }
+
+    NeighborList::BondData m_bonds;  //! The bond arrays of the NeighborList.
+    size_t m_current_index;          //! The row of the NeighborList where the iterator is currently located.
+    size_t m_end_index;              //! The row at which the iteration stops.
+    bool m_check_query_point {true}; //! Whether bonds past the query point's own may be reached.
     size_t m_returned_point_index {
         0xffffffff}; //! The index of the last returned point (i.e. the value of
                      //! m_nlist.getNeighbors()(m_current_index, 0)). Initialized to an arbitrary sentinel in
@@ -89,6 +130,21 @@ private:
     bool m_finished; //! Flag to indicate that the iterator has been exhausted.
 };
 
+//! The bonds of one query point, as contiguous arrays.
+/*! The arrays hold num_bonds elements each, and the bonds are in the order in
+ *  which they are stored in the NeighborList or found by the query. They
+ *  remain valid until the compute function passed to loopOverNeighborSegments
+ *  returns.
+ */
+struct NeighborSegment
+{
+    size_t query_point_idx;            //!< Index of the query point
+    unsigned int num_bonds;            //!< Number of bonds of the query point
+    const unsigned int* point_indices; //!< Point index of each bond
+    const float* distances;            //!< Distance of each bond
+    const float* weights;              //!< Weight of each bond
+};
+
 //! Wrapper iterating looping over NeighborQuery or NeighborList.
 /*! This function dynamically determines whether or not the provided
  *  NeighborList is valid. If it is, it applies the provide compute function to
@@ -112,15 +168,21 @@ private:
  *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
  * given qargs. \param cf An object with operator(size_t point_index, std::shared_ptr<NeighborIterator>) as
  * input. It should implement iteration logic over the iterator.
+ *  \param parallel If true, run the loop in parallel.
+ *  \param policy How to split the loop over query points among threads.
  */
 template<typename ComputePairType>
 void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
                                unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
-                               const ComputePairType& cf, bool parallel = true)
+                               const ComputePairType& cf, bool parallel = true,
+                               const util::LoopPolicy& policy = util::LoopPolicy())
 {
+    FREUD_PROFILE_SCOPE("bond loop");
     // check if nlist exists
     if (nlist != nullptr)
     {
+        // The iterators read the bonds of each point from its segment.
+        nlist->updateSegmentCounts();
         util::forLoopWrapper(
             0, n_query_points,
             [=](size_t begin, size_t end) {
@@ -131,7 +193,7 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
                     cf(i, niter);
                 }
             },
-            parallel);
+            policy, parallel);
     }
     else
     {
@@ -148,8 +210,125 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
                     cf(i, it);
                 }
             },
-            parallel);
+            policy, parallel);
+    }
+}
+
+//! Wrapper looping over the bonds of each query point as contiguous arrays.
+/*! This function passes the same bonds to the compute function as
+ *  loopOverNeighborsIterator, but without a virtual call and a NeighborBond
+ *  per bond: the compute function receives a NeighborSegment holding the
+ *  point indices, distances and weights of all bonds of a query point, so it
+ *  can loop, or vectorize, over plain arrays.
+ *
+ *  With a NeighborList, the arrays point into the segment of the query point
+ *  whenever the layout of the list stores them contiguously. The point
+ *  indices of the full layout, which are interleaved with the query point
+ *  indices, quantized distances, and the weights of a compact list whose
+ *  weights are all 1 are gathered into buffers that each thread reuses
+ *  across its query points. Without a NeighborList, the bonds of each query
+ *  point are found with the NeighborQuery and gathered into those buffers.
+ *
+ *  \param neighbor_query NeighborQuery object to iterate over.
+ *  \param query_points Query points to perform computation on.
+ *  \param n_query_points Number of query_points.
+ *  \param qargs Query arguments.
+ *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
+ *         given qargs.
+ *  \param cf An object with operator(const NeighborSegment&) as input.
+ *  \param parallel If true, run the loop in parallel.
+ *  \param policy How to split the loop over query points among threads.
+ */
+template<typename ComputeSegmentType>
+void loopOverNeighborSegments(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                              unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
+                              const ComputeSegmentType& cf, bool parallel = true,
+                              const util::LoopPolicy& policy = util::LoopPolicy())
+{
+    FREUD_PROFILE_SCOPE("bond loop");
+    std::shared_ptr<NeighborQueryIterator> iter;
+    NeighborList::BondData bonds {};
+    if (nlist != nullptr)
+    {
+        nlist->updateSegmentCounts();
+        bonds = nlist->getBondData();
+    }
+    else
+    {
+        iter = neighbor_query->query(query_points, n_query_points, qargs);
     }
+
+    util::forLoopWrapper(
+        0, n_query_points,
+        [&](size_t begin, size_t end) {
+            std::vector<unsigned int> point_indices;
+            std::vector<float> distances;
+            std::vector<float> weights;
+            for (size_t i = begin; i != end; ++i)
+            {
+                NeighborSegment segment {i, 0, nullptr, nullptr, nullptr};
+                if (nlist != nullptr && i < nlist->getNumQueryPoints())
+                {
+                    const size_t first_bond = bonds.segments[i];
+                    segment.num_bonds = bonds.counts[i];
+                    if (bonds.point_indices != nullptr)
+                    {
+                        segment.point_indices = bonds.point_indices + first_bond;
+                    }
+                    else
+                    {
+                        point_indices.resize(segment.num_bonds);
+                        for (unsigned int j = 0; j < segment.num_bonds; ++j)
+                        {
+                            point_indices[j] = bonds.neighbors[2 * (first_bond + j) + 1];
+                        }
+                        segment.point_indices = point_indices.data();
+                    }
+                    if (bonds.distances != nullptr)
+                    {
+                        segment.distances = bonds.distances + first_bond;
+                    }
+                    else
+                    {
+                        distances.resize(segment.num_bonds);
+                        for (unsigned int j = 0; j < segment.num_bonds; ++j)
+                        {
+                            distances[j] = bonds.distance(first_bond + j);
+                        }
+                        segment.distances = distances.data();
+                    }
+                    if (bonds.weights != nullptr)
+                    {
+                        segment.weights = bonds.weights + first_bond;
+                    }
+                    else
+                    {
+                        weights.assign(segment.num_bonds, float(1.0));
+                        segment.weights = weights.data();
+                    }
+                }
+                else if (nlist == nullptr)
+                {
+                    point_indices.clear();
+                    distances.clear();
+                    weights.clear();
+                    std::shared_ptr<NeighborQueryPerPointIterator> it = iter->query(i);
+                    for (NeighborBond nb = it->next(); !it->end(); nb = it->next())
+                    {
+                        point_indices.push_back(nb.point_idx);
+                        distances.push_back(nb.distance);
+                        weights.push_back(nb.weight);
+                    }
+                    segment.num_bonds = static_cast<unsigned int>(point_indices.size());
+                    segment.point_indices = point_indices.data();
+                    segment.distances = distances.data();
+                    segment.weights = weights.data();
+                }
+                FREUD_PROFILE_COUNT("bonds", segment.num_bonds);
+                cf(segment);
+            }
+        },
+        policy, parallel);
 }
 
 //! Wrapper iterating looping over NeighborQuery or NeighborList.
@@ -162,9 +341,12 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
  *
  *  This function is designed for computations that can simplify accumulate
  *  over all neighbor pairs. As a result, the provided compute function is
- *  simply applied to all pairs, allowing maximum parallelism. The actual logic
- *  for the NeighborList vs NeighborQuery code paths are handled in helper
- *  functions.
+ *  simply applied to all pairs, allowing maximum parallelism, and the pairs
+ *  are not passed in any particular order. Without a NeighborList, the pairs
+ *  are found with batched queries of blocks of query points and passed to the
+ *  compute function as each block is found, so no NeighborList is built. The
+ *  blocks follow the spatial order of the query points if the NeighborQuery
+ *  sorts query points.
  *
  *  \param neighbor_query NeighborQuery object to iterate over.
  *  \param query_points Query points to perform computation on.
@@ -172,49 +354,109 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
  *  \param qargs Query arguments.
  *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
  * given qargs. \param cf An object with operator(NeighborBond) as input.
+ *  \param parallel If true, run the loop in parallel.
+ *  \param policy How to split the loop over bonds or query points among threads.
+ *  \param squared_distances If true, the distance of each bond passed to
+ *         the compute function is its squared distance, which the ball
+ *         queries find without taking a square root, see BondSink.
  */
 template<typename ComputePairType>
 void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
                        unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
-                       const ComputePairType& cf, bool parallel = true)
+                       const ComputePairType& cf, bool parallel = true,
+                       const util::LoopPolicy& policy = util::LoopPolicy(), bool squared_distances = false)
 {
+    FREUD_PROFILE_SCOPE("bond loop");
     // check if nlist exists
     if (nlist != nullptr)
     {
+        const NeighborList::BondData bonds = nlist->getBondData();
+        if (nlist->isCompact())
+        {
+            // The compact layout has no query point indices, so the loop
+            // runs over the bond segments of the query points.
+            util::forLoopWrapper(
+                0, nlist->getNumQueryPoints(),
+                [=, &cf](size_t begin, size_t end) {
+                    for (size_t i = begin; i != end; ++i)
+                    {
+                        const size_t first_bond = bonds.segments[i];
+                        const size_t last_bond = first_bond + bonds.counts[i];
+                        FREUD_PROFILE_COUNT("bonds", last_bond - first_bond);
+                        for (size_t bond = first_bond; bond != last_bond; ++bond)
+                        {
+                            const float distance = bonds.distance(bond);
+                            const NeighborBond nb(i, bonds.point_indices[bond],
+                                                  squared_distances ? distance * distance : distance,
+                                                  bonds.weight(bond));
+                            cf(nb);
+                        }
+                    }
+                },
+                policy, parallel);
+            return;
+        }
+
+        const unsigned int* neighbors = bonds.neighbors;
+        const float* distances = bonds.distances;
+        const float* weights = bonds.weights;
         util::forLoopWrapper(
             0, nlist->getNumBonds(),
-            [=](size_t begin, size_t end) {
+            [=, &cf](size_t begin, size_t end) {
+                FREUD_PROFILE_COUNT("bonds", end - begin);
                 for (size_t bond = begin; bond != end; ++bond)
                 {
-                    const NeighborBond nb(nlist->getNeighbors()(bond, 0), nlist->getNeighbors()(bond, 1),
-                                          nlist->getDistances()[bond], nlist->getWeights()[bond]);
+                    const float distance = distances[bond];
+                    const NeighborBond nb(neighbors[2 * bond], neighbors[2 * bond + 1],
+                                          squared_distances ? distance * distance : distance, weights[bond]);
                     cf(nb);
                 }
             },
-            parallel);
+            policy, parallel);
     }
     else
     {
-        std::shared_ptr<NeighborQueryIterator> iter
-            = neighbor_query->query(query_points, n_query_points, qargs);
+        // The query validates the arguments and sets up any search structure
+        // that is built on first use.
+        neighbor_query->query(query_points, n_query_points, qargs);
+        const std::shared_ptr<const std::vector<unsigned int>> order
+            = neighbor_query->getQueryOrder(query_points, n_query_points, qargs.region);
 
-        // iterate over the query object in parallel
+        // Find the bonds of blocks of query points with batched queries and
+        // pass them to the compute function while they are in cache. With a
+        // region, the order only holds the query points inside of it.
         util::forLoopWrapper(
-            0, n_query_points,
-            [&iter, &cf](size_t begin, size_t end) {
-                NeighborBond nb;
-                for (size_t i = begin; i != end; ++i)
+            0, order != nullptr ? order->size() : n_query_points,
+            [&](size_t begin, size_t end) {
+                BondSink sink;
+                sink.squared_distances = squared_distances;
+                for (size_t block = begin; block < end; block += NEIGHBOR_LOOP_BLOCK_SIZE)
                 {
-                    std::shared_ptr<NeighborQueryPerPointIterator> it = iter->query(i);
-                    nb = it->next();
-                    while (!it->end())
+                    const auto block_end = static_cast<unsigned int>(
+                        std::min(block + NEIGHBOR_LOOP_BLOCK_SIZE, end));
+                    sink.bonds.clear();
+                    {
+                        FREUD_PROFILE_SCOPE("neighbor query");
+                        if (order != nullptr)
+                        {
+                            neighbor_query->queryIndexed(query_points, order->data() + block,
+                                                         block_end - static_cast<unsigned int>(block), qargs,
+                                                         sink);
+                        }
+                        else
+                        {
+                            neighbor_query->queryBatch(query_points, static_cast<unsigned int>(block),
+                                                       block_end, qargs, sink);
+                        }
+                    }
+                    FREUD_PROFILE_COUNT("bonds", sink.bonds.size());
+                    for (const NeighborBond& nb : sink.bonds)
                     {
                         cf(nb);
-                        nb = it->next();
                     }
                 }
             },
-            parallel);
+            policy, parallel);
     }
 }
 
@@ -0,0 +1,196 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_HEAP_H
+#define NEIGHBOR_HEAP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Box.h"
+#include "NeighborBond.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file NeighborHeap.h
+    \brief Helpers for batched nearest neighbor queries.
+*/
+
+namespace freud { namespace locality {
+
+//! Bounded max-heap of the nearest candidates found for a query point
+/*! The heap holds at most capacity candidates, ordered by squared distance
+ *  and then by point index, so that the candidate that is discarded next is
+ *  always on top. Its storage is allocated once and reused for all query
+ *  points of a batch.
+ */
+class NeighborHeap
+{
+public:
+    //! Constructor
+    /*! \param capacity The number of neighbors to keep.
+     */
+    explicit NeighborHeap(unsigned int capacity) : m_capacity(capacity)
+    {
+        m_candidates.reserve(capacity);
+    }
+
+    //! Remove all candidates
+    void clear()
+    {
+        m_candidates.clear();
+    }
+
+    //! Whether the heap holds capacity candidates
+    bool full() const
+    {
+        return m_candidates.size() >= m_capacity;
+    }
+
+    //! Get the squared distance of the farthest kept candidate
+    /*! Only valid if the heap is not empty.
+     */
+    float getMaxDistanceSq() const
+    {
+        return m_candidates.front().r_sq;
+    }
+
+    //! Offer a candidate, keeping it if it is nearer than the farthest kept candidate
+    void push(float r_sq, unsigned int point_idx)
+    {
+        const Candidate candidate {r_sq, point_idx};
+        if (!full())
+        {
+            m_candidates.push_back(candidate);
+            std::push_heap(m_candidates.begin(), m_candidates.end());
+        }
+        else if (m_capacity != 0 && candidate < m_candidates.front())
+        {
+            std::pop_heap(m_candidates.begin(), m_candidates.end());
+            m_candidates.back() = candidate;
+            std::push_heap(m_candidates.begin(), m_candidates.end());
+        }
+    }
+
+    //! Append the kept candidates as bonds in order of distance and empty the heap
+    /*! \param query_point_idx The index of the query point.
+     *  \param bonds The bonds to append to.
+     *  \param squared_distances Whether the bonds hold squared distances, see BondSink.
+     */
+    void appendSorted(unsigned int query_point_idx, std::vector<NeighborBond>& bonds,
+                      bool squared_distances = false)
+    {
+        std::sort_heap(m_candidates.begin(), m_candidates.end());
+        for (const Candidate& candidate : m_candidates)
+        {
+            bonds.emplace_back(query_point_idx, candidate.point_idx,
+                               squared_distances ? candidate.r_sq : std::sqrt(candidate.r_sq));
+        }
+        m_candidates.clear();
+    }
+
+private:
+    //! A point and its squared distance from the query point
+    struct Candidate
+    {
+        float r_sq;             //!< Squared distance
+        unsigned int point_idx; //!< Point index
+
+        bool operator<(const Candidate& other) const
+        {
+            return r_sq < other.r_sq || (r_sq == other.r_sq && point_idx < other.point_idx);
+        }
+    };
+
+    unsigned int m_capacity;             //!< Number of candidates to keep
+    std::vector<Candidate> m_candidates; //!< Heap of the kept candidates
+};
+
+//! Order a range of query points cell by cell
+/*! The points are binned into cells of about cell_width along each lattice
+ *  direction of the box, and ordered by cell so that consecutive queries
+ *  search overlapping regions.
+ *
+ *  \param box The box of the query.
+ *  \param query_points The query points.
+ *  \param begin The index of the first query point to order.
+ *  \param end One past the index of the last query point to order.
+ *  \param cell_width Approximate width of the cells.
+ *  \returns The indices of the query points in the range in cell order.
+ */
+inline std::vector<unsigned int> spatialQueryOrder(const box::Box& box, const vec3<float>* query_points,
+                                                   unsigned int begin, unsigned int end, float cell_width)
+{
+    // Limit the number of cells per dimension so that cell keys fit the sort
+    // key and degenerate widths still produce an order.
+    constexpr float max_cells = 1024;
+    const vec3<float> plane_distance = box.getNearestPlaneDistance();
+    auto numCells = [&](float length) {
+        const float cells = (cell_width > 0) ? length / cell_width : float(1.0);
+        return static_cast<uint64_t>(std::min(std::max(cells, float(1.0)), max_cells));
+    };
+    const uint64_t nx = numCells(plane_distance.x);
+    const uint64_t ny = numCells(plane_distance.y);
+    const uint64_t nz = box.is2D() ? 1 : numCells(plane_distance.z);
+    auto bin = [](float frac, uint64_t n) {
+        const float wrapped = frac - std::floor(frac);
+        return std::min(static_cast<uint64_t>(wrapped * static_cast<float>(n)), n - 1);
+    };
+
+    std::vector<std::pair<uint64_t, unsigned int>> keys(end - begin);
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        const vec3<float> frac = box.makeFractional(query_points[i]);
+        const uint64_t cell = (bin(frac.z, nz) * ny + bin(frac.y, ny)) * nx + bin(frac.x, nx);
+        keys[i - begin] = {cell, i};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<unsigned int> order(keys.size());
+    std::transform(keys.begin(), keys.end(), order.begin(),
+                   [](const std::pair<uint64_t, unsigned int>& key) { return key.second; });
+    return order;
+}
+
+//! Find the neighbors of a range of query points in a given order
+/*! The bonds of each query point are buffered so that they can be emitted to
+ *  the sink in order of query point index, as required by queryBatch.
+ *
+ *  \param order The indices of the query points in the order to process them.
+ *  \param begin The index of the first query point.
+ *  \param end One past the index of the last query point.
+ *  \param sink The destination for the bonds that are found.
+ *  \param find_neighbors Function (query_point_idx, bonds) that appends the
+ *                        bonds of a query point to bonds, with squared
+ *                        distances if the sink holds squared distances.
+ */
+template<typename FindNeighbors>
+void queryInOrder(const std::vector<unsigned int>& order, unsigned int begin, unsigned int end,
+                  BondSink& sink, const FindNeighbors& find_neighbors)
+{
+    std::vector<NeighborBond> bonds;
+    std::vector<size_t> starts(end - begin);
+    std::vector<size_t> counts(end - begin);
+    for (const unsigned int i : order)
+    {
+        starts[i - begin] = bonds.size();
+        find_neighbors(i, bonds);
+        counts[i - begin] = bonds.size() - starts[i - begin];
+    }
+
+    sink.bonds.reserve(sink.bonds.size() + bonds.size());
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        for (size_t bond = starts[i - begin]; bond < starts[i - begin] + counts[i - begin]; ++bond)
+        {
+            sink.bonds.push_back(bonds[bond]);
+        }
+    }
+}
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_HEAP_H
@@ -2,11 +2,25 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <tbb/parallel_sort.h>
+#include <utility>
 
 #include "NeighborList.h"
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Number of bonds per block of the parallel stream compaction of filters
+constexpr size_t COMPACTION_BLOCK_SIZE = 4096;
+
+}; // end anonymous namespace
+
 NeighborList::NeighborList()
     : m_num_query_points(0), m_num_points(0), m_neighbors({0, 2}), m_distances(0), m_weights(0),
       m_segments_counts_updated(false)
@@ -24,6 +38,23 @@ NeighborList::NeighborList(const NeighborList& other)
     copy(other);
 }
 
+NeighborList& NeighborList::operator=(const NeighborList& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    share(other);
+    std::lock_guard<std::mutex> lock(other.m_lazy_update_mutex);
+    if (other.m_segments_counts_updated)
+    {
+        m_counts = other.m_counts;
+        m_segments = other.m_segments;
+        m_segments_counts_updated = true;
+    }
+    return *this;
+}
+
 NeighborList::NeighborList(unsigned int num_bonds, const unsigned int* query_point_index,
                            unsigned int num_query_points, const unsigned int* point_index,
                            unsigned int num_points, const float* distances, const float* weights)
@@ -55,9 +86,20 @@ NeighborList::NeighborList(unsigned int num_bonds, const unsigned int* query_poi
     }
 }
 
+NeighborList::NeighborList(unsigned int num_query_points, unsigned int num_points,
+                           const util::ManagedArray<unsigned int>& neighbors,
+                           const util::ManagedArray<float>& distances,
+                           const util::ManagedArray<float>& weights,
+                           const util::ManagedArray<unsigned int>& counts,
+                           const util::ManagedArray<unsigned int>& segments)
+    : m_num_query_points(num_query_points), m_num_points(num_points), m_neighbors(neighbors),
+      m_distances(distances), m_weights(weights), m_segments_counts_updated(true), m_counts(counts),
+      m_segments(segments)
+{}
+
 unsigned int NeighborList::getNumBonds() const
 {
-    return m_neighbors.shape()[0];
+    return m_compact ? m_point_indices.size() : m_neighbors.shape()[0];
 }
 
 unsigned int NeighborList::getNumQueryPoints() const
@@ -80,6 +122,11 @@ void NeighborList::setNumBonds(unsigned int num_bonds, unsigned int num_query_po
 
 void NeighborList::updateSegmentCounts() const
 {
+    if (m_segments_counts_updated)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lazy_update_mutex);
     if (!m_segments_counts_updated)
     {
         m_counts.prepare(m_num_query_points);
@@ -113,39 +160,191 @@ void NeighborList::updateSegmentCounts() const
     }
 }
 
-// We are currently assuming that the input iterator has the correct length;
-// however, this is compatible with the original assumptions of this function
-// (pre-iterator syntax), so we'll accept that level of type-safety for now. In
-// the future, if we expose a more appropriate iterator API then we'll need to
-// accept an "end" parameter as well.
-template<typename Iterator> unsigned int NeighborList::filter(Iterator begin)
+void NeighborList::compact(bool quantize_distances)
 {
-    const unsigned int old_size(getNumBonds());
-    const auto end = begin + old_size;
+    // Start from the full layout, so that the distances can be requantized.
+    expandForUpdate();
+    updateSegmentCounts();
+
+    const unsigned int num_bonds = getNumBonds();
+    const unsigned int* neighbors = m_neighbors.get();
+    m_point_indices = util::ManagedArray<unsigned int>(num_bonds);
+    for (unsigned int bond = 0; bond < num_bonds; ++bond)
+    {
+        m_point_indices[bond] = neighbors[2 * bond + 1];
+    }
 
-    // new_size is the number of good (unfiltered-out) elements
-    const unsigned int new_size(std::count(begin, end, true));
+    const float* weights = m_weights.get();
+    m_compact_weights = std::any_of(weights, weights + num_bonds, [](float w) { return w != float(1.0); });
+    if (!m_compact_weights)
+    {
+        m_weights = util::ManagedArray<float>(0);
+    }
 
-    // Arrays to hold filtered data - we use new arrays instead of writing over
-    // existing data to avoid requiring a second pass in resize().
-    auto new_neighbors = util::ManagedArray<unsigned int>({new_size, 2});
-    auto new_distances = util::ManagedArray<float>(new_size);
-    auto new_weights = util::ManagedArray<float>(new_size);
+    m_compact_quantized = quantize_distances;
+    if (quantize_distances)
+    {
+        const float* distances = m_distances.get();
+        const float max_distance = num_bonds == 0 ? 0 : *std::max_element(distances, distances + num_bonds);
+        m_distance_scale = max_distance / float(std::numeric_limits<uint16_t>::max());
+        m_quantized_distances = util::ManagedArray<uint16_t>(num_bonds);
+        for (unsigned int bond = 0; bond < num_bonds; ++bond)
+        {
+            m_quantized_distances[bond] = m_distance_scale == 0
+                ? 0
+                : static_cast<uint16_t>(std::lround(distances[bond] / m_distance_scale));
+        }
+        m_distances = util::ManagedArray<float>(0);
+    }
+
+    m_neighbors = util::ManagedArray<unsigned int>({0, 2});
+    m_compact = true;
+}
+
+void NeighborList::expand() const
+{
+    if (!m_compact)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lazy_update_mutex);
+    if (!m_compact)
+    {
+        return;
+    }
 
-    auto current_element = begin;
-    unsigned int num_good(0);
-    for (unsigned int i(0); i < old_size; ++i)
+    const unsigned int num_bonds = getNumBonds();
+    util::ManagedArray<unsigned int> neighbors({num_bonds, 2});
+    unsigned int* neighbor_data = neighbors.get();
+    for (unsigned int i = 0; i < m_num_query_points; ++i)
     {
-        if (*current_element)
+        const unsigned int first_bond = m_segments[i];
+        for (unsigned int bond = first_bond; bond < first_bond + m_counts[i]; ++bond)
         {
-            new_neighbors(num_good, 0) = m_neighbors(i, 0);
-            new_neighbors(num_good, 1) = m_neighbors(i, 1);
-            new_weights[num_good] = m_weights[i];
-            new_distances[num_good] = m_distances[i];
-            ++num_good;
+            neighbor_data[2 * bond] = i;
+            neighbor_data[2 * bond + 1] = m_point_indices[bond];
         }
-        ++current_element;
     }
+    m_neighbors = neighbors;
+
+    if (m_compact_quantized)
+    {
+        m_distances = util::ManagedArray<float>(num_bonds);
+        for (unsigned int bond = 0; bond < num_bonds; ++bond)
+        {
+            m_distances[bond] = float(m_quantized_distances[bond]) * m_distance_scale;
+        }
+    }
+    if (!m_compact_weights)
+    {
+        m_weights = util::ManagedArray<float>(num_bonds);
+        std::fill(m_weights.get(), m_weights.get() + num_bonds, float(1.0));
+    }
+
+    // The full layout is only used once all of its arrays are written.
+    m_compact = false;
+}
+
+void NeighborList::expandForUpdate()
+{
+    expand();
+    m_point_indices = util::ManagedArray<unsigned int>(0);
+    m_quantized_distances = util::ManagedArray<uint16_t>(0);
+    m_compact_weights = false;
+    m_compact_quantized = false;
+}
+
+size_t NeighborList::getMemoryUsage() const
+{
+    return sizeof(unsigned int) * (m_neighbors.size() + m_counts.size() + m_segments.size())
+        + sizeof(float) * (m_distances.size() + m_weights.size())
+        + sizeof(unsigned int) * m_point_indices.size() + sizeof(uint16_t) * m_quantized_distances.size();
+}
+
+NeighborList::BondData NeighborList::getBondData() const
+{
+    BondData data {};
+    data.distance_scale = m_distance_scale;
+    if (m_compact)
+    {
+        data.point_indices = m_point_indices.get();
+        data.distances = m_compact_quantized ? nullptr : m_distances.get();
+        data.quantized_distances = m_compact_quantized ? m_quantized_distances.get() : nullptr;
+        data.weights = m_compact_weights ? m_weights.get() : nullptr;
+        data.counts = m_counts.get();
+        data.segments = m_segments.get();
+    }
+    else
+    {
+        data.neighbors = m_neighbors.get();
+        data.distances = m_distances.get();
+        data.weights = m_weights.get();
+        if (m_segments_counts_updated)
+        {
+            data.counts = m_counts.get();
+            data.segments = m_segments.get();
+        }
+    }
+    return data;
+}
+
+template<typename Keep> unsigned int NeighborList::compactBonds(const Keep& keep)
+{
+    expandForUpdate();
+    const unsigned int old_size(getNumBonds());
+    const size_t num_blocks = (old_size + COMPACTION_BLOCK_SIZE - 1) / COMPACTION_BLOCK_SIZE;
+
+    // Count the bonds kept in each block, then copy them to offsets given by
+    // a prefix sum over the block counts, which preserves their order.
+    std::vector<unsigned int> block_offsets(num_blocks + 1, 0);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t last_bond = std::min(size_t(old_size), (block + 1) * COMPACTION_BLOCK_SIZE);
+            unsigned int num_kept = 0;
+            for (size_t bond = block * COMPACTION_BLOCK_SIZE; bond < last_bond; ++bond)
+            {
+                num_kept += keep(bond) ? 1 : 0;
+            }
+            block_offsets[block + 1] = num_kept;
+        }
+    });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+    const unsigned int new_size = block_offsets.back();
+
+    // Arrays to hold filtered data - we use new arrays instead of writing over
+    // existing data to avoid requiring a second pass in resize().
+    util::ManagedArray<unsigned int> new_neighbors;
+    new_neighbors.prepareUninitialized({new_size, 2});
+    util::ManagedArray<float> new_distances;
+    new_distances.prepareUninitialized(new_size);
+    util::ManagedArray<float> new_weights;
+    new_weights.prepareUninitialized(new_size);
+
+    const unsigned int* neighbors = m_neighbors.get();
+    const float* distances = m_distances.get();
+    const float* weights = m_weights.get();
+    unsigned int* out_neighbors = new_neighbors.get();
+    float* out_distances = new_distances.get();
+    float* out_weights = new_weights.get();
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t last_bond = std::min(size_t(old_size), (block + 1) * COMPACTION_BLOCK_SIZE);
+            unsigned int out = block_offsets[block];
+            for (size_t bond = block * COMPACTION_BLOCK_SIZE; bond < last_bond; ++bond)
+            {
+                if (keep(bond))
+                {
+                    out_neighbors[2 * out] = neighbors[2 * bond];
+                    out_neighbors[2 * out + 1] = neighbors[2 * bond + 1];
+                    out_distances[out] = distances[bond];
+                    out_weights[out] = weights[bond];
+                    ++out;
+                }
+            }
+        }
+    });
 
     m_neighbors = new_neighbors;
     m_distances = new_distances;
@@ -154,25 +353,262 @@ template<typename Iterator> unsigned int NeighborList::filter(Iterator begin)
     return old_size - new_size;
 }
 
+// We are currently assuming that the input iterator has the correct length;
+// however, this is compatible with the original assumptions of this function
+// (pre-iterator syntax), so we'll accept that level of type-safety for now. In
+// the future, if we expose a more appropriate iterator API then we'll need to
+// accept an "end" parameter as well.
+template<typename Iterator> unsigned int NeighborList::filter(Iterator begin)
+{
+    return compactBonds([begin](size_t bond) { return static_cast<bool>(*(begin + bond)); });
+}
+
 // Explicit template instantiation required for usage in dynamically linked
 // Cython code.
 template unsigned int NeighborList::filter(std::vector<bool>::const_iterator);
 template unsigned int NeighborList::filter(std::vector<bool>::iterator);
 template unsigned int NeighborList::filter(const bool*);
 template unsigned int NeighborList::filter(bool*);
+template unsigned int NeighborList::filter(const char*);
 
 unsigned int NeighborList::filter_r(float r_max, float r_min)
 {
-    std::vector<bool> dist_filter(getNumBonds());
-    for (unsigned int i(0); i < getNumBonds(); ++i)
+    expandForUpdate();
+    const float* distances = m_distances.get();
+    return compactBonds(
+        [=](size_t bond) { return distances[bond] >= r_min && distances[bond] < r_max; });
+}
+
+bool NeighborList::isSortedByPointIndex() const
+{
+    const unsigned int* neighbors = m_neighbors.get();
+    for (unsigned int bond = 1; bond < getNumBonds(); ++bond)
     {
-        dist_filter[i] = (m_distances[i] >= r_min && m_distances[i] < r_max);
+        if (neighbors[2 * bond] == neighbors[2 * bond - 2]
+            && neighbors[2 * bond + 1] < neighbors[2 * bond - 1])
+        {
+            return false;
+        }
     }
-    return filter(dist_filter.cbegin());
+    return true;
+}
+
+void NeighborList::sortByPointIndex()
+{
+    expandForUpdate();
+    updateSegmentCounts();
+    const unsigned int num_bonds = getNumBonds();
+    util::ManagedArray<unsigned int> new_neighbors;
+    new_neighbors.prepareUninitialized({num_bonds, 2});
+    util::ManagedArray<float> new_distances;
+    new_distances.prepareUninitialized(num_bonds);
+    util::ManagedArray<float> new_weights;
+    new_weights.prepareUninitialized(num_bonds);
+
+    const unsigned int* neighbors = m_neighbors.get();
+    const float* distances = m_distances.get();
+    const float* weights = m_weights.get();
+    const unsigned int* counts = m_counts.get();
+    const unsigned int* segments = m_segments.get();
+    unsigned int* out_neighbors = new_neighbors.get();
+    float* out_distances = new_distances.get();
+    float* out_weights = new_weights.get();
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> order;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned int first_bond = segments[i];
+            order.resize(counts[i]);
+            std::iota(order.begin(), order.end(), first_bond);
+            std::stable_sort(order.begin(), order.end(), [=](unsigned int left, unsigned int right) {
+                return neighbors[2 * left + 1] < neighbors[2 * right + 1];
+            });
+            for (unsigned int k = 0; k < counts[i]; ++k)
+            {
+                const unsigned int out = first_bond + k;
+                out_neighbors[2 * out] = neighbors[2 * order[k]];
+                out_neighbors[2 * out + 1] = neighbors[2 * order[k] + 1];
+                out_distances[out] = distances[order[k]];
+                out_weights[out] = weights[order[k]];
+            }
+        }
+    });
+
+    m_neighbors = new_neighbors;
+    m_distances = new_distances;
+    m_weights = new_weights;
+}
+
+void NeighborList::mergeSorted(const NeighborList& other, MergeMode mode)
+{
+    if (other.m_num_query_points != m_num_query_points || other.m_num_points != m_num_points)
+    {
+        throw std::invalid_argument(
+            "NeighborLists must have the same numbers of query points and points to be merged.");
+    }
+    expandForUpdate();
+    other.expand();
+    if (!isSortedByPointIndex())
+    {
+        sortByPointIndex();
+    }
+    if (!other.isSortedByPointIndex())
+    {
+        NeighborList sorted(other);
+        sorted.sortByPointIndex();
+        mergeSorted(sorted, mode);
+        return;
+    }
+    updateSegmentCounts();
+    other.updateSegmentCounts();
+
+    const unsigned int* neighbors = m_neighbors.get();
+    const unsigned int* counts = m_counts.get();
+    const unsigned int* segments = m_segments.get();
+    const unsigned int* other_neighbors = other.m_neighbors.get();
+    const unsigned int* other_counts = other.m_counts.get();
+    const unsigned int* other_segments = other.m_segments.get();
+    const bool unite = mode == MergeMode::unite;
+
+    // Walk the bonds of query point i of both lists in order of point index,
+    // calling emit(from_this, bond) for every bond of the result.
+    const auto merge_query_point = [&](unsigned int i, const auto& emit) {
+        unsigned int bond = counts[i] != 0 ? segments[i] : 0;
+        const unsigned int last_bond = bond + counts[i];
+        unsigned int other_bond = other_counts[i] != 0 ? other_segments[i] : 0;
+        const unsigned int other_last_bond = other_bond + other_counts[i];
+        while (bond < last_bond || other_bond < other_last_bond)
+        {
+            if (other_bond == other_last_bond
+                || (bond < last_bond && neighbors[2 * bond + 1] < other_neighbors[2 * other_bond + 1]))
+            {
+                if (unite)
+                {
+                    emit(true, bond);
+                }
+                ++bond;
+            }
+            else if (bond == last_bond || other_neighbors[2 * other_bond + 1] < neighbors[2 * bond + 1])
+            {
+                if (unite)
+                {
+                    emit(false, other_bond);
+                }
+                ++other_bond;
+            }
+            else
+            {
+                emit(true, bond);
+                ++bond;
+                ++other_bond;
+            }
+        }
+    };
+
+    // Count the bonds of each query point, then write them to offsets given
+    // by a prefix sum over the counts.
+    std::vector<unsigned int> offsets(m_num_query_points + 1, 0);
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            unsigned int count = 0;
+            merge_query_point(i, [&](bool, unsigned int) { ++count; });
+            offsets[i + 1] = count;
+        }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const unsigned int num_bonds = offsets.back();
+
+    util::ManagedArray<unsigned int> new_neighbors;
+    new_neighbors.prepareUninitialized({num_bonds, 2});
+    util::ManagedArray<float> new_distances;
+    new_distances.prepareUninitialized(num_bonds);
+    util::ManagedArray<float> new_weights;
+    new_weights.prepareUninitialized(num_bonds);
+
+    const float* distances = m_distances.get();
+    const float* weights = m_weights.get();
+    const float* other_distances = other.m_distances.get();
+    const float* other_weights = other.m_weights.get();
+    unsigned int* out_neighbors = new_neighbors.get();
+    float* out_distances = new_distances.get();
+    float* out_weights = new_weights.get();
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            unsigned int out = offsets[i];
+            merge_query_point(i, [&](bool from_this, unsigned int bond) {
+                const unsigned int* source = from_this ? neighbors : other_neighbors;
+                out_neighbors[2 * out] = source[2 * bond];
+                out_neighbors[2 * out + 1] = source[2 * bond + 1];
+                out_distances[out] = from_this ? distances[bond] : other_distances[bond];
+                out_weights[out] = from_this ? weights[bond] : other_weights[bond];
+                ++out;
+            });
+        }
+    });
+
+    m_neighbors = new_neighbors;
+    m_distances = new_distances;
+    m_weights = new_weights;
+    m_segments_counts_updated = false;
+}
+
+void NeighborList::symmetrize()
+{
+    if (m_num_query_points != m_num_points)
+    {
+        throw std::invalid_argument("Only NeighborLists of a set of points with itself can be symmetrized.");
+    }
+    expandForUpdate();
+
+    // Sort the reversed bonds by their new query point index and then point
+    // index, and take the union with them.
+    const unsigned int num_bonds = getNumBonds();
+    const unsigned int* neighbors = m_neighbors.get();
+    std::vector<std::pair<uint64_t, unsigned int>> keys(num_bonds);
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            keys[bond] = {(uint64_t(neighbors[2 * bond + 1]) << 32) | neighbors[2 * bond], bond};
+        }
+    });
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    NeighborList reversed;
+    reversed.setNumBonds(num_bonds, m_num_query_points, m_num_points);
+    unsigned int* reversed_neighbors = reversed.m_neighbors.get();
+    float* reversed_distances = reversed.m_distances.get();
+    float* reversed_weights = reversed.m_weights.get();
+    const float* distances = m_distances.get();
+    const float* weights = m_weights.get();
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k)
+        {
+            const unsigned int bond = keys[k].second;
+            reversed_neighbors[2 * k] = neighbors[2 * bond + 1];
+            reversed_neighbors[2 * k + 1] = neighbors[2 * bond];
+            reversed_distances[k] = distances[bond];
+            reversed_weights[k] = weights[bond];
+        }
+    });
+
+    mergeSorted(reversed, MergeMode::unite);
 }
 
 unsigned int NeighborList::find_first_index(unsigned int i) const
 {
+    if (m_compact)
+    {
+        for (unsigned int j = i; j < m_num_query_points; ++j)
+        {
+            if (m_counts[j] != 0)
+            {
+                return m_segments[j];
+            }
+        }
+        return getNumBonds();
+    }
     if (getNumBonds() != 0)
     {
         return bisection_search(i, 0, getNumBonds()) + (i > m_neighbors(0, 0) ? 1 : 0);
@@ -182,6 +618,7 @@ unsigned int NeighborList::find_first_index(unsigned int i) const
 
 void NeighborList::resize(unsigned int num_bonds)
 {
+    expandForUpdate();
     auto new_neighbors = util::ManagedArray<unsigned int>({num_bonds, 2});
     auto new_distances = util::ManagedArray<float>(num_bonds);
     auto new_weights = util::ManagedArray<float>(num_bonds);
@@ -206,11 +643,43 @@ void NeighborList::resize(unsigned int num_bonds)
 
 void NeighborList::copy(const NeighborList& other)
 {
-    setNumBonds(other.getNumBonds(), other.getNumQueryPoints(), other.getNumPoints());
+    // The arrays of the other list must not be updated by its const accessors meanwhile.
+    std::lock_guard<std::mutex> lock(other.m_lazy_update_mutex);
+    m_num_query_points = other.m_num_query_points;
+    m_num_points = other.m_num_points;
     m_neighbors = other.m_neighbors.copy();
     m_weights = other.m_weights.copy();
     m_distances = other.m_distances.copy();
-    m_segments_counts_updated = false;
+    copyCompact(other, true);
+}
+
+void NeighborList::share(const NeighborList& other)
+{
+    std::lock_guard<std::mutex> lock(other.m_lazy_update_mutex);
+    m_num_query_points = other.m_num_query_points;
+    m_num_points = other.m_num_points;
+    m_neighbors = other.m_neighbors;
+    m_weights = other.m_weights;
+    m_distances = other.m_distances;
+    copyCompact(other, false);
+}
+
+void NeighborList::copyCompact(const NeighborList& other, bool deep)
+{
+    m_compact = other.m_compact.load();
+    m_compact_weights = other.m_compact_weights;
+    m_compact_quantized = other.m_compact_quantized;
+    m_distance_scale = other.m_distance_scale;
+    m_point_indices = deep ? other.m_point_indices.copy() : other.m_point_indices;
+    m_quantized_distances = deep ? other.m_quantized_distances.copy() : other.m_quantized_distances;
+
+    // The counts and segments are part of the compact layout.
+    m_segments_counts_updated = m_compact.load();
+    if (m_compact)
+    {
+        m_counts = deep ? other.m_counts.copy() : other.m_counts;
+        m_segments = deep ? other.m_segments.copy() : other.m_segments;
+    }
 }
 
 void NeighborList::validate(unsigned int num_query_points, unsigned int num_points) const
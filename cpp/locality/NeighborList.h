@@ -4,6 +4,9 @@
 #ifndef NEIGHBOR_LIST_H
 #define NEIGHBOR_LIST_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "Box.h"
@@ -13,6 +16,13 @@
 
 namespace freud { namespace locality {
 
+//! How NeighborList::mergeSorted combines the bonds of two NeighborLists
+enum class MergeMode
+{
+    unite,    //!< Keep the bonds found in either list
+    intersect //!< Keep the bonds found in both lists
+};
+
 //! Store a number of near-neighbor bonds from one set of positions
 //  ("query points") to another set ("points")
 /*! A NeighborList object acts as a source of neighbor information for
@@ -23,6 +33,19 @@ namespace freud { namespace locality {
 
     Query point and point indices are stored in a 2D array m_neighbors of shape
     (n_bonds, 2). The distances and weights arrays are flat per-bond arrays.
+
+    <b>Compact layout:</b>
+
+    Since bonds are sorted by query point index, the query point index column
+    is implied by the neighbor counts and segments, which form the offsets of
+    a compressed sparse row layout. After a call to compact, only the point
+    indices are stored per bond, weights are dropped if they are all 1, and
+    distances are optionally quantized to 16 bit fixed point values, reducing
+    the memory per bond from 16 bytes to 4 (point index) plus 2 or 4
+    (distance) bytes. loopOverNeighbors and NeighborListPerPointIterator read
+    the compact layout directly. Any other access to the neighbors, distances
+    or weights arrays, and any modification, converts the list back to the
+    full layout first.
  */
 class NeighborList
 {
@@ -33,10 +56,21 @@ public:
     explicit NeighborList(unsigned int num_bonds);
     //! Copy constructor (makes a deep copy)
     NeighborList(const NeighborList& other);
+    //! Copy assignment (shares the arrays of the other NeighborList, like a memberwise copy)
+    NeighborList& operator=(const NeighborList& other);
     //! Construct from arrays
     NeighborList(unsigned int num_bonds, const unsigned int* query_point_index, unsigned int num_query_points,
                  const unsigned int* point_index, unsigned int num_points, const float* distances,
                  const float* weights);
+    //! Construct from existing arrays without copying them
+    /*! The counts and segments must be consistent with the neighbors, as
+     *  computed by updateSegmentCounts.
+     */
+    NeighborList(unsigned int num_query_points, unsigned int num_points,
+                 const util::ManagedArray<unsigned int>& neighbors,
+                 const util::ManagedArray<float>& distances, const util::ManagedArray<float>& weights,
+                 const util::ManagedArray<unsigned int>& counts,
+                 const util::ManagedArray<unsigned int>& segments);
 
     //! Return the number of bonds stored in this NeighborList
     unsigned int getNumBonds() const;
@@ -48,21 +82,27 @@ public:
     //! Set the number of bonds, query points, and points for this NeighborList object
     void setNumBonds(unsigned int num_bonds, unsigned int num_query_points, unsigned int num_points);
     //! Update the arrays of neighbor counts and segments
+    /*! This is called lazily through const accessors, so concurrent calls
+     *  are serialized and the arrays are only written by the first of them.
+     */
     void updateSegmentCounts() const;
 
     //! Access the neighbors array for reading and writing
     util::ManagedArray<unsigned int>& getNeighbors()
     {
+        expand();
         return m_neighbors;
     }
     //! Access the distances array for reading and writing
     util::ManagedArray<float>& getDistances()
     {
+        expand();
         return m_distances;
     }
     //! Access the weights array for reading and writing
     util::ManagedArray<float>& getWeights()
     {
+        expand();
         return m_weights;
     }
     //! Access the counts array for reading
@@ -81,16 +121,19 @@ public:
     //! Access the neighbors array for reading
     const util::ManagedArray<unsigned int>& getNeighbors() const
     {
+        expand();
         return m_neighbors;
     }
     //! Access the distances array for reading
     const util::ManagedArray<float>& getDistances() const
     {
+        expand();
         return m_distances;
     }
     //! Access the weights array for reading
     const util::ManagedArray<float>& getWeights() const
     {
+        expand();
         return m_weights;
     }
     //! Access the counts array for reading
@@ -106,6 +149,65 @@ public:
         return m_segments;
     }
 
+    //! Convert the bonds to the compact layout.
+    /*! \param quantize_distances Whether to store distances as 16 bit fixed
+     *         point values in units of the largest distance divided by 65535,
+     *         which bounds the error of each distance by half that unit.
+     */
+    void compact(bool quantize_distances = false);
+    //! Convert the bonds back to the full layout.
+    /*! Like updateSegmentCounts, this may be called through const accessors
+     *  by several threads, so the conversion is serialized. The arrays of the
+     *  compact layout are kept until the NeighborList is next modified, so
+     *  that loops over the bond data of the compact layout which are still
+     *  running on other threads remain valid.
+     */
+    void expand() const;
+    //! Return whether the bonds are stored in the compact layout
+    bool isCompact() const
+    {
+        return m_compact;
+    }
+    //! Return the number of bytes used to store the bonds and segments
+    size_t getMemoryUsage() const;
+
+    //! Read-only access to the bonds in either layout for loops over bonds.
+    /*! In the compact layout, point_indices holds the point index of each
+     *  bond and the query point indices are given by the counts and segments.
+     *  In the full layout, the counts and segments are set if they are up to
+     *  date, see updateSegmentCounts. Exactly one of distances and
+     *  quantized_distances is set, and weights is null if all weights are 1.
+     */
+    struct BondData
+    {
+        const unsigned int* neighbors;       //!< Index pairs of the full layout, or null
+        const unsigned int* point_indices;   //!< Point indices of the compact layout, or null
+        const float* distances;              //!< Distances, or null if quantized
+        const uint16_t* quantized_distances; //!< Quantized distances, or null
+        float distance_scale;                //!< Distance of a quantized distance of 1
+        const float* weights;                //!< Weights, or null if all are 1
+        const unsigned int* counts;          //!< Neighbor counts, or null if not up to date
+        const unsigned int* segments;        //!< Segments, or null if not up to date
+
+        //! Get the point index of a bond.
+        unsigned int pointIndex(size_t bond) const
+        {
+            return point_indices != nullptr ? point_indices[bond] : neighbors[2 * bond + 1];
+        }
+        //! Get the distance of a bond.
+        float distance(size_t bond) const
+        {
+            return distances != nullptr ? distances[bond] : float(quantized_distances[bond]) * distance_scale;
+        }
+        //! Get the weight of a bond.
+        float weight(size_t bond) const
+        {
+            return weights != nullptr ? weights[bond] : float(1.0);
+        }
+    };
+    //! Get the bond arrays without converting the layout.
+    BondData getBondData() const;
+
     //! Remove bonds in this object based on an array of boolean values. The
     //  array must be at least as long as the number of neighbor bonds.
     //  Returns the number of bonds removed.
@@ -113,6 +215,47 @@ public:
     //! Remove bonds in this object based on minimum and maximum distance
     //  constraints. Returns the number of bonds removed.
     unsigned int filter_r(float r_max, float r_min = 0);
+    //! Remove bonds for which a predicate is false.
+    /*! The predicate is evaluated for all bonds in parallel, so it must be
+     *  safe to call concurrently. The bonds that are kept stay in order.
+     *
+     *  \param keep Callable taking a NeighborBond and returning whether to keep it.
+     *  \returns The number of bonds removed.
+     */
+    template<typename Predicate> unsigned int filter_if(const Predicate& keep)
+    {
+        expand();
+        std::vector<char> mask(getNumBonds());
+        const unsigned int* neighbors = m_neighbors.get();
+        const float* distances = m_distances.get();
+        const float* weights = m_weights.get();
+        util::forLoopWrapper(0, mask.size(), [&](size_t begin, size_t end) {
+            for (size_t bond = begin; bond < end; ++bond)
+            {
+                mask[bond] = static_cast<char>(keep(NeighborBond(neighbors[2 * bond], neighbors[2 * bond + 1],
+                                                                 distances[bond], weights[bond])));
+            }
+        });
+        return filter(static_cast<const char*>(mask.data()));
+    }
+
+    //! Combine the bonds of this object with those of another NeighborList.
+    /*! Both lists must have the same numbers of query points and points. The
+     *  bonds of each query point of the result are sorted by point index.
+     *  Bonds present in both lists are taken from this list. Lists whose
+     *  bonds are not sorted by point index (such as lists sorted by
+     *  distance) are sorted first.
+     *
+     *  \param other The NeighborList to combine with.
+     *  \param mode Whether to keep the bonds found in either or in both lists.
+     */
+    void mergeSorted(const NeighborList& other, MergeMode mode);
+    //! Add the reverse of every bond whose reverse is missing.
+    /*! The query points and points must be the same set of points. Added
+     *  bonds copy the distance and weight of the bond they reverse, and the
+     *  bonds of each query point of the result are sorted by point index.
+     */
+    void symmetrize();
 
     //! Return the first bond index corresponding to point i
     unsigned int find_first_index(unsigned int i) const;
@@ -122,11 +265,24 @@ public:
 
     //! Copy the bonds from another NeighborList object
     void copy(const NeighborList& other);
+    //! Share the bond arrays of another NeighborList object without copying them
+    void share(const NeighborList& other);
     //! Throw a runtime_error if num_points and num_query_points do not match
     //  the stored value
     void validate(unsigned int num_query_points, unsigned int num_points) const;
 
 private:
+    //! Copy or share the compact layout of another NeighborList object
+    void copyCompact(const NeighborList& other, bool deep);
+    //! Convert the bonds to the full layout before modifying them, releasing the compact layout
+    void expandForUpdate();
+    //! Remove the bonds for which keep(bond index) is false, preserving their order.
+    template<typename Keep> unsigned int compactBonds(const Keep& keep);
+    //! Check whether the bonds of each query point are sorted by point index
+    bool isSortedByPointIndex() const;
+    //! Sort the bonds of each query point by point index
+    void sortByPointIndex();
+
     //! Helper method for bisection search of the neighbor list, used in find_first_index
     unsigned int bisection_search(unsigned int val, unsigned int left, unsigned int right) const;
 
@@ -134,19 +290,39 @@ private:
     unsigned int m_num_query_points;
     //! Number of points
     unsigned int m_num_points;
+    // The bond arrays are mutable because const accessors may convert the
+    // compact layout back to the full layout. The flags of the lazy updates
+    // are atomic so that the arrays can be read without taking the lock once
+    // they are up to date.
+
     //! Neighbor list indices array
-    util::ManagedArray<unsigned int> m_neighbors;
+    mutable util::ManagedArray<unsigned int> m_neighbors;
     //! Neighbor list per-bond distance array
-    util::ManagedArray<float> m_distances;
+    mutable util::ManagedArray<float> m_distances;
     //! Neighbor list per-bond weight array
-    util::ManagedArray<float> m_weights;
+    mutable util::ManagedArray<float> m_weights;
 
+    //! Serializes the lazy updates of the const accessors
+    mutable std::mutex m_lazy_update_mutex;
     //! Track whether segments and counts are up to date
-    mutable bool m_segments_counts_updated;
+    mutable std::atomic<bool> m_segments_counts_updated;
     //! Neighbor counts for each query point
     mutable util::ManagedArray<unsigned int> m_counts;
     //! Neighbor segments for each query point
     mutable util::ManagedArray<unsigned int> m_segments;
+
+    //! Whether the bonds are stored in the compact layout
+    mutable std::atomic<bool> m_compact {false};
+    //! Point indices of the compact layout
+    mutable util::ManagedArray<unsigned int> m_point_indices;
+    //! Quantized distances of the compact layout, empty unless distances are quantized
+    mutable util::ManagedArray<uint16_t> m_quantized_distances;
+    //! Distance of a quantized distance of 1
+    mutable float m_distance_scale {0};
+    //! Whether the compact layout stores weights
+    mutable bool m_compact_weights {false};
+    //! Whether the compact layout stores quantized distances
+    mutable bool m_compact_quantized {false};
 };
 
 bool compareNeighborBond(const NeighborBond& left, const NeighborBond& right);
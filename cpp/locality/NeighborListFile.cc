@@ -0,0 +1,409 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "NeighborListFile.h"
+
+/*! \file NeighborListFile.cc
+    \brief Binary files of neighbor lists that can be memory mapped.
+*/
+
+namespace freud { namespace locality {
+
+namespace {
+
+//! Signature at the start of every neighbor list file
+constexpr char FILE_MAGIC[8] = "FREUDNL";
+
+//! Current version of the file format
+constexpr uint32_t FILE_VERSION = 1;
+
+//! Value of the byte order marker
+constexpr uint32_t FILE_BYTE_ORDER = 0x01020304;
+
+//! Size of the blocks copied from the temporary files
+constexpr size_t COPY_BLOCK_BYTES = size_t(1) << 20;
+
+//! Round a file offset up to the alignment of the arrays.
+uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + NEIGHBOR_LIST_FILE_ALIGNMENT - 1) / NEIGHBOR_LIST_FILE_ALIGNMENT
+        * NEIGHBOR_LIST_FILE_ALIGNMENT;
+}
+
+//! Get the position in a file as a 64 bit offset.
+uint64_t tellFile(std::FILE* file)
+{
+#if defined _WIN32
+    return _ftelli64(file);
+#else
+    return ftello(file);
+#endif
+}
+
+//! Seek to a 64 bit offset in a file.
+void seekFile(std::FILE* file, uint64_t offset, const std::string& filename)
+{
+#if defined _WIN32
+    const int result = _fseeki64(file, offset, SEEK_SET);
+#else
+    const int result = fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+    if (result != 0)
+    {
+        throw std::runtime_error("Failed to seek in neighbor list file " + filename + ".");
+    }
+}
+
+//! Get the size of a file in bytes, leaving the position at the start of the file.
+uint64_t getFileSize(std::FILE* file, const std::string& filename)
+{
+#if defined _WIN32
+    const int result = _fseeki64(file, 0, SEEK_END);
+#else
+    const int result = fseeko(file, 0, SEEK_END);
+#endif
+    if (result != 0)
+    {
+        throw std::runtime_error("Failed to seek in neighbor list file " + filename + ".");
+    }
+    const uint64_t size = tellFile(file);
+    seekFile(file, 0, filename);
+    return size;
+}
+
+//! Write bytes to a file.
+void writeBytes(std::FILE* file, const void* data, size_t bytes, const std::string& filename)
+{
+    if (bytes != 0 && std::fwrite(data, 1, bytes, file) != bytes)
+    {
+        throw std::runtime_error("Failed to write neighbor list file " + filename + ".");
+    }
+}
+
+//! Pad a file with zeros up to the alignment of the arrays, returning the new offset.
+uint64_t padFile(std::FILE* file, const std::string& filename)
+{
+    const char zeros[NEIGHBOR_LIST_FILE_ALIGNMENT] = {};
+    const uint64_t offset = tellFile(file);
+    const uint64_t aligned = alignOffset(offset);
+    writeBytes(file, zeros, aligned - offset, filename);
+    return aligned;
+}
+
+//! Append the contents of a temporary file to a file.
+void appendFile(std::FILE* file, std::FILE* source, const std::string& filename)
+{
+    std::rewind(source);
+    std::vector<char> buffer(COPY_BLOCK_BYTES);
+    size_t bytes;
+    while ((bytes = std::fread(buffer.data(), 1, buffer.size(), source)) != 0)
+    {
+        writeBytes(file, buffer.data(), bytes, filename);
+    }
+    if (std::ferror(source) != 0)
+    {
+        throw std::runtime_error("Failed to read temporary file of neighbor list file " + filename + ".");
+    }
+}
+
+//! Open a file, throwing on failure.
+std::FILE* openFile(const std::string& filename, const char* mode)
+{
+    std::FILE* file = std::fopen(filename.c_str(), mode);
+    if (file == nullptr)
+    {
+        throw std::runtime_error("Failed to open neighbor list file " + filename + ".");
+    }
+    return file;
+}
+
+//! Check that a header describes a valid file of the given size.
+void validateHeader(const NeighborListFileHeader& header, uint64_t file_size, const std::string& filename)
+{
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+    {
+        throw std::runtime_error(filename + " is not a neighbor list file.");
+    }
+    if (header.version != FILE_VERSION)
+    {
+        throw std::runtime_error("Neighbor list file " + filename + " has an unsupported version.");
+    }
+    if (header.byte_order != FILE_BYTE_ORDER)
+    {
+        throw std::runtime_error("Neighbor list file " + filename
+                                 + " was written on a machine with a different byte order.");
+    }
+    const uint64_t bond_bytes = header.num_bonds * sizeof(float);
+    const uint64_t point_bytes = uint64_t(header.num_query_points) * sizeof(unsigned int);
+    if (header.file_size != file_size || header.neighbors_offset + 2 * bond_bytes > file_size
+        || header.distances_offset + bond_bytes > file_size || header.weights_offset + bond_bytes > file_size
+        || header.counts_offset + point_bytes > file_size || header.segments_offset + point_bytes > file_size)
+    {
+        throw std::runtime_error("Neighbor list file " + filename + " is truncated or corrupt.");
+    }
+}
+
+//! Create a NeighborList from the arrays of a file held in memory owned by another object.
+NeighborList* makeNeighborList(const NeighborListFileHeader& header, char* data,
+                               const std::shared_ptr<void>& owner)
+{
+    const size_t num_bonds = header.num_bonds;
+    const size_t num_query_points = header.num_query_points;
+    return new NeighborList(
+        header.num_query_points, header.num_points,
+        util::ManagedArray<unsigned int>::wrap(
+            reinterpret_cast<unsigned int*>(data + header.neighbors_offset), {num_bonds, 2}, owner),
+        util::ManagedArray<float>::wrap(reinterpret_cast<float*>(data + header.distances_offset),
+                                        {num_bonds}, owner),
+        util::ManagedArray<float>::wrap(reinterpret_cast<float*>(data + header.weights_offset), {num_bonds},
+                                        owner),
+        util::ManagedArray<unsigned int>::wrap(reinterpret_cast<unsigned int*>(data + header.counts_offset),
+                                               {num_query_points}, owner),
+        util::ManagedArray<unsigned int>::wrap(
+            reinterpret_cast<unsigned int*>(data + header.segments_offset), {num_query_points}, owner));
+}
+
+}; // end anonymous namespace
+
+NeighborListWriter::NeighborListWriter(const std::string& filename, unsigned int num_query_points,
+                                       unsigned int num_points)
+    : m_filename(filename), m_file(nullptr), m_distances_file(nullptr), m_weights_file(nullptr),
+      m_num_query_points(num_query_points), m_num_points(num_points), m_counts(num_query_points, 0)
+{
+    try
+    {
+        m_file = openFile(m_filename, "wb");
+        m_distances_file = openFile(m_filename + ".distances.tmp", "w+b");
+        m_weights_file = openFile(m_filename + ".weights.tmp", "w+b");
+
+        // Reserve the header, which is written once all offsets are known.
+        const char zeros[sizeof(NeighborListFileHeader)] = {};
+        writeBytes(m_file, zeros, sizeof(zeros), m_filename);
+        padFile(m_file, m_filename);
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+}
+
+NeighborListWriter::~NeighborListWriter()
+{
+    if (m_file != nullptr)
+    {
+        discard();
+    }
+}
+
+void NeighborListWriter::discard()
+{
+    for (std::FILE* file : {m_file, m_distances_file, m_weights_file})
+    {
+        if (file != nullptr)
+        {
+            std::fclose(file);
+        }
+    }
+    if (m_file != nullptr)
+    {
+        std::remove(m_filename.c_str());
+    }
+    if (m_distances_file != nullptr)
+    {
+        std::remove((m_filename + ".distances.tmp").c_str());
+    }
+    if (m_weights_file != nullptr)
+    {
+        std::remove((m_filename + ".weights.tmp").c_str());
+    }
+    m_file = m_distances_file = m_weights_file = nullptr;
+}
+
+void NeighborListWriter::append(unsigned int num_bonds, const unsigned int* neighbors, const float* distances,
+                                const float* weights)
+{
+    if (m_file == nullptr)
+    {
+        throw std::runtime_error("Cannot append to a closed neighbor list file.");
+    }
+    if (m_num_bonds + num_bonds > std::numeric_limits<unsigned int>::max())
+    {
+        throw std::overflow_error("Neighbor lists are limited to 2^32 - 1 bonds.");
+    }
+    for (unsigned int bond = 0; bond < num_bonds; ++bond)
+    {
+        const unsigned int query_point_idx = neighbors[2 * bond];
+        if (query_point_idx < m_last_query_point)
+        {
+            throw std::invalid_argument("Bonds must be appended in order of query point index.");
+        }
+        if (query_point_idx >= m_num_query_points)
+        {
+            throw std::invalid_argument("Query point indices must be less than num_query_points.");
+        }
+        if (neighbors[2 * bond + 1] >= m_num_points)
+        {
+            throw std::invalid_argument("Point indices must be less than num_points.");
+        }
+        ++m_counts[query_point_idx];
+        m_last_query_point = query_point_idx;
+    }
+    writeBytes(m_file, neighbors, 2 * sizeof(unsigned int) * num_bonds, m_filename);
+    writeBytes(m_distances_file, distances, sizeof(float) * num_bonds, m_filename);
+    writeBytes(m_weights_file, weights, sizeof(float) * num_bonds, m_filename);
+    m_num_bonds += num_bonds;
+}
+
+void NeighborListWriter::append(const std::vector<NeighborBond>& bonds)
+{
+    std::vector<unsigned int> neighbors(2 * bonds.size());
+    std::vector<float> distances(bonds.size());
+    std::vector<float> weights(bonds.size());
+    for (size_t bond = 0; bond < bonds.size(); ++bond)
+    {
+        neighbors[2 * bond] = bonds[bond].query_point_idx;
+        neighbors[2 * bond + 1] = bonds[bond].point_idx;
+        distances[bond] = bonds[bond].distance;
+        weights[bond] = bonds[bond].weight;
+    }
+    append(bonds.size(), neighbors.data(), distances.data(), weights.data());
+}
+
+void NeighborListWriter::close()
+{
+    if (m_file == nullptr)
+    {
+        throw std::runtime_error("The neighbor list file is already closed.");
+    }
+    try
+    {
+        NeighborListFileHeader header {};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.byte_order = FILE_BYTE_ORDER;
+        header.num_bonds = m_num_bonds;
+        header.num_query_points = m_num_query_points;
+        header.num_points = m_num_points;
+        header.neighbors_offset = alignOffset(sizeof(NeighborListFileHeader));
+
+        header.distances_offset = padFile(m_file, m_filename);
+        appendFile(m_file, m_distances_file, m_filename);
+        header.weights_offset = padFile(m_file, m_filename);
+        appendFile(m_file, m_weights_file, m_filename);
+
+        // Segments follow the convention of NeighborList::updateSegmentCounts,
+        // which leaves the segments of query points without bonds at zero.
+        std::vector<unsigned int> segments(m_num_query_points, 0);
+        unsigned int first_bond = 0;
+        for (unsigned int i = 0; i < m_num_query_points; ++i)
+        {
+            if (m_counts[i] != 0)
+            {
+                segments[i] = first_bond;
+            }
+            first_bond += m_counts[i];
+        }
+        header.counts_offset = padFile(m_file, m_filename);
+        writeBytes(m_file, m_counts.data(), sizeof(unsigned int) * m_counts.size(), m_filename);
+        header.segments_offset = padFile(m_file, m_filename);
+        writeBytes(m_file, segments.data(), sizeof(unsigned int) * segments.size(), m_filename);
+        header.file_size = tellFile(m_file);
+
+        seekFile(m_file, 0, m_filename);
+        writeBytes(m_file, &header, sizeof(header), m_filename);
+        if (std::fclose(m_file) != 0)
+        {
+            m_file = nullptr;
+            throw std::runtime_error("Failed to write neighbor list file " + m_filename + ".");
+        }
+        m_file = nullptr;
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+    discard();
+}
+
+void writeNeighborList(const NeighborList& nlist, const std::string& filename)
+{
+    NeighborListWriter writer(filename, nlist.getNumQueryPoints(), nlist.getNumPoints());
+    writer.append(nlist.getNumBonds(), nlist.getNeighbors().get(), nlist.getDistances().get(),
+                  nlist.getWeights().get());
+    writer.close();
+}
+
+NeighborList* readNeighborList(const std::string& filename)
+{
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(openFile(filename, "rb"), &std::fclose);
+    const uint64_t file_size = getFileSize(file.get(), filename);
+
+    NeighborListFileHeader header {};
+    if (file_size < sizeof(header) || std::fread(&header, sizeof(header), 1, file.get()) != 1)
+    {
+        throw std::runtime_error(filename + " is not a neighbor list file.");
+    }
+    validateHeader(header, file_size, filename);
+
+    // The whole file is read into one buffer so that the arrays can share it.
+    std::shared_ptr<char> data(new char[file_size], std::default_delete<char[]>());
+    std::rewind(file.get());
+    if (std::fread(data.get(), 1, file_size, file.get()) != file_size)
+    {
+        throw std::runtime_error("Failed to read neighbor list file " + filename + ".");
+    }
+    return makeNeighborList(header, data.get(), data);
+}
+
+NeighborList* mapNeighborList(const std::string& filename)
+{
+#if defined _WIN32
+    return readNeighborList(filename);
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to open neighbor list file " + filename + ".");
+    }
+    struct stat status
+    {};
+    if (::fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(NeighborListFileHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error(filename + " is not a neighbor list file.");
+    }
+    const size_t file_size = status.st_size;
+
+    // A private writable mapping lets the arrays be modified like any other
+    // NeighborList (copy on write) without ever changing the file.
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map neighbor list file " + filename + ".");
+    }
+    std::shared_ptr<char> data(static_cast<char*>(mapping),
+                               [file_size](char* address) { ::munmap(address, file_size); });
+
+    NeighborListFileHeader header {};
+    std::memcpy(&header, data.get(), sizeof(header));
+    validateHeader(header, file_size, filename);
+    return makeNeighborList(header, data.get(), data);
+#endif
+}
+
+}; }; // end namespace freud::locality
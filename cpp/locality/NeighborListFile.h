@@ -0,0 +1,128 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_LIST_FILE_H
+#define NEIGHBOR_LIST_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "NeighborBond.h"
+#include "NeighborList.h"
+
+/*! \file NeighborListFile.h
+    \brief Binary files of neighbor lists that can be memory mapped.
+
+    A file starts with a NeighborListFileHeader, followed by the arrays of the
+    NeighborList in its in-memory layout: the (num_bonds, 2) neighbors array,
+    the distances and the weights, and the CSR arrays of neighbor counts and
+    segments of the query points. Every array starts at a multiple of
+    NEIGHBOR_LIST_FILE_ALIGNMENT bytes from the start of the file, so that a
+    mapping of the file can be used as a NeighborList without copying.
+*/
+
+namespace freud { namespace locality {
+
+//! Alignment in bytes of the arrays in a neighbor list file
+constexpr uint64_t NEIGHBOR_LIST_FILE_ALIGNMENT = 64;
+
+//! Header of a neighbor list file.
+struct NeighborListFileHeader
+{
+    char magic[8];             //!< File signature, "FREUDNL" followed by a null byte
+    uint32_t version;          //!< Version of the file format
+    uint32_t byte_order;       //!< 0x01020304 written in the byte order of the arrays
+    uint64_t num_bonds;        //!< Number of bonds
+    uint32_t num_query_points; //!< Number of query points
+    uint32_t num_points;       //!< Number of points
+    uint64_t neighbors_offset; //!< Offset in bytes of the neighbors array
+    uint64_t distances_offset; //!< Offset in bytes of the distances array
+    uint64_t weights_offset;   //!< Offset in bytes of the weights array
+    uint64_t counts_offset;    //!< Offset in bytes of the neighbor counts array
+    uint64_t segments_offset;  //!< Offset in bytes of the segments array
+    uint64_t file_size;        //!< Total size of the file in bytes
+};
+
+//! Write a neighbor list file in chunks of bonds.
+/*! The bonds are appended in order of query point index, so a neighbor list
+ *  that does not fit into memory can be written chunk by chunk. Only the
+ *  neighbor counts of the query points are kept in memory. Since the number
+ *  of bonds is not known until the last chunk, the distances and weights are
+ *  staged in temporary files next to the output file, which are appended to
+ *  it by close.
+ */
+class NeighborListWriter
+{
+public:
+    //! Constructor, creates the file.
+    /*! \param filename Path of the file, which is overwritten if it exists.
+     *  \param num_query_points Number of query points of the neighbor list.
+     *  \param num_points Number of points of the neighbor list.
+     */
+    NeighborListWriter(const std::string& filename, unsigned int num_query_points, unsigned int num_points);
+
+    //! Destructor, removes the file if it was not closed.
+    ~NeighborListWriter();
+
+    NeighborListWriter(const NeighborListWriter&) = delete;
+    NeighborListWriter& operator=(const NeighborListWriter&) = delete;
+
+    //! Append a chunk of bonds given as arrays.
+    /*! \param num_bonds Number of bonds of the chunk.
+     *  \param neighbors Pairs of query point and point indices of the bonds.
+     *  \param distances Distances of the bonds.
+     *  \param weights Weights of the bonds.
+     */
+    void append(unsigned int num_bonds, const unsigned int* neighbors, const float* distances,
+                const float* weights);
+
+    //! Append a chunk of bonds.
+    void append(const std::vector<NeighborBond>& bonds);
+
+    //! Write the remaining arrays and the header, and close the file.
+    void close();
+
+    //! Get the number of bonds appended so far.
+    uint64_t getNumBonds() const
+    {
+        return m_num_bonds;
+    }
+
+private:
+    //! Discard the file and the temporary files.
+    void discard();
+
+    std::string m_filename;              //!< Path of the file
+    std::FILE* m_file;                   //!< The file, receiving the neighbors array
+    std::FILE* m_distances_file;         //!< Temporary file of the distances
+    std::FILE* m_weights_file;           //!< Temporary file of the weights
+    unsigned int m_num_query_points;     //!< Number of query points
+    unsigned int m_num_points;           //!< Number of points
+    uint64_t m_num_bonds {0};            //!< Number of bonds appended so far
+    unsigned int m_last_query_point {0}; //!< Query point index of the last bond appended
+    std::vector<unsigned int> m_counts;  //!< Neighbor counts of the query points
+};
+
+//! Write a NeighborList to a neighbor list file.
+void writeNeighborList(const NeighborList& nlist, const std::string& filename);
+
+//! Read a neighbor list file into memory.
+/*! The caller is responsible for deleting the returned NeighborList.
+ */
+NeighborList* readNeighborList(const std::string& filename);
+
+//! Memory map a neighbor list file as a NeighborList.
+/*! The arrays of the NeighborList reference the mapping, which stays alive
+ *  as long as any of them (or a NumPy array exposing them) does, so pages of
+ *  the file are only read when they are accessed and can be evicted again
+ *  under memory pressure. The mapping is private: modifying the arrays never
+ *  changes the file. On platforms without mmap, the file is read into memory
+ *  instead. The caller is responsible for deleting the returned NeighborList.
+ */
+NeighborList* mapNeighborList(const std::string& filename);
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_LIST_FILE_H
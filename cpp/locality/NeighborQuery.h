@@ -4,15 +4,22 @@
 #ifndef NEIGHBOR_QUERY_H
 #define NEIGHBOR_QUERY_H
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <numeric>
+#include <iterator>
 #include <stdexcept>
-#include <tbb/enumerable_thread_specific.h>
-#include <tbb/parallel_sort.h>
+#include <string>
+#include <tbb/concurrent_vector.h>
 #include <utility>
+#include <vector>
 
 #include "Box.h"
+#include "MortonOrder.h"
 #include "NeighborBond.h"
 #include "NeighborList.h"
+#include "NeighborListFile.h"
 #include "NeighborPerPointIterator.h"
 #include "utils.h"
 
@@ -38,9 +45,66 @@ constexpr float DEFAULT_R_MIN(0);                         //!< Default minimum q
 constexpr float DEFAULT_R_GUESS(-1.0);                    //!< Default guess query distance.
 constexpr float DEFAULT_SCALE(-1.0);      //!< Default scaling parameter for AABB nearest neighbor queries.
 constexpr bool DEFAULT_EXCLUDE_II(false); //!< Default for whether or not to include self-neighbors.
+constexpr unsigned int DEFAULT_POINT_TYPE(0xffffffff); //!< Default type of points to find, meaning all types.
 constexpr auto ITERATOR_TERMINATOR
     = NeighborBond(-1, -1, 0); //!< The object returned when iteration is complete.
 
+//! Enumeration for shapes of the regions restricting the query points of a query.
+enum class RegionShape
+{
+    none,   //! Query all query points.
+    box,    //! Query the query points in an axis-aligned box of fractional coordinates.
+    sphere, //! Query the query points in a sphere around a point given in fractional coordinates.
+};
+
+//! POD class to hold a region of the box restricting the query points of a query.
+/*! Query points outside of the region are skipped, so they have no neighbors,
+ *  while the query points inside of it find their neighbors among all points.
+ *  The lower corner of a box region may exceed its upper corner along an
+ *  axis, in which case the region wraps through the periodic boundary along
+ *  that axis. The z coordinates are ignored in 2D boxes.
+ */
+struct QueryRegion
+{
+    RegionShape shape {RegionShape::none}; //! The shape of the region.
+    vec3<float> lower {0, 0, 0};           //! The fractional coordinates of the lower corner of a box.
+    vec3<float> upper {1, 1, 1};           //! The fractional coordinates of the upper corner of a box.
+    vec3<float> center {0.5, 0.5, 0.5};    //! The fractional coordinates of the center of a sphere.
+    float radius {0};                      //! The radius of a sphere, in absolute distance.
+
+    //! Return whether the region restricts the query points
+    bool isSet() const
+    {
+        return shape != RegionShape::none;
+    }
+
+    //! Return whether a point of the box is inside of the region
+    bool contains(const box::Box& box, const vec3<float>& point) const
+    {
+        if (shape == RegionShape::sphere)
+        {
+            const vec3<float> delta = box.wrap(point - box.makeAbsolute(center));
+            return dot(delta, delta) <= radius * radius;
+        }
+        if (shape == RegionShape::box)
+        {
+            vec3<float> f = box.makeFractional(point);
+            f.x -= std::floor(f.x);
+            f.y -= std::floor(f.y);
+            f.z -= std::floor(f.z);
+            return containsCoordinate(f.x, lower.x, upper.x) && containsCoordinate(f.y, lower.y, upper.y)
+                && (box.is2D() || containsCoordinate(f.z, lower.z, upper.z));
+        }
+        return true;
+    }
+
+    //! Return whether a wrapped fractional coordinate is within the range of the region along an axis
+    static bool containsCoordinate(float f, float lower, float upper)
+    {
+        return lower <= upper ? (f >= lower && f < upper) : (f >= lower || f < upper);
+    }
+};
+
 //! POD class to hold information about generic queries.
 /*! This class provides a standard method for specifying the type of query to
  *  perform with a NeighborQuery object. Rather than calling queryBall
@@ -60,6 +124,34 @@ struct QueryArgs
     float scale {DEFAULT_SCALE};          //! The scale factor to use when performing repeated ball queries
                                           //! to find a specified number of nearest neighbors.
     bool exclude_ii {DEFAULT_EXCLUDE_II}; //! If true, exclude self-neighbors.
+    unsigned int point_type {DEFAULT_POINT_TYPE}; //! The type of points to find, see TypedNeighborQuery.
+    QueryRegion region;                           //! The region of the query points to query.
+};
+
+//! Destination for the bonds found by batched neighbor queries.
+/*! Batched queries append bonds in nondecreasing order of query point index,
+ *  so a sink filled from a contiguous range of query points holds a contiguous
+ *  segment of the final NeighborList. If squared_distances is set, the bonds
+ *  hold their squared distances instead, so that queries which compare
+ *  squared distances to the cutoff need not take their square roots.
+ */
+struct BondSink
+{
+    //! Append a bond to the sink.
+    void emit(unsigned int query_point_idx, unsigned int point_idx, float distance)
+    {
+        bonds.emplace_back(query_point_idx, point_idx, squared_distances ? distance * distance : distance);
+    }
+
+    //! Append a bond to the sink from its squared distance.
+    void emitSquared(unsigned int query_point_idx, unsigned int point_idx, float distance_sq)
+    {
+        bonds.emplace_back(query_point_idx, point_idx,
+                           squared_distances ? distance_sq : std::sqrt(distance_sq));
+    }
+
+    std::vector<NeighborBond> bonds; //!< The bonds emitted so far.
+    bool squared_distances {false};  //!< Whether the bonds hold squared distances.
 };
 
 // Forward declare the iterators
@@ -83,23 +175,7 @@ public:
     NeighborQuery(box::Box box, const vec3<float>* points, unsigned int n_points)
         : m_box(std::move(box)), m_points(points), m_n_points(n_points)
     {
-        // Reject systems with 0 particles
-        if (m_n_points == 0)
-        {
-            throw std::invalid_argument("Cannot create a NeighborQuery with 0 particles.");
-        }
-
-        // For 2D systems, check if any z-coordinates are outside some tolerance of z=0
-        if (m_box.is2D())
-        {
-            for (unsigned int i(0); i < n_points; i++)
-            {
-                if (std::abs(m_points[i].z) > 1e-6)
-                {
-                    throw std::invalid_argument("A point with z != 0 was provided in a 2D box.");
-                }
-            }
-        }
+        validatePoints(m_box, m_points, m_n_points);
     }
 
     //! Empty Destructor
@@ -144,6 +220,121 @@ public:
     virtual std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const = 0;
 
+    //! Find the neighbors of a contiguous range of query points.
+    /*! The default implementation loops over the per-point iterators returned
+     *  by querySingle. Subclasses may override this function to find neighbors
+     *  without allocating an iterator for every query point. Implementations
+     *  must emit bonds in nondecreasing order of query point index, but the
+     *  bonds of a single query point may be emitted in any order.
+     *
+     *  \param query_points The points to find neighbors for.
+     *  \param begin The index of the first query point to process.
+     *  \param end One past the index of the last query point to process.
+     *  \param args The query arguments that should be used to find neighbors.
+     *  \param sink The destination for the bonds that are found.
+     */
+    virtual void queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end,
+                            QueryArgs args, BondSink& sink) const;
+
+    //! Find the neighbors of a list of query points.
+    /*! This function is the counterpart of queryBatch for query points that
+     *  are processed in an order other than that of their indices, such as the
+     *  order returned by getQueryOrder. Implementations must emit the bonds
+     *  of the query points in the order of the list, but the bonds of a single
+     *  query point may be emitted in any order.
+     *
+     *  \param query_points The points to find neighbors for.
+     *  \param query_point_indices The indices of the query points to process.
+     *  \param n The number of indices.
+     *  \param args The query arguments that should be used to find neighbors.
+     *  \param sink The destination for the bonds that are found.
+     */
+    virtual void queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                              unsigned int n, QueryArgs args, BondSink& sink) const;
+
+    //! Set whether queries process the query points in spatial order.
+    /*! Query points are usually stored in an order that is unrelated to
+     *  their positions, so consecutive query points search distant parts of
+     *  the search structure. When this option is enabled, NeighborLists and
+     *  loops over all bonds are generated by processing the query points in
+     *  Morton order, and the results are identical to those of unsorted
+     *  queries. The order of the points of this object is computed here and
+     *  reused by all queries whose query points are these points.
+     *
+     *  \param sort_query_points Whether to process query points in spatial order.
+     */
+    void setSortQueryPoints(bool sort_query_points)
+    {
+        m_point_order = sort_query_points
+            ? std::make_shared<const std::vector<unsigned int>>(mortonOrder(m_box, m_points, m_n_points))
+            : nullptr;
+    }
+
+    //! Get whether queries process the query points in spatial order
+    bool getSortQueryPoints() const
+    {
+        return m_point_order != nullptr;
+    }
+
+    //! Get the order in which to process a set of query points.
+    /*! \param query_points The points to find neighbors for.
+     *  \param n_query_points The number of query points.
+     *  \returns The indices of the query points in Morton order, or nullptr
+     *            if the query points should be processed in order of index.
+     */
+    std::shared_ptr<const std::vector<unsigned int>> getQueryOrder(const vec3<float>* query_points,
+                                                                   unsigned int n_query_points) const
+    {
+        if (m_point_order == nullptr || (query_points == m_points && n_query_points == m_n_points))
+        {
+            return m_point_order;
+        }
+        return std::make_shared<const std::vector<unsigned int>>(
+            mortonOrder(m_box, query_points, n_query_points));
+    }
+
+    //! Get the query points inside of a region, in the order in which to process them.
+    /*! \param query_points The points to find neighbors for.
+     *  \param n_query_points The number of query points.
+     *  \param region The region of the query points to query.
+     *  \returns The indices of the query points inside of the region, in the
+     *            order of getQueryOrder, or nullptr if the region is not set
+     *            and the query points should be processed in order of index.
+     */
+    std::shared_ptr<const std::vector<unsigned int>> getQueryOrder(const vec3<float>* query_points,
+                                                                   unsigned int n_query_points,
+                                                                   const QueryRegion& region) const
+    {
+        std::shared_ptr<const std::vector<unsigned int>> order = getQueryOrder(query_points, n_query_points);
+        if (!region.isSet())
+        {
+            return order;
+        }
+        auto selected = std::make_shared<std::vector<unsigned int>>();
+        for (unsigned int k = 0; k < n_query_points; ++k)
+        {
+            const unsigned int i = order != nullptr ? (*order)[k] : k;
+            if (region.contains(m_box, query_points[i]))
+            {
+                selected->push_back(i);
+            }
+        }
+        return selected;
+    }
+
+    //! Get the number of query points inside of a region.
+    unsigned int countQueryPoints(const vec3<float>* query_points, unsigned int n_query_points,
+                                  const QueryRegion& region) const
+    {
+        if (!region.isSet())
+        {
+            return n_query_points;
+        }
+        return static_cast<unsigned int>(std::count_if(
+            query_points, query_points + n_query_points,
+            [&](const vec3<float>& query_point) { return region.contains(m_box, query_point); }));
+    }
+
     //! Get the simulation box
     const box::Box& getBox() const
     {
@@ -175,6 +366,33 @@ public:
     }
 
 protected:
+    //! Check that a set of points can be used to build a NeighborQuery.
+    /*! \param box The box containing the points.
+     *  \param points The point coordinates.
+     *  \param n_points The number of points.
+     */
+    static void validatePoints(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+    {
+        // Reject systems with 0 particles
+        if (n_points == 0)
+        {
+            throw std::invalid_argument("Cannot create a NeighborQuery with 0 particles.");
+        }
+
+        // For 2D systems, check if any z-coordinates are outside some tolerance of z=0
+        if (box.is2D())
+        {
+            for (unsigned int i(0); i < n_points; i++)
+            {
+                if (std::abs(points[i].z) > 1e-6)
+                {
+                    throw std::invalid_argument("A point with z != 0 was provided in a 2D box.");
+                }
+            }
+        }
+    }
+
+public:
     //! Validate the combination of specified arguments.
     /*! Before checking if the combination of parameters currently set is
      *  valid, this function first attempts to infer a mode if one is not set in
@@ -215,6 +433,8 @@ protected:
         {
             throw std::runtime_error("Unknown mode");
         }
+        validatePointType(args);
+        validateRegion(args.region);
     }
 
     //! Try to determine the query mode if one is not specified.
@@ -239,9 +459,43 @@ protected:
         }
     }
 
-    const box::Box m_box;        //!< Simulation box where the particles belong.
+protected:
+    //! Validate the region query argument.
+    static void validateRegion(const QueryRegion& region)
+    {
+        if (region.shape == RegionShape::box)
+        {
+            const auto in_range = [](const vec3<float>& f) {
+                return f.x >= 0 && f.x <= 1 && f.y >= 0 && f.y <= 1 && f.z >= 0 && f.z <= 1;
+            };
+            if (!in_range(region.lower) || !in_range(region.upper))
+            {
+                throw std::invalid_argument("The corners of a region must be in fractional coordinates.");
+            }
+        }
+        else if (region.shape == RegionShape::sphere && !(region.radius > 0))
+        {
+            throw std::invalid_argument("The radius of a region must be positive.");
+        }
+    }
+
+    //! Validate the point_type query argument.
+    /*! Only subclasses that know the types of their points accept queries
+     *  for the neighbors of a single type.
+     */
+    virtual void validatePointType(const QueryArgs& args) const
+    {
+        if (args.point_type != DEFAULT_POINT_TYPE)
+        {
+            throw std::runtime_error("The point_type query argument requires a TypedNeighborQuery.");
+        }
+    }
+
+    box::Box m_box;              //!< Simulation box where the particles belong.
     const vec3<float>* m_points; //!< Point coordinates.
     unsigned int m_n_points;     //!< Number of points.
+    std::shared_ptr<const std::vector<unsigned int>>
+        m_point_order; //!< Morton order of the points, if query points are sorted.
 };
 
 //! Implementation of per-point finding logic for NeighborQuery objects.
@@ -288,6 +542,53 @@ protected:
     bool m_exclude_ii; //!< Flag to indicate whether or not to include self bonds.
 };
 
+//! Per-point iterator of a query point that is skipped by a query, which finds no neighbors.
+class NeighborQueryEmptyIterator : public NeighborQueryPerPointIterator
+{
+public:
+    //! Constructor
+    NeighborQueryEmptyIterator(const NeighborQuery* neighbor_query, const vec3<float>& query_point,
+                               unsigned int query_point_idx)
+        : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, 0, 0, false)
+    {
+        m_finished = true;
+    }
+
+    //! Get the next element, which is always the terminator.
+    NeighborBond next() override
+    {
+        return ITERATOR_TERMINATOR;
+    }
+};
+
+inline void NeighborQuery::queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end,
+                                      QueryArgs args, BondSink& sink) const
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        std::shared_ptr<NeighborQueryPerPointIterator> it = this->querySingle(query_points[i], i, args);
+        for (NeighborBond nb = it->next(); !it->end(); nb = it->next())
+        {
+            sink.emit(nb.query_point_idx, nb.point_idx, nb.distance);
+        }
+    }
+}
+
+inline void NeighborQuery::queryIndexed(const vec3<float>* query_points,
+                                        const unsigned int* query_point_indices, unsigned int n,
+                                        QueryArgs args, BondSink& sink) const
+{
+    for (unsigned int k = 0; k < n; ++k)
+    {
+        const unsigned int i = query_point_indices[k];
+        std::shared_ptr<NeighborQueryPerPointIterator> it = this->querySingle(query_points[i], i, args);
+        for (NeighborBond nb = it->next(); !it->end(); nb = it->next())
+        {
+            sink.emit(nb.query_point_idx, nb.point_idx, nb.distance);
+        }
+    }
+}
+
 //! The iterator class for neighbor queries on NeighborQuery objects.
 /*! All queries to a NeighborQuery return instances of this class. The
  *  NeighborQueryIterator is capable of either iterating over all neighbors of
@@ -322,8 +623,15 @@ public:
     }
 
     //! Get an iterator for a specific query point by index.
+    /*! Query points outside of the region of the query get an iterator
+     *  without neighbors.
+     */
     std::shared_ptr<NeighborQueryPerPointIterator> query(unsigned int i)
     {
+        if (m_qargs.region.isSet() && !m_qargs.region.contains(m_neighbor_query->getBox(), m_query_points[i]))
+        {
+            return std::make_shared<NeighborQueryEmptyIterator>(m_neighbor_query, m_query_points[i], i);
+        }
         return m_neighbor_query->querySingle(m_query_points[i], i, m_qargs);
     }
 
@@ -359,11 +667,18 @@ public:
 
     //! Generate a NeighborList from query.
     /*! This function exploits parallelism by finding the neighbors for
-     *  each query point in parallel and adding them to a list, which is
-     *  then sorted in parallel as well before being added to the
-     *  NeighborList object. Right now this won't be backwards compatible
-     *  because the kn query is not symmetric, so even if we reverse the
-     *  output order here the actual neighbors found will be different.
+     *  contiguous blocks of query points in parallel using the batched query
+     *  interface of the NeighborQuery. Since each block emits its bonds in
+     *  order of query point index, only the bonds of each individual query
+     *  point need to be sorted, and the blocks are then copied into the
+     *  NeighborList at offsets given by a prefix sum over the block sizes.
+     *  If the NeighborQuery sorts query points, the blocks are instead taken
+     *  from the spatial order of the query points, and the bonds of each
+     *  query point are copied to offsets given by a prefix sum over the
+     *  neighbor counts of the query points.
+     *  Right now this won't be backwards compatible because the kn query is
+     *  not symmetric, so even if we reverse the output order here the actual
+     *  neighbors found will be different.
      *
      *  This function returns a pointer, not a shared pointer, so the
      *  caller is responsible for deleting it. The reason for this is that
@@ -372,56 +687,214 @@ public:
      */
     NeighborList* toNeighborList(bool sort_by_distance = false)
     {
-        using BondVector = tbb::enumerable_thread_specific<std::vector<NeighborBond>>;
-        BondVector bonds;
-        util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
-            BondVector::reference local_bonds(bonds.local());
-            NeighborBond nb;
-            for (size_t i = begin; i < end; ++i)
+        FREUD_PROFILE_SCOPE("neighbor query");
+        const auto compare = sort_by_distance ? compareNeighborDistance : compareNeighborBond;
+        const std::shared_ptr<const std::vector<unsigned int>> order
+            = m_neighbor_query->getQueryOrder(m_query_points, m_num_query_points, m_qargs.region);
+        if (order != nullptr)
+        {
+            return toNeighborListInOrder(*order, compare);
+        }
+
+        const std::vector<BondBlock> ordered_blocks = queryBlocks(0, m_num_query_points, compare);
+
+        std::vector<unsigned int> block_offsets(ordered_blocks.size() + 1, 0);
+        for (size_t block = 0; block < ordered_blocks.size(); ++block)
+        {
+            block_offsets[block + 1] = block_offsets[block] + ordered_blocks[block].sink.bonds.size();
+        }
+        const unsigned int num_bonds = block_offsets.back();
+        FREUD_PROFILE_COUNT("neighbor query bonds", num_bonds);
+
+        auto* nl = new NeighborList();
+        nl->setNumBonds(num_bonds, m_num_query_points, m_neighbor_query->getNPoints());
+        unsigned int* neighbors = nl->getNeighbors().get();
+        float* distances = nl->getDistances().get();
+        float* weights = nl->getWeights().get();
+
+        util::forLoopWrapper(0, ordered_blocks.size(), [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
             {
-                std::shared_ptr<NeighborQueryPerPointIterator> it = this->query(i);
-                while (!it->end())
+                const std::vector<NeighborBond>& bonds = ordered_blocks[block].sink.bonds;
+                unsigned int bond = block_offsets[block];
+                for (const NeighborBond& nb : bonds)
                 {
-                    nb = it->next();
-                    // If we're excluding ii bonds, we have to check before adding.
-                    if (nb != ITERATOR_TERMINATOR)
-                    {
-                        local_bonds.emplace_back(nb.query_point_idx, nb.point_idx, nb.distance);
-                    }
+                    neighbors[2 * bond] = nb.query_point_idx;
+                    neighbors[2 * bond + 1] = nb.point_idx;
+                    distances[bond] = nb.distance;
+                    weights[bond] = float(1.0);
+                    ++bond;
                 }
             }
         });
 
-        tbb::flattened2d<BondVector> flat_bonds = tbb::flatten2d(bonds);
-        std::vector<NeighborBond> linear_bonds(flat_bonds.begin(), flat_bonds.end());
-        if (sort_by_distance)
+        return nl;
+    }
+
+    //! Write the NeighborList of this query to a neighbor list file in chunks.
+    /*! The query points are processed in chunks of chunk_size consecutive
+     *  query points. The bonds of each chunk are found in parallel and sorted
+     *  as in toNeighborList, then appended to the file before the next chunk
+     *  is queried. The file thus holds the bonds that toNeighborList would
+     *  return, while only the bonds of one chunk are held in memory, so
+     *  neighbor lists larger than the memory can be produced and memory
+     *  mapped afterwards (see mapNeighborList).
+     *
+     *  \param filename Path of the file, which is overwritten if it exists.
+     *  \param chunk_size Number of query points per chunk.
+     *  \param sort_by_distance Whether to sort the bonds of each query point by distance.
+     */
+    void toNeighborListFile(const std::string& filename, unsigned int chunk_size = 65536,
+                            bool sort_by_distance = false)
+    {
+        FREUD_PROFILE_SCOPE("neighbor query");
+        if (chunk_size == 0)
         {
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborDistance);
+            throw std::invalid_argument("chunk_size must be positive.");
         }
-        else
+        const auto compare = sort_by_distance ? compareNeighborDistance : compareNeighborBond;
+
+        NeighborListWriter writer(filename, m_num_query_points, m_neighbor_query->getNPoints());
+        unsigned int chunk_begin = 0;
+        while (chunk_begin < m_num_query_points)
+        {
+            const unsigned int chunk_end
+                = chunk_begin + std::min(chunk_size, m_num_query_points - chunk_begin);
+            for (const BondBlock& block : queryBlocks(chunk_begin, chunk_end, compare))
+            {
+                writer.append(block.sink.bonds);
+            }
+            chunk_begin = chunk_end;
+        }
+        FREUD_PROFILE_COUNT("neighbor query bonds", writer.getNumBonds());
+        writer.close();
+    }
+
+protected:
+    using BondComparison = bool (*)(const NeighborBond&, const NeighborBond&);
+
+    //! The bonds found for a contiguous block of query points.
+    struct BondBlock
+    {
+        unsigned int begin; //!< The first query point in this block.
+        BondSink sink;      //!< The bonds found for this block.
+    };
+
+    //! Find the bonds of a range of query points in parallel blocks.
+    /*! \returns The blocks in order of query point index, with the bonds of
+     *           each query point sorted by compare.
+     */
+    std::vector<BondBlock> queryBlocks(unsigned int begin, unsigned int end, BondComparison compare) const
+    {
+        tbb::concurrent_vector<BondBlock> blocks;
+
+        util::forLoopWrapper(begin, end, [&](size_t block_begin, size_t block_end) {
+            BondBlock block;
+            block.begin = block_begin;
+            if (m_qargs.region.isSet())
+            {
+                // The query points of the block inside of the region are
+                // queried in order of index.
+                std::vector<unsigned int> indices;
+                for (size_t i = block_begin; i < block_end; ++i)
+                {
+                    if (m_qargs.region.contains(m_neighbor_query->getBox(), m_query_points[i]))
+                    {
+                        indices.push_back(static_cast<unsigned int>(i));
+                    }
+                }
+                m_neighbor_query->queryIndexed(m_query_points, indices.data(),
+                                               static_cast<unsigned int>(indices.size()), m_qargs,
+                                               block.sink);
+            }
+            else
+            {
+                m_neighbor_query->queryBatch(m_query_points, block_begin, block_end, m_qargs, block.sink);
+            }
+
+            // Bonds are already grouped by query point, so sorting each
+            // query point's segment yields the globally sorted order.
+            sortSegments(block.sink.bonds, compare);
+            blocks.push_back(std::move(block));
+        });
+
+        std::vector<BondBlock> ordered_blocks(std::make_move_iterator(blocks.begin()),
+                                              std::make_move_iterator(blocks.end()));
+        std::sort(ordered_blocks.begin(), ordered_blocks.end(),
+                  [](const BondBlock& left, const BondBlock& right) { return left.begin < right.begin; });
+        return ordered_blocks;
+    }
+
+    //! Sort the bonds of each query point of a list of bonds grouped by query point.
+    static void sortSegments(std::vector<NeighborBond>& bonds, BondComparison compare)
+    {
+        auto segment_start = bonds.begin();
+        while (segment_start != bonds.end())
         {
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborBond);
+            const unsigned int query_point_idx = segment_start->query_point_idx;
+            auto segment_end = std::find_if(segment_start, bonds.end(), [=](const NeighborBond& nb) {
+                return nb.query_point_idx != query_point_idx;
+            });
+            std::sort(segment_start, segment_end, compare);
+            segment_start = segment_end;
         }
+    }
 
-        unsigned int num_bonds = linear_bonds.size();
+    //! Generate a NeighborList by processing the query points in a given order (see toNeighborList).
+    NeighborList* toNeighborListInOrder(const std::vector<unsigned int>& order, BondComparison compare)
+    {
+        tbb::concurrent_vector<BondSink> sinks;
+        std::vector<unsigned int> counts(m_num_query_points, 0);
+
+        util::forLoopWrapper(0, order.size(), [&](size_t begin, size_t end) {
+            BondSink sink;
+            m_neighbor_query->queryIndexed(m_query_points, order.data() + begin,
+                                           static_cast<unsigned int>(end - begin), m_qargs, sink);
+            sortSegments(sink.bonds, compare);
+
+            // Every query point is processed by a single block.
+            for (const NeighborBond& nb : sink.bonds)
+            {
+                ++counts[nb.query_point_idx];
+            }
+            sinks.push_back(std::move(sink));
+        });
+
+        std::vector<unsigned int> offsets(m_num_query_points + 1, 0);
+        std::partial_sum(counts.begin(), counts.end(), offsets.begin() + 1);
+        const unsigned int num_bonds = offsets.back();
+        FREUD_PROFILE_COUNT("neighbor query bonds", num_bonds);
 
         auto* nl = new NeighborList();
         nl->setNumBonds(num_bonds, m_num_query_points, m_neighbor_query->getNPoints());
+        unsigned int* neighbors = nl->getNeighbors().get();
+        float* distances = nl->getDistances().get();
+        float* weights = nl->getWeights().get();
 
-        util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
-            for (size_t bond = begin; bond < end; ++bond)
+        util::forLoopWrapper(0, sinks.size(), [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
             {
-                nl->getNeighbors()(bond, 0) = linear_bonds[bond].query_point_idx;
-                nl->getNeighbors()(bond, 1) = linear_bonds[bond].point_idx;
-                nl->getDistances()[bond] = linear_bonds[bond].distance;
-                nl->getWeights()[bond] = float(1.0);
+                unsigned int bond = 0;
+                unsigned int query_point_idx = m_num_query_points;
+                for (const NeighborBond& nb : sinks[block].bonds)
+                {
+                    if (nb.query_point_idx != query_point_idx)
+                    {
+                        query_point_idx = nb.query_point_idx;
+                        bond = offsets[query_point_idx];
+                    }
+                    neighbors[2 * bond] = nb.query_point_idx;
+                    neighbors[2 * bond + 1] = nb.point_idx;
+                    distances[bond] = nb.distance;
+                    weights[bond] = float(1.0);
+                    ++bond;
+                }
             }
         });
 
         return nl;
     }
 
-protected:
     const NeighborQuery* m_neighbor_query;                 //!< Link to the NeighborQuery object.
     const vec3<float>* m_query_points;                     //!< Coordinates of the query points.
     unsigned int m_num_query_points;                       //!< The number of query points.
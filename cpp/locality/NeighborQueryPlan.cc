@@ -0,0 +1,272 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include "NeighborQueryPlan.h"
+#include "utils.h"
+
+/*! \file NeighborQueryPlan.cc
+    \brief Serves several neighbor queries of the same points from shared passes.
+*/
+
+namespace freud { namespace locality {
+
+//! Return whether two sets of query arguments find the same bonds
+inline bool sameBonds(const QueryArgs& left, const QueryArgs& right)
+{
+    return left.mode == right.mode && left.r_max == right.r_max && left.r_min == right.r_min
+        && left.exclude_ii == right.exclude_ii
+        && (left.mode != QueryType::nearest || left.num_neighbors == right.num_neighbors);
+}
+
+//! Combine the arguments of several queries into one query finding all of their bonds
+/*! Nearest neighbor queries that include self-neighbors may be combined with
+ *  queries excluding them, so one extra neighbor is requested in that case.
+ */
+inline QueryArgs widestQuery(const std::vector<QueryArgs>& qargs, const std::vector<unsigned int>& indices)
+{
+    QueryArgs widest(qargs[indices[0]]);
+    bool any_exclude_ii(widest.exclude_ii);
+    for (unsigned int i : indices)
+    {
+        const QueryArgs& args = qargs[i];
+        widest.r_max = std::max(widest.r_max, args.r_max);
+        widest.r_min = std::min(widest.r_min, args.r_min);
+        widest.exclude_ii = widest.exclude_ii && args.exclude_ii;
+        any_exclude_ii = any_exclude_ii || args.exclude_ii;
+        if (widest.mode == QueryType::nearest)
+        {
+            widest.num_neighbors = std::max(widest.num_neighbors, args.num_neighbors);
+        }
+    }
+    if (widest.mode == QueryType::nearest && any_exclude_ii && !widest.exclude_ii)
+    {
+        ++widest.num_neighbors;
+    }
+    return widest;
+}
+
+void NeighborQueryPlan::compute(const NeighborQuery* nq, const vec3<float>* query_points,
+                                unsigned int n_query_points, const std::vector<QueryArgs>& qargs)
+{
+    // Normalize the arguments the same way a query would.
+    std::vector<QueryArgs> args(qargs);
+    std::vector<unsigned int> ball_queries;
+    std::vector<unsigned int> nearest_queries;
+    std::vector<unsigned int> separate_queries;
+    for (unsigned int i = 0; i < args.size(); ++i)
+    {
+        nq->validateQueryArgs(args[i]);
+        if (args[i].point_type != DEFAULT_POINT_TYPE || args[i].region.isSet())
+        {
+            separate_queries.push_back(i);
+        }
+        else
+        {
+            (args[i].mode == QueryType::ball ? ball_queries : nearest_queries).push_back(i);
+        }
+    }
+
+    m_num_queries = args.size();
+    m_num_passes = 0;
+    while (m_neighbor_lists.size() < args.size())
+    {
+        m_neighbor_lists.push_back(std::make_shared<NeighborList>());
+    }
+
+    // Serve all ball queries, and as many nearest neighbor queries as
+    // possible, from a single ball query at the largest cutoff.
+    std::vector<unsigned int> unserved;
+    if (!ball_queries.empty())
+    {
+        const QueryArgs ball_args = widestQuery(args, ball_queries);
+        std::shared_ptr<NeighborList> ball_pass = runQuery(nq, query_points, n_query_points, ball_args);
+        for (unsigned int i : ball_queries)
+        {
+            if (sameBonds(args[i], ball_args))
+            {
+                m_neighbor_lists[i]->share(*ball_pass);
+            }
+            else
+            {
+                filterBonds(*ball_pass, ball_args, args[i], *m_neighbor_lists[i]);
+            }
+        }
+        for (unsigned int i : nearest_queries)
+        {
+            if (!filterBonds(*ball_pass, ball_args, args[i], *m_neighbor_lists[i]))
+            {
+                unserved.push_back(i);
+            }
+        }
+    }
+    else
+    {
+        unserved = nearest_queries;
+    }
+
+    // Serve the remaining nearest neighbor queries from a single query for
+    // the largest number of neighbors. Queries that still cannot be served,
+    // which requires a larger r_min than other queries, are run on their own.
+    if (!unserved.empty())
+    {
+        const QueryArgs nearest_args = widestQuery(args, unserved);
+        std::shared_ptr<NeighborList> nearest_pass
+            = runQuery(nq, query_points, n_query_points, nearest_args);
+        for (unsigned int i : unserved)
+        {
+            if (sameBonds(args[i], nearest_args))
+            {
+                m_neighbor_lists[i]->share(*nearest_pass);
+            }
+            else if (!filterBonds(*nearest_pass, nearest_args, args[i], *m_neighbor_lists[i]))
+            {
+                m_neighbor_lists[i]->share(*runQuery(nq, query_points, n_query_points, args[i]));
+            }
+        }
+    }
+
+    // The bonds of queries for a single type of points or for the query
+    // points of a region cannot be filtered from those of other queries, so
+    // they are run on their own.
+    for (unsigned int i : separate_queries)
+    {
+        m_neighbor_lists[i]->share(*runQuery(nq, query_points, n_query_points, args[i]));
+    }
+}
+
+std::shared_ptr<NeighborList> NeighborQueryPlan::getNeighborList(unsigned int query_idx) const
+{
+    if (query_idx >= m_num_queries)
+    {
+        throw std::out_of_range("The requested query does not exist.");
+    }
+    return m_neighbor_lists[query_idx];
+}
+
+std::shared_ptr<NeighborList> NeighborQueryPlan::runQuery(const NeighborQuery* nq,
+                                                          const vec3<float>* query_points,
+                                                          unsigned int n_query_points, const QueryArgs& qargs)
+{
+    ++m_num_passes;
+    return std::shared_ptr<NeighborList>(nq->query(query_points, n_query_points, qargs)->toNeighborList());
+}
+
+bool NeighborQueryPlan::filterBonds(const NeighborList& source, const QueryArgs& source_args,
+                                    const QueryArgs& args, NeighborList& nlist)
+{
+    // The source must contain every bond the narrower query could find.
+    if (source_args.r_min > args.r_min || (source_args.exclude_ii && !args.exclude_ii))
+    {
+        return false;
+    }
+    const bool nearest = args.mode == QueryType::nearest;
+    const bool source_nearest = source_args.mode == QueryType::nearest;
+    if (!nearest && (source_nearest || source_args.r_max < args.r_max))
+    {
+        return false;
+    }
+
+    const unsigned int n_query_points = source.getNumQueryPoints();
+    const unsigned int* source_segments = source.getSegments().get();
+    const unsigned int* source_counts = source.getCounts().get();
+    const unsigned int* source_neighbors = source.getNeighbors().get();
+    const float* source_distances = source.getDistances().get();
+    const float* source_weights = source.getWeights().get();
+
+    auto is_candidate = [&](unsigned int bond) {
+        const float distance = source_distances[bond];
+        return distance >= args.r_min && distance < args.r_max
+            && !(args.exclude_ii && source_neighbors[2 * bond] == source_neighbors[2 * bond + 1]);
+    };
+
+    // Count the bonds of each query point, making sure that no nearest
+    // neighbors can be missing from the source.
+    std::vector<unsigned int> counts(n_query_points);
+    std::atomic<bool> complete(true);
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned int first = source_segments[i];
+            const unsigned int last = first + source_counts[i];
+            unsigned int count(0);
+            for (unsigned int bond = first; bond < last; ++bond)
+            {
+                count += static_cast<unsigned int>(is_candidate(bond));
+            }
+            if (nearest && count < args.num_neighbors)
+            {
+                // Fewer candidates than requested are correct only if the
+                // source found every neighbor within r_max.
+                const bool source_exhaustive = source_nearest
+                    ? source_counts[i] < source_args.num_neighbors
+                    : source_args.r_max >= args.r_max;
+                if (!source_exhaustive)
+                {
+                    complete = false;
+                }
+            }
+            counts[i] = nearest ? std::min(count, args.num_neighbors) : count;
+        }
+    });
+    if (!complete)
+    {
+        return false;
+    }
+
+    std::vector<unsigned int> offsets(n_query_points + 1, 0);
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    nlist.setNumBonds(offsets[n_query_points], n_query_points, source.getNumPoints());
+    unsigned int* neighbors = nlist.getNeighbors().get();
+    float* distances = nlist.getDistances().get();
+    float* weights = nlist.getWeights().get();
+
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> candidates;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned int first = source_segments[i];
+            const unsigned int last = first + source_counts[i];
+            candidates.clear();
+            for (unsigned int bond = first; bond < last; ++bond)
+            {
+                if (is_candidate(bond))
+                {
+                    candidates.push_back(bond);
+                }
+            }
+            if (candidates.size() > counts[i])
+            {
+                // Keep the nearest neighbors, then restore the point index
+                // order of the source bonds.
+                std::nth_element(candidates.begin(), candidates.begin() + counts[i], candidates.end(),
+                                 [&](unsigned int left, unsigned int right) {
+                                     return source_distances[left] < source_distances[right]
+                                         || (source_distances[left] == source_distances[right]
+                                             && source_neighbors[2 * left + 1]
+                                                 < source_neighbors[2 * right + 1]);
+                                 });
+                candidates.resize(counts[i]);
+                std::sort(candidates.begin(), candidates.end());
+            }
+            for (unsigned int j = 0; j < counts[i]; ++j)
+            {
+                const unsigned int bond = candidates[j];
+                const unsigned int out = offsets[i] + j;
+                neighbors[2 * out] = source_neighbors[2 * bond];
+                neighbors[2 * out + 1] = source_neighbors[2 * bond + 1];
+                distances[out] = source_distances[bond];
+                weights[out] = source_weights[bond];
+            }
+        }
+    });
+    return true;
+}
+
+}; }; // end namespace freud::locality
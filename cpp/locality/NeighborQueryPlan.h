@@ -0,0 +1,88 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_QUERY_PLAN_H
+#define NEIGHBOR_QUERY_PLAN_H
+
+#include <memory>
+#include <vector>
+
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file NeighborQueryPlan.h
+    \brief Serves several neighbor queries of the same points from shared passes.
+*/
+
+namespace freud { namespace locality {
+
+//! Find the neighbors requested by several computes with as few queries as possible
+/*! All ball queries are served from a single ball query at the largest
+ *  requested r_max. The computed NeighborList of a query whose arguments match
+ *  the shared pass shares its bond arrays, while the NeighborLists of narrower
+ *  queries are filtered from the shared bonds in parallel. Nearest neighbor
+ *  queries are served from the ball pass whenever it holds enough neighbors of
+ *  every query point. Otherwise a single nearest neighbor query with the
+ *  largest requested number of neighbors serves all of them. Queries for the
+ *  neighbors of a single type of points are performed on their own.
+ *
+ *  Every NeighborList has the same bonds, in the same order, as a query
+ *  performed with the corresponding arguments on its own.
+ */
+class NeighborQueryPlan
+{
+public:
+    //! Constructor
+    NeighborQueryPlan() = default;
+
+    //! Find the neighbors of the query points for every set of query arguments
+    /*! \param nq NeighborQuery containing the points.
+     *  \param query_points The query points.
+     *  \param n_query_points The number of query points.
+     *  \param qargs The query arguments of every requested query.
+     */
+    void compute(const NeighborQuery* nq, const vec3<float>* query_points, unsigned int n_query_points,
+                 const std::vector<QueryArgs>& qargs);
+
+    //! Get the number of queries served by the last compute
+    unsigned int getNumQueries() const
+    {
+        return m_num_queries;
+    }
+
+    //! Get the number of neighbor queries performed by the last compute
+    unsigned int getNumPasses() const
+    {
+        return m_num_passes;
+    }
+
+    //! Get the NeighborList of a requested query
+    std::shared_ptr<NeighborList> getNeighborList(unsigned int query_idx) const;
+
+private:
+    //! Perform a neighbor query and return the resulting NeighborList
+    std::shared_ptr<NeighborList> runQuery(const NeighborQuery* nq, const vec3<float>* query_points,
+                                           unsigned int n_query_points, const QueryArgs& qargs);
+
+    //! Filter the bonds of a neighbor query that satisfy a narrower query
+    /*! \param source The NeighborList found by the source query.
+     *  \param source_args The arguments of the source query.
+     *  \param args The arguments of the narrower query.
+     *  \param nlist The NeighborList to fill.
+     *  \return False if the source query may miss neighbors of the narrower
+     *          query, in which case nlist is not modified.
+     */
+    static bool filterBonds(const NeighborList& source, const QueryArgs& source_args, const QueryArgs& args,
+                            NeighborList& nlist);
+
+    unsigned int m_num_queries {0}; //!< Number of queries served by the last compute
+    unsigned int m_num_passes {0};  //!< Number of neighbor queries performed by the last compute
+    //! NeighborLists of the requested queries. These objects are kept alive
+    //  across calls to compute so that references to them remain valid.
+    std::vector<std::shared_ptr<NeighborList>> m_neighbor_lists;
+};
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_QUERY_PLAN_H
@@ -1,9 +1,11 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "PeriodicBuffer.h"
+#include "utils.h"
 
 /*! \file PeriodicBuffer.cc
     \brief Replicates points across periodic boundaries.
@@ -11,6 +13,16 @@
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Fraction of the box length by which points must clear the buffer distance to be rejected early
+constexpr float PERIODIC_BUFFER_CULL_TOLERANCE = 1e-4;
+
+//! Number of points whose images are collected together
+constexpr size_t PERIODIC_BUFFER_BLOCK_SIZE = 4096;
+
+}; // end anonymous namespace
+
 void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>& buff,
                              const bool use_images)
 {
@@ -55,12 +67,38 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
         images.z = 0;
     }
 
-    m_buffer_points.clear();
-    m_buffer_ids.clear();
+    const unsigned int n_points = neighbor_query->getNPoints();
+    const vec3<float> lattice_x(m_box.getLatticeVector(0));
+    const vec3<float> lattice_y(m_box.getLatticeVector(1));
+    const vec3<float> lattice_z(is2D ? vec3<float>(0, 0, 0) : m_box.getLatticeVector(2));
 
-    // for each point
-    for (unsigned int point_id = 0; point_id < neighbor_query->getNPoints(); point_id++)
-    {
+    // The buffer box has the same tilt factors as the box, so the fractional
+    // coordinate f' of an image along each axis depends only on the
+    // fractional coordinate f of the point along that axis,
+    // f' = 1/2 + (f - 1/2 + n) L / L'. The first images n = 1 and n = -1
+    // are therefore outside of the buffer box when f L > buff and
+    // (1 - f) L > buff. Points that satisfy both along every axis have no
+    // images in the buffer box and are rejected before any images are
+    // generated. The tolerance keeps the rejection conservative with respect
+    // to the rounding of the exact test below.
+    const vec3<float> cull_distance(buff + PERIODIC_BUFFER_CULL_TOLERANCE * L);
+    auto mayHaveImages = [&](const vec3<float>& point) {
+        const vec3<float> frac = m_box.makeFractional(point);
+        const vec3<float> low = frac * L;
+        const vec3<float> high = (vec3<float>(1, 1, 1) - frac) * L;
+        const bool near_x = low.x <= cull_distance.x || high.x <= cull_distance.x;
+        const bool near_y = low.y <= cull_distance.y || high.y <= cull_distance.y;
+        const bool near_z = !is2D && (low.z <= cull_distance.z || high.z <= cull_distance.z);
+        return near_x || near_y || near_z;
+    };
+
+    // Call emit(point_image) for every image of a point in the buffer box.
+    auto forEachImage = [&](unsigned int point_id, const auto& emit) {
+        const vec3<float> point = (*neighbor_query)[point_id];
+        if (!use_images && !mayHaveImages(point))
+        {
+            return;
+        }
         for (int i = use_images ? 0 : -images.x; i <= images.x; i++)
         {
             for (int j = use_images ? 0 : -images.y; j <= images.y; j++)
@@ -75,12 +113,12 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
 
                     // Compute the new position for the buffer point,
                     // shifted by images.
-                    vec3<float> point_image = (*neighbor_query)[point_id];
-                    point_image += float(i) * m_box.getLatticeVector(0);
-                    point_image += float(j) * m_box.getLatticeVector(1);
+                    vec3<float> point_image = point;
+                    point_image += float(i) * lattice_x;
+                    point_image += float(j) * lattice_y;
                     if (!is2D)
                     {
-                        point_image += float(k) * m_box.getLatticeVector(2);
+                        point_image += float(k) * lattice_z;
                     }
 
                     if (use_images)
@@ -91,8 +129,7 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
                         // have the correct number of points instead of
                         // relying on the floating point precision of the
                         // fractional check below.
-                        m_buffer_points.push_back(m_buffer_box.wrap(point_image));
-                        m_buffer_ids.push_back(point_id);
+                        emit(m_buffer_box.wrap(point_image));
                     }
                     else
                     {
@@ -104,14 +141,70 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
                         if (0 <= buff_frac.x && buff_frac.x < 1 && 0 <= buff_frac.y && buff_frac.y < 1
                             && (is2D || (0 <= buff_frac.z && buff_frac.z < 1)))
                         {
-                            m_buffer_points.push_back(point_image);
-                            m_buffer_ids.push_back(point_id);
+                            emit(point_image);
                         }
                     }
                 }
             }
         }
+    };
+
+    if (use_images)
+    {
+        // Every point has the same number of images, so each point writes
+        // its images directly to its own range of the output.
+        const size_t num_images = static_cast<size_t>(images.x + 1) * (images.y + 1) * (images.z + 1) - 1;
+        m_buffer_points.resize(num_images * n_points);
+        m_buffer_ids.resize(num_images * n_points);
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            for (size_t point_id = begin; point_id < end; ++point_id)
+            {
+                size_t index = point_id * num_images;
+                forEachImage(point_id, [&](const vec3<float>& point_image) {
+                    m_buffer_points[index] = point_image;
+                    m_buffer_ids[index] = point_id;
+                    ++index;
+                });
+            }
+        });
+        return;
     }
+
+    // The images of each block of points are collected separately, and the
+    // blocks are then copied in order to their ranges of the output.
+    const size_t num_blocks = (n_points + PERIODIC_BUFFER_BLOCK_SIZE - 1) / PERIODIC_BUFFER_BLOCK_SIZE;
+    std::vector<std::vector<vec3<float>>> block_points(num_blocks);
+    std::vector<std::vector<unsigned int>> block_ids(num_blocks);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t block_end = std::min((block + 1) * PERIODIC_BUFFER_BLOCK_SIZE, size_t(n_points));
+            for (size_t point_id = block * PERIODIC_BUFFER_BLOCK_SIZE; point_id < block_end; ++point_id)
+            {
+                forEachImage(point_id, [&](const vec3<float>& point_image) {
+                    block_points[block].push_back(point_image);
+                    block_ids[block].push_back(point_id);
+                });
+            }
+        }
+    });
+
+    std::vector<size_t> offsets(num_blocks + 1, 0);
+    for (size_t block = 0; block < num_blocks; ++block)
+    {
+        offsets[block + 1] = offsets[block] + block_points[block].size();
+    }
+    m_buffer_points.resize(offsets[num_blocks]);
+    m_buffer_ids.resize(offsets[num_blocks]);
+    util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            std::copy(block_points[block].begin(), block_points[block].end(),
+                      m_buffer_points.begin() + offsets[block]);
+            std::copy(block_ids[block].begin(), block_ids[block].end(),
+                      m_buffer_ids.begin() + offsets[block]);
+        }
+    });
 }
 
 }; }; // end namespace freud::locality
@@ -39,13 +39,13 @@ public:
                  const bool use_images);
 
     //! Return the buffer points
-    std::vector<vec3<float>> getBufferPoints() const
+    const std::vector<vec3<float>>& getBufferPoints() const
     {
         return m_buffer_points;
     }
 
     //! Return the buffer ids
-    std::vector<unsigned int> getBufferIds() const
+    const std::vector<unsigned int>& getBufferIds() const
     {
         return m_buffer_ids;
     }
@@ -70,6 +70,32 @@ public:
         return aq->querySingle(query_point, query_point_idx, qargs);
     }
 
+    //! Forward batched queries to the underlying AABBQuery.
+    void queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end, QueryArgs qargs,
+                    BondSink& sink) const override
+    {
+        if (!aq)
+        {
+            throw std::runtime_error("The underlying AABBQuery object has not yet been initialized. Please "
+                                     "report this error.");
+        }
+
+        aq->queryBatch(query_points, begin, end, qargs, sink);
+    }
+
+    //! Forward indexed queries to the underlying AABBQuery.
+    void queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                      unsigned int n, QueryArgs qargs, BondSink& sink) const override
+    {
+        if (!aq)
+        {
+            throw std::runtime_error("The underlying AABBQuery object has not yet been initialized. Please "
+                                     "report this error.");
+        }
+
+        aq->queryIndexed(query_points, query_point_indices, n, qargs, sink);
+    }
+
 private:
     mutable std::unique_ptr<AABBQuery> aq; //!< The AABBQuery object that will be used to perform queries.
 };
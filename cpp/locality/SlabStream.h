@@ -0,0 +1,277 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SLAB_STREAM_H
+#define SLAB_STREAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tbb/tbb.h>
+#include <utility>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Box.h"
+#include "TrajectoryPipeline.h"
+#include "VectorMath.h"
+
+/*! \file SlabStream.h
+    \brief Streamed processing of systems too large for memory in slabs.
+*/
+
+namespace freud { namespace locality {
+
+//! Function that loads the points of a system within a range of fractional coordinates.
+/*! The source is called with a range [begin, end) of fractional coordinates
+ *  along the first box vector, with 0 <= begin < end <= 1, and appends the
+ *  points whose fractional coordinate, wrapped into [0, 1), lies in the range
+ *  to the vector. It returns false if the points could not be loaded. Each
+ *  point must be loaded by exactly one range of any partition of [0, 1), so
+ *  the source must compare the fractional coordinates to the bounds of the
+ *  ranges exactly as they are given.
+ */
+using SlabSource = std::function<bool(float, float, std::vector<vec3<float>>&)>;
+
+//! Function pointer that loads the points of a range, for sources implemented in other languages.
+/*! The callback is called with the bounds of the range and the data it was
+ *  registered with, and sets the pointer to the points of the range and
+ *  their number. The points must remain valid until the next call.
+ */
+using SlabCallback = bool (*)(float, float, void*, const vec3<float>**, unsigned int*);
+
+//! Create a slab source from a callback.
+inline SlabSource makeSlabCallbackSource(SlabCallback callback, void* data)
+{
+    return [callback, data](float begin, float end, std::vector<vec3<float>>& points) {
+        const vec3<float>* range_points = nullptr;
+        unsigned int n_range_points = 0;
+        if (!callback(begin, end, data, &range_points, &n_range_points))
+        {
+            return false;
+        }
+        points.insert(points.end(), range_points, range_points + n_range_points);
+        return true;
+    };
+}
+
+//! Create a slab source from an array of points, which is scanned for each range.
+/*! \param box The box of the points.
+ *  \param points The points, which must remain valid while the source is used.
+ *  \param n_points The number of points.
+ */
+inline SlabSource makeSlabArraySource(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+{
+    return [box, points, n_points](float begin, float end, std::vector<vec3<float>>& range_points) {
+        for (unsigned int i = 0; i < n_points; ++i)
+        {
+            float fraction = box.makeFractional(points[i]).x;
+            fraction -= std::floor(fraction);
+            if (fraction >= float(1.0))
+            {
+                fraction = 0;
+            }
+            if (fraction >= begin && fraction < end)
+            {
+                range_points.push_back(points[i]);
+            }
+        }
+        return true;
+    };
+}
+
+//! Function that sums an array of counts over the processes of a domain decomposition, in place.
+/*! Every process must call it with an array of the same size, for instance
+ *  through an MPI allreduce. It returns false if the counts could not be
+ *  reduced.
+ */
+using CountReducer = std::function<bool(std::uint64_t*, size_t)>;
+
+//! Function pointer that sums counts over processes, for reducers implemented in other languages.
+using CountCallback = bool (*)(std::uint64_t*, size_t, void*);
+
+//! Create a count reducer from a callback.
+inline CountReducer makeCountCallbackReducer(CountCallback callback, void* data)
+{
+    return [callback, data](std::uint64_t* counts, size_t n_counts) {
+        return callback(counts, n_counts, data);
+    };
+}
+
+//! The slabs of a system owned by one process of a domain decomposition.
+/*! Each process processes the slabs of its domain, loading their halos from
+ *  the source, so the domains are decomposed without exchanging points
+ *  between processes. The counts of the domains are then summed with the
+ *  reducer, which every process calls once per frame.
+ */
+struct SlabDomain
+{
+    unsigned int first_slab {0}; //!< First slab of the domain
+    unsigned int last_slab {
+        std::numeric_limits<unsigned int>::max()}; //!< One past the last slab of the domain, clamped to
+                                                   //!< the number of slabs
+    CountReducer reducer; //!< Sums the counts of the domains, or empty if the domain is the whole system
+};
+
+//! The points of one slab of a system, followed by the points of the halo around it.
+struct Slab
+{
+    size_t index {0};                //!< Index of the slab
+    std::vector<vec3<float>> points; //!< Points of the slab followed by the points of its halo
+    unsigned int n_slab_points {0};  //!< Number of points of the slab
+};
+
+//! Relative margin added to the width of the halos, so that bonds of length r_max are not lost to rounding.
+constexpr float SLAB_HALO_MARGIN = 1e-4;
+
+//! Process a system in slabs along the first box vector, one slab and its halo at a time.
+/*! The system is divided into slabs of equal width in the fractional
+ *  coordinate along the first box vector. For each slab, the points of the
+ *  slab and of a halo around it, which contains every point within the halo
+ *  width of the slab, are loaded from the source and an AABBQuery is built
+ *  over them with the periodic box of the whole system. Each bond of length
+ *  less than the halo width from a point of the slab is then found by
+ *  querying the points of the slab, so the bonds of the whole system are
+ *  found exactly once while only one slab and its halo are held in memory.
+ *  The halos are wrapped through the periodic boundaries, and the halo of a
+ *  slab is the rest of the system if the system is too thin for disjoint
+ *  halos on both sides.
+ *
+ *  As in processTrajectory, the slabs are loaded and their neighbor queries
+ *  built in one stage of a pipeline while the body processes the previous
+ *  slabs in a second stage. Slabs without points are skipped. Only the
+ *  slabs from first_slab to last_slab are processed, so that the slabs can be
+ *  divided among the processes of a domain decomposition, see SlabDomain.
+ *
+ *  \param box The box of the system, which must be periodic along the first box vector.
+ *  \param source The source of the points.
+ *  \param n_slabs The number of slabs.
+ *  \param first_slab The first slab to process.
+ *  \param last_slab One past the last slab to process, at most n_slabs.
+ *  \param halo_width The width of the halos, the largest bond length.
+ *  \param body Function taking the NeighborQuery of the slab and its halo,
+ *         and the Slab, whose first n_slab_points points are the query
+ *         points of the slab.
+ *  \param max_slabs_in_flight The number of slabs that may be loaded at the
+ *         same time, which bounds the memory used.
+ */
+template<typename Body>
+void processSlabs(const box::Box& box, const SlabSource& source, unsigned int n_slabs,
+                  unsigned int first_slab, unsigned int last_slab, float halo_width, const Body& body,
+                  size_t max_slabs_in_flight = 2)
+{
+    if (n_slabs == 0)
+    {
+        throw std::invalid_argument("A system must be processed in at least one slab.");
+    }
+    if (first_slab > last_slab || last_slab > n_slabs)
+    {
+        throw std::invalid_argument("The slabs to process must be a range of the slabs of the system.");
+    }
+    if (!(halo_width > 0) || !std::isfinite(halo_width))
+    {
+        throw std::invalid_argument("The halo of the slabs must have a positive and finite width.");
+    }
+    if (!box.getPeriodic().x)
+    {
+        throw std::invalid_argument("A system can only be processed in slabs if its box is periodic along "
+                                    "the first box vector.");
+    }
+
+    const float halo = halo_width * (float(1.0) + SLAB_HALO_MARGIN) / box.getNearestPlaneDistance().x;
+    const auto slab_bound = [n_slabs](size_t index) {
+        return index == n_slabs ? float(1.0) : static_cast<float>(index) / static_cast<float>(n_slabs);
+    };
+
+    // The ranges of the halo of a slab, split at the periodic boundary.
+    // The ranges meet the slab at its own bounds, so that no point is loaded
+    // twice, and the halos on both sides are replaced by the rest of the
+    // system if they could overlap.
+    const auto halo_ranges = [halo](float begin, float end) {
+        std::vector<std::pair<float, float>> ranges;
+        if (end - begin + float(2.0) * halo >= float(1.0) - SLAB_HALO_MARGIN)
+        {
+            ranges = {{end, float(1.0)}, {0, begin}};
+            return ranges;
+        }
+        const float lower = begin - halo;
+        const float upper = end + halo;
+        if (lower < 0)
+        {
+            ranges.emplace_back(lower + float(1.0), float(1.0));
+            ranges.emplace_back(0, begin);
+        }
+        else
+        {
+            ranges.emplace_back(lower, begin);
+        }
+        if (upper > float(1.0))
+        {
+            ranges.emplace_back(end, float(1.0));
+            ranges.emplace_back(0, upper - float(1.0));
+        }
+        else
+        {
+            ranges.emplace_back(end, upper);
+        }
+        return ranges;
+    };
+
+    struct PreparedSlab
+    {
+        Slab slab;
+        std::unique_ptr<AABBQuery> neighbor_query;
+    };
+
+    size_t next_index = first_slab;
+    tbb::parallel_pipeline(
+        std::max(max_slabs_in_flight, size_t(1)),
+        tbb::make_filter<void, std::shared_ptr<PreparedSlab>>(
+            PIPELINE_SERIAL_IN_ORDER,
+            [&](tbb::flow_control& control) -> std::shared_ptr<PreparedSlab> {
+                auto prepared = std::make_shared<PreparedSlab>();
+                Slab& slab = prepared->slab;
+                do
+                {
+                    if (next_index == last_slab)
+                    {
+                        control.stop();
+                        return nullptr;
+                    }
+                    slab.index = next_index++;
+                    slab.points.clear();
+                    const float begin = slab_bound(slab.index);
+                    const float end = slab_bound(slab.index + 1);
+                    bool loaded = source(begin, end, slab.points);
+                    slab.n_slab_points = static_cast<unsigned int>(slab.points.size());
+                    if (loaded && slab.n_slab_points != 0)
+                    {
+                        for (const auto& range : halo_ranges(begin, end))
+                        {
+                            loaded = loaded
+                                && (range.first >= range.second
+                                    || source(range.first, range.second, slab.points));
+                        }
+                    }
+                    if (!loaded)
+                    {
+                        throw std::runtime_error("The points of a slab could not be loaded.");
+                    }
+                } while (slab.n_slab_points == 0);
+                prepared->neighbor_query = std::make_unique<AABBQuery>(
+                    box, slab.points.data(), static_cast<unsigned int>(slab.points.size()));
+                return prepared;
+            })
+            & tbb::make_filter<std::shared_ptr<PreparedSlab>, void>(
+                PIPELINE_SERIAL_IN_ORDER, [&](const std::shared_ptr<PreparedSlab>& prepared) {
+                    body(prepared->neighbor_query.get(), prepared->slab);
+                }));
+}
+
+}; }; // end namespace freud::locality
+
+#endif // SLAB_STREAM_H
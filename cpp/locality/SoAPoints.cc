@@ -0,0 +1,65 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <limits>
+
+#include "SoAPoints.h"
+#include "utils.h"
+
+/*! \file SoAPoints.cc
+    \brief Structure-of-arrays storage of point positions for vectorized scans.
+*/
+
+namespace freud { namespace locality {
+
+FREUD_SIMD_CLONES
+void differencesKernel(const float* __restrict px, const float* __restrict py, const float* __restrict pz,
+                       size_t n, const vec3<float> point, float* __restrict x, float* __restrict y,
+                       float* __restrict z)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = px[i] - point.x;
+        y[i] = py[i] - point.y;
+        z[i] = pz[i] - point.z;
+    }
+}
+
+FREUD_SIMD_CLONES
+void distancesSqKernel(const float* __restrict px, const float* __restrict py, const float* __restrict pz,
+                       size_t n, const vec3<float> point, float* __restrict r_sq)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const float dx = px[i] - point.x;
+        const float dy = py[i] - point.y;
+        const float dz = pz[i] - point.z;
+        r_sq[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+void SoAPoints::resize(unsigned int n)
+{
+    m_size = n;
+    m_padded_size = ((n + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE;
+    m_storage.assign(3 * static_cast<size_t>(m_padded_size) + BLOCK_SIZE,
+                     std::numeric_limits<float>::infinity());
+}
+
+void SoAPoints::computeDifferences(const vec3<float>& point, unsigned int begin, unsigned int end, float* x,
+                                   float* y, float* z) const
+{
+    const float* px = data();
+    differencesKernel(px + begin, px + m_padded_size + begin, px + 2 * m_padded_size + begin, end - begin,
+                      point, x, y, z);
+}
+
+void SoAPoints::computeDistancesSq(const vec3<float>& point, unsigned int begin, unsigned int end,
+                                   float* r_sq) const
+{
+    const float* px = data();
+    distancesSqKernel(px + begin, px + m_padded_size + begin, px + 2 * m_padded_size + begin, end - begin,
+                      point, r_sq);
+}
+
+}; }; // end namespace freud::locality
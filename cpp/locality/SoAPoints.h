@@ -0,0 +1,111 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SOA_POINTS_H
+#define SOA_POINTS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "VectorMath.h"
+
+/*! \file SoAPoints.h
+    \brief Structure-of-arrays storage of point positions for vectorized scans.
+*/
+
+namespace freud { namespace locality {
+
+//! Point positions stored as separate, cache line aligned x, y, and z arrays
+/*! NeighborQuery implementations keep a copy of their points in this layout,
+ *  ordered the same way as their search structure, so that the points of a
+ *  cell or tree leaf are contiguous and their distances to a query point can
+ *  be computed many at a time with vector instructions. Each array is padded
+ *  to a whole number of blocks, and unused slots hold infinite coordinates
+ *  so that they are never within any cutoff of a finite query point.
+ */
+class SoAPoints
+{
+public:
+    //! Number of floats in a 64 byte cache line
+    static constexpr unsigned int BLOCK_SIZE = 16;
+
+    //! Constructor
+    SoAPoints() = default;
+
+    //! Allocate n slots, all of which are initially unused
+    void resize(unsigned int n);
+
+    //! Set the position stored in a slot
+    void set(unsigned int slot, const vec3<float>& point)
+    {
+        float* x = data();
+        x[slot] = point.x;
+        x[m_padded_size + slot] = point.y;
+        x[2 * m_padded_size + slot] = point.z;
+    }
+
+    //! Get the position stored in a slot
+    vec3<float> get(unsigned int slot) const
+    {
+        const float* x = data();
+        return {x[slot], x[m_padded_size + slot], x[2 * m_padded_size + slot]};
+    }
+
+    //! Get the number of slots
+    unsigned int size() const
+    {
+        return m_size;
+    }
+
+    //! Compute the vectors from a point to the points in a range of slots
+    /*! \param point The origin of the vectors.
+     *  \param begin The first slot.
+     *  \param end One past the last slot.
+     *  \param x Output array of end - begin x components.
+     *  \param y Output array of end - begin y components.
+     *  \param z Output array of end - begin z components.
+     */
+    void computeDifferences(const vec3<float>& point, unsigned int begin, unsigned int end, float* x, float* y,
+                            float* z) const;
+
+    //! Compute the squared distances from a point to the points in a range of slots
+    /*! \param point The point to measure distances from.
+     *  \param begin The first slot.
+     *  \param end One past the last slot.
+     *  \param r_sq Output array of end - begin squared distances.
+     */
+    void computeDistancesSq(const vec3<float>& point, unsigned int begin, unsigned int end,
+                            float* r_sq) const;
+
+private:
+    //! Get the first element of the x array, which is aligned to a cache line
+    float* data()
+    {
+        return m_storage.data() + alignmentOffset();
+    }
+
+    //! Get the first element of the x array, which is aligned to a cache line
+    const float* data() const
+    {
+        return m_storage.data() + alignmentOffset();
+    }
+
+    //! Number of floats between the start of the storage and the next cache line
+    /*! The offset is recomputed on every access so that copies of this object,
+     *  whose storage may be aligned differently, remain valid.
+     */
+    unsigned int alignmentOffset() const
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+        const auto misalignment = static_cast<unsigned int>(address % (BLOCK_SIZE * sizeof(float)));
+        return (misalignment == 0) ? 0 : (BLOCK_SIZE * sizeof(float) - misalignment) / sizeof(float);
+    }
+
+    unsigned int m_size {0};        //!< Number of slots
+    unsigned int m_padded_size {0}; //!< Number of slots rounded up to whole blocks
+    std::vector<float> m_storage;   //!< The x, y, and z arrays, with room to align them
+};
+
+}; }; // end namespace freud::locality
+
+#endif // SOA_POINTS_H
@@ -0,0 +1,127 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TRAJECTORY_PIPELINE_H
+#define TRAJECTORY_PIPELINE_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tbb/tbb.h>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Box.h"
+#include "VectorMath.h"
+
+/*! \file TrajectoryPipeline.h
+    \brief Pipelined processing of the frames of a trajectory.
+*/
+
+namespace freud { namespace locality {
+
+//! The data of one frame of a trajectory.
+/*! The pointers must remain valid until the frame has been processed.
+ */
+struct TrajectoryFrame
+{
+    box::Box box;                              //!< Simulation box of the frame
+    const vec3<float>* points {nullptr};       //!< Point positions
+    unsigned int n_points {0};                 //!< Number of points
+    const quat<float>* orientations {nullptr}; //!< Point orientations, for computes that need them
+};
+
+//! Function that fills in the frame with the given index, returning false if there is no such frame.
+/*! Frames are requested in order, one at a time, starting from index 0.
+ */
+using FrameSource = std::function<bool(size_t, TrajectoryFrame&)>;
+
+//! Create a frame source from arrays of per-frame data.
+/*! \param boxes The box of each frame.
+ *  \param points The points of each frame.
+ *  \param n_points The number of points of each frame.
+ *  \param orientations The orientations of the points of each frame, or an
+ *         empty vector if no orientations are needed.
+ */
+inline FrameSource makeFrameArraySource(const std::vector<box::Box>& boxes,
+                                        const std::vector<const vec3<float>*>& points,
+                                        const std::vector<unsigned int>& n_points,
+                                        const std::vector<const quat<float>*>& orientations = {})
+{
+    if (points.size() != boxes.size() || n_points.size() != boxes.size()
+        || (!orientations.empty() && orientations.size() != boxes.size()))
+    {
+        throw std::invalid_argument("Every frame of a trajectory must have a box, points and a number of "
+                                    "points, and orientations if any frame has them.");
+    }
+    return [boxes, points, n_points, orientations](size_t index, TrajectoryFrame& frame) {
+        if (index >= boxes.size())
+        {
+            return false;
+        }
+        frame.box = boxes[index];
+        frame.points = points[index];
+        frame.n_points = n_points[index];
+        frame.orientations = orientations.empty() ? nullptr : orientations[index];
+        return true;
+    };
+}
+
+#if TBB_VERSION_MAJOR >= 2021
+constexpr auto PIPELINE_SERIAL_IN_ORDER = tbb::filter_mode::serial_in_order;
+#else
+constexpr auto PIPELINE_SERIAL_IN_ORDER = tbb::filter::serial_in_order;
+#endif
+
+//! Process the frames of a trajectory in a pipeline.
+/*! The frames are read from the source and an AABBQuery is built for each
+ *  frame in one stage of the pipeline, and the body is called on the frames
+ *  in order in a second stage. While the body processes one frame, the
+ *  neighbor queries of the following frames are built concurrently, so the
+ *  cores are kept busy over the whole trajectory rather than idling while
+ *  each neighbor query is built. The body may itself run parallel loops.
+ *
+ *  \param source The source of the frames.
+ *  \param body Function taking the frame index, the NeighborQuery of the
+ *         frame and the TrajectoryFrame itself.
+ *  \param max_frames_in_flight The number of frames whose neighbor queries
+ *         may exist at the same time, which bounds the memory used.
+ */
+template<typename Body>
+void processTrajectory(const FrameSource& source, const Body& body, size_t max_frames_in_flight = 2)
+{
+    struct PreparedFrame
+    {
+        size_t index;
+        TrajectoryFrame frame;
+        std::unique_ptr<AABBQuery> neighbor_query;
+    };
+
+    size_t next_index = 0;
+    tbb::parallel_pipeline(
+        std::max(max_frames_in_flight, size_t(1)),
+        tbb::make_filter<void, std::shared_ptr<PreparedFrame>>(
+            PIPELINE_SERIAL_IN_ORDER,
+            [&](tbb::flow_control& control) -> std::shared_ptr<PreparedFrame> {
+                auto prepared = std::make_shared<PreparedFrame>();
+                prepared->index = next_index;
+                if (!source(next_index, prepared->frame))
+                {
+                    control.stop();
+                    return nullptr;
+                }
+                ++next_index;
+                prepared->neighbor_query = std::make_unique<AABBQuery>(
+                    prepared->frame.box, prepared->frame.points, prepared->frame.n_points);
+                return prepared;
+            })
+            & tbb::make_filter<std::shared_ptr<PreparedFrame>, void>(
+                PIPELINE_SERIAL_IN_ORDER, [&](const std::shared_ptr<PreparedFrame>& prepared) {
+                    body(prepared->index, prepared->neighbor_query.get(), prepared->frame);
+                }));
+}
+
+}; }; // end namespace freud::locality
+
+#endif // TRAJECTORY_PIPELINE_H
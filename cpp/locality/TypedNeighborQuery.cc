@@ -0,0 +1,202 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "TypedNeighborQuery.h"
+
+/*! \file TypedNeighborQuery.cc
+    \brief Query points of several types for neighbors of all or one type.
+*/
+
+namespace freud { namespace locality {
+
+TypedNeighborQuery::TypedNeighborQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                       const unsigned int* types, unsigned int n_types)
+    : NeighborQuery(box, points, n_points), m_types(types, types + n_points)
+{
+    const unsigned int max_type = *std::max_element(m_types.begin(), m_types.end());
+    if (n_types == 0)
+    {
+        n_types = max_type + 1;
+    }
+    else if (max_type >= n_types)
+    {
+        throw std::invalid_argument("TypedNeighborQuery types must be less than the number of types.");
+    }
+
+    // Group the points by type with a counting sort, which keeps the points
+    // of each type in order of index.
+    m_type_offsets.assign(n_types + 1, 0);
+    for (const unsigned int type : m_types)
+    {
+        ++m_type_offsets[type + 1];
+    }
+    std::partial_sum(m_type_offsets.begin(), m_type_offsets.end(), m_type_offsets.begin());
+
+    m_type_points.resize(n_points);
+    m_type_point_indices.resize(n_points);
+    std::vector<unsigned int> next_slot(m_type_offsets.begin(), m_type_offsets.end() - 1);
+    for (unsigned int i = 0; i < n_points; ++i)
+    {
+        const unsigned int slot = next_slot[m_types[i]]++;
+        m_type_points[slot] = points[i];
+        m_type_point_indices[slot] = i;
+    }
+
+    m_type_queries.resize(n_types);
+    for (unsigned int type = 0; type < n_types; ++type)
+    {
+        if (getNumPointsOfType(type) != 0)
+        {
+            m_type_queries[type] = std::make_unique<AABBQuery>(
+                m_box, m_type_points.data() + m_type_offsets[type], getNumPointsOfType(type));
+        }
+    }
+}
+
+TypedNeighborQuery::~TypedNeighborQuery() = default;
+
+void TypedNeighborQuery::validatePointType(const QueryArgs& args) const
+{
+    if (args.point_type != DEFAULT_POINT_TYPE && args.point_type >= getNumTypes())
+    {
+        throw std::runtime_error("The point_type query argument must be less than the number of types.");
+    }
+}
+
+QueryArgs TypedNeighborQuery::getTypeQueryArgs(const QueryArgs& args)
+{
+    QueryArgs type_args(args);
+    type_args.point_type = DEFAULT_POINT_TYPE;
+    type_args.exclude_ii = false;
+    if (args.mode == QueryType::nearest && args.exclude_ii)
+    {
+        ++type_args.num_neighbors;
+    }
+    return type_args;
+}
+
+void TypedNeighborQuery::selectNeighbors(const QueryArgs& args, std::vector<NeighborBond>& candidates)
+{
+    // The nearest neighbors of all types are among the nearest neighbors of
+    // each type.
+    if (args.mode == QueryType::nearest && candidates.size() > args.num_neighbors)
+    {
+        std::partial_sort(candidates.begin(), candidates.begin() + args.num_neighbors, candidates.end(),
+                          compareNeighborDistance);
+        candidates.resize(args.num_neighbors);
+    }
+}
+
+std::shared_ptr<NeighborQueryPerPointIterator>
+TypedNeighborQuery::querySingle(const vec3<float> query_point, unsigned int query_point_idx,
+                                QueryArgs args) const
+{
+    this->validateQueryArgs(args);
+    const QueryArgs type_args = getTypeQueryArgs(args);
+    const bool all_types = args.point_type == DEFAULT_POINT_TYPE;
+    const unsigned int first_type = all_types ? 0 : args.point_type;
+    const unsigned int last_type = all_types ? getNumTypes() : args.point_type + 1;
+
+    std::vector<NeighborBond> candidates;
+    for (unsigned int type = first_type; type < last_type; ++type)
+    {
+        if (m_type_queries[type] == nullptr)
+        {
+            continue;
+        }
+        std::shared_ptr<NeighborQueryPerPointIterator> it
+            = m_type_queries[type]->querySingle(query_point, query_point_idx, type_args);
+        for (NeighborBond nb = it->next(); !it->end(); nb = it->next())
+        {
+            const unsigned int point_idx = m_type_point_indices[m_type_offsets[type] + nb.point_idx];
+            if (!args.exclude_ii || point_idx != query_point_idx)
+            {
+                candidates.emplace_back(query_point_idx, point_idx, nb.distance);
+            }
+        }
+    }
+    selectNeighbors(args, candidates);
+    return std::make_shared<TypedNeighborQueryIterator>(this, query_point, query_point_idx, args.r_max,
+                                                        args.r_min, args.exclude_ii, std::move(candidates));
+}
+
+void TypedNeighborQuery::queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end,
+                                    QueryArgs args, BondSink& sink) const
+{
+    queryTypes(query_points, nullptr, begin, end, args, sink);
+}
+
+void TypedNeighborQuery::queryIndexed(const vec3<float>* query_points,
+                                      const unsigned int* query_point_indices, unsigned int n, QueryArgs args,
+                                      BondSink& sink) const
+{
+    queryTypes(query_points, query_point_indices, 0, n, args, sink);
+}
+
+void TypedNeighborQuery::queryTypes(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                                    unsigned int begin, unsigned int end, QueryArgs args,
+                                    BondSink& sink) const
+{
+    this->validateQueryArgs(args);
+    const QueryArgs type_args = getTypeQueryArgs(args);
+    const bool all_types = args.point_type == DEFAULT_POINT_TYPE;
+    const unsigned int first_type = all_types ? 0 : args.point_type;
+    const unsigned int last_type = all_types ? getNumTypes() : args.point_type + 1;
+
+    // Every tree emits the bonds of the query points in the order in which
+    // they are processed, so the bonds of each query point are merged from
+    // the results of all trees with one cursor per tree.
+    std::vector<BondSink> type_sinks(last_type - first_type);
+    for (unsigned int type = first_type; type < last_type; ++type)
+    {
+        const AABBQuery* type_query = m_type_queries[type].get();
+        if (type_query == nullptr)
+        {
+            continue;
+        }
+        if (query_point_indices == nullptr)
+        {
+            type_query->queryBatch(query_points, begin, end, type_args, type_sinks[type - first_type]);
+        }
+        else
+        {
+            type_query->queryIndexed(query_points, query_point_indices + begin, end - begin, type_args,
+                                     type_sinks[type - first_type]);
+        }
+    }
+
+    std::vector<size_t> cursors(type_sinks.size(), 0);
+    std::vector<NeighborBond> candidates;
+    for (unsigned int position = begin; position < end; ++position)
+    {
+        const unsigned int query_point_idx
+            = query_point_indices == nullptr ? position : query_point_indices[position];
+        candidates.clear();
+        for (size_t sink_idx = 0; sink_idx < type_sinks.size(); ++sink_idx)
+        {
+            const std::vector<NeighborBond>& bonds = type_sinks[sink_idx].bonds;
+            const unsigned int* point_indices
+                = m_type_point_indices.data() + m_type_offsets[first_type + sink_idx];
+            size_t& cursor = cursors[sink_idx];
+            for (; cursor < bonds.size() && bonds[cursor].query_point_idx == query_point_idx; ++cursor)
+            {
+                const unsigned int point_idx = point_indices[bonds[cursor].point_idx];
+                if (!args.exclude_ii || point_idx != query_point_idx)
+                {
+                    candidates.emplace_back(query_point_idx, point_idx, bonds[cursor].distance);
+                }
+            }
+        }
+        selectNeighbors(args, candidates);
+        for (const NeighborBond& nb : candidates)
+        {
+            sink.emit(nb.query_point_idx, nb.point_idx, nb.distance);
+        }
+    }
+}
+
+}; }; // end namespace freud::locality
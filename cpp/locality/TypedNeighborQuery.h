@@ -0,0 +1,158 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TYPED_NEIGHBOR_QUERY_H
+#define TYPED_NEIGHBOR_QUERY_H
+
+#include <memory>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Box.h"
+#include "NeighborQuery.h"
+
+/*! \file TypedNeighborQuery.h
+    \brief Query points of several types for neighbors of all or one type.
+*/
+
+namespace freud { namespace locality {
+
+//! NeighborQuery of points of several types with an AABB tree for each type.
+/*! The points are grouped by type into one array, ordered by index within
+ *  each type, and an AABBQuery is built over the points of each type. Queries
+ *  with the point_type query argument only search the tree of that type, so
+ *  the neighbors of one type can be found without building a NeighborQuery of
+ *  a subset of the points. Queries for all types search every tree and merge
+ *  the results, keeping the nearest neighbors of all types for nearest
+ *  neighbor queries. Point indices of the bonds are always indices into the
+ *  full array of points.
+ */
+class TypedNeighborQuery : public NeighborQuery
+{
+public:
+    //! Constructor
+    /*! \param box The box containing the points.
+     *  \param points The point coordinates.
+     *  \param n_points The number of points.
+     *  \param types The type of each point.
+     *  \param n_types The number of types, or 0 to use one more than the
+     *                 largest type.
+     */
+    TypedNeighborQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                       const unsigned int* types, unsigned int n_types = 0);
+
+    //! Destructor
+    ~TypedNeighborQuery() override;
+
+    //! Implementation of per-particle query for TypedNeighborQuery (see NeighborQuery.h for documentation).
+    std::shared_ptr<NeighborQueryPerPointIterator>
+    querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
+
+    //! Implementation of batched queries for TypedNeighborQuery (see NeighborQuery.h for documentation).
+    /*! Each tree that is searched finds the neighbors of the whole batch with
+     *  its own batched query, and the bonds of each query point are merged
+     *  from the results of all trees.
+     */
+    void queryBatch(const vec3<float>* query_points, unsigned int begin, unsigned int end, QueryArgs args,
+                    BondSink& sink) const override;
+
+    //! Implementation of indexed queries for TypedNeighborQuery (see NeighborQuery.h for documentation).
+    void queryIndexed(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                      unsigned int n, QueryArgs args, BondSink& sink) const override;
+
+    //! Get the number of types
+    unsigned int getNumTypes() const
+    {
+        return static_cast<unsigned int>(m_type_queries.size());
+    }
+
+    //! Get the type of each point
+    const unsigned int* getTypes() const
+    {
+        return m_types.data();
+    }
+
+    //! Get the number of points of a type
+    unsigned int getNumPointsOfType(unsigned int type) const
+    {
+        return m_type_offsets.at(type + 1) - m_type_offsets.at(type);
+    }
+
+protected:
+    //! Validate the point_type query argument, which must be a type of this object.
+    void validatePointType(const QueryArgs& args) const override;
+
+private:
+    //! Find the neighbors of a range of positions of query points (see queryBatch)
+    /*! \param query_points The points to find neighbors for.
+     *  \param query_point_indices The indices of the query points to process,
+     *                             or nullptr to process the query points in
+     *                             order of index.
+     *  \param begin The first position to process.
+     *  \param end One past the last position to process.
+     *  \param args The query arguments.
+     *  \param sink The destination for the bonds that are found.
+     */
+    void queryTypes(const vec3<float>* query_points, const unsigned int* query_point_indices,
+                    unsigned int begin, unsigned int end, QueryArgs args, BondSink& sink) const;
+
+    //! Get the query arguments with which the tree of each type is searched.
+    /*! Self-neighbors are excluded by comparing indices into the full array
+     *  of points, so the trees are searched including them, for one more
+     *  nearest neighbor if necessary.
+     */
+    static QueryArgs getTypeQueryArgs(const QueryArgs& args);
+
+    //! Keep the neighbors of a query point that the query asked for.
+    /*! \param args The query arguments.
+     *  \param candidates The bonds of the query point found in all searched
+     *                    trees, with self-neighbors already excluded.
+     */
+    static void selectNeighbors(const QueryArgs& args, std::vector<NeighborBond>& candidates);
+
+    std::vector<unsigned int> m_types;                      //!< Type of each point
+    std::vector<unsigned int> m_type_offsets;               //!< Offset of the points of each type
+    std::vector<vec3<float>> m_type_points;                 //!< Point coordinates grouped by type
+    std::vector<unsigned int> m_type_point_indices;         //!< Index of each point of m_type_points
+    std::vector<std::unique_ptr<AABBQuery>> m_type_queries; //!< Tree of each type, or nullptr if empty
+};
+
+//! Iterator over the neighbors of a query point found by a TypedNeighborQuery.
+/*! The neighbors are found from all searched trees when the iterator is
+ *  constructed, since nearest neighbor queries can only tell which neighbors
+ *  to keep once all trees have been searched.
+ */
+class TypedNeighborQueryIterator : public NeighborQueryPerPointIterator
+{
+public:
+    //! Constructor
+    TypedNeighborQueryIterator(const TypedNeighborQuery* neighbor_query, const vec3<float>& query_point,
+                               unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                               std::vector<NeighborBond> bonds)
+        : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min,
+                                        exclude_ii),
+          m_bonds(std::move(bonds))
+    {}
+
+    //! Empty Destructor
+    ~TypedNeighborQueryIterator() override = default;
+
+    //! Get the next element.
+    NeighborBond next() override
+    {
+        if (m_cur_bond < m_bonds.size())
+        {
+            return m_bonds[m_cur_bond++];
+        }
+        m_finished = true;
+        return ITERATOR_TERMINATOR;
+    }
+
+private:
+    std::vector<NeighborBond> m_bonds; //!< The neighbors of the query point
+    size_t m_cur_bond {0};             //!< Index of the next neighbor to return
+};
+
+}; }; // end namespace freud::locality
+
+#endif // TYPED_NEIGHBOR_QUERY_H
@@ -1,13 +1,20 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <iterator>
+#include <limits>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 #include <vector>
 
 #include "NeighborBond.h"
+#include "PeriodicBuffer.h"
 #include "Voronoi.h"
+#include "diagonalize.h"
 
 /*! \file Voronoi.cc
     \brief Computes Voronoi neighbors for a set of points.
@@ -15,161 +22,708 @@
 
 namespace freud { namespace locality {
 
-// Voronoi calculations should be kept in double precision.
-void Voronoi::compute(const freud::locality::NeighborQuery* nq)
-{
-    const auto box = nq->getBox();
-    const auto n_points = nq->getNPoints();
+namespace {
 
-    m_polytopes.resize(n_points);
-    m_volumes.prepare(n_points);
+//! Minimum number of points owned by each block of the domain decomposition
+constexpr unsigned int VORONOI_MIN_BLOCK_POINTS = 16384;
 
-    const vec3<float> v1 = box.getLatticeVector(0);
-    const vec3<float> v2 = box.getLatticeVector(1);
-    const vec3<float> v3 = (box.is2D() ? vec3<float>(0, 0, 1) : box.getLatticeVector(2));
+//! Number of blocks of the domain decomposition per thread
+constexpr unsigned int VORONOI_BLOCKS_PER_THREAD = 4;
 
-    // This heuristic for choosing blocks is based on the voro::pre_container
-    // guess_optimal method. By computing the heuristic directly, we avoid
-    // having to create a pre_container. This saves time because the
-    // pre_container cannot be used to set up container_periodic (only
-    // non-periodic containers are compatible).
-    const float block_scale
-        = std::pow(n_points / (voro::optimal_particles * box.getVolume()), float(1.0 / 3.0));
-    const int voro_blocks_x = int(box.getLx() * block_scale + 1);
-    const int voro_blocks_y = int(box.getLy() * block_scale + 1);
-    const int voro_blocks_z = int(box.getLz() * block_scale + 1);
+//! Thickness of the ghost layer around each block in mean interparticle spacings
+constexpr double VORONOI_GHOST_SPACINGS = 3.0;
 
-    voro::container_periodic container(v1.x, v2.x, v2.y, v3.x, v3.y, v3.z, voro_blocks_x, voro_blocks_y,
-                                       voro_blocks_z, 3);
+//! Relative margin of the test that a cell is unaffected by the boundary of its block
+constexpr double VORONOI_GHOST_TOLERANCE = 1e-4;
 
-    for (size_t query_point_id = 0; query_point_id < n_points; query_point_id++)
-    {
-        vec3<double> query_point((*nq)[query_point_id]);
-        container.put(query_point_id, query_point.x, query_point.y, query_point.z);
-    }
+//! Cells computed from one voro++ container
+struct VoronoiCells
+{
+    std::vector<NeighborBond> bonds;    //!< Bonds of all cells
+    std::vector<vec3<double>> vertices; //!< Polytope vertices of all cells in system coordinates
+};
 
-    voro::voronoicell_neighbor cell;
-    voro::c_loop_all_periodic voronoi_loop(container);
+//! An edge of a face of a voro++ cell, between two vertices of the cell
+struct CellEdge
+{
+    int first;         //!< Smaller vertex index
+    int second;        //!< Larger vertex index
+    unsigned int face; //!< Face bounded by the edge
+};
+
+//! Scratch arrays for the properties of a voro++ cell
+struct CellScratch
+{
     std::vector<double> face_areas;
-    std::vector<int> face_vertices;
     std::vector<int> neighbors;
     std::vector<double> normals;
     std::vector<double> vertices;
+    std::vector<vec3<double>> relative_vertices;
     std::vector<NeighborBond> bonds;
+    std::vector<int> face_vertices;
+    std::vector<CellEdge> edges;
+};
+
+//! Statistics of the cells, stored when requested
+struct CellStatistics
+{
+    std::vector<double> surface_areas;     //!< Surface area of each cell
+    std::vector<double> surface_tensors;   //!< Minkowski tensor W1^{0,2} of each cell, 9 values per cell
+    std::vector<double> curvature_tensors; //!< Minkowski tensor W2^{0,2} of each cell, 9 values per cell
+};
 
-    if (voronoi_loop.start())
+//! Cells of the points that were computed by tessellate
+struct Tessellation
+{
+    std::vector<VoronoiCells> batches;      //!< Cells computed from each container
+    std::vector<unsigned int> cell_batches; //!< Batch holding the vertices of each cell
+    std::vector<size_t> vertex_starts;      //!< Index of the first vertex of each cell in its batch
+    std::vector<size_t> vertex_counts;      //!< Number of vertices of each cell
+    std::vector<double> volumes;            //!< Volume of each cell
+    std::vector<double> radii;              //!< Largest distance from each point to a vertex of its cell
+    CellStatistics statistics;              //!< Statistics of each cell, empty if not requested
+};
+
+//! Convert vectors between precisions
+vec3<double> toDouble(const vec3<float>& v)
+{
+    return vec3<double>(v.x, v.y, v.z);
+}
+
+//! Get the normal of a face of a voro++ cell, or a zero vector for faces that are not part of the surface
+/*! The faces of 2D cells that bound the slab of the container above and
+ *  below are skipped, like the degenerate faces whose normals are zero.
+ */
+vec3<double> surfaceNormal(const CellScratch& scratch, size_t face, bool is2D)
+{
+    const vec3<double> normal(scratch.normals[3 * face], scratch.normals[3 * face + 1],
+                              scratch.normals[3 * face + 2]);
+    if (is2D && std::abs(normal.z) > 0.5)
     {
-        do
+        return vec3<double>(0, 0, 0);
+    }
+    return normal;
+}
+
+//! Add a multiple of the outer product of a vector with itself to a row-major 3x3 tensor
+void addOuterProduct(double* tensor, const vec3<double>& v, double scale)
+{
+    const std::array<double, 3> c {v.x, v.y, v.z};
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        for (unsigned int j = 0; j < 3; ++j)
         {
-            container.compute_cell(cell, voronoi_loop);
+            tensor[3 * i + j] += scale * c[i] * c[j];
+        }
+    }
+}
 
-            // Get id and position of current particle
-            const int query_point_id(voronoi_loop.pid());
-            vec3<double> query_point(voronoi_loop.x(), voronoi_loop.y(), voronoi_loop.z());
+//! Compute the surface area and Minkowski tensors of a voro++ cell
+/*! The face areas, normals and absolute vertex positions of the cell must
+ *  already be in scratch. See Voronoi::getSurfaceTensors and
+ *  Voronoi::getCurvatureTensors for the definitions of the tensors.
+ *
+ *  \param cell The cell.
+ *  \param scratch Scratch arrays of the cell.
+ *  \param is2D Whether the cell is the prism of a 2D cell.
+ *  \param surface_area Receives the surface area of the cell.
+ *  \param surface_tensor Receives the 9 elements of the surface tensor.
+ *  \param curvature_tensor Receives the 9 elements of the curvature tensor.
+ */
+void computeCellStatistics(voro::voronoicell_neighbor& cell, CellScratch& scratch, bool is2D,
+                           double& surface_area, double* surface_tensor, double* curvature_tensor)
+{
+    const double dimension = is2D ? 2 : 3;
+    surface_area = 0;
+    std::fill_n(surface_tensor, 9, 0.0);
+    std::fill_n(curvature_tensor, 9, 0.0);
+    for (size_t face = 0; face < scratch.face_areas.size(); ++face)
+    {
+        const vec3<double> normal = surfaceNormal(scratch, face, is2D);
+        if (normal.x == 0 && normal.y == 0 && normal.z == 0)
+        {
+            continue;
+        }
+        surface_area += scratch.face_areas[face];
+        addOuterProduct(surface_tensor, normal, scratch.face_areas[face] / dimension);
+    }
+
+    // Every edge bounds two faces. The edges of the faces are sorted by
+    // their vertices to find the pairs of faces meeting at each edge.
+    cell.face_vertices(scratch.face_vertices);
+    scratch.edges.clear();
+    unsigned int face = 0;
+    for (size_t pos = 0; pos < scratch.face_vertices.size(); pos += scratch.face_vertices[pos] + 1, ++face)
+    {
+        const int num_vertices = scratch.face_vertices[pos];
+        for (int k = 0; k < num_vertices; ++k)
+        {
+            const int a = scratch.face_vertices[pos + 1 + k];
+            const int b = scratch.face_vertices[pos + 1 + (k + 1) % num_vertices];
+            scratch.edges.push_back({std::min(a, b), std::max(a, b), face});
+        }
+    }
+    std::sort(scratch.edges.begin(), scratch.edges.end(), [](const CellEdge& e1, const CellEdge& e2) {
+        return e1.first < e2.first || (e1.first == e2.first && e1.second < e2.second);
+    });
+    for (size_t edge = 0; edge + 1 < scratch.edges.size(); ++edge)
+    {
+        const CellEdge& e1 = scratch.edges[edge];
+        const CellEdge& e2 = scratch.edges[edge + 1];
+        if (e1.first != e2.first || e1.second != e2.second)
+        {
+            continue;
+        }
+        ++edge;
+        const vec3<double> n1 = surfaceNormal(scratch, e1.face, is2D);
+        const vec3<double> n2 = surfaceNormal(scratch, e2.face, is2D);
+        if (dot(n1, n1) == 0 || dot(n2, n2) == 0)
+        {
+            continue;
+        }
 
-            // Get Voronoi cell properties
-            cell.face_areas(face_areas);
-            cell.face_vertices(face_vertices);
-            cell.neighbors(neighbors);
-            cell.normals(normals);
-            cell.vertices(query_point.x, query_point.y, query_point.z, vertices);
+        // The normal does not turn at edges between parallel faces.
+        const vec3<double> sum = n1 + n2;
+        const vec3<double> difference = n1 - n2;
+        const double sum_sq = dot(sum, sum);
+        const double difference_sq = dot(difference, difference);
+        if (sum_sq == 0 || difference_sq == 0)
+        {
+            continue;
+        }
+
+        // In 2D, the edges between two faces of the surface are the
+        // vertices of the polygon.
+        double weight = 0.25;
+        if (!is2D)
+        {
+            const double* v1 = &scratch.vertices[3 * e1.first];
+            const double* v2 = &scratch.vertices[3 * e1.second];
+            const vec3<double> delta(v2[0] - v1[0], v2[1] - v1[1], v2[2] - v1[2]);
+            weight = std::sqrt(dot(delta, delta)) / 12;
+        }
+        const double angle = std::acos(std::max(-1.0, std::min(1.0, dot(n1, n2))));
+        addOuterProduct(curvature_tensor, sum, weight * (angle + std::sin(angle)) / sum_sq);
+        addOuterProduct(curvature_tensor, difference, weight * (angle - std::sin(angle)) / difference_sq);
+    }
+}
+
+//! Compute the Voronoi cells of a subset of the points
+/*! Voronoi calculations should be kept in double precision.
+ *
+ *  \param nq The points and box.
+ *  \param compute_polytopes Whether to store the vertices of each cell.
+ *  \param compute_statistics Whether to compute the statistics of each cell.
+ *  \param pending Whether to compute the cell of each point. Every entry is
+ *         cleared on return.
+ *  \param tessellation The computed cells. The entries of the points that
+ *         were not pending are left unset.
+ */
+void tessellate(const NeighborQuery* nq, bool compute_polytopes, bool compute_statistics,
+                std::vector<char>& pending, Tessellation& tessellation)
+{
+    const auto box = nq->getBox();
+    const auto n_points = nq->getNPoints();
+    const bool is2D = box.is2D();
+    const auto num_cells = static_cast<unsigned int>(std::count(pending.begin(), pending.end(), 1));
+
+    const vec3<float> v1 = box.getLatticeVector(0);
+    const vec3<float> v2 = box.getLatticeVector(1);
+    const vec3<float> v3 = (is2D ? vec3<float>(0, 0, 1) : box.getLatticeVector(2));
 
-            // Compute polytope vertices in relative coordinates
-            std::vector<vec3<double>> relative_vertices;
-            auto vertex_iterator = vertices.begin();
-            while (vertex_iterator != vertices.end())
+    // Where the cell of each point is stored. A point remains pending until
+    // its cell has been computed.
+    std::vector<unsigned int>& cell_batches = tessellation.cell_batches;
+    std::vector<size_t>& vertex_starts = tessellation.vertex_starts;
+    std::vector<size_t>& vertex_counts = tessellation.vertex_counts;
+    cell_batches.assign(n_points, 0);
+    vertex_starts.assign(n_points, 0);
+    vertex_counts.assign(n_points, 0);
+    tessellation.volumes.assign(n_points, 0);
+    tessellation.radii.assign(n_points, 0);
+    CellStatistics& statistics = tessellation.statistics;
+    if (compute_statistics)
+    {
+        statistics.surface_areas.assign(n_points, 0);
+        statistics.surface_tensors.assign(9 * static_cast<size_t>(n_points), 0);
+        statistics.curvature_tensors.assign(9 * static_cast<size_t>(n_points), 0);
+    }
+
+    // Store the cell of a point unless it extends further than max_radius
+    // from the point or has faces on the walls of its container. The ids of
+    // the neighbors in the container are converted by global_id. Returns
+    // whether the cell was stored.
+    auto addCell = [&](voro::voronoicell_neighbor& cell, CellScratch& scratch, VoronoiCells& cells,
+                       unsigned int batch, unsigned int query_point_id, const vec3<double>& query_point,
+                       double max_radius, const auto& global_id) {
+        // Compute polytope vertices in relative coordinates
+        cell.vertices(query_point.x, query_point.y, query_point.z, scratch.vertices);
+        scratch.relative_vertices.clear();
+        double max_radius_sq = 0;
+        for (size_t vertex = 0; vertex < scratch.vertices.size(); vertex += 3)
+        {
+            const double vert_x = scratch.vertices[vertex];
+            const double vert_y = scratch.vertices[vertex + 1];
+            double vert_z = scratch.vertices[vertex + 2];
+
+            // In 2D systems, only use vertices from the upper plane
+            // to prevent double-counting, and set z=0 manually
+            if (is2D)
             {
-                double vert_x = *vertex_iterator;
-                vertex_iterator++;
-                double vert_y = *vertex_iterator;
-                vertex_iterator++;
-                double vert_z = *vertex_iterator;
-                vertex_iterator++;
-
-                // In 2D systems, only use vertices from the upper plane
-                // to prevent double-counting, and set z=0 manually
-                if (box.is2D())
+                if (vert_z < 0)
                 {
-                    if (vert_z < 0)
-                    {
-                        continue;
-                    }
-                    vert_z = 0;
+                    continue;
                 }
-                vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
-                relative_vertices.push_back(delta);
+                vert_z = 0;
             }
+            const vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
+            const double radius_sq = delta.x * delta.x + delta.y * delta.y + (is2D ? 0 : delta.z * delta.z);
+            max_radius_sq = std::max(max_radius_sq, radius_sq);
+            scratch.relative_vertices.push_back(delta);
+        }
+        if (max_radius_sq > max_radius * max_radius)
+        {
+            return false;
+        }
 
+        // Compute cell neighbors
+        cell.face_areas(scratch.face_areas);
+        cell.neighbors(scratch.neighbors);
+        cell.normals(scratch.normals);
+        const vec3<double> query_point_system_coords((*nq)[query_point_id]);
+        scratch.bonds.clear();
+        for (size_t neighbor_counter = 0; neighbor_counter < scratch.neighbors.size(); ++neighbor_counter)
+        {
+            // Get the normal to the current face
+            const vec3<double> normal(scratch.normals[3 * neighbor_counter],
+                                      scratch.normals[3 * neighbor_counter + 1],
+                                      scratch.normals[3 * neighbor_counter + 2]);
+
+            // Ignore bonds in 2D systems that point up or down. This check
+            // should only be dealing with bonds whose normal vectors' z
+            // components are -1, 0, or +1 (within some tolerance). This
+            // also skips bonds where the normal vector is exactly zero.
+            // A normal vector of exactly zero seems to appear for certain
+            // particles in 2D systems where the neighbors are very close.
+            // It seems like an issue of numerical imprecision but could be
+            // some other pathological case.
+            if ((is2D && std::abs(normal.z) > 0.5) || (normal.x == 0 && normal.y == 0 && normal.z == 0))
+            {
+                continue;
+            }
+
+            // Walls of a container have negative ids.
+            const int neighbor = scratch.neighbors[neighbor_counter];
+            if (neighbor < 0)
+            {
+                return false;
+            }
+
+            // Fetch neighbor information
+            const unsigned int point_id = global_id(neighbor);
+            const float weight(scratch.face_areas[neighbor_counter]);
+            const vec3<double> point_system_coords((*nq)[point_id]);
+
+            // Compute the distance from query_point to point.
+            const vec3<float> rij = box.wrap(point_system_coords - query_point_system_coords);
+            const float distance(std::sqrt(dot(rij, rij)));
+
+            scratch.bonds.emplace_back(query_point_id, point_id, distance, weight);
+        }
+        cells.bonds.insert(cells.bonds.end(), scratch.bonds.begin(), scratch.bonds.end());
+
+        if (compute_statistics)
+        {
+            computeCellStatistics(cell, scratch, is2D, statistics.surface_areas[query_point_id],
+                                  &statistics.surface_tensors[9 * static_cast<size_t>(query_point_id)],
+                                  &statistics.curvature_tensors[9 * static_cast<size_t>(query_point_id)]);
+        }
+
+        if (compute_polytopes)
+        {
             // Sort relative vertices by their angle in 2D systems
-            if (box.is2D())
+            if (is2D)
             {
-                std::sort(relative_vertices.begin(), relative_vertices.end(),
+                std::sort(scratch.relative_vertices.begin(), scratch.relative_vertices.end(),
                           [](const vec3<double>& a, const vec3<double>& b) {
                               return std::atan2(a.y, a.x) < std::atan2(b.y, b.x);
                           });
             }
 
             // Save polytope vertices in system coordinates
-            const vec3<double>& query_point_system_coords((*nq)[query_point_id]);
-
-            std::vector<vec3<double>> system_vertices;
-            system_vertices.reserve(relative_vertices.size());
+            cell_batches[query_point_id] = batch;
+            vertex_starts[query_point_id] = cells.vertices.size();
+            vertex_counts[query_point_id] = scratch.relative_vertices.size();
             std::transform(
-                relative_vertices.begin(), relative_vertices.end(), std::back_inserter(system_vertices),
+                scratch.relative_vertices.begin(), scratch.relative_vertices.end(),
+                std::back_inserter(cells.vertices),
                 [&](const auto& relative_vertex) { return relative_vertex + query_point_system_coords; });
-            m_polytopes[query_point_id] = system_vertices;
+        }
 
-            // Save cell volume
-            m_volumes[query_point_id] = cell.volume();
+        // Save cell volume
+        tessellation.volumes[query_point_id] = cell.volume();
+        tessellation.radii[query_point_id] = std::sqrt(max_radius_sq);
+        pending[query_point_id] = 0;
+        return true;
+    };
 
-            // Compute cell neighbors
-            size_t neighbor_counter(0);
-            for (auto neighbor_iterator = neighbors.begin(); neighbor_iterator != neighbors.end();
-                 neighbor_iterator++, neighbor_counter++)
+    // The box is decomposed into blocks along its lattice vectors, with
+    // about the same number of blocks per unit length along each axis.
+    // heights holds the distances between opposite faces of the box.
+    const double volume = box.getVolume();
+    const vec3<double> d1(toDouble(v1));
+    const vec3<double> d2(toDouble(v2));
+    const vec3<double> d3(toDouble(v3));
+    const std::array<double, 3> heights {volume / std::sqrt(dot(cross(d2, d3), cross(d2, d3))),
+                                         volume / std::sqrt(dot(cross(d3, d1), cross(d3, d1))),
+                                         volume / std::sqrt(dot(cross(d1, d2), cross(d1, d2)))};
+    const unsigned int num_dims = is2D ? 2 : 3;
+    const auto num_threads = static_cast<unsigned int>(tbb::this_task_arena::max_concurrency());
+    const unsigned int target_blocks
+        = std::min(VORONOI_BLOCKS_PER_THREAD * num_threads, num_cells / VORONOI_MIN_BLOCK_POINTS);
+    std::array<unsigned int, 3> num_blocks {1, 1, 1};
+    if (target_blocks > 1)
+    {
+        const double blocks_per_length = std::pow(target_blocks / volume, 1.0 / num_dims);
+        for (unsigned int d = 0; d < num_dims; ++d)
+        {
+            num_blocks[d]
+                = std::max(1U, static_cast<unsigned int>(std::lround(heights[d] * blocks_per_length)));
+        }
+    }
+    const unsigned int total_blocks = num_blocks[0] * num_blocks[1] * num_blocks[2];
+    std::vector<VoronoiCells>& batches = tessellation.batches;
+    batches.assign(total_blocks + 1, VoronoiCells());
+
+    if (total_blocks > 1)
+    {
+        // Each block is extended by a layer of ghost points, including
+        // periodic images of the points near the faces of the box. The
+        // ghost layer has the thickness skin perpendicular to each face,
+        // which is skin / height in fractional coordinates.
+        const double skin = VORONOI_GHOST_SPACINGS * std::pow(volume / n_points, 1.0 / num_dims);
+        std::array<double, 3> frac_skin {0, 0, 0};
+        for (unsigned int d = 0; d < num_dims; ++d)
+        {
+            frac_skin[d] = skin / heights[d];
+        }
+        const vec3<float> L(box.getL());
+        PeriodicBuffer buffer;
+        buffer.compute(nq,
+                       vec3<float>(frac_skin[0] * L.x, frac_skin[1] * L.y, is2D ? 0 : frac_skin[2] * L.z),
+                       false);
+        const std::vector<vec3<float>>& buffer_points = buffer.getBufferPoints();
+        const std::vector<unsigned int>& buffer_ids = buffer.getBufferIds();
+        const size_t num_candidates = n_points + buffer_points.size();
+        auto candidatePosition = [&](size_t candidate) {
+            return candidate < n_points ? (*nq)[candidate] : buffer_points[candidate - n_points];
+        };
+        auto candidateId = [&](size_t candidate) {
+            return candidate < n_points ? static_cast<unsigned int>(candidate)
+                                        : buffer_ids[candidate - n_points];
+        };
+
+        // Assign every point to the block that owns it and the points and
+        // images to all blocks whose ghost layer contains them.
+        std::vector<std::vector<size_t>> block_members(total_blocks);
+        std::vector<unsigned int> block_cells(total_blocks, 0);
+        std::vector<unsigned int> owners(n_points);
+        for (size_t candidate = 0; candidate < num_candidates; ++candidate)
+        {
+            const vec3<float> frac_vec = box.makeFractional(candidatePosition(candidate));
+            const std::array<double, 3> frac {frac_vec.x, frac_vec.y, frac_vec.z};
+            std::array<unsigned int, 3> first {0, 0, 0};
+            std::array<unsigned int, 3> last {0, 0, 0};
+            std::array<unsigned int, 3> owner {0, 0, 0};
+            bool inside = true;
+            for (unsigned int d = 0; d < num_dims; ++d)
             {
-                // Get the normal to the current face
-                const vec3<double> normal(normals[3 * neighbor_counter], normals[3 * neighbor_counter + 1],
-                                          normals[3 * neighbor_counter + 2]);
-
-                // Ignore bonds in 2D systems that point up or down. This check
-                // should only be dealing with bonds whose normal vectors' z
-                // components are -1, 0, or +1 (within some tolerance). This
-                // also skips bonds where the normal vector is exactly zero.
-                // A normal vector of exactly zero seems to appear for certain
-                // particles in 2D systems where the neighbors are very close.
-                // It seems like an issue of numerical imprecision but could be
-                // some other pathological case.
-                if (box.is2D() && std::abs(normal.z) > 0.5
-                    || (normal.x == 0 && normal.y == 0 && normal.z == 0))
+                const double nb = num_blocks[d];
+                const double low = std::floor((frac[d] - frac_skin[d]) * nb);
+                const double high = std::floor((frac[d] + frac_skin[d]) * nb);
+                if (high < 0 || low > nb - 1)
+                {
+                    inside = false;
+                    break;
+                }
+                first[d] = static_cast<unsigned int>(std::max(low, 0.0));
+                last[d] = static_cast<unsigned int>(std::min(high, nb - 1));
+                owner[d]
+                    = static_cast<unsigned int>(std::min(std::max(std::floor(frac[d] * nb), 0.0), nb - 1));
+            }
+            if (!inside)
+            {
+                continue;
+            }
+            if (candidate < n_points)
+            {
+                owners[candidate] = (owner[0] * num_blocks[1] + owner[1]) * num_blocks[2] + owner[2];
+                block_cells[owners[candidate]] += static_cast<unsigned int>(pending[candidate]);
+            }
+            for (unsigned int bx = first[0]; bx <= last[0]; ++bx)
+            {
+                for (unsigned int by = first[1]; by <= last[1]; ++by)
+                {
+                    for (unsigned int bz = first[2]; bz <= last[2]; ++bz)
+                    {
+                        block_members[(bx * num_blocks[1] + by) * num_blocks[2] + bz].push_back(candidate);
+                    }
+                }
+            }
+        }
+
+        // The cells of the points owned by each block are computed in
+        // parallel in a non-periodic container of the block and its ghosts.
+        // A cell is exact if the ball of twice its circumradius around its
+        // point lies inside the extended block, because no point outside of
+        // it can then cut the cell. Other cells are left to the periodic
+        // container below.
+        util::forLoopWrapper(0, total_blocks, [&](size_t begin, size_t end) {
+            voro::voronoicell_neighbor cell;
+            CellScratch scratch;
+            for (size_t block = begin; block < end; ++block)
+            {
+                if (block_cells[block] == 0)
                 {
                     continue;
                 }
+                const std::array<unsigned int, 3> block_index {
+                    static_cast<unsigned int>(block / (num_blocks[1] * num_blocks[2])),
+                    static_cast<unsigned int>((block / num_blocks[2]) % num_blocks[1]),
+                    static_cast<unsigned int>(block % num_blocks[2])};
+                std::array<double, 3> frac_low {0, 0, 0};
+                std::array<double, 3> frac_high {1, 1, 1};
+                for (unsigned int d = 0; d < num_dims; ++d)
+                {
+                    frac_low[d] = double(block_index[d]) / num_blocks[d] - frac_skin[d];
+                    frac_high[d] = double(block_index[d] + 1) / num_blocks[d] + frac_skin[d];
+                }
 
-                // Fetch neighbor information
-                const int point_id = *neighbor_iterator;
-                const float weight(face_areas[neighbor_counter]);
-                const vec3<double> point_system_coords((*nq)[point_id]);
+                // The container is the bounding box of the extended block.
+                vec3<double> lower(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                                   std::numeric_limits<double>::max());
+                vec3<double> upper(-lower);
+                for (unsigned int corner = 0; corner < 8; ++corner)
+                {
+                    const vec3<float> corner_frac((corner & 1) ? frac_high[0] : frac_low[0],
+                                                  (corner & 2) ? frac_high[1] : frac_low[1],
+                                                  (corner & 4) ? frac_high[2] : frac_low[2]);
+                    const vec3<double> position(toDouble(box.makeAbsolute(corner_frac)));
+                    lower = vec3<double>(std::min(lower.x, position.x), std::min(lower.y, position.y),
+                                         std::min(lower.z, position.z));
+                    upper = vec3<double>(std::max(upper.x, position.x), std::max(upper.y, position.y),
+                                         std::max(upper.z, position.z));
+                }
+                const vec3<double> margin(VORONOI_GHOST_TOLERANCE * skin, VORONOI_GHOST_TOLERANCE * skin,
+                                          VORONOI_GHOST_TOLERANCE * skin);
+                lower -= margin;
+                upper += margin;
+                if (is2D)
+                {
+                    lower.z = -0.5;
+                    upper.z = 0.5;
+                }
 
-                // Compute the distance from query_point to point.
-                const vec3<float> rij = box.wrap(point_system_coords - query_point_system_coords);
-                const float distance(std::sqrt(dot(rij, rij)));
+                const std::vector<size_t>& members = block_members[block];
+                const vec3<double> extent = upper - lower;
+                const double block_scale = std::pow(
+                    members.size() / (voro::optimal_particles * extent.x * extent.y * extent.z), 1.0 / 3.0);
+                voro::container container(lower.x, upper.x, lower.y, upper.y, lower.z, upper.z,
+                                          int(extent.x * block_scale + 1), int(extent.y * block_scale + 1),
+                                          int(extent.z * block_scale + 1), false, false, false, 8);
+                voro::particle_order owned_order;
+                for (size_t member = 0; member < members.size(); ++member)
+                {
+                    const size_t candidate = members[member];
+                    const vec3<double> position(toDouble(candidatePosition(candidate)));
+                    if (candidate < n_points && owners[candidate] == block && pending[candidate] != 0)
+                    {
+                        container.put(owned_order, member, position.x, position.y, position.z);
+                    }
+                    else
+                    {
+                        container.put(member, position.x, position.y, position.z);
+                    }
+                }
+
+                auto global_id = [&](int member) { return candidateId(members[member]); };
+                voro::c_loop_order voronoi_loop(container, owned_order);
+                if (voronoi_loop.start())
+                {
+                    do
+                    {
+                        if (!container.compute_cell(cell, voronoi_loop))
+                        {
+                            continue;
+                        }
+                        const size_t candidate = members[voronoi_loop.pid()];
+                        const vec3<double> query_point(voronoi_loop.x(), voronoi_loop.y(), voronoi_loop.z());
 
-                bonds.emplace_back(query_point_id, point_id, distance, weight);
+                        // Distance from the point to the nearest face of
+                        // the extended block.
+                        const vec3<float> frac_vec = box.makeFractional(candidatePosition(candidate));
+                        const std::array<double, 3> frac {frac_vec.x, frac_vec.y, frac_vec.z};
+                        double clearance = std::numeric_limits<double>::max();
+                        for (unsigned int d = 0; d < num_dims; ++d)
+                        {
+                            clearance = std::min(clearance, (frac[d] - frac_low[d]) * heights[d]);
+                            clearance = std::min(clearance, (frac_high[d] - frac[d]) * heights[d]);
+                        }
+                        addCell(cell, scratch, batches[block], block, static_cast<unsigned int>(candidate),
+                                query_point, clearance / (2 * (1 + VORONOI_GHOST_TOLERANCE)), global_id);
+                    } while (voronoi_loop.inc());
+                }
             }
+        });
+    }
+
+    // The remaining cells are computed from a periodic container of all
+    // points. Without a domain decomposition, these are all of the cells.
+    const size_t num_pending = std::count(pending.begin(), pending.end(), 1);
+    if (num_pending != 0)
+    {
+        // This heuristic for choosing blocks is based on the voro::pre_container
+        // guess_optimal method. By computing the heuristic directly, we avoid
+        // having to create a pre_container. This saves time because the
+        // pre_container cannot be used to set up container_periodic (only
+        // non-periodic containers are compatible).
+        const float block_scale
+            = std::pow(n_points / (voro::optimal_particles * box.getVolume()), float(1.0 / 3.0));
+        const int voro_blocks_x = int(box.getLx() * block_scale + 1);
+        const int voro_blocks_y = int(box.getLy() * block_scale + 1);
+        const int voro_blocks_z = int(box.getLz() * block_scale + 1);
+
+        voro::container_periodic container(v1.x, v2.x, v2.y, v3.x, v3.y, v3.z, voro_blocks_x, voro_blocks_y,
+                                           voro_blocks_z, 3);
+        voro::particle_order pending_order;
+        for (size_t query_point_id = 0; query_point_id < n_points; query_point_id++)
+        {
+            vec3<double> query_point((*nq)[query_point_id]);
+            if (pending[query_point_id] != 0)
+            {
+                container.put(pending_order, query_point_id, query_point.x, query_point.y, query_point.z);
+            }
+            else
+            {
+                container.put(query_point_id, query_point.x, query_point.y, query_point.z);
+            }
+        }
+
+        voro::voronoicell_neighbor cell;
+        CellScratch scratch;
+        auto global_id = [](int point_id) { return static_cast<unsigned int>(point_id); };
+        voro::c_loop_order_periodic voronoi_loop(container, pending_order);
+        if (voronoi_loop.start())
+        {
+            do
+            {
+                container.compute_cell(cell, voronoi_loop);
+
+                // Get id and position of current particle
+                const int query_point_id(voronoi_loop.pid());
+                vec3<double> query_point(voronoi_loop.x(), voronoi_loop.y(), voronoi_loop.z());
+                addCell(cell, scratch, batches[total_blocks], total_blocks, query_point_id, query_point,
+                        std::numeric_limits<double>::infinity(), global_id);
+            } while (voronoi_loop.inc());
+        }
+    }
+}
 
-        } while (voronoi_loop.inc());
+//! Gather the bonds of all computed cells, sorted by query point
+std::vector<NeighborBond> collectBonds(const Tessellation& tessellation)
+{
+    const std::vector<VoronoiCells>& batches = tessellation.batches;
+    std::vector<size_t> bond_offsets(batches.size() + 1, 0);
+    for (size_t batch = 0; batch < batches.size(); ++batch)
+    {
+        bond_offsets[batch + 1] = bond_offsets[batch] + batches[batch].bonds.size();
     }
+    std::vector<NeighborBond> bonds(bond_offsets.back());
+    util::forLoopWrapper(0, batches.size(), [&](size_t begin, size_t end) {
+        for (size_t batch = begin; batch < end; ++batch)
+        {
+            std::copy(batches[batch].bonds.begin(), batches[batch].bonds.end(),
+                      bonds.begin() + bond_offsets[batch]);
+        }
+    });
 
     tbb::parallel_sort(bonds.begin(), bonds.end(), [](const NeighborBond& n1, const NeighborBond& n2) {
         return n1.less_id_ref_weight(n2);
     });
+    return bonds;
+}
+
+}; // end anonymous namespace
 
+void Voronoi::computeAsphericities()
+{
+    const size_t n_cells = m_surface_areas.size();
+    m_asphericities.prepareUninitialized(n_cells);
+    if (m_box.is2D())
+    {
+        // The eigenvalues of the in-plane block of the tensor
+        for (size_t cell = 0; cell < n_cells; ++cell)
+        {
+            const double* tensor = m_surface_tensors.get() + 9 * cell;
+            const double mean = (tensor[0] + tensor[4]) / 2;
+            const double half_difference = (tensor[0] - tensor[4]) / 2;
+            const double radius = std::sqrt(half_difference * half_difference + tensor[1] * tensor[1]);
+            m_asphericities[cell] = mean + radius > 0 ? (mean - radius) / (mean + radius) : 0;
+        }
+        return;
+    }
+
+    std::vector<float> tensors(m_surface_tensors.get(), m_surface_tensors.get() + 9 * n_cells);
+    std::vector<float> eigen_vals(3 * n_cells);
+    std::vector<float> eigen_vecs(9 * n_cells);
+    util::diagonalize33SymmetricMatrices(tensors.data(), eigen_vals.data(), eigen_vecs.data(), n_cells);
+    for (size_t cell = 0; cell < n_cells; ++cell)
+    {
+        const double largest = eigen_vals[3 * cell + 2];
+        m_asphericities[cell] = largest > 0 ? eigen_vals[3 * cell] / largest : 0;
+    }
+}
+
+void Voronoi::compute(const freud::locality::NeighborQuery* nq, bool compute_polytopes,
+                      bool compute_statistics)
+{
+    const auto n_points = nq->getNPoints();
+
+    std::vector<char> pending(n_points, 1);
+    Tessellation tessellation;
+    tessellate(nq, compute_polytopes, compute_statistics, pending, tessellation);
+
+    m_volumes.prepareUninitialized(n_points);
+    std::copy(tessellation.volumes.begin(), tessellation.volumes.end(), m_volumes.get());
+
+    // The statistics are empty unless they were requested.
+    const CellStatistics& statistics = tessellation.statistics;
+    const size_t n_cells = compute_statistics ? n_points : 0;
+    m_surface_areas.prepareUninitialized(n_cells);
+    m_surface_tensors.prepareUninitialized({n_cells, 3, 3});
+    m_curvature_tensors.prepareUninitialized({n_cells, 3, 3});
+    std::copy(statistics.surface_areas.begin(), statistics.surface_areas.end(), m_surface_areas.get());
+    std::copy(statistics.surface_tensors.begin(), statistics.surface_tensors.end(), m_surface_tensors.get());
+    std::copy(statistics.curvature_tensors.begin(), statistics.curvature_tensors.end(),
+              m_curvature_tensors.get());
+
+    m_polytopes.prepare(tessellation.vertex_counts);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t point_id = begin; point_id < end; ++point_id)
+        {
+            std::copy_n(tessellation.batches[tessellation.cell_batches[point_id]].vertices.begin()
+                            + tessellation.vertex_starts[point_id],
+                        tessellation.vertex_counts[point_id], m_polytopes.getSegment(point_id));
+        }
+    });
+
+    const std::vector<NeighborBond> bonds = collectBonds(tessellation);
     unsigned int num_bonds = bonds.size();
 
     m_neighbor_list->resize(num_bonds);
     m_neighbor_list->setNumBonds(num_bonds, n_points, n_points);
 
-    util::forLoopWrapper(0, num_bonds, [=](size_t begin, size_t end) {
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
         for (size_t bond = begin; bond != end; ++bond)
         {
             m_neighbor_list->getNeighbors()(bond, 0) = bonds[bond].query_point_idx;
@@ -178,6 +732,202 @@ void Voronoi::compute(const freud::locality::NeighborQuery* nq)
             m_neighbor_list->getWeights()[bond] = bonds[bond].weight;
         }
     });
+
+    // Keep the positions and cell sizes for update.
+    m_box = nq->getBox();
+    m_points.assign(nq->getPoints(), nq->getPoints() + n_points);
+    m_cell_radii = std::move(tessellation.radii);
+    m_compute_polytopes = compute_polytopes;
+    m_compute_statistics = compute_statistics;
+    m_has_cells = true;
+    m_num_computed_cells = n_points;
+    computeAsphericities();
+}
+
+void Voronoi::update(const freud::locality::NeighborQuery* nq, bool compute_polytopes,
+                     bool compute_statistics)
+{
+    const auto box = nq->getBox();
+    const auto n_points = nq->getNPoints();
+    if (!m_has_cells || !(box == m_box) || n_points != m_points.size()
+        || compute_polytopes != m_compute_polytopes || compute_statistics != m_compute_statistics)
+    {
+        compute(nq, compute_polytopes, compute_statistics);
+        return;
+    }
+
+    // The cell of a point is determined by the points closer to it than
+    // twice the largest distance to the vertices of the cell. A stored cell
+    // is therefore unchanged unless a point that moved was or is now closer
+    // than that, and only those cells and the cells of the moved points are
+    // computed again.
+    std::vector<char> pending(n_points, 0);
+    std::vector<vec3<float>> moved_positions;
+    for (unsigned int point_id = 0; point_id < n_points; ++point_id)
+    {
+        if ((*nq)[point_id] != m_points[point_id])
+        {
+            pending[point_id] = 1;
+            moved_positions.push_back(m_points[point_id]);
+            moved_positions.push_back((*nq)[point_id]);
+        }
+    }
+    if (moved_positions.empty())
+    {
+        m_num_computed_cells = 0;
+        return;
+    }
+
+    // Periodic images would have to be considered if the search extended
+    // beyond half of the box.
+    const double search_scale = 2 * (1 + VORONOI_GHOST_TOLERANCE);
+    const double search_radius = search_scale * *std::max_element(m_cell_radii.begin(), m_cell_radii.end());
+    const vec3<float> plane_distances = box.getNearestPlaneDistance();
+    const float min_plane_distance = box.is2D()
+        ? std::min(plane_distances.x, plane_distances.y)
+        : std::min(std::min(plane_distances.x, plane_distances.y), plane_distances.z);
+    if (search_radius >= min_plane_distance / 2)
+    {
+        compute(nq, compute_polytopes, compute_statistics);
+        return;
+    }
+
+    QueryArgs args;
+    args.mode = QueryType::ball;
+    args.r_max = static_cast<float>(search_radius);
+    args.exclude_ii = false;
+    tbb::enumerable_thread_specific<BondSink> sinks;
+    util::forLoopWrapper(0, moved_positions.size(), [&](size_t begin, size_t end) {
+        nq->queryBatch(moved_positions.data(), begin, end, args, sinks.local());
+    });
+    for (const BondSink& sink : sinks)
+    {
+        for (const NeighborBond& bond : sink.bonds)
+        {
+            if (bond.distance < search_scale * m_cell_radii[bond.point_idx])
+            {
+                pending[bond.point_idx] = 1;
+            }
+        }
+    }
+    const std::vector<char> recomputed(pending);
+    m_num_computed_cells = static_cast<unsigned int>(std::count(pending.begin(), pending.end(), 1));
+
+    Tessellation tessellation;
+    tessellate(nq, compute_polytopes, compute_statistics, pending, tessellation);
+    const std::vector<NeighborBond> bonds = collectBonds(tessellation);
+
+    // Merge the computed cells with the stored cells of the other points.
+    // The previous arrays are kept alive so that their values can be copied
+    // after the new arrays are prepared.
+    const NeighborList previous_list(*m_neighbor_list);
+    const util::ManagedArray<double> previous_volumes = m_volumes;
+    const util::ManagedArray<double> previous_surface_areas = m_surface_areas;
+    const util::ManagedArray<double> previous_surface_tensors = m_surface_tensors;
+    const util::ManagedArray<double> previous_curvature_tensors = m_curvature_tensors;
+    const util::RaggedArray<vec3<double>> previous_polytopes = m_polytopes;
+    const unsigned int* previous_segments = previous_list.getSegments().get();
+    const unsigned int* previous_counts = previous_list.getCounts().get();
+    const unsigned int* previous_neighbors = previous_list.getNeighbors().get();
+    const float* previous_distances = previous_list.getDistances().get();
+    const float* previous_weights = previous_list.getWeights().get();
+
+    std::vector<unsigned int> counts(n_points, 0);
+    std::vector<size_t> polytope_sizes(n_points, 0);
+    for (const NeighborBond& bond : bonds)
+    {
+        ++counts[bond.query_point_idx];
+    }
+    std::vector<size_t> sources(n_points, 0);
+    std::vector<size_t> offsets(n_points + 1, 0);
+    size_t num_new_bonds = 0;
+    for (unsigned int point_id = 0; point_id < n_points; ++point_id)
+    {
+        if (recomputed[point_id] != 0)
+        {
+            sources[point_id] = num_new_bonds;
+            num_new_bonds += counts[point_id];
+            polytope_sizes[point_id] = tessellation.vertex_counts[point_id];
+            m_cell_radii[point_id] = tessellation.radii[point_id];
+        }
+        else
+        {
+            sources[point_id] = previous_segments[point_id];
+            counts[point_id] = previous_counts[point_id];
+            polytope_sizes[point_id] = previous_polytopes.getSegmentSize(point_id);
+        }
+        offsets[point_id + 1] = offsets[point_id] + counts[point_id];
+    }
+
+    const auto num_bonds = static_cast<unsigned int>(offsets[n_points]);
+    m_neighbor_list->resize(num_bonds);
+    m_neighbor_list->setNumBonds(num_bonds, n_points, n_points);
+    m_volumes.prepareUninitialized(n_points);
+    m_polytopes.prepare(polytope_sizes);
+    if (compute_statistics)
+    {
+        m_surface_areas.prepareUninitialized(n_points);
+        m_surface_tensors.prepareUninitialized({n_points, 3, 3});
+        m_curvature_tensors.prepareUninitialized({n_points, 3, 3});
+    }
+    unsigned int* neighbors = m_neighbor_list->getNeighbors().get();
+    float* distances = m_neighbor_list->getDistances().get();
+    float* weights = m_neighbor_list->getWeights().get();
+
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t point_id = begin; point_id < end; ++point_id)
+        {
+            const size_t first = offsets[point_id];
+            const size_t source = sources[point_id];
+            if (recomputed[point_id] != 0)
+            {
+                for (size_t bond = 0; bond < counts[point_id]; ++bond)
+                {
+                    const NeighborBond& new_bond = bonds[source + bond];
+                    neighbors[2 * (first + bond)] = new_bond.query_point_idx;
+                    neighbors[2 * (first + bond) + 1] = new_bond.point_idx;
+                    distances[first + bond] = new_bond.distance;
+                    weights[first + bond] = new_bond.weight;
+                }
+                m_volumes[point_id] = tessellation.volumes[point_id];
+                if (compute_statistics)
+                {
+                    const CellStatistics& statistics = tessellation.statistics;
+                    m_surface_areas[point_id] = statistics.surface_areas[point_id];
+                    std::copy_n(statistics.surface_tensors.begin() + 9 * point_id, 9,
+                                m_surface_tensors.get() + 9 * point_id);
+                    std::copy_n(statistics.curvature_tensors.begin() + 9 * point_id, 9,
+                                m_curvature_tensors.get() + 9 * point_id);
+                }
+                std::copy_n(tessellation.batches[tessellation.cell_batches[point_id]].vertices.begin()
+                                + tessellation.vertex_starts[point_id],
+                            polytope_sizes[point_id], m_polytopes.getSegment(point_id));
+            }
+            else
+            {
+                std::copy_n(previous_neighbors + 2 * source, 2 * counts[point_id], neighbors + 2 * first);
+                std::copy_n(previous_distances + source, counts[point_id], distances + first);
+                std::copy_n(previous_weights + source, counts[point_id], weights + first);
+                m_volumes[point_id] = previous_volumes[point_id];
+                if (compute_statistics)
+                {
+                    m_surface_areas[point_id] = previous_surface_areas[point_id];
+                    std::copy_n(previous_surface_tensors.get() + 9 * point_id, 9,
+                                m_surface_tensors.get() + 9 * point_id);
+                    std::copy_n(previous_curvature_tensors.get() + 9 * point_id, 9,
+                                m_curvature_tensors.get() + 9 * point_id);
+                }
+                std::copy_n(previous_polytopes.getSegment(point_id), polytope_sizes[point_id],
+                            m_polytopes.getSegment(point_id));
+            }
+        }
+    });
+
+    std::copy(nq->getPoints(), nq->getPoints() + n_points, m_points.begin());
+    if (compute_statistics)
+    {
+        computeAsphericities();
+    }
 }
 
 }; }; // end namespace freud::locality
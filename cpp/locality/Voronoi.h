@@ -8,7 +8,9 @@
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "RaggedArray.h"
 #include "VectorMath.h"
+#include <vector>
 #include <voro++/src/voro++.hh>
 
 namespace freud { namespace locality {
@@ -19,14 +21,51 @@ public:
     // default constructor
     Voronoi() : m_neighbor_list(std::make_shared<NeighborList>()) {}
 
-    void compute(const freud::locality::NeighborQuery* nq);
+    //! Compute the Voronoi diagram
+    /*! Large systems are decomposed into blocks whose cells are computed in
+     *  parallel, each from the points of the block and a layer of ghost
+     *  points around it. Cells that may reach beyond the ghost layer are
+     *  computed again from all points.
+     *
+     *  \param nq The points and box.
+     *  \param compute_polytopes Whether to store the vertices of each cell.
+     *         If false, every polytope is empty.
+     *  \param compute_statistics Whether to compute the surface areas,
+     *         Minkowski tensors and asphericities of the cells while they are
+     *         tessellated. If false, these arrays are empty.
+     */
+    void compute(const freud::locality::NeighborQuery* nq, bool compute_polytopes = true,
+                 bool compute_statistics = false);
+
+    //! Update the Voronoi diagram of the previous compute for new positions
+    /*! Only the cells that the moved points could have changed are
+     *  computed again: the cells of the moved points and the cells whose
+     *  points are closer to the previous or current position of a moved point
+     *  than twice the largest distance to the vertices of the cell. The other
+     *  cells are kept, so the results agree with those of compute up to
+     *  rounding. If the box, the number of points, compute_polytopes or
+     *  compute_statistics differ from the previous call, all cells are
+     *  computed.
+     *
+     *  \param nq The points and box.
+     *  \param compute_polytopes Whether to store the vertices of each cell.
+     *  \param compute_statistics Whether to compute the statistics of each cell.
+     */
+    void update(const freud::locality::NeighborQuery* nq, bool compute_polytopes = true,
+                bool compute_statistics = false);
+
+    //! Get the number of cells computed by the most recent compute or update
+    unsigned int getNumComputedCells() const
+    {
+        return m_num_computed_cells;
+    }
 
     std::shared_ptr<NeighborList> getNeighborList() const
     {
         return m_neighbor_list;
     }
 
-    std::vector<std::vector<vec3<double>>> getPolytopes() const
+    const util::RaggedArray<vec3<double>>& getPolytopes() const
     {
         return m_polytopes;
     }
@@ -36,11 +75,76 @@ public:
         return m_volumes;
     }
 
+    //! Get whether the statistics of the cells were computed
+    bool getComputeStatistics() const
+    {
+        return m_compute_statistics;
+    }
+
+    //! Get the surface area (perimeter in 2D) of each cell
+    const util::ManagedArray<double>& getSurfaceAreas() const
+    {
+        return m_surface_areas;
+    }
+
+    //! Get the surface tensor of each cell
+    /*! The Minkowski tensor \f$W_1^{0,2} = \frac{1}{d} \int n \otimes n \, dA\f$
+     *  integrates the outer product of the normal over the surface of the
+     *  cell, where d is the dimension, so it is the sum over the faces of
+     *  their area times the outer product of their normal, divided by d.
+     *  The array has shape (N, 3, 3).
+     */
+    const util::ManagedArray<double>& getSurfaceTensors() const
+    {
+        return m_surface_tensors;
+    }
+
+    //! Get the curvature tensor of each cell
+    /*! The Minkowski tensor \f$W_2^{0,2}\f$ weights the outer product of
+     *  the normal by the mean curvature, which is concentrated on the edges
+     *  of a polyhedron (vertices of a polygon), where the normal turns from
+     *  one face to the next. Each edge of length L, around which the normal
+     *  turns by the angle \f$\alpha\f$, contributes
+     *  \f$\frac{L}{12} \left[(\alpha + \sin\alpha) a \otimes a
+     *  + (\alpha - \sin\alpha) b \otimes b\right]\f$, with a and b the unit
+     *  vectors along the sum and difference of the normals of its faces. In
+     *  2D, each vertex contributes the same term with L / 12 replaced by
+     *  1 / 4. The array has shape (N, 3, 3).
+     */
+    const util::ManagedArray<double>& getCurvatureTensors() const
+    {
+        return m_curvature_tensors;
+    }
+
+    //! Get the asphericity of each cell
+    /*! The asphericity is the ratio of the smallest to the largest
+     *  eigenvalue of the surface tensor, which is 1 for cells whose
+     *  surface is isotropic, such as cubes and regular polygons, and
+     *  decreases as the cells become elongated or flattened.
+     */
+    const util::ManagedArray<double>& getAsphericities() const
+    {
+        return m_asphericities;
+    }
+
 private:
-    box::Box m_box;
-    std::shared_ptr<NeighborList> m_neighbor_list;      //!< Stored neighbor list
-    std::vector<std::vector<vec3<double>>> m_polytopes; //!< Voronoi polytopes
-    util::ManagedArray<double> m_volumes;               //!< Voronoi cell volumes
+    //! Compute the asphericities of the cells from their surface tensors
+    void computeAsphericities();
+
+    box::Box m_box;                                 //!< Box of the stored cells
+    std::shared_ptr<NeighborList> m_neighbor_list;  //!< Stored neighbor list
+    util::RaggedArray<vec3<double>> m_polytopes;    //!< Voronoi polytopes
+    util::ManagedArray<double> m_volumes;           //!< Voronoi cell volumes
+    util::ManagedArray<double> m_surface_areas;     //!< Surface area of each cell
+    util::ManagedArray<double> m_surface_tensors;   //!< Minkowski tensor W1^{0,2} of each cell
+    util::ManagedArray<double> m_curvature_tensors; //!< Minkowski tensor W2^{0,2} of each cell
+    util::ManagedArray<double> m_asphericities;     //!< Asphericity of each cell
+    std::vector<vec3<float>> m_points;              //!< Positions of the points of the stored cells
+    std::vector<double> m_cell_radii;               //!< Circumradius of each stored cell about its point
+    bool m_compute_polytopes {true};                //!< Whether the polytopes of the stored cells were kept
+    bool m_compute_statistics {false};              //!< Whether the statistics of the stored cells were kept
+    bool m_has_cells {false};                       //!< Whether cells have been computed
+    unsigned int m_num_computed_cells {0};          //!< Number of cells computed by the last call
 };
 }; }; // end namespace freud::locality
 
@@ -0,0 +1,352 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+
+#include "FFT.h"
+#include "MSD.h"
+#include "utils.h"
+
+/*! \file MSD.cc
+    \brief Routines for computing mean squared displacements.
+*/
+
+namespace freud { namespace msd {
+
+//! Get the unwrapped position of a point
+inline vec3<float> unwrappedPosition(const box::Box& box, const vec3<float>* positions,
+                                     const vec3<int>* images, size_t index)
+{
+    return images == nullptr ? positions[index] : box.unwrap(positions[index], images[index]);
+}
+
+void MSD::reset()
+{
+    m_n_frames = 0;
+    m_n_particles = 0;
+    m_msd.prepare(0);
+    m_particle_msd.prepare({0, 0});
+}
+
+void MSD::accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                     unsigned int n_particles)
+{
+    if (n_frames == 0)
+    {
+        throw std::invalid_argument("MSD requires at least one frame.");
+    }
+    if (m_n_particles != 0 && n_frames != m_n_frames)
+    {
+        throw std::invalid_argument("MSD can only accumulate particles over the same number of frames.");
+    }
+
+    // The new particles are appended as columns of the particle MSD array.
+    const unsigned int n_total = m_n_particles + n_particles;
+    util::ManagedArray<double> particle_msd({n_frames, n_total});
+    if (m_n_particles != 0)
+    {
+        for (size_t m = 0; m < n_frames; ++m)
+        {
+            const double* previous = m_particle_msd.get() + m * m_n_particles;
+            std::copy(previous, previous + m_n_particles, particle_msd.get() + m * n_total);
+        }
+    }
+
+    double* out = particle_msd.get() + m_n_particles;
+    if (m_mode == window)
+    {
+        computeWindow(positions, images, n_frames, n_particles, out, n_total);
+    }
+    else
+    {
+        computeDirect(positions, images, n_frames, n_particles, out, n_total);
+    }
+
+    // The mean is updated from the previous mean and the sums over the new particles.
+    util::ManagedArray<double> msd(n_frames);
+    util::forLoopWrapper(0, n_frames, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m)
+        {
+            double sum = 0;
+            for (unsigned int i = 0; i < n_particles; ++i)
+            {
+                sum += out[m * n_total + i];
+            }
+            const double previous = m_n_particles == 0 ? 0 : m_msd[m] * m_n_particles;
+            msd[m] = (previous + sum) / n_total;
+        }
+    });
+
+    m_n_frames = n_frames;
+    m_n_particles = n_total;
+    m_particle_msd = particle_msd;
+    m_msd = msd;
+}
+
+void MSD::computeWindow(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                        unsigned int n_particles, double* out, size_t stride) const
+{
+    // Zero padding to at least 2 * n_frames turns the circular autocorrelation
+    // computed by the FFT into the linear autocorrelation. A power of two
+    // length uses the fast radix-2 path of the plan.
+    size_t fft_size = 1;
+    while (fft_size < 2 * static_cast<size_t>(n_frames))
+    {
+        fft_size *= 2;
+    }
+    const util::FFTPlan plan(fft_size);
+    const double scale = 1.0 / static_cast<double>(fft_size);
+
+    util::forLoopWrapper(0, n_particles, [&](size_t begin, size_t end) {
+        std::vector<std::complex<double>> xy(fft_size);
+        std::vector<std::complex<double>> z(fft_size);
+        std::vector<double> square_norms(n_frames);
+        for (size_t i = begin; i < end; ++i)
+        {
+            std::fill(xy.begin(), xy.end(), 0);
+            std::fill(z.begin(), z.end(), 0);
+            double sum_square_norms = 0;
+            for (unsigned int t = 0; t < n_frames; ++t)
+            {
+                const vec3<float> r
+                    = unwrappedPosition(m_box, positions, images, static_cast<size_t>(t) * n_particles + i);
+                xy[t] = std::complex<double>(r.x, r.y);
+                z[t] = std::complex<double>(r.z, 0);
+                square_norms[t] = double(r.x) * r.x + double(r.y) * r.y + double(r.z) * r.z;
+                sum_square_norms += square_norms[t];
+            }
+
+            // The real part of the autocorrelation of x + iy is the sum of the
+            // autocorrelations of x and y, so the power spectra of both
+            // transforms can be added before a single inverse transform.
+            plan.forward(xy.data());
+            plan.forward(z.data());
+            for (size_t k = 0; k < fft_size; ++k)
+            {
+                xy[k] = std::norm(xy[k]) + std::norm(z[k]);
+            }
+            plan.inverse(xy.data());
+
+            // The MSD at lag m is S1(m) - 2 S2(m), where S2 is the
+            // autocorrelation and S1 averages |r(k)|^2 + |r(k + m)|^2 over the
+            // windows, which is updated by removing the two terms that leave
+            // the window sum at each lag.
+            double window_sum = 2 * sum_square_norms;
+            for (unsigned int m = 0; m < n_frames; ++m)
+            {
+                if (m > 0)
+                {
+                    window_sum -= square_norms[m - 1] + square_norms[n_frames - m];
+                }
+                const double num_windows = n_frames - m;
+                const double autocorrelation = xy[m].real() * scale;
+                out[m * stride + i] = (window_sum - 2 * autocorrelation) / num_windows;
+            }
+        }
+    });
+}
+
+void MSD::computeDirect(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                        unsigned int n_particles, double* out, size_t stride) const
+{
+    util::forLoopWrapper(0, n_particles, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<float> r0 = unwrappedPosition(m_box, positions, images, i);
+            for (unsigned int t = 0; t < n_frames; ++t)
+            {
+                const vec3<float> r
+                    = unwrappedPosition(m_box, positions, images, static_cast<size_t>(t) * n_particles + i);
+                const vec3<double> delta(double(r.x) - r0.x, double(r.y) - r0.y, double(r.z) - r0.z);
+                out[t * stride + i] = dot(delta, delta);
+            }
+        }
+    });
+}
+
+MultiTauMSD::MultiTauMSD(const box::Box& box, unsigned int points_per_level, unsigned int level_ratio)
+    : m_box(box), m_points_per_level(points_per_level), m_level_ratio(level_ratio)
+{
+    if (points_per_level < 2)
+    {
+        throw std::invalid_argument("MultiTauMSD requires at least two points per level.");
+    }
+    if (level_ratio < 2)
+    {
+        throw std::invalid_argument("MultiTauMSD requires a level ratio of at least two.");
+    }
+    reset();
+}
+
+void MultiTauMSD::reset()
+{
+    m_n_frames = 0;
+    m_n_particles = 0;
+    m_levels.clear();
+    m_frame.clear();
+    m_lags.prepare(0);
+    m_msd.prepare(0);
+    m_counts.prepare(0);
+}
+
+void MultiTauMSD::addLevel(size_t spacing)
+{
+    Level level;
+    level.spacing = spacing;
+    level.positions.resize(static_cast<size_t>(m_points_per_level) * m_n_particles);
+    level.frames.resize(m_points_per_level);
+    level.sums.resize(m_points_per_level);
+    level.counts.resize(m_points_per_level);
+    m_levels.push_back(std::move(level));
+    m_local_sums.resize(m_levels.size() * m_points_per_level);
+}
+
+void MultiTauMSD::store(Level& level, size_t frame, const vec3<float>* positions) const
+{
+    std::copy(positions, positions + m_n_particles,
+              level.positions.begin() + static_cast<size_t>(level.next_slot) * m_n_particles);
+    level.frames[level.next_slot] = frame;
+    level.next_slot = (level.next_slot + 1) % m_points_per_level;
+    level.num_stored = std::min(level.num_stored + 1, m_points_per_level);
+}
+
+unsigned int MultiTauMSD::firstLagMultiple(size_t level) const
+{
+    // Level l measures the multiples of its spacing that are longer than the
+    // longest lag (m_points_per_level - 1) * spacing / m_level_ratio of level l - 1.
+    return level == 0 ? 1 : (m_points_per_level - 1) / m_level_ratio + 1;
+}
+
+void MultiTauMSD::accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_particles)
+{
+    if (m_n_frames == 0)
+    {
+        m_n_particles = n_particles;
+        m_frame.resize(n_particles);
+        addLevel(1);
+    }
+    else if (n_particles != m_n_particles)
+    {
+        throw std::invalid_argument("MultiTauMSD requires the same number of particles in every frame.");
+    }
+
+    util::forLoopWrapper(0, n_particles, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_frame[i] = unwrappedPosition(m_box, positions, images, i);
+        }
+    });
+
+    // Find the levels that the frame enters and the stored frames that it is
+    // correlated with. A full level is about to drop its oldest frame, so a
+    // coarser level is added first, seeded with the stored frames at its
+    // spacing. The seeded frames are closer together than the lags measured
+    // by the new level, so no pair of them needs to be correlated.
+    const size_t frame = m_n_frames;
+    struct Pair
+    {
+        size_t level;
+        unsigned int slot;
+        unsigned int lag_multiple;
+    };
+    std::vector<Pair> pairs;
+    size_t num_entered = 0;
+    for (size_t l = 0; l < m_levels.size() && frame % m_levels[l].spacing == 0; ++l)
+    {
+        if (m_levels[l].num_stored == m_points_per_level && l + 1 == m_levels.size())
+        {
+            const size_t spacing = m_levels[l].spacing * m_level_ratio;
+            addLevel(spacing);
+            Level& finer = m_levels[l];
+            // Seed in the order the frames were stored, starting from the oldest.
+            for (unsigned int s = 0; s < m_points_per_level; ++s)
+            {
+                const unsigned int slot = (finer.next_slot + s) % m_points_per_level;
+                if (finer.frames[slot] % spacing == 0)
+                {
+                    store(m_levels[l + 1], finer.frames[slot],
+                          finer.positions.data() + static_cast<size_t>(slot) * m_n_particles);
+                }
+            }
+        }
+
+        const Level& level = m_levels[l];
+        for (unsigned int slot = 0; slot < level.num_stored; ++slot)
+        {
+            const size_t lag_multiple = (frame - level.frames[slot]) / level.spacing;
+            if (lag_multiple >= firstLagMultiple(l) && lag_multiple < m_points_per_level)
+            {
+                pairs.push_back({l, slot, static_cast<unsigned int>(lag_multiple)});
+            }
+        }
+        ++num_entered;
+    }
+
+    // Sum the squared displacements of each pair over the particles in parallel.
+    m_local_sums.reset();
+    util::forLoopWrapper(0, n_particles, [&](size_t begin, size_t end) {
+        auto& local_sums = m_local_sums.local();
+        for (size_t p = 0; p < pairs.size(); ++p)
+        {
+            const vec3<float>* stored = m_levels[pairs[p].level].positions.data()
+                + static_cast<size_t>(pairs[p].slot) * m_n_particles;
+            double sum = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const vec3<float> delta = m_frame[i] - stored[i];
+                sum += double(delta.x) * delta.x + double(delta.y) * delta.y + double(delta.z) * delta.z;
+            }
+            local_sums[p] += sum;
+        }
+    });
+    util::ManagedArray<double> sums(m_levels.size() * m_points_per_level);
+    m_local_sums.reduceInto(sums);
+    for (size_t p = 0; p < pairs.size(); ++p)
+    {
+        Level& level = m_levels[pairs[p].level];
+        level.sums[pairs[p].lag_multiple] += sums[p];
+        ++level.counts[pairs[p].lag_multiple];
+    }
+
+    for (size_t l = 0; l < num_entered; ++l)
+    {
+        store(m_levels[l], frame, m_frame.data());
+    }
+    ++m_n_frames;
+    updateOutputs();
+}
+
+void MultiTauMSD::updateOutputs()
+{
+    // Lag zero, which has every frame as a time origin, is listed first.
+    std::vector<unsigned int> lags {0};
+    std::vector<double> msd {0};
+    std::vector<unsigned int> counts {m_n_frames};
+    for (size_t l = 0; l < m_levels.size(); ++l)
+    {
+        const Level& level = m_levels[l];
+        for (unsigned int j = firstLagMultiple(l); j < m_points_per_level; ++j)
+        {
+            if (level.counts[j] != 0)
+            {
+                lags.push_back(static_cast<unsigned int>(j * level.spacing));
+                msd.push_back(level.sums[j] / (static_cast<double>(level.counts[j]) * m_n_particles));
+                counts.push_back(level.counts[j]);
+            }
+        }
+    }
+
+    m_lags.prepare(lags.size());
+    m_msd.prepare(msd.size());
+    m_counts.prepare(counts.size());
+    for (size_t i = 0; i < lags.size(); ++i)
+    {
+        m_lags[i] = lags[i];
+        m_msd[i] = msd[i];
+        m_counts[i] = counts[i];
+    }
+}
+
+}; }; // end namespace freud::msd
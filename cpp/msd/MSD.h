@@ -0,0 +1,234 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef MSD_H
+#define MSD_H
+
+#include <vector>
+
+#include "Box.h"
+#include "ManagedArray.h"
+#include "ThreadStorage.h"
+#include "VectorMath.h"
+
+/*! \file MSD.h
+    \brief Routines for computing mean squared displacements.
+*/
+
+namespace freud { namespace msd {
+
+//! Definitions of the mean squared displacement
+enum MSDMode
+{
+    window, //!< Average over all windows of each length
+    direct  //!< Displacement from the first frame
+};
+
+//! Compute the mean squared displacement of particles over a trajectory
+/*! The MSD of each particle is computed independently, in parallel over the
+ *  particles. In window mode, the average over all time origins is computed
+ *  from the autocorrelation of the trajectory of each particle, which is
+ *  evaluated with fast Fourier transforms in O(N_frames log N_frames) time
+ *  per particle (see Calandrini et al., nMoldyn). The x and y coordinates of
+ *  a particle are transformed together as the real and imaginary parts of a
+ *  single complex sequence, whose autocorrelation has the sum of the
+ *  autocorrelations of the two coordinates as its real part.
+ *
+ *  Positions given with image flags are unwrapped with the box as they are
+ *  read, so no unwrapped copy of the trajectory is made.
+ *
+ *  Accumulation is over particles rather than frames: each call to accumulate
+ *  adds the particle MSDs of another set of particles over the same frames.
+ */
+class MSD
+{
+public:
+    //! Constructor
+    /*! \param box Box used to unwrap positions with their image flags.
+     *  \param mode Definition of the MSD to compute.
+     */
+    MSD(const box::Box& box, MSDMode mode) : m_box(box), m_mode(mode) {}
+
+    //! Destructor
+    virtual ~MSD() = default;
+
+    //! Reset the MSD to zero particles
+    void reset();
+
+    //! Compute the MSD of a set of particles and add them to the current particles
+    /*! \param positions Positions of shape (n_frames, n_particles) in row-major order.
+     *  \param images Image flags of the positions with the same shape, or
+     *         nullptr if the positions are already unwrapped.
+     *  \param n_frames Number of frames.
+     *  \param n_particles Number of particles in each frame.
+     */
+    void accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                    unsigned int n_particles);
+
+    //! Get the MSD averaged over all particles, of shape (n_frames,)
+    const util::ManagedArray<double>& getMSD() const
+    {
+        return m_msd;
+    }
+
+    //! Get the MSD of each particle, of shape (n_frames, n_particles)
+    const util::ManagedArray<double>& getParticleMSD() const
+    {
+        return m_particle_msd;
+    }
+
+    //! Get the box used to unwrap positions
+    const box::Box& getBox() const
+    {
+        return m_box;
+    }
+
+    //! Get the definition of the MSD
+    MSDMode getMode() const
+    {
+        return m_mode;
+    }
+
+private:
+    //! Compute the MSD of particles with windowed averaging
+    /*! The MSD of particle i at lag m is written to out[m * stride + i]. */
+    void computeWindow(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                       unsigned int n_particles, double* out, size_t stride) const;
+
+    //! Compute the MSD of particles from their first positions
+    /*! The MSD of particle i at frame m is written to out[m * stride + i]. */
+    void computeDirect(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                       unsigned int n_particles, double* out, size_t stride) const;
+
+    box::Box m_box;                            //!< Box used to unwrap positions
+    MSDMode m_mode;                            //!< Definition of the MSD
+    unsigned int m_n_frames {0};               //!< Number of frames of the accumulated particles
+    unsigned int m_n_particles {0};            //!< Number of accumulated particles
+    util::ManagedArray<double> m_msd;          //!< MSD averaged over particles
+    util::ManagedArray<double> m_particle_msd; //!< MSD of each particle
+};
+
+//! Compute the mean squared displacement of a trajectory streamed one frame at a time
+/*! Storing the whole trajectory is not possible for long trajectories of
+ *  large systems, so this class implements a multiple-tau scheme that keeps a
+ *  bounded history of frames. The history is a hierarchy of levels, where
+ *  level l stores the last points_per_level frames whose indices are
+ *  multiples of level_ratio^l. Each new frame is correlated with the frames
+ *  in every level that it enters, and level l measures the lags
+ *  j * level_ratio^l that are longer than the lags of level l - 1, so every
+ *  lag is measured by a single level. Short lags are averaged over every
+ *  frame as time origin and the lags measured by level l are averaged over
+ *  one in level_ratio^l frames, so the MSD is sampled at logarithmically
+ *  spaced lags with a memory cost of O(points_per_level * N_particles *
+ *  log(N_frames)).
+ *
+ *  Frames are not averaged within levels, so the MSD at each measured lag is
+ *  an unbiased average over its time origins.
+ */
+class MultiTauMSD
+{
+public:
+    //! Constructor
+    /*! \param box Box used to unwrap positions with their image flags.
+     *  \param points_per_level Number of frames stored in each level.
+     *  \param level_ratio Ratio of the frame spacings of consecutive levels.
+     */
+    MultiTauMSD(const box::Box& box, unsigned int points_per_level, unsigned int level_ratio);
+
+    //! Destructor
+    virtual ~MultiTauMSD() = default;
+
+    //! Discard all frames
+    void reset();
+
+    //! Add the next frame of the trajectory
+    /*! \param positions Positions of the particles.
+     *  \param images Image flags of the positions, or nullptr if the
+     *         positions are already unwrapped.
+     *  \param n_particles Number of particles, which must be the same in every frame.
+     */
+    void accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_particles);
+
+    //! Get the measured lags, in frames
+    const util::ManagedArray<unsigned int>& getLags() const
+    {
+        return m_lags;
+    }
+
+    //! Get the MSD at each measured lag
+    const util::ManagedArray<double>& getMSD() const
+    {
+        return m_msd;
+    }
+
+    //! Get the number of time origins averaged at each measured lag
+    const util::ManagedArray<unsigned int>& getCounts() const
+    {
+        return m_counts;
+    }
+
+    //! Get the number of frames added since the last reset
+    unsigned int getNumFrames() const
+    {
+        return m_n_frames;
+    }
+
+    //! Get the box used to unwrap positions
+    const box::Box& getBox() const
+    {
+        return m_box;
+    }
+
+    //! Get the number of frames stored in each level
+    unsigned int getPointsPerLevel() const
+    {
+        return m_points_per_level;
+    }
+
+    //! Get the ratio of the frame spacings of consecutive levels
+    unsigned int getLevelRatio() const
+    {
+        return m_level_ratio;
+    }
+
+private:
+    //! The frames stored at one spacing
+    struct Level
+    {
+        size_t spacing;                     //!< Spacing of the frames of the level
+        std::vector<vec3<float>> positions; //!< Ring buffer of the positions of the stored frames
+        std::vector<size_t> frames;         //!< Frame index of each slot of the ring buffer
+        unsigned int num_stored {0};        //!< Number of occupied slots
+        unsigned int next_slot {0};         //!< Slot that the next frame is written to
+        std::vector<double> sums;           //!< Sum of squared displacements at each lag multiple
+        std::vector<unsigned int> counts;   //!< Number of time origins at each lag multiple
+    };
+
+    //! Add an empty level with the given spacing
+    void addLevel(size_t spacing);
+
+    //! Store a frame in a level, replacing its oldest frame if it is full
+    void store(Level& level, size_t frame, const vec3<float>* positions) const;
+
+    //! Smallest lag multiple measured by a level
+    unsigned int firstLagMultiple(size_t level) const;
+
+    //! Rebuild the output arrays from the accumulated sums
+    void updateOutputs();
+
+    box::Box m_box;                            //!< Box used to unwrap positions
+    unsigned int m_points_per_level;           //!< Number of frames stored in each level
+    unsigned int m_level_ratio;                //!< Ratio of the frame spacings of consecutive levels
+    unsigned int m_n_frames {0};               //!< Number of frames added since the last reset
+    unsigned int m_n_particles {0};            //!< Number of particles in each frame
+    std::vector<Level> m_levels;               //!< The levels, from the finest spacing to the coarsest
+    std::vector<vec3<float>> m_frame;          //!< Unwrapped positions of the current frame
+    util::ThreadStorage<double> m_local_sums;  //!< Thread local sums of squared displacements
+    util::ManagedArray<unsigned int> m_lags;   //!< Measured lags
+    util::ManagedArray<double> m_msd;          //!< MSD at each measured lag
+    util::ManagedArray<unsigned int> m_counts; //!< Number of time origins at each measured lag
+};
+
+}; }; // end namespace freud::msd
+
+#endif // MSD_H
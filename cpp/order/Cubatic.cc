@@ -8,6 +8,7 @@
 #include <tbb/parallel_for.h>
 
 #include "Cubatic.h"
+#include "SmallTensor.h"
 #include "utils.h"
 
 /*! \file Cubatic.h
@@ -16,24 +17,60 @@
 
 namespace freud { namespace order {
 
+namespace {
+
+//! Exponents of x, y and z of each independent component of a tensor4
+/*! The component with exponents (a, b, c) holds the elements whose indices
+ *  contain 0 a times, 1 b times and 2 c times. The components are ordered by
+ *  the sorted indices of their elements, 0000, 0001, 0002, 0011, ..., 2222.
+ */
+constexpr std::array<std::array<unsigned int, 3>, tensor4::size> TENSOR4_POWERS {
+    {{4, 0, 0},
+     {3, 1, 0},
+     {3, 0, 1},
+     {2, 2, 0},
+     {2, 1, 1},
+     {2, 0, 2},
+     {1, 3, 0},
+     {1, 2, 1},
+     {1, 1, 2},
+     {1, 0, 3},
+     {0, 4, 0},
+     {0, 3, 1},
+     {0, 2, 2},
+     {0, 1, 3},
+     {0, 0, 4}}};
+
+//! Number of elements of a tensor4 equal to each independent component, 4! / (a! b! c!)
+constexpr std::array<float, tensor4::size> TENSOR4_MULTIPLICITIES {1, 4, 4, 6, 12, 6, 4, 12, 12, 4,
+                                                                      1, 4, 6, 4,  1};
+
+//! Index of the independent component holding the element with the given numbers of 1 and 2 indices
+inline unsigned int tensor4Index(unsigned int num_ones, unsigned int num_twos)
+{
+    return (num_ones + num_twos) * (num_ones + num_twos + 1) / 2 + num_twos;
+}
+
+}; // end anonymous namespace
+
 tensor4::tensor4(const vec3<float>& vector)
 {
-    unsigned int cnt = 0;
-    std::array<float, 3> v = {vector.x, vector.y, vector.z};
-    for (float vi : v)
+    // Powers 0 to 4 of each coordinate
+    util::SmallTensor<float, 3, 5> powers;
+    const std::array<float, 3> v = {vector.x, vector.y, vector.z};
+    for (unsigned int d = 0; d < 3; ++d)
     {
-        for (float vj : v)
+        powers(d, 0) = 1;
+        for (unsigned int n = 1; n < 5; ++n)
         {
-            for (float vk : v)
-            {
-                for (float vl : v)
-                {
-                    data[cnt] = vi * vj * vk * vl;
-                    cnt++;
-                }
-            }
+            powers(d, n) = powers(d, n - 1) * v[d];
         }
     }
+    for (unsigned int n = 0; n < size; ++n)
+    {
+        data[n] = powers(0, TENSOR4_POWERS[n][0]) * powers(1, TENSOR4_POWERS[n][1])
+            * powers(2, TENSOR4_POWERS[n][2]);
+    }
 }
 
 //! Writeable index into array.
@@ -44,7 +81,7 @@ float& tensor4::operator[](unsigned int index)
 
 tensor4 tensor4::operator+=(const tensor4& b)
 {
-    for (unsigned int i = 0; i < 81; i++)
+    for (unsigned int i = 0; i < size; i++)
     {
         data[i] += b.data[i];
     }
@@ -54,7 +91,7 @@ tensor4 tensor4::operator+=(const tensor4& b)
 tensor4 tensor4::operator-(const tensor4& b) const
 {
     tensor4 c;
-    for (unsigned int i = 0; i < 81; i++)
+    for (unsigned int i = 0; i < size; i++)
     {
         c.data[i] = data[i] - b.data[i];
     }
@@ -64,7 +101,7 @@ tensor4 tensor4::operator-(const tensor4& b) const
 tensor4 tensor4::operator*(const float& b) const
 {
     tensor4 c;
-    for (unsigned int i = 0; i < 81; i++)
+    for (unsigned int i = 0; i < size; i++)
     {
         c.data[i] = data[i] * b;
     }
@@ -73,11 +110,29 @@ tensor4 tensor4::operator*(const float& b) const
 
 void tensor4::copyToManagedArray(util::ManagedArray<float>& ma)
 {
-    std::copy(data.begin(), data.end(), ma.get());
+    unsigned int cnt = 0;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                for (unsigned int l = 0; l < 3; ++l)
+                {
+                    const unsigned int num_ones = (i == 1) + (j == 1) + (k == 1) + (l == 1);
+                    const unsigned int num_twos = (i == 2) + (j == 2) + (k == 2) + (l == 2);
+                    ma[cnt] = data[tensor4Index(num_ones, num_twos)];
+                    ++cnt;
+                }
+            }
+        }
+    }
 }
 
 //! Complete tensor contraction.
-/*! This function is simply a sum-product over two tensors. For reference, see eq. 4.
+/*! This function is simply a sum-product over two tensors. For reference, see
+ *  eq. 4. Each independent component stands for all of the elements that are
+ *  equal to it by symmetry.
  *
  *  \param a The first tensor.
  *  \param b The second tensor.
@@ -85,9 +140,9 @@ void tensor4::copyToManagedArray(util::ManagedArray<float>& ma)
 float dot(const tensor4& a, const tensor4& b)
 {
     float c = 0;
-    for (unsigned int i = 0; i < 81; i++)
+    for (unsigned int i = 0; i < tensor4::size; i++)
     {
-        c += a.data[i] * b.data[i];
+        c += TENSOR4_MULTIPLICITIES[i] * a.data[i] * b.data[i];
     }
     return c;
 }
@@ -100,37 +155,85 @@ float dot(const tensor4& a, const tensor4& b)
  */
 tensor4 genR4Tensor()
 {
-    // Construct the identity matrix to build the delta functions.
-    util::ManagedArray<float> identity({3, 3});
-    identity(0, 0) = 1;
-    identity(1, 1) = 1;
-    identity(2, 2) = 1;
-
-    unsigned int cnt = 0;
     tensor4 r4 = tensor4();
-    for (unsigned int i = 0; i < 3; ++i)
+    for (unsigned int n = 0; n < tensor4::size; ++n)
     {
-        for (unsigned int j = 0; j < 3; ++j)
+        // The sorted indices ijkl of an element of this component.
+        std::array<unsigned int, 4> indices {};
+        unsigned int cnt = 0;
+        for (unsigned int d = 0; d < 3; ++d)
         {
-            for (unsigned int k = 0; k < 3; ++k)
+            for (unsigned int p = 0; p < TENSOR4_POWERS[n][d]; ++p)
             {
-                for (unsigned int l = 0; l < 3; ++l)
-                {
-                    // ijkl term
-                    r4[cnt] += identity(i, j) * identity(k, l);
-                    // ikjl term
-                    r4[cnt] += identity(i, k) * identity(j, l);
-                    // iljk term
-                    r4[cnt] += identity(i, l) * identity(j, k);
-                    r4[cnt] *= 2.0 / 5.0;
-                    ++cnt;
-                }
+                indices[cnt++] = d;
             }
         }
+        const unsigned int i = indices[0];
+        const unsigned int j = indices[1];
+        const unsigned int k = indices[2];
+        const unsigned int l = indices[3];
+        // ijkl, ikjl and iljk terms
+        r4[n] = static_cast<float>((i == j) * (k == l) + (i == k) * (j == l) + (i == l) * (j == k));
+        r4[n] *= 2.0 / 5.0;
     }
     return r4;
 }
 
+namespace {
+
+//! Maximum number of annealing steps of each replicate
+constexpr unsigned int CUBATIC_MAX_STEPS = 10000;
+
+//! Number of consecutive rejected steps after which a replicate has converged
+constexpr unsigned int CUBATIC_MAX_REJECTIONS = 1000;
+
+//! Evaluates the cubatic order parameter of orientations against a global tensor.
+/*! Implements eq. 22 without forming the cubatic tensor M_{\omega}. Since the
+ *  r4 tensor is isotropic, the norm of M_{\omega} does not depend on the
+ *  orientation, and the squared norm of \bar{M} - M_{\omega} expands into
+ *  constants and the contraction of \bar{M} with M_{\omega}. That
+ *  contraction is a sum over the rotated system vectors.
+ */
+class CubaticOrderParameterEvaluator
+{
+public:
+    CubaticOrderParameterEvaluator(const tensor4& global_tensor, const tensor4& r4_tensor,
+                                   const std::array<vec3<float>, 3>& system_vectors)
+        : m_global_tensor(global_tensor), m_system_vectors(system_vectors)
+    {
+        // The norm of M_{\omega} is evaluated for the identity orientation.
+        tensor4 cubatic_tensor;
+        for (const auto& system_vector : system_vectors)
+        {
+            cubatic_tensor += tensor4(system_vector);
+        }
+        cubatic_tensor = cubatic_tensor * float(2.0) - r4_tensor;
+        m_cubatic_norm = dot(cubatic_tensor, cubatic_tensor);
+        m_global_norm = dot(global_tensor, global_tensor);
+        m_global_r4 = dot(global_tensor, r4_tensor);
+    }
+
+    float operator()(const quat<float>& orientation) const
+    {
+        float global_cubatic = 0;
+        for (const auto& system_vector : m_system_vectors)
+        {
+            global_cubatic += dot(m_global_tensor, tensor4(rotate(orientation, system_vector)));
+        }
+        global_cubatic = float(2.0) * global_cubatic - m_global_r4;
+        return float(1.0) - (m_global_norm - float(2.0) * global_cubatic + m_cubatic_norm) / m_cubatic_norm;
+    }
+
+private:
+    const tensor4& m_global_tensor;                     //!< The global tensor \bar{M}
+    const std::array<vec3<float>, 3>& m_system_vectors; //!< The system vectors
+    float m_cubatic_norm;                               //!< Squared norm of M_{\omega}
+    float m_global_norm;                                //!< Squared norm of \bar{M}
+    float m_global_r4;                                  //!< Contraction of \bar{M} with r4
+};
+
+}; // end anonymous namespace
+
 Cubatic::Cubatic(float t_initial, float t_final, float scale, unsigned int n_replicates, unsigned int seed)
     : m_t_initial(t_initial), m_t_final(t_final), m_scale(scale), m_n_replicates(n_replicates), m_seed(seed)
 {
@@ -168,12 +271,6 @@ tensor4 Cubatic::calcCubaticTensor(quat<float>& orientation)
     return calculated_tensor * float(2.0) - m_gen_r4_tensor;
 }
 
-float Cubatic::calcCubaticOrderParameter(const tensor4& cubatic_tensor, const tensor4& global_tensor)
-{
-    tensor4 diff = global_tensor - cubatic_tensor;
-    return float(1.0) - dot(diff, diff) / dot(cubatic_tensor, cubatic_tensor);
-}
-
 template<typename T> quat<float> Cubatic::calcRandomQuaternion(T& dist, float angle_multiplier) const
 {
     float theta = 2.0 * M_PI * dist();
@@ -219,7 +316,7 @@ tensor4 Cubatic::calculateGlobalTensor(quat<float>* orientations) const
     // now calculate the global tensor
     float n_inv = float(1.0) / static_cast<float>(m_n);
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, 81),
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tensor4::size),
                       [=, &global_tensor, &n_inv, &particle_tensor](const tbb::blocked_range<size_t>& r) {
                           for (size_t i = r.begin(); i != r.end(); i++)
                           {
@@ -253,80 +350,58 @@ void Cubatic::compute(quat<float>* orientations, unsigned int num_orientations)
     // parameter, but in practice we find that simulated annealing performs
     // much better, so we perform replicates of the process and choose the best
     // one.
+    const CubaticOrderParameterEvaluator calcOrderParameter(global_tensor, m_gen_r4_tensor, m_system_vectors);
     util::ManagedArray<tensor4> p_cubatic_tensor(m_n_replicates);
     util::ManagedArray<float> p_cubatic_order_parameter(m_n_replicates);
     util::ManagedArray<quat<float>> p_cubatic_orientation(m_n_replicates);
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, m_n_replicates),
-        [=, &p_cubatic_orientation, &p_cubatic_order_parameter,
-         &p_cubatic_tensor](const tbb::blocked_range<size_t>& r) {
-            // create thread-specific rng
-            unsigned int thread_start = r.begin();
-
-            std::vector<unsigned int> seed_seq(3);
-            seed_seq[0] = m_seed;
-            seed_seq[1] = thread_start;
-            seed_seq[2] = 0xffaabb;
-            std::seed_seq seed(seed_seq.begin(), seed_seq.end());
+    util::forLoopWrapper(0, m_n_replicates, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            // Each replicate has its own random number stream, so the results
+            // do not depend on how the replicates are distributed over threads.
+            std::seed_seq seed {m_seed, static_cast<unsigned int>(i), 0xffaabbU};
             std::mt19937 rng(seed);
             std::uniform_real_distribution<float> base_dist(0, 1);
             auto dist = [&]() { return base_dist(rng); };
 
-            for (size_t i = r.begin(); i != r.end(); i++)
+            // need to generate random orientation
+            quat<float> cubatic_orientation = calcRandomQuaternion(dist);
+            float cubatic_order_parameter = calcOrderParameter(cubatic_orientation);
+
+            // set initial temperature and count
+            float t_current = m_t_initial;
+            unsigned int loop_count = 0;
+            unsigned int num_rejections = 0;
+            // simulated annealing loop; loop counter to prevent inf loops, and
+            // stop early once no step has been accepted for a long time
+            while ((t_current > m_t_final) && (loop_count < CUBATIC_MAX_STEPS)
+                   && (num_rejections < CUBATIC_MAX_REJECTIONS))
             {
-                // need to generate random orientation
-                quat<float> cubatic_orientation = calcRandomQuaternion(dist);
-                quat<float> new_orientation = cubatic_orientation;
-
-                // now calculate the cubatic tensor
-                tensor4 cubatic_tensor = calcCubaticTensor(cubatic_orientation);
-                float cubatic_order_parameter = calcCubaticOrderParameter(cubatic_tensor, global_tensor);
-                float new_order_parameter = cubatic_order_parameter;
-
-                // set initial temperature and count
-                float t_current = m_t_initial;
-                unsigned int loop_count = 0;
-                // simulated annealing loop; loop counter to prevent inf loops
-                while ((t_current > m_t_final) && (loop_count < 10000))
+                ++loop_count;
+                const quat<float> new_orientation = calcRandomQuaternion(dist, 0.1) * cubatic_orientation;
+                const float new_order_parameter = calcOrderParameter(new_orientation);
+                if ((new_order_parameter > cubatic_order_parameter)
+                    || (std::exp(-(cubatic_order_parameter - new_order_parameter) / t_current) >= dist()))
                 {
-                    ++loop_count;
-                    new_orientation = calcRandomQuaternion(dist, 0.1) * (cubatic_orientation);
-                    // now calculate the cubatic tensor
-                    tensor4 new_cubatic_tensor = calcCubaticTensor(new_orientation);
-                    new_order_parameter = calcCubaticOrderParameter(new_cubatic_tensor, global_tensor);
-                    if (new_order_parameter > cubatic_order_parameter)
-                    {
-                        cubatic_tensor = new_cubatic_tensor;
-                        cubatic_order_parameter = new_order_parameter;
-                        cubatic_orientation = new_orientation;
-                    }
-                    else
-                    {
-                        float boltzmann_factor
-                            = std::exp(-(cubatic_order_parameter - new_order_parameter) / t_current);
-                        if (boltzmann_factor >= dist())
-                        {
-                            cubatic_tensor = new_cubatic_tensor;
-                            cubatic_order_parameter = new_order_parameter;
-                            cubatic_orientation = new_orientation;
-                        }
-                        else
-                        {
-                            continue;
-                        }
-                    }
+                    cubatic_order_parameter = new_order_parameter;
+                    cubatic_orientation = new_orientation;
+                    num_rejections = 0;
                     t_current *= m_scale;
                 }
-                // set values
-                p_cubatic_tensor[i] = cubatic_tensor;
-                p_cubatic_orientation[i].s = cubatic_orientation.s;
-                p_cubatic_orientation[i].v = cubatic_orientation.v;
-                p_cubatic_order_parameter[i] = cubatic_order_parameter;
+                else
+                {
+                    ++num_rejections;
+                }
             }
-        });
+            // set values
+            p_cubatic_tensor[i] = calcCubaticTensor(cubatic_orientation);
+            p_cubatic_orientation[i] = cubatic_orientation;
+            p_cubatic_order_parameter[i] = cubatic_order_parameter;
+        }
+    });
 
-    // Loop over threads and choose the replicate that found the highest order.
+    // Choose the replicate that found the highest order.
     unsigned int max_idx = 0;
     float max_cubatic_order_parameter = p_cubatic_order_parameter[max_idx];
     for (unsigned int i = 1; i < m_n_replicates; ++i)
@@ -344,14 +419,13 @@ void Cubatic::compute(quat<float>* orientations, unsigned int num_orientations)
     m_cubatic_order_parameter = p_cubatic_order_parameter[max_idx];
 
     // Now calculate the per-particle order parameters
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_n), [=](const tbb::blocked_range<size_t>& r) {
-        for (size_t i = r.begin(); i != r.end(); i++)
+    util::forLoopWrapper(0, m_n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
             // The per-particle order parameter is defined as the value of the
             // cubatic order parameter if the global orientation was the
             // particle orientation, so we can reuse the same machinery.
-            m_particle_order_parameter[i]
-                = calcCubaticOrderParameter(calcCubaticTensor(orientations[i]), global_tensor);
+            m_particle_order_parameter[i] = calcOrderParameter(orientations[i]);
         }
     });
 }
@@ -21,9 +21,16 @@ namespace freud { namespace order {
  *  tensor4 class encapsulates some of the basic features required to enable
  *  these calculations, in particular the construction of the tensor from a
  *  vector and some arithmetic operations that help simplify the code.
+ *
+ *  These tensors are fully symmetric, so only the 15 independent components
+ *  of the 81 elements are stored. The elements of a component are those
+ *  with the same number of each index, and copyToManagedArray expands the
+ *  components into the full 3x3x3x3 array.
  */
 struct tensor4
 {
+    static constexpr unsigned int size = 15; //!< Number of independent components
+
     tensor4() = default;
     explicit tensor4(const vec3<float>& vector);
     tensor4 operator+=(const tensor4& b);
@@ -33,7 +40,7 @@ struct tensor4
 
     void copyToManagedArray(util::ManagedArray<float>& ma);
 
-    std::array<float, 81> data {0};
+    std::array<float, size> data {0};
 };
 
 //! Compute the cubatic order parameter for a set of points
@@ -134,16 +141,6 @@ private:
      */
     tensor4 calcCubaticTensor(quat<float>& orientation);
 
-    //! Calculate the scalar cubatic order parameter.
-    /*! Implements eq. 22.
-     *
-     *  \param cubatic_tensor The cubatic tensor M_{\omega}.
-     *  \param global_tensor The tensor encoding the average system orientation (denoted \bar{M}).
-     *
-     *  \return The value of the cubatic order parameter.
-     */
-    static float calcCubaticOrderParameter(const tensor4& cubatic_tensor, const tensor4& global_tensor);
-
     //! Calculate the per-particle tensor.
     /*! Implements the first line of eq. 27, the calculation of M.
      *
@@ -5,45 +5,41 @@
 
 namespace freud { namespace order {
 
+template<typename T>
+void HexaticTranslational<T>::prepare(const freud::locality::NeighborQuery* neighbor_query,
+                                      const vec3<float>* /*query_points*/, unsigned int n_query_points,
+                                      const freud::locality::NeighborList* /*nlist*/,
+                                      freud::locality::QueryArgs /*qargs*/)
+{
+    neighbor_query->getBox().enforce2D();
+    m_psi_array.prepare(n_query_points);
+}
+
 //! Compute the order parameter
 template<typename T>
 template<typename Func>
-void HexaticTranslational<T>::computeGeneral(Func func, const freud::locality::NeighborList* nlist,
-                                             const freud::locality::NeighborQuery* points,
-                                             freud::locality::QueryArgs qargs, bool normalize_by_k)
+void HexaticTranslational<T>::computePointGeneral(Func func, size_t query_point_idx,
+                                                  const freud::locality::PointBonds& point_bonds,
+                                                  bool normalize_by_k)
 {
-    const auto box = points->getBox();
-    box.enforce2D();
-
-    const unsigned int Np = points->getNPoints();
-
-    m_psi_array.prepare(Np);
-
-    freud::locality::loopOverNeighborsIterator(
-        points, points->getPoints(), Np, qargs, nlist,
-        [=](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
-            float total_weight(0);
-            const vec3<float> ref((*points)[i]);
+    float total_weight(0);
+    std::complex<float> psi(0);
+    for (size_t bond = 0; bond < point_bonds.bonds.size(); ++bond)
+    {
+        const float weight(m_weighted ? point_bonds.bonds[bond].weight : 1.0);
 
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
-            {
-                // Compute vector from query_point to point
-                const vec3<float> delta = box.wrap((*points)[nb.point_idx] - ref);
-                const float weight(m_weighted ? nb.weight : 1.0);
-
-                // Compute psi for this vector
-                m_psi_array[i] += weight * func(delta);
-                total_weight += weight;
-            }
-            if (normalize_by_k)
-            {
-                m_psi_array[i] /= std::complex<float>(m_k);
-            }
-            else
-            {
-                m_psi_array[i] /= std::complex<float>(total_weight);
-            }
-        });
+        // Compute psi for the vector from query_point to point
+        psi += weight * func(point_bonds.deltas[bond]);
+        total_weight += weight;
+    }
+    if (normalize_by_k)
+    {
+        m_psi_array[query_point_idx] = psi / std::complex<float>(m_k);
+    }
+    else
+    {
+        m_psi_array[query_point_idx] = psi / std::complex<float>(total_weight);
+    }
 }
 
 Hexatic::Hexatic(unsigned int k, bool weighted) : HexaticTranslational<unsigned int>(k, weighted) {}
@@ -51,12 +47,18 @@ Hexatic::Hexatic(unsigned int k, bool weighted) : HexaticTranslational<unsigned
 void Hexatic::compute(const freud::locality::NeighborList* nlist,
                       const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
-    computeGeneral(
+    freud::locality::loopOverBondKernels({this}, points, points->getPoints(), points->getNPoints(), nlist,
+                                         qargs);
+}
+
+void Hexatic::computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds)
+{
+    computePointGeneral(
         [this](const vec3<float>& delta) {
             const float theta_ij = std::atan2(delta.y, delta.x);
             return std::exp(std::complex<float>(0, static_cast<float>(m_k) * theta_ij));
         },
-        nlist, points, qargs, false);
+        query_point_idx, point_bonds, false);
 }
 
 Translational::Translational(float k, bool weighted) : HexaticTranslational<float>(k, weighted) {}
@@ -64,8 +66,14 @@ Translational::Translational(float k, bool weighted) : HexaticTranslational<floa
 void Translational::compute(const freud::locality::NeighborList* nlist,
                             const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
-    computeGeneral([](const vec3<float>& delta) { return std::complex<float>(delta.x, delta.y); }, nlist,
-                   points, qargs, true);
+    freud::locality::loopOverBondKernels({this}, points, points->getPoints(), points->getNPoints(), nlist,
+                                         qargs);
+}
+
+void Translational::computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds)
+{
+    computePointGeneral([](const vec3<float>& delta) { return std::complex<float>(delta.x, delta.y); },
+                        query_point_idx, point_bonds, true);
 }
 
 }; }; // namespace freud::order
@@ -6,6 +6,7 @@
 
 #include <complex>
 
+#include "BondKernel.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborComputeFunctional.h"
@@ -20,16 +21,18 @@
 namespace freud { namespace order {
 
 //! Parent class for Hexatic and Translational
-/*!
+/*! The order parameter of each point is computed from its bonds as a
+ *  locality::BondKernel, so it can be computed in the same pass over the bonds
+ *  as other bond order parameters.
  */
-template<typename T> class HexaticTranslational
+template<typename T> class HexaticTranslational : public locality::BondKernel
 {
 public:
     //! Constructor
     explicit HexaticTranslational(T k, bool weighted = false) : m_k(k), m_weighted(weighted) {}
 
     //! Destructor
-    virtual ~HexaticTranslational() = default;
+    ~HexaticTranslational() override = default;
 
     T getK() const
     {
@@ -47,12 +50,16 @@ public:
         return m_psi_array;
     }
 
+    //! Prepare the order parameter array for the points
+    void prepare(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                 unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                 freud::locality::QueryArgs qargs) override;
+
 protected:
-    //! Compute the order parameter
+    //! Compute the order parameter of a point from its bonds
     template<typename Func>
-    void computeGeneral(Func func, const freud::locality::NeighborList* nlist,
-                        const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
-                        bool normalize_by_k);
+    void computePointGeneral(Func func, size_t query_point_idx,
+                             const freud::locality::PointBonds& point_bonds, bool normalize_by_k);
 
     const T m_k; //!< The symmetry order for Hexatic, or normalization for Translational
     const bool
@@ -75,6 +82,9 @@ public:
     //! Compute the hexatic order parameter
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
+
+    //! Compute the order parameter of a point from its bonds
+    void computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds) override;
 };
 
 //! Compute the translational order parameter for a set of points
@@ -92,6 +102,9 @@ public:
     //! Compute the translational order parameter
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
+
+    //! Compute the order parameter of a point from its bonds
+    void computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds) override;
 };
 
 }; }; // end namespace freud::order
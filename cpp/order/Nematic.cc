@@ -1,9 +1,12 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 
 #include "Nematic.h"
+#include "SmallTensor.h"
 #include "diagonalize.h"
 
 /*! \file Nematic.h
@@ -45,52 +48,55 @@ vec3<float> Nematic::getU() const
     return m_u;
 }
 
-void Nematic::compute(quat<float>* orientations, unsigned int n)
+void Nematic::compute(quat<float>* orientations, unsigned int n, bool compute_particle_tensor)
 {
     m_n = n;
-    m_particle_tensor.prepare({m_n, 3, 3});
+    m_particle_tensor.prepare({compute_particle_tensor ? m_n : 0, 3, 3});
     m_nematic_tensor_local.reset();
 
     // calculate per-particle tensor
-    util::forLoopWrapper(0, n, [=](size_t begin, size_t end) {
+    util::forLoopWrapper(0, n, [&](size_t begin, size_t end) {
+        util::SmallTensor<float, 3, 3> Q_sum;
         for (size_t i = begin; i < end; ++i)
         {
             // get the director of the particle
             quat<float> q = orientations[i];
             vec3<float> u_i = rotate(q, m_u);
+            const std::array<float, 3> u = {u_i.x, u_i.y, u_i.z};
 
-            util::ManagedArray<float> Q_ab({3, 3});
-
-            Q_ab(0, 0) = 1.5f * u_i.x * u_i.x - 0.5f;
-            Q_ab(0, 1) = 1.5f * u_i.x * u_i.y;
-            Q_ab(0, 2) = 1.5f * u_i.x * u_i.z;
-            Q_ab(1, 0) = 1.5f * u_i.y * u_i.x;
-            Q_ab(1, 1) = 1.5f * u_i.y * u_i.y - 0.5f;
-            Q_ab(1, 2) = 1.5f * u_i.y * u_i.z;
-            Q_ab(2, 0) = 1.5f * u_i.z * u_i.x;
-            Q_ab(2, 1) = 1.5f * u_i.z * u_i.y;
-            Q_ab(2, 2) = 1.5f * u_i.z * u_i.z - 0.5f;
-
-            // Set the values. The nematic tensor is reduced later.
+            util::SmallTensor<float, 3, 3> Q_ab;
             for (unsigned int j = 0; j < 3; j++)
             {
                 for (unsigned int k = 0; k < 3; k++)
                 {
-                    m_particle_tensor(i, j, k) += Q_ab(j, k);
-                    m_nematic_tensor_local.local()(j, k) += Q_ab(j, k);
+                    Q_ab(j, k) = 1.5f * u[j] * u[k] - ((j == k) ? 0.5f : 0.0f);
                 }
             }
+
+            // Set the values. The nematic tensor is reduced later.
+            if (compute_particle_tensor)
+            {
+                std::copy(Q_ab.begin(), Q_ab.end(), m_particle_tensor.get() + i * Q_ab.size);
+            }
+            Q_sum += Q_ab;
+        }
+
+        util::ManagedArray<float>& local_tensor = m_nematic_tensor_local.local();
+        for (unsigned int j = 0; j < Q_sum.size; j++)
+        {
+            local_tensor[j] += Q_sum[j];
         }
     });
 
-    // Now calculate the sum of Q_ab's
-    m_nematic_tensor.prepare({3, 3});
-    m_nematic_tensor_local.reduceInto(m_nematic_tensor);
+    // Now calculate the sum of Q_ab's. The thread local tensors are reset
+    // before the next compute, so they can be summed in place.
+    const util::ManagedArray<float>& tensor_sum = m_nematic_tensor_local.reduceInPlace();
 
     // Normalize by the number of particles
+    m_nematic_tensor.prepare({3, 3});
     for (unsigned int i = 0; i < m_nematic_tensor.size(); ++i)
     {
-        m_nematic_tensor[i] /= static_cast<float>(m_n);
+        m_nematic_tensor[i] = tensor_sum[i] / static_cast<float>(m_n);
     }
 
     // the order parameter is the eigenvector belonging to the largest eigenvalue
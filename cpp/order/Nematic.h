@@ -29,7 +29,12 @@ public:
     virtual ~Nematic() = default;
 
     //! Compute the nematic order parameter
-    void compute(quat<float>* orientations, unsigned int n);
+    /*! \param orientations The orientations of the particles.
+     *  \param n The number of particles.
+     *  \param compute_particle_tensor Whether to store the tensor of each
+     *         particle. If false, the per-particle tensor is left empty.
+     */
+    void compute(quat<float>* orientations, unsigned int n, bool compute_particle_tensor = true);
 
     //! Get the value of the last computed nematic order parameter
     float getNematicOrderParameter() const;
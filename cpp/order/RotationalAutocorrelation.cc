@@ -3,8 +3,12 @@
 
 #include "RotationalAutocorrelation.h"
 
+#include "FFT.h"
+#include "ThreadStorage.h"
 #include "utils.h"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 /*! \file RotationalAutocorrelation.cc
     \brief Implements the RotationalAutocorrelation class.
@@ -12,42 +16,69 @@
 
 namespace freud { namespace order {
 
-// This function wraps exponentiation for complex numbers to avoid
-// the case where pow((0,0), 0) returns (nan, nan). Additionally, it
-// serves as a micro-optimization since std::pow can be slow. We can take the
-// exponent to be an unsigned int since all the sums in the hyperspherical
-// harmonic below guarantee this.
-inline std::complex<float> cpow(std::complex<float> base, unsigned int p)
+RotationalAutocorrelation::RotationalAutocorrelation(unsigned int l) : m_l(l)
 {
-    if (p == 0)
+    // For efficiency, we precompute all required factorials and the
+    // coefficients of the terms of every harmonic, each of which is the
+    // inverse of a product of four factorials.
+    m_factorials.resize(m_l + 1);
+    m_factorials[0] = 1;
+    for (unsigned int i = 1; i <= m_l; i++)
     {
-        return {1, 0};
+        m_factorials[i] = i * m_factorials[i - 1];
     }
-    std::complex<float> val(base);
-    for (unsigned int i = 1; i < p; i++)
+
+    m_term_offsets.push_back(0);
+    for (unsigned int m1 = 0; m1 <= m_l; m1++)
     {
-        val *= base;
+        for (unsigned int m2 = 0; m2 <= m_l; m2++)
+        {
+            for (unsigned int k = (m1 + m2 < m_l ? 0 : m1 + m2 - m_l); k <= std::min(m1, m2); k++)
+            {
+                m_coefficients.push_back(static_cast<float>(
+                    1.0
+                    / (m_factorials[k] * m_factorials[m_l + k - m1 - m2] * m_factorials[m1 - k]
+                       * m_factorials[m2 - k])));
+            }
+            m_term_offsets.push_back(static_cast<unsigned int>(m_coefficients.size()));
+        }
     }
-    return val;
 }
 
-inline std::complex<float> RotationalAutocorrelation::hypersphere_harmonic(const std::complex<float> xi,
-                                                                           std::complex<float> zeta,
+void RotationalAutocorrelation::computePowers(std::complex<float> xi, std::complex<float> zeta,
+                                              std::complex<float>* powers) const
+{
+    // Powers are built by repeated multiplication, which also avoids the case
+    // where pow((0,0), 0) returns (nan, nan).
+    const std::complex<float> bases[] = {std::conj(xi), zeta, std::conj(zeta), -xi};
+    for (unsigned int j = 0; j < 4; j++)
+    {
+        std::complex<float>* power = powers + j * (m_l + 1);
+        power[0] = std::complex<float>(1, 0);
+        for (unsigned int p = 1; p <= m_l; p++)
+        {
+            power[p] = power[p - 1] * bases[j];
+        }
+    }
+}
+
+inline std::complex<float> RotationalAutocorrelation::hypersphere_harmonic(const std::complex<float>* powers,
                                                                            const unsigned int m1,
-                                                                           const unsigned int m2)
+                                                                           const unsigned int m2) const
 {
-    const std::complex<float> xi_conj = std::conj(xi);
-    const std::complex<float> zeta_conj = std::conj(zeta);
+    const std::complex<float>* xi_conj = powers;
+    const std::complex<float>* zeta = powers + (m_l + 1);
+    const std::complex<float>* zeta_conj = powers + 2 * (m_l + 1);
+    const std::complex<float>* neg_xi = powers + 3 * (m_l + 1);
 
     // Doing a summation over non-negative exponents, which requires the additional inner conditional.
+    const unsigned int harmonic = m1 * (m_l + 1) + m2;
     std::complex<float> sum_tracker(0, 0);
-    for (unsigned int k = (m1 + m2 < m_l ? 0 : m1 + m2 - m_l); k <= std::min(m1, m2); k++)
+    unsigned int k = (m1 + m2 < m_l ? 0 : m1 + m2 - m_l);
+    for (unsigned int term = m_term_offsets[harmonic]; term < m_term_offsets[harmonic + 1]; ++term, ++k)
     {
-        float fact_product = static_cast<float>(m_factorials[k])
-            * static_cast<float>(m_factorials[m_l + k - m1 - m2]) * static_cast<float>(m_factorials[m1 - k])
-            * static_cast<float>(m_factorials[m2 - k]);
-        sum_tracker += cpow(xi_conj, k) * cpow(zeta, m2 - k) * cpow(zeta_conj, m1 - k)
-            * cpow(-xi, m_l + k - m1 - m2) / fact_product;
+        sum_tracker += m_coefficients[term] * xi_conj[k] * zeta[m2 - k] * zeta_conj[m1 - k]
+            * neg_xi[m_l + k - m1 - m2];
     }
     return sum_tracker;
 }
@@ -58,46 +89,52 @@ void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, con
     m_RA_array.prepare(N);
 
     // Precompute the hyperspherical harmonics for the unit quaternion. The
-    // default quaternion constructor gives a unit quaternion. We will assume
-    // the same iteration order here as in the loop below to save ourselves
-    // from having to use a more expensive process (i.e. a map).
-    std::complex<float> xi = std::complex<float>(0, 0);
-    std::complex<float> zeta = std::complex<float>(0, 1);
-    std::vector<std::complex<float>> unit_harmonics;
-    std::vector<std::vector<float>> prefactors(m_l + 1, std::vector<float>(m_l + 1, float(0)));
+    // default quaternion constructor gives a unit quaternion. Only the
+    // harmonics with m1 + m2 = l are nonzero for the unit quaternion, so the
+    // autocorrelation of each particle is a weighted sum of l + 1 harmonics.
+    std::vector<std::complex<float>> unit_powers(4 * (m_l + 1));
+    computePowers(std::complex<float>(0, 0), std::complex<float>(0, 1), unit_powers.data());
+    struct WeightedHarmonic
+    {
+        unsigned int m1;
+        unsigned int m2;
+        std::complex<float> weight;
+    };
+    std::vector<WeightedHarmonic> weighted_harmonics;
     for (unsigned int a = 0; a <= m_l; a++)
     {
         for (unsigned int b = 0; b <= m_l; b++)
         {
-            unit_harmonics.push_back(std::conj(hypersphere_harmonic(xi, zeta, a, b)));
-            prefactors[a][b] = static_cast<float>(m_factorials[a] * m_factorials[m_l - a] * m_factorials[b]
-                                                  * m_factorials[m_l - b])
-                / (static_cast<float>(m_l + 1));
+            const std::complex<float> unit_harmonic
+                = std::conj(hypersphere_harmonic(unit_powers.data(), a, b));
+            if (unit_harmonic != std::complex<float>(0, 0))
+            {
+                const auto prefactor = static_cast<float>(m_factorials[a] * m_factorials[m_l - a]
+                                                          * m_factorials[b] * m_factorials[m_l - b]
+                                                          / static_cast<double>(m_l + 1));
+                weighted_harmonics.push_back({a, b, prefactor * unit_harmonic});
+            }
         }
     }
 
     // Parallel loop is over orientations (technically (ref_or, or) pairs).
-    util::forLoopWrapper(0, N, [=](size_t begin, size_t end) {
+    util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+        std::vector<std::complex<float>> powers(4 * (m_l + 1));
         for (size_t i = begin; i < end; ++i)
         {
             // Transform the orientation quaternions into Xi/Zeta coordinates;
             quat<float> qq_1 = conj(ref_orientations[i]) * orientations[i];
             std::complex<float> xi = std::complex<float>(qq_1.v.x, qq_1.v.y);
             std::complex<float> zeta = std::complex<float>(qq_1.v.z, qq_1.s);
+            computePowers(xi, zeta, powers.data());
 
             // Loop through the valid quantum numbers.
-            m_RA_array[i] = std::complex<float>(0, 0);
-            unsigned int uh_index = 0;
-            for (unsigned int a = 0; a <= m_l; a++)
+            std::complex<float> RA(0, 0);
+            for (const WeightedHarmonic& h : weighted_harmonics)
             {
-                for (unsigned int b = 0; b <= m_l; b++)
-                {
-                    std::complex<float> combined_value
-                        = unit_harmonics[uh_index] * hypersphere_harmonic(xi, zeta, a, b);
-                    m_RA_array[i] += prefactors[a][b] * combined_value;
-                    uh_index += 1;
-                }
+                RA += h.weight * hypersphere_harmonic(powers.data(), h.m1, h.m2);
             }
+            m_RA_array[i] = RA;
         }
     });
 
@@ -109,4 +146,81 @@ void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, con
     m_Ft = RA_sum / static_cast<float>(N);
 };
 
+void RotationalAutocorrelation::computeTrajectory(const quat<float>* orientations, unsigned int n_frames,
+                                                  unsigned int N)
+{
+    if (n_frames == 0)
+    {
+        throw std::invalid_argument("RotationalAutocorrelation requires at least one frame.");
+    }
+
+    // Zero padding to at least 2 * n_frames turns the circular autocorrelation
+    // computed by the FFT into the linear autocorrelation.
+    size_t fft_size = 1;
+    while (fft_size < 2 * static_cast<size_t>(n_frames))
+    {
+        fft_size *= 2;
+    }
+    const util::FFTPlan plan(fft_size);
+
+    std::vector<float> norms;
+    for (unsigned int a = 0; a <= m_l; a++)
+    {
+        for (unsigned int b = 0; b <= m_l; b++)
+        {
+            norms.push_back(static_cast<float>(std::sqrt(m_factorials[a] * m_factorials[m_l - a]
+                                                         * m_factorials[b] * m_factorials[m_l - b])));
+        }
+    }
+
+    util::ThreadStorage<double> local_spectra(fft_size);
+    util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+        auto& spectrum = local_spectra.local();
+        const size_t num_powers = 4 * (m_l + 1);
+        std::vector<std::complex<float>> powers(n_frames * num_powers);
+        std::vector<std::complex<double>> sequence(fft_size);
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (unsigned int t = 0; t < n_frames; ++t)
+            {
+                const quat<float>& q = orientations[static_cast<size_t>(t) * N + i];
+                computePowers(std::complex<float>(q.v.x, q.v.y), std::complex<float>(q.v.z, q.s),
+                              powers.data() + t * num_powers);
+            }
+
+            unsigned int harmonic = 0;
+            for (unsigned int a = 0; a <= m_l; a++)
+            {
+                for (unsigned int b = 0; b <= m_l; b++)
+                {
+                    std::fill(sequence.begin(), sequence.end(), 0);
+                    for (unsigned int t = 0; t < n_frames; ++t)
+                    {
+                        sequence[t] = norms[harmonic]
+                            * hypersphere_harmonic(powers.data() + t * num_powers, a, b);
+                    }
+                    plan.forward(sequence.data());
+                    for (size_t k = 0; k < fft_size; ++k)
+                    {
+                        spectrum[k] += std::norm(sequence[k]);
+                    }
+                    harmonic += 1;
+                }
+            }
+        }
+    });
+
+    util::ManagedArray<double> spectrum(fft_size);
+    local_spectra.reduceInto(spectrum);
+    std::vector<std::complex<double>> correlation(spectrum.get(), spectrum.get() + fft_size);
+    plan.inverse(correlation.data());
+
+    m_autocorrelation.prepare(n_frames);
+    const double scale = 1.0 / (static_cast<double>(fft_size) * (m_l + 1) * N);
+    for (unsigned int m = 0; m < n_frames; ++m)
+    {
+        m_autocorrelation[m] = static_cast<float>(correlation[m].real() * scale / (n_frames - m));
+    }
+}
+
 }; }; // end namespace freud::order
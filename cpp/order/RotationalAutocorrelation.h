@@ -5,6 +5,7 @@
 #define ROTATIONAL_AUTOCORRELATION_H
 
 #include <complex>
+#include <vector>
 
 #include "ManagedArray.h"
 #include "VectorMath.h"
@@ -50,17 +51,7 @@ public:
     //! Constructor
     /*! \param l The order of the spherical harmonic.
      */
-    explicit RotationalAutocorrelation(unsigned int l) : m_l(l)
-    {
-        // For efficiency, we precompute all required factorials for use during
-        // the per-particle computation.
-        m_factorials.prepare(m_l + 1);
-        m_factorials[0] = 1;
-        for (unsigned int i = 1; i <= m_l; i++)
-        {
-            m_factorials[i] = i * m_factorials[i - 1];
-        }
-    }
+    explicit RotationalAutocorrelation(unsigned int l);
 
     //! Destructor
     ~RotationalAutocorrelation() = default;
@@ -83,6 +74,12 @@ public:
         return m_Ft;
     }
 
+    //! Get a reference to the rotational autocorrelation at each lag of the last computed trajectory.
+    const util::ManagedArray<float>& getAutocorrelation() const
+    {
+        return m_autocorrelation;
+    }
+
     //! Compute the rotational autocorrelation.
     /*! \param ref_orientations Quaternions in initial frame.
      *  \param orientations Quaternions in current frame.
@@ -98,11 +95,37 @@ public:
      */
     void compute(const quat<float>* ref_orientations, const quat<float>* orientations, unsigned int N);
 
+    //! Compute the rotational autocorrelation at every lag of a trajectory.
+    /*! \param orientations Quaternions of shape (n_frames, N) in row-major order.
+     *  \param n_frames The number of frames.
+     *  \param N The number of orientations in each frame.
+     *
+     *  The autocorrelation of a pair of orientations is the normalized trace
+     *  of the Wigner D-matrix of their relative rotation, which is the inner
+     *  product of the D-matrices of the two orientations. The elements of
+     *  these matrices are the hyperspherical harmonics scaled by
+     *  sqrt(a! (l - a)! b! (l - b)!), so the harmonics of every orientation
+     *  are computed once, and the sums over all time origins at every lag
+     *  are the autocorrelations of the sequences of harmonics of each
+     *  particle. These are evaluated with fast Fourier transforms as in
+     *  msd::MSD, and since only their sum over particles and harmonics is
+     *  needed, the power spectra are summed in parallel before a single
+     *  inverse transform. The value at lag m is averaged over all particles
+     *  and all n_frames - m time origins.
+     */
+    void computeTrajectory(const quat<float>* orientations, unsigned int n_frames, unsigned int N);
+
 private:
-    //! Compute a hyperspherical harmonic.
+    //! Compute the powers of the coordinates of an orientation that appear in the hyperspherical harmonics.
     /*! \param xi The first complex number coordinate.
      *  \param zeta The second complex number coordinate.
-     *  \param l The azimuthal quantum number.
+     *  \param powers Output array of the powers 0 to l of conj(xi), zeta,
+     *                conj(zeta), and -xi, each stored as l + 1 consecutive values.
+     */
+    void computePowers(std::complex<float> xi, std::complex<float> zeta, std::complex<float>* powers) const;
+
+    //! Compute a hyperspherical harmonic.
+    /*! \param powers The powers of the coordinates (xi, zeta) from computePowers.
      *  \param m1 The first magnetic quantum number.
      *  \param m2 The second magnetic quantum number.
      *  \return The value of the hyperspherical harmonic (l, m1, m2) at (xi, zeta).
@@ -110,18 +133,22 @@ private:
      *  The hyperspherical harmonic function is a generalization of spherical
      *  harmonics from the 2-sphere to the 3-sphere. For details, see Harmonic
      *  functions and matrix elements for hyperspherical quantum field models
-     *  (https://doi.org/10.1063/1.526210). The function needs to be a class
-     *  method to access the cached factorial values for the class's value of
-     *  m_l.
+     *  (https://doi.org/10.1063/1.526210). Each harmonic is a sum of products
+     *  of powers of the coordinates, whose coefficients, the inverse products
+     *  of factorials, are tabulated for the class's value of m_l in the
+     *  constructor, so evaluating it only multiplies table entries.
      */
-    std::complex<float> hypersphere_harmonic(const std::complex<float> xi, std::complex<float> zeta,
-                                             const unsigned int m1, const unsigned int m2);
+    std::complex<float> hypersphere_harmonic(const std::complex<float>* powers, unsigned int m1,
+                                             unsigned int m2) const;
 
     unsigned int m_l; //!< Order of the hyperspherical harmonic.
     float m_Ft {0};   //!< Real value of calculated RA function.
 
     util::ManagedArray<std::complex<float>> m_RA_array; //!< Array of RA values per particle
-    util::ManagedArray<unsigned int> m_factorials;      //!< Array of cached factorials
+    util::ManagedArray<float> m_autocorrelation;        //!< RA at each lag of a trajectory
+    std::vector<double> m_factorials;                   //!< Factorials of 0 to m_l
+    std::vector<float> m_coefficients;                  //!< Coefficients of the terms of all harmonics
+    std::vector<unsigned int> m_term_offsets;           //!< Index of the first term of each harmonic
 };
 
 }; }; // end namespace freud::order
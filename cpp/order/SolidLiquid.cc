@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <memory>
 #include <stdexcept>
 
 #include "NeighborComputeFunctional.h"
@@ -8,9 +9,43 @@
 
 namespace freud { namespace order {
 
+namespace {
+
+//! Number of partial sums of componentDot, which are vectorized together
+constexpr unsigned int DOT_PARTIAL_SUMS = 8;
+
+//! Compute the dot product of two arrays of floats
+/*! The products are summed into independent partial sums, so the compiler
+ *  can vectorize the sum without reordering floating point additions.
+ */
+inline float componentDot(const float* a, const float* b, unsigned int n)
+{
+    float partial_sums[DOT_PARTIAL_SUMS] = {};
+    unsigned int k = 0;
+    for (; k + DOT_PARTIAL_SUMS <= n; k += DOT_PARTIAL_SUMS)
+    {
+        for (unsigned int lane = 0; lane < DOT_PARTIAL_SUMS; ++lane)
+        {
+            partial_sums[lane] += a[k + lane] * b[k + lane];
+        }
+    }
+    for (unsigned int lane = 0; k < n; ++k, ++lane)
+    {
+        partial_sums[lane] += a[k] * b[k];
+    }
+    float sum(0);
+    for (const float partial_sum : partial_sums)
+    {
+        sum += partial_sum;
+    }
+    return sum;
+}
+
+}; // end anonymous namespace
+
 SolidLiquid::SolidLiquid(unsigned int l, float q_threshold, unsigned int solid_threshold, bool normalize_q)
     : m_l(l), m_num_ms(2 * l + 1), m_q_threshold(q_threshold), m_solid_threshold(solid_threshold),
-      m_normalize_q(normalize_q), m_steinhardt(l), m_cluster()
+      m_normalize_q(normalize_q), m_steinhardt({l}), m_cluster()
 {
     if (m_q_threshold < 0.0)
     {
@@ -29,30 +64,34 @@ void SolidLiquid::compute(const freud::locality::NeighborList* nlist,
 
     // Compute Steinhardt using neighbor list (also gets ql for normalization)
     m_steinhardt.compute(&m_nlist, points, qargs);
-    const auto& qlm = m_steinhardt.getQlm();
+    const auto& qlm = m_steinhardt.getQlm()[0];
     const auto& ql = m_steinhardt.getQl();
 
-    // Compute (normalized) dot products for each bond in the neighbor list
+    // Compute (normalized) dot products for each bond in the neighbor list,
+    // counting the solid-like bonds of each query point as they are found.
+    // Only the real part of each dot product is used, which is the dot
+    // product of the rows of qlm viewed as contiguous arrays of floats.
     const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
     const unsigned int num_bonds(m_nlist.getNumBonds());
+    const unsigned int* neighbors = m_nlist.getNeighbors().get();
+    const auto* qlm_components = reinterpret_cast<const float*>(qlm.get());
+    const unsigned int num_components = 2 * m_num_ms;
     m_ql_ij.prepare(num_bonds);
+    m_number_of_connections.prepare(num_query_points);
 
     util::forLoopWrapper(
         0, num_query_points,
-        [=](size_t begin, size_t end) {
+        [&](size_t begin, size_t end) {
             for (unsigned int i = begin; i != end; ++i)
             {
+                const float* qlmi = qlm_components + static_cast<size_t>(i) * num_components;
+                unsigned int num_solid_bonds(0);
                 unsigned int bond(m_nlist.find_first_index(i));
-                for (; bond < num_bonds && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+                for (; bond < num_bonds && neighbors[2 * bond] == i; ++bond)
                 {
-                    const unsigned int j(m_nlist.getNeighbors()(bond, 1));
-
-                    // Accumulate the dot product over m of qlmi and qlmj vectors
-                    std::complex<float> bond_ql_ij = 0;
-                    for (unsigned int k = 0; k < m_num_ms; k++)
-                    {
-                        bond_ql_ij += qlm(i, k) * std::conj(qlm(j, k));
-                    }
+                    const unsigned int j(neighbors[2 * bond + 1]);
+                    float bond_ql_ij = componentDot(
+                        qlmi, qlm_components + static_cast<size_t>(j) * num_components, num_components);
 
                     // Optionally normalize dot products by points' ql values,
                     // accounting for the normalization of ql values
@@ -60,44 +99,37 @@ void SolidLiquid::compute(const freud::locality::NeighborList* nlist,
                     {
                         bond_ql_ij *= normalizationfactor / (ql[i] * ql[j]);
                     }
-                    m_ql_ij[bond] = bond_ql_ij.real();
+                    m_ql_ij[bond] = bond_ql_ij;
+                    if (bond_ql_ij > m_q_threshold)
+                    {
+                        ++num_solid_bonds;
+                    }
                 }
+                m_number_of_connections[i] = num_solid_bonds;
             }
         },
         true);
 
-    // Filter neighbors to contain only solid-like bonds
-    std::vector<bool> solid_filter(num_bonds);
-    for (unsigned int bond(0); bond < num_bonds; bond++)
-    {
-        solid_filter[bond] = (m_ql_ij[bond] > m_q_threshold);
-    }
-    freud::locality::NeighborList solid_nlist(m_nlist);
-    solid_nlist.filter(solid_filter.cbegin());
-
-    // Save the neighbor counts of solid-like bonds for each query point
-    m_number_of_connections.prepare(num_query_points);
-    for (unsigned int i(0); i < num_query_points; i++)
-    {
-        m_number_of_connections[i] = solid_nlist.getCounts()[i];
-    }
-
-    // Filter nlist to only bonds between solid-like particles
-    // (particles with more than solid_threshold solid-like bonds)
-    const unsigned int num_solid_bonds(solid_nlist.getNumBonds());
-    std::vector<bool> neighbor_count_filter(num_solid_bonds);
-    for (unsigned int bond(0); bond < num_solid_bonds; bond++)
-    {
-        const unsigned int i(solid_nlist.getNeighbors()(bond, 0));
-        const unsigned int j(solid_nlist.getNeighbors()(bond, 1));
-        neighbor_count_filter[bond] = (m_number_of_connections[i] >= m_solid_threshold
-                                       && m_number_of_connections[j] >= m_solid_threshold);
-    }
-    freud::locality::NeighborList solid_neighbor_nlist(solid_nlist);
-    solid_neighbor_nlist.filter(neighbor_count_filter.cbegin());
+    // Find clusters of solid-like particles (particles with more than
+    // solid_threshold solid-like bonds) joined by solid-like bonds. The bonds
+    // are merged directly from the neighbor list.
+    std::unique_ptr<bool[]> solid_bonds(new bool[num_bonds]);
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            solid_bonds[bond] = m_ql_ij[bond] > m_q_threshold
+                && m_number_of_connections[neighbors[2 * bond]] >= m_solid_threshold
+                && m_number_of_connections[neighbors[2 * bond + 1]] >= m_solid_threshold;
+        }
+    });
+    m_cluster.computeFiltered(points->getNPoints(), &m_nlist, solid_bonds.get());
+}
 
-    // Find clusters of solid-like particles
-    m_cluster.compute(points, &solid_neighbor_nlist, qargs);
+freud::locality::FrameTask SolidLiquid::makeFrameTask(unsigned int neighbors)
+{
+    return [this, neighbors](const freud::locality::FrameContext& context) {
+        compute(context.getNeighborList(neighbors), context.neighbor_query, freud::locality::QueryArgs());
+    };
 }
 
 }; }; // end namespace freud::order
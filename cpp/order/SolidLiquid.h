@@ -5,7 +5,6 @@
 #define SOLID_LIQUID_H
 
 #include <complex>
-#include <iterator>
 #include <vector>
 
 #include "Cluster.h"
@@ -88,20 +87,25 @@ public:
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
 
+    //! Get a task computing the order parameter from a neighbor node of an AnalysisGraph
+    freud::locality::FrameTask makeFrameTask(unsigned int neighbors);
+
     //! Returns largest cluster size.
     unsigned int getLargestClusterSize() const
     {
-        return m_cluster.getClusterKeys()[0].size();
+        const auto& keys = m_cluster.getClusterKeys();
+        return (keys.getNumSegments() > 0) ? keys.getSegmentSize(0) : 0;
     }
 
     //! Returns a vector containing the size of all clusters.
     std::vector<unsigned int> getClusterSizes() const
     {
-        auto keys = m_cluster.getClusterKeys();
-        std::vector<unsigned int> sizes;
-        sizes.reserve(keys.size());
-        std::transform(keys.begin(), keys.end(), std::back_inserter(sizes),
-                       [](auto& key) { return key.size(); });
+        const auto& keys = m_cluster.getClusterKeys();
+        std::vector<unsigned int> sizes(keys.getNumSegments());
+        for (size_t cluster = 0; cluster < sizes.size(); ++cluster)
+        {
+            sizes[cluster] = keys.getSegmentSize(cluster);
+        }
         return sizes;
     }
 
@@ -132,7 +136,7 @@ public:
     //! Get the last calculated qlm for each particle
     const util::ManagedArray<std::complex<float>>& getQlm() const
     {
-        return m_steinhardt.getQlm();
+        return m_steinhardt.getQlm()[0];
     }
 
     //! Return the ql_ij values.
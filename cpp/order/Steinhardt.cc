@@ -1,6 +1,9 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "Steinhardt.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -11,70 +14,151 @@
 
 namespace freud { namespace order {
 
-// Calculating Ylm using fsph module
-void Steinhardt::computeYlm(const float theta, const float phi, std::vector<std::complex<float>>& Ylm) const
+Steinhardt::Steinhardt(const std::vector<unsigned int>& l, bool average, bool wl, bool weighted,
+                       bool wl_normalize)
+    : m_l(l), m_average(average), m_wl(wl), m_weighted(weighted), m_wl_normalize(wl_normalize),
+      m_norm(l.size(), 0),
+      m_sph_evaluators(
+          util::SphericalHarmonicsEvaluator(l.empty() ? 0 : *std::max_element(l.begin(), l.end())))
 {
-    if (Ylm.size() != m_num_ms)
+    if (m_l.empty())
     {
-        Ylm.resize(m_num_ms);
+        throw std::invalid_argument("Steinhardt requires at least one spherical harmonic number l.");
     }
-
-    fsph::PointSPHEvaluator<float> sph_eval(m_l);
-
-    unsigned int m_index(0);
-    sph_eval.compute(theta, phi);
-
-    for (typename fsph::PointSPHEvaluator<float>::iterator iter(sph_eval.begin_l(m_l, 0, true));
-         iter != sph_eval.end(); ++iter)
+    for (const auto sph_l : m_l)
     {
-        // Manually add the Condon-Shortley phase, (-1)^m, to positive odd m
-        float phase = 1;
-        if (m_index <= m_l && m_index % 2 == 1)
+        m_num_ms.push_back(2 * sph_l + 1);
+        m_qlm_local.emplace_back(2 * sph_l + 1);
+        if (m_wl)
         {
-            phase = -1;
+            m_wigner3j.push_back(getWigner3jTable(sph_l));
         }
-
-        Ylm[m_index] = phase * (*iter);
-        ++m_index;
     }
+    m_qlmi.resize(m_l.size());
+    m_qlm.resize(m_l.size());
+    m_qlmiAve.resize(m_l.size());
 }
 
 void Steinhardt::reallocateArrays(unsigned int Np)
 {
     m_Np = Np;
-    m_qlmi.prepare({Np, m_num_ms});
-    m_qlm.prepare(m_num_ms);
-    m_qli.prepare(Np);
+    const size_t num_l = m_l.size();
+    for (size_t l_index = 0; l_index < num_l; ++l_index)
+    {
+        m_qlmi[l_index].prepare({Np, m_num_ms[l_index]});
+        m_qlm[l_index].prepare(m_num_ms[l_index]);
+        if (m_average)
+        {
+            m_qlmiAve[l_index].prepare({Np, m_num_ms[l_index]});
+        }
+    }
+    m_qli.prepareUninitialized({Np, num_l});
     if (m_average)
     {
-        m_qlmiAve.prepare({Np, m_num_ms});
-        m_qliAve.prepare(Np);
+        m_qliAve.prepare({Np, num_l});
     }
     if (m_wl)
     {
-        m_wli.prepare(Np);
+        m_wli.prepare({Np, num_l});
     }
 }
 
 void Steinhardt::compute(const freud::locality::NeighborList* nlist,
                          const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+{
+    freud::locality::loopOverBondKernels({this}, points, points->getPoints(), points->getNPoints(), nlist,
+                                         qargs);
+}
+
+freud::locality::FrameTask Steinhardt::makeFrameTask(unsigned int neighbors)
+{
+    return [this, neighbors](const freud::locality::FrameContext& context) {
+        compute(context.getNeighborList(neighbors), context.neighbor_query, freud::locality::QueryArgs());
+    };
+}
+
+void Steinhardt::prepare(const freud::locality::NeighborQuery* neighbor_query,
+                         const vec3<float>* /*query_points*/, unsigned int /*n_query_points*/,
+                         const freud::locality::NeighborList* /*nlist*/, freud::locality::QueryArgs /*qargs*/)
 {
     // Allocate and zero out arrays as necessary.
-    reallocateArrays(points->getNPoints());
+    reallocateArrays(neighbor_query->getNPoints());
+
+    // For consistency, this reset is done here regardless of whether the array
+    // is populated by computePoint or computeAve.
+    for (auto& qlm_local : m_qlm_local)
+    {
+        qlm_local.reset();
+    }
+}
+
+void Steinhardt::computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds)
+{
+    // Computes the base qlmi required for each specialized order parameter.
+    // The harmonics of all bonds of the point are evaluated together, with
+    // one evaluator per thread that keeps its buffers between points. A
+    // single evaluation up to the largest l provides the harmonics of every l.
+    const size_t i = query_point_idx;
+    const size_t num_l = m_l.size();
+    util::SphericalHarmonicsEvaluator& sph_eval = m_sph_evaluators.local();
+    sph_eval.clear();
+    float total_weight(0);
+    for (size_t bond = 0; bond < point_bonds.bonds.size(); ++bond)
+    {
+        const float weight(m_weighted ? point_bonds.bonds[bond].weight : float(1.0));
+        sph_eval.addBond(point_bonds.deltas[bond], weight);
+        total_weight += weight;
+    } // End loop going over neighbor bonds
+    {
+        FREUD_PROFILE_FINE_SCOPE("spherical harmonics");
+        sph_eval.evaluate();
+    }
 
-    // Computes the base qlmi required for each specialized order parameter
-    baseCompute(nlist, points, qargs);
+    for (size_t l_index = 0; l_index < num_l; ++l_index)
+    {
+        auto& qlmi = m_qlmi[l_index];
+        const unsigned int num_ms = m_num_ms[l_index];
+        sph_eval.accumulate(m_l[l_index], &qlmi({static_cast<unsigned int>(i), 0}));
 
+        // Normalize!
+        float qli(0);
+        for (unsigned int k = 0; k < num_ms; ++k)
+        {
+            // Cache the index for efficiency.
+            const unsigned int index = qlmi.getIndex({static_cast<unsigned int>(i), k});
+            qlmi[index] /= total_weight;
+            // Add the norm, which is the (complex) squared magnitude
+            qli += norm(qlmi[index]);
+            // This array gets populated by computeAve in the averaging case.
+            if (!m_average)
+            {
+                m_qlm_local[l_index].local()[k] += qlmi[index] / float(m_Np);
+            }
+        }
+        // Every element of m_qli is written here, so it is not zeroed when prepared.
+        m_qli({i, l_index}) = std::sqrt(qli * float(4.0 * M_PI / num_ms));
+    }
+}
+
+void Steinhardt::finish(const freud::locality::NeighborQuery* neighbor_query,
+                        const vec3<float>* /*query_points*/, unsigned int /*n_query_points*/,
+                        const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+{
     if (m_average)
     {
-        computeAve(nlist, points, qargs);
+        FREUD_PROFILE_SCOPE("neighbor averaging");
+        computeAve(nlist, neighbor_query, qargs);
     }
 
     // Reduce qlm
-    m_qlm_local.reduceInto(m_qlm);
+    for (size_t l_index = 0; l_index < m_l.size(); ++l_index)
+    {
+        m_qlm_local[l_index].reduceInto(m_qlm[l_index]);
+    }
 
     if (m_wl)
     {
+        FREUD_PROFILE_SCOPE("wigner 3j");
         if (m_average)
         {
             aggregatewl(m_wli, m_qlmiAve, m_qliAve);
@@ -84,71 +168,7 @@ void Steinhardt::compute(const freud::locality::NeighborList* nlist,
             aggregatewl(m_wli, m_qlmi, m_qli);
         }
     }
-    m_norm = normalizeSystem();
-}
-
-void Steinhardt::baseCompute(const freud::locality::NeighborList* nlist,
-                             const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
-{
-    const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
-    // For consistency, this reset is done here regardless of whether the array
-    // is populated in baseCompute or computeAve.
-    m_qlm_local.reset();
-    freud::locality::loopOverNeighborsIterator(
-        points, points->getPoints(), m_Np, qargs, nlist,
-        [=](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
-            float total_weight(0);
-            const vec3<float> ref((*points)[i]);
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
-            {
-                const vec3<float> delta = points->getBox().wrap((*points)[nb.point_idx] - ref);
-                const float weight(m_weighted ? nb.weight : float(1.0));
-
-                // phi is usually in range 0..2Pi, but
-                // it only appears in Ylm as exp(im\phi),
-                // so range -Pi..Pi will give same results.
-                float phi = std::atan2(delta.y, delta.x); // -Pi..Pi
-
-                // This value must be clamped in cases where the particles are
-                // aligned along z, otherwise due to floating point error we
-                // could get delta.z/nb.distance = -1-eps, which is outside the
-                // valid range of std::acos.
-                float theta = std::acos(util::clamp(delta.z / nb.distance, -1, 1)); // 0..Pi
-
-                // If the points are directly on top of each other,
-                // theta should be zero instead of nan.
-                if (nb.distance == float(0))
-                {
-                    theta = 0;
-                }
-
-                std::vector<std::complex<float>> Ylm(m_num_ms);
-                computeYlm(theta, phi, Ylm); // Fill up Ylm
-
-                for (unsigned int k = 0; k < m_num_ms; ++k)
-                {
-                    m_qlmi({static_cast<unsigned int>(i), k}) += weight * Ylm[k];
-                }
-                total_weight += weight;
-            } // End loop going over neighbor bonds
-
-            // Normalize!
-            for (unsigned int k = 0; k < m_num_ms; ++k)
-            {
-                // Cache the index for efficiency.
-                const unsigned int index = m_qlmi.getIndex({static_cast<unsigned int>(i), k});
-                m_qlmi[index] /= total_weight;
-                // Add the norm, which is the (complex) squared magnitude
-                m_qli[i] += norm(m_qlmi[index]);
-                // This array gets populated by computeAve in the averaging case.
-                if (!m_average)
-                {
-                    m_qlm_local.local()[k] += m_qlmi[index] / float(m_Np);
-                }
-            }
-            m_qli[i] *= normalizationfactor;
-            m_qli[i] = std::sqrt(m_qli[i]);
-        });
+    normalizeSystem();
 }
 
 void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
@@ -160,11 +180,11 @@ void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
         iter = points->query(points->getPoints(), points->getNPoints(), qargs);
     }
 
-    const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
+    const size_t num_l = m_l.size();
 
     freud::locality::loopOverNeighborsIterator(
         points, points->getPoints(), m_Np, qargs, nlist,
-        [=](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
+        [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
             unsigned int neighborcount(1);
             for (freud::locality::NeighborBond nb1 = ppiter->next(); !ppiter->end(); nb1 = ppiter->next())
             {
@@ -184,77 +204,100 @@ void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
                 for (freud::locality::NeighborBond nb2 = ns_neighbors_iter->next(); !ns_neighbors_iter->end();
                      nb2 = ns_neighbors_iter->next())
                 {
-                    for (unsigned int k = 0; k < m_num_ms; ++k)
+                    for (size_t l_index = 0; l_index < num_l; ++l_index)
                     {
-                        // Adding all the qlm of the neighbors. We use the
-                        // vector function signature for indexing into the
-                        // arrays for speed.
-                        m_qlmiAve({static_cast<unsigned int>(i), k}) += m_qlmi({nb2.point_idx, k});
+                        for (unsigned int k = 0; k < m_num_ms[l_index]; ++k)
+                        {
+                            // Adding all the qlm of the neighbors. We use the
+                            // vector function signature for indexing into the
+                            // arrays for speed.
+                            m_qlmiAve[l_index]({static_cast<unsigned int>(i), k})
+                                += m_qlmi[l_index]({nb2.point_idx, k});
+                        }
                     }
                     neighborcount++;
                 } // End loop over particle neighbor's bonds
             }     // End loop over particle's bonds
 
             // Normalize!
-            for (unsigned int k = 0; k < m_num_ms; ++k)
+            for (size_t l_index = 0; l_index < num_l; ++l_index)
             {
-                // Cache the index for efficiency.
-                const unsigned int index = m_qlmiAve.getIndex({static_cast<unsigned int>(i), k});
-                // Adding the qlm of the particle i itself
-                m_qlmiAve[index] += m_qlmi[index];
-                m_qlmiAve[index] /= static_cast<float>(neighborcount);
-                m_qlm_local.local()[k] += m_qlmiAve[index] / float(m_Np);
-                // Add the norm, which is the complex squared magnitude
-                m_qliAve[i] += norm(m_qlmiAve[index]);
+                auto& qlmiAve = m_qlmiAve[l_index];
+                const auto& qlmi = m_qlmi[l_index];
+                const unsigned int num_ms = m_num_ms[l_index];
+                const unsigned int qli_index = m_qliAve.getIndex({i, l_index});
+                for (unsigned int k = 0; k < num_ms; ++k)
+                {
+                    // Cache the index for efficiency.
+                    const unsigned int index = qlmiAve.getIndex({static_cast<unsigned int>(i), k});
+                    // Adding the qlm of the particle i itself
+                    qlmiAve[index] += qlmi[index];
+                    qlmiAve[index] /= static_cast<float>(neighborcount);
+                    m_qlm_local[l_index].local()[k] += qlmiAve[index] / float(m_Np);
+                    // Add the norm, which is the complex squared magnitude
+                    m_qliAve[qli_index] += norm(qlmiAve[index]);
+                }
+                m_qliAve[qli_index] *= float(4.0 * M_PI / num_ms);
+                m_qliAve[qli_index] = std::sqrt(m_qliAve[qli_index]);
             }
-            m_qliAve[i] *= normalizationfactor;
-            m_qliAve[i] = std::sqrt(m_qliAve[i]);
         });
 }
 
-float Steinhardt::normalizeSystem()
+void Steinhardt::normalizeSystem()
 {
-    float calc_norm(0);
-    const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
-    for (unsigned int k = 0; k < m_num_ms; ++k)
+    for (size_t l_index = 0; l_index < m_l.size(); ++l_index)
     {
-        // Add the norm, which is the complex squared magnitude
-        calc_norm += norm(m_qlm[k]);
-    }
-    const float ql_system_norm = std::sqrt(calc_norm * normalizationfactor);
+        const auto& qlm = m_qlm[l_index];
+        float calc_norm(0);
+        const auto normalizationfactor = float(4.0 * M_PI / m_num_ms[l_index]);
+        for (unsigned int k = 0; k < m_num_ms[l_index]; ++k)
+        {
+            // Add the norm, which is the complex squared magnitude
+            calc_norm += norm(qlm[k]);
+        }
+        const float ql_system_norm = std::sqrt(calc_norm * normalizationfactor);
 
-    if (m_wl)
-    {
-        auto wigner3jvalues = getWigner3j(m_l);
-        float wl_system_norm = reduceWigner3j(m_qlm.get(), m_l, wigner3jvalues);
+        if (m_wl)
+        {
+            float wl_system_norm = reduceWigner3j(qlm.get(), *m_wigner3j[l_index]);
 
-        // The normalization factor of wl is calculated using qli, which is
-        // equivalent to calculate the normalization factor from qlmi
-        if (m_wl_normalize)
+            // The normalization factor of wl is calculated using qli, which is
+            // equivalent to calculate the normalization factor from qlmi
+            if (m_wl_normalize)
+            {
+                const float wl_normalization = std::sqrt(normalizationfactor) / ql_system_norm;
+                wl_system_norm *= wl_normalization * wl_normalization * wl_normalization;
+            }
+            m_norm[l_index] = wl_system_norm;
+        }
+        else
         {
-            const float wl_normalization = std::sqrt(normalizationfactor) / ql_system_norm;
-            wl_system_norm *= wl_normalization * wl_normalization * wl_normalization;
+            m_norm[l_index] = ql_system_norm;
         }
-        return wl_system_norm;
     }
-
-    return ql_system_norm;
 }
 
 void Steinhardt::aggregatewl(util::ManagedArray<float>& target,
-                             const util::ManagedArray<std::complex<float>>& source,
+                             const std::vector<util::ManagedArray<std::complex<float>>>& source,
                              const util::ManagedArray<float>& normalization_source) const
 {
-    auto wigner3jvalues = getWigner3j(m_l);
-    const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
+    const size_t num_l = m_l.size();
     util::forLoopWrapper(0, m_Np, [&](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+        for (size_t l_index = 0; l_index < num_l; ++l_index)
         {
-            target[i] = reduceWigner3j(&(source({static_cast<unsigned int>(i), 0})), m_l, wigner3jvalues);
+            // Each entry of the table is applied to blocks of points at once.
+            const size_t num_ms = m_num_ms[l_index];
+            reduceWigner3j(source[l_index].get() + begin * num_ms, num_ms,
+                           target.get() + begin * num_l + l_index, num_l, end - begin, *m_wigner3j[l_index]);
             if (m_wl_normalize)
             {
-                const float normalization = std::sqrt(normalizationfactor) / normalization_source[i];
-                target[i] *= normalization * normalization * normalization;
+                const auto normalizationfactor = float(4.0 * M_PI / num_ms);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t index = i * num_l + l_index;
+                    const float normalization = std::sqrt(normalizationfactor) / normalization_source[index];
+                    target[index] *= normalization * normalization * normalization;
+                }
             }
         }
     });
@@ -5,15 +5,19 @@
 #define STEINHARDT_H
 
 #include <complex>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
 
+#include "AnalysisGraph.h"
+#include "BondKernel.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "SphericalHarmonics.h"
 #include "ThreadStorage.h"
 #include "VectorMath.h"
 #include "Wigner3j.h"
-#include "fsph/src/spherical_harmonics.hpp"
 
 /*! \file Steinhardt.h
     \brief Computes variants of Steinhardt order parameters.
@@ -48,28 +52,34 @@ namespace freud { namespace order {
  * If the flag wl_normalize is set, the third-order invariant wl order parameter
  * will be normalized.
  *
+ * The order parameters of several values of l are computed together from a
+ * single pass over the bonds, since the recurrences that evaluate the
+ * spherical harmonics of the largest l produce those of every smaller l. The
+ * per-particle outputs have shape (N, n_l), and the qlm have one array of
+ * shape (N, 2l + 1) for each l.
+ *
+ * The qlm of each particle are computed from its bonds as a
+ * locality::BondKernel, so they can be computed in the same pass over the
+ * bonds as other bond order parameters.
+ *
  * For more details see:
  * - PJ Steinhardt (1983) (DOI: 10.1103/PhysRevB.28.784)
  * - Wolfgang Lechner (2008) (DOI: 10.1063/Journal of Chemical Physics 129.114707)
  */
 
-class Steinhardt
+class Steinhardt : public locality::BondKernel
 {
 public:
     //! Steinhardt Class Constructor
     /*! Constructor for Steinhardt analysis class.
-     *  \param l Spherical harmonic number l.
-     *           Must be a positive number.
+     *  \param l Spherical harmonic numbers l to compute.
+     *           Must be a nonempty list.
      */
-    explicit Steinhardt(unsigned int l, bool average = false, bool wl = false, bool weighted = false,
-                        bool wl_normalize = false)
-        : m_l(l), m_num_ms(2 * l + 1), m_average(average), m_wl(wl), m_weighted(weighted),
-          m_wl_normalize(wl_normalize), m_qlm_local(2 * l + 1)
-
-    {}
+    explicit Steinhardt(const std::vector<unsigned int>& l, bool average = false, bool wl = false,
+                        bool weighted = false, bool wl_normalize = false);
 
     //! Empty destructor
-    ~Steinhardt() = default;
+    ~Steinhardt() override = default;
 
     //! Get the number of particles used in the last compute
     unsigned int getNP() const
@@ -97,14 +107,14 @@ public:
         return m_qli;
     }
 
-    //! Get the last calculated qlm for each particle
-    const util::ManagedArray<std::complex<float>>& getQlm() const
+    //! Get the last calculated qlm for each particle, with one array for each l
+    const std::vector<util::ManagedArray<std::complex<float>>>& getQlm() const
     {
         return m_qlmi;
     }
 
-    //! Get system-normalized order
-    float getOrder() const
+    //! Get system-normalized order for each l
+    const std::vector<float>& getOrder() const
     {
         return m_norm;
     }
@@ -137,44 +147,53 @@ public:
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
 
-    unsigned int getL() const
+    //! Get a task computing the order parameter from a neighbor node of an AnalysisGraph
+    freud::locality::FrameTask makeFrameTask(unsigned int neighbors);
+
+    //! Prepare the arrays for the points
+    void prepare(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                 unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                 freud::locality::QueryArgs qargs) override;
+
+    //! Calculate the qlm and ql of a point from its bonds
+    void computePoint(size_t query_point_idx, const freud::locality::PointBonds& point_bonds) override;
+
+    //! Calculate the averaged and third-order invariants and the system-wide order
+    void finish(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                freud::locality::QueryArgs qargs) override;
+
+    //! Get the spherical harmonic numbers l
+    const std::vector<unsigned int>& getL() const
     {
         return m_l;
     }
 
 private:
-    //! \internal
-    //! Spherical harmonics calculation for Ylm filling a
-    //  std::vector<std::complex<float> > with values for m = 0, 1, ..., l, -1, ..., -l
-    void computeYlm(const float theta, const float phi, std::vector<std::complex<float>>& Ylm) const;
-
-    template<typename T> std::shared_ptr<T> makeArray(size_t size);
-
     //! Reallocates only the necessary arrays when the number of particles changes
     // unsigned int Np number of particles
     void reallocateArrays(unsigned int Np);
 
-    //! Calculates qlms and the ql order parameter before any further modifications
-    void baseCompute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
-                     freud::locality::QueryArgs qargs);
-
     //! Calculates the neighbor average ql order parameter
     void computeAve(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                     freud::locality::QueryArgs qargs);
 
-    //! Compute the system-wide order by averaging over particles, then
+    //! Compute the system-wide order of each l by averaging over particles, then
     //  reducing over the m values to produce a single scalar.
-    float normalizeSystem();
+    void normalizeSystem();
 
     //! Sum over Wigner 3j coefficients to compute third-order invariants
     //  wl from second-order invariants ql
-    void aggregatewl(util::ManagedArray<float>& target, const util::ManagedArray<std::complex<float>>& source,
+    void aggregatewl(util::ManagedArray<float>& target,
+                     const std::vector<util::ManagedArray<std::complex<float>>>& source,
                      const util::ManagedArray<float>& normalization_source) const;
 
     // Member variables used for compute
-    unsigned int m_Np {0}; //!< Last number of points computed
-    unsigned int m_l;      //!< Spherical harmonic l value.
-    unsigned int m_num_ms; //!< The number of magnetic quantum numbers (2*m_l+1).
+    unsigned int m_Np {0};              //!< Last number of points computed
+    std::vector<unsigned int> m_l;      //!< Spherical harmonic l values.
+    std::vector<unsigned int> m_num_ms; //!< Number of magnetic quantum numbers (2*l+1).
+    std::vector<std::shared_ptr<const Wigner3jTable>>
+        m_wigner3j; //!< Wigner 3j coefficients of each l
 
     // Flags
     bool m_average;      //!< Whether to take a second shell average (default false)
@@ -182,17 +201,19 @@ private:
     bool m_weighted;     //!< Whether to use neighbor weights in computing qlmi (default false)
     bool m_wl_normalize; //!< Whether to normalize the third-order invariant wl (default false)
 
-    util::ManagedArray<std::complex<float>> m_qlmi;       //!< qlm for each particle i
-    util::ManagedArray<std::complex<float>> m_qlm;        //!< Normalized qlm(Ave) for the whole system
-    util::ThreadStorage<std::complex<float>> m_qlm_local; //!< Thread-specific m_qlm(Ave)
-    util::ManagedArray<float> m_qli;    //!< ql locally invariant order parameter for each particle i
-    util::ManagedArray<float> m_qliAve; //!< Averaged ql with 2nd neighbor shell for each particle i
-    util::ManagedArray<std::complex<float>>
-        m_qlmiAve; //!< Averaged qlm with 2nd neighbor shell for each particle i
-    util::ManagedArray<std::complex<float>> m_qlmAve; //!< Normalized qlmiAve for the whole system
-    float m_norm {0};                                 //!< System normalized order parameter
+    std::vector<util::ManagedArray<std::complex<float>>> m_qlmi; //!< qlm for each particle i and each l
+    std::vector<util::ManagedArray<std::complex<float>>>
+        m_qlm; //!< Normalized qlm(Ave) for the whole system for each l
+    std::vector<util::ThreadStorage<std::complex<float>>> m_qlm_local; //!< Thread-specific m_qlm(Ave)
+    util::ManagedArray<float> m_qli;    //!< ql locally invariant order parameter for each particle i and l
+    util::ManagedArray<float> m_qliAve; //!< Averaged ql with 2nd neighbor shell for each particle i and l
+    std::vector<util::ManagedArray<std::complex<float>>>
+        m_qlmiAve;             //!< Averaged qlm with 2nd neighbor shell for each particle i and l
+    std::vector<float> m_norm; //!< System normalized order parameter for each l
     util::ManagedArray<float>
-        m_wli; //!< wl order parameter for each particle i, also used for wl averaged data
+        m_wli; //!< wl order parameter for each particle i and l, also used for wl averaged data
+    tbb::enumerable_thread_specific<util::SphericalHarmonicsEvaluator>
+        m_sph_evaluators; //!< Thread local evaluators of the bond spherical harmonics
 };
 
 }; };  // end namespace freud::order
@@ -5,10 +5,11 @@
 #define WIGNER3J_H
 
 #include <complex>
+#include <memory>
 #include <vector>
 
 /*! \file Wigner3j.h
- *  \brief Stores and reduces over Wigner 3j coefficients for l from 0 to 20
+ *  \brief Computes and reduces over Wigner 3j coefficients of any l
  */
 
 namespace freud { namespace order {
@@ -17,49 +18,51 @@ namespace freud { namespace order {
 //  [0, 1, ..., l, -1, -2, ..., -l]
 int lmIndex(int l, int m);
 
+//! The nonzero Wigner 3j coefficients (l l l; m1 m2 m3) of a single l
+/*! Because all three columns of the symbol have the same l, permuting them
+ *  multiplies the coefficient by (-1)^(3l), while the product
+ *  q_m1 q_m2 q_m3 that it weights is unchanged. The terms of all
+ *  permutations of a triple are therefore combined into a single entry for
+ *  m1 <= m2 <= m3, whose coefficient is multiplied by the number of distinct
+ *  permutations. For odd l the permutations cancel and the table is empty.
+ *
+ *  The m values are stored as indices into arrays ordered like
+ *  [0, 1, ..., l, -1, -2, ..., -l].
+ */
+struct Wigner3jTable
+{
+    unsigned int l;                       //!< Spherical harmonic number l
+    std::vector<unsigned int> m1_indices; //!< Index of m1 of each entry
+    std::vector<unsigned int> m2_indices; //!< Index of m2 of each entry
+    std::vector<unsigned int> m3_indices; //!< Index of m3 of each entry
+    std::vector<float> coefficients;      //!< Coefficient of each entry, including permutations
+};
+
+//! Get the table of Wigner 3j coefficients of l
+/*! Tables are computed from the Racah formula on first use and cached, so
+ *  all computes share one table for each l. This function is thread safe.
+ */
+std::shared_ptr<const Wigner3jTable> getWigner3jTable(unsigned int l);
+
 //! Reduce an array using Wigner 3j coefficients to construct a
 //  third-order rotational invariant quantity.
 //  source array must be indexed by m, like [0, 1, ..., l, -1, -2, ..., -l].
-float reduceWigner3j(const std::complex<float>* source, unsigned int l_, const std::vector<double>& wigner3j);
-
-std::vector<double> getWigner3j(unsigned int l);
-// All Wigner 3j coefficients created using sympy
-/*
-
-from sympy.physics.wigner import wigner_3j
-import numpy as np
-import json
+float reduceWigner3j(const std::complex<float>* source, const Wigner3jTable& table);
 
-wigner = {}
-for l in range(21):
-    wigner[l] = []
-    for m1 in range(-l, l+1):
-        for m2 in range(max(-l-m1, -l), min(l-m1, l)+1):
-            m3 = -m1-m2
-            wigner[l].append(float(wigner_3j(l, l, l, m1, m2, m3)))
-
-with open('wigner3j.json', 'w') as jsonfile:
-    json.dump(wigner, jsonfile, sort_keys=True, indent=4)
-
-WIGNER_COEFF = """
-    case {l}:
-    {{
-        return {{
-{values}
-        }};
-    }}"""
-
-def format_values(values, per_line=4, spaces=12):
-    lines = []
-    for line in range(int(np.ceil(len(values)/per_line))):
-        lines.append(', '.join(
-            map(str, values[line*per_line:min(len(values), (line+1)*per_line)])))
-    return ' '*spaces + (',\n' + ' '*spaces).join(lines)
-
-for l in sorted(wigner.keys()):
-    print(WIGNER_COEFF.format(l=l, values=format_values(wigner[l])))
-
-*/
+//! Reduce the arrays of many points using Wigner 3j coefficients
+/*! The arrays of a block of points are transposed so that each entry of the
+ *  table is applied to all points of the block in a single loop, which the
+ *  compiler vectorizes across points.
+ *
+ *  \param source Array of the first point, indexed like reduceWigner3j.
+ *  \param source_stride Distance between the arrays of consecutive points.
+ *  \param target Output of the first point.
+ *  \param target_stride Distance between the outputs of consecutive points.
+ *  \param n Number of points.
+ *  \param table Wigner 3j coefficients.
+ */
+void reduceWigner3j(const std::complex<float>* source, size_t source_stride, float* target,
+                    size_t target_stride, size_t n, const Wigner3jTable& table);
 
 }; };  // end namespace freud::order
 #endif // WIGNER3J_H
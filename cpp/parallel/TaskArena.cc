@@ -0,0 +1,172 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <atomic>
+#include <stdexcept>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#if TBB_VERSION_MAJOR >= 2021
+#include <tbb/info.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "TaskArena.h"
+#include "utils.h"
+
+/*! \file TaskArena.cc
+    \brief Task arenas bound to NUMA nodes in which freud computes can run.
+*/
+
+namespace freud { namespace parallel {
+
+std::vector<int> getNumaNodes()
+{
+#if TBB_VERSION_MAJOR >= 2021
+    std::vector<int> nodes;
+    for (const auto node : tbb::info::numa_nodes())
+    {
+        nodes.push_back(static_cast<int>(node));
+    }
+    return nodes;
+#else
+    return {-1};
+#endif
+}
+
+//! Pins the threads joining an arena to single cores.
+/*! Each thread is pinned to one of the cores it is allowed to run on when it
+ *  joins the arena, which for an arena bound to a NUMA node are the cores of
+ *  that node. Threads are assigned to cores in the order in which they join,
+ *  and their previous affinity is restored when they leave the arena.
+ */
+class ThreadPinningObserver : public tbb::task_scheduler_observer
+{
+public:
+    //! Constructor, starts observing the arena.
+    explicit ThreadPinningObserver(tbb::task_arena& arena) : tbb::task_scheduler_observer(arena)
+    {
+        observe(true);
+    }
+
+    //! Destructor, stops observing the arena.
+    ~ThreadPinningObserver() override
+    {
+        observe(false);
+    }
+
+    ThreadPinningObserver(const ThreadPinningObserver&) = delete;
+    ThreadPinningObserver& operator=(const ThreadPinningObserver&) = delete;
+
+    void on_scheduler_entry(bool /*is_worker*/) override
+    {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0)
+        {
+            return;
+        }
+        previousAffinity() = allowed;
+        hasPreviousAffinity() = true;
+
+        const int num_allowed = CPU_COUNT(&allowed);
+        if (num_allowed == 0)
+        {
+            return;
+        }
+        int core_index = static_cast<int>(m_next_core++ % static_cast<unsigned int>(num_allowed));
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed) && core_index-- == 0)
+            {
+                cpu_set_t pinned;
+                CPU_ZERO(&pinned);
+                CPU_SET(cpu, &pinned);
+                // Pinning is only an optimization, so failures are ignored.
+                pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+                break;
+            }
+        }
+#endif
+    }
+
+    void on_scheduler_exit(bool /*is_worker*/) override
+    {
+#ifdef __linux__
+        if (hasPreviousAffinity())
+        {
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &previousAffinity());
+            hasPreviousAffinity() = false;
+        }
+#endif
+    }
+
+private:
+#ifdef __linux__
+    //! Affinity of the calling thread before it joined the arena.
+    static cpu_set_t& previousAffinity()
+    {
+        static thread_local cpu_set_t affinity;
+        return affinity;
+    }
+
+    //! Whether previousAffinity holds the affinity of the calling thread.
+    static bool& hasPreviousAffinity()
+    {
+        static thread_local bool has_affinity = false;
+        return has_affinity;
+    }
+#endif
+
+    std::atomic<unsigned int> m_next_core {0}; //!< Index of the core for the next thread joining
+};
+
+TaskArena::TaskArena(int numa_node, unsigned int num_threads, bool pin_threads) : m_numa_node(numa_node)
+{
+    if (numa_node < -1)
+    {
+        throw std::invalid_argument("TaskArena requires a NUMA node id of at least -1.");
+    }
+    const int max_concurrency
+        = (num_threads == 0) ? tbb::task_arena::automatic : static_cast<int>(num_threads);
+#if TBB_VERSION_MAJOR >= 2021
+    m_arena = std::make_unique<tbb::task_arena>(tbb::task_arena::constraints(numa_node, max_concurrency));
+#else
+    m_numa_node = -1;
+    m_arena = std::make_unique<tbb::task_arena>(max_concurrency);
+#endif
+    m_arena->initialize();
+    if (pin_threads)
+    {
+        m_observer = std::make_unique<ThreadPinningObserver>(*m_arena);
+    }
+}
+
+TaskArena::~TaskArena()
+{
+    // The observer must stop observing before the arena is destroyed.
+    m_observer.reset();
+}
+
+void TaskArena::enter()
+{
+    m_previous_arenas.push_back(util::setActiveArena(m_arena.get()));
+}
+
+void TaskArena::exit()
+{
+    if (m_previous_arenas.empty())
+    {
+        throw std::runtime_error("TaskArena::exit was called without a matching call to enter.");
+    }
+    util::setActiveArena(m_previous_arenas.back());
+    m_previous_arenas.pop_back();
+}
+
+}; }; // end namespace freud::parallel
@@ -0,0 +1,94 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TASK_ARENA_H
+#define TASK_ARENA_H
+
+#include <memory>
+#include <vector>
+
+#include <tbb/task_arena.h>
+
+/*! \file TaskArena.h
+    \brief Task arenas bound to NUMA nodes in which freud computes can run.
+*/
+
+namespace freud { namespace parallel {
+
+//! Get the NUMA nodes of the machine.
+/*! \returns The ids of the NUMA nodes, or a single id of -1 if the topology is
+ *  not available, in which case arenas are not bound to any node.
+ */
+std::vector<int> getNumaNodes();
+
+class ThreadPinningObserver;
+
+//! Task arena in which the parallel loops of freud computes can run.
+/*! An arena bound to a NUMA node only runs its tasks on the cores of that
+ *  node, so the thread local storage that computes allocate and first touch
+ *  inside the arena stays in the memory of the node. Binding requires oneTBB
+ *  with its hwloc based topology support, and is ignored otherwise.
+ *
+ *  Threads joining the arena can additionally be pinned to single cores of
+ *  the node, in the order in which they join, to stop them from migrating
+ *  between cores. Pinning is only supported on Linux.
+ *
+ *  Computes started by a thread between enter and exit run in the arena.
+ */
+class TaskArena
+{
+public:
+    //! Constructor
+    /*! \param numa_node The NUMA node to bind the arena to, or -1 for no binding.
+     *  \param num_threads Maximum number of threads of the arena, or 0 for all
+     *         cores of the node.
+     *  \param pin_threads Whether to pin threads joining the arena to cores.
+     */
+    explicit TaskArena(int numa_node = -1, unsigned int num_threads = 0, bool pin_threads = false);
+
+    //! Destructor
+    ~TaskArena();
+
+    TaskArena(const TaskArena&) = delete;
+    TaskArena& operator=(const TaskArena&) = delete;
+
+    //! Run the parallel loops started by the calling thread in this arena.
+    void enter();
+
+    //! Restore the arena that was active when enter was called.
+    void exit();
+
+    //! Get the NUMA node of the arena, or -1 if it is not bound to a node.
+    int getNumaNode() const
+    {
+        return m_numa_node;
+    }
+
+    //! Get the maximum number of threads of the arena.
+    unsigned int getNumThreads() const
+    {
+        return static_cast<unsigned int>(m_arena->max_concurrency());
+    }
+
+    //! Return whether threads joining the arena are pinned to cores.
+    bool getPinThreads() const
+    {
+        return m_observer != nullptr;
+    }
+
+    //! Get the underlying TBB arena.
+    tbb::task_arena& getArena()
+    {
+        return *m_arena;
+    }
+
+private:
+    int m_numa_node;                                   //!< NUMA node of the arena
+    std::unique_ptr<tbb::task_arena> m_arena;          //!< The TBB arena
+    std::unique_ptr<ThreadPinningObserver> m_observer; //!< Pins threads joining the arena, if requested
+    std::vector<tbb::task_arena*> m_previous_arenas;   //!< Arenas active before each enter
+};
+
+}; }; // end namespace freud::parallel
+
+#endif // TASK_ARENA_H
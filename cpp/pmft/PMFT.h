@@ -4,6 +4,7 @@
 #ifndef PMFT_H
 #define PMFT_H
 
+#include <cmath>
 #include <tbb/tbb.h>
 
 #include "BondHistogramCompute.h"
@@ -41,6 +42,27 @@ public:
         return reduceAndReturn(m_pcf_array);
     }
 
+    //! Get a reference to the PMFT array, the negative logarithm of the PCF
+    /*! The PMFT is only computed when it is read, at most once per reduction
+     *  of the PCF.
+     */
+    const util::ManagedArray<float>& getPMFT()
+    {
+        const util::ManagedArray<float>& pcf = getPCF();
+        if (m_reduce_pmft)
+        {
+            m_pmft_array.prepareUninitialized(pcf.shape());
+            util::forLoopWrapper(0, pcf.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    m_pmft_array[i] = -std::log(pcf[i]);
+                }
+            });
+            m_reduce_pmft = false;
+        }
+        return m_pmft_array;
+    }
+
 protected:
     //! Reduce the thread local histogram into the total pair correlation function.
     /*! The pair correlation function is computed by reducing the bin counts in
@@ -66,19 +88,21 @@ protected:
     template<typename JacobFactor> void reduce(JacobFactor jf)
     {
         m_pcf_array.prepare(m_histogram.shape());
-        m_histogram.prepare(m_histogram.shape());
+        m_reduce_pmft = true;
 
         float inv_num_dens = m_box.getVolume() / static_cast<float>(m_n_query_points);
         float norm_factor
             = float(1.0) / (static_cast<float>(m_frame_counter) * static_cast<float>(m_n_points));
         float prefactor = inv_num_dens * norm_factor;
 
-        m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &jf](size_t i) {
-            m_pcf_array[i] = static_cast<float>(m_histogram[i]) * prefactor * jf(i);
+        reduceBinCounts([this, &prefactor, &jf](size_t i) {
+            m_pcf_array[i] = static_cast<float>(getBinCount(i)) * prefactor * jf(i);
         });
     }
 
-    util::ManagedArray<float> m_pcf_array; //!< Array of computed pair correlation function.
+    util::ManagedArray<float> m_pcf_array;  //!< Array of computed pair correlation function.
+    util::ManagedArray<float> m_pmft_array; //!< Array of computed potential of mean force and torque.
+    bool m_reduce_pmft {true};              //!< Whether the PMFT must be computed from the PCF.
 };
 
 }; }; // end namespace freud::pmft
@@ -2,6 +2,7 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <stdexcept>
+#include <vector>
 
 #include "PMFTXYT.h"
 #include "utils.h"
@@ -69,15 +70,20 @@ void PMFTXYT::accumulate(const locality::NeighborQuery* neighbor_query, const fl
                          freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce2D();
+
+    // Convert the orientation of each query point to a matrix once, rather
+    // than computing a sine and a cosine for each bond.
+    std::vector<rotmat2<float>> query_rotations(n_query_points);
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        inverseRotationMatrices(query_orientations + begin, query_rotations.data() + begin, end - begin);
+    });
+    const rotmat2<float>* rotations = query_rotations.data();
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+                          vec2<float> delta(bondVector2D(neighbor_bond, neighbor_query, query_points));
 
                           // rotate interparticle vector
-                          vec2<float> myVec(delta.x, delta.y);
-                          rotmat2<float> myMat
-                              = rotmat2<float>::fromAngle(-query_orientations[neighbor_bond.query_point_idx]);
-                          vec2<float> rotVec = myMat * myVec;
+                          vec2<float> rotVec = rotations[neighbor_bond.query_point_idx] * delta;
                           // calculate angle
                           float d_theta = std::atan2(-delta.y, -delta.x);
                           float t = orientations[neighbor_bond.point_idx] - d_theta;
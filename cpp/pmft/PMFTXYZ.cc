@@ -2,6 +2,9 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include "PMFTXYZ.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 /*! \file PMFTXYZ.cc
@@ -10,6 +13,69 @@
 
 namespace freud { namespace pmft {
 
+namespace {
+
+//! Tolerance on the entries of rotation matrices that are zero or one up to rounding
+constexpr float SIGNED_PERMUTATION_TOLERANCE = 1e-3;
+
+//! A rotation that permutes the coordinate axes and flips the signs of some of them
+struct SignedPermutation
+{
+    std::array<unsigned int, 3> axis {0, 1, 2}; //!< Component of the vector giving each rotated component
+    std::array<int, 3> sign {1, 1, 1};          //!< Sign of each rotated component
+
+    bool operator==(const SignedPermutation& other) const
+    {
+        return axis == other.axis && sign == other.sign;
+    }
+
+    //! Compose with a rotation applied before this one
+    SignedPermutation operator*(const SignedPermutation& other) const
+    {
+        SignedPermutation result;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            result.axis[i] = other.axis[axis[i]];
+            result.sign[i] = sign[i] * other.sign[axis[i]];
+        }
+        return result;
+    }
+};
+
+//! Find the signed permutation performed by a rotation
+/*! \returns Whether the rotation is a signed permutation up to rounding.
+ */
+bool toSignedPermutation(const quat<float>& q, SignedPermutation& permutation)
+{
+    const rotmat3<float> matrix(q);
+    const std::array<vec3<float>, 3> rows {matrix.row0, matrix.row1, matrix.row2};
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        unsigned int num_nonzero = 0;
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            const float entry = j == 0 ? rows[i].x : (j == 1 ? rows[i].y : rows[i].z);
+            if (std::abs(entry) > float(1.0) - SIGNED_PERMUTATION_TOLERANCE)
+            {
+                permutation.axis[i] = j;
+                permutation.sign[i] = entry > 0 ? 1 : -1;
+                ++num_nonzero;
+            }
+            else if (std::abs(entry) > SIGNED_PERMUTATION_TOLERANCE)
+            {
+                return false;
+            }
+        }
+        if (num_nonzero != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}; // end anonymous namespace
+
 PMFTXYZ::PMFTXYZ(float x_max, float y_max, float z_max, unsigned int n_x, unsigned int n_y, unsigned int n_z,
                  const vec3<float>& shiftvec)
     : PMFT(), m_shiftvec(shiftvec), m_num_equiv_orientations(0xffffffff)
@@ -65,20 +131,43 @@ PMFTXYZ::PMFTXYZ(float x_max, float y_max, float z_max, unsigned int n_x, unsign
 
     // Construct the Histogram object that will be used to keep track of counts
     // of bond distances found.
-    BHAxes axes;
-    axes.push_back(std::make_shared<util::RegularAxis>(n_x, -x_max, x_max));
-    axes.push_back(std::make_shared<util::RegularAxis>(n_y, -y_max, y_max));
-    axes.push_back(std::make_shared<util::RegularAxis>(n_z, -z_max, z_max));
-    m_histogram = BondHistogram(axes);
+    m_axes = {std::make_shared<util::RegularAxis>(n_x, -x_max, x_max),
+              std::make_shared<util::RegularAxis>(n_y, -y_max, y_max),
+              std::make_shared<util::RegularAxis>(n_z, -z_max, z_max)};
+    m_histogram = BondHistogram(BHAxes(m_axes.begin(), m_axes.end()));
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 }
 
+// The bonds binned into the orbits of the bins are part of the bin counts, so
+// they are unfolded when the counts are reduced.
+void PMFTXYZ::reduceCounts()
+{
+    // Bonds binned into the orbits of the bins are unfolded into every bin of their orbit.
+    const bool folded = m_folded_frames != 0;
+    if (folded)
+    {
+        m_folded_histogram.prepare(m_folded_histogram.shape());
+        m_folded_histogram.reduceOverThreads(m_local_folded_histograms);
+    }
+    reduceBinCounts([this, folded](size_t i) {
+        if (folded)
+        {
+            const unsigned int orbit = m_orbit_index[i];
+            addToBinCount(i, m_orbit_weights[orbit] * m_folded_histogram[orbit]);
+        }
+    });
+}
+
 // Almost identical to the parent method, except that the normalization factor
 // in this class also includes the number of equivalent orientations.
 void PMFTXYZ::reduce()
 {
     m_pcf_array.prepare(m_histogram.shape());
-    m_histogram.prepare(m_histogram.shape());
+    m_reduce_pmft = true;
+    if (!countsReduced())
+    {
+        reduceCounts();
+    }
 
     float inv_num_dens = m_box.getVolume() / (float) m_n_query_points;
     float norm_factor
@@ -86,8 +175,8 @@ void PMFTXYZ::reduce()
     float prefactor = inv_num_dens * norm_factor;
 
     float jacobian_factor = (float) 1.0 / m_jacobian;
-    m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &jacobian_factor](size_t i) {
-        m_pcf_array[i] = static_cast<float>(m_histogram[i]) * prefactor * jacobian_factor;
+    reduceBinCounts([this, &prefactor, &jacobian_factor](size_t i) {
+        m_pcf_array[i] = static_cast<float>(getBinCount(i)) * prefactor * jacobian_factor;
     });
 }
 
@@ -95,6 +184,144 @@ void PMFTXYZ::reset()
 {
     BondHistogramCompute::reset();
     m_num_equiv_orientations = 0xffffffff;
+    m_local_folded_histograms.reset();
+    m_folded_frames = 0;
+}
+
+bool PMFTXYZ::prepareFolding(const quat<float>* equiv_orientations, unsigned int num_equiv_orientations)
+{
+    const bool same_orientations = m_fold_orientations.size() == num_equiv_orientations
+        && std::equal(m_fold_orientations.begin(), m_fold_orientations.end(), equiv_orientations,
+                      [](const quat<float>& a, const quat<float>& b) {
+                          return a.s == b.s && a.v.x == b.v.x && a.v.y == b.v.y && a.v.z == b.v.z;
+                      });
+    if (same_orientations)
+    {
+        return m_can_fold;
+    }
+    // The orbits may only change while nothing has been binned into them.
+    if (m_folded_frames != 0)
+    {
+        return false;
+    }
+    m_fold_orientations.assign(equiv_orientations, equiv_orientations + num_equiv_orientations);
+    m_can_fold = false;
+    m_orbit_index.clear();
+    m_orbit_weights.clear();
+
+    // The distinct rotations must form a group, with every rotation repeated equally often.
+    std::vector<SignedPermutation> group;
+    std::vector<unsigned int> multiplicities;
+    for (unsigned int k = 0; k < num_equiv_orientations; ++k)
+    {
+        SignedPermutation permutation;
+        if (!toSignedPermutation(equiv_orientations[k], permutation))
+        {
+            return false;
+        }
+        const auto match = std::find(group.begin(), group.end(), permutation);
+        if (match == group.end())
+        {
+            group.push_back(permutation);
+            multiplicities.push_back(1);
+        }
+        else
+        {
+            ++multiplicities[match - group.begin()];
+        }
+    }
+    if (group.empty()
+        || std::any_of(multiplicities.begin(), multiplicities.end(),
+                       [&](unsigned int multiplicity) { return multiplicity != multiplicities[0]; }))
+    {
+        return false;
+    }
+    for (const auto& a : group)
+    {
+        for (const auto& b : group)
+        {
+            if (std::find(group.begin(), group.end(), a * b) == group.end())
+            {
+                return false;
+            }
+        }
+    }
+
+    // The grid must be mapped onto itself, so axes that are exchanged must be identical.
+    const std::array<size_t, 3> shape {m_axes[0]->size(), m_axes[1]->size(), m_axes[2]->size()};
+    for (const auto& permutation : group)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const unsigned int j = permutation.axis[i];
+            if (shape[i] != shape[j] || m_axes[i]->getMax() != m_axes[j]->getMax())
+            {
+                return false;
+            }
+        }
+    }
+    const size_t n_bins = shape[0] * shape[1] * shape[2];
+    if (n_bins > std::numeric_limits<unsigned int>::max())
+    {
+        return false;
+    }
+    m_can_fold = true;
+    if (group.size() == 1)
+    {
+        // Copies of the identity are binned once into the full grid.
+        m_orbit_weights.push_back(multiplicities[0]);
+        return true;
+    }
+
+    // Find the first bin of the orbit of each bin.
+    m_orbit_index.resize(n_bins);
+    util::forLoopWrapper(0, n_bins, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const std::array<size_t, 3> index {b / (shape[1] * shape[2]), (b / shape[2]) % shape[1],
+                                               b % shape[2]};
+            size_t first = b;
+            for (const auto& permutation : group)
+            {
+                std::array<size_t, 3> image;
+                for (unsigned int i = 0; i < 3; ++i)
+                {
+                    const size_t source = index[permutation.axis[i]];
+                    image[i] = permutation.sign[i] > 0 ? source : shape[i] - 1 - source;
+                }
+                first = std::min(first, (image[0] * shape[1] + image[1]) * shape[2] + image[2]);
+            }
+            m_orbit_index[b] = static_cast<unsigned int>(first);
+        }
+    });
+
+    // Number the orbits in order of their first bins, which are numbered before the other bins of the orbit.
+    std::vector<unsigned int> orbit_sizes;
+    for (size_t b = 0; b < n_bins; ++b)
+    {
+        if (m_orbit_index[b] == b)
+        {
+            m_orbit_index[b] = static_cast<unsigned int>(orbit_sizes.size());
+            orbit_sizes.push_back(0);
+        }
+        else
+        {
+            m_orbit_index[b] = m_orbit_index[m_orbit_index[b]];
+        }
+        ++orbit_sizes[m_orbit_index[b]];
+    }
+
+    // Each bond binned into an orbit is binned into the full grid once per
+    // equivalent orientation, which covers each bin of the orbit equally often.
+    const auto num_orbits = static_cast<unsigned int>(orbit_sizes.size());
+    for (const unsigned int orbit_size : orbit_sizes)
+    {
+        m_orbit_weights.push_back(num_equiv_orientations / orbit_size);
+    }
+    m_folded_histogram = BondHistogram(
+        BHAxes {std::make_shared<util::RegularAxis>(num_orbits, 0, static_cast<float>(num_orbits))});
+    m_local_folded_histograms = BondHistogram::ThreadLocalHistogram(m_folded_histogram);
+    return true;
 }
 
 void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, const quat<float>* query_orientations,
@@ -114,24 +341,104 @@ void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, const qu
             "The number of equivalent orientations must be constant while accumulating data into PMFTXYZ.");
     }
     neighbor_query->getBox().enforce3D();
+
+    // Convert the inverse of the orientation of each query point to a matrix
+    // once, rather than rotating each bond by the quaternion.
+    std::vector<rotmat3<float>> query_rotations(n_query_points);
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        inverseRotationMatrices(query_orientations + begin, query_rotations.data() + begin, end - begin);
+    });
+    const rotmat3<float>* rotations = query_rotations.data();
+
+    if (prepareFolding(equiv_orientations, num_equiv_orientations))
+    {
+        accumulateFolded(neighbor_query, rotations, query_points, n_query_points, nlist, qargs);
+        return;
+    }
+    std::vector<rotmat3<float>> equiv_rotations(equiv_orientations,
+                                                equiv_orientations + num_equiv_orientations);
+    const rotmat3<float>* equivalents = equiv_rotations.data();
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          // create the reference point quaternion
-                          quat<float> query_orientation(query_orientations[neighbor_bond.query_point_idx]);
                           // make sure that the particles are wrapped into the box
                           vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+                          // rotate the vector into the frame of the query point
+                          const vec3<float> local_delta(rotations[neighbor_bond.query_point_idx] * delta);
 
                           for (unsigned int k = 0; k < num_equiv_orientations; k++)
                           {
-                              // create point vector
-                              vec3<float> v(delta);
-                              // rotate the vector
-                              v = rotate(conj(query_orientation), v);
-                              v = rotate(equiv_orientations[k], v);
-
+                              const vec3<float> v(equivalents[k] * local_delta);
                               m_local_histograms(v.x, v.y, v.z);
                           }
                       });
 }
 
+void PMFTXYZ::accumulateFolded(const locality::NeighborQuery* neighbor_query,
+                               const rotmat3<float>* query_rotations, const vec3<float>* query_points,
+                               unsigned int n_query_points, const locality::NeighborList* nlist,
+                               freud::locality::QueryArgs qargs)
+{
+    const std::array<size_t, 3> shape {m_axes[0]->size(), m_axes[1]->size(), m_axes[2]->size()};
+    auto bin = [this, shape](const vec3<float>& v) -> size_t {
+        const size_t bin_x = m_axes[0]->bin(v.x);
+        const size_t bin_y = m_axes[1]->bin(v.y);
+        const size_t bin_z = m_axes[2]->bin(v.z);
+        if (bin_x == util::Axis::OVERFLOW_BIN || bin_y == util::Axis::OVERFLOW_BIN
+            || bin_z == util::Axis::OVERFLOW_BIN)
+        {
+            return util::Axis::OVERFLOW_BIN;
+        }
+        return (bin_x * shape[1] + bin_y) * shape[2] + bin_z;
+    };
+
+    if (m_orbit_index.empty())
+    {
+        const unsigned int multiplicity = m_orbit_weights[0];
+        accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                          [=](const freud::locality::NeighborBond& neighbor_bond) {
+                              vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+                              m_local_histograms.increment(
+                                  bin(query_rotations[neighbor_bond.query_point_idx] * delta), multiplicity);
+                          });
+        return;
+    }
+
+    if (m_folded_frames == 0)
+    {
+        // The orbits are empty, so their strategy may change.
+        util::AccumulationStrategy strategy = m_requested_strategy;
+        if (strategy == util::AccumulationStrategy::automatic)
+        {
+            strategy = BondHistogram::ThreadLocalHistogram::chooseStrategy(
+                m_folded_histogram.size(), estimateNumBonds(neighbor_query, n_query_points, nlist, qargs));
+        }
+        m_local_folded_histograms.setStrategy(strategy);
+    }
+    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                      [=](const freud::locality::NeighborBond& neighbor_bond) {
+                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+                          const size_t value_bin
+                              = bin(query_rotations[neighbor_bond.query_point_idx] * delta);
+                          if (value_bin != util::Axis::OVERFLOW_BIN)
+                          {
+                              m_local_folded_histograms.increment(m_orbit_index[value_bin]);
+                          }
+                      });
+    ++m_folded_frames;
+}
+
+void PMFTXYZ::accumulateTrajectory(const locality::FrameSource& source, const quat<float>* equiv_orientations,
+                                   unsigned int num_equiv_orientations, freud::locality::QueryArgs qargs)
+{
+    locality::processTrajectory(source, [&](size_t /*index*/, const locality::NeighborQuery* neighbor_query,
+                                            const locality::TrajectoryFrame& frame) {
+        if (frame.orientations == nullptr)
+        {
+            throw std::invalid_argument("PMFTXYZ requires the orientations of the points of every frame.");
+        }
+        accumulate(neighbor_query, frame.orientations, frame.points, frame.n_points, equiv_orientations,
+                   num_equiv_orientations, nullptr, qargs);
+    });
+}
+
 }; }; // end namespace freud::pmft
@@ -4,7 +4,12 @@
 #ifndef PMFTXYZ_H
 #define PMFTXYZ_H
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "PMFT.h"
+#include "TrajectoryPipeline.h"
 
 /*! \file PMFTXYZ.h
     \brief Routines for computing 3D potential of mean force in XYZ coordinates
@@ -12,6 +17,15 @@
 
 namespace freud { namespace pmft {
 
+//! Computes the PMFT in XYZ coordinates
+/*! When the equivalent orientations form a group of rotations that permute
+ *  the axes of the grid and flip their signs, such as the rotations of a
+ *  cube, the bin counts are invariant under the group. Each bond is then
+ *  binned once into the orbit of its bin under the group, in thread local
+ *  histograms with one bin per orbit, instead of once per equivalent
+ *  orientation into the full grid. The orbits are unfolded into the full grid
+ *  when the results are reduced.
+ */
 class PMFTXYZ : public PMFT
 {
 public:
@@ -27,6 +41,15 @@ public:
                     const quat<float>* equiv_orientations, unsigned int num_equiv_orientations,
                     const locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Compute the PCF of every frame of a trajectory
+    /*! The orientations of the points of each frame are used as the query
+     *  orientations. The neighbor queries of the following frames are built
+     *  while the bonds of each frame are binned, see
+     *  locality::processTrajectory.
+     */
+    void accumulateTrajectory(const locality::FrameSource& source, const quat<float>* equiv_orientations,
+                              unsigned int num_equiv_orientations, freud::locality::QueryArgs qargs);
+
     //! Reset the PMFT
     /*! Override the parent method to also reset the number of equivalent orientations.
      */
@@ -37,10 +60,38 @@ protected:
     //! helper function to reduce the thread specific arrays into one array
     void reduce() override;
 
+    //! Reduce the bin counts, unfolding the bonds binned into the orbits of the bins
+    void reduceCounts() override;
+
+    //! Prepare to fold the equivalent orientations of an accumulation.
+    /*! The orbits of the bins are computed when the orientations differ from
+     *  those of the current orbits and nothing has been accumulated into the
+     *  orbits since the last reset.
+     *
+     *  \returns Whether the bonds of the accumulation can be binned into the orbits.
+     */
+    bool prepareFolding(const quat<float>* equiv_orientations, unsigned int num_equiv_orientations);
+
+    //! Bin each bond, rotated into the frame of its query point, once into the orbits of prepareFolding.
+    void accumulateFolded(const locality::NeighborQuery* neighbor_query,
+                          const rotmat3<float>* query_rotations, const vec3<float>* query_points,
+                          unsigned int n_query_points, const locality::NeighborList* nlist,
+                          freud::locality::QueryArgs qargs);
+
     float m_jacobian;
     vec3<float> m_shiftvec;                //!< vector that points from [0,0,0] to the origin of the pmft
     unsigned int m_num_equiv_orientations; //!< The number of equivalent orientations used in the current
                                            //!< calls to compute.
+
+    std::array<std::shared_ptr<util::RegularAxis>, 3> m_axes; //!< The axes of the grid.
+    std::vector<quat<float>> m_fold_orientations; //!< The equivalent orientations of the orbits.
+    bool m_can_fold {false};                      //!< Whether the orientations can be folded.
+    std::vector<unsigned int> m_orbit_index;      //!< The orbit of each bin, empty for the trivial group.
+    std::vector<unsigned int> m_orbit_weights;    //!< Count of each bin of an orbit per bond in the orbit.
+    unsigned int m_folded_frames {0};             //!< Number of frames accumulated into the orbits.
+    BondHistogram m_folded_histogram;             //!< Histogram of bonds in each orbit.
+    BondHistogram::ThreadLocalHistogram
+        m_local_folded_histograms; //!< Thread local bin counts of the orbits.
 };
 
 }; }; // end namespace freud::pmft
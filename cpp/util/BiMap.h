@@ -339,12 +339,22 @@ public:
         return container.end();
     }
 
-    auto cbegin() -> decltype(container.cbegin())
+    auto begin() const -> decltype(container.cbegin())
     {
         return container.cbegin();
     }
 
-    auto cend() -> decltype(container.cend())
+    auto end() const -> decltype(container.cend())
+    {
+        return container.cend();
+    }
+
+    auto cbegin() const -> decltype(container.cbegin())
+    {
+        return container.cbegin();
+    }
+
+    auto cend() const -> decltype(container.cend())
     {
         return container.cend();
     }
@@ -0,0 +1,195 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined _WIN32 || defined __CYGWIN__
+#include <malloc.h>
+#elif defined __linux__
+#include <sys/mman.h>
+#endif
+
+#include "BufferPool.h"
+
+/*! \file BufferPool.cc
+    \brief Implements the pool of recycled memory buffers backing ManagedArray.
+*/
+
+namespace freud { namespace util {
+
+namespace {
+
+//! Alignment in bytes of all buffers smaller than a huge page
+constexpr size_t BUFFER_ALIGNMENT = 64;
+
+//! Number of size classes per power of two
+constexpr size_t SIZE_CLASSES_PER_OCTAVE = 4;
+
+}; // end anonymous namespace
+
+BufferPool& BufferPool::instance()
+{
+    // The pool is intentionally never destroyed so that arrays released during static destruction, for
+    // example when the Python interpreter exits, can still return their buffers.
+    static auto* pool = new BufferPool();
+    return *pool;
+}
+
+BufferPool::~BufferPool()
+{
+    clear();
+}
+
+size_t BufferPool::getCapacity(size_t bytes)
+{
+    if (bytes < MIN_POOLED_SIZE)
+    {
+        const size_t num_blocks = std::max(size_t(1), (bytes + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT);
+        return num_blocks * BUFFER_ALIGNMENT;
+    }
+    size_t octave = MIN_POOLED_SIZE;
+    while (octave <= bytes / 2)
+    {
+        octave *= 2;
+    }
+    const size_t step = octave / SIZE_CLASSES_PER_OCTAVE;
+    return (bytes + step - 1) / step * step;
+}
+
+void* BufferPool::allocateBuffer(size_t capacity)
+{
+    const size_t alignment = (capacity >= HUGE_PAGE_SIZE) ? HUGE_PAGE_SIZE : BUFFER_ALIGNMENT;
+    void* ptr = nullptr;
+#if defined _WIN32 || defined __CYGWIN__
+    ptr = _aligned_malloc(capacity, alignment);
+#else
+    if (posix_memalign(&ptr, alignment, capacity) != 0)
+    {
+        ptr = nullptr;
+    }
+#endif
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+#if defined __linux__ && defined MADV_HUGEPAGE
+    if (capacity >= HUGE_PAGE_SIZE)
+    {
+        // This is only advice, so failures are ignored.
+        madvise(ptr, capacity, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+
+void BufferPool::freeBuffer(void* ptr)
+{
+#if defined _WIN32 || defined __CYGWIN__
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+void* BufferPool::allocate(size_t bytes)
+{
+    const size_t capacity = getCapacity(bytes);
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.allocations;
+        auto free_buffers = m_free_buffers.find(capacity);
+        if (capacity >= MIN_POOLED_SIZE && free_buffers != m_free_buffers.end()
+            && !free_buffers->second.empty())
+        {
+            void* ptr = free_buffers->second.back();
+            free_buffers->second.pop_back();
+            m_statistics.cached_bytes -= capacity;
+            ++m_statistics.reuses;
+            return ptr;
+        }
+    }
+    return allocateBuffer(capacity);
+}
+
+void BufferPool::deallocate(void* ptr, size_t bytes)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    const size_t capacity = getCapacity(bytes);
+    if (capacity >= MIN_POOLED_SIZE)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.releases;
+        if (m_enabled && m_statistics.cached_bytes + capacity <= m_max_cached_bytes)
+        {
+            m_free_buffers[capacity].push_back(ptr);
+            m_statistics.cached_bytes += capacity;
+            return;
+        }
+        ++m_statistics.evictions;
+    }
+    freeBuffer(ptr);
+}
+
+void BufferPool::clear()
+{
+    std::map<size_t, std::vector<void*>> free_buffers;
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        free_buffers.swap(m_free_buffers);
+        m_statistics.cached_bytes = 0;
+    }
+    for (const auto& size_class : free_buffers)
+    {
+        for (void* ptr : size_class.second)
+        {
+            freeBuffer(ptr);
+        }
+    }
+}
+
+void BufferPool::setEnabled(bool enabled)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled = enabled;
+    }
+    if (!enabled)
+    {
+        clear();
+    }
+}
+
+void BufferPool::setMaxCachedBytes(size_t max_cached_bytes)
+{
+    bool over_limit;
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_cached_bytes = max_cached_bytes;
+        over_limit = m_statistics.cached_bytes > m_max_cached_bytes;
+    }
+    if (over_limit)
+    {
+        clear();
+    }
+}
+
+BufferPoolStatistics BufferPool::getStatistics() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void BufferPool::resetStatistics()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t cached_bytes = m_statistics.cached_bytes;
+    m_statistics = BufferPoolStatistics();
+    m_statistics.cached_bytes = cached_bytes;
+}
+
+}; }; // end namespace freud::util
@@ -0,0 +1,115 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/*! \file BufferPool.h
+    \brief Pool of recycled memory buffers backing ManagedArray.
+*/
+
+namespace freud { namespace util {
+
+//! Counters describing the use of a BufferPool.
+struct BufferPoolStatistics
+{
+    size_t allocations {0};  //!< Number of buffers requested from the pool
+    size_t reuses {0};       //!< Number of requests served by a recycled buffer
+    size_t releases {0};     //!< Number of buffers returned to the pool
+    size_t evictions {0};    //!< Number of returned buffers freed because the pool was full
+    size_t cached_bytes {0}; //!< Number of bytes currently held by the pool
+};
+
+//! Size-class pool of memory buffers.
+/*! Requests are rounded up to one of four size classes per power of two, so
+ *  a buffer wastes at most a quarter of its size and buffers of similar sizes
+ *  can serve each other. Memory returned to the pool is kept, up to a limit,
+ *  and handed out again to the next request of the same size class instead of
+ *  being returned to the operating system. This avoids the page faults of
+ *  fresh allocations when a compute is called repeatedly while its previous
+ *  outputs are still referenced, for example by numpy arrays in Python.
+ *
+ *  Buffers of at least HUGE_PAGE_SIZE bytes are aligned to HUGE_PAGE_SIZE
+ *  and, on Linux, advised to be backed by transparent huge pages. Buffers
+ *  smaller than MIN_POOLED_SIZE bytes bypass the pool, since the system
+ *  allocator already recycles those efficiently.
+ *
+ *  The pool is shared by all freud objects and is thread safe.
+ */
+class BufferPool
+{
+public:
+    //! Smallest request in bytes that is served from the pool
+    static constexpr size_t MIN_POOLED_SIZE = 4096;
+
+    //! Size in bytes of a huge page
+    static constexpr size_t HUGE_PAGE_SIZE = size_t(1) << 21;
+
+    //! Default limit on the number of bytes held by the pool
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = size_t(1) << 30;
+
+    //! Get the pool shared by all freud objects.
+    static BufferPool& instance();
+
+    //! Destructor, frees all cached buffers.
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    //! Allocate a buffer of at least the requested size.
+    /*! \param bytes The number of bytes requested.
+     *  \returns A pointer aligned to at least 64 bytes, which must be returned with deallocate.
+     */
+    void* allocate(size_t bytes);
+
+    //! Return a buffer obtained from allocate to the pool.
+    /*! \param ptr The buffer.
+     *  \param bytes The number of bytes originally requested.
+     */
+    void deallocate(void* ptr, size_t bytes);
+
+    //! Free all cached buffers.
+    void clear();
+
+    //! Enable or disable recycling of buffers.
+    /*! A disabled pool frees buffers as soon as they are returned. */
+    void setEnabled(bool enabled);
+
+    //! Set the maximum number of bytes held by the pool.
+    void setMaxCachedBytes(size_t max_cached_bytes);
+
+    //! Get a snapshot of the counters of the pool.
+    BufferPoolStatistics getStatistics() const;
+
+    //! Reset all counters except the number of cached bytes.
+    void resetStatistics();
+
+    //! Get the number of bytes allocated for a request of the given size.
+    static size_t getCapacity(size_t bytes);
+
+private:
+    //! Private constructor, use instance.
+    BufferPool() = default;
+
+    //! Allocate a new buffer with the given capacity.
+    static void* allocateBuffer(size_t capacity);
+
+    //! Free a buffer obtained from allocateBuffer.
+    static void freeBuffer(void* ptr);
+
+    mutable std::mutex m_mutex;                           //!< Guards all members below
+    std::map<size_t, std::vector<void*>> m_free_buffers;  //!< Recycled buffers by capacity
+    BufferPoolStatistics m_statistics;                    //!< Counters of the pool
+    size_t m_max_cached_bytes {DEFAULT_MAX_CACHED_BYTES}; //!< Limit on the cached bytes
+    bool m_enabled {true};                                //!< Whether buffers are recycled
+};
+
+}; }; // end namespace freud::util
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,223 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <stdexcept>
+
+#include "FFT.h"
+#include "utils.h"
+
+/*! \file FFT.cc
+    \brief Fast Fourier transforms of arbitrary length.
+*/
+
+namespace freud { namespace util {
+
+FFTPlan::FFTPlan(size_t n) : m_n(n), m_fft_size(1)
+{
+    if (n == 0)
+    {
+        throw std::invalid_argument("FFTPlan requires a positive length.");
+    }
+
+    // Bluestein's algorithm needs a circular convolution of length at least
+    // 2n - 1 to hold the linear convolution of two sequences of length n.
+    const bool power_of_two = (n & (n - 1)) == 0;
+    const size_t min_size = power_of_two ? n : 2 * n - 1;
+    unsigned int num_bits = 0;
+    while (m_fft_size < min_size)
+    {
+        m_fft_size *= 2;
+        ++num_bits;
+    }
+
+    m_bit_reverse.resize(m_fft_size);
+    for (size_t i = 0; i < m_fft_size; ++i)
+    {
+        size_t reversed = 0;
+        for (unsigned int bit = 0; bit < num_bits; ++bit)
+        {
+            reversed |= ((i >> bit) & 1) << (num_bits - 1 - bit);
+        }
+        m_bit_reverse[i] = reversed;
+    }
+
+    m_twiddles.resize(m_fft_size / 2);
+    for (size_t k = 0; k < m_twiddles.size(); ++k)
+    {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(m_fft_size);
+        m_twiddles[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+
+    if (!power_of_two)
+    {
+        // Reducing k^2 modulo 2n keeps the chirp angles accurate for large k.
+        m_chirp.resize(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t k_sq = (k * k) % (2 * n);
+            const double angle = -M_PI * static_cast<double>(k_sq) / static_cast<double>(n);
+            m_chirp[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+
+        m_chirp_fft.assign(m_fft_size, 0);
+        m_chirp_fft[0] = std::conj(m_chirp[0]);
+        for (size_t k = 1; k < n; ++k)
+        {
+            m_chirp_fft[k] = std::conj(m_chirp[k]);
+            m_chirp_fft[m_fft_size - k] = std::conj(m_chirp[k]);
+        }
+        radix2(m_chirp_fft.data());
+    }
+}
+
+void FFTPlan::radix2(std::complex<double>* data) const
+{
+    for (size_t i = 0; i < m_fft_size; ++i)
+    {
+        const size_t j = m_bit_reverse[i];
+        if (i < j)
+        {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (size_t len = 2; len <= m_fft_size; len *= 2)
+    {
+        const size_t half = len / 2;
+        const size_t step = m_fft_size / len;
+        for (size_t start = 0; start < m_fft_size; start += len)
+        {
+            for (size_t k = 0; k < half; ++k)
+            {
+                const std::complex<double> u = data[start + k];
+                const std::complex<double> v = data[start + k + half] * m_twiddles[k * step];
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+            }
+        }
+    }
+}
+
+void FFTPlan::forward(std::complex<double>* data) const
+{
+    if (m_chirp.empty())
+    {
+        radix2(data);
+        return;
+    }
+
+    // Bluestein's algorithm: multiply by the chirp, convolve with the
+    // conjugate chirp, and multiply by the chirp again.
+    std::vector<std::complex<double>> work(m_fft_size, 0);
+    for (size_t k = 0; k < m_n; ++k)
+    {
+        work[k] = data[k] * m_chirp[k];
+    }
+    radix2(work.data());
+    for (size_t k = 0; k < m_fft_size; ++k)
+    {
+        work[k] = std::conj(work[k] * m_chirp_fft[k]);
+    }
+    radix2(work.data());
+    const double scale = 1.0 / static_cast<double>(m_fft_size);
+    for (size_t k = 0; k < m_n; ++k)
+    {
+        data[k] = std::conj(work[k]) * scale * m_chirp[k];
+    }
+}
+
+void FFTPlan::inverse(std::complex<double>* data) const
+{
+    // The inverse transform is the conjugate of the forward transform of the
+    // conjugate input.
+    for (size_t k = 0; k < m_n; ++k)
+    {
+        data[k] = std::conj(data[k]);
+    }
+    forward(data);
+    for (size_t k = 0; k < m_n; ++k)
+    {
+        data[k] = std::conj(data[k]);
+    }
+}
+
+FFTNPlan::FFTNPlan(const std::vector<size_t>& shape) : m_shape(shape), m_plans(shape.size())
+{
+    for (size_t axis = 0; axis < shape.size(); ++axis)
+    {
+        for (size_t prev = 0; prev < axis; ++prev)
+        {
+            if (shape[prev] == shape[axis])
+            {
+                m_plans[axis] = m_plans[prev];
+                break;
+            }
+        }
+        if (!m_plans[axis] && shape[axis] > 1)
+        {
+            m_plans[axis] = std::make_shared<const FFTPlan>(shape[axis]);
+        }
+    }
+}
+
+void FFTNPlan::transform(std::complex<double>* data, bool inverse) const
+{
+    size_t total = 1;
+    for (const size_t len : m_shape)
+    {
+        total *= len;
+    }
+
+    size_t stride = total;
+    for (size_t axis = 0; axis < m_shape.size(); ++axis)
+    {
+        // Values along this axis are stride elements apart.
+        const size_t len = m_shape[axis];
+        stride /= len;
+        if (len == 1)
+        {
+            continue;
+        }
+
+        const FFTPlan& plan = *m_plans[axis];
+        util::forLoopWrapper(0, total / len, [&](size_t begin, size_t end) {
+            std::vector<std::complex<double>> line(len);
+            for (size_t l = begin; l < end; ++l)
+            {
+                std::complex<double>* first = data + (l / stride) * len * stride + (l % stride);
+                for (size_t k = 0; k < len; ++k)
+                {
+                    line[k] = first[k * stride];
+                }
+                if (inverse)
+                {
+                    plan.inverse(line.data());
+                }
+                else
+                {
+                    plan.forward(line.data());
+                }
+                for (size_t k = 0; k < len; ++k)
+                {
+                    first[k * stride] = line[k];
+                }
+            }
+        });
+    }
+}
+
+void fftn(std::complex<double>* data, const std::vector<size_t>& shape, bool inverse)
+{
+    const FFTNPlan plan(shape);
+    if (inverse)
+    {
+        plan.inverse(data);
+    }
+    else
+    {
+        plan.forward(data);
+    }
+}
+
+}; }; // end namespace freud::util
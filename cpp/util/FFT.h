@@ -0,0 +1,114 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+/*! \file FFT.h
+    \brief Fast Fourier transforms of arbitrary length.
+*/
+
+namespace freud { namespace util {
+
+//! Precomputed tables for complex discrete Fourier transforms of a fixed length
+/*! Power of two lengths use an iterative radix-2 transform. Other lengths are
+ *  computed with Bluestein's algorithm, which expresses the transform as a
+ *  convolution that is evaluated with power of two transforms, so every
+ *  length costs O(n log n). A plan is immutable after construction, so one
+ *  plan can be shared by many threads.
+ *
+ *  The forward transform computes X_k = sum_j x_j exp(-2 pi i j k / n), and the
+ *  inverse transform is unnormalized, so applying both multiplies by n.
+ */
+class FFTPlan
+{
+public:
+    //! Constructor
+    /*! \param n The length of the transforms.
+     */
+    explicit FFTPlan(size_t n);
+
+    //! Get the length of the transforms
+    size_t size() const
+    {
+        return m_n;
+    }
+
+    //! Compute the forward transform in place
+    /*! \param data Array of size() values.
+     */
+    void forward(std::complex<double>* data) const;
+
+    //! Compute the unnormalized inverse transform in place
+    /*! \param data Array of size() values.
+     */
+    void inverse(std::complex<double>* data) const;
+
+private:
+    //! Compute a forward transform of length m_fft_size in place
+    void radix2(std::complex<double>* data) const;
+
+    size_t m_n;        //!< Length of the transforms
+    size_t m_fft_size; //!< Length of the power of two transforms used internally
+    std::vector<size_t> m_bit_reverse;             //!< Bit reversal permutation of the radix-2 transform
+    std::vector<std::complex<double>> m_twiddles;  //!< Roots of unity of the radix-2 transform
+    std::vector<std::complex<double>> m_chirp;     //!< Bluestein chirp exp(-pi i k^2 / n)
+    std::vector<std::complex<double>> m_chirp_fft; //!< Transform of the conjugate chirp filter
+};
+
+//! Precomputed plans for multidimensional transforms of a fixed shape
+/*! The FFTPlan of each axis is built once, and axes of equal length share a
+ *  plan, so computes that transform many arrays of the same shape do not
+ *  rebuild the tables of every axis for each transform. The one dimensional
+ *  transforms along each axis are computed in parallel.
+ */
+class FFTNPlan
+{
+public:
+    //! Constructor
+    /*! \param shape The shape of the row-major arrays to transform.
+     */
+    explicit FFTNPlan(const std::vector<size_t>& shape);
+
+    //! Get the shape of the transformed arrays
+    const std::vector<size_t>& shape() const
+    {
+        return m_shape;
+    }
+
+    //! Compute the forward transform in place
+    void forward(std::complex<double>* data) const
+    {
+        transform(data, false);
+    }
+
+    //! Compute the unnormalized inverse transform in place
+    void inverse(std::complex<double>* data) const
+    {
+        transform(data, true);
+    }
+
+private:
+    //! Transform the array along every axis
+    void transform(std::complex<double>* data, bool inverse) const;
+
+    std::vector<size_t> m_shape;                         //!< Shape of the transformed arrays
+    std::vector<std::shared_ptr<const FFTPlan>> m_plans; //!< Plan of each axis
+};
+
+//! Compute the multidimensional transform of a row-major array in place
+/*! The one dimensional transforms along each axis are computed in parallel.
+ *
+ *  \param data The array to transform.
+ *  \param shape The shape of the array.
+ *  \param inverse If true, compute the unnormalized inverse transform.
+ */
+void fftn(std::complex<double>* data, const std::vector<size_t>& shape, bool inverse = false);
+
+}; }; // end namespace freud::util
+
+#endif // FFT_H
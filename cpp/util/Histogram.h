@@ -1,21 +1,44 @@
 #ifndef HISTOGRAM_H
 #define HISTOGRAM_H
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#include <chrono>
 #include <sstream>
 #include <tbb/enumerable_thread_specific.h>
-#include <utility>
+#include <tbb/task_arena.h>
 
 #include "ManagedArray.h"
+#include "ThreadStorage.h"
 #include "utils.h"
 
 namespace freud { namespace util {
 
+//! Strategies for accumulating a histogram from many threads.
+enum class AccumulationStrategy
+{
+    automatic, //!< Choose a strategy from the number of bins and the expected number of values.
+    dense,     //!< Dense thread local copies of the histogram, reduced at the end.
+    atomic,    //!< A single shared histogram incremented atomically (integer counts only).
+    tiled,     //!< Thread local copies of the histogram allocated lazily in tiles.
+};
+
+//! Precisions of the bin counts of a histogram accumulated over many frames.
+enum class CountPrecision
+{
+    uint32, //!< Counts of all frames are accumulated in 32 bit unsigned integers.
+    uint64, //!< Counts of each frame are added to 64 bit unsigned integer totals.
+};
+
 //! Weight to add to a histogram.
 /*! For histograms that are not simple counts, a Weight instance may be passed
  * in to indicate what value should be added to a bin. If not provided,
@@ -172,6 +195,105 @@ protected:
     float m_inverse_bin_width; //!< Inverse of bin width
 };
 
+//! Table binning squared values along an axis without taking their square roots.
+/*! Bins of distances are found much faster from squared distances, since
+ * neighbor queries compare squared distances to the cutoff and would
+ * otherwise take a square root per bond. For every bin edge of the axis, the
+ * table holds the smallest float whose square root the axis bins at or
+ * beyond the edge, so binning a squared value reduces to counting the edges
+ * that it reaches. Because std::sqrt is correctly rounded and the axis bins
+ * values monotonically, each squared value is binned exactly as the axis
+ * bins its square root, including values next to the edges. The squared
+ * distance of a bond of known distance d is d * d, whose square root is d
+ * again, so bonds of known distance are binned exactly as well.
+ */
+class SquaredBinTable
+{
+public:
+    SquaredBinTable() = default;
+
+    //! Precompute the edges of the squares of the values binned by an axis.
+    explicit SquaredBinTable(const Axis& axis) : m_nbins(axis.size()), m_edges(axis.size() + 1)
+    {
+        // The position of a value past the edges of the axis: 0 below the
+        // first bin, bin + 1 within the axis, and nbins + 1 above it.
+        const auto position = [&axis](float value_sq) {
+            const float value = std::sqrt(value_sq);
+            const size_t bin = axis.bin(value);
+            if (bin != Axis::OVERFLOW_BIN)
+            {
+                return bin + 1;
+            }
+            return value < axis.getMin() ? size_t(0) : axis.size() + 1;
+        };
+
+        // Non-negative floats are ordered like their bit patterns, so each
+        // edge is found by bisecting the bits between zero and infinity.
+        const std::uint32_t infinity_bits = 0x7f800000;
+        for (size_t edge = 0; edge <= m_nbins; ++edge)
+        {
+            std::uint32_t low = 0;
+            std::uint32_t high = infinity_bits;
+            while (low < high)
+            {
+                const std::uint32_t middle = low + (high - low) / 2;
+                if (position(fromBits(middle)) > edge)
+                {
+                    high = middle;
+                }
+                else
+                {
+                    low = middle + 1;
+                }
+            }
+            m_edges[edge] = fromBits(low);
+        }
+    }
+
+    //! Return the number of bins.
+    size_t size() const
+    {
+        return m_nbins;
+    }
+
+    //! Find the bin of the square root of a value.
+    /*! The edges reached by the value are counted with a binary search
+     * whose number of steps only depends on the number of bins and whose
+     * steps select the next interval without branching, so the loop is
+     * never mispredicted.
+     *
+     * \param value_sq The squared value to bin
+     *
+     * \return The index of the bin the square root of the value falls into,
+     *         or Axis::OVERFLOW_BIN if it is outside of the axis.
+     */
+    size_t bin(float value_sq) const
+    {
+        const float* base = m_edges.data();
+        size_t n = m_edges.size();
+        while (n > 1)
+        {
+            const size_t half = n / 2;
+            base = (base[half] <= value_sq) ? base + half : base;
+            n -= half;
+        }
+        // The number of edges reached, minus one, wraps below the first bin.
+        const size_t bin = static_cast<size_t>(base - m_edges.data()) + (*base <= value_sq ? 1 : 0) - 1;
+        return bin < m_nbins ? bin : Axis::OVERFLOW_BIN;
+    }
+
+private:
+    static float fromBits(std::uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    size_t m_nbins {0};         //!< Number of bins
+    std::vector<float> m_edges; //!< Smallest squared value reaching each bin edge
+};
+
 //! An n-dimensional histogram class.
 /*! The Histogram is designed to simplify the most common use of histograms in
  * C++ code, which is looping over a series of values and then binning them. To
@@ -185,29 +307,37 @@ protected:
 template<typename T> class Histogram
 {
 public:
+    using Axes = std::vector<std::shared_ptr<Axis>>;
+    using AxisIterator = Axes::const_iterator;
+
     //! A container for thread-local copies of a provided histogram.
     /*! This container implements the simplest method of enabling parallel-safe
      * accumulation, namely the creation of separate instances on each thread.
      * Thread local histograms can be accumulated later using the
      * reduceOverThreads functions in the Histogram class.
      *
-     * To simplify the implementation and avoid unnecessary copies, the thread
-     * local copies all share the same axes (because the axes are stored as
-     * arrays of shared_ptrs in the Histogram class). This should cause no
-     * problems, but can be refactored if needed.
+     * The values are binned using the axes of the provided histogram, which
+     * are shared with it (because the axes are stored as arrays of
+     * shared_ptrs in the Histogram class), and the bin counts of each thread
+     * are stored in a ThreadStorage. The Array template parameter selects the
+     * ThreadStorage policy: the DenseThreadLocalHistogram is best for small
+     * histograms, while the TiledThreadLocalHistogram only allocates, resets
+     * and reduces the tiles of bins that each thread actually touched, which
+     * is much cheaper for histograms with many bins that are mostly empty.
+     * The ThreadLocalHistogram chooses between them at runtime.
      */
-    class ThreadLocalHistogram
+    template<typename Array> class BasicThreadLocalHistogram
     {
     public:
-        ThreadLocalHistogram() = default;
+        BasicThreadLocalHistogram() = default;
 
-        explicit ThreadLocalHistogram(const Histogram& histogram)
-            : m_local_histograms([histogram]() { return Histogram(histogram.m_axes); })
+        explicit BasicThreadLocalHistogram(const Histogram& histogram)
+            : m_axes(histogram.m_axes), m_local_histograms(histogram.shape())
         {}
 
-        using const_iterator = typename tbb::enumerable_thread_specific<Histogram<T>>::const_iterator;
-        using iterator = typename tbb::enumerable_thread_specific<Histogram>::iterator;
-        using reference = typename tbb::enumerable_thread_specific<Histogram>::reference;
+        using const_iterator = typename ThreadStorage<T, Array>::const_iterator;
+        using iterator = typename ThreadStorage<T, Array>::iterator;
+        using reference = typename ThreadStorage<T, Array>::reference;
 
         const_iterator begin() const
         {
@@ -236,46 +366,290 @@ public:
 
         void reset()
         {
-            for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
-            {
-                hist->reset();
-            }
+            m_local_histograms.reset();
         }
 
-        //! Dispatch to thread local histogram.
+        //! Bin value and update the thread local bin count.
         template<typename... FloatsOrWeight> void operator()(FloatsOrWeight... values)
         {
-            m_local_histograms.local()(values...);
+            std::pair<std::vector<float>, Weight<T>> value_vector = getValueVector(values...);
+            increment(Histogram::bin(m_axes, value_vector.first), value_vector.second.value);
         }
 
-        //! Dispatch to thread local histogram.
+        //! Increment specified linear bin of the thread local histogram.
         void increment(size_t value_bin, T weight = 1)
         {
-            m_local_histograms.local().increment(value_bin, weight);
+            // Check for sentinel to avoid overflow.
+            if (value_bin != Axis::OVERFLOW_BIN)
+            {
+                m_local_histograms.local()[value_bin] += weight;
+            }
         }
 
         // Reduce over histograms into the result array.
         void reduceInto(ManagedArray<T>& result)
         {
             result.reset();
-            util::forLoopWrapper(0, result.size(), [=, &result](size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i)
+            m_local_histograms.reduceInto(result);
+        }
+
+        //! Get the wall time in seconds taken by the most recent reduction.
+        double getReduceTime() const
+        {
+            return m_local_histograms.getReduceTime();
+        }
+
+    protected:
+        Axes m_axes;                                //!< The axes of the histogram.
+        ThreadStorage<T, Array> m_local_histograms; //!< The thread-local bin counts.
+    };
+
+    //! Thread local histograms stored as dense arrays.
+    using DenseThreadLocalHistogram = BasicThreadLocalHistogram<ManagedArray<T>>;
+
+    //! Thread local histograms stored as lazily allocated tiles.
+    using TiledThreadLocalHistogram = BasicThreadLocalHistogram<TiledArray<T>>;
+
+    //! A container for accumulating a histogram from many threads with a strategy chosen at runtime.
+    /*! Dense thread local copies are the fastest way to accumulate into small
+     * histograms, but for histograms with many bins and comparatively few
+     * values, allocating, zeroing and reducing one full copy per thread
+     * dominates. Such histograms are better accumulated into lazily allocated
+     * tiles, or, when the values are so few that they rarely land in the same
+     * bin, directly into one shared histogram with atomic increments.
+     *
+     * The strategy defaults to dense and may only be changed while the
+     * container is empty, i.e. before the first value after a reset.
+     */
+    class ThreadLocalHistogram
+    {
+    public:
+        ThreadLocalHistogram() = default;
+
+        explicit ThreadLocalHistogram(const Histogram& histogram)
+            : m_axes(histogram.m_axes), m_size(histogram.size()), m_dense(histogram), m_tiled(histogram)
+        {}
+
+        //! Get the strategy used to accumulate values.
+        AccumulationStrategy getStrategy() const
+        {
+            return m_strategy;
+        }
+
+        //! Set the strategy used to accumulate values.
+        /*! \param strategy Any strategy except automatic. The atomic strategy
+         *         requires integer counts.
+         */
+        void setStrategy(AccumulationStrategy strategy)
+        {
+            if (strategy == AccumulationStrategy::automatic)
+            {
+                throw std::invalid_argument("A specific accumulation strategy must be set.");
+            }
+            if (strategy == AccumulationStrategy::atomic)
+            {
+                if (!std::is_integral<T>::value)
+                {
+                    throw std::invalid_argument(
+                        "The atomic accumulation strategy requires a histogram of integer counts.");
+                }
+                if (!m_atomic_counts || m_atomic_counts->size() != m_size)
                 {
-                    for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
+                    m_atomic_counts = std::make_shared<std::vector<std::atomic<T>>>(m_size);
+                }
+            }
+            m_strategy = strategy;
+        }
+
+        //! Choose an accumulation strategy.
+        /*! Dense thread local copies are used whenever there are enough values
+         * that reducing the copies costs less than binning the values.
+         * Otherwise, a shared histogram is incremented atomically if there are
+         * fewer values than bins, so that contention is rare, and tiles are
+         * used for the remaining cases (and for non-integer histograms).
+         *
+         * \param n_bins The number of bins of the histogram.
+         * \param n_values The expected number of values to accumulate.
+         * \param n_threads The number of threads accumulating values.
+         */
+        static AccumulationStrategy chooseStrategy(size_t n_bins, size_t n_values, size_t n_threads)
+        {
+            if (n_bins * n_threads <= n_values)
+            {
+                return AccumulationStrategy::dense;
+            }
+            if (n_values <= n_bins && std::is_integral<T>::value)
+            {
+                return AccumulationStrategy::atomic;
+            }
+            return AccumulationStrategy::tiled;
+        }
+
+        //! Choose an accumulation strategy for the threads of the current task arena.
+        static AccumulationStrategy chooseStrategy(size_t n_bins, size_t n_values)
+        {
+            return chooseStrategy(n_bins, n_values,
+                                  static_cast<size_t>(tbb::this_task_arena::max_concurrency()));
+        }
+
+        void reset()
+        {
+            m_dense.reset();
+            m_tiled.reset();
+            if (m_atomic_counts)
+            {
+                util::forLoopWrapper(0, m_atomic_counts->size(), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
                     {
-                        result[i] += hist->m_bin_counts[i];
+                        atomicStore((*m_atomic_counts)[i], T(0), std::is_integral<T>());
                     }
+                });
+            }
+        }
+
+        //! Bin value and update the bin count.
+        template<typename... FloatsOrWeight> void operator()(FloatsOrWeight... values)
+        {
+            std::pair<std::vector<float>, Weight<T>> value_vector = getValueVector(values...);
+            increment(Histogram::bin(m_axes, value_vector.first), value_vector.second.value);
+        }
+
+        //! Increment specified linear bin (with a specified weight if desired).
+        void increment(size_t value_bin, T weight = 1)
+        {
+            // Check for sentinel to avoid overflow.
+            if (value_bin == Axis::OVERFLOW_BIN)
+            {
+                return;
+            }
+            switch (m_strategy)
+            {
+            case AccumulationStrategy::atomic:
+                atomicAdd((*m_atomic_counts)[value_bin], weight, std::is_integral<T>());
+                break;
+            case AccumulationStrategy::tiled:
+                m_tiled.increment(value_bin, weight);
+                break;
+            default:
+                m_dense.increment(value_bin, weight);
+                break;
+            }
+        }
+
+        //! Add weights to the num_bins consecutive linear bins starting at first_bin.
+        /*! With the dense strategy, the weights are added to the thread local
+         *  bins in one loop that the compiler can vectorize.
+         */
+        void incrementBins(size_t first_bin, const T* weights, size_t num_bins)
+        {
+            // Check for sentinel to avoid overflow.
+            if (first_bin == Axis::OVERFLOW_BIN)
+            {
+                return;
+            }
+            switch (m_strategy)
+            {
+            case AccumulationStrategy::atomic:
+                for (size_t i = 0; i < num_bins; ++i)
+                {
+                    atomicAdd((*m_atomic_counts)[first_bin + i], weights[i], std::is_integral<T>());
+                }
+                break;
+            case AccumulationStrategy::tiled:
+                for (size_t i = 0; i < num_bins; ++i)
+                {
+                    m_tiled.increment(first_bin + i, weights[i]);
                 }
-            });
+                break;
+            default:
+            {
+                T* bins = &m_dense.local()[first_bin];
+                for (size_t i = 0; i < num_bins; ++i)
+                {
+                    bins[i] += weights[i];
+                }
+                break;
+            }
+            }
+        }
+
+        // Reduce over histograms into the result array.
+        void reduceInto(ManagedArray<T>& result)
+        {
+            switch (m_strategy)
+            {
+            case AccumulationStrategy::atomic:
+            {
+                const auto start = std::chrono::steady_clock::now();
+                T* result_data = result.get();
+                util::forLoopWrapper(0, result.size(), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        result_data[i] = atomicLoad((*m_atomic_counts)[i], std::is_integral<T>());
+                    }
+                });
+                m_atomic_reduce_time
+                    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                break;
+            }
+            case AccumulationStrategy::tiled:
+                m_tiled.reduceInto(result);
+                break;
+            default:
+                m_dense.reduceInto(result);
+                break;
+            }
+        }
+
+        //! Get the wall time in seconds taken by the most recent reduction.
+        double getReduceTime() const
+        {
+            switch (m_strategy)
+            {
+            case AccumulationStrategy::atomic:
+                return m_atomic_reduce_time;
+            case AccumulationStrategy::tiled:
+                return m_tiled.getReduceTime();
+            default:
+                return m_dense.getReduceTime();
+            }
         }
 
     protected:
-        tbb::enumerable_thread_specific<Histogram<T>>
-            m_local_histograms; //!< The thread-local copies of m_histogram.
-    };
+        // Atomic operations are only instantiated for integer counts, since
+        // setStrategy refuses the atomic strategy for other types.
+        static void atomicAdd(std::atomic<T>& count, T weight, std::true_type /*is_integral*/)
+        {
+            count.fetch_add(weight, std::memory_order_relaxed);
+        }
 
-    using Axes = std::vector<std::shared_ptr<Axis>>;
-    using AxisIterator = Axes::const_iterator;
+        static void atomicAdd(std::atomic<T>& /*count*/, T /*weight*/, std::false_type /*is_integral*/) {}
+
+        static void atomicStore(std::atomic<T>& count, T value, std::true_type /*is_integral*/)
+        {
+            count.store(value, std::memory_order_relaxed);
+        }
+
+        static void atomicStore(std::atomic<T>& /*count*/, T /*value*/, std::false_type /*is_integral*/) {}
+
+        static T atomicLoad(const std::atomic<T>& count, std::true_type /*is_integral*/)
+        {
+            return count.load(std::memory_order_relaxed);
+        }
+
+        static T atomicLoad(const std::atomic<T>& /*count*/, std::false_type /*is_integral*/)
+        {
+            return T(0);
+        }
+
+        Axes m_axes;       //!< The axes of the histogram.
+        size_t m_size {0}; //!< The number of bins.
+        AccumulationStrategy m_strategy {AccumulationStrategy::dense}; //!< The accumulation strategy.
+        DenseThreadLocalHistogram m_dense;                             //!< Storage of the dense strategy.
+        TiledThreadLocalHistogram m_tiled;                             //!< Storage of the tiled strategy.
+        std::shared_ptr<std::vector<std::atomic<T>>> m_atomic_counts;  //!< Storage of the atomic strategy.
+        double m_atomic_reduce_time {0}; //!< Wall time of the most recent atomic reduction in seconds.
+    };
 
     //! Default constructor
     Histogram() = default;
@@ -339,27 +713,36 @@ public:
      */
     size_t bin(std::vector<float> values) const
     {
-        if (values.size() != m_axes.size())
+        return bin(m_axes, values);
+    }
+
+    //! Find the bin of a value along a set of axes.
+    /*! The bins along each axis are combined into a linear index in row-major
+     *  order, matching the layout of the bin counts.
+     */
+    static size_t bin(const Axes& axes, const std::vector<float>& values)
+    {
+        if (values.size() != axes.size())
         {
             std::ostringstream msg;
-            msg << "This Histogram is " << m_axes.size() << "-dimensional, but " << values.size()
+            msg << "This Histogram is " << axes.size() << "-dimensional, but " << values.size()
                 << " values were provided in bin" << std::endl;
             throw std::invalid_argument(msg.str());
         }
         // First bin the values along each axis.
-        std::vector<size_t> ax_bins;
-        for (unsigned int ax_idx = 0; ax_idx < m_axes.size(); ++ax_idx)
+        size_t value_bin = 0;
+        for (unsigned int ax_idx = 0; ax_idx < axes.size(); ++ax_idx)
         {
-            size_t bin_i = m_axes[ax_idx]->bin(values[ax_idx]);
+            size_t bin_i = axes[ax_idx]->bin(values[ax_idx]);
             // Immediately return sentinel if any bin is out of bounds.
             if (bin_i == Axis::OVERFLOW_BIN)
             {
                 return Axis::OVERFLOW_BIN;
             }
-            ax_bins.push_back(bin_i);
+            value_bin = value_bin * axes[ax_idx]->size() + bin_i;
         }
 
-        return m_bin_counts.getIndex(ax_bins);
+        return value_bin;
     }
 
     //! Get the computed histogram.
@@ -436,8 +819,8 @@ public:
      * \param local_histograms The set of local histograms to reduce into this one.
      * \param cf The function to apply to each bin, must have signature (size_t i) {...}
      */
-    template<typename ComputeFunction>
-    void reduceOverThreadsPerBin(ThreadLocalHistogram& local_histograms, const ComputeFunction& cf)
+    template<typename LocalHistogram, typename ComputeFunction>
+    void reduceOverThreadsPerBin(LocalHistogram& local_histograms, const ComputeFunction& cf)
     {
         local_histograms.reduceInto(m_bin_counts);
         util::forLoopWrapper(0, m_bin_counts.size(), [=](size_t begin, size_t end) {
@@ -457,10 +840,10 @@ public:
      *
      * \param local_histograms The set of local histograms to reduce into this one.
      */
-    void reduceOverThreads(ThreadLocalHistogram& local_histograms)
+    template<typename LocalHistogram> void reduceOverThreads(LocalHistogram& local_histograms)
     {
         // Simply call the per-bin function with a nullary function.
-        reduceOverThreadsPerBin(local_histograms, [](size_t i) {});
+        reduceOverThreadsPerBin(local_histograms, [](size_t /*i*/) {});
     }
 
     //! Writeable index into array.
@@ -489,7 +872,7 @@ protected:
      * variadic templating to accept an arbitrary set of float values and
      * construct a vector out of them.
      */
-    std::pair<std::vector<float>, Weight<T>> getValueVector(float value) const
+    static std::pair<std::vector<float>, Weight<T>> getValueVector(float value)
     {
         return {{value}, Weight<T>()};
     }
@@ -499,14 +882,14 @@ protected:
      * variadic templating to accept an arbitrary set of float values and
      * construct a vector out of them.
      */
-    std::pair<std::vector<float>, Weight<T>> getValueVector(Weight<T> weight) const
+    static std::pair<std::vector<float>, Weight<T>> getValueVector(Weight<T> weight)
     {
         return {{}, weight};
     }
 
     //! The recursive case for constructing a vector of values (see base-case function docs).
     template<typename... FloatsOrWeight>
-    std::pair<std::vector<float>, Weight<T>> getValueVector(float value, FloatsOrWeight... values) const
+    static std::pair<std::vector<float>, Weight<T>> getValueVector(float value, FloatsOrWeight... values)
     {
         std::pair<std::vector<float>, Weight<T>> tmp = getValueVector(values...);
         tmp.first.insert(tmp.first.begin(), value);
@@ -515,7 +898,8 @@ protected:
 
     //! The recursive case for constructing a vector of values (see base-case function docs).
     template<typename... FloatsOrWeight>
-    std::pair<std::vector<float>, Weight<T>> getValueVector(Weight<T> weight, FloatsOrWeight... values) const
+    static std::pair<std::vector<float>, Weight<T>>
+    getValueVector(Weight<T> weight, FloatsOrWeight... values)
     {
         std::pair<std::vector<float>, Weight<T>> tmp = getValueVector(values...);
         tmp.second = weight;
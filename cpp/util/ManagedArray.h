@@ -1,13 +1,18 @@
 #ifndef MANAGED_ARRAY_H
 #define MANAGED_ARRAY_H
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <memory>
 #include <numeric>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#include "BufferPool.h"
+#include "utils.h"
+
 /*! \file ManagedArray.h
     \brief Defines the standard array class to be used throughout freud.
 */
@@ -34,6 +39,11 @@ namespace freud { namespace util {
  *  the original array alive if the original ManagedArray instances become
  *  decoupled from it.
  *
+ *  The data is allocated from the shared BufferPool and returned to it when
+ *  the last reference to it is released, so repeatedly preparing arrays of
+ *  the same size recycles memory instead of allocating it again. Elements are
+ *  treated as plain data that is never constructed or destroyed.
+ *
  *  Performance notes:
  *      1. The variadic indexers may be a bottleneck if used in
  *         performance-critical code paths. In such cases, directly calling the
@@ -44,16 +54,22 @@ namespace freud { namespace util {
  */
 template<typename T> class ManagedArray
 {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ManagedArray elements are released without being destroyed.");
+
 public:
     //! Constructor based on a shape tuple.
     /*! Including a default value for the shape allows the usage of this
-     *  constructor as the default constructor.
+     *  constructor as the default constructor. The array is zeroed by the
+     *  constructing thread, so the memory of thread local arrays is placed
+     *  near the thread that owns them.
      *
      *  \param shape Shape of the array to allocate.
      */
     ManagedArray(const std::vector<size_t>& shape = {0})
     {
-        prepare(shape, true);
+        reallocate(shape);
+        reset(false);
     }
 
     //! Constructor based on a shape tuple.
@@ -67,6 +83,25 @@ public:
     //! Destructor (currently empty because data is managed by shared pointer).
     ~ManagedArray() = default;
 
+    //! Create an array referencing memory owned by another object, without copying it.
+    /*! The array and all copies of it keep the owner alive. This is used to
+     *  expose memory that is not allocated from the BufferPool, such as
+     *  memory mapped files, through the usual ManagedArray interface.
+     *
+     *  \param data Pointer to the first element.
+     *  \param shape Shape of the array.
+     *  \param owner Object that keeps the memory valid while it is alive.
+     */
+    static ManagedArray wrap(T* data, const std::vector<size_t>& shape, std::shared_ptr<void> owner)
+    {
+        ManagedArray array;
+        array.m_shape = std::make_shared<std::vector<size_t>>(shape);
+        array.m_size = std::make_shared<size_t>(
+            std::accumulate(shape.cbegin(), shape.cend(), size_t(1), std::multiplies<>()));
+        array.m_data = std::make_shared<std::shared_ptr<T>>(std::move(owner), data);
+        return array;
+    }
+
     //! Simple convenience for 1D arrays that calls through to the shape based `prepare` function.
     /*! \param new_size Size of the 1D array to allocate.
      */
@@ -90,32 +125,64 @@ public:
         // reset.
         if (force || (m_data.use_count() > 1) || (new_shape != shape()))
         {
-            m_shape = std::make_shared<std::vector<size_t>>(new_shape);
+            reallocate(new_shape);
+        }
+        reset();
+    }
 
-            m_size = std::make_shared<size_t>(1);
-            for (unsigned int i = m_shape->size() - 1; i != static_cast<unsigned int>(-1); --i)
-            {
-                (*m_size) *= (*m_shape)[i];
-            }
+    //! Simple convenience for 1D arrays that calls through to the shape based `prepareUninitialized`
+    //! function.
+    /*! \param new_size Size of the 1D array to allocate.
+     */
+    void prepareUninitialized(size_t new_size)
+    {
+        prepareUninitialized(std::vector<size_t> {new_size});
+    }
 
-            // We make use of C-style arrays here rather than any alternative
-            // because we need the underlying data representation to be
-            // compatible with numpy on the Python side. We _could_ do this
-            // with a different data structure like std::vector, but it would
-            // require writing additional gymnastics to ensure proper reference
-            // management and should be carefully considered before any rewrite.
-            m_data = std::shared_ptr<std::shared_ptr<T>>(new std::shared_ptr<T>(
-                new T[size()], std::default_delete<T[]>())); // NOLINT(modernize-avoid-c-arrays)
+    //! Prepare for writing new data that overwrites every element.
+    /*! This function reallocates under the same conditions as prepare, but
+     * leaves the contents of the array unspecified instead of resetting them
+     * to zero. It must only be used by computes that write every element of
+     * the array before it is read, in which case it saves a full pass over
+     * the memory of the array.
+     *
+     *  \param new_shape Shape of the array to allocate.
+     */
+    void prepareUninitialized(const std::vector<size_t>& new_shape)
+    {
+        if ((m_data.use_count() > 1) || (new_shape != shape()))
+        {
+            reallocate(new_shape);
         }
-        reset();
     }
 
     //! Reset the contents of array to be 0.
-    void reset()
+    /*! Large arrays are cleared in parallel by default, so that on first use
+     * their pages are placed in the memory of the threads that will likely
+     * write to them.
+     *
+     *  \param parallel If false, clear the array on the calling thread only.
+     */
+    void reset(bool parallel = true)
     {
-        if (size() != 0)
+        // Arrays of at least this many bytes are cleared in parallel, in blocks of reset_block_bytes.
+        constexpr size_t parallel_reset_bytes = size_t(1) << 20;
+        constexpr size_t reset_block_bytes = size_t(1) << 16;
+
+        const size_t bytes = sizeof(T) * size();
+        auto* data = reinterpret_cast<char*>(get());
+        if (parallel && bytes >= parallel_reset_bytes)
         {
-            memset((void*) get(), 0, sizeof(T) * size());
+            const size_t num_blocks = (bytes + reset_block_bytes - 1) / reset_block_bytes;
+            forLoopWrapper(0, num_blocks, [=](size_t begin, size_t end) {
+                const size_t first = begin * reset_block_bytes;
+                const size_t last = std::min(bytes, end * reset_block_bytes);
+                memset(data + first, 0, last - first);
+            });
+        }
+        else if (bytes != 0)
+        {
+            memset(data, 0, bytes);
         }
     }
 
@@ -344,6 +411,35 @@ public:
     }
 
 private:
+    //! Allocate new data with the given shape, leaving its contents unspecified.
+    /*! The previous data remains valid for any other ManagedArray referencing it.
+     *
+     *  \param new_shape Shape of the array to allocate.
+     */
+    void reallocate(const std::vector<size_t>& new_shape)
+    {
+        m_shape = std::make_shared<std::vector<size_t>>(new_shape);
+
+        m_size = std::make_shared<size_t>(1);
+        for (unsigned int i = m_shape->size() - 1; i != static_cast<unsigned int>(-1); --i)
+        {
+            (*m_size) *= (*m_shape)[i];
+        }
+
+        // We make use of C-style arrays here rather than any alternative
+        // because we need the underlying data representation to be
+        // compatible with numpy on the Python side. We _could_ do this
+        // with a different data structure like std::vector, but it would
+        // require writing additional gymnastics to ensure proper reference
+        // management and should be carefully considered before any rewrite.
+        // The buffer goes back to the pool once every ManagedArray and
+        // numpy array referencing it is gone.
+        const size_t bytes = sizeof(T) * size();
+        m_data = std::make_shared<std::shared_ptr<T>>(
+            static_cast<T*>(BufferPool::instance().allocate(bytes)),
+            [bytes](T* data) { BufferPool::instance().deallocate(data, bytes); });
+    }
+
     //! The base case for building up the index.
     /*! These argument building functions are templated on two types, one that
      *  encapsulates the current object being operated on and the other being
@@ -0,0 +1,154 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cstring>
+#include <sstream>
+
+#include "Profiler.h"
+
+/*! \file Profiler.cc
+    \brief Opt-in timers and counters for the hot paths of computes.
+*/
+
+namespace freud { namespace util {
+
+namespace {
+
+//! The profile the instrumentation points of this thread record into
+thread_local Profile* active_profile = nullptr;
+
+//! Write a string as a JSON string literal.
+void writeJsonString(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (const char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+}; // end anonymous namespace
+
+Profile::Profile()
+    : m_records([this]() {
+          ThreadRecord record;
+          record.thread_id = m_num_threads++;
+          return record;
+      })
+{
+    // Fix the clock origin before any event can be recorded.
+    getProfileClockOrigin();
+}
+
+ProfileEntry& Profile::findEntry(ThreadRecord& record, const char* name)
+{
+    // Names are string literals, so the same name almost always has the
+    // same address and the string comparison is rarely needed.
+    for (auto& entry : record.entries)
+    {
+        if (entry.first == name || std::strcmp(entry.first, name) == 0)
+        {
+            return entry.second;
+        }
+    }
+    record.entries.emplace_back(name, ProfileEntry());
+    return record.entries.back().second;
+}
+
+void Profile::addTime(const char* name, clock::time_point start, clock::time_point end, bool trace)
+{
+    ThreadRecord& record = m_records.local();
+    ProfileEntry& entry = findEntry(record, name);
+    const std::chrono::duration<double> elapsed = end - start;
+    ++entry.calls;
+    entry.seconds += elapsed.count();
+    if (trace && record.events.size() < MAX_EVENTS_PER_THREAD)
+    {
+        const std::chrono::duration<double, std::micro> offset = start - getProfileClockOrigin();
+        record.events.push_back({name, offset.count(), elapsed.count() * 1e6});
+    }
+}
+
+void Profile::addCount(const char* name, size_t count)
+{
+    ProfileEntry& entry = findEntry(m_records.local(), name);
+    ++entry.calls;
+    entry.count += count;
+}
+
+std::map<std::string, ProfileEntry> Profile::getEntries() const
+{
+    std::map<std::string, ProfileEntry> entries;
+    for (const auto& record : m_records)
+    {
+        for (const auto& entry : record.entries)
+        {
+            ProfileEntry& merged = entries[entry.first];
+            merged.calls += entry.second.calls;
+            merged.seconds += entry.second.seconds;
+            merged.count += entry.second.count;
+        }
+    }
+    return entries;
+}
+
+std::string Profile::getChromeTrace(int pid) const
+{
+    std::ostringstream out;
+    out.precision(15);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& record : m_records)
+    {
+        for (const auto& event : record.events)
+        {
+            out << (first ? "" : ",") << "\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":\"freud\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                << ",\"pid\":" << pid << ",\"tid\":" << record.thread_id << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+void Profile::reset()
+{
+    m_records.clear();
+    m_num_threads = 0;
+}
+
+bool isProfilingAvailable()
+{
+#ifdef FREUD_ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+Profile* getActiveProfile()
+{
+    return active_profile;
+}
+
+Profile* setActiveProfile(Profile* profile)
+{
+    Profile* previous = active_profile;
+    active_profile = profile;
+    return previous;
+}
+
+Profile::clock::time_point getProfileClockOrigin()
+{
+    static const Profile::clock::time_point origin = Profile::clock::now();
+    return origin;
+}
+
+}; }; // end namespace freud::util
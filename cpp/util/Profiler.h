@@ -0,0 +1,211 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <tbb/enumerable_thread_specific.h>
+#include <utility>
+#include <vector>
+
+/*! \file Profiler.h
+    \brief Opt-in timers and counters for the hot paths of computes.
+
+    Instrumentation points use the FREUD_PROFILE_SCOPE, FREUD_PROFILE_FINE_SCOPE
+    and FREUD_PROFILE_COUNT macros, which expand to nothing unless freud is built with
+    FREUD_ENABLE_PROFILING defined (the ENABLE_PROFILING CMake option). When
+    built in, they record into the active Profile of the calling thread, if
+    any, so they only cost a thread local load while no profile is active.
+*/
+
+namespace freud { namespace util {
+
+//! Accumulated measurements of one timer or counter.
+struct ProfileEntry
+{
+    size_t calls {0};   //!< Number of timed scopes or counter increments
+    double seconds {0}; //!< Total wall time of the timed scopes
+    size_t count {0};   //!< Sum of the counter increments
+};
+
+//! A timed scope recorded for a trace.
+struct ProfileEvent
+{
+    const char* name; //!< Name of the timer
+    double start;     //!< Start time in microseconds since the profiling clock origin
+    double duration;  //!< Duration in microseconds
+};
+
+//! Timers and counters of one compute object.
+/*! Each thread records into its own storage, so recording does not need any
+ *  synchronization. Reading the measurements merges the storage of all
+ *  threads and must not happen concurrently with recording.
+ */
+class Profile
+{
+public:
+    using clock = std::chrono::steady_clock; //!< Clock of all timers
+
+    //! Maximum number of events kept per thread for traces
+    static constexpr size_t MAX_EVENTS_PER_THREAD = size_t(1) << 16;
+
+    //! Constructor
+    Profile();
+
+    Profile(const Profile&) = delete;
+    Profile& operator=(const Profile&) = delete;
+
+    //! Record a timed scope of the calling thread.
+    /*! \param name Name of the timer.
+     *  \param start Start of the scope.
+     *  \param end End of the scope.
+     *  \param trace Whether to also keep the scope as an event for traces.
+     */
+    void addTime(const char* name, clock::time_point start, clock::time_point end, bool trace = true);
+
+    //! Add to a counter of the calling thread.
+    void addCount(const char* name, size_t count);
+
+    //! Get the measurements merged over all threads, by name.
+    std::map<std::string, ProfileEntry> getEntries() const;
+
+    //! Get the recorded events in the Chrome trace event JSON format.
+    /*! \param pid Process id written to the events, which lets traces of
+     *         several computes be shown side by side.
+     */
+    std::string getChromeTrace(int pid = 0) const;
+
+    //! Discard all measurements.
+    void reset();
+
+private:
+    //! Measurements of one thread.
+    struct ThreadRecord
+    {
+        unsigned int thread_id {0};                                //!< Index of the thread in the trace
+        std::vector<std::pair<const char*, ProfileEntry>> entries; //!< Measurements by name
+        std::vector<ProfileEvent> events;                          //!< Timed scopes for the trace
+    };
+
+    //! Get the entry of a name in the record of the calling thread.
+    static ProfileEntry& findEntry(ThreadRecord& record, const char* name);
+
+    std::atomic<unsigned int> m_num_threads {0};             //!< Number of threads that recorded
+    tbb::enumerable_thread_specific<ThreadRecord> m_records; //!< Measurements of each thread
+};
+
+//! Check whether freud was built with the instrumentation points.
+bool isProfilingAvailable();
+
+//! Get the profile the instrumentation points of the calling thread record into.
+Profile* getActiveProfile();
+
+//! Set the profile the instrumentation points of the calling thread record into.
+/*! \param profile The profile, or nullptr to stop recording.
+ *  \returns The previously active profile.
+ */
+Profile* setActiveProfile(Profile* profile);
+
+//! Get the origin of the times of all trace events.
+Profile::clock::time_point getProfileClockOrigin();
+
+//! Activates a profile on the calling thread for the lifetime of this object.
+class ProfileScope
+{
+public:
+    //! Constructor
+    /*! \param profile The profile to activate, or nullptr to stop recording.
+     */
+    explicit ProfileScope(Profile* profile) : m_previous(setActiveProfile(profile)) {}
+
+    //! Destructor, restores the previously active profile.
+    ~ProfileScope()
+    {
+        setActiveProfile(m_previous);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profile* m_previous; //!< Profile active before this scope
+};
+
+//! Records the wall time of its lifetime into the active profile.
+class ScopedTimer
+{
+public:
+    //! Constructor
+    /*! \param name Name of the timer, which must outlive the profile.
+     *  \param trace Whether to keep the scope as an event for traces, which
+     *         is best avoided for scopes entered once per point or bond.
+     */
+    explicit ScopedTimer(const char* name, bool trace = true)
+        : m_name(name), m_profile(getActiveProfile()), m_trace(trace)
+    {
+        if (m_profile != nullptr)
+        {
+            m_start = Profile::clock::now();
+        }
+    }
+
+    //! Destructor, records the elapsed time.
+    ~ScopedTimer()
+    {
+        if (m_profile != nullptr)
+        {
+            m_profile->addTime(m_name, m_start, Profile::clock::now(), m_trace);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* m_name;                 //!< Name of the timer
+    Profile* m_profile;                 //!< Profile to record into, or nullptr
+    bool m_trace;                       //!< Whether to keep the scope for traces
+    Profile::clock::time_point m_start; //!< Start of the timed scope
+};
+
+//! Add to a counter of the active profile, if any.
+inline void addProfileCount(const char* name, size_t count)
+{
+    Profile* profile = getActiveProfile();
+    if (profile != nullptr)
+    {
+        profile->addCount(name, count);
+    }
+}
+
+}; }; // end namespace freud::util
+
+#define FREUD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FREUD_PROFILE_CONCAT(a, b) FREUD_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef FREUD_ENABLE_PROFILING
+//! Time the rest of the enclosing scope.
+#define FREUD_PROFILE_SCOPE(name) \
+    const ::freud::util::ScopedTimer FREUD_PROFILE_CONCAT(freud_profile_timer_, __LINE__)(name)
+//! Time the rest of the enclosing scope without keeping it for traces.
+#define FREUD_PROFILE_FINE_SCOPE(name) \
+    const ::freud::util::ScopedTimer FREUD_PROFILE_CONCAT(freud_profile_timer_, __LINE__)(name, false)
+//! Add to a counter.
+#define FREUD_PROFILE_COUNT(name, count) ::freud::util::addProfileCount(name, count)
+//! Record into the active profile of the calling thread inside a parallel loop.
+#define FREUD_PROFILE_CAPTURE(var) ::freud::util::Profile* var = ::freud::util::getActiveProfile()
+#define FREUD_PROFILE_ACTIVATE(var) \
+    const ::freud::util::ProfileScope FREUD_PROFILE_CONCAT(freud_profile_scope_, __LINE__)(var)
+#else
+#define FREUD_PROFILE_SCOPE(name)
+#define FREUD_PROFILE_FINE_SCOPE(name)
+#define FREUD_PROFILE_COUNT(name, count)
+#define FREUD_PROFILE_CAPTURE(var)
+#define FREUD_PROFILE_ACTIVATE(var)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,95 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef RAGGED_ARRAY_H
+#define RAGGED_ARRAY_H
+
+#include <numeric>
+#include <vector>
+
+#include "ManagedArray.h"
+
+/*! \file RaggedArray.h
+    \brief Defines the array class used for outputs with a variable number of values per element.
+*/
+
+namespace freud { namespace util {
+
+//! Stores a sequence of segments with different numbers of values.
+/*! The values of all segments are stored contiguously in a single
+ *  ManagedArray, and a second ManagedArray holds the offset of the first value
+ *  of each segment, followed by the total number of values. The values of
+ *  segment i are therefore found between offsets i and i + 1. This layout
+ *  needs only two allocations regardless of the number of segments, and both
+ *  arrays can be shared with NumPy without copying, like any other
+ *  ManagedArray.
+ */
+template<typename T> class RaggedArray
+{
+public:
+    //! Constructor for an array without any segments.
+    RaggedArray() : m_offsets(1) {}
+
+    //! Prepare for writing new data.
+    /*! The offsets are computed from the sizes of the segments, and the values
+     *  are reset to zero.
+     *
+     *  \param sizes Number of values of each segment.
+     */
+    template<typename Int> void prepare(const std::vector<Int>& sizes)
+    {
+        m_offsets.prepare(sizes.size() + 1);
+        std::partial_sum(sizes.begin(), sizes.end(), m_offsets.get() + 1);
+        m_values.prepare(m_offsets[sizes.size()]);
+    }
+
+    //! Get the number of segments.
+    size_t getNumSegments() const
+    {
+        return m_offsets.size() - 1;
+    }
+
+    //! Get the total number of values of all segments.
+    size_t getNumValues() const
+    {
+        return m_values.size();
+    }
+
+    //! Get the number of values of a segment.
+    size_t getSegmentSize(size_t segment) const
+    {
+        return m_offsets[segment + 1] - m_offsets[segment];
+    }
+
+    //! Get a pointer to the first value of a segment.
+    T* getSegment(size_t segment)
+    {
+        return m_values.get() + m_offsets[segment];
+    }
+
+    //! Get a constant pointer to the first value of a segment.
+    const T* getSegment(size_t segment) const
+    {
+        return m_values.get() + m_offsets[segment];
+    }
+
+    //! Get a reference to the offsets of the segments.
+    const ManagedArray<unsigned int>& getOffsets() const
+    {
+        return m_offsets;
+    }
+
+    //! Get a reference to the values of all segments.
+    const ManagedArray<T>& getValues() const
+    {
+        return m_values;
+    }
+
+private:
+    ManagedArray<unsigned int> m_offsets; //!< Offset of each segment, followed by the number of values
+    ManagedArray<T> m_values;             //!< Values of all segments
+};
+
+}; }; // end namespace freud::util
+
+#endif // RAGGED_ARRAY_H
@@ -0,0 +1,143 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SMALL_TENSOR_H
+#define SMALL_TENSOR_H
+
+#include <array>
+#include <cstddef>
+
+/*! \file SmallTensor.h
+    \brief Defines a fixed-size tensor for small per-element temporaries.
+*/
+
+namespace freud { namespace util {
+
+namespace detail {
+
+//! Product of a list of sizes
+template<size_t... Dims> struct ShapeSize;
+
+template<> struct ShapeSize<>
+{
+    static constexpr size_t value = 1;
+};
+
+template<size_t Dim, size_t... Dims> struct ShapeSize<Dim, Dims...>
+{
+    static constexpr size_t value = Dim * ShapeSize<Dims...>::value;
+};
+
+}; // end namespace detail
+
+//! A tensor whose shape is known at compile time.
+/*! ManagedArray allocates its data and shape on the heap, which is wasteful
+ *  for the small tensors that are created for every particle or bond inside
+ *  parallel loops. The values of a SmallTensor live inside the object, so it
+ *  can be created on the stack, and the linear index of an element is
+ *  computed from the constant shape. The values are stored in row-major
+ *  order, matching a ManagedArray of the same shape, and are zero
+ *  initialized.
+ */
+template<typename T, size_t... Dims> class SmallTensor
+{
+public:
+    static constexpr size_t ndim = sizeof...(Dims);                  //!< Number of dimensions
+    static constexpr size_t size = detail::ShapeSize<Dims...>::value; //!< Number of elements
+
+    static_assert(ndim > 0, "A SmallTensor must have at least one dimension.");
+
+    //! Writeable index into the flattened tensor.
+    T& operator[](size_t index)
+    {
+        return m_data[index];
+    }
+
+    //! Read-only index into the flattened tensor.
+    const T& operator[](size_t index) const
+    {
+        return m_data[index];
+    }
+
+    //! Writeable index into the tensor by one index per dimension.
+    template<typename... Ints> T& operator()(Ints... indices)
+    {
+        return m_data[getIndex(indices...)];
+    }
+
+    //! Read-only index into the tensor by one index per dimension.
+    template<typename... Ints> const T& operator()(Ints... indices) const
+    {
+        return m_data[getIndex(indices...)];
+    }
+
+    //! Get the linear index of the element with one index per dimension.
+    template<typename... Ints> static size_t getIndex(Ints... indices)
+    {
+        static_assert(sizeof...(Ints) == ndim, "The number of indices must match the number of dimensions.");
+        const std::array<size_t, ndim> shape {Dims...};
+        const std::array<size_t, ndim> index {static_cast<size_t>(indices)...};
+        size_t idx = 0;
+        for (size_t i = 0; i < ndim; ++i)
+        {
+            idx = idx * shape[i] + index[i];
+        }
+        return idx;
+    }
+
+    //! Get a pointer to the first element.
+    T* data()
+    {
+        return m_data.data();
+    }
+
+    //! Get a constant pointer to the first element.
+    const T* data() const
+    {
+        return m_data.data();
+    }
+
+    //! Set all elements to a value.
+    void fill(const T& value)
+    {
+        m_data.fill(value);
+    }
+
+    //! Add another tensor of the same shape elementwise.
+    SmallTensor& operator+=(const SmallTensor& other)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_data[i] += other.m_data[i];
+        }
+        return *this;
+    }
+
+    //! Iterators over the flattened tensor.
+    typename std::array<T, size>::iterator begin()
+    {
+        return m_data.begin();
+    }
+
+    typename std::array<T, size>::iterator end()
+    {
+        return m_data.end();
+    }
+
+    typename std::array<T, size>::const_iterator begin() const
+    {
+        return m_data.begin();
+    }
+
+    typename std::array<T, size>::const_iterator end() const
+    {
+        return m_data.end();
+    }
+
+private:
+    std::array<T, size> m_data {}; //!< The elements in row-major order
+};
+
+}; }; // end namespace freud::util
+
+#endif // SMALL_TENSOR_H
@@ -0,0 +1,238 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "SphericalHarmonics.h"
+
+/*! \file SphericalHarmonics.cc
+    \brief Batched evaluation of spherical harmonics for the bonds of a point.
+*/
+
+namespace freud { namespace util {
+
+SphericalHarmonicsEvaluator::SphericalHarmonicsEvaluator(unsigned int l_max)
+    : m_l_max(l_max), m_diagonal(l_max + 1), m_first(l_max + 1), m_a(sphCount(l_max)), m_b(sphCount(l_max))
+{
+    // The normalized associated Legendre functions
+    // P_l^m = sqrt((2l + 1) / (4 pi) (l - m)! / (l + m)!) P_lm
+    // follow from the recurrences
+    // P_m^m = sqrt((2m + 1) / (2m)) sin(theta) P_{m-1}^{m-1},
+    // P_{m+1}^m = sqrt(2m + 3) cos(theta) P_m^m, and
+    // P_l^m = a_lm (cos(theta) P_{l-1}^m - b_lm P_{l-2}^m).
+    m_diagonal[0] = static_cast<float>(1.0 / std::sqrt(4 * M_PI));
+    for (unsigned int m = 0; m <= l_max; ++m)
+    {
+        const auto dm = static_cast<double>(m);
+        if (m > 0)
+        {
+            m_diagonal[m] = static_cast<float>(std::sqrt((2 * dm + 1) / (2 * dm)));
+        }
+        m_first[m] = static_cast<float>(std::sqrt(2 * dm + 3));
+        for (unsigned int l = m + 2; l <= l_max; ++l)
+        {
+            const auto dl = static_cast<double>(l);
+            m_a[sphIndex(l, m)] = static_cast<float>(std::sqrt((4 * dl * dl - 1) / (dl * dl - dm * dm)));
+            m_b[sphIndex(l, m)] = static_cast<float>(
+                std::sqrt(((dl - 1) * (dl - 1) - dm * dm) / (4 * (dl - 1) * (dl - 1) - 1)));
+        }
+    }
+}
+
+void SphericalHarmonicsEvaluator::clear()
+{
+    m_bond_x.clear();
+    m_bond_y.clear();
+    m_bond_z.clear();
+    m_weights.clear();
+}
+
+void SphericalHarmonicsEvaluator::addBond(const vec3<float>& bond, float weight)
+{
+    m_bond_x.push_back(bond.x);
+    m_bond_y.push_back(bond.y);
+    m_bond_z.push_back(bond.z);
+    m_weights.push_back(weight);
+}
+
+void SphericalHarmonicsEvaluator::evaluate()
+{
+    const size_t n = m_bond_x.size();
+    m_cos_theta.resize(n);
+    m_sin_theta.resize(n);
+    m_phase_re.resize(n);
+    m_phase_im.resize(n);
+    m_power_re.assign(n, 1);
+    m_power_im.assign(n, 0);
+    for (auto& row : m_legendre)
+    {
+        row.resize(n);
+    }
+    m_values_re.resize(sphCount(m_l_max) * n);
+    m_values_im.resize(sphCount(m_l_max) * n);
+
+    for (size_t b = 0; b < n; ++b)
+    {
+        const float x = m_bond_x[b];
+        const float y = m_bond_y[b];
+        const float z = m_bond_z[b];
+        const float rho = std::sqrt(x * x + y * y);
+        const float r = std::sqrt(rho * rho + z * z);
+        // Bonds along z have phi = 0 and bonds of zero length have theta = 0.
+        m_cos_theta[b] = (r > 0) ? std::min(std::max(z / r, -1.0f), 1.0f) : 1;
+        m_sin_theta[b] = (r > 0) ? rho / r : 0;
+        m_phase_re[b] = (rho > 0) ? x / rho : 1;
+        m_phase_im[b] = (rho > 0) ? y / rho : 0;
+    }
+
+    // The diagonal P_m^m of the current m is kept in m_legendre[0], and the
+    // recurrence along l for fixed m uses all three rows.
+    float* const diagonal = m_legendre[0].data();
+    for (size_t b = 0; b < n; ++b)
+    {
+        diagonal[b] = m_diagonal[0];
+    }
+    const float* const cos_theta = m_cos_theta.data();
+    const float* const sin_theta = m_sin_theta.data();
+    float* const power_re = m_power_re.data();
+    float* const power_im = m_power_im.data();
+    for (unsigned int m = 0; m <= m_l_max; ++m)
+    {
+        if (m > 0)
+        {
+            const float factor = m_diagonal[m];
+            const float* const phase_re = m_phase_re.data();
+            const float* const phase_im = m_phase_im.data();
+            for (size_t b = 0; b < n; ++b)
+            {
+                diagonal[b] *= factor * sin_theta[b];
+                const float re = power_re[b] * phase_re[b] - power_im[b] * phase_im[b];
+                const float im = power_re[b] * phase_im[b] + power_im[b] * phase_re[b];
+                power_re[b] = re;
+                power_im[b] = im;
+            }
+        }
+
+        // Write Y_l^m = P_l^m exp(i m phi) for l = m, ..., l_max.
+        auto store = [&](unsigned int l, const float* legendre) {
+            float* const out_re = &m_values_re[sphIndex(l, m) * n];
+            float* const out_im = &m_values_im[sphIndex(l, m) * n];
+            for (size_t b = 0; b < n; ++b)
+            {
+                out_re[b] = legendre[b] * power_re[b];
+                out_im[b] = legendre[b] * power_im[b];
+            }
+        };
+        store(m, diagonal);
+        if (m == m_l_max)
+        {
+            break;
+        }
+
+        float* prev_2 = m_legendre[1].data();
+        float* prev_1 = m_legendre[2].data();
+        const float first = m_first[m];
+        for (size_t b = 0; b < n; ++b)
+        {
+            prev_2[b] = diagonal[b];
+            prev_1[b] = first * cos_theta[b] * diagonal[b];
+        }
+        store(m + 1, prev_1);
+        for (unsigned int l = m + 2; l <= m_l_max; ++l)
+        {
+            const float a = m_a[sphIndex(l, m)];
+            const float a_b = a * m_b[sphIndex(l, m)];
+            // The result overwrites P_{l-2}^m, which is no longer needed.
+            for (size_t b = 0; b < n; ++b)
+            {
+                prev_2[b] = a * cos_theta[b] * prev_1[b] - a_b * prev_2[b];
+            }
+            std::swap(prev_1, prev_2);
+            store(l, prev_1);
+        }
+    }
+}
+
+void SphericalHarmonicsEvaluator::accumulate(unsigned int l, std::complex<float>* qlm) const
+{
+    if (l > m_l_max)
+    {
+        throw std::invalid_argument("The spherical harmonic l must not exceed l_max.");
+    }
+    const size_t n = m_bond_x.size();
+    const float* const weights = m_weights.data();
+    for (unsigned int m = 0; m <= l; ++m)
+    {
+        const float* const values_re = &m_values_re[sphIndex(l, m) * n];
+        const float* const values_im = &m_values_im[sphIndex(l, m) * n];
+        float sum_re(0);
+        float sum_im(0);
+        for (size_t b = 0; b < n; ++b)
+        {
+            sum_re += weights[b] * values_re[b];
+            sum_im += weights[b] * values_im[b];
+        }
+        const std::complex<float> sum(sum_re, sum_im);
+        qlm[m] += (m % 2 == 1) ? -sum : sum;
+        if (m > 0)
+        {
+            qlm[l + m] += std::conj(sum);
+        }
+    }
+}
+
+void SphericalHarmonicsEvaluator::copyBond(unsigned int bond, bool negative_m, std::complex<float>* out) const
+{
+    const size_t n = m_bond_x.size();
+    for (unsigned int l = 0; l <= m_l_max; ++l)
+    {
+        for (unsigned int m = 0; m <= l; ++m)
+        {
+            const size_t index = sphIndex(l, m) * n + bond;
+            *out++ = std::complex<float>(m_values_re[index], m_values_im[index]);
+        }
+        if (negative_m)
+        {
+            for (unsigned int m = 1; m <= l; ++m)
+            {
+                const size_t index = sphIndex(l, m) * n + bond;
+                *out++ = std::complex<float>(m_values_re[index], -m_values_im[index]);
+            }
+        }
+    }
+}
+
+void SphericalHarmonicsEvaluator::copyBonds(bool negative_m, std::complex<float>* out, size_t stride) const
+{
+    const size_t n = m_bond_x.size();
+    size_t column = 0;
+    for (unsigned int l = 0; l <= m_l_max; ++l)
+    {
+        for (unsigned int m = 0; m <= l; ++m, ++column)
+        {
+            const float* values_re = &m_values_re[sphIndex(l, m) * n];
+            const float* values_im = &m_values_im[sphIndex(l, m) * n];
+            for (size_t bond = 0; bond < n; ++bond)
+            {
+                out[bond * stride + column] = std::complex<float>(values_re[bond], values_im[bond]);
+            }
+        }
+        if (negative_m)
+        {
+            for (unsigned int m = 1; m <= l; ++m, ++column)
+            {
+                const float* values_re = &m_values_re[sphIndex(l, m) * n];
+                const float* values_im = &m_values_im[sphIndex(l, m) * n];
+                for (size_t bond = 0; bond < n; ++bond)
+                {
+                    out[bond * stride + column] = std::complex<float>(values_re[bond], -values_im[bond]);
+                }
+            }
+        }
+    }
+}
+
+}; }; // end namespace freud::util
@@ -0,0 +1,131 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SPHERICAL_HARMONICS_H
+#define SPHERICAL_HARMONICS_H
+
+#include <complex>
+#include <vector>
+
+#include "VectorMath.h"
+
+/*! \file SphericalHarmonics.h
+    \brief Batched evaluation of spherical harmonics for the bonds of a point.
+*/
+
+namespace freud { namespace util {
+
+//! Evaluates the spherical harmonics Y_lm of a batch of bond vectors
+/*! The bonds of a point are added one at a time and then evaluated together
+ *  for all l <= l_max and 0 <= m <= l. The values are stored with the bonds as
+ *  the fastest index, so the recurrences of the normalized associated Legendre
+ *  functions over l and the powers exp(i m phi) over m are evaluated for all
+ *  bonds in each step, in loops that the compiler vectorizes across bonds.
+ *  The polar and azimuthal angles are never computed, since cos(theta),
+ *  sin(theta) and exp(i phi) follow directly from the bond vector.
+ *
+ *  The harmonics are orthonormal and, like fsph, omit the Condon-Shortley
+ *  phase, so Y_l^{-m} = conj(Y_l^m). An evaluator keeps its buffers between
+ *  batches, so each thread should reuse one evaluator for all of its points.
+ */
+class SphericalHarmonicsEvaluator
+{
+public:
+    //! Constructor
+    /*! \param l_max Largest spherical harmonic l to evaluate.
+     */
+    explicit SphericalHarmonicsEvaluator(unsigned int l_max);
+
+    //! Number of harmonics with 0 <= m <= l for all l <= l_max
+    static unsigned int sphCount(unsigned int l_max)
+    {
+        return (l_max + 1) * (l_max + 2) / 2;
+    }
+
+    //! Get the largest spherical harmonic l
+    unsigned int getLMax() const
+    {
+        return m_l_max;
+    }
+
+    //! Get the number of bonds in the current batch
+    unsigned int getNumBonds() const
+    {
+        return static_cast<unsigned int>(m_bond_x.size());
+    }
+
+    //! Discard the bonds of the current batch
+    void clear();
+
+    //! Add a bond to the current batch
+    /*! Bonds of zero length are treated as pointing along the z axis.
+     *
+     *  \param bond The bond vector.
+     *  \param weight Weight of the bond in the sums of accumulate().
+     */
+    void addBond(const vec3<float>& bond, float weight = 1);
+
+    //! Evaluate the spherical harmonics of all bonds in the current batch
+    void evaluate();
+
+    //! Add the weighted sum of Y_lm over the bonds of the batch for a single l
+    /*! The sums are added to qlm in the order m = 0, 1, ..., l, -1, ..., -l,
+     *  with the Condon-Shortley phase (-1)^m applied to positive m, which is
+     *  the convention of the Steinhardt order parameters.
+     *
+     *  \param l Spherical harmonic l, which must not exceed l_max.
+     *  \param qlm Array of 2 * l + 1 values to add the sums to.
+     */
+    void accumulate(unsigned int l, std::complex<float>* qlm) const;
+
+    //! Copy the spherical harmonics of one bond of the batch for all l <= l_max
+    /*! The values are written in the order of fsph: for each l, m = 0, 1, ...,
+     *  l, followed by m = -1, ..., -l if negative_m is true.
+     *
+     *  \param bond Index of the bond in the batch.
+     *  \param negative_m Whether to include negative m.
+     *  \param out Array to write the values to.
+     */
+    void copyBond(unsigned int bond, bool negative_m, std::complex<float>* out) const;
+
+    //! Copy the spherical harmonics of all bonds of the batch for all l <= l_max
+    /*! The values of each bond are written in the order of copyBond, with the
+     *  values of consecutive bonds stride elements apart. Each harmonic is
+     *  copied for all bonds at once, so the values are read contiguously.
+     *
+     *  \param negative_m Whether to include negative m.
+     *  \param out Array to write the values of the first bond to.
+     *  \param stride Distance between the values of consecutive bonds.
+     */
+    void copyBonds(bool negative_m, std::complex<float>* out, size_t stride) const;
+
+private:
+    //! Index of (l, m) in the harmonics of a bond
+    static unsigned int sphIndex(unsigned int l, unsigned int m)
+    {
+        return l * (l + 1) / 2 + m;
+    }
+
+    unsigned int m_l_max;             //!< Largest spherical harmonic l
+    std::vector<float> m_diagonal;    //!< Factors of the P_m^m recurrence for each m
+    std::vector<float> m_first;       //!< Factors of the P_{m+1}^m recurrence for each m
+    std::vector<float> m_a;           //!< Factors a_lm of the P_l^m recurrence over l
+    std::vector<float> m_b;           //!< Factors b_lm of the P_l^m recurrence over l
+    std::vector<float> m_bond_x;      //!< x component of each bond
+    std::vector<float> m_bond_y;      //!< y component of each bond
+    std::vector<float> m_bond_z;      //!< z component of each bond
+    std::vector<float> m_weights;     //!< Weight of each bond
+    std::vector<float> m_cos_theta;   //!< Cosine of the polar angle of each bond
+    std::vector<float> m_sin_theta;   //!< Sine of the polar angle of each bond
+    std::vector<float> m_phase_re;    //!< Real part of exp(i phi) of each bond
+    std::vector<float> m_phase_im;    //!< Imaginary part of exp(i phi) of each bond
+    std::vector<float> m_power_re;    //!< Real part of exp(i m phi) of each bond for the current m
+    std::vector<float> m_power_im;    //!< Imaginary part of exp(i m phi) of each bond for the current m
+    std::vector<float> m_legendre[3]; //!< Legendre functions of each bond for the last three l
+    std::vector<float> m_values_re;   //!< Real parts of Y_lm, of shape (sphCount(l_max), num_bonds)
+    std::vector<float> m_values_im;   //!< Imaginary parts of Y_lm, of shape (sphCount(l_max), num_bonds)
+};
+
+}; }; // end namespace freud::util
+
+#endif // SPHERICAL_HARMONICS_H
@@ -2,7 +2,10 @@
 #define THREADSTORAGE_H
 
 #include "ManagedArray.h"
+#include "TiledArray.h"
 #include "utils.h"
+#include <algorithm>
+#include <chrono>
 #include <tbb/enumerable_thread_specific.h>
 #include <vector>
 
@@ -10,13 +13,20 @@ namespace freud { namespace util {
 
 //! Wrapper class for enumerable_thread_specific<T*>
 /*! It is expected that default value for T is 0.
+ *
+ *  The Array template parameter selects how the thread local arrays are
+ *  stored. The default ManagedArray gives each thread a dense copy of the
+ *  full shape. A TiledArray instead allocates tiles lazily on first touch, so
+ *  resetting and reducing the thread local arrays only touches the tiles that
+ *  were written, which is much cheaper for large arrays that are mostly empty
+ *  on each thread.
  */
-template<typename T> class ThreadStorage
+template<typename T, typename Array = ManagedArray<T>> class ThreadStorage
 {
 public:
     //! Default constructor
     ThreadStorage()
-        : arrays(tbb::enumerable_thread_specific<ManagedArray<T>>([]() { return ManagedArray<T>(); }))
+        : arrays(tbb::enumerable_thread_specific<Array>([]() { return Array(); }))
     {}
 
     //! Constructor with specific size for thread local arrays
@@ -28,8 +38,7 @@ public:
     /*! \param shape Vector of sizes in each dimension of the thread local arrays
      */
     explicit ThreadStorage(const std::vector<size_t>& shape)
-        : arrays(
-            tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); }))
+        : arrays(tbb::enumerable_thread_specific<Array>([shape]() { return Array(shape); }))
     {}
 
     //! Destructor
@@ -48,22 +57,22 @@ public:
      */
     void resize(std::vector<size_t> shape)
     {
-        arrays
-            = tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); });
+        arrays = tbb::enumerable_thread_specific<Array>([shape]() { return Array(shape); });
     }
 
     //! Reset the contents of thread local arrays to be 0
     void reset()
     {
+        FREUD_PROFILE_SCOPE("thread storage reset");
         for (auto array = arrays.begin(); array != arrays.end(); ++array)
         {
             array->reset();
         }
     }
 
-    using const_iterator = typename tbb::enumerable_thread_specific<ManagedArray<T>>::const_iterator;
-    using iterator = typename tbb::enumerable_thread_specific<ManagedArray<T>>::iterator;
-    using reference = typename tbb::enumerable_thread_specific<ManagedArray<T>>::reference;
+    using const_iterator = typename tbb::enumerable_thread_specific<Array>::const_iterator;
+    using iterator = typename tbb::enumerable_thread_specific<Array>::iterator;
+    using reference = typename tbb::enumerable_thread_specific<Array>::reference;
 
     const_iterator begin() const
     {
@@ -90,8 +99,13 @@ public:
         return arrays.local();
     }
 
+    //! Add the sum of the thread local arrays into the result array.
+    /*! \param result Array of the same size as the thread local arrays.
+     */
     void reduceInto(ManagedArray<T>& result)
     {
+        FREUD_PROFILE_SCOPE("thread storage reduction");
+        const auto start = std::chrono::steady_clock::now();
         if (arrays.size() == 0)
         {
             // If no local arrays have been created, then no data can be reduced
@@ -101,23 +115,187 @@ public:
         }
         else
         {
-            // Reduce over arrays into the result array.
-            util::forLoopWrapper(0, result.size(), [=, &result](size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i)
+            reduceArrays(arrays, result);
+        }
+        m_reduce_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //! Sum the thread local arrays into one of them.
+    /*! This avoids writing a separate result array when the sum is only read
+     *  before the thread local arrays are reset again. The other thread local
+     *  arrays are left holding partial sums, so they must be reset before
+     *  accumulating into them again. Only dense arrays can be reduced in place.
+     *
+     *  \return The thread local array holding the sum, valid until the next reset.
+     */
+    reference reduceInPlace()
+    {
+        FREUD_PROFILE_SCOPE("thread storage reduction");
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<T*> data;
+        for (auto arr = arrays.begin(); arr != arrays.end(); ++arr)
+        {
+            data.push_back(arr->get());
+        }
+        if (data.empty())
+        {
+            // Create a zeroed array on this thread to hold the (empty) sum.
+            return arrays.local();
+        }
+
+        // Add arrays pairwise in rounds of doubling stride, one chunk at a
+        // time so that each chunk stays in cache for all rounds.
+        const size_t size = arrays.begin()->size();
+        util::forLoopWrapper(0, numReduceChunks(size), [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                const size_t offset = chunk * REDUCE_CHUNK_SIZE;
+                const size_t count = std::min(REDUCE_CHUNK_SIZE, size - offset);
+                for (size_t stride = 1; stride < data.size(); stride *= 2)
                 {
-                    for (auto arr = arrays.begin(); arr != arrays.end(); ++arr)
+                    for (size_t i = 0; i + stride < data.size(); i += 2 * stride)
                     {
-                        result[i] += (*arr)[i];
+                        addChunk(data[i] + offset, data[i + stride] + offset, count);
                     }
                 }
-            });
-        }
+            }
+        });
+        m_reduce_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return *arrays.begin();
+    }
+
+    //! Get the wall time in seconds taken by the most recent reduction.
+    double getReduceTime() const
+    {
+        return m_reduce_time;
     }
 
 private:
-    tbb::enumerable_thread_specific<ManagedArray<T>> arrays; //!< thread local arrays
+    //! Number of elements reduced together by each task.
+    /*! A chunk of every thread local array, plus the scratch space of the
+     *  pairwise sum, fits comfortably into the L2 cache of a core for any
+     *  reasonable number of threads and element type.
+     */
+    static const size_t REDUCE_CHUNK_SIZE = 1024;
+
+    //! Return the number of reduction chunks of an array.
+    static size_t numReduceChunks(size_t size)
+    {
+        return (size + REDUCE_CHUNK_SIZE - 1) / REDUCE_CHUNK_SIZE;
+    }
+
+    //! Add count elements of values into out.
+    static void addChunk(T* __restrict out, const T* __restrict values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] += values[i];
+        }
+    }
+
+    //! Write the sum of count elements of a set of arrays into out.
+    /*! The arrays are summed pairwise, which keeps the rounding error of
+     *  floating point sums growing with the logarithm of the number of arrays
+     *  rather than linearly.
+     *
+     *  \param data Pointers to the first element to sum of each array.
+     *  \param n_arrays Number of arrays, at least 1.
+     *  \param count Number of elements to sum.
+     *  \param out Array of count elements receiving the sums.
+     *  \param scratch Array of count elements per level of the pairwise sum.
+     */
+    static void sumChunk(const T* const* data, size_t n_arrays, size_t count, T* __restrict out,
+                         T* __restrict scratch)
+    {
+        if (n_arrays == 1)
+        {
+            std::copy(data[0], data[0] + count, out);
+            return;
+        }
+        if (n_arrays == 2)
+        {
+            const T* __restrict first = data[0];
+            const T* __restrict second = data[1];
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = first[i] + second[i];
+            }
+            return;
+        }
+        const size_t half = n_arrays / 2;
+        sumChunk(data, half, count, out, scratch + count);
+        sumChunk(data + half, n_arrays - half, count, scratch, scratch + count);
+        addChunk(out, scratch, count);
+    }
+
+    //! Reduce over dense arrays into the result array.
+    /*! The result is processed in cache-sized chunks in parallel. Each chunk
+     *  of the thread local arrays is summed pairwise with contiguous loops
+     *  that the compiler vectorizes, and then added into the result.
+     */
+    static void reduceArrays(const tbb::enumerable_thread_specific<ManagedArray<T>>& arrays,
+                             ManagedArray<T>& result)
+    {
+        std::vector<const T*> data;
+        for (auto arr = arrays.begin(); arr != arrays.end(); ++arr)
+        {
+            data.push_back(arr->get());
+        }
+        size_t levels = 1;
+        while ((size_t(1) << levels) < data.size())
+        {
+            ++levels;
+        }
+
+        T* result_data = result.get();
+        const size_t size = result.size();
+        util::forLoopWrapper(0, numReduceChunks(size), [&](size_t begin, size_t end) {
+            std::vector<T> sums(REDUCE_CHUNK_SIZE * (levels + 1));
+            std::vector<const T*> chunk_data(data.size());
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                const size_t offset = chunk * REDUCE_CHUNK_SIZE;
+                const size_t count = std::min(REDUCE_CHUNK_SIZE, size - offset);
+                for (size_t i = 0; i < data.size(); ++i)
+                {
+                    chunk_data[i] = data[i] + offset;
+                }
+                sumChunk(chunk_data.data(), chunk_data.size(), count, sums.data(),
+                         sums.data() + REDUCE_CHUNK_SIZE);
+                addChunk(result_data + offset, sums.data(), count);
+            }
+        });
+    }
+
+    //! Reduce over the touched tiles of tiled arrays into the result array.
+    static void reduceArrays(const tbb::enumerable_thread_specific<TiledArray<T>>& arrays,
+                             ManagedArray<T>& result)
+    {
+        T* result_data = result.get();
+        util::forLoopWrapper(0, arrays.begin()->getNumTiles(), [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; ++tile)
+            {
+                const size_t first = tile * TiledArray<T>::TILE_SIZE;
+                const size_t count = std::min(static_cast<size_t>(TiledArray<T>::TILE_SIZE),
+                                              result.size() - first);
+                for (auto arr = arrays.begin(); arr != arrays.end(); ++arr)
+                {
+                    const T* values = arr->getTile(tile);
+                    if (values != nullptr)
+                    {
+                        addChunk(result_data + first, values, count);
+                    }
+                }
+            }
+        });
+    }
+
+    tbb::enumerable_thread_specific<Array> arrays; //!< thread local arrays
+    double m_reduce_time {0};                      //!< Wall time of the most recent reduction in seconds
 };
 
+template<typename T, typename Array> const size_t ThreadStorage<T, Array>::REDUCE_CHUNK_SIZE;
+
 }; }; // end namespace freud::util
 
 #endif
@@ -0,0 +1,117 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TILED_ARRAY_H
+#define TILED_ARRAY_H
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+/*! \file TiledArray.h
+    \brief Sparse array made of lazily allocated tiles.
+*/
+
+namespace freud { namespace util {
+
+//! A linear array whose elements are stored in tiles allocated on first write.
+/*! The TiledArray is an alternative to a dense ManagedArray for thread local
+ *  buffers that are mostly empty, such as the per-thread copies of histograms
+ *  with many bins. A tile of TILE_SIZE elements is only allocated (and zeroed)
+ *  when one of its elements is first accessed through the writeable index
+ *  operator, so resetting the array and reducing it into a dense result only
+ *  cost time proportional to the number of tiles that were touched.
+ *
+ *  Tiles remain allocated when the array is reset, so buffers that are reused
+ *  over many frames reach a steady state without further allocations.
+ */
+template<typename T> class TiledArray
+{
+public:
+    static const size_t TILE_SIZE = 4096; //!< Number of elements per tile
+
+    //! Default constructor
+    TiledArray() : TiledArray(std::vector<size_t> {0}) {}
+
+    //! Constructor with specific size
+    /*! \param size Number of elements of the array.
+     */
+    explicit TiledArray(size_t size) : TiledArray(std::vector<size_t> {size}) {}
+
+    //! Constructor with specific shape
+    /*! Elements are indexed linearly in row-major order, matching the layout
+     *  of a ManagedArray with the same shape.
+     *
+     *  \param shape Vector of sizes in each dimension.
+     */
+    explicit TiledArray(const std::vector<size_t>& shape)
+        : m_shape(shape),
+          m_size(std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>())),
+          m_tiles((m_size + TILE_SIZE - 1) / TILE_SIZE)
+    {}
+
+    //! Writeable index into array, allocating the containing tile if needed.
+    T& operator[](size_t i)
+    {
+        std::vector<T>& tile = m_tiles[i / TILE_SIZE];
+        if (tile.empty())
+        {
+            tile.resize(TILE_SIZE, T());
+        }
+        return tile[i % TILE_SIZE];
+    }
+
+    //! Read-only index into array, returning zero for untouched tiles.
+    T operator[](size_t i) const
+    {
+        const std::vector<T>& tile = m_tiles[i / TILE_SIZE];
+        return tile.empty() ? T() : tile[i % TILE_SIZE];
+    }
+
+    //! Zero all touched tiles, keeping them allocated.
+    void reset()
+    {
+        for (auto& tile : m_tiles)
+        {
+            std::fill(tile.begin(), tile.end(), T());
+        }
+    }
+
+    //! Get the elements of a tile, or nullptr if it was never touched.
+    /*! \param tile Index of the tile, holding elements [tile * TILE_SIZE, (tile + 1) * TILE_SIZE).
+     */
+    const T* getTile(size_t tile) const
+    {
+        return m_tiles[tile].empty() ? nullptr : m_tiles[tile].data();
+    }
+
+    //! Get the number of tiles, touched or not.
+    size_t getNumTiles() const
+    {
+        return m_tiles.size();
+    }
+
+    //! Get the number of elements of the array.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    //! Get the shape of the array.
+    std::vector<size_t> shape() const
+    {
+        return m_shape;
+    }
+
+private:
+    std::vector<size_t> m_shape;         //!< Shape of the array
+    size_t m_size;                       //!< Number of elements of the array
+    std::vector<std::vector<T>> m_tiles; //!< The tiles, empty until touched
+};
+
+template<typename T> const size_t TiledArray<T>::TILE_SIZE;
+
+}; }; // end namespace freud::util
+
+#endif // TILED_ARRAY_H
@@ -6,6 +6,7 @@
 #define VECTOR_MATH_H
 
 #include <cmath>
+#include <cstddef>
 #include <utility>
 
 /*! \file VectorMath.h
@@ -1075,6 +1076,73 @@ template<class Real> inline rotmat3<Real> transpose(const rotmat3<Real>& A)
                          vec3<Real>(A.row0.z, A.row1.z, A.row2.z));
 }
 
+/////////////////////////////// batched operations /////////////////////////////////
+
+//! Convert the inverses of a batch of rotations to rotation matrices
+/*! \param q quaternions (should be unit quaternions)
+    \param matrices output rotation matrices, one per quaternion
+    \param n number of quaternions
+
+    Loops that undo the rotation of the same point for many bonds convert the orientations once, since
+   multiplying by a rotmat3 takes fewer operations than rotate(conj(q), b). The loop has no branches and
+   no dependencies between iterations, so that the compiler can vectorize it.
+*/
+template<class Real>
+inline void inverseRotationMatrices(const quat<Real>* q, rotmat3<Real>* matrices, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        matrices[i] = rotmat3<Real>(conj(q[i]));
+    }
+}
+
+//! Convert the inverses of a batch of rotations by angles to rotation matrices
+/*! \param angles rotation angles
+    \param matrices output rotation matrices, one per angle
+    \param n number of angles
+
+    Each rotmat2 rotates by the negated angle, replacing a sine and a cosine per use with a matrix vector
+   product.
+*/
+template<class Real>
+inline void inverseRotationMatrices(const Real* angles, rotmat2<Real>* matrices, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        matrices[i] = rotmat2<Real>::fromAngle(-angles[i]);
+    }
+}
+
+//! Multiply a quaternion by a batch of quaternions
+/*! \param a quaternion to multiply from the left
+    \param b quaternions to multiply from the right
+    \param products output products a * b[i]
+    \param n number of quaternions in b
+*/
+template<class Real>
+inline void multiplyBatch(const quat<Real>& a, const quat<Real>* b, quat<Real>* products, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        products[i] = a * b[i];
+    }
+}
+
+//! Rotate a vector by a batch of quaternions
+/*! \param a quaternions (should be unit quaternions)
+    \param b vector to rotate
+    \param rotated output vectors rotate(a[i], b)
+    \param n number of quaternions
+*/
+template<class Real>
+inline void rotateBatch(const quat<Real>* a, const vec3<Real>& b, vec3<Real>* rotated, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        rotated[i] = rotate(a[i], b);
+    }
+}
+
 /////////////////////////////// generic operations /////////////////////////////////
 
 //! Vector projection
@@ -1,34 +1,302 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Eigen/Eigen/Dense"
 #include "diagonalize.h"
 
 namespace freud { namespace util {
 
-void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
-                                  util::ManagedArray<float>& eigen_vecs)
+namespace {
+
+//! Number of matrices whose eigenvalues are computed together
+constexpr size_t DIAGONALIZE_BLOCK_SIZE = 64;
+
+//! Largest residual of the eigenvalue equation, relative to the largest element, that is accepted
+constexpr double DIAGONALIZE_TOLERANCE = 1e-5;
+
+//! Unique elements of a symmetric matrix, in the order 00, 01, 02, 11, 12, 22
+struct SymmetricMatrix
+{
+    double a00, a01, a02, a11, a12, a22;
+};
+
+struct Vector3
+{
+    double x, y, z;
+};
+
+inline Vector3 cross(const Vector3& u, const Vector3& v)
+{
+    return {u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x};
+}
+
+inline double dot(const Vector3& u, const Vector3& v)
+{
+    return u.x * v.x + u.y * v.y + u.z * v.z;
+}
+
+inline Vector3 multiply(const SymmetricMatrix& a, const Vector3& v)
+{
+    return {a.a00 * v.x + a.a01 * v.y + a.a02 * v.z, a.a01 * v.x + a.a11 * v.y + a.a12 * v.z,
+            a.a02 * v.x + a.a12 * v.y + a.a22 * v.z};
+}
+
+//! Compute the eigenvector of an eigenvalue of multiplicity one
+/*! The rows of a - eigenvalue * I span the plane orthogonal to the
+ *  eigenvector, so the eigenvector is parallel to the cross product of any two
+ *  independent rows. The largest of the three cross products is used.
+ */
+Vector3 eigenvector0(const SymmetricMatrix& a, double eigenvalue)
+{
+    const Vector3 row0 {a.a00 - eigenvalue, a.a01, a.a02};
+    const Vector3 row1 {a.a01, a.a11 - eigenvalue, a.a12};
+    const Vector3 row2 {a.a02, a.a12, a.a22 - eigenvalue};
+    const Vector3 r0xr1 = cross(row0, row1);
+    const Vector3 r0xr2 = cross(row0, row2);
+    const Vector3 r1xr2 = cross(row1, row2);
+    const double d0 = dot(r0xr1, r0xr1);
+    const double d1 = dot(r0xr2, r0xr2);
+    const double d2 = dot(r1xr2, r1xr2);
+    const Vector3& largest = (d0 >= d1 && d0 >= d2) ? r0xr1 : ((d1 >= d2) ? r0xr2 : r1xr2);
+    const double d_max = std::max({d0, d1, d2});
+    if (d_max == 0)
+    {
+        return {1, 0, 0};
+    }
+    const double inv_length = 1 / std::sqrt(d_max);
+    return {largest.x * inv_length, largest.y * inv_length, largest.z * inv_length};
+}
+
+//! Compute the eigenvector of a second eigenvalue, orthogonal to the eigenvector evec0
+/*! The problem is restricted to the plane orthogonal to evec0, where it
+ *  reduces to finding the null space of a symmetric 2x2 matrix, which is
+ *  robust even when the remaining two eigenvalues are nearly equal.
+ */
+Vector3 eigenvector1(const SymmetricMatrix& a, const Vector3& evec0, double eigenvalue)
+{
+    // Build an orthonormal basis {u, v} of the plane orthogonal to evec0.
+    Vector3 u;
+    if (std::abs(evec0.x) > std::abs(evec0.y))
+    {
+        const double inv_length = 1 / std::sqrt(evec0.x * evec0.x + evec0.z * evec0.z);
+        u = {-evec0.z * inv_length, 0, evec0.x * inv_length};
+    }
+    else
+    {
+        const double inv_length = 1 / std::sqrt(evec0.y * evec0.y + evec0.z * evec0.z);
+        u = {0, evec0.z * inv_length, -evec0.y * inv_length};
+    }
+    const Vector3 v = cross(evec0, u);
+
+    const Vector3 au = multiply(a, u);
+    const Vector3 av = multiply(a, v);
+    double m00 = dot(u, au) - eigenvalue;
+    double m01 = dot(u, av);
+    double m11 = dot(v, av) - eigenvalue;
+
+    const double abs_m00 = std::abs(m00);
+    const double abs_m01 = std::abs(m01);
+    const double abs_m11 = std::abs(m11);
+    if (abs_m00 >= abs_m11)
+    {
+        if (std::max(abs_m00, abs_m01) == 0)
+        {
+            return u;
+        }
+        if (abs_m00 >= abs_m01)
+        {
+            m01 /= m00;
+            m00 = 1 / std::sqrt(1 + m01 * m01);
+            m01 *= m00;
+        }
+        else
+        {
+            m00 /= m01;
+            m01 = 1 / std::sqrt(1 + m00 * m00);
+            m00 *= m01;
+        }
+        return {m01 * u.x - m00 * v.x, m01 * u.y - m00 * v.y, m01 * u.z - m00 * v.z};
+    }
+    if (std::max(abs_m11, abs_m01) == 0)
+    {
+        return u;
+    }
+    if (abs_m11 >= abs_m01)
+    {
+        m01 /= m11;
+        m11 = 1 / std::sqrt(1 + m01 * m01);
+        m01 *= m11;
+    }
+    else
+    {
+        m11 /= m01;
+        m01 = 1 / std::sqrt(1 + m11 * m11);
+        m11 *= m01;
+    }
+    return {m11 * u.x - m01 * v.x, m11 * u.y - m01 * v.y, m11 * u.z - m01 * v.z};
+}
+
+//! Flip an eigenvector so that its component of largest magnitude is positive
+inline Vector3 canonicalSign(const Vector3& v)
 {
-    const Eigen::Matrix3f m = Eigen::Map<const Eigen::Matrix3f>(mat.get());
+    const double abs_x = std::abs(v.x);
+    const double abs_y = std::abs(v.y);
+    const double abs_z = std::abs(v.z);
+    const double largest = (abs_x >= abs_y && abs_x >= abs_z) ? v.x : ((abs_y >= abs_z) ? v.y : v.z);
+    return (largest < 0) ? Vector3 {-v.x, -v.y, -v.z} : v;
+}
 
-    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> es;
+//! Diagonalize a matrix with Eigen's iterative solver
+void diagonalizeIteratively(const float* matrix, std::array<double, 3>& eigen_vals,
+                            std::array<Vector3, 3>& eigen_vecs)
+{
+    const Eigen::Matrix3d m = Eigen::Map<const Eigen::Matrix3f>(matrix).cast<double>();
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es;
     es.compute(m);
 
     if (es.info() != Eigen::Success)
     {
-        // numerical issue, return identity matrix
-        Eigen::Matrix3f id = Eigen::Matrix3f::Identity();
-        Eigen::Map<Eigen::Matrix3f>(eigen_vecs.get(), 3, 3) = id;
-        // set eigenvalues to zero so it's easily detectable
-        eigen_vals[0] = eigen_vals[1] = eigen_vals[2] = 0.0;
+        // numerical issue, return identity matrix and set eigenvalues to zero
+        // so it's easily detectable
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            eigen_vals[k] = 0;
+        }
+        eigen_vecs[0] = {1, 0, 0};
+        eigen_vecs[1] = {0, 1, 0};
+        eigen_vecs[2] = {0, 0, 1};
+        return;
     }
-    else
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+        eigen_vals[k] = es.eigenvalues()[k];
+        eigen_vecs[k] = {es.eigenvectors()(0, k), es.eigenvectors()(1, k), es.eigenvectors()(2, k)};
+    }
+}
+
+}; // end anonymous namespace
+
+void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
+                                  util::ManagedArray<float>& eigen_vecs)
+{
+    diagonalize33SymmetricMatrices(mat.get(), eigen_vals.get(), eigen_vecs.get(), 1);
+}
+
+void diagonalize33SymmetricMatrices(const float* matrices, float* eigen_vals, float* eigen_vecs, size_t n)
+{
+    constexpr size_t block = DIAGONALIZE_BLOCK_SIZE;
+    std::array<SymmetricMatrix, block> scaled {};
+    std::array<double, block> scale {};
+    std::array<std::array<double, block>, 3> eigenvalues {};
+    std::array<double, block> half_det {};
+
+    for (size_t begin = 0; begin < n; begin += block)
     {
-        // Note that Eigen by default stores matrices in column-major order,
-        // whereas everything we do in freud uses row major ordering. As a
-        // result, this operation here transposes the matrix, which is why
-        // eigenvectors are returned as rows rather than columns of the
-        // outputmatrix eigen_vecs.
-        // See here for information:
-        // https://eigen.tuxfamily.org/dox/group__TopicStorageOrders.html
-        Eigen::Map<Eigen::Matrix3f>(eigen_vecs.get(), 3, 3) = es.eigenvectors();
-        Eigen::Map<Eigen::Vector3f>(eigen_vals.get(), 3) = es.eigenvalues();
+        const size_t count = std::min(block, n - begin);
+
+        // Compute the eigenvalues of the matrices of the block in closed form.
+        // The matrices are scaled by their largest element to avoid overflow
+        // and underflow, and shifted by a third of their trace so that the
+        // characteristic polynomial has no quadratic term.
+        for (size_t k = 0; k < count; ++k)
+        {
+            const float* m = matrices + 9 * (begin + k);
+            const SymmetricMatrix a {m[0], m[1], m[2], m[4], m[5], m[8]};
+            const double max_element = std::max({std::abs(a.a00), std::abs(a.a01), std::abs(a.a02),
+                                                 std::abs(a.a11), std::abs(a.a12), std::abs(a.a22)});
+            scale[k] = max_element;
+            const double inv_scale = (max_element > 0) ? 1 / max_element : 0;
+            const SymmetricMatrix s {a.a00 * inv_scale, a.a01 * inv_scale, a.a02 * inv_scale,
+                                     a.a11 * inv_scale, a.a12 * inv_scale, a.a22 * inv_scale};
+            scaled[k] = s;
+
+            const double q = (s.a00 + s.a11 + s.a22) / 3;
+            const double b00 = s.a00 - q;
+            const double b11 = s.a11 - q;
+            const double b22 = s.a22 - q;
+            const double off_diagonal = s.a01 * s.a01 + s.a02 * s.a02 + s.a12 * s.a12;
+            const double p = std::sqrt((b00 * b00 + b11 * b11 + b22 * b22 + 2 * off_diagonal) / 6);
+            const double inv_p = (p > 0) ? 1 / p : 0;
+            const double c00 = b11 * b22 - s.a12 * s.a12;
+            const double c01 = s.a01 * b22 - s.a12 * s.a02;
+            const double c02 = s.a01 * s.a12 - b11 * s.a02;
+            const double det = (b00 * c00 - s.a01 * c01 + s.a02 * c02) * inv_p * inv_p * inv_p;
+            half_det[k] = std::min(std::max(det / 2, -1.0), 1.0);
+
+            // The roots of the depressed characteristic polynomial are
+            // 2 cos(angle + 2 pi j / 3), in increasing order for j = 1, 2, 0.
+            const double angle = std::acos(half_det[k]) / 3;
+            const double cos_angle = std::cos(angle);
+            const double sin_angle = std::sin(angle);
+            const double beta2 = 2 * cos_angle;
+            const double beta0 = -cos_angle - std::sqrt(3.0) * sin_angle;
+            const double beta1 = -(beta0 + beta2);
+            eigenvalues[0][k] = q + p * beta0;
+            eigenvalues[1][k] = q + p * beta1;
+            eigenvalues[2][k] = q + p * beta2;
+        }
+
+        // Compute the eigenvectors, starting from the eigenvalue that is
+        // farther from the middle eigenvalue.
+        for (size_t k = 0; k < count; ++k)
+        {
+            const SymmetricMatrix& s = scaled[k];
+            std::array<double, 3> vals {eigenvalues[0][k], eigenvalues[1][k], eigenvalues[2][k]};
+            std::array<Vector3, 3> vecs {};
+            if (vals[0] == vals[2])
+            {
+                // The matrix is a multiple of the identity.
+                vecs[0] = {1, 0, 0};
+                vecs[1] = {0, 1, 0};
+                vecs[2] = {0, 0, 1};
+            }
+            else if (half_det[k] >= 0)
+            {
+                vecs[2] = eigenvector0(s, vals[2]);
+                vecs[1] = eigenvector1(s, vecs[2], vals[1]);
+                vecs[0] = cross(vecs[1], vecs[2]);
+            }
+            else
+            {
+                vecs[0] = eigenvector0(s, vals[0]);
+                vecs[1] = eigenvector1(s, vecs[0], vals[1]);
+                vecs[2] = cross(vecs[0], vecs[1]);
+            }
+
+            // Fall back to the iterative solver if rounding has spoiled the
+            // closed-form eigenpairs.
+            double residual = 0;
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                const Vector3 av = multiply(s, vecs[j]);
+                residual = std::max({residual, std::abs(av.x - vals[j] * vecs[j].x),
+                                     std::abs(av.y - vals[j] * vecs[j].y),
+                                     std::abs(av.z - vals[j] * vecs[j].z)});
+            }
+            if (!(residual <= DIAGONALIZE_TOLERANCE))
+            {
+                diagonalizeIteratively(matrices + 9 * (begin + k), vals, vecs);
+            }
+            else
+            {
+                for (double& val : vals)
+                {
+                    val *= scale[k];
+                }
+            }
+
+            float* out_vals = eigen_vals + 3 * (begin + k);
+            float* out_vecs = eigen_vecs + 9 * (begin + k);
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                const Vector3 v = canonicalSign(vecs[j]);
+                out_vals[j] = static_cast<float>(vals[j]);
+                out_vecs[3 * j] = static_cast<float>(v.x);
+                out_vecs[3 * j + 1] = static_cast<float>(v.y);
+                out_vecs[3 * j + 2] = static_cast<float>(v.z);
+            }
+        }
     }
 }
 
@@ -1,7 +1,8 @@
 #ifndef DIAGONALIZE_H
 #define DIAGONALIZE_H
 
-#include "Eigen/Eigen/Dense"
+#include <cstddef>
+
 #include "ManagedArray.h"
 
 namespace freud { namespace util {
@@ -10,7 +11,9 @@ namespace freud { namespace util {
  * ManagedArrays that will be updated by reference. The eigenvectors are placed
  * in rows of eigen_vecs, so e.g. the first eigenvector is [eigen_vecs(0, 0),
  * eigen_vecs(0, 1), eigen_vecs(0, 2)]. The eigenvalues are returned in
- * increasing order, with the eigenvectors in the corresponding order.
+ * increasing order, with the eigenvectors in the corresponding order. The
+ * sign of each eigenvector is chosen to make its component of largest
+ * magnitude positive.
  *
  * Note that no checks are performed to check if the matrix is symmetric. It is
  * the responsibility of calling code to only use this function for symmetric
@@ -23,5 +26,25 @@ namespace freud { namespace util {
 void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
                                   util::ManagedArray<float>& eigen_vecs);
 
+//! Compute eigenvalues and eigenvectors of many self-adjoint 3x3 matrices.
+/*! The eigenvalues are found in closed form from the trigonometric solution
+ * of the characteristic polynomial, and the eigenvectors from cross products
+ * of the rows of the shifted matrix, following D. Eberly, "A Robust
+ * Eigensolver for 3 x 3 Symmetric Matrices" (2014). Each stage is applied to
+ * all matrices in a single loop, so the compiler can vectorize it across
+ * matrices. Matrices whose eigenpairs do not satisfy the eigenvalue equation
+ * to within a small tolerance of the largest element, which can only happen
+ * through rounding for nearly degenerate eigenvalues, are diagonalized again
+ * with an iterative solver.
+ *
+ * Results follow the conventions of diagonalize33SymmetricMatrix.
+ *
+ *  \param matrices Row-major 3x3 matrices, 9 values for each matrix.
+ *  \param eigen_vals Output eigenvalues, 3 values for each matrix.
+ *  \param eigen_vecs Output row-major matrices with eigenvectors as the rows, 9 values for each matrix.
+ *  \param n Number of matrices.
+ */
+void diagonalize33SymmetricMatrices(const float* matrices, float* eigen_vals, float* eigen_vecs, size_t n);
+
 }; }; // namespace freud::util
 #endif
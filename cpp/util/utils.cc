@@ -0,0 +1,63 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <atomic>
+#include <stdexcept>
+
+#include "utils.h"
+
+/*! \file utils.cc
+    \brief Holds the state of the parallel loop helpers.
+*/
+
+namespace freud { namespace util {
+
+namespace {
+
+//! The task arena in which parallel loops started by this thread run
+thread_local tbb::task_arena* active_arena = nullptr;
+
+//! The partitioner of loops that do not request one
+std::atomic<LoopPartitioner> default_partitioner {LoopPartitioner::automatic};
+
+//! The grain size of loops that do not request one
+std::atomic<size_t> default_grain_size {1};
+
+}; // end anonymous namespace
+
+// These are defined here rather than inline in utils.h so that libfreud and
+// the Python extension modules share a single active arena per thread and a
+// single default loop policy.
+tbb::task_arena* getActiveArena()
+{
+    return active_arena;
+}
+
+tbb::task_arena* setActiveArena(tbb::task_arena* arena)
+{
+    tbb::task_arena* previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+LoopPolicy getDefaultLoopPolicy()
+{
+    return LoopPolicy(default_partitioner.load(std::memory_order_relaxed),
+                      default_grain_size.load(std::memory_order_relaxed));
+}
+
+void setDefaultLoopPolicy(LoopPartitioner partitioner, size_t grain_size)
+{
+    if (partitioner == LoopPartitioner::global_default || partitioner == LoopPartitioner::affinity)
+    {
+        throw std::invalid_argument("The default loop partitioner must be automatic, simple or static.");
+    }
+    if (grain_size == 0)
+    {
+        throw std::invalid_argument("The default loop grain size must be at least 1.");
+    }
+    default_partitioner.store(partitioner, std::memory_order_relaxed);
+    default_grain_size.store(grain_size, std::memory_order_relaxed);
+}
+
+}; }; // end namespace freud::util
@@ -3,9 +3,26 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <tbb/blocked_range.h>
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+
+#include "Profiler.h"
+
+// On x86-64 ELF platforms, functions marked with FREUD_SIMD_CLONES are
+// compiled for AVX-512, AVX2, and the baseline instruction set, and the loader
+// picks the variant supported by the running CPU. Elsewhere, a single portable
+// variant is built. Translation units defining such functions should disable
+// floating point contraction so that all variants give identical results.
+#if defined(__x86_64__) && defined(__ELF__) \
+    && ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && defined(__GNUC__)))
+#define FREUD_SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define FREUD_SIMD_CLONES
+#endif
 
 namespace freud { namespace util {
 
@@ -26,24 +43,166 @@ template<class Scalar> inline Scalar modulusPositive(Scalar a, Scalar b)
     return std::fmod(std::fmod(a, b) + b, b);
 }
 
+//! Get the task arena in which parallel loops started by the calling thread run.
+/*! \returns The arena set by setActiveArena on this thread, or nullptr if
+ *  loops run in the arena of the calling thread.
+ */
+tbb::task_arena* getActiveArena();
+
+//! Set the task arena in which parallel loops started by the calling thread run.
+/*! Only the calling thread is affected, so several threads can each run
+ *  computes in their own arena, for example one per NUMA node. Loops nested
+ *  in a parallel loop run in the arena of the outer loop.
+ *
+ *  \param arena The arena, or nullptr to run in the arena of the calling thread.
+ *  \returns The previously active arena of this thread.
+ */
+tbb::task_arena* setActiveArena(tbb::task_arena* arena);
+
+//! Run a function in the active arena of the calling thread (see setActiveArena).
+template<typename Function> inline void executeInActiveArena(const Function& function)
+{
+    tbb::task_arena* arena = getActiveArena();
+    if (arena != nullptr)
+    {
+        arena->execute(function);
+    }
+    else
+    {
+        function();
+    }
+}
+
+//! Strategies for splitting the iterations of a parallel loop among threads.
+enum class LoopPartitioner
+{
+    global_default,   //!< The default set by setDefaultLoopPolicy.
+    automatic,        //!< Split further as threads run out of work (tbb::auto_partitioner).
+    simple,           //!< Split down to the grain size (tbb::simple_partitioner).
+    static_partition, //!< Split evenly among the threads once (tbb::static_partitioner).
+    affinity,         //!< Replay the threads of the previous loop (tbb::affinity_partitioner).
+};
+
+//! Hints on how a parallel loop is split among threads.
+/*! A policy with the affinity partitioner keeps the assignment of iterations
+ *  to threads of the last loop it was used in. A compute that keeps such a
+ *  policy as a member therefore runs the loop of each frame on the threads
+ *  that processed the same iterations in the previous frame, whose caches
+ *  still hold their data. Copies of a policy share this state, so a policy
+ *  must not be used by concurrent loops.
+ */
+struct LoopPolicy
+{
+    //! Constructor
+    /*! \param partitioner The partitioner of the loop.
+     *  \param grain_size Minimum number of iterations per task, or 0 for the default.
+     */
+    explicit LoopPolicy(LoopPartitioner partitioner = LoopPartitioner::global_default, size_t grain_size = 0)
+        : partitioner(partitioner), grain_size(grain_size),
+          affinity_state(partitioner == LoopPartitioner::affinity
+                             ? std::make_shared<tbb::affinity_partitioner>()
+                             : nullptr)
+    {}
+
+    LoopPartitioner partitioner; //!< The partitioner of the loop
+    size_t grain_size;           //!< Minimum number of iterations per task, or 0 for the default
+    std::shared_ptr<tbb::affinity_partitioner> affinity_state; //!< State of the affinity partitioner
+};
+
+//! Get the policy of parallel loops that do not specify a partitioner or grain size.
+LoopPolicy getDefaultLoopPolicy();
+
+//! Set the policy of parallel loops that do not specify a partitioner or grain size.
+/*! The default is the automatic partitioner with a grain size of 1.
+ *
+ *  \param partitioner The automatic, simple or static partitioner. The
+ *         affinity partitioner needs state kept by each loop, so it can only
+ *         be requested by individual loops.
+ *  \param grain_size Minimum number of iterations per task, at least 1.
+ */
+void setDefaultLoopPolicy(LoopPartitioner partitioner, size_t grain_size);
+
 //! Wrapper for for-loop to allow the execution in parallel or not.
-/*! \param begin Beginning index.
+/*! Parallel loops run in the active arena of the calling thread, see
+ *  setActiveArena.
+ *
+ *  \param begin Beginning index.
  *  \param end Ending index.
  *  \param body An object with operator(size_t begin, size_t end).
+ *  \param policy How to split the loop among threads.
  *  \param parallel If true, run body in parallel.
  */
 template<typename Body>
-inline void forLoopWrapper(size_t begin, size_t end, const Body& body, bool parallel = true)
+inline void forLoopWrapper(size_t begin, size_t end, const Body& body, const LoopPolicy& policy,
+                           bool parallel = true)
 {
-    if (parallel)
+    if (!parallel)
     {
-        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end),
-                          [&body](const tbb::blocked_range<size_t>& r) { body(r.begin(), r.end()); });
+        body(begin, end);
+        return;
     }
-    else
+
+    LoopPartitioner partitioner = policy.partitioner;
+    size_t grain_size = policy.grain_size;
+    if (partitioner == LoopPartitioner::global_default || grain_size == 0)
     {
-        body(begin, end);
+        const LoopPolicy default_policy = getDefaultLoopPolicy();
+        if (partitioner == LoopPartitioner::global_default)
+        {
+            partitioner = default_policy.partitioner;
+        }
+        if (grain_size == 0)
+        {
+            grain_size = default_policy.grain_size;
+        }
     }
+
+    const tbb::blocked_range<size_t> range(begin, end, grain_size);
+    // The tasks record into the active profile of the calling thread.
+    FREUD_PROFILE_CAPTURE(profile);
+    const auto loop = [&](const tbb::blocked_range<size_t>& r) {
+        FREUD_PROFILE_ACTIVATE(profile);
+        body(r.begin(), r.end());
+    };
+    executeInActiveArena([&]() {
+        switch (partitioner)
+        {
+        case LoopPartitioner::simple:
+            tbb::parallel_for(range, loop, tbb::simple_partitioner());
+            break;
+        case LoopPartitioner::static_partition:
+            tbb::parallel_for(range, loop, tbb::static_partitioner());
+            break;
+        case LoopPartitioner::affinity:
+            if (policy.affinity_state != nullptr)
+            {
+                tbb::parallel_for(range, loop, *policy.affinity_state);
+            }
+            else
+            {
+                tbb::parallel_for(range, loop, tbb::auto_partitioner());
+            }
+            break;
+        default:
+            tbb::parallel_for(range, loop, tbb::auto_partitioner());
+            break;
+        }
+    });
+}
+
+//! Wrapper for for-loop to allow the execution in parallel or not.
+/*! The loop is split according to the default policy, see
+ *  setDefaultLoopPolicy.
+ *
+ *  \param begin Beginning index.
+ *  \param end Ending index.
+ *  \param body An object with operator(size_t begin, size_t end).
+ *  \param parallel If true, run body in parallel.
+ */
+template<typename Body>
+inline void forLoopWrapper(size_t begin, size_t end, const Body& body, bool parallel = true)
+{
+    forLoopWrapper(begin, end, body, LoopPolicy(), parallel);
 }
 
 //! Wrapper for 2D nested for loops to allow the execution in parallel or not.
@@ -60,10 +219,14 @@ inline void forLoopWrapper2D(size_t begin_row, size_t end_row, size_t begin_col,
 {
     if (parallel)
     {
-        tbb::parallel_for(tbb::blocked_range2d<size_t>(begin_row, end_row, begin_col, end_col),
-                          [&body](const tbb::blocked_range2d<size_t>& r) {
-                              body(r.rows().begin(), r.rows().end(), r.cols().begin(), r.cols().end());
-                          });
+        FREUD_PROFILE_CAPTURE(profile);
+        executeInActiveArena([&]() {
+            tbb::parallel_for(tbb::blocked_range2d<size_t>(begin_row, end_row, begin_col, end_col),
+                              [&](const tbb::blocked_range2d<size_t>& r) {
+                                  FREUD_PROFILE_ACTIVATE(profile);
+                                  body(r.rows().begin(), r.rows().end(), r.cols().begin(), r.cols().end());
+                              });
+        });
     }
     else
     {
@@ -46,9 +46,9 @@ cdef extern from "Box.h" namespace "freud::box":
         void center(vec3[float]*, size_t, float*) const
         void computeDistances(vec3[float]*, unsigned int,
                               vec3[float]*, unsigned int, float*
-                              ) except +
+                              ) nogil except +
         void computeAllDistances(vec3[float]*, unsigned int,
-                                 vec3[float]*, unsigned int, float*)
+                                 vec3[float]*, unsigned int, float*) nogil
         void contains(vec3[float]*, unsigned int, bool*) const
         vec3[bool] getPeriodic() const
         bool getPeriodicX() const
@@ -58,3 +58,17 @@ cdef extern from "Box.h" namespace "freud::box":
         void setPeriodicX(bool)
         void setPeriodicY(bool)
         void setPeriodicZ(bool)
+
+    void makeAbsoluteFrames(const Box*, const vec3[float]*, unsigned int,
+                            unsigned int, vec3[float]*) nogil
+    void makeFractionalFrames(const Box*, const vec3[float]*, unsigned int,
+                              unsigned int, vec3[float]*) nogil
+    void getImagesFrames(const Box*, const vec3[float]*, unsigned int,
+                         unsigned int, vec3[int]*) nogil
+    void wrapFrames(const Box*, const vec3[float]*, unsigned int,
+                    unsigned int, vec3[float]*) nogil
+    void unwrapFrames(const Box*, const vec3[float]*, const vec3[int]*,
+                      unsigned int, unsigned int, vec3[float]*) nogil
+    void unwrapTrajectory(const Box*, const vec3[float]*, unsigned int,
+                          unsigned int, const vec3[int]*, vec3[int]*,
+                          vec3[float]*) nogil
@@ -14,16 +14,24 @@ cdef extern from "Cluster.h" namespace "freud::cluster":
         void compute(const freud._locality.NeighborQuery*,
                      const freud._locality.NeighborList*,
                      freud._locality.QueryArgs,
-                     const unsigned int*) except +
+                     const unsigned int*) nogil except +
+        freud._locality.FrameTask makeFrameTask(unsigned int,
+                                                const unsigned int*)
         unsigned int getNumClusters() const
         const freud.util.ManagedArray[unsigned int] &getClusterIdx() const
-        const vector[vector[uint]] getClusterKeys() const
+        const freud.util.RaggedArray[uint] &getClusterKeys() const
 
 cdef extern from "ClusterProperties.h" namespace "freud::cluster":
     cdef cppclass ClusterProperties:
         ClusterProperties()
         void compute(const freud._locality.NeighborQuery*,
-                     const unsigned int*) except +
+                     const unsigned int*,
+                     const float*) nogil except +
+        freud._locality.FrameTask makeFrameTask(unsigned int)
         const freud.util.ManagedArray[vec3[float]] &getClusterCenters() const
+        const freud.util.ManagedArray[vec3[float]] \
+            &getClusterCentersOfMass() const
         const freud.util.ManagedArray[float] &getClusterGyrations() const
+        const freud.util.ManagedArray[float] &getClusterInertiaTensors() const
         const freud.util.ManagedArray[unsigned int] &getClusterSizes() const
+        const freud.util.ManagedArray[float] &getClusterMasses() const
@@ -2,6 +2,7 @@
 # This file is from the freud project, released under the BSD 3-Clause License.
 
 from libcpp cimport bool
+from libcpp.string cimport string
 
 cimport freud._box
 cimport freud._locality
@@ -13,25 +14,33 @@ ctypedef unsigned int uint
 
 cdef extern from "CorrelationFunction.h" namespace "freud::density":
     cdef cppclass CorrelationFunction[T](BondHistogramCompute):
-        CorrelationFunction(float, float) except +
+        CorrelationFunction(unsigned int, float, unsigned int) except +
+        unsigned int getNumFields() const
         void accumulate(const freud._locality.NeighborQuery*, const T*,
                         const vec3[float]*,
                         const T*,
                         unsigned int, const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[T] &getCorrelation()
 
 cdef extern from "GaussianDensity.h" namespace "freud::density":
     cdef cppclass GaussianDensity:
-        GaussianDensity(vec3[unsigned int], float, float) except +
+        GaussianDensity(vec3[unsigned int], float, float, bool) except +
         const freud._box.Box & getBox() const
         void reset()
         void compute(const freud._locality.NeighborQuery*,
-                     const float*) except +
+                     const float*) nogil except +
+        void computeToFile(const freud._locality.NeighborQuery*,
+                           const float*, const string &,
+                           unsigned int) nogil except +
+        void computeAdaptive(const freud._locality.NeighborQuery*,
+                             const float*, unsigned int) nogil except +
         const freud.util.ManagedArray[float] &getDensity() const
+        const freud.util.ManagedArray[float] &getSigmas() const
         vec3[unsigned int] getWidth() const
         float getSigma() const
         float getRMax() const
+        bool getFFT() const
 
 cdef extern from "LocalDensity.h" namespace "freud::density":
     cdef cppclass LocalDensity:
@@ -41,7 +50,12 @@ cdef extern from "LocalDensity.h" namespace "freud::density":
             const freud._locality.NeighborQuery*,
             const vec3[float]*,
             unsigned int, const freud._locality.NeighborList *,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs) nogil except +
+        void computeAdaptive(
+            const freud._locality.NeighborQuery*,
+            const vec3[float]*,
+            unsigned int,
+            freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float] &getDensity() const
         const freud.util.ManagedArray[float] &getNumNeighbors() const
         float getRMax() const
@@ -49,13 +63,40 @@ cdef extern from "LocalDensity.h" namespace "freud::density":
 
 cdef extern from "RDF.h" namespace "freud::density":
     cdef cppclass RDF(BondHistogramCompute):
-        RDF(float, float, float, bool) except +
+        RDF(float, float, float, bool, unsigned int) except +
+        const freud._box.Box & getBox() const
+        void accumulate(const freud._locality.NeighborQuery*,
+                        const vec3[float]*,
+                        unsigned int,
+                        const freud._locality.NeighborList*,
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.FrameSource &,
+                                  freud._locality.QueryArgs) nogil except +
+        void accumulateSlabs(const freud._box.Box &,
+                             const freud._locality.SlabSource &,
+                             unsigned int,
+                             freud._locality.QueryArgs,
+                             const freud._locality.SlabDomain &) nogil except +
+        freud._locality.FrameTask makeFrameTask(unsigned int)
+        const freud.util.ManagedArray[float] &getRDF()
+        const freud.util.ManagedArray[float] &getNr()
+        unsigned int getBlockSize() const
+        unsigned int getNumBlocks() const
+        const freud.util.ManagedArray[float] &getBlockMean()
+        const freud.util.ManagedArray[float] &getBlockStandardError()
+
+cdef extern from "PartialRDF.h" namespace "freud::density":
+    cdef cppclass PartialRDF(BondHistogramCompute):
+        PartialRDF(unsigned int, float, unsigned int, float) except +
         const freud._box.Box & getBox() const
         void accumulate(const freud._locality.NeighborQuery*,
+                        const unsigned int*,
                         const vec3[float]*,
+                        const unsigned int*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        unsigned int getNumTypes() const
         const freud.util.ManagedArray[float] &getRDF()
         const freud.util.ManagedArray[float] &getNr()
 
@@ -64,7 +105,9 @@ cdef extern from "SphereVoxelization.h" namespace "freud::density":
         SphereVoxelization(vec3[unsigned int], float) except +
         const freud._box.Box & getBox() const
         void reset()
-        void compute(const freud._locality.NeighborQuery*) except +
+        void compute(const freud._locality.NeighborQuery*) nogil except +
+        void computeToFile(const freud._locality.NeighborQuery*,
+                           const string &, unsigned int) nogil except +
         const freud.util.ManagedArray[unsigned int] &getVoxels() const
         vec3[unsigned int] getWidth() const
         float getRMax() const
@@ -0,0 +1,45 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+from libcpp cimport bool
+from libcpp.vector cimport vector
+
+cimport freud._box
+cimport freud._locality
+cimport freud.util
+from freud._locality cimport BondHistogramCompute
+from freud.util cimport quat, vec3
+
+cdef extern from "DiffractionPattern.h" namespace "freud::diffraction":
+    cdef cppclass DiffractionPattern:
+        DiffractionPattern(unsigned int, unsigned int) except +
+        void reset()
+        void accumulate(const freud._box.Box &, const vec3[float]*,
+                        unsigned int, const quat[float]*, unsigned int,
+                        double, double) nogil except +
+        const freud.util.ManagedArray[double] &getDiffraction() const
+        const freud.util.ManagedArray[double] &getKValues() const
+        const freud.util.ManagedArray[vec3[double]] &getKVectors() const
+        unsigned int getNumViews() const
+        unsigned int getGridSize() const
+        unsigned int getOutputSize() const
+
+cdef extern from "StaticStructureFactorDirect.h" namespace "freud::diffraction":
+    cdef cppclass StaticStructureFactorDirect(BondHistogramCompute):
+        StaticStructureFactorDirect(unsigned int, float, float) except +
+        void accumulate(const freud._locality.NeighborQuery*) nogil except +
+        const freud.util.ManagedArray[float] &getStructureFactor()
+        float getMinValidK() const
+
+cdef extern from "StaticStructureFactorRDF.h" namespace "freud::diffraction":
+    cdef cppclass StaticStructureFactorRDF(BondHistogramCompute):
+        StaticStructureFactorRDF(unsigned int, float, float, unsigned int,
+                                 float, bool) except +
+        void accumulate(const freud._locality.NeighborQuery*,
+                        const vec3[float]*, unsigned int,
+                        const freud._locality.NeighborList*,
+                        freud._locality.QueryArgs) nogil except +
+        const freud.util.ManagedArray[float] &getStructureFactor()
+        bool getLorchWindow() const
+        vector[float] getKBinEdges() const
+        vector[float] getKBinCenters() const
@@ -29,7 +29,7 @@ cdef extern from "BondOrder.h" namespace "freud::environment":
             quat[float]*,
             unsigned int,
             const freud._locality.NeighborList*,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float] &getBondOrder()
         BondOrderMode getMode() const
 
@@ -51,7 +51,7 @@ cdef extern from "LocalDescriptors.h" namespace "freud::environment":
             const quat[float]*,
             const freud._locality.NeighborList*,
             freud._locality.QueryArgs,
-            unsigned int) except +
+            unsigned int) nogil except +
         const freud.util.ManagedArray[float complex] &getSph() const
         freud._locality.NeighborList * getNList()
         LocalDescriptorOrientation getMode() const
@@ -81,7 +81,7 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
                      const vec3[float]*,
                      unsigned int,
                      float,
-                     bool) except +
+                     bool) nogil except +
         const freud.util.ManagedArray[bool] &getMatches()
 
     cdef cppclass EnvironmentRMSDMinimizer(MatchEnv):
@@ -92,7 +92,7 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
             freud._locality.QueryArgs,
             const vec3[float]*,
             unsigned int,
-            bool) except +
+            bool) nogil except +
         const freud.util.ManagedArray[float] &getRMSDs()
 
     cdef cppclass EnvironmentCluster(MatchEnv):
@@ -104,10 +104,10 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
                      freud._locality.QueryArgs,
                      float,
                      bool,
-                     bool) except +
+                     bool) nogil except +
         unsigned int getNumClusters()
         const freud.util.ManagedArray[unsigned int] &getClusters()
-        vector[vector[vec3[float]]] &getClusterEnvironments()
+        const freud.util.RaggedArray[vec3[float]] &getClusterEnvironments() const
 
 cdef extern from "AngularSeparation.h" namespace "freud::environment":
     cdef cppclass AngularSeparationGlobal:
@@ -117,8 +117,11 @@ cdef extern from "AngularSeparation.h" namespace "freud::environment":
                      quat[float]*,
                      unsigned int,
                      quat[float]*,
-                     unsigned int) except +
+                     unsigned int,
+                     bool) nogil except +
         const freud.util.ManagedArray[float] &getAngles() const
+        const freud.util.ManagedArray[float] &getMinAngles() const
+        const freud.util.ManagedArray[unsigned int] &getMinIndices() const
 
     cdef cppclass AngularSeparationNeighbor:
         AngularSeparationNeighbor()
@@ -129,7 +132,7 @@ cdef extern from "AngularSeparation.h" namespace "freud::environment":
             const quat[float]*, unsigned int,
             const quat[float]*, unsigned int,
             const freud._locality.NeighborList*,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float] &getAngles() const
         freud._locality.NeighborList * getNList()
 
@@ -140,7 +143,7 @@ cdef extern from "LocalBondProjection.h" namespace "freud::environment":
                      vec3[float]*, unsigned int, vec3[float]*, unsigned int,
                      quat[float]*, unsigned int, const
                      freud._locality.NeighborList*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
 
         const freud.util.ManagedArray[float] &getProjections() const
         const freud.util.ManagedArray[float] &getNormedProjections() const
@@ -0,0 +1,20 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+cimport freud._locality
+cimport freud.util
+from freud.util cimport vec3
+
+
+cdef extern from "Interface.h" namespace "freud::interface":
+    cdef cppclass Interface:
+        Interface() except +
+        void compute(const freud._locality.NeighborQuery*,
+                     const vec3[float]*,
+                     unsigned int,
+                     const freud._locality.NeighborList*,
+                     freud._locality.QueryArgs) nogil except +
+        unsigned int getPointCount() const
+        const freud.util.ManagedArray[unsigned int] &getPointIds() const
+        unsigned int getQueryPointCount() const
+        const freud.util.ManagedArray[unsigned int] &getQueryPointIds() const
@@ -1,9 +1,11 @@
 # Copyright (c) 2010-2020 The Regents of the University of Michigan
 # This file is from the freud project, released under the BSD 3-Clause License.
 
+from libc.stdint cimport uint64_t
 from libcpp cimport bool
 from libcpp.memory cimport shared_ptr
 from libcpp.pair cimport pair
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 
 cimport freud._box
@@ -28,6 +30,18 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         ball "freud::locality::QueryType::ball"
         nearest "freud::locality::QueryType::nearest"
 
+    ctypedef enum RegionShape "freud::locality::RegionShape":
+        region_none "freud::locality::RegionShape::none"
+        region_box "freud::locality::RegionShape::box"
+        region_sphere "freud::locality::RegionShape::sphere"
+
+    cdef cppclass QueryRegion:
+        RegionShape shape
+        vec3[float] lower
+        vec3[float] upper
+        vec3[float] center
+        float radius
+
     cdef cppclass QueryArgs:
         QueryType mode
         int num_neighbors
@@ -36,6 +50,10 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         float r_guess
         float scale
         bool exclude_ii
+        unsigned int point_type
+        QueryRegion region
+
+    unsigned int DEFAULT_POINT_TYPE "freud::locality::DEFAULT_POINT_TYPE"
 
     cdef cppclass NeighborQuery:
         NeighborQuery() except +
@@ -48,6 +66,8 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         const vec3[float]* getPoints const
         const unsigned int getNPoints const
         const vec3[float] operator[](unsigned int) const
+        void setSortQueryPoints(bool)
+        bool getSortQueryPoints() const
 
     NeighborBond ITERATOR_TERMINATOR \
         "freud::locality::ITERATOR_TERMINATOR"
@@ -58,6 +78,8 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         bool end()
         NeighborBond next()
         NeighborList *toNeighborList(bool)
+        void toNeighborListFile(const string &, unsigned int,
+                                bool) nogil except +
 
 cdef extern from "RawPoints.h" namespace "freud::locality":
 
@@ -68,6 +90,10 @@ cdef extern from "RawPoints.h" namespace "freud::locality":
                   unsigned int) except +
 
 cdef extern from "NeighborList.h" namespace "freud::locality":
+    ctypedef enum MergeMode "freud::locality::MergeMode":
+        unite "freud::locality::MergeMode::unite"
+        intersect "freud::locality::MergeMode::intersect"
+
     cdef cppclass NeighborList:
         NeighborList()
         NeighborList(unsigned int)
@@ -87,13 +113,86 @@ cdef extern from "NeighborList.h" namespace "freud::locality":
         void setNumBonds(unsigned int, unsigned int, unsigned int)
         unsigned int filter[Iterator](const Iterator) except +
         unsigned int filter_r(float, float) except +
+        void mergeSorted(const NeighborList &, MergeMode) nogil except +
+        void symmetrize() nogil except +
 
         unsigned int find_first_index(unsigned int)
 
+        void compact(bool)
+        bool isCompact() const
+        size_t getMemoryUsage() const
+
         void resize(unsigned int)
         void copy(const NeighborList &)
         void validate(unsigned int, unsigned int) except +
 
+cdef extern from "NeighborListFile.h" namespace "freud::locality":
+    void writeNeighborList(const NeighborList &, const string &) nogil except +
+    NeighborList *readNeighborList(const string &) nogil except +
+    NeighborList *mapNeighborList(const string &) nogil except +
+
+cdef extern from "CachedNeighborList.h" namespace "freud::locality":
+    cdef cppclass CachedNeighborList:
+        CachedNeighborList(float, float) except +
+        void compute(const NeighborQuery*, const vec3[float]*, unsigned int,
+                     bool) nogil except +
+        void reset()
+        float getRMax() const
+        float getSkin() const
+        unsigned int getNumBuilds() const
+        shared_ptr[NeighborList] getNeighborList() const
+
+cdef extern from "NeighborQueryPlan.h" namespace "freud::locality":
+    cdef cppclass NeighborQueryPlan:
+        NeighborQueryPlan()
+        void compute(const NeighborQuery*, const vec3[float]*, unsigned int,
+                     const vector[QueryArgs] &) nogil except +
+        unsigned int getNumQueries() const
+        unsigned int getNumPasses() const
+        shared_ptr[NeighborList] getNeighborList(unsigned int) except +
+
+cdef extern from "TrajectoryPipeline.h" namespace "freud::locality":
+    cdef cppclass FrameSource:
+        pass
+    FrameSource makeFrameArraySource(
+        const vector[freud._box.Box] &,
+        const vector[const vec3[float]*] &,
+        const vector[unsigned int] &) nogil except +
+
+cdef extern from "SlabStream.h" namespace "freud::locality":
+    cdef cppclass SlabSource:
+        pass
+    ctypedef bool (*SlabCallback)(float, float, void*, const vec3[float]**,
+                                  unsigned int*)
+    SlabSource makeSlabCallbackSource(SlabCallback, void*) nogil except +
+    cdef cppclass CountReducer:
+        pass
+    ctypedef bool (*CountCallback)(uint64_t*, size_t, void*)
+    CountReducer makeCountCallbackReducer(CountCallback, void*) nogil except +
+    cdef cppclass SlabDomain:
+        SlabDomain()
+        unsigned int first_slab
+        unsigned int last_slab
+        CountReducer reducer
+
+cdef extern from "AnalysisGraph.h" namespace "freud::locality":
+    cdef cppclass FrameTask:
+        pass
+    ctypedef bool (*FrameCallback)(size_t, void*)
+    cdef cppclass AnalysisGraph:
+        AnalysisGraph()
+        unsigned int addNeighbors(const QueryArgs &)
+        unsigned int addTask(
+            FrameTask, const vector[unsigned int] &,
+            const freud.util.ManagedArray[unsigned int]*) except +
+        void setFrameCallback(FrameCallback, void*)
+        void run(const FrameSource &) nogil except +
+        unsigned int getNumNodes() const
+        bool isNeighborNode(unsigned int) except +
+        const freud.util.ManagedArray[unsigned int]* getPointLabels(
+            unsigned int) except +
+        size_t getNumFrames() const
+
 cdef extern from "LinkCell.h" namespace "freud::locality":
     cdef cppclass LinkCell(NeighborQuery):
         LinkCell() except +
@@ -102,6 +201,9 @@ cdef extern from "LinkCell.h" namespace "freud::locality":
                  unsigned int,
                  float) except +
         float getCellWidth() const
+        void update(const freud._box.Box &,
+                    const vec3[float]*,
+                    unsigned int) except +
 
 cdef extern from "AABBQuery.h" namespace "freud::locality":
     cdef cppclass AABBQuery(NeighborQuery):
@@ -109,6 +211,31 @@ cdef extern from "AABBQuery.h" namespace "freud::locality":
         AABBQuery(const freud._box.Box,
                   const vec3[float]*,
                   unsigned int) except +
+        void update(const freud._box.Box &,
+                    const vec3[float]*,
+                    unsigned int) except +
+
+cdef extern from "TypedNeighborQuery.h" namespace "freud::locality":
+    cdef cppclass TypedNeighborQuery(NeighborQuery):
+        TypedNeighborQuery(const freud._box.Box,
+                           const vec3[float]*,
+                           unsigned int,
+                           const unsigned int*,
+                           unsigned int) except +
+        unsigned int getNumTypes() const
+        const unsigned int* getTypes() const
+        unsigned int getNumPointsOfType(unsigned int) except +
+
+cdef extern from "Histogram.h" namespace "freud::util":
+    ctypedef enum AccumulationStrategy "freud::util::AccumulationStrategy":
+        automatic "freud::util::AccumulationStrategy::automatic"
+        dense "freud::util::AccumulationStrategy::dense"
+        atomic "freud::util::AccumulationStrategy::atomic"
+        tiled "freud::util::AccumulationStrategy::tiled"
+
+    ctypedef enum CountPrecision "freud::util::CountPrecision":
+        uint32 "freud::util::CountPrecision::uint32"
+        uint64 "freud::util::CountPrecision::uint64"
 
 cdef extern from "BondHistogramCompute.h" namespace "freud::locality":
     cdef cppclass BondHistogramCompute:
@@ -116,12 +243,28 @@ cdef extern from "BondHistogramCompute.h" namespace "freud::locality":
 
         const freud._box.Box & getBox() const
         void reset()
+        void setAccumulationStrategy(AccumulationStrategy)
+        AccumulationStrategy getAccumulationStrategy() const
+        void setCountPrecision(CountPrecision)
+        CountPrecision getCountPrecision() const
         const freud.util.ManagedArray[unsigned int] &getBinCounts()
+        const freud.util.ManagedArray[uint64_t] &getWideBinCounts()
         vector[vector[float]] getBinEdges() const
         vector[vector[float]] getBinCenters() const
         vector[pair[float, float]] getBounds() const
         vector[size_t] getAxisSizes() const
 
+cdef extern from "BondKernel.h" namespace "freud::locality":
+    cdef cppclass BondKernel:
+        pass
+
+    void loopOverBondKernels(const vector[BondKernel*] &,
+                             const NeighborQuery*,
+                             const vec3[float]*,
+                             unsigned int,
+                             const NeighborList*,
+                             QueryArgs) nogil except +
+
 cdef extern from "PeriodicBuffer.h" namespace "freud::locality":
     cdef cppclass PeriodicBuffer:
         PeriodicBuffer()
@@ -130,14 +273,21 @@ cdef extern from "PeriodicBuffer.h" namespace "freud::locality":
         void compute(
             const NeighborQuery*,
             const vec3[float],
-            const bool) except +
+            const bool) nogil except +
         vector[vec3[float]] getBufferPoints() const
         vector[uint] getBufferIds() const
 
 cdef extern from "Voronoi.h" namespace "freud::locality":
     cdef cppclass Voronoi:
         Voronoi()
-        void compute(const NeighborQuery*) nogil except +
-        vector[vector[vec3[double]]] getPolytopes() const
+        void compute(const NeighborQuery*, bool, bool) nogil except +
+        void update(const NeighborQuery*, bool, bool) nogil except +
+        unsigned int getNumComputedCells() const
+        const freud.util.RaggedArray[vec3[double]] &getPolytopes() const
         const freud.util.ManagedArray[double] &getVolumes() const
+        bool getComputeStatistics() const
+        const freud.util.ManagedArray[double] &getSurfaceAreas() const
+        const freud.util.ManagedArray[double] &getSurfaceTensors() const
+        const freud.util.ManagedArray[double] &getCurvatureTensors() const
+        const freud.util.ManagedArray[double] &getAsphericities() const
         shared_ptr[NeighborList] getNeighborList() const
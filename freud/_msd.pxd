@@ -0,0 +1,36 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+cimport freud._box
+cimport freud.util
+from freud.util cimport vec3
+
+
+cdef extern from "MSD.h" namespace "freud::msd":
+    ctypedef enum MSDMode:
+        window
+        direct
+
+    cdef cppclass MSD:
+        MSD(const freud._box.Box &, MSDMode) except +
+        void reset()
+        void accumulate(const vec3[float]*, const vec3[int]*, unsigned int,
+                        unsigned int) nogil except +
+        const freud.util.ManagedArray[double] &getMSD() const
+        const freud.util.ManagedArray[double] &getParticleMSD() const
+        const freud._box.Box &getBox() const
+        MSDMode getMode() const
+
+    cdef cppclass MultiTauMSD:
+        MultiTauMSD(const freud._box.Box &, unsigned int,
+                    unsigned int) except +
+        void reset()
+        void accumulate(const vec3[float]*, const vec3[int]*,
+                        unsigned int) nogil except +
+        const freud.util.ManagedArray[unsigned int] &getLags() const
+        const freud.util.ManagedArray[double] &getMSD() const
+        const freud.util.ManagedArray[unsigned int] &getCounts() const
+        unsigned int getNumFrames() const
+        const freud._box.Box &getBox() const
+        unsigned int getPointsPerLevel() const
+        unsigned int getLevelRatio() const
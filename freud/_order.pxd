@@ -20,7 +20,7 @@ cdef extern from "Cubatic.h" namespace "freud::order":
                 unsigned int) except +
         void reset()
         void compute(quat[float]*,
-                     unsigned int) except +
+                     unsigned int) nogil except +
         unsigned int getNumParticles() const
         float getCubaticOrderParameter() const
         const freud.util.ManagedArray[float] &getParticleOrderParameter() const
@@ -39,7 +39,8 @@ cdef extern from "Nematic.h" namespace "freud::order":
         Nematic(vec3[float])
         void reset()
         void compute(quat[float]*,
-                     unsigned int) except +
+                     unsigned int,
+                     bool) nogil except +
         unsigned int getNumParticles() const
         float getNematicOrderParameter() const
         const freud.util.ManagedArray[float] &getParticleTensor() const
@@ -49,41 +50,42 @@ cdef extern from "Nematic.h" namespace "freud::order":
 
 
 cdef extern from "HexaticTranslational.h" namespace "freud::order":
-    cdef cppclass Hexatic:
+    cdef cppclass Hexatic(freud._locality.BondKernel):
         Hexatic(unsigned int, bool)
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float complex] &getOrder()
         unsigned int getK()
         bool isWeighted() const
 
-    cdef cppclass Translational:
+    cdef cppclass Translational(freud._locality.BondKernel):
         Translational(float, bool)
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float complex] &getOrder() const
         float getK() const
         bool isWeighted() const
 
 
 cdef extern from "Steinhardt.h" namespace "freud::order":
-    cdef cppclass Steinhardt:
-        Steinhardt(unsigned int, bool, bool, bool, bool) except +
+    cdef cppclass Steinhardt(freud._locality.BondKernel):
+        Steinhardt(vector[unsigned int], bool, bool, bool, bool) except +
         unsigned int getNP() const
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
+        freud._locality.FrameTask makeFrameTask(unsigned int)
         const freud.util.ManagedArray[float] &getQl() const
-        const freud.util.ManagedArray[float] &getQlm() const
+        const vector[freud.util.ManagedArray[float]] &getQlm() const
         const freud.util.ManagedArray[float] &getParticleOrder() const
-        float getOrder() const
+        const vector[float] &getOrder() const
         bool isAverage() const
         bool isWl() const
         bool isWeighted() const
         bool isWlNormalized() const
-        unsigned int getL() const
+        const vector[unsigned int] &getL() const
 
 
 cdef extern from "SolidLiquid.h" namespace "freud::order":
@@ -96,6 +98,7 @@ cdef extern from "SolidLiquid.h" namespace "freud::order":
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
                      freud._locality.QueryArgs) nogil except +
+        freud._locality.FrameTask makeFrameTask(unsigned int)
         unsigned int getLargestClusterSize() const
         vector[unsigned int] getClusterSizes() const
         const freud.util.ManagedArray[unsigned int] &getClusterIdx() const
@@ -114,4 +117,7 @@ cdef extern from "RotationalAutocorrelation.h" namespace "freud::order":
         unsigned int getL() const
         const freud.util.ManagedArray[float complex] &getRAArray() const
         float getRotationalAutocorrelation() const
-        void compute(quat[float]*, quat[float]*, unsigned int) except +
+        const freud.util.ManagedArray[float] &getAutocorrelation() const
+        void compute(quat[float]*, quat[float]*, unsigned int) nogil except +
+        void computeTrajectory(const quat[float]*, unsigned int,
+                               unsigned int) nogil except +
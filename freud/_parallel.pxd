@@ -1,5 +1,32 @@
 # Copyright (c) 2010-2020 The Regents of the University of Michigan
 # This file is from the freud project, released under the BSD 3-Clause License.
 
+from libcpp cimport bool
+from libcpp.vector cimport vector
+
 cdef extern from "tbb_config.h" namespace "freud::parallel":
     void setNumThreads(unsigned int)
+
+cdef extern from "TaskArena.h" namespace "freud::parallel":
+    vector[int] getNumaNodes()
+
+    cdef cppclass TaskArena:
+        TaskArena(int, unsigned int, bool) except +
+        void enter()
+        void exit() except +
+        int getNumaNode() const
+        unsigned int getNumThreads() const
+        bool getPinThreads() const
+
+cdef extern from "utils.h" namespace "freud::util":
+    ctypedef enum LoopPartitioner "freud::util::LoopPartitioner":
+        automatic "freud::util::LoopPartitioner::automatic"
+        simple "freud::util::LoopPartitioner::simple"
+        static_partition "freud::util::LoopPartitioner::static_partition"
+
+    cdef cppclass LoopPolicy:
+        LoopPartitioner partitioner
+        size_t grain_size
+
+    LoopPolicy getDefaultLoopPolicy()
+    void setDefaultLoopPolicy(LoopPartitioner, size_t) except +
@@ -11,6 +11,7 @@ cdef extern from "PMFT.h" namespace "freud::pmft":
     cdef cppclass PMFT(BondHistogramCompute):
         PMFT() except +
         const freud.util.ManagedArray[float] &getPCF()
+        const freud.util.ManagedArray[float] &getPMFT()
 
 cdef extern from "PMFTR12.h" namespace "freud::pmft":
     cdef cppclass PMFTR12(PMFT):
@@ -22,7 +23,7 @@ cdef extern from "PMFTR12.h" namespace "freud::pmft":
                         const float*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
 
 cdef extern from "PMFTXYT.h" namespace "freud::pmft":
     cdef cppclass PMFTXYT(PMFT):
@@ -35,7 +36,7 @@ cdef extern from "PMFTXYT.h" namespace "freud::pmft":
                         const float*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
 
 cdef extern from "PMFTXY.h" namespace "freud::pmft":
     cdef cppclass PMFTXY(PMFT):
@@ -46,7 +47,7 @@ cdef extern from "PMFTXY.h" namespace "freud::pmft":
                         const vec3[float]*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
 
 cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
     cdef cppclass PMFTXYZ(PMFT):
@@ -60,4 +61,4 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
                         const quat[float]*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
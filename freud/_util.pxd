@@ -3,8 +3,12 @@
 
 cimport numpy
 from libcpp cimport bool
+from libcpp.map cimport map
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 
+ctypedef unsigned int uint
+
 
 cdef extern from "VectorMath.h":
     cdef cppclass vec3[Real]:
@@ -28,6 +32,53 @@ cdef extern from "ManagedArray.h" namespace "freud::util":
         size_t size() const
         vector[size_t] shape() const
 
+cdef extern from "RaggedArray.h" namespace "freud::util":
+    cdef cppclass RaggedArray[T]:
+        RaggedArray()
+        size_t getNumSegments() const
+        size_t getNumValues() const
+        const ManagedArray[uint] &getOffsets() const
+        const ManagedArray[T] &getValues() const
+
 
 cdef extern from "numpy/arrayobject.h":
     cdef int PyArray_SetBaseObject(numpy.ndarray arr, obj)
+
+
+cdef extern from "BufferPool.h" namespace "freud::util":
+    cdef cppclass BufferPoolStatistics:
+        size_t allocations
+        size_t reuses
+        size_t releases
+        size_t evictions
+        size_t cached_bytes
+
+    cdef cppclass BufferPool:
+        @staticmethod
+        BufferPool &instance()
+        void clear()
+        void setEnabled(bool enabled)
+        void setMaxCachedBytes(size_t max_cached_bytes)
+        BufferPoolStatistics getStatistics() const
+        void resetStatistics()
+
+
+cdef extern from "Profiler.h" namespace "freud::util":
+    cdef cppclass ProfileEntry:
+        size_t calls
+        double seconds
+        size_t count
+
+    cdef cppclass Profile:
+        Profile()
+        map[string, ProfileEntry] getEntries() const
+        string getChromeTrace(int) const
+        void reset()
+
+    cdef cppclass ProfileScope:
+        ProfileScope(Profile*)
+
+    cdef cppclass ScopedTimer:
+        ScopedTimer(const char*)
+
+    bool isProfilingAvailable()
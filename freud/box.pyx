@@ -16,7 +16,9 @@ import freud.util
 
 cimport numpy as np
 from cpython.object cimport Py_EQ, Py_NE
+from cython.operator cimport dereference
 from libcpp cimport bool as cpp_bool
+from libcpp.vector cimport vector
 
 cimport freud._box
 from freud.util cimport vec3
@@ -498,10 +500,11 @@ cdef class Box:
             float[::1] distances = np.empty(
                 n_query_points, dtype=np.float32)
 
-        self.thisptr.computeDistances(
-            <vec3[float]*> &l_query_points[0, 0], n_query_points,
-            <vec3[float]*> &l_points[0, 0], n_points,
-            <float *> &distances[0])
+        with nogil:
+            self.thisptr.computeDistances(
+                <vec3[float]*> &l_query_points[0, 0], n_query_points,
+                <vec3[float]*> &l_points[0, 0], n_points,
+                <float *> &distances[0])
         return np.asarray(distances)
 
     def compute_all_distances(self, query_points, points):
@@ -533,10 +536,11 @@ cdef class Box:
             float[:, ::1] distances = np.empty(
                 [n_query_points, n_points], dtype=np.float32)
 
-        self.thisptr.computeAllDistances(
-            <vec3[float]*> &l_query_points[0, 0], n_query_points,
-            <vec3[float]*> &l_points[0, 0], n_points,
-            <float *> &distances[0, 0])
+        with nogil:
+            self.thisptr.computeAllDistances(
+                <vec3[float]*> &l_query_points[0, 0], n_query_points,
+                <vec3[float]*> &l_points[0, 0], n_points,
+                <float *> &distances[0, 0])
 
         return np.asarray(distances)
 
@@ -895,6 +899,293 @@ cdef class Box:
         return cls(Lx=L, Ly=L, Lz=0, xy=0, xz=0, yz=0, is2D=True)
 
 
+cdef vector[freud._box.Box] _frame_boxes(boxes, unsigned int n_frames) except *:
+    R"""Convert the boxes of a stack of frames into C++ boxes.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        n_frames (unsigned int):
+            Number of frames.
+    """
+    cdef vector[freud._box.Box] cpp_boxes
+    cdef Box b
+    if isinstance(boxes, Box):
+        b = boxes
+        cpp_boxes.assign(n_frames, dereference(b.thisptr))
+        return cpp_boxes
+    if len(boxes) != n_frames:
+        raise ValueError(
+            "The number of boxes ({}) must match the number of frames "
+            "({}).".format(len(boxes), n_frames))
+    for box in boxes:
+        b = Box.from_box(box)
+        cpp_boxes.push_back(dereference(b.thisptr))
+    return cpp_boxes
+
+
+def _convert_frames(vecs):
+    R"""Convert a stack of frames of vectors to a C-contiguous array of shape
+    :math:`\left(N_{frames}, N, 3\right)`."""
+    return freud.util._convert_array(vecs, shape=(None, None, 3))
+
+
+def make_absolute_frames(boxes, fractional_coordinates, out=None):
+    R"""Convert the fractional coordinates of a stack of frames into absolute
+    coordinates, with the box of each frame.
+
+    All vectors of all frames are converted in a single parallel loop, with
+    results identical to calling :meth:`Box.make_absolute` on each frame.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        fractional_coordinates (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Fractional coordinate vectors of each frame.
+        out (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray` or :code:`None`):
+            The array in which to place the absolute coordinates. It must be
+            of dtype `np.float32`. If ``None``, this function will return a
+            newly allocated array (Default value = None).
+
+    Returns:
+        :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`:
+            Absolute coordinate vectors. If ``out`` is provided, a reference to
+            it is returned.
+    """  # noqa: E501
+    fractions = _convert_frames(fractional_coordinates)
+    out = freud.util._convert_array(
+        out, shape=fractions.shape, allow_copy=False)
+
+    cdef const float[:, :, ::1] l_points = fractions
+    cdef float[:, :, ::1] l_out = out
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if n_frames == 0 or Np == 0:
+        return out
+
+    with nogil:
+        freud._box.makeAbsoluteFrames(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0], n_frames,
+            Np, <vec3[float]*> &l_out[0, 0, 0])
+    return out
+
+
+def make_fractional_frames(boxes, absolute_coordinates, out=None):
+    R"""Convert the absolute coordinates of a stack of frames into fractional
+    coordinates, with the box of each frame.
+
+    All vectors of all frames are converted in a single parallel loop, with
+    results identical to calling :meth:`Box.make_fractional` on each frame.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        absolute_coordinates (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Absolute coordinate vectors of each frame.
+        out (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray` or :code:`None`):
+            The array in which to place the fractional coordinates. It must be
+            of dtype `np.float32`. If ``None``, this function will return a
+            newly allocated array (Default value = None).
+
+    Returns:
+        :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`:
+            Fractional coordinate vectors. If ``out`` is provided, a reference
+            to it is returned.
+    """  # noqa: E501
+    vecs = _convert_frames(absolute_coordinates)
+    out = freud.util._convert_array(out, shape=vecs.shape, allow_copy=False)
+
+    cdef const float[:, :, ::1] l_points = vecs
+    cdef float[:, :, ::1] l_out = out
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if n_frames == 0 or Np == 0:
+        return out
+
+    with nogil:
+        freud._box.makeFractionalFrames(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0], n_frames,
+            Np, <vec3[float]*> &l_out[0, 0, 0])
+    return out
+
+
+def get_images_frames(boxes, vecs):
+    R"""Returns the images of the unwrapped vectors of a stack of frames,
+    with the box of each frame.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        vecs (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Unwrapped vectors of each frame.
+
+    Returns:
+        :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`:
+            Image index vectors.
+    """  # noqa: E501
+    vecs = _convert_frames(vecs)
+    images = np.zeros(vecs.shape, dtype=np.int32)
+
+    cdef const float[:, :, ::1] l_points = vecs
+    cdef int[:, :, ::1] l_result = images
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if n_frames == 0 or Np == 0:
+        return images
+
+    with nogil:
+        freud._box.getImagesFrames(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0], n_frames,
+            Np, <vec3[int]*> &l_result[0, 0, 0])
+    return images
+
+
+def wrap_frames(boxes, vecs, out=None):
+    R"""Wrap the vectors of a stack of frames into the box of each frame.
+
+    The vectors are wrapped in a single parallel loop over all frames by a
+    vectorized kernel, with results identical to calling :meth:`Box.wrap` on
+    each frame.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        vecs (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Unwrapped vectors of each frame.
+        out (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray` or :code:`None`):
+            The array in which to place the wrapped vectors. It must be of
+            dtype `np.float32`. If ``None``, this function will return a newly
+            allocated array (Default value = None).
+
+    Returns:
+        :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`:
+            Vectors wrapped into the boxes. If ``out`` is provided, a reference
+            to it is returned.
+    """  # noqa: E501
+    vecs = _convert_frames(vecs)
+    out = freud.util._convert_array(out, shape=vecs.shape, allow_copy=False)
+
+    cdef const float[:, :, ::1] l_points = vecs
+    cdef float[:, :, ::1] l_out = out
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if n_frames == 0 or Np == 0:
+        return out
+
+    with nogil:
+        freud._box.wrapFrames(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0], n_frames,
+            Np, <vec3[float]*> &l_out[0, 0, 0])
+    return out
+
+
+def unwrap_frames(boxes, vecs, imgs, out=None):
+    R"""Unwrap the vectors of a stack of frames with their image indices and
+    the box of each frame.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        vecs (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Vectors of each frame to be unwrapped.
+        imgs (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Image indices of the vectors.
+        out (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray` or :code:`None`):
+            The array in which to place the unwrapped vectors. It must be of
+            dtype `np.float32`. If ``None``, this function will return a newly
+            allocated array (Default value = None).
+
+    Returns:
+        :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`:
+            Unwrapped vectors. If ``out`` is provided, a reference to it is
+            returned.
+    """  # noqa: E501
+    vecs = _convert_frames(vecs)
+    imgs = freud.util._convert_array(imgs, shape=vecs.shape, dtype=np.int32)
+    out = freud.util._convert_array(out, shape=vecs.shape, allow_copy=False)
+
+    cdef const float[:, :, ::1] l_points = vecs
+    cdef const int[:, :, ::1] l_imgs = imgs
+    cdef float[:, :, ::1] l_out = out
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if n_frames == 0 or Np == 0:
+        return out
+
+    with nogil:
+        freud._box.unwrapFrames(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0],
+            <vec3[int]*> &l_imgs[0, 0, 0], n_frames, Np,
+            <vec3[float]*> &l_out[0, 0, 0])
+    return out
+
+
+def unwrap_trajectory(boxes, vecs, initial_images=None):
+    R"""Unwrap a trajectory by tracking the image indices of each vector
+    across consecutive frames.
+
+    The image index of a vector changes between consecutive frames whenever
+    its fractional coordinates jump by more than half of the box in a periodic
+    direction. The fractional coordinates of each frame are computed with the
+    box of that frame, so this supports boxes which change shape during the
+    trajectory as long as no vector moves by half of the box between two
+    consecutive frames. The image indices and the unwrapped vectors of all
+    frames are found in a single pass, in parallel over the vectors.
+
+    Args:
+        boxes (:class:`~.Box` or sequence of box-like objects):
+            A single :class:`~.Box` shared by all frames, or one box-like
+            object per frame.
+        vecs (:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Vectors of each frame, usually wrapped into the box.
+        initial_images (:math:`\left(N, 3\right)` :class:`numpy.ndarray`, optional):
+            Image indices of the vectors of the first frame. If ``None``, they
+            are all zero (Default value = None).
+
+    Returns:
+        tuple(:math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`, :math:`\left(N_{frames}, N, 3\right)` :class:`numpy.ndarray`):
+            Unwrapped vectors and image indices of each frame.
+    """  # noqa: E501
+    vecs = _convert_frames(vecs)
+    out = np.empty(vecs.shape, dtype=np.float32)
+    images = np.zeros(vecs.shape, dtype=np.int32)
+
+    cdef const float[:, :, ::1] l_points = vecs
+    cdef float[:, :, ::1] l_out = out
+    cdef int[:, :, ::1] l_images = images
+    cdef const int[:, ::1] l_initial_images
+    cdef const vec3[int]* l_initial_images_ptr = NULL
+    cdef unsigned int n_frames = l_points.shape[0]
+    cdef unsigned int Np = l_points.shape[1]
+    cdef vector[freud._box.Box] cpp_boxes = _frame_boxes(boxes, n_frames)
+    if initial_images is not None:
+        initial_images = freud.util._convert_array(
+            initial_images, shape=(Np, 3), dtype=np.int32)
+        if Np > 0:
+            l_initial_images = initial_images
+            l_initial_images_ptr = <vec3[int]*> &l_initial_images[0, 0]
+    if n_frames == 0 or Np == 0:
+        return out, images
+
+    with nogil:
+        freud._box.unwrapTrajectory(
+            cpp_boxes.data(), <vec3[float]*> &l_points[0, 0, 0], n_frames,
+            Np, l_initial_images_ptr, <vec3[int]*> &l_images[0, 0, 0],
+            <vec3[float]*> &l_out[0, 0, 0])
+    return out, images
+
+
 cdef BoxFromCPP(const freud._box.Box & cppbox):
     b = Box(cppbox.getLx(), cppbox.getLy(), cppbox.getLz(),
             cppbox.getTiltFactorXY(), cppbox.getTiltFactorXZ(),
@@ -94,13 +94,23 @@ cdef class Cluster(_PairCompute):
                 keys, shape=(num_query_points, ), dtype=np.uint32)
             l_keys_ptr = &l_keys[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(),
-            nlist.get_ptr(),
-            dereference(qargs.thisptr),
-            l_keys_ptr)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                nlist.get_ptr(),
+                dereference(qargs.thisptr),
+                l_keys_ptr)
         return self
 
+    def _add_to_graph(self, freud.locality.AnalysisGraph graph, neighbors,
+                      clusters, dependencies):
+        R"""Add this compute to an :class:`~.locality.AnalysisGraph`."""
+        neighbors = graph._neighbors_dependency(
+            neighbors, clusters, type(self).__name__)
+        return graph.thisptr.addTask(
+            self.thisptr.makeFrameTask(neighbors, NULL), dependencies,
+            &self.thisptr.getClusterIdx())
+
     @_Compute._computed_property
     def num_clusters(self):
         """int: The number of clusters."""
@@ -116,10 +126,12 @@ cdef class Cluster(_PairCompute):
 
     @_Compute._computed_property
     def cluster_keys(self):
-        """list(list): A list of lists of the keys contained in each
-        cluster."""
-        cluster_keys = self.thisptr.getClusterKeys()
-        return cluster_keys
+        """list[:class:`numpy.ndarray`]: A list of arrays of the keys
+        contained in each cluster."""
+        return freud.util.make_managed_numpy_ragged_array(
+            &self.thisptr.getClusterKeys().getOffsets(),
+            &self.thisptr.getClusterKeys().getValues(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     def __repr__(self):
         return "freud.cluster.{cls}()".format(cls=type(self).__name__)
@@ -157,14 +169,21 @@ cdef class ClusterProperties(_Compute):
     Given a set of points and cluster ids (from :class:`~.Cluster` or another
     source), this class determines the following properties for each cluster:
 
+     - Center
      - Center of mass
      - Gyration tensor
+     - Moment of inertia tensor
      - Size (number of points)
-
-    The center of mass for each cluster (properly handling periodic boundary
-    conditions) can be accessed with :code:`centers` attribute.  The :math:`3
-    \times 3` symmetric gyration tensors :math:`G` can be accessed with
-    :code:`gyrations` attribute.
+     - Mass
+
+    The center for each cluster (properly handling periodic boundary
+    conditions) can be accessed with :code:`centers` attribute, and the
+    mass-weighted center with the :code:`centers_of_mass` attribute.  The
+    :math:`3 \times 3` symmetric gyration tensors :math:`G` about the centers
+    can be accessed with :code:`gyrations` attribute, and the moment of
+    inertia tensors :math:`I` about the centers of mass can be accessed with
+    the :code:`inertia_tensors` attribute. All properties are computed in a
+    single call to :meth:`compute`.
     """
 
     cdef freud._cluster.ClusterProperties * thisptr
@@ -178,12 +197,13 @@ cdef class ClusterProperties(_Compute):
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, system, cluster_idx):
+    def compute(self, system, cluster_idx, masses=None):
         R"""Compute properties of the point clusters.
-        Loops over all points in the given array and determines the center of
-        mass of the cluster as well as the gyration tensor. After calling
-        this method, these properties can be accessed with the
-        :code:`centers` and :code:`gyrations` attributes.
+        Loops over all points in the given array and determines the center
+        and center of mass of the cluster as well as the gyration and inertia
+        tensors. After calling this method, these properties can be accessed
+        with the :code:`centers`, :code:`centers_of_mass`, :code:`gyrations`
+        and :code:`inertia_tensors` attributes.
 
         Example::
 
@@ -204,25 +224,55 @@ cdef class ClusterProperties(_Compute):
                 :class:`freud.locality.NeighborQuery.from_system`.
             cluster_idx ((:math:`N_{points}`,) :class:`np.ndarray`):
                 Cluster indexes for each point.
+            masses ((:math:`N_{points}`,) :class:`np.ndarray`, optional):
+                Mass of each point, used for the centers of mass, inertia
+                tensors and cluster masses. If :code:`None`, all points have
+                unit mass (Default value = :code:`None`).
         """
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
         cluster_idx = freud.util._convert_array(
             cluster_idx, shape=(nq.points.shape[0], ), dtype=np.uint32)
         cdef const unsigned int[::1] l_cluster_idx = cluster_idx
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <unsigned int*> &l_cluster_idx[0])
+
+        cdef float* l_masses_ptr = NULL
+        cdef float[::1] l_masses
+        if masses is not None:
+            l_masses = freud.util._convert_array(
+                masses, shape=(nq.points.shape[0], ))
+            l_masses_ptr = &l_masses[0]
+
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <unsigned int*> &l_cluster_idx[0],
+                l_masses_ptr)
         return self
 
+    def _add_to_graph(self, freud.locality.AnalysisGraph graph, neighbors,
+                      clusters, dependencies):
+        R"""Add this compute to an :class:`~.locality.AnalysisGraph`."""
+        clusters = graph._clusters_dependency(
+            neighbors, clusters, type(self).__name__)
+        return graph.thisptr.addTask(
+            self.thisptr.makeFrameTask(clusters), dependencies, NULL)
+
     @_Compute._computed_property
     def centers(self):
         """(:math:`N_{clusters}`, 3) :class:`numpy.ndarray`: The centers of
-        mass of the clusters."""
+        the clusters."""
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getClusterCenters(),
             freud.util.arr_type_t.FLOAT, 3)
 
+    @_Compute._computed_property
+    def centers_of_mass(self):
+        """(:math:`N_{clusters}`, 3) :class:`numpy.ndarray`: The centers of
+        mass of the clusters."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterCentersOfMass(),
+            freud.util.arr_type_t.FLOAT, 3)
+
     @_Compute._computed_property
     def gyrations(self):
         """(:math:`N_{clusters}`, 3, 3) :class:`numpy.ndarray`: The gyration
@@ -231,6 +281,14 @@ cdef class ClusterProperties(_Compute):
             &self.thisptr.getClusterGyrations(),
             freud.util.arr_type_t.FLOAT)
 
+    @_Compute._computed_property
+    def inertia_tensors(self):
+        """(:math:`N_{clusters}`, 3, 3) :class:`numpy.ndarray`: The moment of
+        inertia tensors of the clusters about their centers of mass."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterInertiaTensors(),
+            freud.util.arr_type_t.FLOAT)
+
     @_Compute._computed_property
     def radii_of_gyration(self):
         """(:math:`N_{clusters}`,) :class:`numpy.ndarray`: The radius of
@@ -244,5 +302,13 @@ cdef class ClusterProperties(_Compute):
             &self.thisptr.getClusterSizes(),
             freud.util.arr_type_t.UNSIGNED_INT)
 
+    @_Compute._computed_property
+    def cluster_masses(self):
+        """(:math:`N_{clusters}`) :class:`numpy.ndarray`: The total mass of
+        each cluster."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterMasses(),
+            freud.util.arr_type_t.FLOAT)
+
     def __repr__(self):
         return "freud.cluster.{cls}()".format(cls=type(self).__name__)
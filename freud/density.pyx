@@ -7,6 +7,7 @@ density of the system. These functions allow evaluation of particle
 distributions with respect to other particles.
 """
 
+import os
 import warnings
 
 import numpy as np
@@ -14,15 +15,25 @@ import numpy as np
 import freud.locality
 
 from cython.operator cimport dereference
-
-from freud.locality cimport _PairCompute, _SpatialHistogram1D
+from libc.stdint cimport uint64_t
+from libcpp cimport bool as cbool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from freud.locality cimport (
+    _PairCompute,
+    _SpatialHistogram,
+    _SpatialHistogram1D,
+)
 from freud.util cimport _Compute, vec3
 
 from collections.abc import Sequence
 
 cimport numpy as np
 
+cimport freud._box
 cimport freud._density
+cimport freud._locality
 cimport freud.box
 cimport freud.locality
 cimport freud.util
@@ -55,18 +66,30 @@ cdef class CorrelationFunction(_SpatialHistogram1D):
         :code:`None`, we omit accumulating the self-correlation value in the
         first bin.
 
+    Several fields can be correlated in one pass over the bonds by setting
+    :code:`num_fields`. The values then have one column for each field, each
+    field of :code:`values` is correlated with the same field of
+    :code:`query_values`, and the correlation has one column for each field.
+
     Args:
         bins (unsigned int):
             The number of bins in the correlation function.
         r_max (float):
             Maximum pointwise distance to include in the calculation.
+        num_fields (unsigned int, optional):
+            The number of fields correlated together. If greater than 1, the
+            values have shape :math:`\left(N, N_{fields}\right)` and the
+            correlation has shape :math:`\left(N_{bins}, N_{fields}\right)`
+            (Default value = 1).
     """  # noqa E501
     cdef freud._density.CorrelationFunction[np.complex128_t] * thisptr
     cdef is_complex
 
-    def __cinit__(self, unsigned int bins, float r_max):
+    def __cinit__(self, unsigned int bins, float r_max,
+                  unsigned int num_fields=1):
         self.thisptr = self.histptr = new \
-            freud._density.CorrelationFunction[np.complex128_t](bins, r_max)
+            freud._density.CorrelationFunction[np.complex128_t](
+                bins, r_max, num_fields)
         self.r_max = r_max
         self.is_complex = False
 
@@ -82,14 +105,15 @@ cdef class CorrelationFunction(_SpatialHistogram1D):
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
-            values ((:math:`N_{points}`) :class:`numpy.ndarray`):
+            values ((:math:`N_{points}`) or (:math:`N_{points}`, :math:`N_{fields}`) :class:`numpy.ndarray`):
                 Values associated with the system points used to calculate the
-                correlation function.
+                correlation function, with one column for each field if
+                :code:`num_fields` is greater than 1.
             query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
                 Query points used to calculate the correlation function.  Uses
                 the system's points if :code:`None` (Default value =
                 :code:`None`).
-            query_values ((:math:`N_{query\_points}`) :class:`numpy.ndarray`, optional):
+            query_values ((:math:`N_{query\_points}`) or (:math:`N_{query\_points}`, :math:`N_{fields}`) :class:`numpy.ndarray`, optional):
                 Query values used to calculate the correlation function.  Uses
                 :code:`values` if :code:`None`.  (Default value
                 = :code:`None`).
@@ -122,39 +146,51 @@ cdef class CorrelationFunction(_SpatialHistogram1D):
         self.is_complex = self.is_complex or np.any(np.iscomplex(values)) or \
             np.any(np.iscomplex(query_values))
 
+        field_shape = (self.num_fields, ) if self.num_fields > 1 else ()
         values = freud.util._convert_array(
-            values, shape=(nq.points.shape[0], ), dtype=np.complex128)
+            values, shape=(nq.points.shape[0], ) + field_shape,
+            dtype=np.complex128)
         if query_values is None:
             query_values = values
         else:
             query_values = freud.util._convert_array(
-                query_values, shape=(l_query_points.shape[0], ),
+                query_values, shape=(l_query_points.shape[0], ) + field_shape,
                 dtype=np.complex128)
 
-        cdef np.complex128_t[::1] l_values = values
-        cdef np.complex128_t[::1] l_query_values = query_values
-
-        self.thisptr.accumulate(
-            nq.get_ptr(),
-            <np.complex128_t*> &l_values[0],
-            <vec3[float]*> &l_query_points[0, 0],
-            <np.complex128_t*> &l_query_values[0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        cdef np.complex128_t[::1] l_values = values.ravel()
+        cdef np.complex128_t[::1] l_query_values = query_values.ravel()
+
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(),
+                <np.complex128_t*> &l_values[0],
+                <vec3[float]*> &l_query_points[0, 0],
+                <np.complex128_t*> &l_query_values[0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
+    @property
+    def num_fields(self):
+        """unsigned int: The number of fields correlated together."""
+        return self.thisptr.getNumFields()
+
     @_Compute._computed_property
     def correlation(self):
-        """(:math:`N_{bins}`) :class:`numpy.ndarray`: Expected (average)
-        product of all values at a given radial distance."""
+        """(:math:`N_{bins}`) or (:math:`N_{bins}`, :math:`N_{fields}`) :class:`numpy.ndarray`:
+        Expected (average) product of all values at a given radial
+        distance, with one column for each field if :code:`num_fields` is
+        greater than 1."""  # noqa E501
         output = freud.util.make_managed_numpy_array(
             &self.thisptr.getCorrelation(),
             freud.util.arr_type_t.COMPLEX_DOUBLE)
         return output if self.is_complex else np.real(output)
 
     def __repr__(self):
-        return ("freud.density.{cls}(bins={bins}, r_max={r_max})").format(
-            cls=type(self).__name__, bins=self.nbins, r_max=self.r_max)
+        return ("freud.density.{cls}(bins={bins}, r_max={r_max}, "
+                "num_fields={num_fields})").format(
+                    cls=type(self).__name__, bins=self.nbins, r_max=self.r_max,
+                    num_fields=self.num_fields)
 
     def plot(self, ax=None):
         """Plot complex correlation function.
@@ -203,6 +239,36 @@ cdef class GaussianDensity(_Compute):
     dimensions of the grid are set in the constructor, and can either be set
     equally for all dimensions or for each dimension independently.
 
+    In the default :code:`'direct'` mode, the Gaussian of each point is
+    evaluated at every grid cell within :code:`r_max` of the point. In
+    orthorhombic boxes, the Gaussian factorizes along the box axes and is
+    accumulated from tables along each axis, which is much faster than the
+    evaluation at each grid cell required in triclinic boxes. The
+    :code:`'fft'` mode deposits the points onto the grid with cloud-in-cell
+    weights and convolves them with the Gaussian using fast Fourier
+    transforms. Its cost does not depend on :code:`r_max`, which makes it
+    much faster for large grids and wide Gaussians, but it introduces a
+    discretization error of order :math:`(\Delta x / \sigma)^2` for a grid
+    spacing :math:`\Delta x`. The :code:`'fft'` mode requires a periodic,
+    orthorhombic box.
+
+    Grids too large to be held in memory can be written to a file by passing
+    a :code:`filename` to :meth:`compute`. The grid is then filled in slabs of
+    consecutive cells along :math:`x`, each of which is written to the file as
+    soon as it is complete, so only one slab is held in memory at a time. The
+    file holds the grid as raw :code:`float32` values in C order, and
+    :attr:`density` returns a read-only :class:`numpy.memmap` of it. The
+    :code:`'fft'` mode transforms the whole grid at once and cannot write to
+    a file.
+
+    Alternatively, :meth:`compute_adaptive` adapts the width of the Gaussian
+    of each point to the distance :math:`d_k` to its :math:`k` th nearest
+    neighbor, :math:`\sigma_i = \min(d_k, \sigma)`, and cuts it off at
+    :math:`\sigma_i r_{max} / \sigma`. Dense regions are then resolved by
+    narrow Gaussians that each cover few grid cells, while sparse regions are
+    smoothed by Gaussians as wide as :code:`sigma`, so the cost per point is
+    at most that of :meth:`compute`.
+
     Args:
         width (int or Sequence[int]):
             The number of bins to make the grid in each dimension (identical
@@ -211,10 +277,15 @@ cdef class GaussianDensity(_Compute):
             Distance over which to blur.
         sigma (float):
             Sigma parameter for Gaussian.
+        mode (str, optional):
+            Method used to compute the density, either :code:`'direct'` or
+            :code:`'fft'` (Default value = :code:`'direct'`).
     """  # noqa: E501
     cdef freud._density.GaussianDensity * thisptr
+    cdef object _filename
+    cdef bint _adaptive
 
-    def __cinit__(self, width, r_max, sigma):
+    def __cinit__(self, width, r_max, sigma, mode='direct'):
         cdef vec3[uint] width_vector
         if isinstance(width, int):
             width_vector = vec3[uint](width, width, width)
@@ -227,8 +298,11 @@ cdef class GaussianDensity(_Compute):
                              "sequence indicating the widths in each spatial "
                              "dimension (length 2 in 2D, length 3 in 3D).")
 
+        if mode not in ['direct', 'fft']:
+            raise ValueError("The mode must be either 'direct' or 'fft'.")
+
         self.thisptr = new freud._density.GaussianDensity(
-            width_vector, r_max, sigma)
+            width_vector, r_max, sigma, mode == 'fft')
 
     def __dealloc__(self):
         del self.thisptr
@@ -238,7 +312,7 @@ cdef class GaussianDensity(_Compute):
         """:class:`freud.box.Box`: Box used in the calculation."""
         return freud.box.BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, system, values=None):
+    def compute(self, system, values=None, filename=None, slab_width=0):
         R"""Calculates the Gaussian blur for the specified points.
 
         Args:
@@ -250,6 +324,15 @@ cdef class GaussianDensity(_Compute):
                 convolution. Calculates Gaussian blur (equivalent to providing
                 a value of 1 for every point) if :code:`None`. (Default value
                 = :code:`None`).
+            filename (str, optional):
+                If provided, the density is written to this file in slabs
+                instead of being held in memory (Default value =
+                :code:`None`).
+            slab_width (int, optional):
+                Number of grid cells along :math:`x` of the slabs held in
+                memory when writing to a file, rounded up to the width of the
+                tiles that are filled in parallel. The narrowest slabs are
+                used if 0 (Default value = 0).
         """
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
@@ -261,14 +344,88 @@ cdef class GaussianDensity(_Compute):
                 values, shape=(nq.points.shape[0], ))
             l_values_ptr = &l_values[0]
 
-        self.thisptr.compute(nq.get_ptr(),
-                             l_values_ptr)
+        cdef string c_filename
+        cdef unsigned int c_slab_width = slab_width
+        if filename is None:
+            with nogil:
+                self.thisptr.compute(nq.get_ptr(),
+                                     l_values_ptr)
+        else:
+            c_filename = os.fsencode(filename)
+            with nogil:
+                self.thisptr.computeToFile(nq.get_ptr(), l_values_ptr,
+                                           c_filename, c_slab_width)
+        self._filename = filename
+        self._adaptive = False
         return self
 
+    def compute_adaptive(self, system, num_neighbors, values=None):
+        R"""Calculates the density with Gaussians whose widths adapt to the
+        distances to the nearest neighbors of each point.
+
+        The neighbors are found with a nearest neighbor query within
+        :code:`sigma`. Points with fewer than :code:`num_neighbors` neighbors
+        within :code:`sigma` use Gaussians of width :code:`sigma`, and the
+        widths are at least half of the smallest grid spacing.
+
+        Example::
+
+            >>> import freud
+            >>> box, points = freud.data.make_random_system(10, 100, seed=0)
+            >>> gd = freud.density.GaussianDensity(40, r_max=3, sigma=1)
+            >>> gd.compute_adaptive(system=(box, points), num_neighbors=8)
+            freud.density.GaussianDensity(...)
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            num_neighbors (unsigned int):
+                Number of nearest neighbors whose farthest member sets the
+                width of the Gaussian of each point.
+            values ((:math:`N_{points}`) :class:`numpy.ndarray`):
+                Values associated with the system points, as in
+                :meth:`compute` (Default value = :code:`None`).
+        """
+        cdef freud.locality.NeighborQuery nq = \
+            freud.locality.NeighborQuery.from_system(system)
+
+        cdef float* l_values_ptr = NULL
+        cdef float[::1] l_values
+        if values is not None:
+            l_values = freud.util._convert_array(
+                values, shape=(nq.points.shape[0], ))
+            l_values_ptr = &l_values[0]
+
+        cdef unsigned int c_num_neighbors = num_neighbors
+        with nogil:
+            self.thisptr.computeAdaptive(nq.get_ptr(), l_values_ptr,
+                                         c_num_neighbors)
+        self._filename = None
+        self._adaptive = True
+        self._called_compute = True
+        return self
+
+    @_Compute._computed_property
+    def sigmas(self):
+        """(:math:`N_{points}`) :class:`numpy.ndarray`: The width of the
+        Gaussian of each point in the last call to
+        :meth:`compute_adaptive`."""
+        if not self._adaptive:
+            raise AttributeError("The widths of the Gaussians are only "
+                                 "available after compute_adaptive.")
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getSigmas(), freud.util.arr_type_t.FLOAT)
+
     @_Compute._computed_property
     def density(self):
         """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
-        grid with the Gaussian density contributions from each point."""
+        grid with the Gaussian density contributions from each point, mapped
+        from the file if the density was written to one."""
+        if self._filename is not None:
+            data = np.memmap(self._filename, dtype=np.float32, mode='r',
+                             shape=self.width)
+            return np.squeeze(data, axis=2) if self.box.is2D else data
         if self.box.is2D:
             return np.squeeze(freud.util.make_managed_numpy_array(
                 &self.thisptr.getDensity(), freud.util.arr_type_t.FLOAT))
@@ -293,12 +450,18 @@ cdef class GaussianDensity(_Compute):
         cdef vec3[uint] width = self.thisptr.getWidth()
         return (width.x, width.y, width.z)
 
+    @property
+    def mode(self):
+        """str: Method used to compute the density."""
+        return 'fft' if self.thisptr.getFFT() else 'direct'
+
     def __repr__(self):
-        return ("freud.density.{cls}({width}, "
-                "{r_max}, {sigma})").format(cls=type(self).__name__,
-                                            width=self.width,
-                                            r_max=self.r_max,
-                                            sigma=self.sigma)
+        return ("freud.density.{cls}({width}, {r_max}, {sigma}, "
+                "mode={mode})").format(cls=type(self).__name__,
+                                       width=self.width,
+                                       r_max=self.r_max,
+                                       sigma=self.sigma,
+                                       mode=repr(self.mode))
 
     def plot(self, ax=None):
         """Plot Gaussian Density.
@@ -340,8 +503,15 @@ cdef class SphereVoxelization(_Compute):
             in all dimensions if a single integer value is provided).
         r_max (float):
             Sphere radius.
+
+    Grids too large to be held in memory can be written to a file by passing
+    a :code:`filename` to :meth:`compute`, in which case the grid is filled
+    and written in slabs along :math:`x` as in :class:`GaussianDensity`. The
+    file holds the grid as raw :code:`uint32` values in C order, and
+    :attr:`voxels` returns a read-only :class:`numpy.memmap` of it.
     """
     cdef freud._density.SphereVoxelization * thisptr
+    cdef object _filename
 
     def __cinit__(self, width, r_max):
         cdef vec3[uint] width_vector
@@ -367,23 +537,47 @@ cdef class SphereVoxelization(_Compute):
         """:class:`freud.box.Box`: Box used in the calculation."""
         return freud.box.BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, system):
+    def compute(self, system, filename=None, slab_width=0):
         R"""Calculates the voxelization of spheres about the specified points.
 
         Args:
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
+            filename (str, optional):
+                If provided, the voxels are written to this file in slabs
+                instead of being held in memory (Default value =
+                :code:`None`).
+            slab_width (int, optional):
+                Number of grid cells along :math:`x` of the slabs held in
+                memory when writing to a file, rounded up to the width of the
+                tiles that are filled in parallel. The narrowest slabs are
+                used if 0 (Default value = 0).
         """
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
-        self.thisptr.compute(nq.get_ptr())
+        cdef string c_filename
+        cdef unsigned int c_slab_width = slab_width
+        if filename is None:
+            with nogil:
+                self.thisptr.compute(nq.get_ptr())
+        else:
+            c_filename = os.fsencode(filename)
+            with nogil:
+                self.thisptr.computeToFile(nq.get_ptr(), c_filename,
+                                           c_slab_width)
+        self._filename = filename
         return self
 
     @_Compute._computed_property
     def voxels(self):
         """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
-        voxel grid indicating overlap with the computed spheres."""
+        voxel grid indicating overlap with the computed spheres, mapped from
+        the file if the voxels were written to one."""
+        if self._filename is not None:
+            data = np.memmap(self._filename, dtype=np.uint32, mode='r',
+                             shape=self.width)
+            return np.squeeze(data, axis=2) if self.box.is2D else data
         data = freud.util.make_managed_numpy_array(
             &self.thisptr.getVoxels(), freud.util.arr_type_t.UNSIGNED_INT)
         if self.box.is2D:
@@ -460,6 +654,12 @@ cdef class LocalDensity(_PairCompute):
 
     .. image:: images/density.png
 
+    Alternatively, :meth:`compute_adaptive` estimates the density around each
+    query point from a fixed number :math:`k` of its nearest neighbors as
+    :math:`k` divided by the area (volume) of the circle (sphere) reaching the
+    farthest of them, so that the radius adapts to the local density. This
+    mode does not use :code:`r_max` or :code:`diameter`.
+
     Args:
         r_max (float):
             Maximum distance over which to calculate the density.
@@ -525,11 +725,60 @@ cdef class LocalDensity(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, query_points, neighbors)
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
+        return self
+
+    def compute_adaptive(self, system, num_neighbors, query_points=None):
+        R"""Calculates the local density from the distances to a fixed number
+        of nearest neighbors of each query point.
+
+        The neighbors are accumulated directly from the query, without
+        building a :class:`freud.locality.NeighborList`. The
+        :attr:`num_neighbors` of each query point is the number of neighbors
+        found, which is :code:`num_neighbors` unless the system has fewer
+        points.
+
+        Example::
+
+            >>> import freud
+            >>> box, points = freud.data.make_random_system(10, 100, seed=0)
+            >>> ld = freud.density.LocalDensity(r_max=3, diameter=0.05)
+            >>> ld.compute_adaptive(system=(box, points), num_neighbors=8)
+            freud.density.LocalDensity(...)
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            num_neighbors (unsigned int):
+                Number of nearest neighbors to estimate the density from.
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to calculate the local density. Uses the
+                system's points if :code:`None` (Default value =
+                :code:`None`).
+        """  # noqa E501
+        cdef:
+            freud.locality.NeighborQuery nq
+            freud.locality.NeighborList nlist
+            freud.locality._QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(
+                system, query_points,
+                dict(mode="nearest", num_neighbors=num_neighbors))
+        with nogil:
+            self.thisptr.computeAdaptive(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, dereference(qargs.thisptr))
+        self._called_compute = True
         return self
 
     @property
@@ -605,15 +854,28 @@ cdef class RDF(_SpatialHistogram1D):
             arguments are provided to :meth:`~.compute`, specifically if
             :code:`exclude_ii` is set to :code:`False`. This normalization is
             not meaningful in such cases and will simply convolute the data.
+        block_size (unsigned int, optional):
+            If nonzero, the frames accumulated since the last reset are also
+            averaged in blocks of :code:`block_size` consecutive calls to
+            :meth:`~.compute`, and the mean and standard error of the mean of
+            the RDFs of the blocks are available as :attr:`block_mean` and
+            :attr:`block_standard_error`. The blocks are computed while the
+            frames are accumulated, so error bars do not require a separate
+            RDF for each block. Frames of an incomplete last block are only
+            included in :attr:`rdf` (Default value = :code:`0`).
 
     """
     cdef freud._density.RDF * thisptr
+    cdef object _slab_source
+    cdef object _slab_allreduce
+    cdef object _slab_error
+    cdef object _slab_points
 
     def __cinit__(self, unsigned int bins, float r_max, float r_min=0,
-                  normalize=False):
+                  normalize=False, unsigned int block_size=0):
         if type(self) == RDF:
             self.thisptr = self.histptr = new freud._density.RDF(
-                bins, r_max, r_min, normalize)
+                bins, r_max, r_min, normalize, block_size)
 
             # r_max is left as an attribute rather than a property for now
             # since that change needs to happen at the _SpatialHistogram level
@@ -659,13 +921,206 @@ cdef class RDF(_SpatialHistogram1D):
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, query_points, neighbors)
 
-        self.thisptr.accumulate(
-            nq.get_ptr(),
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, frames, neighbors=None, reset=True):
+        R"""Calculates the RDF of every frame of a trajectory and adds them to
+        the current RDF histogram.
+
+        This is equivalent to calling :meth:`compute` on each frame with
+        :code:`reset=False`, but the neighbor queries of the following frames
+        are built in parallel with the binning of the bonds of each frame.
+
+        Args:
+            frames (iterable):
+                The frames of the trajectory, each a tuple of the form
+                (box_like, array_like) of the box and the points of the frame.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+        """  # noqa E501
+        if neighbors is not None and type(neighbors) != dict:
+            raise ValueError('The neighbors of a trajectory must be given as '
+                             'a dict of query arguments.')
+        if reset:
+            self._reset()
+
+        cdef freud.locality.NeighborList nlist
+        cdef freud.locality._QueryArgs qargs
+        nlist, qargs = self._resolve_neighbors(neighbors)
+
+        cdef vector[freud._box.Box] l_boxes
+        cdef vector[const vec3[float]*] l_points
+        cdef vector[unsigned int] l_n_points
+        cdef freud.box.Box b
+        cdef const float[:, ::1] l_frame_points
+
+        # The converted arrays must outlive the computation.
+        frame_points = []
+        for box, points in frames:
+            b = freud.util._convert_box(box)
+            points = freud.util._convert_array(points, shape=(None, 3))
+            frame_points.append(points)
+            l_frame_points = points
+            l_boxes.push_back(dereference(b.thisptr))
+            l_points.push_back(<vec3[float]*> &l_frame_points[0, 0])
+            l_n_points.push_back(l_frame_points.shape[0])
+
+        with nogil:
+            self.thisptr.accumulateTrajectory(
+                freud._locality.makeFrameArraySource(
+                    l_boxes, l_points, l_n_points),
+                dereference(qargs.thisptr))
         return self
 
+    def compute_streaming(self, box, source, num_slabs, neighbors=None,
+                          reset=True, slabs=None, allreduce=None):
+        R"""Calculates the RDF of a system streamed in slabs and adds it to
+        the current RDF histogram.
+
+        Systems too large to be held in memory, for instance snapshots stored
+        in chunked files, are processed in :code:`num_slabs` slabs of equal
+        width along the first box vector. The points of each slab and of a
+        halo of width :code:`r_max` around it are loaded from the source, so
+        only one slab and its halo are held in memory at a time, and the
+        following slab is loaded while the bonds of each slab are binned. The
+        system is accumulated as a single frame, with the same bonds as
+        :meth:`compute` would find with all points in memory.
+
+        .. code-block:: python
+
+            def source(begin, end):
+                # The points whose fractional coordinates along the first box
+                # vector, wrapped into [0, 1), lie in [begin, end).
+                fractions = box.make_fractional(points)[:, 0] % 1
+                return points[(fractions >= begin) & (fractions < end)]
+
+            rdf.compute_streaming(box, source, num_slabs=16)
+
+        The slabs can also be divided among the processes of a domain
+        decomposition, for instance the ranks of an MPI job. Each process
+        then processes the contiguous range :code:`slabs` of the slabs, loading
+        their halos from the source itself, and the bin counts of the
+        processes are summed with :code:`allreduce`, so every process holds
+        the RDF of the whole system:
+
+        .. code-block:: python
+
+            from mpi4py import MPI
+
+            comm = MPI.COMM_WORLD
+            num_slabs = 4 * comm.size
+            rdf.compute_streaming(
+                box, source, num_slabs,
+                slabs=range(4 * comm.rank, 4 * (comm.rank + 1)),
+                allreduce=lambda counts: comm.Allreduce(MPI.IN_PLACE, counts))
+
+        Args:
+            box (:class:`freud.box.Box`):
+                Simulation box of the system, which must be periodic along
+                the first box vector.
+            source (callable):
+                Function called with the bounds :code:`begin` and :code:`end`
+                of a range of fractional coordinates along the first box
+                vector, with :code:`0 <= begin < end <= 1`, returning the
+                (:math:`N_{range}`, 3) points whose fractional coordinate,
+                wrapped into :math:`[0, 1)`, lies in :code:`[begin, end)`.
+                Each point must be returned by exactly one range of any
+                partition of :math:`[0, 1)`.
+            num_slabs (unsigned int):
+                Number of slabs.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_,
+                which must set a finite :code:`r_max` (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            slabs (range, optional):
+                The contiguous range of slabs processed by this process of a
+                domain decomposition. All slabs are processed if
+                :code:`None` (Default value: None).
+            allreduce (callable, optional):
+                Function called once with a :class:`numpy.ndarray` of
+                :code:`numpy.uint64` counts, which it must replace in place
+                by their sum over all processes of the domain decomposition.
+                The counts are not combined if :code:`None`, so the histogram
+                only holds the bonds of the slabs of this process (Default
+                value: None).
+        """  # noqa E501
+        if neighbors is not None and type(neighbors) != dict:
+            raise ValueError('The neighbors of a streamed system must be '
+                             'given as a dict of query arguments.')
+        if not callable(source):
+            raise ValueError('The source of a streamed system must be '
+                             'callable.')
+        if allreduce is not None and not callable(allreduce):
+            raise ValueError('The allreduce of a streamed system must be '
+                             'callable.')
+        if slabs is not None and (not isinstance(slabs, range)
+                                  or slabs.step != 1):
+            raise ValueError('The slabs of a process must be a range of '
+                             'consecutive slabs.')
+        if reset:
+            self._reset()
+
+        cdef freud.box.Box b = freud.util._convert_box(box)
+        cdef unsigned int l_num_slabs = num_slabs
+        cdef freud.locality.NeighborList nlist
+        cdef freud.locality._QueryArgs qargs
+        nlist, qargs = self._resolve_neighbors(neighbors)
+
+        cdef freud._locality.SlabDomain domain
+        if slabs is not None:
+            domain.first_slab = max(slabs.start, 0)
+            domain.last_slab = max(slabs.stop, slabs.start, 0)
+        if allreduce is not None:
+            domain.reducer = freud._locality.makeCountCallbackReducer(
+                <freud._locality.CountCallback> _call_slab_allreduce,
+                <void*> self)
+
+        self._slab_source = source
+        self._slab_allreduce = allreduce
+        self._slab_error = None
+        try:
+            with nogil:
+                self.thisptr.accumulateSlabs(
+                    dereference(b.thisptr),
+                    freud._locality.makeSlabCallbackSource(
+                        <freud._locality.SlabCallback> _call_slab_source,
+                        <void*> self),
+                    l_num_slabs, dereference(qargs.thisptr), domain)
+        except RuntimeError:
+            if self._slab_error is not None:
+                raise self._slab_error
+            raise
+        finally:
+            self._slab_source = None
+            self._slab_allreduce = None
+            self._slab_error = None
+            self._slab_points = None
+        return self
+
+    def _add_to_graph(self, freud.locality.AnalysisGraph graph, neighbors,
+                      clusters, dependencies):
+        R"""Add this compute to an :class:`~.locality.AnalysisGraph`."""
+        neighbors = graph._neighbors_dependency(
+            neighbors, clusters, type(self).__name__)
+        return graph.thisptr.addTask(
+            self.thisptr.makeFrameTask(neighbors), dependencies, NULL)
+
     @_Compute._computed_property
     def rdf(self):
         """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Histogram of RDF
@@ -685,12 +1140,54 @@ cdef class RDF(_SpatialHistogram1D):
             &self.thisptr.getNr(),
             freud.util.arr_type_t.FLOAT)
 
+    @property
+    def block_size(self):
+        """unsigned int: The number of frames of each block, or 0 if blocks
+        are not computed."""
+        return self.thisptr.getBlockSize()
+
+    @_Compute._computed_property
+    def num_blocks(self):
+        """unsigned int: The number of complete blocks accumulated since the
+        last reset."""
+        return self.thisptr.getNumBlocks()
+
+    def _check_blocks(self):
+        if self.block_size == 0:
+            raise AttributeError(
+                "Blocks are only computed by an RDF with a nonzero "
+                "block_size.")
+
+    @_Compute._computed_property
+    def block_mean(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Mean of the RDFs of
+        the complete blocks, or NaN if there are none."""
+        self._check_blocks()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getBlockMean(),
+            freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def block_standard_error(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Standard error of the
+        mean of the RDFs of the complete blocks, the standard deviation of
+        the blocks divided by the square root of the number of blocks, or NaN
+        if there are fewer than two blocks."""
+        self._check_blocks()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getBlockStandardError(),
+            freud.util.arr_type_t.FLOAT)
+
     def __repr__(self):
+        block_size = (", block_size={}".format(self.block_size)
+                      if self.block_size != 0 else "")
         return ("freud.density.{cls}(bins={bins}, r_max={r_max}, "
-                "r_min={r_min})").format(cls=type(self).__name__,
-                                         bins=len(self.bin_centers),
-                                         r_max=self.bounds[1],
-                                         r_min=self.bounds[0])
+                "r_min={r_min}{block_size})").format(
+                    cls=type(self).__name__,
+                    bins=len(self.bin_centers),
+                    r_max=self.bounds[1],
+                    r_min=self.bounds[0],
+                    block_size=block_size)
 
     def plot(self, ax=None):
         """Plot radial distribution function.
@@ -716,3 +1213,220 @@ cdef class RDF(_SpatialHistogram1D):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef cbool _call_slab_source(float begin, float end, void* data,
+                             const vec3[float]** points,
+                             unsigned int* num_points) with gil:
+    R"""Load the points of a range from the source of
+    :meth:`RDF.compute_streaming`, storing any exception it raises so that it
+    can be raised once the computation stops."""
+    cdef RDF rdf = <RDF> data
+    cdef const float[:, ::1] l_points
+    try:
+        range_points = freud.util._convert_array(
+            rdf._slab_source(begin, end), shape=(None, 3))
+    except BaseException as error:
+        rdf._slab_error = error
+        return False
+    # The points must remain valid until the next range is loaded.
+    rdf._slab_points = range_points
+    num_points[0] = range_points.shape[0]
+    if num_points[0] > 0:
+        l_points = range_points
+        points[0] = <vec3[float]*> &l_points[0, 0]
+    return True
+
+
+cdef cbool _call_slab_allreduce(uint64_t* counts, size_t num_counts,
+                                void* data) with gil:
+    R"""Sum the counts of :meth:`RDF.compute_streaming` over the processes of
+    a domain decomposition with its allreduce, storing any exception it
+    raises so that it can be raised once the computation stops."""
+    cdef RDF rdf = <RDF> data
+    cdef uint64_t[::1] l_counts = <uint64_t[:num_counts]> counts
+    try:
+        rdf._slab_allreduce(np.asarray(l_counts))
+    except BaseException as error:
+        rdf._slab_error = error
+        return False
+    return True
+
+
+cdef class PartialRDF(_SpatialHistogram):
+    R"""Computes the partial RDFs :math:`g_{ab} \left( r \right)` of all
+    pairs of types of a mixture.
+
+    The bonds between all points are found by a single query, and each bond
+    is binned by the type of its query point, the type of its point and its
+    distance, so the partial RDFs of all pairs of types are computed in one
+    pass over the bonds. Element :code:`[a, b]` of the results is the RDF of
+    the points of type :math:`b` around the query points of type :math:`a`,
+
+    .. math::
+
+        g_{ab}(r) = \frac{V}{N_a N_b} \left\langle \sum_{i \in a}
+        \sum_{j \in b} \delta(r - r_{ij}) \right\rangle
+
+    normalized by the volume of each bin. When the query points are the
+    points, :math:`g_{aa}` tends to :math:`\frac{N_a - 1}{N_a}` at large
+    distances because self-neighbors are excluded.
+
+    .. note::
+        **2D:** :class:`freud.density.PartialRDF` properly handles 2D boxes.
+        The points must be passed in as :code:`[x, y, 0]`.
+
+    Args:
+        bins (unsigned int):
+            The number of bins in the RDFs.
+        r_max (float):
+            Maximum interparticle distance to include in the calculation.
+        n_types (unsigned int):
+            The number of types.
+        r_min (float, optional):
+            Minimum interparticle distance to include in the calculation
+            (Default value = :code:`0`).
+    """
+    cdef freud._density.PartialRDF * thisptr
+
+    def __cinit__(self, unsigned int bins, float r_max, unsigned int n_types,
+                  float r_min=0):
+        if type(self) == PartialRDF:
+            self.thisptr = self.histptr = new freud._density.PartialRDF(
+                bins, r_max, n_types, r_min)
+            self.r_max = r_max
+
+    def __dealloc__(self):
+        if type(self) == PartialRDF:
+            del self.thisptr
+
+    def compute(self, system, types=None, query_points=None, query_types=None,
+                neighbors=None, reset=True):
+        R"""Calculates the partial RDFs and adds to the current histograms.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            types ((:math:`N_{points}`,) :class:`numpy.ndarray`, optional):
+                The type of each point. May be omitted if :code:`system` is a
+                :class:`freud.locality.TypedNeighborQuery`, whose types are
+                used (Default value = :code:`None`).
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to calculate the RDFs. Uses the system's
+                points if :code:`None` (Default value = :code:`None`).
+            query_types ((:math:`N_{query\_points}`,) :class:`numpy.ndarray`, optional):
+                The type of each query point, which must be provided with
+                :code:`query_points`. Uses :code:`types` if
+                :code:`query_points` is :code:`None` (Default value =
+                :code:`None`).
+            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+                Either a :class:`NeighborList <freud.locality.NeighborList>` of
+                neighbor pairs to use in the calculation, or a dictionary of
+                `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+        """  # noqa E501
+        if reset:
+            self._reset()
+
+        cdef:
+            freud.locality.NeighborQuery nq
+            freud.locality.NeighborList nlist
+            freud.locality._QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, query_points, neighbors)
+
+        if types is None:
+            if not isinstance(nq, freud.locality.TypedNeighborQuery):
+                raise ValueError(
+                    "The types of the points must be provided unless the "
+                    "system is a TypedNeighborQuery.")
+            types = nq.types
+        cdef const unsigned int[::1] l_types = freud.util._convert_array(
+            types, shape=(nq.points.shape[0], ), dtype=np.uint32)
+        if query_types is None:
+            if query_points is not None:
+                raise ValueError(
+                    "The types of the query points must be provided with the "
+                    "query points.")
+            query_types = l_types
+        cdef const unsigned int[::1] l_query_types = \
+            freud.util._convert_array(
+                query_types, shape=(num_query_points, ), dtype=np.uint32)
+
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(), &l_types[0],
+                <vec3[float]*> &l_query_points[0, 0],
+                &l_query_types[0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
+        return self
+
+    @property
+    def n_types(self):
+        """unsigned int: The number of types."""
+        return self.thisptr.getNumTypes()
+
+    @property
+    def bin_centers(self):
+        """:math:`(N_{bins}, )` :class:`numpy.ndarray`: The centers of the
+        distance bins."""
+        vec = self.histptr.getBinCenters()
+        return np.array(vec[2], copy=True)
+
+    @property
+    def bin_edges(self):
+        """:math:`(N_{bins}+1, )` :class:`numpy.ndarray`: The edges of the
+        distance bins."""
+        vec = self.histptr.getBinEdges()
+        return np.array(vec[2], copy=True)
+
+    @property
+    def bounds(self):
+        """tuple: A tuple indicating upper and lower bounds of the
+        distances."""
+        vec = self.histptr.getBounds()
+        return vec[2]
+
+    @property
+    def nbins(self):
+        """int: The number of distance bins."""
+        return self.histptr.getAxisSizes()[2]
+
+    @_Compute._computed_property
+    def rdf(self):
+        """(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`) \
+        :class:`numpy.ndarray`: The partial RDFs, where :code:`rdf[a, b]` is
+        the RDF of the points of type :code:`b` around the query points of
+        type :code:`a`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getRDF(),
+            freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def n_r(self):
+        """(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`) \
+        :class:`numpy.ndarray`: Cumulative bin counts, where
+        :code:`n_r[a, b, i]` is the average number of points of type
+        :code:`b` contained within a ball of radius :code:`bin_edges[i+1]`
+        centered at a query point of type :code:`a`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getNr(),
+            freud.util.arr_type_t.FLOAT)
+
+    def __repr__(self):
+        return ("freud.density.{cls}(bins={bins}, r_max={r_max}, "
+                "n_types={n_types}, r_min={r_min})").format(
+                    cls=type(self).__name__,
+                    bins=self.nbins,
+                    r_max=self.bounds[1],
+                    n_types=self.n_types,
+                    r_min=self.bounds[0])
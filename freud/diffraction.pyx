@@ -3,7 +3,8 @@
 
 R"""
 The :class:`freud.diffraction` module provides functions for computing the
-diffraction pattern of particles in systems with long range order.
+diffraction pattern of particles in systems with long range order and the
+static structure factor of particles.
 
 .. rubric:: Stability
 
@@ -12,21 +13,27 @@ diffraction pattern of particles in systems with long range order.
 finalized in a future release.
 """
 
-import logging
-
 import numpy as np
-import rowan
-import scipy.ndimage
 
 import freud.locality
+import freud.util
+
+from cython.operator cimport dereference
+
+from freud.locality cimport _PairCompute
+from freud.util cimport _Compute, quat, vec3
 
 cimport numpy as np
-from libcpp cimport bool as cbool
 
+cimport freud._diffraction
+cimport freud._locality
+cimport freud.box
+cimport freud.locality
 cimport freud.util
-from freud.util cimport _Compute
 
-logger = logging.getLogger(__name__)
+# numpy must be initialized. When using numpy from C or Cython you must
+# _always_ do that, or you will have segfaults
+np.import_array()
 
 
 cdef class DiffractionPattern(_Compute):
@@ -66,148 +73,33 @@ cdef class DiffractionPattern(_Compute):
             Resolution of the output diffraction image, uses ``grid_size`` if
             not provided or ``None`` (Default value = :code:`None`).
     """
-    cdef int _grid_size
-    cdef int _output_size
-    cdef double[:] _k_values_orig
-    cdef double[:, :, :] _k_vectors_orig
-    cdef double[:] _k_values
-    cdef double[:, :, :] _k_vectors
-    cdef double[:, :] _diffraction
-    cdef unsigned int _frame_counter
-    cdef double _box_matrix_scale_factor
-    cdef double[:] _view_orientation
-    cdef double _k_scale_factor
-    cdef cbool _k_values_cached
-    cdef cbool _k_vectors_cached
-
-    def __init__(self, grid_size=512, output_size=None):
-        self._grid_size = int(grid_size)
-        self._output_size = int(grid_size) if output_size is None \
-            else int(output_size)
-
-        # Cache these because they are system-independent.
-        self._k_values_orig = np.empty(self.output_size)
-        self._k_vectors_orig = np.empty((
-            self.output_size, self.output_size, 3))
+    cdef freud._diffraction.DiffractionPattern * thisptr
 
-        # Store these computed arrays which are exposed as properties.
-        self._k_values = np.empty_like(self._k_values_orig)
-        self._k_vectors = np.empty_like(self._k_vectors_orig)
-        self._diffraction = np.zeros((self.output_size, self.output_size))
-        self._frame_counter = 0
-
-    def _calc_proj(self, view_orientation, box):
-        """Calculate the inverse shear matrix from finding the projected box
-        vectors whose area of parallogram is the largest.
-
-        Args:
-            view_orientation ((:math:`4`) :class:`numpy.ndarray`):
-                View orientation as a quaternion.
-            box (:class:`~.box.Box`):
-                Simulation box.
-
-        Returns:
-            (2, 2) :class:`numpy.ndarray`:
-                Inverse shear matrix.
-        """
-        # Rotate the box matrix by the view orientation.
-        box_matrix = rowan.rotate(view_orientation, box.to_matrix())
-
-        # Compute normals for each box face.
-        # The area of the face is the length of the vector.
-        box_face_normals = np.cross(
-            np.roll(box_matrix, 1, axis=-1),
-            np.roll(box_matrix, -1, axis=-1),
-            axis=0)
-
-        # Compute view axis projections.
-        projections = np.abs(box_face_normals.T @ np.array([0., 0., 1.]))
-
-        # Determine the largest projection area along the view axis and use
-        # that face for the projection into 2D.
-        best_projection_axis = np.argmax(projections)
-        secondary_axes = np.array([
-            best_projection_axis + 1, best_projection_axis + 2]) % 3
-
-        # Figure out appropriate shear matrix
-        shear = box_matrix[np.ix_([0, 1], secondary_axes)]
-
-        # Return the inverse shear matrix
-        inv_shear = np.linalg.inv(shear)
-        return inv_shear
-
-    def _transform(self, img, box, inv_shear, zoom):
-        """Zoom, shear, and scale diffraction intensities.
-
-        Args:
-            img ((``grid_size, grid_size``) :class:`numpy.ndarray`):
-                Array of diffraction intensities.
-            box (:class:`~.box.Box`):
-                Simulation box.
-            inv_shear ((2, 2) :class:`numpy.ndarray`):
-                Inverse shear matrix.
-            zoom (float):
-                Scaling factor for incident wavevectors.
+    def __cinit__(self, grid_size=512, output_size=None):
+        cdef unsigned int c_grid_size = int(grid_size)
+        cdef unsigned int c_output_size = c_grid_size if output_size is None \
+            else int(output_size)
+        self.thisptr = new freud._diffraction.DiffractionPattern(
+            c_grid_size, c_output_size)
 
-        Returns:
-            (``output_size, output_size``) :class:`numpy.ndarray`:
-                Transformed array of diffraction intensities.
-        """  # noqa: E501
+    def __dealloc__(self):
+        del self.thisptr
 
-        # The adjustments to roll and roll_shift ensure that the peak
-        # corresponding to k=0 is located at exactly
-        # (output_size//2, output_size//2), regardless of whether the grid_size
-        # and output_size are odd or even. This keeps the peak aligned at the
-        # center of a single pixel, which should always have the maximum value.
-
-        roll = img.shape[0] / 2
-        if img.shape[0] % 2 == 1:
-            roll -= 0.5
-
-        roll_shift = self.output_size / zoom / 2
-        if self.output_size % 2 == 1:
-            roll_shift -= 0.5 / zoom
-
-        box_matrix = box.to_matrix()
-        ss = np.max(box_matrix) * inv_shear
-
-        shift_matrix = np.array(
-            [[1, 0, -roll],
-             [0, 1, -roll],
-             [0, 0, 1]])
-
-        # Translation for [roll_shift, roll_shift]
-        # Then shift using ss
-        shear_matrix = np.array(
-            [[ss[1, 0], ss[0, 0], roll_shift],
-             [ss[1, 1], ss[0, 1], roll_shift],
-             [0, 0, 1]])
-
-        zoom_matrix = np.diag((zoom, zoom, 1))
-
-        # This matrix uses homogeneous coordinates. It is a 3x3 matrix that
-        # transforms 2D points and adds an offset.
-        inverse_transform = np.linalg.inv(
-            zoom_matrix @ shear_matrix @ shift_matrix)
-
-        img = scipy.ndimage.affine_transform(
-            input=img,
-            matrix=inverse_transform,
-            output_shape=(self.output_size, self.output_size),
-            order=1,
-            mode="constant")
-        return img
-
-    def compute(self, system, view_orientation=None, zoom=4, peak_width=1, reset=True):
+    def compute(self, system, view_orientation=None, zoom=4, peak_width=1,
+                reset=True):
         R"""Computes diffraction pattern.
 
+        Several view orientations may be given at once, in which case the
+        diffraction pattern is averaged over the views as if each view had
+        been computed in a separate call with ``reset=False``.
+
         Args:
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
-            view_orientation ((:math:`4`) :class:`numpy.ndarray`, optional):
-                View orientation. Uses :math:`(1, 0, 0, 0)` if not provided
-                or :code:`None` (Default value = :code:`None`).
+            view_orientation ((:math:`4`) or (:math:`N_{views}`, :math:`4`) :class:`numpy.ndarray`, optional):
+                View orientation or orientations. Uses :math:`(1, 0, 0, 0)` if
+                not provided or :code:`None` (Default value = :code:`None`).
             zoom (float):
                 Scaling factor for incident wavevectors (Default value = 4).
             peak_width (float):
@@ -217,112 +109,71 @@ cdef class DiffractionPattern(_Compute):
                 Whether to erase the previously computed values before adding
                 the new computations; if False, will accumulate data (Default
                 value: True).
-        """
+        """  # noqa: E501
         if reset:
-            self._diffraction = np.zeros((self.output_size, self.output_size))
-            self._frame_counter = 0
+            self.thisptr.reset()
 
-        system = freud.locality.NeighborQuery.from_system(system)
+        cdef freud.locality.NeighborQuery nq = \
+            freud.locality.NeighborQuery.from_system(system)
 
         if view_orientation is None:
             view_orientation = np.array([1., 0., 0., 0.])
         view_orientation = freud.util._convert_array(
-            view_orientation, (4,), np.double)
-
-        # Compute the box projection matrix
-        inv_shear = self._calc_proj(view_orientation, system.box)
-
-        # Rotate points by the view quaternion and shear by the box projection
-        xy = rowan.rotate(view_orientation, system.points)[:, 0:2]
-        xy = xy @ inv_shear.T
-
-        # Map positions to [0, 1] and compute a histogram "image"
-        # Use grid_size+1 bin edges so that there are grid_size bins
-        xy += 0.5
-        xy %= 1
-        im, _, _ = np.histogram2d(
-            xy[:, 0], xy[:, 1], bins=np.linspace(0, 1, self.grid_size+1))
-
-        # Compute FFT and convolve with Gaussian
-        cdef double complex[:, :] diffraction_fft
-        diffraction_fft = np.fft.fft2(im)
-        diffraction_fft = scipy.ndimage.fourier.fourier_gaussian(
-            diffraction_fft, peak_width / zoom)
-        diffraction_fft = np.fft.fftshift(diffraction_fft)
-
-        # Compute the squared modulus of the FFT, which is S(k)
-        cdef double[:, :] diffraction_frame
-        diffraction_frame = np.real(
-            diffraction_fft * np.conjugate(diffraction_fft))
-
-        # Transform the image (scale, shear, zoom) and normalize S(k) by N^2
-        N = len(system.points)
-        diffraction_frame = self._transform(
-            diffraction_frame, system.box, inv_shear, zoom) / (N*N)
-
-        # Add to the diffraction pattern and increment the frame counter
-        self._diffraction += np.asarray(diffraction_frame)
-        self._frame_counter += 1
-
-        # Compute a cached array of k-vectors that can be rotated and scaled
-        if not self._called_compute:
-            # Create a 1D axis of k-vector magnitudes
-            self._k_values_orig = np.fft.fftshift(np.fft.fftfreq(
-                n=self.output_size))
-
-            # Create a 3D meshgrid of k-vectors with shape
-            # (output_size, output_size, 3)
-            self._k_vectors_orig = np.asarray(np.meshgrid(
-                self._k_values_orig, self._k_values_orig, [0])).T[0]
-
-        # Cache the view orientation and box matrix scale factor for
-        # lazy evaluation of k-values and k-vectors
-        self._box_matrix_scale_factor = np.max(system.box.to_matrix())
-        self._view_orientation = view_orientation
-        self._k_scale_factor = 2 * np.pi * self.output_size / (self._box_matrix_scale_factor * zoom)
-        self._k_values_cached = False
-        self._k_vectors_cached = False
-
+            np.atleast_2d(view_orientation), (None, 4))
+
+        cdef freud.box.Box box = nq.box
+        cdef const float[:, ::1] l_points = nq.points
+        cdef const float[:, ::1] l_view_orientation = view_orientation
+        cdef unsigned int n_points = l_points.shape[0]
+        cdef unsigned int n_views = l_view_orientation.shape[0]
+        cdef double c_zoom = zoom
+        cdef double c_peak_width = peak_width
+
+        with nogil:
+            self.thisptr.accumulate(
+                dereference(box.thisptr),
+                <vec3[float]*> &l_points[0, 0], n_points,
+                <quat[float]*> &l_view_orientation[0, 0], n_views,
+                c_zoom, c_peak_width)
         return self
 
     @property
     def grid_size(self):
         """int: Resolution of the diffraction grid."""
-        return self._grid_size
+        return self.thisptr.getGridSize()
 
     @property
     def output_size(self):
         """int: Resolution of the output diffraction image."""
-        return self._output_size
+        return self.thisptr.getOutputSize()
 
     @_Compute._computed_property
     def diffraction(self):
         """
         (``output_size``, ``output_size``) :class:`numpy.ndarray`:
-            Diffraction pattern.
+            Diffraction pattern, averaged over all views computed since the
+            last reset.
         """
-        return np.asarray(self._diffraction) / self._frame_counter
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getDiffraction(),
+            freud.util.arr_type_t.DOUBLE)
 
     @_Compute._computed_property
     def k_values(self):
         """(``output_size``, ) :class:`numpy.ndarray`: k-values."""
-        if not self._k_values_cached:
-            self._k_values = np.asarray(self._k_values_orig) * self._k_scale_factor
-            self._k_values_cached = True
-        return np.asarray(self._k_values)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getKValues(),
+            freud.util.arr_type_t.DOUBLE)
 
     @_Compute._computed_property
     def k_vectors(self):
         """
         (``output_size``, ``output_size``, 3) :class:`numpy.ndarray`:
-            k-vectors.
+            k-vectors of the last view orientation.
         """
-        if not self._k_vectors_cached:
-            self._k_vectors = rowan.rotate(
-                self._view_orientation,
-                self._k_vectors_orig) * self._k_scale_factor
-            self._k_vectors_cached = True
-        return np.asarray(self._k_vectors)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getKVectors(),
+            freud.util.arr_type_t.DOUBLE, 3)
 
     def __repr__(self):
         return ("freud.diffraction.{cls}(grid_size={grid_size}, "
@@ -380,3 +231,343 @@ cdef class DiffractionPattern(_Compute):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef class StaticStructureFactorDirect(_Compute):
+    R"""Computes the static structure factor :math:`S(k)` by summing over
+    wavevectors.
+
+    The structure factor is computed directly from its definition,
+
+    .. math::
+
+        S(\vec{k}) = \frac{1}{N} \left| \sum_{j=1}^{N}
+        e^{i \vec{k} \cdot \vec{r}_j} \right|^2,
+
+    for every wavevector :math:`\vec{k}` of the reciprocal lattice of the
+    box with :math:`k_{min} \le |\vec{k}| < k_{max}`, and :math:`S(k)` is the
+    average of :math:`S(\vec{k})` over the wavevectors in each bin of
+    magnitudes. The wavevectors are computed in parallel, and the cost is
+    proportional to the number of points times the number of wavevectors, so
+    this method is exact but becomes expensive for large :math:`k_{max}`.
+
+    The smallest wavevector magnitude of the reciprocal lattice is given by
+    :attr:`min_valid_k`, and bins below it that contain no wavevectors have a
+    structure factor of zero.
+
+    .. note::
+        **2D:** :class:`freud.diffraction.StaticStructureFactorDirect`
+        properly handles 2D boxes, in which only wavevectors in the plane are
+        used.
+
+    Args:
+        bins (unsigned int):
+            Number of bins of wavevector magnitudes.
+        k_max (float):
+            Largest wavevector magnitude.
+        k_min (float, optional):
+            Smallest wavevector magnitude (Default value = :code:`0`).
+    """
+    cdef freud._diffraction.StaticStructureFactorDirect * thisptr
+
+    def __cinit__(self, unsigned int bins, float k_max, float k_min=0):
+        self.thisptr = new freud._diffraction.StaticStructureFactorDirect(
+            bins, k_max, k_min)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, reset=True):
+        R"""Computes the static structure factor and adds it to the
+        accumulated frames.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+        """
+        if reset:
+            self.thisptr.reset()
+
+        cdef freud.locality.NeighborQuery nq = \
+            freud.locality.NeighborQuery.from_system(system)
+        with nogil:
+            self.thisptr.accumulate(nq.get_ptr())
+        return self
+
+    @_Compute._computed_property
+    def box(self):
+        """:class:`freud.box.Box`: Box used in the calculation."""
+        return freud.box.BoxFromCPP(self.thisptr.getBox())
+
+    @_Compute._computed_property
+    def S_k(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Static structure
+        factor :math:`S(k)` in each bin."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getStructureFactor(),
+            freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def bin_counts(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Number of wavevectors
+        in each bin, summed over the accumulated frames."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getBinCounts(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
+    @property
+    def bin_centers(self):
+        """:math:`(N_{bins}, )` :class:`numpy.ndarray`: The centers of each bin
+        of wavevector magnitudes."""
+        vec = self.thisptr.getBinCenters()
+        return np.array(vec[0], copy=True)
+
+    @property
+    def bin_edges(self):
+        """:math:`(N_{bins}+1, )` :class:`numpy.ndarray`: The edges of each bin
+        of wavevector magnitudes."""
+        vec = self.thisptr.getBinEdges()
+        return np.array(vec[0], copy=True)
+
+    @property
+    def k_min(self):
+        """float: Smallest wavevector magnitude."""
+        return self.thisptr.getBounds()[0].first
+
+    @property
+    def k_max(self):
+        """float: Largest wavevector magnitude."""
+        return self.thisptr.getBounds()[0].second
+
+    @_Compute._computed_property
+    def min_valid_k(self):
+        """float: Smallest nonzero wavevector magnitude of the reciprocal
+        lattice of the last computed box."""
+        return self.thisptr.getMinValidK()
+
+    def __repr__(self):
+        return ("freud.diffraction.{cls}(bins={bins}, k_max={k_max}, "
+                "k_min={k_min})").format(
+                    cls=type(self).__name__,
+                    bins=len(self.bin_centers),
+                    k_max=self.k_max,
+                    k_min=self.k_min)
+
+    def plot(self, ax=None):
+        """Plot the static structure factor.
+
+        Args:
+            ax (:class:`matplotlib.axes.Axes`, optional): Axis to plot on. If
+                :code:`None`, make a new figure and axis.
+                (Default value = :code:`None`)
+
+        Returns:
+            (:class:`matplotlib.axes.Axes`): Axis with the plot.
+        """
+        import freud.plot
+        return freud.plot.line_plot(self.bin_centers, self.S_k,
+                                    title="Static Structure Factor",
+                                    xlabel=r"$k$",
+                                    ylabel=r"$S(k)$",
+                                    ax=ax)
+
+    def _repr_png_(self):
+        try:
+            import freud.plot
+            return freud.plot._ax_to_bytes(self.plot())
+        except (AttributeError, ImportError):
+            return None
+
+
+cdef class StaticStructureFactorRDF(_PairCompute):
+    R"""Computes the static structure factor :math:`S(k)` from the histogram
+    of pair distances.
+
+    The distances between pairs of points closer than ``r_max`` are binned as
+    in :class:`freud.density.RDF`, and the structure factor is the radial
+    Fourier transform of the pair correlation function,
+
+    .. math::
+
+        S(k) = 1 + \sum_b \left(\frac{n_b}{N} - \rho V_b\right) W(r_b)
+        \frac{\sin(k r_b)}{k r_b},
+
+    where :math:`n_b` is the number of pairs in the bin at distance
+    :math:`r_b`, :math:`V_b` is the volume of its spherical shell, and
+    :math:`\rho = (N - 1) / V` is the background density. In 2D,
+    :math:`\sin(k r) / (k r)` is replaced by the Bessel function
+    :math:`J_0(k r)` and the spherical shells by rings. The Lorch window
+    :math:`W(r) = \sin(\pi r / r_{max}) / (\pi r / r_{max})` damps the
+    ripples in :math:`S(k)` caused by truncating the pairs at ``r_max``, at
+    the cost of broadening the peaks. Frames are accumulated into the
+    histogram of pair distances, and the transform is only computed when
+    :attr:`S_k` is read.
+
+    The cost of the transform is independent of the number of points, so
+    this method is much faster than
+    :class:`freud.diffraction.StaticStructureFactorDirect` for large
+    systems, but the truncation of the pair distances at ``r_max`` limits its
+    accuracy for :math:`k \lesssim 2 \pi / r_{max}`.
+
+    Args:
+        bins (unsigned int):
+            Number of bins of wavevector magnitudes.
+        k_max (float):
+            Largest wavevector magnitude.
+        r_max (float):
+            Largest pair distance included in the calculation.
+        k_min (float, optional):
+            Smallest wavevector magnitude (Default value = :code:`0`).
+        r_bins (unsigned int, optional):
+            Number of bins of the histogram of pair distances, which should
+            be fine compared to :math:`2 \pi / k_{max}` (Default value =
+            :code:`1000`).
+        lorch_window (bool, optional):
+            Whether to multiply the pair correlation function by the Lorch
+            window (Default value = :code:`True`).
+    """
+    cdef freud._diffraction.StaticStructureFactorRDF * thisptr
+    cdef float r_max
+
+    def __cinit__(self, unsigned int bins, float k_max, float r_max,
+                  float k_min=0, unsigned int r_bins=1000,
+                  bint lorch_window=True):
+        self.thisptr = new freud._diffraction.StaticStructureFactorRDF(
+            bins, k_max, k_min, r_bins, r_max, lorch_window)
+        self.r_max = r_max
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    @property
+    def default_query_args(self):
+        """The default query arguments are
+        :code:`{'mode': 'ball', 'r_max': self.r_max}`."""
+        return dict(mode="ball", r_max=self.r_max)
+
+    def compute(self, system, neighbors=None, reset=True):
+        R"""Bins the pair distances of the points and adds them to the
+        accumulated frames.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+                Either a :class:`NeighborList <freud.locality.NeighborList>` of
+                neighbor pairs to use in the calculation, or a dictionary of
+                `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+        """  # noqa E501
+        if reset:
+            self.thisptr.reset()
+
+        cdef:
+            freud.locality.NeighborQuery nq
+            freud.locality.NeighborList nlist
+            freud.locality._QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, None, neighbors)
+
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
+        return self
+
+    @_Compute._computed_property
+    def box(self):
+        """:class:`freud.box.Box`: Box used in the calculation."""
+        return freud.box.BoxFromCPP(self.thisptr.getBox())
+
+    @_Compute._computed_property
+    def S_k(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Static structure
+        factor :math:`S(k)` at each bin center."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getStructureFactor(),
+            freud.util.arr_type_t.FLOAT)
+
+    @property
+    def bin_centers(self):
+        """:math:`(N_{bins}, )` :class:`numpy.ndarray`: The centers of each bin
+        of wavevector magnitudes."""
+        return np.array(self.thisptr.getKBinCenters(), copy=True)
+
+    @property
+    def bin_edges(self):
+        """:math:`(N_{bins}+1, )` :class:`numpy.ndarray`: The edges of each bin
+        of wavevector magnitudes."""
+        return np.array(self.thisptr.getKBinEdges(), copy=True)
+
+    @property
+    def k_min(self):
+        """float: Smallest wavevector magnitude."""
+        return self.bin_edges[0]
+
+    @property
+    def k_max(self):
+        """float: Largest wavevector magnitude."""
+        return self.bin_edges[-1]
+
+    @property
+    def r_bins(self):
+        """unsigned int: Number of bins of the histogram of pair
+        distances."""
+        return self.thisptr.getAxisSizes()[0]
+
+    @property
+    def lorch_window(self):
+        """bool: Whether the Lorch window is applied."""
+        return self.thisptr.getLorchWindow()
+
+    def __repr__(self):
+        return ("freud.diffraction.{cls}(bins={bins}, k_max={k_max}, "
+                "r_max={r_max}, k_min={k_min}, r_bins={r_bins}, "
+                "lorch_window={lorch_window})").format(
+                    cls=type(self).__name__,
+                    bins=len(self.bin_centers),
+                    k_max=self.k_max,
+                    r_max=self.r_max,
+                    k_min=self.k_min,
+                    r_bins=self.r_bins,
+                    lorch_window=self.lorch_window)
+
+    def plot(self, ax=None):
+        """Plot the static structure factor.
+
+        Args:
+            ax (:class:`matplotlib.axes.Axes`, optional): Axis to plot on. If
+                :code:`None`, make a new figure and axis.
+                (Default value = :code:`None`)
+
+        Returns:
+            (:class:`matplotlib.axes.Axes`): Axis with the plot.
+        """
+        import freud.plot
+        return freud.plot.line_plot(self.bin_centers, self.S_k,
+                                    title="Static Structure Factor",
+                                    xlabel=r"$k$",
+                                    ylabel=r"$S(k)$",
+                                    ax=ax)
+
+    def _repr_png_(self):
+        try:
+            import freud.plot
+            return freud.plot._ax_to_bytes(self.plot())
+        except (AttributeError, ImportError):
+            return None
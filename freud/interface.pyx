@@ -8,27 +8,37 @@ between sets of points.
 
 import numpy as np
 
+from cython.operator cimport dereference
+
 from freud.locality cimport _PairCompute
-from freud.util cimport _Compute
+from freud.util cimport _Compute, vec3
 
 import freud.locality
 
 cimport numpy as np
 
+cimport freud._interface
 cimport freud.locality
+cimport freud.util
 
 # numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
 np.import_array()
 
 cdef class Interface(_PairCompute):
-    R"""Measures the interface between two sets of points."""
-    cdef const unsigned int[::1] _point_ids
-    cdef const unsigned int[::1] _query_point_ids
+    R"""Measures the interface between two sets of points.
+
+    A point or query point is at the interface if it is part of any bond
+    between the two sets. The bonds are found in parallel without building a
+    :class:`~.locality.NeighborList`.
+    """
+    cdef freud._interface.Interface * thisptr
+
+    def __cinit__(self):
+        self.thisptr = new freud._interface.Interface()
 
-    def __init__(self):
-        self._point_ids = np.empty(0, dtype=np.uint32)
-        self._query_point_ids = np.empty(0, dtype=np.uint32)
+    def __dealloc__(self):
+        del self.thisptr
 
     def compute(self, system, query_points, neighbors=None):
         R"""Compute the particles at the interface between two sets of points.
@@ -54,33 +64,41 @@ cdef class Interface(_PairCompute):
             const float[:, ::1] l_query_points
             unsigned int num_query_points
 
-        nlist = freud.locality._make_default_nlist(
-            system, neighbors, query_points)
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, query_points, neighbors)
 
-        self._point_ids = np.unique(nlist.point_indices)
-        self._query_point_ids = np.unique(nlist.query_point_indices)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
     @_Compute._computed_property
     def point_count(self):
         """int: Number of particles from :code:`points` on the interface."""
-        return len(self._point_ids)
+        return self.thisptr.getPointCount()
 
     @_Compute._computed_property
     def point_ids(self):
         """:class:`np.ndarray`: The particle IDs from :code:`points`."""
-        return np.asarray(self._point_ids)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPointIds(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     @_Compute._computed_property
     def query_point_count(self):
         """int: Number of particles from :code:`query_points` on the
         interface."""
-        return len(self._query_point_ids)
+        return self.thisptr.getQueryPointCount()
 
     @_Compute._computed_property
     def query_point_ids(self):
         """:class:`np.ndarray`: The particle IDs from :code:`query_points`."""
-        return np.asarray(self._query_point_ids)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getQueryPointIds(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     def __repr__(self):
         return "freud.interface.{cls}()".format(cls=type(self).__name__)
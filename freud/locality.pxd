@@ -35,21 +35,39 @@ cdef class NeighborQueryResult:
 cdef class NeighborQuery:
     cdef freud._locality.NeighborQuery * nqptr
     cdef const float[:, ::1] points
-    cdef freud._locality.NeighborQuery * get_ptr(self)
+    cdef freud._locality.NeighborQuery * get_ptr(self) nogil
 
 cdef class NeighborList:
     cdef freud._locality.NeighborList * thisptr
     cdef char _managed
 
-    cdef freud._locality.NeighborList * get_ptr(self)
+    cdef freud._locality.NeighborList * get_ptr(self) nogil
     cdef void copy_c(self, NeighborList other)
 
+cdef class CachedNeighborList(_Compute):
+    cdef freud._locality.CachedNeighborList * thisptr
+    cdef NeighborList _nlist
+
+cdef class NeighborQueryPlan(_Compute):
+    cdef freud._locality.NeighborQueryPlan * thisptr
+    cdef list _queries
+
+cdef class AnalysisGraph(_Compute):
+    cdef freud._locality.AnalysisGraph * thisptr
+    cdef list _nodes
+    cdef object _callback
+    cdef object _callback_error
+
 cdef class LinkCell(NeighborQuery):
     cdef freud._locality.LinkCell * thisptr
 
 cdef class AABBQuery(NeighborQuery):
     cdef freud._locality.AABBQuery * thisptr
 
+cdef class TypedNeighborQuery(NeighborQuery):
+    cdef freud._locality.TypedNeighborQuery * thisptr
+    cdef const unsigned int[::1] _types
+
 cdef class _RawPoints(NeighborQuery):
     cdef freud._locality.RawPoints * thisptr
 
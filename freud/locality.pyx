@@ -6,6 +6,7 @@ The :mod:`freud.locality` module contains data structures to efficiently
 locate points based on their proximity to other points.
 """
 import inspect
+import os
 
 import numpy as np
 
@@ -16,8 +17,10 @@ cimport numpy as np
 from cython.operator cimport dereference
 from libcpp cimport bool as cbool
 from libcpp.memory cimport shared_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 
+cimport freud._box
 cimport freud._locality
 cimport freud.box
 from freud._locality cimport ITERATOR_TERMINATOR
@@ -39,7 +42,7 @@ cdef class _QueryArgs:
 
     def __cinit__(self, mode=None, r_min=None, r_max=None, r_guess=None,
                   num_neighbors=None, exclude_ii=None,
-                  scale=None, **kwargs):
+                  scale=None, point_type=None, region=None, **kwargs):
         if type(self) == _QueryArgs:
             self.thisptr = new freud._locality.QueryArgs()
             self.mode = mode
@@ -55,6 +58,10 @@ cdef class _QueryArgs:
                 self.exclude_ii = exclude_ii
             if scale is not None:
                 self.scale = scale
+            if point_type is not None:
+                self.point_type = point_type
+            if region is not None:
+                self.region = region
             if len(kwargs):
                 err_str = ", ".join(
                     "{} = {}".format(k, v) for k, v in kwargs.items())
@@ -151,6 +158,54 @@ cdef class _QueryArgs:
     def scale(self, value):
         self.thisptr.scale = value
 
+    @property
+    def point_type(self):
+        if self.thisptr.point_type == freud._locality.DEFAULT_POINT_TYPE:
+            return None
+        return self.thisptr.point_type
+
+    @point_type.setter
+    def point_type(self, value):
+        if value is None:
+            self.thisptr.point_type = freud._locality.DEFAULT_POINT_TYPE
+        else:
+            self.thisptr.point_type = value
+
+    @property
+    def region(self):
+        cdef freud._locality.QueryRegion r = self.thisptr.region
+        if r.shape == freud._locality.RegionShape.region_box:
+            return dict(lower=(r.lower.x, r.lower.y, r.lower.z),
+                        upper=(r.upper.x, r.upper.y, r.upper.z))
+        elif r.shape == freud._locality.RegionShape.region_sphere:
+            return dict(center=(r.center.x, r.center.y, r.center.z),
+                        radius=r.radius)
+        return None
+
+    @region.setter
+    def region(self, value):
+        cdef freud._locality.QueryRegion r
+        if value is None:
+            self.thisptr.region = r
+            return
+        value = dict(value)
+        if set(value) == {'lower', 'upper'}:
+            r.shape = freud._locality.RegionShape.region_box
+            lower = freud.util._convert_array(value['lower'], shape=(3, ))
+            upper = freud.util._convert_array(value['upper'], shape=(3, ))
+            r.lower = vec3[float](lower[0], lower[1], lower[2])
+            r.upper = vec3[float](upper[0], upper[1], upper[2])
+        elif set(value) == {'center', 'radius'}:
+            r.shape = freud._locality.RegionShape.region_sphere
+            center = freud.util._convert_array(value['center'], shape=(3, ))
+            r.center = vec3[float](center[0], center[1], center[2])
+            r.radius = value['radius']
+        else:
+            raise ValueError(
+                "A region must be a dict with the keys 'lower' and 'upper' "
+                "of a box, or 'center' and 'radius' of a sphere.")
+        self.thisptr.region = r
+
     def __repr__(self):
         return ("freud.locality.{cls}(mode={mode}, r_max={r_max}, "
                 "num_neighbors={num_neighbors}, exclude_ii={exclude_ii}, "
@@ -229,6 +284,41 @@ cdef class NeighborQueryResult:
 
         return nl
 
+    def toNeighborListFile(self, filename, chunk_size=65536,
+                           sort_by_distance=False):
+        """Write the query result to a neighbor list file in chunks.
+
+        The query points are processed in chunks, and the bonds of each chunk
+        are written to the file before the next chunk is queried, so neighbor
+        lists that do not fit into memory can be produced. The file contains
+        the bonds of :meth:`toNeighborList` and can be opened with
+        :meth:`NeighborList.from_file`.
+
+        Args:
+            filename (str):
+                Path of the file, which is overwritten if it exists.
+            chunk_size (int):
+                Number of query points per chunk (Default value = 65536).
+            sort_by_distance (bool):
+                If :code:`True`, sort neighboring bonds by distance.
+                If :code:`False`, sort neighboring bonds by point index
+                (Default value = :code:`False`).
+        """
+        if chunk_size < 1:
+            raise ValueError("chunk_size must be positive.")
+        cdef const float[:, ::1] l_points = self.points
+        cdef shared_ptr[freud._locality.NeighborQueryIterator] iterator = \
+            self.nq.nqptr.query(
+                <vec3[float]*> &l_points[0, 0],
+                self.points.shape[0],
+                dereference(self.query_args.thisptr))
+        cdef string c_filename = os.fsencode(filename)
+        cdef unsigned int c_chunk_size = chunk_size
+        cdef cbool c_sort_by_distance = sort_by_distance
+        with nogil:
+            dereference(iterator).toNeighborListFile(
+                c_filename, c_chunk_size, c_sort_by_distance)
+
 
 cdef class NeighborQuery:
     R"""Class representing a set of points along with the ability to query for
@@ -381,6 +471,23 @@ cdef class NeighborQuery:
         """:class:`np.ndarray`: The array of points in this data structure."""
         return np.asarray(self.points)
 
+    @property
+    def sort_query_points(self):
+        """bool: Whether queries process the query points in spatial order.
+
+        Points are often stored in an order that is unrelated to their
+        positions, so consecutive query points search distant parts of the
+        data structure. If this option is enabled, neighbor lists and
+        computes that do not use a neighbor list process the query points in
+        Morton order, which improves memory locality for large systems. The
+        results are identical to those of unsorted queries, including the
+        order of the bonds in neighbor lists. Defaults to :code:`False`."""
+        return self.nqptr.getSortQueryPoints()
+
+    @sort_query_points.setter
+    def sort_query_points(self, value):
+        self.nqptr.setSortQueryPoints(value)
+
     def query(self, query_points, query_args):
         R"""Query for nearest neighbors of the provided point.
 
@@ -402,7 +509,7 @@ cdef class NeighborQuery:
         cdef _QueryArgs args = _QueryArgs.from_dict(query_args)
         return NeighborQueryResult.init(self, query_points, args)
 
-    cdef freud._locality.NeighborQuery * get_ptr(self):
+    cdef freud._locality.NeighborQuery * get_ptr(self) nogil:
         R"""Returns a pointer to the raw C++ object we are wrapping."""
         return self.nqptr
 
@@ -546,6 +653,55 @@ cdef class NeighborList:
 
         return result
 
+    @classmethod
+    def from_file(cls, filename, mmap=True):
+        R"""Open a neighbor list file written by :meth:`save` or
+        :meth:`NeighborQueryResult.toNeighborListFile`.
+
+        A memory mapped NeighborList references the file instead of copying
+        it, so parts of the file are only read when computes access them, and
+        neighbor lists larger than the memory can be used. The mapping is
+        private: modifying the NeighborList never changes the file. Arrays
+        obtained from the NeighborList keep the mapping alive.
+
+        Args:
+            filename (str):
+                Path of the file.
+            mmap (bool, optional):
+                If :code:`True`, memory map the file where supported,
+                otherwise read it into memory (Default value = :code:`True`).
+
+        Returns:
+            :class:`~NeighborList`: The neighbor list stored in the file.
+        """
+        cdef string c_filename = os.fsencode(filename)
+        cdef freud._locality.NeighborList *cnlist
+        if mmap:
+            with nogil:
+                cnlist = freud._locality.mapNeighborList(c_filename)
+        else:
+            with nogil:
+                cnlist = freud._locality.readNeighborList(c_filename)
+        cdef NeighborList result = _nlist_from_cnlist(cnlist)
+        result._managed = True
+        return result
+
+    def save(self, filename):
+        R"""Write this NeighborList to a file that can be memory mapped with
+        :meth:`from_file`.
+
+        The file holds a header followed by the bond arrays and the neighbor
+        counts and segments of the query points, in the native byte order.
+
+        Args:
+            filename (str):
+                Path of the file, which is overwritten if it exists.
+        """
+        cdef string c_filename = os.fsencode(filename)
+        with nogil:
+            freud._locality.writeNeighborList(
+                dereference(self.thisptr), c_filename)
+
     def __cinit__(self, _null=False):
         # Setting _null to True will create a NeighborList with no underlying
         # C++ object. This is useful for passing NULL pointers to C++ to
@@ -559,7 +715,7 @@ cdef class NeighborList:
         if self._managed:
             del self.thisptr
 
-    cdef freud._locality.NeighborList * get_ptr(self):
+    cdef freud._locality.NeighborList * get_ptr(self) nogil:
         R"""Returns a pointer to the raw C++ object we are wrapping."""
         return self.thisptr
 
@@ -689,6 +845,93 @@ cdef class NeighborList:
         self.thisptr.filter(filt_ptr)
         return self
 
+    def symmetrize(self):
+        R"""Add the reverse of every bond whose reverse is missing.
+
+        This turns asymmetric neighbor lists, such as those of nearest
+        neighbor queries, into lists in which :math:`j` is a neighbor of
+        :math:`i` whenever :math:`i` is a neighbor of :math:`j`. Added bonds
+        copy the distance and weight of the bond they reverse. The query
+        points and points must be the same set of points.
+
+        .. note:: This method modifies this object in-place, and sorts the
+            bonds of each query point by point index.
+        """
+        with nogil:
+            self.thisptr.symmetrize()
+        return self
+
+    def union(self, NeighborList other):
+        R"""Add the bonds of another neighbor list that are missing from this
+        one.
+
+        Bonds present in both lists keep the distance and weight of this
+        list. Both lists must have the same numbers of query points and
+        points.
+
+        .. note:: This method modifies this object in-place, and sorts the
+            bonds of each query point by point index.
+
+        Args:
+            other (:class:`freud.locality.NeighborList`):
+                The neighbor list whose bonds are added.
+        """
+        with nogil:
+            self.thisptr.mergeSorted(
+                dereference(other.thisptr), freud._locality.MergeMode.unite)
+        return self
+
+    def intersection(self, NeighborList other):
+        R"""Remove the bonds that are missing from another neighbor list.
+
+        Both lists must have the same numbers of query points and points.
+
+        .. note:: This method modifies this object in-place, and sorts the
+            bonds of each query point by point index.
+
+        Args:
+            other (:class:`freud.locality.NeighborList`):
+                The neighbor list whose bonds are kept.
+        """
+        with nogil:
+            self.thisptr.mergeSorted(
+                dereference(other.thisptr),
+                freud._locality.MergeMode.intersect)
+        return self
+
+    def compact(self, quantize_distances=False):
+        R"""Store the bonds in a compact layout to reduce memory usage.
+
+        Since bonds are sorted by query point index, the query point indices
+        are implied by :attr:`neighbor_counts` and :attr:`segments`, so the
+        compact layout only stores the point index of each bond. Weights are
+        only stored if any of them differs from 1, and distances can
+        optionally be quantized to 16 bit values, reducing the memory per
+        bond from 16 bytes to 6 or 8 bytes. Computes read the compact layout
+        directly. Accessing the bond arrays of this object, or modifying it,
+        converts it back to the full layout.
+
+        Args:
+            quantize_distances (bool, optional):
+                If :code:`True`, store distances as multiples of the largest
+                distance divided by 65535, which bounds the error of each
+                distance by half that unit (Default value = :code:`False`).
+        """
+        self.thisptr.compact(quantize_distances)
+        return self
+
+    @property
+    def is_compact(self):
+        """bool: Whether the bonds are stored in the compact layout (see
+        :meth:`compact`)."""
+        return self.thisptr.isCompact()
+
+    @property
+    def memory_usage(self):
+        """int: The number of bytes used to store the bonds, neighbor counts
+        and segments."""
+        return self.thisptr.getMemoryUsage()
+
     def filter_r(self, float r_max, float r_min=0):
         R"""Removes bonds that are outside of a given radius range.
 
@@ -845,6 +1088,96 @@ cdef class AABBQuery(NeighborQuery):
         if type(self) is AABBQuery:
             del self.thisptr
 
+    def update(self, points, box=None):
+        R"""Update the tree with new point positions.
+
+        The tree is refit to the new positions, keeping its structure, which
+        makes updating much cheaper than constructing a new
+        :class:`~.AABBQuery` when analyzing trajectories where points move
+        little between frames. The tree is rebuilt if the bounding boxes of
+        its leaves grow too much, or if the number of points or the
+        dimensionality of the box changes.
+
+        Args:
+            points ((:math:`N`, 3) :class:`numpy.ndarray`):
+                The new points to use to build the tree.
+            box (:class:`freud.box.Box`, optional):
+                New simulation box. If :code:`None`, the current box is used
+                (Default value = :code:`None`).
+        """
+        cdef freud.box.Box b = freud.util._convert_box(
+            self.box if box is None else box)
+        new_points = freud.util._convert_array(points, shape=(None, 3)).copy()
+        cdef const float[:, ::1] l_points = new_points
+        self.thisptr.update(
+            dereference(b.thisptr),
+            <vec3[float]*> &l_points[0, 0],
+            new_points.shape[0])
+        # Only release the old points once the C++ object refers to the new
+        # ones.
+        self.points = new_points
+        return self
+
+
+cdef class TypedNeighborQuery(NeighborQuery):
+    R"""Find neighbors of points of several types, using an AABB tree for
+    each type.
+
+    The points are grouped by type and an AABB tree is built for the points
+    of each type, so queries can find the neighbors of a single type without
+    constructing a :class:`~.NeighborQuery` of a subset of the points. Set
+    the :code:`point_type` query argument to a type to only find neighbors of
+    that type. Queries without it find the neighbors of all types, like an
+    :class:`~.AABBQuery` of all points would. Point indices of the bonds are
+    always indices into the full array of points.
+
+    Args:
+        box (:class:`freud.box.Box`):
+            Simulation box.
+        points ((:math:`N`, 3) :class:`numpy.ndarray`):
+            The points to use to build the trees.
+        types ((:math:`N`,) :class:`numpy.ndarray`):
+            The type of each point, a nonnegative integer.
+        n_types (unsigned int, optional):
+            The number of types. If not provided, it is one more than the
+            largest type (Default value = :code:`None`).
+    """
+
+    def __cinit__(self, box, points, types, n_types=None):
+        cdef const float[:, ::1] l_points
+        cdef freud.box.Box b = freud.util._convert_box(box)
+        self.points = freud.util._convert_array(
+            points, shape=(None, 3)).copy()
+        l_points = self.points
+        self._types = freud.util._convert_array(
+            types, shape=(self.points.shape[0], ), dtype=np.uint32).copy()
+        self.thisptr = self.nqptr = new freud._locality.TypedNeighborQuery(
+            dereference(b.thisptr),
+            <vec3[float]*> &l_points[0, 0],
+            self.points.shape[0], &self._types[0],
+            0 if n_types is None else n_types)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    @property
+    def types(self):
+        """(:math:`N`,) :class:`numpy.ndarray`: The type of each point."""
+        return np.asarray(self._types)
+
+    @property
+    def n_types(self):
+        """unsigned int: The number of types."""
+        return self.thisptr.getNumTypes()
+
+    @property
+    def type_counts(self):
+        """(:math:`N_{types}`,) :class:`numpy.ndarray`: The number of points
+        of each type."""
+        return np.array([self.thisptr.getNumPointsOfType(t)
+                         for t in range(self.thisptr.getNumTypes())],
+                        dtype=np.uint32)
+
 
 cdef class LinkCell(NeighborQuery):
     R"""Supports efficiently finding all points in a set within a certain
@@ -882,6 +1215,483 @@ cdef class LinkCell(NeighborQuery):
         """float: Cell width."""
         return self.thisptr.getCellWidth()
 
+    def update(self, points, box=None):
+        R"""Update the cell list with new point positions.
+
+        Only the cells that points moved out of or into are re-sorted, which makes
+        updating much cheaper than constructing a new :class:`~.LinkCell`
+        when analyzing trajectories where points move little between frames.
+        The cell width is kept fixed. If the cell dimensions change because
+        of a new box or the number of points changes, the cell list is rebuilt.
+
+        Args:
+            points ((:math:`N`, 3) :class:`numpy.ndarray`):
+                The new points to bin into the cell list.
+            box (:class:`freud.box.Box`, optional):
+                New simulation box. If :code:`None`, the current box is used
+                (Default value = :code:`None`).
+        """
+        cdef freud.box.Box b = freud.util._convert_box(
+            self.box if box is None else box)
+        new_points = freud.util._convert_array(points, shape=(None, 3)).copy()
+        cdef const float[:, ::1] l_points = new_points
+        self.thisptr.update(
+            dereference(b.thisptr),
+            <vec3[float]*> &l_points[0, 0],
+            new_points.shape[0])
+        # Only release the old points once the C++ object refers to the new
+        # ones.
+        self.points = new_points
+        return self
+
+
+cdef class CachedNeighborList(_Compute):
+    R"""Neighbor list that is reused across frames until points move too far.
+
+    Neighbors are found with a ball query at a distance of
+    :code:`r_max + skin` and the resulting bonds are cached together with the
+    positions used to find them. Subsequent calls to :meth:`compute` only
+    recompute the distances of the cached bonds and keep those closer than
+    :code:`r_max`, which gives the same bonds as a new query as long as no
+    point has moved more than :code:`skin/2` since the cached bonds were
+    found (when distinct query points are used, as long as the largest point
+    displacement plus the largest query point displacement does not exceed
+    :code:`skin`). Otherwise, or if the box, the number of points, or the
+    query points change, the bonds are found again.
+
+    The resulting :attr:`nlist` can be passed as the :code:`neighbors`
+    argument of other computes, so the cost of finding neighbors is shared by
+    all computes performed on a frame and amortized over many frames.
+
+    Args:
+        r_max (float):
+            Distance within which to find neighbors.
+        skin (float):
+            Extra distance searched when the bonds are found.
+    """
+
+    def __cinit__(self, float r_max, float skin):
+        self.thisptr = new freud._locality.CachedNeighborList(r_max, skin)
+        self._nlist = NeighborList()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, query_points=None):
+        R"""Compute the neighbor list, reusing the cached bonds if possible.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to find bonds. Uses the system's points if
+                :code:`None`, in which case bonds between a point and itself
+                are excluded (Default value = :code:`None`).
+        """  # noqa E501
+        cdef NeighborQuery nq = NeighborQuery.from_system(system)
+        cdef cbool exclude_ii = query_points is None
+        if query_points is None:
+            query_points = nq.points
+        else:
+            query_points = freud.util._convert_array(
+                query_points, shape=(None, 3))
+        cdef const float[:, ::1] l_query_points = query_points
+        cdef unsigned int num_query_points = l_query_points.shape[0]
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, exclude_ii)
+        return self
+
+    def reset(self):
+        R"""Discard the cached bonds so that the next call to
+        :meth:`compute` finds them again."""
+        self.thisptr.reset()
+        return self
+
+    @property
+    def r_max(self):
+        """float: Distance within which neighbors are found."""
+        return self.thisptr.getRMax()
+
+    @property
+    def skin(self):
+        """float: Extra distance searched when the bonds are found."""
+        return self.thisptr.getSkin()
+
+    @property
+    def num_builds(self):
+        """int: Number of times the cached bonds have been found with a new
+        neighbor query."""
+        return self.thisptr.getNumBuilds()
+
+    @_Compute._computed_property
+    def nlist(self):
+        R""":class:`~.locality.NeighborList`: Bonds within :code:`r_max` for
+        the most recently computed positions."""
+        self._nlist = _nlist_from_cnlist(self.thisptr.getNeighborList().get())
+        return self._nlist
+
+    def __repr__(self):
+        return "freud.locality.{cls}(r_max={r_max}, skin={skin})".format(
+            cls=type(self).__name__, r_max=self.r_max, skin=self.skin)
+
+    def __str__(self):
+        return repr(self)
+
+
+cdef class NeighborQueryPlan(_Compute):
+    R"""Serves several neighbor queries of the same points from shared
+    queries.
+
+    Computes performed on the same points usually find their neighbors with
+    different query arguments. A plan collects the query arguments of all
+    such computes with :meth:`add_query` and finds all of their neighbors in
+    as few queries as possible: all ball queries are served from one ball
+    query at the largest :code:`r_max`, and nearest neighbor queries are
+    served from the same bonds whenever they contain enough neighbors of
+    every query point. Otherwise, a single nearest neighbor query for the
+    largest :code:`num_neighbors` serves all remaining nearest neighbor
+    queries.
+
+    Every :class:`~.locality.NeighborList` in :attr:`nlists` has the same
+    bonds, in the same order, as a query performed with the corresponding
+    arguments on its own, and can be passed as the :code:`neighbors` argument
+    of the compute that requested it. The neighbor lists of queries whose
+    arguments match a shared query share its bond arrays instead of copying
+    them.
+
+    .. code-block:: python
+
+        plan = freud.locality.NeighborQueryPlan()
+        rdf_query = plan.add_query(dict(r_max=3))
+        ql_query = plan.add_query(dict(num_neighbors=12))
+        plan.compute(system)
+        rdf.compute(system, neighbors=plan.nlists[rdf_query])
+        ql.compute(system, neighbors=plan.nlists[ql_query])
+    """
+
+    def __cinit__(self):
+        self.thisptr = new freud._locality.NeighborQueryPlan()
+        self._queries = []
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def add_query(self, query_args):
+        R"""Add a query to the plan.
+
+        Args:
+            query_args (dict):
+                Query arguments of the query. If :code:`exclude_ii` is not
+                provided, it is set the same way as for a compute, i.e. to
+                :code:`True` if :meth:`compute` is called without query points.
+
+        Returns:
+            int: The index of the query's neighbor list in :attr:`nlists`.
+        """
+        # Reject invalid query arguments early.
+        _QueryArgs.from_dict(query_args)
+        self._queries.append(dict(query_args))
+        return len(self._queries) - 1
+
+    @property
+    def queries(self):
+        """list[dict]: Query arguments of the queries in the plan."""
+        return [query_args.copy() for query_args in self._queries]
+
+    def compute(self, system, query_points=None):
+        R"""Find the neighbors of every query in the plan.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to find bonds. Uses the system's points if
+                :code:`None` (Default value = :code:`None`).
+        """  # noqa E501
+        cdef NeighborQuery nq = NeighborQuery.from_system(system)
+        cdef vector[freud._locality.QueryArgs] c_qargs
+        cdef _QueryArgs qargs
+        for query_args in self._queries:
+            query_args = query_args.copy()
+            query_args.setdefault('exclude_ii', query_points is None)
+            qargs = _QueryArgs.from_dict(query_args)
+            c_qargs.push_back(dereference(qargs.thisptr))
+
+        if query_points is None:
+            query_points = nq.points
+        else:
+            query_points = freud.util._convert_array(
+                query_points, shape=(None, 3))
+        cdef const float[:, ::1] l_query_points = query_points
+        cdef unsigned int num_query_points = l_query_points.shape[0]
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, c_qargs)
+        return self
+
+    @_Compute._computed_property
+    def nlists(self):
+        R"""list[:class:`~.locality.NeighborList`]: The neighbor lists of the
+        queries, in the order the queries were added."""
+        return [
+            _nlist_from_cnlist(self.thisptr.getNeighborList(i).get())
+            for i in range(self.thisptr.getNumQueries())]
+
+    @_Compute._computed_property
+    def num_passes(self):
+        """int: Number of neighbor queries performed by the last call to
+        :meth:`compute`."""
+        return self.thisptr.getNumPasses()
+
+    def __repr__(self):
+        return "freud.locality.{cls}()".format(cls=type(self).__name__)
+
+    def __str__(self):
+        return repr(self)
+
+
+cdef cbool _call_frame_callback(size_t index, void* data) with gil:
+    R"""Call the frame callback of an :class:`~.AnalysisGraph`, storing any
+    exception it raises so that it can be raised once the analysis stops."""
+    cdef AnalysisGraph graph = <AnalysisGraph> data
+    try:
+        graph._callback(index)
+    except BaseException as error:
+        graph._callback_error = error
+        return False
+    return True
+
+
+cdef class AnalysisGraph(_Compute):
+    R"""Runs a graph of computes on every frame of a trajectory in C++.
+
+    Analyzing a trajectory with a loop over its frames in Python converts the
+    inputs of every compute of every frame and builds their neighbor queries
+    and neighbor lists one at a time. An analysis graph is declared once, with
+    the neighbors the computes need and the computes themselves, and
+    :meth:`compute` then processes all frames in C++:
+
+    * The neighbor query of the points of the following frames is built while
+      the computes process the current frame.
+    * The neighbors of all neighbor nodes are found together, as by a
+      :class:`~.NeighborQueryPlan`, whose neighbor lists are reused between
+      frames.
+    * The computes of a frame are scheduled as a TBB flow graph, so computes
+      that do not depend on each other run concurrently.
+
+    The supported computes are :class:`freud.density.RDF`, which accumulates
+    its histogram over all frames, and :class:`freud.order.Steinhardt`,
+    :class:`freud.order.SolidLiquid`, :class:`freud.cluster.Cluster` and
+    :class:`freud.cluster.ClusterProperties`, which hold the results of the
+    last frame once :meth:`compute` returns. The results of the other frames
+    can be read by a callback, which is called after all computes have
+    processed each frame.
+
+    .. code-block:: python
+
+        graph = freud.locality.AnalysisGraph()
+        rdf_neighbors = graph.add_neighbors(dict(r_max=3))
+        ql_neighbors = graph.add_neighbors(dict(num_neighbors=12))
+        graph.add(rdf, neighbors=rdf_neighbors)
+        graph.add(ql, neighbors=ql_neighbors)
+        clusters = graph.add(
+            cl, neighbors=graph.add_neighbors(dict(r_max=1.2)))
+        graph.add(cl_props, clusters=clusters)
+
+        num_clusters = []
+        graph.compute(
+            frames, callback=lambda frame: num_clusters.append(
+                cl.num_clusters))
+    """
+
+    def __cinit__(self):
+        self.thisptr = new freud._locality.AnalysisGraph()
+        self._nodes = []
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def _check_node(self, node):
+        if node not in range(len(self._nodes)):
+            raise ValueError(
+                "{} is not a node of the analysis graph.".format(node))
+        return node
+
+    def _neighbors_dependency(self, neighbors, clusters, name):
+        R"""Check the nodes given to a compute that uses the neighbors of
+        a neighbor node, returning the index of the neighbor node."""
+        if neighbors is None or not self.thisptr.isNeighborNode(neighbors):
+            raise ValueError(
+                "{} requires a neighbor node of the analysis "
+                "graph.".format(name))
+        if clusters is not None:
+            raise ValueError(
+                "{} does not use the clusters of another node.".format(name))
+        return neighbors
+
+    def _clusters_dependency(self, neighbors, clusters, name):
+        R"""Check the nodes given to a compute that uses the clusters computed
+        by another node, returning the index of that node."""
+        if clusters is None or self.thisptr.isNeighborNode(clusters) or \
+                self.thisptr.getPointLabels(clusters) == NULL:
+            raise ValueError(
+                "{} requires a node of the analysis graph that computes "
+                "clusters.".format(name))
+        if neighbors is not None:
+            raise ValueError(
+                "{} does not use the neighbors of a neighbor node.".format(
+                    name))
+        return clusters
+
+    def add_neighbors(self, query_args):
+        R"""Add a neighbor node, whose neighbors are found for every frame.
+
+        Args:
+            query_args (dict):
+                Query arguments of the neighbors of the points of each frame.
+                If :code:`exclude_ii` is not provided, it is set to
+                :code:`True`.
+
+        Returns:
+            int: The index of the node.
+        """
+        query_args = dict(query_args)
+        query_args.setdefault('exclude_ii', True)
+        cdef _QueryArgs qargs = _QueryArgs.from_dict(query_args)
+        node = self.thisptr.addNeighbors(dereference(qargs.thisptr))
+        self._nodes.append(query_args)
+        return node
+
+    def add(self, compute, neighbors=None, clusters=None, after=()):
+        R"""Add a compute node, which computes every frame.
+
+        Args:
+            compute:
+                The compute, which must be one of the computes supported by
+                analysis graphs.
+            neighbors (int, optional):
+                The neighbor node of the neighbors used by the compute, for
+                all computes except :class:`freud.cluster.ClusterProperties`
+                (Default value = :code:`None`).
+            clusters (int, optional):
+                The node of a :class:`freud.cluster.Cluster` or
+                :class:`freud.order.SolidLiquid` whose clusters are used by a
+                :class:`freud.cluster.ClusterProperties` (Default value =
+                :code:`None`).
+            after (iterable of int, optional):
+                Other nodes that must process each frame before the compute
+                does (Default value = :code:`()`).
+
+        Returns:
+            int: The index of the node.
+        """
+        try:
+            add_to_graph = compute._add_to_graph
+        except AttributeError:
+            raise TypeError(
+                "{} cannot be computed by an analysis graph.".format(
+                    type(compute).__name__))
+        if neighbors is not None:
+            self._check_node(neighbors)
+        if clusters is not None:
+            self._check_node(clusters)
+        dependencies = [self._check_node(node) for node in after]
+        dependencies.extend(
+            node for node in (neighbors, clusters) if node is not None)
+        node = add_to_graph(self, neighbors, clusters, dependencies)
+        self._nodes.append(compute)
+        return node
+
+    @property
+    def nodes(self):
+        """list: The query arguments of each neighbor node and the compute of
+        each compute node, in order of index."""
+        return list(self._nodes)
+
+    def compute(self, frames, callback=None, reset=True):
+        R"""Process every frame of a trajectory.
+
+        Args:
+            frames (iterable):
+                The frames of the trajectory, each a tuple of the form
+                (box_like, array_like) of the box and the points of the frame.
+            callback (callable, optional):
+                Function called with the index of each frame after all
+                computes have processed the frame, in order of frame index.
+                Exceptions raised by the callback stop the analysis and are
+                raised by this method (Default value = :code:`None`).
+            reset (bool):
+                Whether to erase the histograms of computes that accumulate
+                over frames before processing the frames; if False, will
+                accumulate data (Default value: True).
+        """
+        if reset:
+            for node in self._nodes:
+                if not isinstance(node, dict) and hasattr(node, '_reset'):
+                    node._reset()
+
+        cdef vector[freud._box.Box] l_boxes
+        cdef vector[const vec3[float]*] l_points
+        cdef vector[unsigned int] l_n_points
+        cdef freud.box.Box b
+        cdef const float[:, ::1] l_frame_points
+
+        # The converted arrays must outlive the computation.
+        frame_points = []
+        for box, points in frames:
+            b = freud.util._convert_box(box)
+            points = freud.util._convert_array(points, shape=(None, 3))
+            frame_points.append(points)
+            l_frame_points = points
+            l_boxes.push_back(dereference(b.thisptr))
+            l_points.push_back(<vec3[float]*> &l_frame_points[0, 0])
+            l_n_points.push_back(l_frame_points.shape[0])
+
+        self._callback = callback
+        self._callback_error = None
+        if callback is None:
+            self.thisptr.setFrameCallback(NULL, NULL)
+        else:
+            self.thisptr.setFrameCallback(
+                <freud._locality.FrameCallback> _call_frame_callback,
+                <void*> self)
+        try:
+            with nogil:
+                self.thisptr.run(
+                    freud._locality.makeFrameArraySource(
+                        l_boxes, l_points, l_n_points))
+        except RuntimeError:
+            if self._callback_error is not None:
+                raise self._callback_error
+            raise
+        finally:
+            self._callback = None
+            self._callback_error = None
+            self.thisptr.setFrameCallback(NULL, NULL)
+
+        if self.thisptr.getNumFrames() > 0:
+            for node in self._nodes:
+                if isinstance(node, _Compute):
+                    node._called_compute = True
+        return self
+
+    @_Compute._computed_property
+    def num_frames(self):
+        """int: Number of frames processed by the last call to
+        :meth:`compute`."""
+        return self.thisptr.getNumFrames()
+
+    def __repr__(self):
+        return "freud.locality.{cls}()".format(cls=type(self).__name__)
+
+    def __str__(self):
+        return repr(self)
+
 
 cdef class _PairCompute(_Compute):
     R"""Parent class for all compute classes in freud that depend on finding
@@ -986,7 +1796,12 @@ cdef class _SpatialHistogram(_PairCompute):
 
     @_Compute._computed_property
     def bin_counts(self):
-        """:class:`numpy.ndarray`: The bin counts in the histogram."""
+        """:class:`numpy.ndarray`: The bin counts in the histogram, of dtype
+        :code:`np.uint64` if :attr:`count_precision` is :code:`'uint64'`."""
+        if self.count_precision == 'uint64':
+            return freud.util.make_managed_numpy_array(
+                &self.histptr.getWideBinCounts(),
+                freud.util.arr_type_t.UNSIGNED_INT64)
         return freud.util.make_managed_numpy_array(
             &self.histptr.getBinCounts(),
             freud.util.arr_type_t.UNSIGNED_INT)
@@ -1019,6 +1834,78 @@ cdef class _SpatialHistogram(_PairCompute):
         histogram."""
         return list(self.histptr.getAxisSizes())
 
+    @property
+    def accumulation_strategy(self):
+        """str: The strategy used to accumulate the histogram from many
+        threads.
+
+        The strategy is one of :code:`'dense'` (a copy of the histogram per
+        thread, reduced at the end), :code:`'atomic'` (a single histogram
+        incremented atomically) or :code:`'tiled'` (copies of the histogram
+        per thread that are allocated lazily in tiles). The default,
+        :code:`'auto'`, chooses a strategy from the number of bins and the
+        expected number of bonds at the first computation after a reset, so
+        reading this property after a computation reports the strategy that
+        was chosen. A new strategy takes effect at the first computation after
+        the next reset."""
+        cdef freud._locality.AccumulationStrategy strategy = \
+            self.histptr.getAccumulationStrategy()
+        if strategy == freud._locality.AccumulationStrategy.dense:
+            return 'dense'
+        elif strategy == freud._locality.AccumulationStrategy.atomic:
+            return 'atomic'
+        elif strategy == freud._locality.AccumulationStrategy.tiled:
+            return 'tiled'
+        else:
+            return 'auto'
+
+    @accumulation_strategy.setter
+    def accumulation_strategy(self, value):
+        if value == 'auto':
+            self.histptr.setAccumulationStrategy(
+                freud._locality.AccumulationStrategy.automatic)
+        elif value == 'dense':
+            self.histptr.setAccumulationStrategy(
+                freud._locality.AccumulationStrategy.dense)
+        elif value == 'atomic':
+            self.histptr.setAccumulationStrategy(
+                freud._locality.AccumulationStrategy.atomic)
+        elif value == 'tiled':
+            self.histptr.setAccumulationStrategy(
+                freud._locality.AccumulationStrategy.tiled)
+        else:
+            raise ValueError(
+                "The accumulation strategy must be one of 'auto', 'dense', "
+                "'atomic' or 'tiled'.")
+
+    @property
+    def count_precision(self):
+        """str: The precision of the bin counts accumulated over frames.
+
+        With :code:`'uint32'` (the default), the bonds of all frames are
+        counted in 32 bit integers, which overflow after :math:`2^{32}` bonds
+        in a bin. With :code:`'uint64'`, the counts of each frame are added to
+        64 bit totals, so that long accumulations stay exact, at the cost of a
+        pass over the bins after each frame. The bonds are binned identically
+        in both cases. A new precision takes effect at the first computation
+        after the next reset."""
+        if self.histptr.getCountPrecision() == \
+                freud._locality.CountPrecision.uint64:
+            return 'uint64'
+        return 'uint32'
+
+    @count_precision.setter
+    def count_precision(self, value):
+        if value == 'uint32':
+            self.histptr.setCountPrecision(
+                freud._locality.CountPrecision.uint32)
+        elif value == 'uint64':
+            self.histptr.setCountPrecision(
+                freud._locality.CountPrecision.uint64)
+        else:
+            raise ValueError(
+                "The count precision must be one of 'uint32' or 'uint64'.")
+
     def _reset(self):
         # Resets the values of RDF in memory.
         self.histptr.reset()
@@ -1106,7 +1993,8 @@ cdef class PeriodicBuffer(_Compute):
         else:
             raise ValueError('buffer must be a scalar or have length 3.')
 
-        self.thisptr.compute(nq.get_ptr(), buffer_vec, images)
+        with nogil:
+            self.thisptr.compute(nq.get_ptr(), buffer_vec, images)
         return self
 
     @_Compute._computed_property
@@ -1158,41 +2046,85 @@ cdef class Voronoi(_Compute):
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, system):
+    def compute(self, system, compute_polytopes=True,
+                compute_statistics=False):
         R"""Compute Voronoi diagram.
 
         Args:
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
+            compute_polytopes (bool):
+                Whether to store the vertices of each cell. If
+                :code:`False`, only the volumes and the neighbor list are
+                computed and the arrays in :attr:`polytopes` are empty
+                (Default value = :code:`True`).
+            compute_statistics (bool):
+                Whether to compute the :attr:`surface_areas`,
+                :attr:`surface_tensors`, :attr:`curvature_tensors` and
+                :attr:`asphericities` of the cells while they are
+                tessellated (Default value = :code:`False`).
+        """
+        cdef NeighborQuery nq = NeighborQuery.from_system(system)
+        cdef cbool l_compute_polytopes = compute_polytopes
+        cdef cbool l_compute_statistics = compute_statistics
+        with nogil:
+            self.thisptr.compute(nq.get_ptr(), l_compute_polytopes,
+                                 l_compute_statistics)
+        self._box = nq.box
+        return self
+
+    def update(self, system, compute_polytopes=True,
+               compute_statistics=False):
+        R"""Update the Voronoi diagram of the previous call for new positions.
+
+        Only the cells that could have been changed by the points that moved
+        since the previous call to :meth:`compute` or :meth:`update` are
+        computed again. These are the cells of the moved points and the cells
+        whose points are closer to the previous or current position of a
+        moved point than twice the largest distance from the point to the
+        vertices of its cell. The other cells are kept, so the results agree
+        with those of :meth:`compute` while the cost scales with the number
+        of points that moved. If the box, the number of points,
+        :code:`compute_polytopes` or :code:`compute_statistics` changed, all
+        cells are computed.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            compute_polytopes (bool):
+                Whether to store the vertices of each cell
+                (Default value = :code:`True`).
+            compute_statistics (bool):
+                Whether to compute the statistics of each cell, see
+                :meth:`compute` (Default value = :code:`False`).
         """
         cdef NeighborQuery nq = NeighborQuery.from_system(system)
-        self.thisptr.compute(nq.get_ptr())
+        cdef cbool l_compute_polytopes = compute_polytopes
+        cdef cbool l_compute_statistics = compute_statistics
+        with nogil:
+            self.thisptr.update(nq.get_ptr(), l_compute_polytopes,
+                                l_compute_statistics)
         self._box = nq.box
+        self._called_compute = True
         return self
 
+    @_Compute._computed_property
+    def num_computed_cells(self):
+        """int: Number of cells computed by the most recent call to
+        :meth:`compute` or :meth:`update`."""
+        return self.thisptr.getNumComputedCells()
+
     @_Compute._computed_property
     def polytopes(self):
         """list[:class:`numpy.ndarray`]: A list of :class:`numpy.ndarray`
-        defining Voronoi polytope vertices for each cell."""
-        polytopes = []
-        cdef vector[vector[vec3[double]]] raw_polytopes = \
-            self.thisptr.getPolytopes()
-        cdef size_t i
-        cdef size_t j
-        cdef size_t num_verts
-        cdef vector[vec3[double]] raw_vertices
-        cdef double[:, ::1] polytope_vertices
-        for i in range(raw_polytopes.size()):
-            raw_vertices = raw_polytopes[i]
-            num_verts = raw_vertices.size()
-            polytope_vertices = np.empty((num_verts, 3), dtype=np.float64)
-            for j in range(num_verts):
-                polytope_vertices[j, 0] = raw_vertices[j].x
-                polytope_vertices[j, 1] = raw_vertices[j].y
-                polytope_vertices[j, 2] = raw_vertices[j].z
-            polytopes.append(np.asarray(polytope_vertices))
-        return polytopes
+        defining Voronoi polytope vertices for each cell. The arrays are
+        empty if the polytopes were not computed."""
+        return freud.util.make_managed_numpy_ragged_array(
+            &self.thisptr.getPolytopes().getOffsets(),
+            &self.thisptr.getPolytopes().getValues(),
+            freud.util.arr_type_t.DOUBLE, 3)
 
     @_Compute._computed_property
     def volumes(self):
@@ -1202,6 +2134,58 @@ cdef class Voronoi(_Compute):
             &self.thisptr.getVolumes(),
             freud.util.arr_type_t.DOUBLE)
 
+    def _check_statistics(self):
+        if not self.thisptr.getComputeStatistics():
+            raise AttributeError("The statistics of the cells are only "
+                                 "available after computing with "
+                                 "compute_statistics=True.")
+
+    @_Compute._computed_property
+    def surface_areas(self):
+        """:math:`\\left(N_{points} \\right)` :class:`numpy.ndarray`: The
+        surface area (perimeter in 2D) of each cell, which is the sum of the
+        weights of its bonds in :attr:`nlist`."""
+        self._check_statistics()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getSurfaceAreas(),
+            freud.util.arr_type_t.DOUBLE)
+
+    @_Compute._computed_property
+    def surface_tensors(self):
+        R""":math:`\left(N_{points}, 3, 3 \right)` :class:`numpy.ndarray`:
+        The Minkowski surface tensor
+        :math:`W_1^{0,2} = \frac{1}{d} \int \vec{n} \otimes \vec{n} \, dA`
+        of each cell, where :math:`d` is the dimension and :math:`\vec{n}` the
+        outward normal of its surface."""
+        self._check_statistics()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getSurfaceTensors(),
+            freud.util.arr_type_t.DOUBLE)
+
+    @_Compute._computed_property
+    def curvature_tensors(self):
+        R""":math:`\left(N_{points}, 3, 3 \right)` :class:`numpy.ndarray`:
+        The Minkowski curvature tensor :math:`W_2^{0,2}` of each cell, which
+        weights the outer product of the normal by the mean curvature of the
+        surface. The curvature of a polytope is concentrated on its edges
+        (vertices in 2D), so the trace of the tensor is the integral mean
+        curvature of the cell in 3D and :math:`\pi` in 2D."""
+        self._check_statistics()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getCurvatureTensors(),
+            freud.util.arr_type_t.DOUBLE)
+
+    @_Compute._computed_property
+    def asphericities(self):
+        """:math:`\\left(N_{points} \\right)` :class:`numpy.ndarray`: The
+        ratio of the smallest to the largest eigenvalue of the
+        :attr:`surface_tensors` of each cell, which is 1 for cells with an
+        isotropic surface and decreases as the cells become anisotropic."""
+        self._check_statistics()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getAsphericities(),
+            freud.util.arr_type_t.DOUBLE)
+
     @_Compute._computed_property
     def nlist(self):
         R"""Returns the computed :class:`~.locality.NeighborList`.
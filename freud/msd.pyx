@@ -6,60 +6,25 @@ The :class:`freud.msd` module provides functions for computing the
 mean-squared-displacement (MSD) of particles in periodic systems.
 """
 
-import logging
-
 import numpy as np
 
-import freud.parallel
+import freud.box
+import freud.util
+
+from cython.operator cimport dereference
+
+from freud.util cimport _Compute, vec3
 
 cimport numpy as np
 
+cimport freud._box
+cimport freud._msd
 cimport freud.box
-from freud.util cimport _Compute
-
-logger = logging.getLogger(__name__)
-
-# Use fastest available fft library
-try:
-    import pyfftw
-    logger.info("Using PyFFTW for FFTs")
-
-    pyfftw.config.NUM_THREADS = min(1, freud.parallel.get_num_threads())
-    logger.info("Setting number of threads to {}".format(
-        freud.parallel.get_num_threads()))
-
-    # Note that currently these functions are defined to match only the parts
-    # of the numpy/scipy API that are actually used below. There is no promise
-    # that other aspects of the API will be preserved.
-    def fft(x, n, axis):
-        a = pyfftw.empty_aligned(x.shape, 'complex64')
-        a[:] = x
-        fft_object = pyfftw.builders.fft(a, n=n, axis=axis)
-        return fft_object()
-
-    def ifft(x, axis):
-        a = pyfftw.empty_aligned(x.shape, 'complex64')
-        a[:] = x
-        fft_object = pyfftw.builders.ifft(a, axis=axis)
-        return fft_object()
-except ImportError:
-    try:
-        from scipy.fftpack import fft, ifft
-        logger.info("Using SciPy's fftpack for FFTs")
-    except ImportError:
-        from numpy.fft import fft, ifft
-        logger.info("Using NumPy for FFTs")
-
-
-def _autocorrelation(x):
-    R"""Compute the autocorrelation of a sequence"""
-    N = x.shape[0]
-    F = fft(x, n=2*N, axis=0)
-    PSD = F * F.conjugate()
-    res = ifft(PSD, axis=0)
-    res = (res[:N]).real
-    n = np.arange(1, N+1)[::-1]  # N to 1
-    return res/n[:, np.newaxis]
+cimport freud.util
+
+# numpy must be initialized. When using numpy from C or Cython you must
+# _always_ do that, or you will have segfaults
+np.import_array()
 
 
 cdef class MSD(_Compute):
@@ -93,22 +58,10 @@ cdef class MSD(_Compute):
       :cite:`calandrini2011nmoldyn` as described in `this StackOverflow thread
       <https://stackoverflow.com/questions/34222272/computing-mean-square-displacement-using-python-and-fft>`_.
 
-      .. note::
-          The most intensive part of this calculation is computing an FFT. To
-          maximize performance, freud attempts to use the fastest FFT library
-          available. By default, the order of preference is `pyFFTW
-          <https://github.com/pyFFTW/pyFFTW>`_, SciPy, and then NumPy. If you
-          are experiencing significant slowdowns in calculating the MSD, you
-          may benefit from installing a faster FFT library, which freud will
-          automatically detect. The performance change will be especially
-          noticeable if the length of your trajectory is a number whose prime
-          factorization consists of extremely large prime factors. The
-          standard Cooley-Tukey FFT algorithm performs very poorly in this
-          case, so installing pyFFTW will significantly improve performance.
-
-          Note that while pyFFTW is released under the BSD 3-Clause license,
-          the FFTW library is available under either GPL or a commercial
-          license.
+      The autocorrelations are computed with fast Fourier transforms of
+      the trajectory of each particle, in parallel over the particles. The
+      transforms have lengths that are powers of two, so their cost does not
+      depend on the factorization of the length of the trajectory.
 
     * :code:`'direct'`:
       Under some circumstances, however, we may be more interested in
@@ -141,8 +94,8 @@ cdef class MSD(_Compute):
             Mode of calculation. Options are :code:`'window'` and
             :code:`'direct'`.  (Default value = :code:`'window'`).
     """   # noqa: E501
+    cdef freud._msd.MSD * thisptr
     cdef freud.box.Box _box
-    cdef _particle_msd
     cdef str mode
 
     def __cinit__(self, box=None, mode='window'):
@@ -151,12 +104,21 @@ cdef class MSD(_Compute):
         else:
             self._box = None
 
-        self._particle_msd = []
-
         if mode not in ['window', 'direct']:
             raise ValueError("Invalid mode")
         self.mode = mode
 
+        cdef freud._msd.MSDMode c_mode = freud._msd.window
+        if mode == 'direct':
+            c_mode = freud._msd.direct
+        cdef freud._box.Box c_box
+        if self._box is not None:
+            c_box = dereference(self._box.thisptr)
+        self.thisptr = new freud._msd.MSD(c_box, c_mode)
+
+    def __dealloc__(self):
+        del self.thisptr
+
     def compute(self, positions, images=None, reset=True):
         """Calculate the MSD for the positions provided.
 
@@ -170,7 +132,8 @@ cdef class MSD(_Compute):
             multiple times with different subsets the points to calculate the
             MSD over the full set of positions. The primary use-case is when
             the trajectory is so large that computing an MSD on all particles
-            at once is prohibitively expensive.
+            at once is prohibitively expensive. For trajectories that are too
+            long to hold in memory, see :class:`MultiTauMSD`.
 
         Args:
             positions ((:math:`N_{frames}`, :math:`N_{particles}`, 3) :class:`numpy.ndarray`):
@@ -188,47 +151,28 @@ cdef class MSD(_Compute):
                 value: True).
         """  # noqa: E501
         if reset:
-            self._particle_msd = []
-
-        self._called_compute = True
+            self.thisptr.reset()
 
         positions = freud.util._convert_array(
             positions, shape=(None, None, 3))
+        cdef const float[:, :, ::1] l_positions = positions
+        cdef unsigned int n_frames = l_positions.shape[0]
+        cdef unsigned int n_particles = l_positions.shape[1]
+
+        # The positions are unwrapped on the fly, without copying them.
+        cdef const int[:, :, ::1] l_images
+        cdef const vec3[int]* l_images_ptr = NULL
         if images is not None:
             images = freud.util._convert_array(
                 images, shape=positions.shape, dtype=np.int32)
-
-        # Make sure we aren't modifying the provided array
-        if self._box is not None and images is not None:
-            unwrapped_positions = positions.copy()
-            for i in range(positions.shape[0]):
-                unwrapped_positions[i, :, :] = self._box.unwrap(
-                    unwrapped_positions[i, :, :], images[i, :, :])
-            positions = unwrapped_positions
-
-        if self.mode == 'window':
-            # First compute the first term r^2(k+m) - r^2(k)
-            N = positions.shape[0]
-            D = np.square(positions).sum(axis=2)
-            D = np.append(D, np.zeros(positions.shape[:2]), axis=0)
-            Q = 2*D.sum(axis=0)
-            S1 = np.zeros(positions.shape[:2])
-            for m in range(N):
-                Q -= (D[m-1, :] + D[N-m, :])
-                S1[m, :] = Q/(N-m)
-
-            # The second term can be computed via autocorrelation
-            corrs = []
-            for i in range(positions.shape[2]):
-                corrs.append(_autocorrelation(positions[:, :, i]))
-            S2 = np.sum(corrs, axis=0)
-
-            self._particle_msd.append(S1 - 2*S2)
-        elif self.mode == 'direct':
-            self._particle_msd.append(
-                np.linalg.norm(
-                    positions - positions[[0], :, :], axis=-1)**2)
-
+            if self._box is not None:
+                l_images = images
+                l_images_ptr = <vec3[int]*> &l_images[0, 0, 0]
+
+        with nogil:
+            self.thisptr.accumulate(
+                <vec3[float]*> &l_positions[0, 0, 0], l_images_ptr,
+                n_frames, n_particles)
         return self
 
     @property
@@ -240,13 +184,17 @@ cdef class MSD(_Compute):
     def msd(self):
         """:math:`\\left(N_{frames}, \\right)` :class:`numpy.ndarray`: The mean
         squared displacement."""
-        return np.concatenate(self._particle_msd, axis=1).mean(axis=-1)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getMSD(),
+            freud.util.arr_type_t.DOUBLE)
 
     @_Compute._computed_property
     def particle_msd(self):
         """:math:`\\left(N_{frames}, N_{particles} \\right)` :class:`numpy.ndarray`: The per
         particle based mean squared displacement."""  # noqa: E501
-        return np.concatenate(self._particle_msd, axis=1)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getParticleMSD(),
+            freud.util.arr_type_t.DOUBLE)
 
     def __repr__(self):
         return "freud.msd.{cls}(box={box}, mode={mode})".format(
@@ -280,3 +228,170 @@ cdef class MSD(_Compute):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef class MultiTauMSD(_Compute):
+    R"""Compute the mean squared displacement of a trajectory one frame at a
+    time.
+
+    The windowed MSD computed by :class:`MSD` requires the positions of every
+    frame of the trajectory at once, which is not possible for long
+    trajectories of large systems. This class instead takes the frames one at
+    a time and keeps a bounded history of past frames with a multiple-tau
+    scheme, measuring the windowed MSD at logarithmically spaced lags.
+
+    The history is made of levels. With :math:`m` the ``level_ratio``, level
+    :math:`l` stores the last ``points_per_level`` frames whose indices are
+    multiples of :math:`m^l`, and measures the lags :math:`j m^l` that are
+    longer than the lags of the previous level. Lags shorter than ``points_per_level`` are averaged over
+    every frame as a time origin, exactly as in the windowed mode of
+    :class:`MSD`, while longer lags are averaged over the time origins that
+    are multiples of the spacing of their level. The memory required grows
+    with the logarithm of the number of frames rather than linearly.
+
+    .. note::
+        The number of particles must be constant over the course of the
+        simulation.
+
+    Args:
+        box (:class:`freud.box.Box`, optional):
+            If not provided, the class will assume that all positions provided
+            in calls to :meth:`~compute` are already unwrapped. (Default value
+            = :code:`None`).
+        points_per_level (unsigned int, optional):
+            Number of frames stored in each level. (Default value = 16).
+        level_ratio (unsigned int, optional):
+            Ratio of the spacings of the frames stored in consecutive levels.
+            (Default value = 2).
+    """
+    cdef freud._msd.MultiTauMSD * thisptr
+    cdef freud.box.Box _box
+
+    def __cinit__(self, box=None, unsigned int points_per_level=16,
+                  unsigned int level_ratio=2):
+        if box is not None:
+            self._box = freud.util._convert_box(box)
+        else:
+            self._box = None
+
+        cdef freud._box.Box c_box
+        if self._box is not None:
+            c_box = dereference(self._box.thisptr)
+        self.thisptr = new freud._msd.MultiTauMSD(
+            c_box, points_per_level, level_ratio)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, positions, images=None, reset=True):
+        """Add a frame to the trajectory.
+
+        Args:
+            positions ((:math:`N_{particles}`, 3) :class:`numpy.ndarray`):
+                The particle positions of the frame. If neither box nor images
+                are provided, the positions are assumed to be unwrapped already.
+            images ((:math:`N_{particles}`, 3) :class:`numpy.ndarray`, optional):
+                The particle images to unwrap with if provided. Must be provided
+                along with a simulation box (in the constructor) if particle
+                positions need to be unwrapped. (Default value = :code:`None`).
+            reset (bool):
+                Whether to discard the previous frames and start a new
+                trajectory from this frame; if False, the frame is added after
+                the previous frames (Default value: True).
+        """  # noqa: E501
+        if reset:
+            self.thisptr.reset()
+
+        positions = freud.util._convert_array(positions, shape=(None, 3))
+        cdef const float[:, ::1] l_positions = positions
+        cdef unsigned int n_particles = l_positions.shape[0]
+
+        cdef const int[:, ::1] l_images
+        cdef const vec3[int]* l_images_ptr = NULL
+        if images is not None:
+            images = freud.util._convert_array(
+                images, shape=positions.shape, dtype=np.int32)
+            if self._box is not None:
+                l_images = images
+                l_images_ptr = <vec3[int]*> &l_images[0, 0]
+
+        with nogil:
+            self.thisptr.accumulate(
+                <vec3[float]*> &l_positions[0, 0], l_images_ptr, n_particles)
+        return self
+
+    @property
+    def box(self):
+        """:class:`freud.box.Box`: Box used in the calculation."""
+        return self._box
+
+    @property
+    def points_per_level(self):
+        """unsigned int: Number of frames stored in each level."""
+        return self.thisptr.getPointsPerLevel()
+
+    @property
+    def level_ratio(self):
+        """unsigned int: Ratio of the spacings of the frames stored in
+        consecutive levels."""
+        return self.thisptr.getLevelRatio()
+
+    @_Compute._computed_property
+    def num_frames(self):
+        """unsigned int: Number of frames added since the last reset."""
+        return self.thisptr.getNumFrames()
+
+    @_Compute._computed_property
+    def lags(self):
+        """:math:`\\left(N_{lags}, \\right)` :class:`numpy.ndarray`: The
+        measured lags, in frames, in increasing order."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getLags(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
+    @_Compute._computed_property
+    def msd(self):
+        """:math:`\\left(N_{lags}, \\right)` :class:`numpy.ndarray`: The mean
+        squared displacement at each lag."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getMSD(),
+            freud.util.arr_type_t.DOUBLE)
+
+    @_Compute._computed_property
+    def counts(self):
+        """:math:`\\left(N_{lags}, \\right)` :class:`numpy.ndarray`: The
+        number of time origins averaged at each lag."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getCounts(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
+    def __repr__(self):
+        return ("freud.msd.{cls}(box={box}, points_per_level={p}, "
+                "level_ratio={m})").format(
+                    cls=type(self).__name__, box=self._box,
+                    p=self.points_per_level, m=self.level_ratio)
+
+    def plot(self, ax=None):
+        """Plot MSD.
+
+        Args:
+            ax (:class:`matplotlib.axes.Axes`, optional): Axis to plot on. If
+                :code:`None`, make a new figure and axis.
+                (Default value = :code:`None`)
+
+        Returns:
+            (:class:`matplotlib.axes.Axes`): Axis with the plot.
+        """
+        import freud.plot
+        return freud.plot.line_plot(self.lags, self.msd,
+                                    title="MSD",
+                                    xlabel="Window size",
+                                    ylabel="MSD",
+                                    ax=ax)
+
+    def _repr_png_(self):
+        try:
+            import freud.plot
+            return freud.plot._ax_to_bytes(self.plot())
+        except (AttributeError, ImportError):
+            return None
@@ -24,7 +24,10 @@ from freud.errors import FreudDeprecationWarning
 
 cimport numpy as np
 from cython.operator cimport dereference
+from libcpp cimport bool as cbool
+from libcpp.vector cimport vector
 
+cimport freud._locality
 cimport freud._order
 cimport freud.locality
 cimport freud.util
@@ -79,8 +82,9 @@ cdef class Cubatic(_Compute):
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int num_particles = l_orientations.shape[0]
 
-        self.thisptr.compute(
-            <quat[float]*> &l_orientations[0, 0], num_particles)
+        with nogil:
+            self.thisptr.compute(
+                <quat[float]*> &l_orientations[0, 0], num_particles)
         return self
 
     @property
@@ -177,7 +181,7 @@ cdef class Nematic(_Compute):
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, orientations):
+    def compute(self, orientations, compute_particle_tensor=True):
         R"""Calculates the per-particle and global order parameter.
 
         Example::
@@ -191,15 +195,23 @@ cdef class Nematic(_Compute):
         Args:
             orientations (:math:`\left(N_{particles}, 4 \right)` :class:`numpy.ndarray`):
                 Orientations to calculate the order parameter.
+            compute_particle_tensor (bool, optional):
+                Whether to store the tensor of each particle. When only the
+                global order parameter is needed, skipping the per-particle
+                tensor saves :math:`9 N_{particles}` floats. If
+                :code:`False`, :attr:`particle_tensor` is empty
+                (Default value = :code:`True`).
         """   # noqa: E501
         orientations = freud.util._convert_array(
             orientations, shape=(None, 4))
 
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int num_particles = l_orientations.shape[0]
+        cdef cbool l_compute_particle_tensor = compute_particle_tensor
 
-        self.thisptr.compute(<quat[float]*> &l_orientations[0, 0],
-                             num_particles)
+        with nogil:
+            self.thisptr.compute(<quat[float]*> &l_orientations[0, 0],
+                                 num_particles, l_compute_particle_tensor)
         return self
 
     @_Compute._computed_property
@@ -218,7 +230,8 @@ cdef class Nematic(_Compute):
     def particle_tensor(self):
         """:math:`\\left(N_{particles}, 3, 3 \\right)` :class:`numpy.ndarray`:
             One 3x3 matrix per-particle corresponding to each individual
-            particle orientation."""
+            particle orientation. Empty if the last call to :meth:`compute`
+            did not compute the particle tensor."""
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getParticleTensor(),
             freud.util.arr_type_t.FLOAT)
@@ -335,8 +348,9 @@ cdef class Hexatic(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(), dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(), dereference(qargs.thisptr))
         return self
 
     @property
@@ -458,8 +472,9 @@ cdef class Translational(_PairCompute):
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
 
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(), dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(), dereference(qargs.thisptr))
         return self
 
     @property
@@ -530,6 +545,11 @@ cdef class Steinhardt(_PairCompute):
     :math:`q'_l(i)=\sqrt{\frac{4\pi}{2l+1} \displaystyle\sum_{m=-l}^{l}
     |\overline{q}'_{lm}|^2 }`.
 
+    If a list of values of :math:`l` is given, the order parameters of all
+    of them are computed together from a single pass over the neighbors,
+    which is much faster than computing each :math:`l` separately. The
+    per-particle outputs then have one column for each :math:`l`.
+
     The :code:`norm` attribute argument provides normalized versions of the
     order parameter, where the normalization is performed by averaging the
     :math:`q_{lm}` values over all particles before computing the order
@@ -546,8 +566,9 @@ cdef class Steinhardt(_PairCompute):
         NumPy: :code:`numpy.nan_to_num(particle_order)`.
 
     Args:
-        l (unsigned int):
-            Spherical harmonic quantum number l.
+        l (unsigned int or sequence of unsigned int):
+            Spherical harmonic quantum number l, or a list of numbers l to
+            compute together.
         average (bool, optional):
             Determines whether to calculate the averaged Steinhardt order
             parameter (Default value = :code:`False`).
@@ -565,11 +586,14 @@ cdef class Steinhardt(_PairCompute):
             of the Steinhardt order parameter (Default value = :code:`False`).
     """  # noqa: E501
     cdef freud._order.Steinhardt * thisptr
+    cdef bint _multiple_l
 
     def __cinit__(self, l, average=False, wl=False, weighted=False,
                   wl_normalize=False):
-        self.thisptr = new freud._order.Steinhardt(l, average, wl, weighted,
-                                                   wl_normalize)
+        cdef vector[unsigned int] l_values = np.atleast_1d(l).tolist()
+        self.thisptr = new freud._order.Steinhardt(l_values, average, wl,
+                                                   weighted, wl_normalize)
+        self._multiple_l = np.ndim(l) > 0
 
     def __dealloc__(self):
         del self.thisptr
@@ -597,42 +621,60 @@ cdef class Steinhardt(_PairCompute):
 
     @property
     def l(self):  # noqa: E743
-        """unsigned int: Spherical harmonic quantum number l."""
-        return self.thisptr.getL()
+        """unsigned int or list[unsigned int]: Spherical harmonic quantum
+        number l, or the list of numbers l if a list was given."""
+        l_values = list(self.thisptr.getL())
+        return l_values if self._multiple_l else l_values[0]
+
+    def _per_particle(self, array):
+        # Arrays have one column per l, which is removed for a single l.
+        return array if self._multiple_l else np.ravel(array)
 
     @_Compute._computed_property
     def order(self):
-        """float: The system wide normalization of the :math:`q_l` or
-        :math:`w_l` order parameter."""
-        return self.thisptr.getOrder()
+        """float or :class:`numpy.ndarray`: The system wide normalization of
+        the :math:`q_l` or :math:`w_l` order parameter, for each l if a list
+        of l was given."""
+        order = self.thisptr.getOrder()
+        return np.array(order, dtype=np.float32) if self._multiple_l \
+            else order[0]
 
     @_Compute._computed_property
     def particle_order(self):
-        """:math:`\\left(N_{particles}\\right)` :class:`numpy.ndarray`: Variant
-        of the Steinhardt order parameter for each particle (filled with
-        :code:`nan` for particles with no neighbors)."""
-        return freud.util.make_managed_numpy_array(
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_l\\right)` :class:`numpy.ndarray`: Variant of the Steinhardt order
+        parameter for each particle (filled with :code:`nan` for particles
+        with no neighbors), with one column for each l if a list of l was
+        given."""
+        return self._per_particle(freud.util.make_managed_numpy_array(
             &self.thisptr.getParticleOrder(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
 
     @_Compute._computed_property
     def ql(self):
-        """:math:`\\left(N_{particles}\\right)` :class:`numpy.ndarray`:
-        :math:`q_l` Steinhardt order parameter for each particle (filled with
-        :code:`nan` for particles with no neighbors). This is always available,
-        no matter which options are selected."""
-        return freud.util.make_managed_numpy_array(
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_l\\right)` :class:`numpy.ndarray`: :math:`q_l` Steinhardt order
+        parameter for each particle (filled with :code:`nan` for particles
+        with no neighbors), with one column for each l if a list of l was
+        given. This is always available, no matter which options are
+        selected."""
+        return self._per_particle(freud.util.make_managed_numpy_array(
             &self.thisptr.getQl(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
 
     @_Compute._computed_property
     def particle_harmonics(self):
         """:math:`\\left(N_{particles}, 2*l+1\\right)` :class:`numpy.ndarray`:
         The raw array of \\overline{q}_{lm}(i). The array is provided in the
-        order given by fsph: :math:`m = 0, 1, ..., l, -1, ..., -l`."""
-        return freud.util.make_managed_numpy_array(
-            &self.thisptr.getQlm(),
-            freud.util.arr_type_t.COMPLEX_FLOAT)
+        order given by fsph: :math:`m = 0, 1, ..., l, -1, ..., -l`. If a list
+        of l was given, this is a list with one such array for each l."""
+        cdef size_t l_index
+        harmonics = []
+        for l_index in range(self.thisptr.getQlm().size()):
+            harmonics.append(freud.util.make_managed_numpy_array(
+                &self.thisptr.getQlm()[l_index],
+                freud.util.arr_type_t.COMPLEX_FLOAT))
+        return harmonics if self._multiple_l else harmonics[0]
 
     def compute(self, system, neighbors=None):
         R"""Compute the order parameter.
@@ -665,11 +707,20 @@ cdef class Steinhardt(_PairCompute):
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
 
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(),
-                             dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(),
+                                 dereference(qargs.thisptr))
         return self
 
+    def _add_to_graph(self, freud.locality.AnalysisGraph graph, neighbors,
+                      clusters, dependencies):
+        R"""Add this compute to an :class:`~.locality.AnalysisGraph`."""
+        neighbors = graph._neighbors_dependency(
+            neighbors, clusters, type(self).__name__)
+        return graph.thisptr.addTask(
+            self.thisptr.makeFrameTask(neighbors), dependencies, NULL)
+
     def __repr__(self):
         return ("freud.order.{cls}(l={l}, average={average}, wl={wl}, "
                 "weighted={weighted}, wl_normalize={wl_normalize})").format(
@@ -692,18 +743,28 @@ cdef class Steinhardt(_PairCompute):
             (:class:`matplotlib.axes.Axes`): Axis with the plot.
         """
         import freud.plot
-        xlabel = r"${mode_letter}{prime}_{{{sph_l}{average}}}$".format(
-            mode_letter='w' if self.wl else 'q',
-            prime='\'' if self.weighted else '',
-            sph_l=self.l,
-            average=',ave' if self.average else '')
-
+        labels = [
+            r"${mode_letter}{prime}_{{{sph_l}{average}}}$".format(
+                mode_letter='w' if self.wl else 'q',
+                prime='\'' if self.weighted else '',
+                sph_l=sph_l,
+                average=',ave' if self.average else '')
+            for sph_l in np.atleast_1d(self.l)]
+
+        if not self._multiple_l:
+            return freud.plot.histogram_plot(
+                self.particle_order,
+                title="Steinhardt Order Parameter " + labels[0],
+                xlabel=labels[0],
+                ylabel=r"Number of particles",
+                ax=ax)
         return freud.plot.histogram_plot(
             self.particle_order,
-            title="Steinhardt Order Parameter " + xlabel,
-            xlabel=xlabel,
+            title="Steinhardt Order Parameter",
+            xlabel="Order parameter",
             ylabel=r"Number of particles",
-            ax=ax)
+            ax=ax,
+            legend_labels=labels)
 
     def _repr_png_(self):
         try:
@@ -713,6 +774,77 @@ cdef class Steinhardt(_PairCompute):
             return None
 
 
+def compute_bond_orders(system, computes, neighbors=None):
+    R"""Computes several bond order parameters in one pass over the bonds.
+
+    The bonds of each particle are found once and passed to each of the
+    computes, so that the bond vectors are only computed once. This gives the
+    same results as calling the :code:`compute` method of each compute with
+    the same arguments.
+
+    Example::
+
+        >>> box, points = freud.data.make_random_system(
+        ...     box_size=10, num_points=100, is2D=True, seed=0)
+        >>> hex_order = freud.order.Hexatic(k=6)
+        >>> trans_order = freud.order.Translational(k=6)
+        >>> freud.order.compute_bond_orders(
+        ...     (box, points), [hex_order, trans_order],
+        ...     {'num_neighbors': 6})
+        [freud.order.Hexatic(...), freud.order.Translational(...)]
+
+    Args:
+        system:
+            Any object that is a valid argument to
+            :class:`freud.locality.NeighborQuery.from_system`.
+        computes (list):
+            The :class:`~.Hexatic`, :class:`~.Translational` and
+            :class:`~.Steinhardt` instances to compute.
+        neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+            Either a :class:`NeighborList <freud.locality.NeighborList>` of
+            neighbor pairs to use in the calculation, or a dictionary of
+            `query arguments
+            <https://freud.readthedocs.io/en/stable/topics/querying.html>`_.
+            Uses the default query arguments of the first compute if
+            :code:`None` (Default value: None).
+
+    Returns:
+        list: The computes.
+    """  # noqa: E501
+    cdef:
+        freud.locality.NeighborQuery nq
+        freud.locality.NeighborList nlist
+        freud.locality._QueryArgs qargs
+        const float[:, ::1] l_query_points
+        unsigned int num_query_points
+        vector[freud._locality.BondKernel*] kernels
+
+    computes = list(computes)
+    if len(computes) == 0:
+        raise ValueError("At least one compute must be provided.")
+    for compute in computes:
+        if isinstance(compute, Hexatic):
+            kernels.push_back((<Hexatic> compute).thisptr)
+        elif isinstance(compute, Translational):
+            kernels.push_back((<Translational> compute).thisptr)
+        elif isinstance(compute, Steinhardt):
+            kernels.push_back((<Steinhardt> compute).thisptr)
+        else:
+            raise TypeError(
+                "Only Hexatic, Translational and Steinhardt computes can be "
+                "computed together, not {}.".format(type(compute).__name__))
+
+    nq, nlist, qargs, l_query_points, num_query_points = \
+        computes[0]._preprocess_arguments(system, neighbors=neighbors)
+    with nogil:
+        freud._locality.loopOverBondKernels(
+            kernels, nq.get_ptr(), <vec3[float]*> &l_query_points[0, 0],
+            num_query_points, nlist.get_ptr(), dereference(qargs.thisptr))
+    for compute in computes:
+        compute._called_compute = True
+    return computes
+
+
 cdef class SolidLiquid(_PairCompute):
     R"""Identifies solid-like clusters using dot products of :math:`q_{lm}`.
 
@@ -783,9 +915,19 @@ cdef class SolidLiquid(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(),
-                             dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(),
+                                 dereference(qargs.thisptr))
+
+    def _add_to_graph(self, freud.locality.AnalysisGraph graph, neighbors,
+                      clusters, dependencies):
+        R"""Add this compute to an :class:`~.locality.AnalysisGraph`."""
+        neighbors = graph._neighbors_dependency(
+            neighbors, clusters, type(self).__name__)
+        return graph.thisptr.addTask(
+            self.thisptr.makeFrameTask(neighbors), dependencies,
+            &self.thisptr.getClusterIdx())
 
     @property
     def l(self):  # noqa: E743
@@ -918,7 +1060,8 @@ cdef class RotationalAutocorrelation(_Compute):
     correlation with an initial state. As such, the output can be treated as an
     order parameter measuring degrees of rotational (de)correlation. For
     analysis of a trajectory, the compute call needs to be
-    done at each trajectory frame.
+    done at each trajectory frame, or :meth:`compute_trajectory` can compute
+    the autocorrelation at every lag time of a whole trajectory at once.
 
     Args:
         l (int):
@@ -954,12 +1097,52 @@ cdef class RotationalAutocorrelation(_Compute):
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int nP = orientations.shape[0]
 
-        self.thisptr.compute(
-            <quat[float]*> &l_ref_orientations[0, 0],
-            <quat[float]*> &l_orientations[0, 0],
-            nP)
+        with nogil:
+            self.thisptr.compute(
+                <quat[float]*> &l_ref_orientations[0, 0],
+                <quat[float]*> &l_orientations[0, 0],
+                nP)
         return self
 
+    def compute_trajectory(self, orientations):
+        R"""Calculates the rotational autocorrelation at every lag time of a
+        trajectory.
+
+        The autocorrelation at a lag of :math:`m` frames is the value of
+        :attr:`order` averaged over all pairs of frames :math:`m` frames
+        apart. The hyperspherical harmonics of each orientation are computed
+        once, and the sums over all pairs of frames are evaluated with fast
+        Fourier transforms, so this is much faster than calling
+        :meth:`compute` for every pair of frames.
+
+        Args:
+            orientations ((:math:`N_{frames}`, :math:`N_{orientations}`, 4) :class:`numpy.ndarray`):
+                Orientations of every frame of the trajectory.
+        """  # noqa: E501
+        orientations = freud.util._convert_array(
+            orientations, shape=(None, None, 4))
+
+        cdef const float[:, :, ::1] l_orientations = orientations
+        cdef unsigned int n_frames = orientations.shape[0]
+        cdef unsigned int nP = orientations.shape[1]
+        if n_frames == 0:
+            raise ValueError("The trajectory must have at least one frame.")
+
+        with nogil:
+            self.thisptr.computeTrajectory(
+                <quat[float]*> &l_orientations[0, 0, 0], n_frames, nP)
+        self._called_compute = True
+        return self
+
+    @_Compute._computed_property
+    def autocorrelation(self):
+        """(:math:`N_{frames}`) :class:`numpy.ndarray`: Rotational
+        autocorrelation at each lag time, in frames, of the trajectory last
+        passed to :meth:`compute_trajectory`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getAutocorrelation(),
+            freud.util.arr_type_t.FLOAT)
+
     @_Compute._computed_property
     def order(self):
         """float: Autocorrelation of the system."""
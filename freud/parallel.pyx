@@ -5,8 +5,13 @@ R"""
 The :class:`freud.parallel` module controls the parallelization behavior of
 freud, determining how many threads the TBB-enabled parts of freud will use.
 freud uses all available threads for parallelization unless directed otherwise.
+On machines with several NUMA nodes, computes can be confined to the cores of
+one node with a :class:`TaskArena`, and the way parallel loops are split
+among threads can be tuned with :func:`set_loop_policy`.
 """
 
+from libcpp cimport bool
+
 cimport freud._parallel
 
 _num_threads = 0
@@ -60,3 +65,152 @@ class NumThreads:
 
     def __exit__(self, *args):
         set_num_threads(self.restore_N)
+
+
+_loop_partitioners = {
+    "auto": freud._parallel.LoopPartitioner.automatic,
+    "simple": freud._parallel.LoopPartitioner.simple,
+    "static": freud._parallel.LoopPartitioner.static_partition,
+}
+
+
+def get_loop_policy():
+    R"""Get the default partitioner and grain size of parallel loops.
+
+    Returns:
+        tuple[str, int]: The name of the partitioner and the grain size.
+    """
+    cdef freud._parallel.LoopPolicy policy = \
+        freud._parallel.getDefaultLoopPolicy()
+    for name, partitioner in _loop_partitioners.items():
+        if partitioner == policy.partitioner:
+            return name, policy.grain_size
+
+
+def set_loop_policy(partitioner="auto", grain_size=1):
+    R"""Set the default partitioner and grain size of parallel loops.
+
+    The partitioner decides how the iterations of a parallel loop, typically
+    over query points, are split into tasks run by the threads:
+
+    * :code:`'auto'` splits the loop further only when threads run out of
+      work. This is TBB's default and works well for most systems.
+    * :code:`'simple'` splits the loop down to chunks of :code:`grain_size`
+      iterations, which balances loops whose iterations have very different
+      costs, such as systems with dense and dilute regions, at the price of a
+      higher scheduling overhead.
+    * :code:`'static'` splits the loop evenly among the threads once, which
+      has the lowest overhead for loops with uniform iterations.
+
+    The grain size is the smallest number of iterations of a task. Larger
+    grain sizes reduce the scheduling overhead of cheap iterations.
+
+    Computes that are called repeatedly on similar systems, such as
+    :class:`freud.density.RDF` and the :mod:`freud.pmft` classes, use TBB's
+    affinity partitioner for their loop over query points regardless of this
+    setting, so that each thread processes the same points in every frame.
+
+    Args:
+        partitioner (str, optional):
+            One of :code:`'auto'`, :code:`'simple'` or :code:`'static'`.
+            (Default value = :code:`'auto'`).
+        grain_size (int, optional):
+            Smallest number of iterations of a task. (Default value = 1).
+    """
+    if partitioner not in _loop_partitioners:
+        raise ValueError(
+            "partitioner must be one of {}.".format(
+                ", ".join(repr(name) for name in _loop_partitioners)))
+    if grain_size < 1:
+        raise ValueError("grain_size must be at least 1.")
+    freud._parallel.setDefaultLoopPolicy(
+        _loop_partitioners[partitioner], grain_size)
+
+
+def get_numa_nodes():
+    R"""Get the NUMA nodes of the machine.
+
+    Returns:
+        list[int]: The ids of the NUMA nodes. If the topology is
+        not available to TBB, a single id of -1 is returned.
+    """
+    return list(freud._parallel.getNumaNodes())
+
+
+cdef class TaskArena:
+    R"""Context manager running the computes started in its context in a TBB
+    task arena, optionally bound to one NUMA node.
+
+    The parallel loops of computes called by the thread that entered the
+    context run on the threads of the arena. For an arena bound to a NUMA
+    node, these threads only run on the cores of that node, so the thread
+    local memory of the computes is allocated on that node. Several Python
+    threads can each enter a different arena, for example one per node, to run
+    independent computes concurrently without sharing memory across sockets.
+
+    Binding to NUMA nodes requires oneTBB with its hwloc based topology
+    support, and is ignored otherwise. Pinning threads to cores is only
+    supported on Linux. An arena must be entered and exited by the same
+    thread.
+
+    Example::
+
+        arenas = [freud.parallel.TaskArena(numa_node=node)
+                  for node in freud.parallel.get_numa_nodes()]
+        with arenas[0]:
+            rdf.compute(system)
+
+    Args:
+        numa_node (int, optional):
+            NUMA node to bind the arena to, one of :func:`get_numa_nodes`,
+            or :code:`None` for no binding. (Default value = :code:`None`).
+        num_threads (int, optional):
+            Maximum number of threads of the arena. If :code:`None`, use all
+            cores of the node. (Default value = :code:`None`).
+        pin_threads (bool, optional):
+            Whether to pin each thread joining the arena to a single core of
+            the node. (Default value = :code:`False`).
+    """
+    cdef freud._parallel.TaskArena *thisptr
+
+    def __cinit__(self, numa_node=None, num_threads=None, bool pin_threads=False):
+        if numa_node is None:
+            numa_node = -1
+        if num_threads is None or num_threads < 0:
+            num_threads = 0
+        self.thisptr = new freud._parallel.TaskArena(
+            numa_node, num_threads, pin_threads)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def __enter__(self):
+        self.thisptr.enter()
+        return self
+
+    def __exit__(self, *args):
+        self.thisptr.exit()
+
+    @property
+    def numa_node(self):
+        """int: The NUMA node of the arena, or -1 if it is not bound to a
+        node."""
+        return self.thisptr.getNumaNode()
+
+    @property
+    def num_threads(self):
+        """int: The maximum number of threads of the arena."""
+        return self.thisptr.getNumThreads()
+
+    @property
+    def pin_threads(self):
+        """bool: Whether threads joining the arena are pinned to cores."""
+        return self.thisptr.getPinThreads()
+
+    def __repr__(self):
+        return ("freud.parallel.{cls}(numa_node={numa_node}, "
+                "num_threads={num_threads}, pin_threads={pin_threads})").format(
+                    cls=type(self).__name__,
+                    numa_node=None if self.numa_node == -1 else self.numa_node,
+                    num_threads=self.num_threads,
+                    pin_threads=self.pin_threads)
@@ -111,10 +111,9 @@ cdef class _PMFT(_SpatialHistogram):
     def pmft(self):
         """:class:`np.ndarray`: The discrete potential of mean force and
         torque."""
-        with np.warnings.catch_warnings():
-            np.warnings.filterwarnings('ignore')
-            result = -np.log(np.copy(self._pcf))
-        return result
+        return freud.util.make_managed_numpy_array(
+            &self.pmftptr.getPMFT(),
+            freud.util.arr_type_t.FLOAT)
 
     @_Compute._computed_property
     def _pcf(self):
@@ -215,12 +214,13 @@ cdef class PMFTR12(_PMFT):
         cdef const float[::1] l_orientations = orientations
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftr12ptr.accumulate(nq.get_ptr(),
-                                   <float*> &l_orientations[0],
-                                   <vec3[float]*> &l_query_points[0, 0],
-                                   <float*> &l_query_orientations[0],
-                                   num_query_points, nlist.get_ptr(),
-                                   dereference(qargs.thisptr))
+        with nogil:
+            self.pmftr12ptr.accumulate(nq.get_ptr(),
+                                       <float*> &l_orientations[0],
+                                       <vec3[float]*> &l_query_points[0, 0],
+                                       <float*> &l_query_orientations[0],
+                                       num_query_points, nlist.get_ptr(),
+                                       dereference(qargs.thisptr))
         return self
 
     def __repr__(self):
@@ -324,12 +324,13 @@ cdef class PMFTXYT(_PMFT):
         cdef const float[::1] l_orientations = orientations
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftxytptr.accumulate(nq.get_ptr(),
-                                   <float*> &l_orientations[0],
-                                   <vec3[float]*> &l_query_points[0, 0],
-                                   <float*> &l_query_orientations[0],
-                                   num_query_points, nlist.get_ptr(),
-                                   dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxytptr.accumulate(nq.get_ptr(),
+                                       <float*> &l_orientations[0],
+                                       <vec3[float]*> &l_query_points[0, 0],
+                                       <float*> &l_query_orientations[0],
+                                       num_query_points, nlist.get_ptr(),
+                                       dereference(qargs.thisptr))
         return self
 
     def __repr__(self):
@@ -433,11 +434,12 @@ cdef class PMFTXY(_PMFT):
             query_orientations, shape=(num_query_points, ))
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftxyptr.accumulate(nq.get_ptr(),
-                                  <float*> &l_query_orientations[0],
-                                  <vec3[float]*> &l_query_points[0, 0],
-                                  num_query_points, nlist.get_ptr(),
-                                  dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxyptr.accumulate(nq.get_ptr(),
+                                      <float*> &l_query_orientations[0],
+                                      <vec3[float]*> &l_query_points[0, 0],
+                                      num_query_points, nlist.get_ptr(),
+                                      dereference(qargs.thisptr))
         return self
 
     @_Compute._computed_property
@@ -555,6 +557,10 @@ cdef class PMFTXYZ(_PMFT):
                 corresponding to the x-axis, then a point at :math:`(1, 0, 0)`
                 and a point at :math:`(-1, 0, 0)` are symmetrically equivalent
                 and can be counted towards both the positive and negative bins.
+                If the orientations form a group of rotations that only
+                exchange and flip the axes of the grid, such as the rotations
+                of a cube, each bond is binned once into its orbit under the
+                group, which is much faster for large groups.
                 If not supplied by user or :code:`None`, a unit quaternion will
                 be used (Default value = :code:`None`).
             neighbors (:class:`freud.locality.NeighborList` or dict, optional):
@@ -581,7 +587,9 @@ cdef class PMFTXYZ(_PMFT):
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(
                 system, query_points, neighbors)
-        l_query_points = l_query_points - self.shiftvec.reshape(1, 3)
+        # Only shift when needed so that the query points are not copied.
+        if np.any(self.shiftvec):
+            l_query_points = l_query_points - self.shiftvec.reshape(1, 3)
 
         query_orientations = freud.util._convert_array(
             np.atleast_1d(query_orientations), shape=(num_query_points, 4))
@@ -597,14 +605,15 @@ cdef class PMFTXYZ(_PMFT):
         cdef const float[:, ::1] l_equiv_orientations = equiv_orientations
         cdef unsigned int num_equiv_orientations = \
             l_equiv_orientations.shape[0]
-        self.pmftxyzptr.accumulate(
-            nq.get_ptr(),
-            <quat[float]*> &l_query_orientations[0, 0],
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points,
-            <quat[float]*> &l_equiv_orientations[0, 0],
-            num_equiv_orientations, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxyzptr.accumulate(
+                nq.get_ptr(),
+                <quat[float]*> &l_query_orientations[0, 0],
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points,
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                num_equiv_orientations, nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
     def __repr__(self):
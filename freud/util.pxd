@@ -8,10 +8,18 @@ import numpy as np
 cimport numpy as np
 from cpython cimport Py_INCREF
 from cython.operator cimport dereference
+from libc.stdint cimport uint64_t
 from libcpp cimport bool
 from libcpp.complex cimport complex
 
-from freud._util cimport ManagedArray, PyArray_SetBaseObject, quat, vec3
+from freud._util cimport (
+    ManagedArray,
+    Profile,
+    PyArray_SetBaseObject,
+    RaggedArray,
+    quat,
+    vec3,
+)
 
 ctypedef unsigned int uint
 ctypedef float complex fcomplex
@@ -23,6 +31,7 @@ ctypedef enum arr_type_t:
     COMPLEX_FLOAT
     COMPLEX_DOUBLE
     UNSIGNED_INT
+    UNSIGNED_INT64
     BOOL
 
 
@@ -33,6 +42,7 @@ ctypedef union arr_ptr_t:
     ManagedArray[float complex] *complex_float_ptr
     ManagedArray[double complex] *complex_double_ptr
     ManagedArray[uint] *uint_ptr
+    ManagedArray[uint64_t] *uint64_ptr
     ManagedArray[bool] *bool_ptr
 
 
@@ -75,6 +85,11 @@ cdef class _ManagedArrayContainer:
                                          element_size)
             obj.thisptr.uint_ptr = new ManagedArray[uint](
                 dereference(<const ManagedArray[uint] *>array))
+        elif arr_type == arr_type_t.UNSIGNED_INT64:
+            obj = _ManagedArrayContainer(arr_type, np.NPY_UINT64,
+                                         element_size)
+            obj.thisptr.uint64_ptr = new ManagedArray[uint64_t](
+                dereference(<const ManagedArray[uint64_t] *>array))
         elif arr_type == arr_type_t.BOOL:
             obj = _ManagedArrayContainer(arr_type, np.NPY_BOOL,
                                          element_size)
@@ -92,5 +107,19 @@ cdef inline make_managed_numpy_array(
         _ManagedArrayContainer.init(array, arr_type, element_size))
 
 
+cdef inline make_managed_numpy_ragged_array(
+        const void *offsets, const void *values, arr_type_t arr_type,
+        uint element_size=1):
+    """Make a list of arrays pointing to the segments of the data of a
+    RaggedArray, given pointers to its offsets and values arrays."""
+    offsets_array = make_managed_numpy_array(offsets, arr_type_t.UNSIGNED_INT)
+    values_array = make_managed_numpy_array(values, arr_type, element_size)
+    if len(offsets_array) < 2:
+        return []
+    return np.split(values_array, offsets_array[1:-1])
+
+
 cdef class _Compute:
     cdef public bool _called_compute
+    cdef Profile *_profile
+    cdef object _async_queue
@@ -1,6 +1,10 @@
 # Copyright (c) 2010-2020 The Regents of the University of Michigan
 # This file is from the freud project, released under the BSD 3-Clause License.
 
+import json
+import threading
+from collections import deque
+from concurrent.futures import Future, ThreadPoolExecutor
 from functools import wraps
 
 import numpy as np
@@ -8,6 +12,10 @@ import numpy as np
 import freud.box
 
 cimport numpy as np
+from libcpp.map cimport map
+from libcpp.string cimport string
+
+cimport freud._util
 
 # numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
@@ -51,6 +59,8 @@ cdef class _ManagedArrayContainer:
     def shape(self):
         if self.data_type == arr_type_t.UNSIGNED_INT:
             return tuple(self.thisptr.uint_ptr.shape())
+        elif self.data_type == arr_type_t.UNSIGNED_INT64:
+            return tuple(self.thisptr.uint64_ptr.shape())
         elif self.data_type == arr_type_t.FLOAT:
             return tuple(self.thisptr.float_ptr.shape())
         elif self.data_type == arr_type_t.DOUBLE:
@@ -69,6 +79,8 @@ cdef class _ManagedArrayContainer:
     def __dealloc__(self):
         if self.data_type == arr_type_t.UNSIGNED_INT:
             del self.thisptr.uint_ptr
+        elif self.data_type == arr_type_t.UNSIGNED_INT64:
+            del self.thisptr.uint64_ptr
         elif self.data_type == arr_type_t.FLOAT:
             del self.thisptr.float_ptr
         elif self.data_type == arr_type_t.DOUBLE:
@@ -90,6 +102,8 @@ cdef class _ManagedArrayContainer:
         """Return a constant raw pointer to the underlying data array."""
         if self.data_type == arr_type_t.UNSIGNED_INT:
             return self.thisptr.uint_ptr.get()
+        elif self.data_type == arr_type_t.UNSIGNED_INT64:
+            return self.thisptr.uint64_ptr.get()
         elif self.data_type == arr_type_t.FLOAT:
             return self.thisptr.float_ptr.get()
         elif self.data_type == arr_type_t.DOUBLE:
@@ -123,6 +137,128 @@ cdef class _ManagedArrayContainer:
             else self.shape + (self.element_size, ))
 
 
+_profiling_enabled = False
+
+
+cdef class _ProfileContext:
+    R"""Context manager that activates the profile of a compute on the
+    calling thread and times the context.
+
+    Args:
+        compute (:class:`_Compute`): The compute to record into.
+        output (bool): Whether the context accesses outputs of the compute
+            rather than computing them.
+    """
+    cdef Profile *profile
+    cdef bool output
+    cdef freud._util.ProfileScope *scope
+    cdef freud._util.ScopedTimer *timer
+
+    def __cinit__(self, _Compute compute, bool output):
+        self.profile = compute._profile
+        self.output = output
+
+    def __enter__(self):
+        self.scope = new freud._util.ProfileScope(self.profile)
+        if self.output:
+            self.timer = new freud._util.ScopedTimer("output")
+        else:
+            self.timer = new freud._util.ScopedTimer("compute")
+        return self
+
+    def __exit__(self, *args):
+        # The timer records into the profile before the scope deactivates it.
+        del self.timer
+        self.timer = NULL
+        del self.scope
+        self.scope = NULL
+
+    def __dealloc__(self):
+        del self.timer
+        del self.scope
+
+
+_async_executor = None
+_async_executor_lock = threading.Lock()
+
+
+def _get_async_executor():
+    R"""Get the pool of threads running asynchronous computes, creating it on
+    first use."""
+    global _async_executor
+    with _async_executor_lock:
+        if _async_executor is None:
+            _async_executor = ThreadPoolExecutor(
+                thread_name_prefix="freud-async")
+        return _async_executor
+
+
+def _copy_async_inputs(value):
+    R"""Copy the arrays and boxes of the arguments of an asynchronous compute,
+    so that the caller can reuse its buffers while the compute runs."""
+    if isinstance(value, np.ndarray):
+        return value.copy()
+    elif isinstance(value, freud.box.Box):
+        return freud.box.Box.from_box(value)
+    elif isinstance(value, (tuple, list)):
+        return type(value)(_copy_async_inputs(v) for v in value)
+    elif isinstance(value, dict):
+        return {k: _copy_async_inputs(v) for k, v in value.items()}
+    return value
+
+
+def _copy_async_system(system):
+    R"""Resolve the system of an asynchronous compute on the calling thread
+    and copy its box and points, since readers such as MDAnalysis reuse their
+    frame objects. Arguments that are not systems are copied as other
+    inputs, and errors are left to the compute so that the future raises
+    them."""
+    if isinstance(system, np.ndarray):
+        return system.copy()
+    try:
+        nq = freud.locality.NeighborQuery.from_system(system)
+    except (TypeError, ValueError):
+        return _copy_async_inputs(system)
+    return (freud.box.Box.from_box(nq.box), np.array(nq.points, copy=True))
+
+
+class _ComputeQueue:
+    R"""Runs the asynchronous computes of one compute object on the threads of
+    the asynchronous pool, one at a time and in the order they were
+    submitted, since they all write to the same compute."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._pending = deque()
+        self._running = False
+
+    def submit(self, function):
+        future = Future()
+        with self._lock:
+            self._pending.append((future, function))
+            start = not self._running
+            self._running = True
+        if start:
+            _get_async_executor().submit(self._run)
+        return future
+
+    def _run(self):
+        while True:
+            with self._lock:
+                if not self._pending:
+                    self._running = False
+                    return
+                future, function = self._pending.popleft()
+            if not future.set_running_or_notify_cancel():
+                continue
+            try:
+                result = function()
+            except BaseException as error:
+                future.set_exception(error)
+            else:
+                future.set_result(result)
+
+
 cdef class _Compute(object):
     R"""Parent class for all compute classes in freud.
 
@@ -143,6 +279,11 @@ cdef class _Compute(object):
             def cluster_idx(self):
                 return ...
 
+    Compute classes also record the time spent in their compute method and
+    in accessing their outputs, as well as the timers and counters of the C++
+    code they run, in :attr:`profile` while profiling is enabled (see
+    :func:`set_profiling_enabled`).
+
     Attributes:
         _called_compute (bool):
             Flag representing whether the compute method has been called.
@@ -150,6 +291,10 @@ cdef class _Compute(object):
 
     def __cinit__(self):
         self._called_compute = False
+        self._profile = new Profile()
+
+    def __dealloc__(self):
+        del self._profile
 
     def __getattribute__(self, attr):
         """Compute methods set a flag to indicate that quantities have been
@@ -162,7 +307,11 @@ cdef class _Compute(object):
 
             @wraps(compute)
             def compute_wrapper(*args, **kwargs):
-                return_value = compute(*args, **kwargs)
+                if _profiling_enabled:
+                    with _ProfileContext(self, False):
+                        return_value = compute(*args, **kwargs)
+                else:
+                    return_value = compute(*args, **kwargs)
                 self._called_compute = True
                 return return_value
             return compute_wrapper
@@ -189,9 +338,102 @@ cdef class _Compute(object):
             if not self._called_compute:
                 raise AttributeError(
                     "Property not computed. Call compute first.")
+            if _profiling_enabled:
+                with _ProfileContext(self, True):
+                    return prop(self, *args, **kwargs)
             return prop(self, *args, **kwargs)
         return wrapper
 
+    @property
+    def profile(self):
+        """dict: The timers and counters recorded while profiling was
+        enabled, since construction or the last call to
+        :meth:`reset_profile`.
+
+        Each entry maps a name to a dict of the number of ``calls`` of the
+        timer or counter, the total wall ``time`` in seconds of the timer, and
+        the total ``count`` of the counter. The ``compute`` and ``output``
+        timers measure calls to the compute method and accesses of computed
+        properties. Timers of threads running in parallel are summed, so the
+        times of parallel parts can exceed the wall time of the compute.
+        Timers and counters of the C++ code, such as ``neighbor query``,
+        ``bond loop``, ``reduction`` and ``bonds``, are only recorded if freud
+        was built with the ``ENABLE_PROFILING`` CMake option (see
+        :func:`is_profiling_available`).
+        """
+        cdef map[string, freud._util.ProfileEntry] entries = \
+            self._profile.getEntries()
+        return {
+            entry.first.decode("utf-8"): {
+                "calls": entry.second.calls,
+                "time": entry.second.seconds,
+                "count": entry.second.count,
+            }
+            for entry in entries
+        }
+
+    def reset_profile(self):
+        """Discard the timers and counters recorded in :attr:`profile`."""
+        self._profile.reset()
+
+    def compute_async(self, *args, result=None, arena=None, **kwargs):
+        R"""Call :code:`compute` on a background thread, returning a future.
+
+        The arguments are passed to :code:`compute`. The system is resolved
+        on the calling thread and its box and points are copied, as are the
+        arrays and boxes among the other arguments, so the caller can
+        overwrite its buffers or frame objects, for example while reading the
+        next frame, as soon as this method returns. Since
+        computes release the GIL while they run in C++, the caller can read
+        frames or run other Python code while the compute runs.
+
+        Computes submitted to the same object run one at a time and in order,
+        so several frames can be in flight at once and accumulating computes
+        such as :class:`freud.density.RDF` can be called with
+        :code:`reset=False`. Computes of different objects run concurrently.
+        The object holds the results of the last frame that was computed, so
+        per frame results should be read by the :code:`result` function, which
+        runs before the next frame of the same object is computed. The object
+        must not be used otherwise until its futures are done.
+
+        .. code-block:: python
+
+            futures = [
+                ql.compute_async(frame, neighbors=dict(num_neighbors=12),
+                                 result=lambda ql: ql.particle_order.copy())
+                for frame in trajectory]
+            particle_orders = [future.result() for future in futures]
+
+        Args:
+            result (callable, optional):
+                Function called with the compute once it has computed, whose
+                return value is the result of the future. If :code:`None`, the
+                result is the compute (Default value = :code:`None`).
+            arena (:class:`freud.parallel.TaskArena`, optional):
+                Arena whose threads run the parallel loops of the compute. If
+                :code:`None`, the default arena is used (Default value =
+                :code:`None`).
+
+        Returns:
+            :class:`concurrent.futures.Future`: The future of the compute.
+        """
+        if self._async_queue is None:
+            self._async_queue = _ComputeQueue()
+        if args:
+            args = (_copy_async_system(args[0]),) + _copy_async_inputs(args[1:])
+        kwargs = _copy_async_inputs(kwargs)
+        if "system" in kwargs:
+            kwargs["system"] = _copy_async_system(kwargs["system"])
+
+        def run():
+            if arena is None:
+                self.compute(*args, **kwargs)
+            else:
+                with arena:
+                    self.compute(*args, **kwargs)
+            return self if result is None else result(self)
+        return self._async_queue.submit(run)
+
     def __str__(self):
         return repr(self)
 
@@ -271,3 +513,121 @@ def _convert_box(box, dimensions=None):
         raise ValueError("The box must be {}-dimensional.".format(dimensions))
 
     return box
+
+
+def get_buffer_pool_statistics(reset=False):
+    R"""Get the counters of the pool that recycles the memory of computed
+    arrays.
+
+    The arrays computed by freud are allocated from a shared pool. When the
+    last reference to an array, including any numpy array viewing it, is
+    released, its memory is returned to the pool and reused by the next array
+    of a similar size instead of being allocated again.
+
+    Args:
+        reset (bool, optional):
+            Whether to reset the counters after reading them, except for the
+            number of cached bytes. (Default value = :code:`False`).
+
+    Returns:
+        dict: The number of ``allocations`` requested from the pool, the
+        number of ``reuses`` of recycled memory (allocations avoided), the
+        number of ``releases`` of memory to the pool, the number of
+        ``evictions`` of released memory freed because the pool was full, and
+        the number of ``cached_bytes`` currently held by the pool.
+    """
+    cdef freud._util.BufferPoolStatistics stats = \
+        freud._util.BufferPool.instance().getStatistics()
+    if reset:
+        freud._util.BufferPool.instance().resetStatistics()
+    return {
+        "allocations": stats.allocations,
+        "reuses": stats.reuses,
+        "releases": stats.releases,
+        "evictions": stats.evictions,
+        "cached_bytes": stats.cached_bytes,
+    }
+
+
+def set_buffer_pool_limit(max_cached_bytes):
+    R"""Set the maximum amount of memory held by the pool that recycles the
+    memory of computed arrays (see :func:`get_buffer_pool_statistics`).
+
+    Args:
+        max_cached_bytes (int):
+            Maximum number of bytes held by the pool. A limit of 0 disables
+            recycling. The default limit is 1 GiB.
+    """
+    if max_cached_bytes < 0:
+        raise ValueError("max_cached_bytes must be nonnegative.")
+    freud._util.BufferPool.instance().setMaxCachedBytes(max_cached_bytes)
+
+
+def clear_buffer_pool():
+    R"""Free all memory held by the pool that recycles the memory of computed
+    arrays (see :func:`get_buffer_pool_statistics`)."""
+    freud._util.BufferPool.instance().clear()
+
+
+def is_profiling_available():
+    R"""Check whether freud was built with the timers and counters of its C++
+    code, using the ``ENABLE_PROFILING`` CMake option.
+
+    Without them, profiles only contain the ``compute`` and ``output`` timers
+    (see :attr:`freud.util._Compute.profile`).
+
+    Returns:
+        bool: Whether the C++ code is instrumented.
+    """
+    return freud._util.isProfilingAvailable()
+
+
+def is_profiling_enabled():
+    R"""Check whether computes record profiles.
+
+    Returns:
+        bool: Whether profiling is enabled.
+    """
+    return _profiling_enabled
+
+
+def set_profiling_enabled(enabled=True):
+    R"""Enable or disable recording of profiles by all computes.
+
+    While profiling is enabled, each compute records timers and counters of
+    its calls into its :attr:`~freud.util._Compute.profile`. Profiling is
+    disabled by default.
+
+    Args:
+        enabled (bool, optional):
+            Whether to record profiles. (Default value = :code:`True`).
+    """
+    global _profiling_enabled
+    _profiling_enabled = bool(enabled)
+
+
+def export_chrome_trace(filename, computes):
+    R"""Write the timed scopes recorded by computes to a trace file that can
+    be opened in Chrome's ``about:tracing`` page or in Perfetto.
+
+    Each compute is shown as a separate process, with one track per thread
+    that ran its code.
+
+    Args:
+        filename (str):
+            Name of the JSON file to write.
+        computes (:class:`freud.util._Compute` or list):
+            Compute or list of computes whose profiles to export.
+    """
+    cdef _Compute compute
+    if isinstance(computes, _Compute):
+        computes = [computes]
+    events = []
+    for pid, compute in enumerate(computes):
+        events.append({
+            "name": "process_name", "ph": "M", "pid": pid, "tid": 0,
+            "args": {"name": "{}[{}]".format(type(compute).__name__, pid)}})
+        trace = json.loads(compute._profile.getChromeTrace(pid).decode("utf-8"))
+        events.extend(trace["traceEvents"])
+    with open(filename, "w") as trace_file:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, trace_file)
@@ -592,6 +592,26 @@ class TestBox:
             distances, [[1.0, 0.0, 1.0], [np.sqrt(2), 1.0, 0.0]], rtol=1e-6
         )
 
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_compute_all_distances_triclinic(self, is2D):
+        if is2D:
+            box = freud.box.Box(7, 9, 0, 0.3, 0, 0.8, is2D=True)
+        else:
+            box = freud.box.Box(7, 9, 11, 0.3, -0.4, 0.8)
+        np.random.seed(0)
+        points = np.random.uniform(-20, 20, size=(37, 3)).astype(np.float32)
+        query_points = np.random.uniform(-20, 20, size=(23, 3)).astype(np.float32)
+        if is2D:
+            points[:, 2] = 0
+            query_points[:, 2] = 0
+        distances = box.compute_all_distances(query_points, points)
+        deltas = box.wrap(
+            (points[np.newaxis, :, :] - query_points[:, np.newaxis, :]).reshape(-1, 3)
+        )
+        npt.assert_allclose(
+            distances, np.linalg.norm(deltas, axis=-1).reshape(23, 37), rtol=1e-5
+        )
+
     def test_contains_2d(self):
         box = freud.box.Box(2, 3, 0, 1, 0, 0)
         points = np.random.uniform(-0.5, 0.5, size=(100, 3)).astype(np.float32)
@@ -615,3 +635,63 @@ class TestBox:
         in_box_mask = np.ones(points.shape[0]).astype(bool)
         in_box_mask[:50] = False
         npt.assert_array_equal(in_box_mask, box.contains(points))
+
+    def test_frames(self):
+        """Compare the operations on stacks of frames to each frame."""
+        rng = np.random.default_rng(0)
+        boxes = [
+            freud.box.Box(2 + 0.1 * i, 3, 4, 0.5, 0.1 * i, 0.3) for i in range(5)
+        ]
+        vecs = rng.uniform(-10, 10, size=(5, 100, 3)).astype(np.float32)
+        imgs = rng.integers(-3, 4, size=(5, 100, 3)).astype(np.int32)
+
+        wrapped = freud.box.wrap_frames(boxes, vecs)
+        fractions = freud.box.make_fractional_frames(boxes, vecs)
+        absolute = freud.box.make_absolute_frames(boxes, fractions)
+        images = freud.box.get_images_frames(boxes, vecs)
+        unwrapped = freud.box.unwrap_frames(boxes, vecs, imgs)
+        for i, box in enumerate(boxes):
+            npt.assert_array_equal(wrapped[i], box.wrap(vecs[i]))
+            npt.assert_array_equal(fractions[i], box.make_fractional(vecs[i]))
+            npt.assert_array_equal(absolute[i], box.make_absolute(fractions[i]))
+            npt.assert_array_equal(images[i], box.get_images(vecs[i]))
+            npt.assert_array_equal(unwrapped[i], box.unwrap(vecs[i], imgs[i]))
+
+        # A single box is shared by all frames.
+        out = np.empty_like(vecs)
+        assert freud.box.wrap_frames(boxes[0], vecs, out=out) is out
+        for i in range(len(boxes)):
+            npt.assert_array_equal(out[i], boxes[0].wrap(vecs[i]))
+
+        with pytest.raises(ValueError):
+            freud.box.wrap_frames(boxes[:2], vecs)
+        with pytest.raises(ValueError):
+            freud.box.wrap_frames(boxes, vecs[0])
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_unwrap_trajectory(self, is2D):
+        rng = np.random.default_rng(0)
+        n_frames = 50
+        boxes = [
+            freud.box.Box(5 + 0.02 * i, 6, 0 if is2D else 7, 0.1, 0.05, 0.2)
+            for i in range(n_frames)
+        ]
+        steps = rng.normal(scale=0.3, size=(n_frames, 200, 3))
+        if is2D:
+            steps[..., 2] = 0
+        trajectory = np.cumsum(steps, axis=0).astype(np.float32)
+        wrapped = freud.box.wrap_frames(boxes, trajectory)
+
+        initial_images = boxes[0].get_images(trajectory[0])
+        unwrapped, images = freud.box.unwrap_trajectory(
+            boxes, wrapped, initial_images
+        )
+        npt.assert_array_equal(images, freud.box.get_images_frames(boxes, trajectory))
+        npt.assert_allclose(unwrapped, trajectory, atol=1e-4)
+
+        # Without initial images, the first frame is taken as unwrapped.
+        unwrapped, images = freud.box.unwrap_trajectory(boxes, wrapped)
+        npt.assert_array_equal(images[0], 0)
+        npt.assert_allclose(
+            unwrapped - unwrapped[0], trajectory - trajectory[0], atol=1e-4
+        )
@@ -98,6 +98,30 @@ class TestCluster:
         npt.assert_allclose(props.gyrations[1], g_tensor_2, rtol=1e-5, atol=1e-5)
         npt.assert_allclose(props.radii_of_gyration, [0, rg_2], rtol=1e-5, atol=1e-5)
 
+    def test_cluster_props_masses(self):
+        """Test mass-weighted centers and inertia tensors"""
+        box = freud.box.Box.square(L=5)
+        positions = np.array([[0, -2, 0], [0, -2, 0], [0, 2, 0], [-0.1, 1.9, 0]])
+        masses = np.array([2, 2, 1, 3])
+        clust = freud.cluster.Cluster()
+        clust.compute((box, positions), neighbors={"r_max": 0.5})
+
+        props = freud.cluster.ClusterProperties()
+        props.compute((box, positions), clust.cluster_idx)
+        npt.assert_allclose(props.centers_of_mass, props.centers, atol=1e-5)
+        npt.assert_allclose(props.cluster_masses, [2, 2])
+
+        props.compute((box, positions), clust.cluster_idx, masses)
+        com_2 = [-0.075, 1.925, 0]
+        i_tensor_2 = [[0.0075, -0.0075, 0], [-0.0075, 0.0075, 0], [0, 0, 0.015]]
+        npt.assert_allclose(props.centers[1, :], [-0.05, 1.95, 0], atol=1e-5)
+        npt.assert_allclose(props.centers_of_mass[0, :], [0, -2, 0], atol=1e-5)
+        # The periodic center of mass differs slightly from the mean position.
+        npt.assert_allclose(props.centers_of_mass[1, :], com_2, atol=1e-4)
+        npt.assert_allclose(props.inertia_tensors[0], 0, atol=1e-5)
+        npt.assert_allclose(props.inertia_tensors[1], i_tensor_2, atol=1e-4)
+        npt.assert_allclose(props.cluster_masses, [4, 4])
+
     def test_cluster_com_periodic(self):
         "Tests center of mass for symmetric, box-spanning clusters."
         box = freud.Box.cube(3)
@@ -154,6 +178,24 @@ class TestCluster:
 
         assert np.all(ckeys == check_values)
 
+    def test_cluster_order(self):
+        """Clusters are sorted by size and then by their smallest point."""
+        box, points = freud.data.make_random_system(10, 2000, seed=1)
+        clust = freud.cluster.Cluster()
+        clust.compute((box, points), neighbors={"r_max": 0.6})
+
+        sizes = np.bincount(clust.cluster_idx)
+        assert len(sizes) == clust.num_clusters
+        min_ids = [
+            np.min(np.where(clust.cluster_idx == c)[0]) for c in range(len(sizes))
+        ]
+        order = sorted(range(len(sizes)), key=lambda c: (-sizes[c], min_ids[c]))
+        npt.assert_equal(order, np.arange(len(sizes)))
+
+        # The keys of each cluster are its points in increasing order.
+        for c, keys in enumerate(clust.cluster_keys):
+            npt.assert_equal(keys, np.where(clust.cluster_idx == c)[0])
+
     def test_repr(self):
         clust = freud.cluster.Cluster()
         assert str(clust) == str(eval(repr(clust)))
@@ -463,6 +463,30 @@ class TestCorrelationFunction:
 
                 npt.assert_allclose(ocf.correlation, correct, atol=1e-6)
 
+    def test_multiple_fields(self):
+        r_max = 5.0
+        bins = 20
+        num_points = 500
+        num_fields = 3
+        box, points = freud.data.make_random_system(r_max * 3.1, num_points, seed=0)
+        values = np.random.default_rng(0).standard_normal((num_points, num_fields))
+        values = values + 1j * np.random.default_rng(1).standard_normal(
+            (num_points, num_fields)
+        )
+        neighbors = {"r_max": r_max, "exclude_ii": True}
+        ocf = freud.density.CorrelationFunction(bins, r_max, num_fields)
+        assert ocf.num_fields == num_fields
+        ocf.compute((box, points), values, neighbors=neighbors)
+        assert ocf.correlation.shape == (bins, num_fields)
+        for field in range(num_fields):
+            single = freud.density.CorrelationFunction(bins, r_max)
+            single.compute((box, points), values[:, field], neighbors=neighbors)
+            npt.assert_allclose(ocf.correlation[:, field], single.correlation)
+            npt.assert_equal(ocf.bin_counts, single.bin_counts)
+
+        with pytest.raises(ValueError):
+            ocf.compute((box, points), values[:, 0], neighbors=neighbors)
+
 
 class TestCorrelationFunctionManagedArray(ManagedArrayTestBase):
     def build_object(self):
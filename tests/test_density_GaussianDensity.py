@@ -134,10 +134,136 @@ class TestGaussianDensity:
             # This has discretization error as well as single-precision error
             assert np.isclose(np.sum(gd.density), np.sum(values), rtol=1e-4)
 
+    @staticmethod
+    def _reference_density(box, points, width, r_max, sigma):
+        """Evaluate the Gaussian of every point at every grid cell."""
+        edges = [
+            (np.arange(w) + 0.5) * L / w - L / 2
+            for w, L in zip(width, (box.Lx, box.Ly, box.Lz))
+        ]
+        centers = np.stack(np.meshgrid(*edges, indexing="ij"), axis=-1)
+        centers = centers.reshape(-1, 3)
+        dims = 2 if box.is2D else 3
+        normalization = (2 * np.pi * sigma ** 2) ** (-dims / 2)
+        density = np.zeros(len(centers))
+        for point in points:
+            r_sq = np.sum(box.wrap(centers - point) ** 2, axis=1)
+            density += np.where(
+                r_sq < r_max ** 2, normalization * np.exp(-r_sq / (2 * sigma ** 2)), 0
+            )
+        return density.reshape(width)
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_orthorhombic_matches_reference(self, is2D):
+        width = (16, 12, 1) if is2D else (16, 12, 10)
+        r_max, sigma = 2.5, 1.0
+        box = freud.box.Box(8, 6, 0 if is2D else 5, is2D=is2D)
+        _, points = freud.data.make_random_system(1, 50, is2D=is2D, seed=0)
+        points = box.wrap(points * [box.Lx, box.Ly, box.Lz])
+        gd = freud.density.GaussianDensity(width[: 2 if is2D else 3], r_max, sigma)
+        gd.compute((box, points))
+        expected = self._reference_density(box, points, width, r_max, sigma)
+        npt.assert_allclose(gd.density, np.squeeze(expected), atol=1e-5)
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_fft_matches_direct(self, is2D):
+        width, r_max, sigma = 32, 5.5, 1.5
+        box, points = freud.data.make_random_system(12, 100, is2D=is2D, seed=0)
+        values = np.random.default_rng(0).random(len(points))
+        direct = freud.density.GaussianDensity(width, r_max, sigma)
+        fft = freud.density.GaussianDensity(width, r_max, sigma, mode="fft")
+        direct.compute((box, points), values)
+        fft.compute((box, points), values)
+        assert fft.mode == "fft"
+        # The cloud-in-cell deposition blurs the Gaussians by a fraction of the
+        # grid spacing.
+        npt.assert_allclose(
+            fft.density, direct.density, atol=0.02 * np.max(direct.density)
+        )
+        npt.assert_allclose(np.sum(fft.density), np.sum(direct.density), rtol=2e-3)
+
+    def test_fft_invalid_box(self):
+        points = np.zeros((1, 3), dtype=np.float32)
+        gd = freud.density.GaussianDensity(10, 2.0, 1.0, mode="fft")
+        with pytest.raises(ValueError):
+            gd.compute((freud.box.Box(10, 10, 10, xy=0.5), points))
+        box = freud.box.Box.cube(10)
+        box.periodic_x = False
+        with pytest.raises(ValueError):
+            gd.compute((box, points))
+        with pytest.raises(ValueError):
+            freud.density.GaussianDensity(10, 2.0, 1.0, mode="spectral")
+
+    @pytest.mark.parametrize("mode", ["direct", "fft"])
+    def test_thread_independent(self, mode):
+        # Each grid cell is filled by a single task, so the result does not
+        # depend on the number of threads.
+        box, points = freud.data.make_random_system(10, 2000, seed=0)
+        gd = freud.density.GaussianDensity(40, 2.0, 0.5, mode=mode)
+        with freud.parallel.NumThreads(1):
+            gd.compute((box, points))
+            density = np.copy(gd.density)
+        with freud.parallel.NumThreads(4):
+            gd.compute((box, points))
+        npt.assert_array_equal(gd.density, density)
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    @pytest.mark.parametrize("slab_width", [0, 5, 100])
+    def test_file(self, tmp_path, is2D, slab_width):
+        box, points = freud.data.make_random_system(10, 500, is2D=is2D, seed=0)
+        values = np.random.default_rng(0).random(len(points))
+        width = (40, 30) if is2D else (40, 30, 20)
+        gd = freud.density.GaussianDensity(width, 2.0, 0.5)
+        gd.compute((box, points), values)
+        filename = str(tmp_path / "density.bin")
+        gd_file = freud.density.GaussianDensity(width, 2.0, 0.5)
+        gd_file.compute((box, points), values, filename=filename, slab_width=slab_width)
+        assert isinstance(gd_file.density, np.memmap)
+        npt.assert_array_equal(gd_file.density, gd.density)
+        npt.assert_array_equal(
+            np.fromfile(filename, dtype=np.float32).reshape(gd.width),
+            gd.density.reshape(gd.width),
+        )
+
+        # The FFT mode cannot write to a file.
+        gd_fft = freud.density.GaussianDensity(width, 2.0, 0.5, mode="fft")
+        with pytest.raises(ValueError):
+            gd_fft.compute((box, points), filename=filename)
+
+    @pytest.mark.parametrize("is2D", (False, True))
+    def test_adaptive(self, is2D):
+        box, points = freud.data.make_random_system(10, 500, is2D=is2D, seed=0)
+        width = (40, 30) if is2D else (40, 30, 20)
+        gd = freud.density.GaussianDensity(width, 2.0, 0.5)
+        gd.compute((box, points))
+        with pytest.raises(AttributeError):
+            gd.sigmas
+
+        # Points with fewer neighbors within sigma use the fixed width.
+        gd_adaptive = freud.density.GaussianDensity(width, 2.0, 0.5)
+        gd_adaptive.compute_adaptive((box, points), num_neighbors=len(points))
+        npt.assert_array_equal(gd_adaptive.sigmas, np.full(len(points), 0.5))
+        npt.assert_allclose(gd_adaptive.density, gd.density, rtol=1e-5, atol=1e-6)
+
+        gd_adaptive.compute_adaptive((box, points), num_neighbors=4)
+        assert gd_adaptive.sigmas.shape == (len(points),)
+        assert np.all(gd_adaptive.sigmas <= 0.5)
+        assert np.any(gd_adaptive.sigmas < 0.5)
+        assert gd_adaptive.density.shape == gd.density.shape
+
+        with pytest.raises(ValueError):
+            gd_adaptive.compute_adaptive((box, points), num_neighbors=0)
+        gd_fft = freud.density.GaussianDensity(width, 2.0, 0.5, mode="fft")
+        with pytest.raises(ValueError):
+            gd_fft.compute_adaptive((box, points), num_neighbors=4)
+
     def test_repr(self):
         gd = freud.density.GaussianDensity(100, 10.0, 0.1)
         assert str(gd) == str(eval(repr(gd)))
 
+        gd = freud.density.GaussianDensity(100, 10.0, 0.1, mode="fft")
+        assert str(gd) == str(eval(repr(gd)))
+
         # Use both signatures
         gd3 = freud.density.GaussianDensity((98, 99, 100), 10.0, 0.1)
         assert str(gd3) == str(eval(repr(gd3)))
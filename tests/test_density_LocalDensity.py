@@ -92,3 +92,25 @@ class TestLocalDensity:
         ) / v_around
         correct_density = [cd0, cd1, 0]
         npt.assert_allclose(ld.density, correct_density, rtol=1e-4)
+
+    def test_compute_adaptive(self):
+        box = freud.box.Box.cube(10)
+        points = np.array([[0, 0, 0], [1, 0, 0], [0, 2, 0], [0, 0, -3]])
+        query_points = np.array([[0, 0, 0], [1, 0, 1]])
+        num_neighbors = 2
+
+        ld = freud.density.LocalDensity(self.r_max, self.diameter)
+        ld.compute_adaptive((box, points), num_neighbors, query_points)
+
+        # The farthest of the two nearest neighbors is at distance 1 of the
+        # first query point and sqrt(2) of the second.
+        r_far = np.array([1, np.sqrt(2)])
+        npt.assert_allclose(
+            ld.density, num_neighbors / (4 / 3 * np.pi * r_far ** 3), rtol=1e-5
+        )
+        npt.assert_array_equal(ld.num_neighbors, [num_neighbors, num_neighbors])
+
+        # Without query points, each point is excluded from its own neighbors.
+        ld.compute_adaptive((box, points), 1)
+        r_far = np.array([1, 1, 2, 3])
+        npt.assert_allclose(ld.density, 1 / (4 / 3 * np.pi * r_far ** 3), rtol=1e-5)
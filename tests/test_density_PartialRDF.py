@@ -0,0 +1,115 @@
+import numpy as np
+import numpy.testing as npt
+import pytest
+
+import freud
+
+
+class TestPartialRDF:
+    def setup_method(self):
+        self.L = 10
+        self.N = 600
+        self.n_types = 3
+        self.r_max = 3
+        self.bins = 30
+        self.box, self.points = freud.data.make_random_system(
+            self.L, self.N, seed=0
+        )
+        self.types = np.random.default_rng(0).integers(0, self.n_types, self.N)
+
+    def test_attributes(self):
+        prdf = freud.density.PartialRDF(
+            self.bins, self.r_max, self.n_types, r_min=0.5
+        )
+        rdf = freud.density.RDF(self.bins, self.r_max, r_min=0.5)
+        assert prdf.n_types == self.n_types
+        assert prdf.nbins == self.bins
+        npt.assert_allclose(prdf.bounds, (0.5, self.r_max))
+        npt.assert_allclose(prdf.bin_centers, rdf.bin_centers)
+        npt.assert_allclose(prdf.bin_edges, rdf.bin_edges)
+
+        with pytest.raises(AttributeError):
+            prdf.rdf
+
+        prdf.compute((self.box, self.points), self.types)
+        assert prdf.rdf.shape == (self.n_types, self.n_types, self.bins)
+        assert prdf.n_r.shape == (self.n_types, self.n_types, self.bins)
+        assert prdf.bin_counts.shape == (self.n_types, self.n_types, self.bins)
+
+    def test_partials(self):
+        """Compare the partial RDFs to RDFs of subsets of the points."""
+        prdf = freud.density.PartialRDF(self.bins, self.r_max, self.n_types)
+        tq = freud.locality.TypedNeighborQuery(self.box, self.points, self.types)
+        prdf.compute(tq)
+
+        # The partials sum to the RDF of all points.
+        rdf = freud.density.RDF(self.bins, self.r_max)
+        rdf.compute((self.box, self.points))
+        npt.assert_array_equal(prdf.bin_counts.sum(axis=(0, 1)), rdf.bin_counts)
+
+        for a in range(self.n_types):
+            for b in range(self.n_types):
+                query_points = self.points[self.types == a]
+                points = self.points[self.types == b]
+                rdf = freud.density.RDF(self.bins, self.r_max)
+                rdf.compute(
+                    (self.box, points),
+                    query_points,
+                    neighbors=dict(r_max=self.r_max, exclude_ii=a == b),
+                )
+                npt.assert_array_equal(prdf.bin_counts[a, b], rdf.bin_counts)
+                npt.assert_allclose(prdf.rdf[a, b], rdf.rdf, rtol=1e-5)
+                npt.assert_allclose(
+                    prdf.n_r[a, b],
+                    np.cumsum(rdf.bin_counts) / len(query_points),
+                    rtol=1e-5,
+                )
+
+    def test_query_points(self):
+        prdf = freud.density.PartialRDF(self.bins, self.r_max, self.n_types)
+        query_points = self.points[:100]
+        query_types = self.types[:100]
+        prdf.compute(
+            (self.box, self.points), self.types, query_points, query_types
+        )
+        aq = freud.locality.AABBQuery(self.box, self.points)
+        nlist = aq.query(query_points, dict(r_max=self.r_max)).toNeighborList()
+        expected = np.zeros((self.n_types, self.n_types, self.bins))
+        np.add.at(
+            expected,
+            (
+                query_types[nlist.query_point_indices],
+                self.types[nlist.point_indices],
+                (nlist.distances / self.r_max * self.bins).astype(int),
+            ),
+            1,
+        )
+        npt.assert_allclose(prdf.bin_counts.sum(), len(nlist))
+        npt.assert_allclose(prdf.bin_counts, expected, atol=2)
+
+        # Accumulating twice doubles the counts but not the RDFs.
+        rdf = prdf.rdf.copy()
+        prdf.compute(
+            (self.box, self.points),
+            self.types,
+            query_points,
+            query_types,
+            reset=False,
+        )
+        npt.assert_allclose(prdf.bin_counts.sum(), 2 * len(nlist))
+        npt.assert_allclose(prdf.rdf, rdf, rtol=1e-5)
+
+    def test_invalid(self):
+        prdf = freud.density.PartialRDF(self.bins, self.r_max, self.n_types)
+        with pytest.raises(ValueError):
+            prdf.compute((self.box, self.points))
+        with pytest.raises(ValueError):
+            prdf.compute((self.box, self.points), self.types, self.points[:10])
+        with pytest.raises(ValueError):
+            prdf.compute((self.box, self.points), self.types + self.n_types)
+        with pytest.raises(ValueError):
+            freud.density.PartialRDF(self.bins, self.r_max, 0)
+
+    def test_repr(self):
+        prdf = freud.density.PartialRDF(self.bins, self.r_max, self.n_types)
+        assert str(prdf) == str(eval(repr(prdf)))
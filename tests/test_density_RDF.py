@@ -195,6 +195,252 @@ class TestRDF:
         )
         npt.assert_allclose(rdf.bin_edges, expected_bin_edges, atol=1e-6)
 
+    def test_bin_edges(self):
+        # Bonds as long as a bin edge fall into the bin above the edge,
+        # whether their distances are found by a query or a neighbor list.
+        box = freud.box.Box.cube(10)
+        points = np.array(
+            [[0, 0, 0], [0.5, 0, 0], [1, 0, 0], [0, 1.5, 0]], dtype=np.float32
+        )
+        bins = 8
+        r_max = 2
+        expected = np.zeros(bins, dtype=np.uint32)
+        expected[[2, 4, 6, 7]] = [4, 2, 4, 2]
+
+        test_set = util.make_raw_query_nlist_test_set(
+            box, points, points, "ball", r_max, 0, True
+        )
+        for nq, neighbors in test_set:
+            rdf = freud.density.RDF(bins, r_max)
+            rdf.compute(nq, neighbors=neighbors)
+            npt.assert_array_equal(rdf.bin_counts, expected)
+
+    def test_accumulation_strategies(self):
+        box, points = freud.data.make_random_system(10, 200, seed=0)
+        rdf = freud.density.RDF(50, 3)
+        assert rdf.accumulation_strategy == "auto"
+        rdf.compute((box, points))
+        # Many bonds in few bins are accumulated into dense copies.
+        assert rdf.accumulation_strategy == "dense"
+        expected = rdf.bin_counts.copy()
+
+        for strategy in ["dense", "atomic", "tiled"]:
+            rdf = freud.density.RDF(50, 3)
+            rdf.accumulation_strategy = strategy
+            rdf.compute((box, points))
+            rdf.compute((box, points), reset=False)
+            assert rdf.accumulation_strategy == strategy
+            npt.assert_array_equal(rdf.bin_counts, 2 * expected)
+
+        with pytest.raises(ValueError):
+            rdf.accumulation_strategy = "sparse"
+
+    def test_count_precision(self):
+        frames = [
+            freud.data.make_random_system(10, 200, seed=seed) for seed in range(4)
+        ]
+        rdf = freud.density.RDF(50, 3)
+        assert rdf.count_precision == "uint32"
+        wide_rdf = freud.density.RDF(50, 3)
+        wide_rdf.count_precision = "uint64"
+        assert wide_rdf.count_precision == "uint64"
+        for frame in frames:
+            rdf.compute(frame, reset=False)
+            wide_rdf.compute(frame, reset=False)
+
+        assert rdf.bin_counts.dtype == np.uint32
+        assert wide_rdf.bin_counts.dtype == np.uint64
+        npt.assert_array_equal(wide_rdf.bin_counts, rdf.bin_counts)
+        npt.assert_array_equal(wide_rdf.rdf, rdf.rdf)
+        npt.assert_array_equal(wide_rdf.n_r, rdf.n_r)
+
+        # The totals of the frames are cleared by a reset.
+        wide_rdf.compute(frames[0])
+        rdf.compute(frames[0])
+        npt.assert_array_equal(wide_rdf.bin_counts, rdf.bin_counts)
+
+        with pytest.raises(ValueError):
+            rdf.count_precision = "float"
+
+    def test_compute_trajectory(self):
+        frames = [
+            freud.data.make_random_system(10, 200, seed=seed) for seed in range(4)
+        ]
+        r_max = 3
+        rdf = freud.density.RDF(50, r_max)
+        for frame in frames:
+            rdf.compute(frame, reset=False)
+
+        rdf_trajectory = freud.density.RDF(50, r_max)
+        rdf_trajectory.compute_trajectory(frames)
+        npt.assert_array_equal(rdf_trajectory.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(rdf_trajectory.rdf, rdf.rdf, rtol=1e-6)
+
+        # The trajectory is added to the previous frames unless reset.
+        rdf_trajectory.compute_trajectory(frames, reset=False)
+        npt.assert_array_equal(rdf_trajectory.bin_counts, 2 * rdf.bin_counts)
+
+        query_args = dict(mode="nearest", num_neighbors=4)
+        rdf = freud.density.RDF(50, r_max)
+        for frame in frames:
+            rdf.compute(frame, neighbors=query_args, reset=False)
+        rdf_trajectory = freud.density.RDF(50, r_max)
+        rdf_trajectory.compute_trajectory(frames, neighbors=query_args)
+        npt.assert_array_equal(rdf_trajectory.bin_counts, rdf.bin_counts)
+
+        nlist = (
+            freud.locality.AABBQuery(*frames[0])
+            .query(frames[0][1], query_args)
+            .toNeighborList()
+        )
+        with pytest.raises(ValueError):
+            rdf_trajectory.compute_trajectory(frames, neighbors=nlist)
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_compute_streaming(self, is2D):
+        box, points = freud.data.make_random_system(12, 2000, is2D=is2D, seed=0)
+        box = freud.box.Box(*box.L, xy=0.3, is2D=is2D)
+        points = box.wrap(points)
+        r_max = 2.5
+        rdf = freud.density.RDF(40, r_max).compute((box, points))
+
+        loaded = []
+
+        def source(begin, end):
+            fractions = box.make_fractional(points)[:, 0] % 1
+            range_points = points[(fractions >= begin) & (fractions < end)]
+            loaded.append(len(range_points))
+            return range_points
+
+        # The bonds are the same whether the slabs are thicker or thinner than
+        # the halos.
+        for num_slabs in (1, 3, 16):
+            rdf_streaming = freud.density.RDF(40, r_max)
+            loaded.clear()
+            rdf_streaming.compute_streaming(box, source, num_slabs)
+            npt.assert_array_equal(rdf_streaming.bin_counts, rdf.bin_counts)
+            npt.assert_allclose(rdf_streaming.rdf, rdf.rdf, rtol=1e-6)
+            npt.assert_allclose(rdf_streaming.n_r, rdf.n_r, rtol=1e-6)
+            if num_slabs > 1:
+                assert max(loaded) < len(points)
+
+        # The system is added to the previous frames unless reset.
+        rdf_streaming.compute_streaming(box, source, 4, reset=False)
+        npt.assert_array_equal(rdf_streaming.bin_counts, 2 * rdf.bin_counts)
+
+        def failing_source(begin, end):
+            raise KeyError("missing chunk")
+
+        with pytest.raises(KeyError):
+            rdf_streaming.compute_streaming(box, failing_source, 4)
+        with pytest.raises(ValueError):
+            rdf_streaming.compute_streaming(
+                box, source, 4, neighbors=dict(mode="nearest", num_neighbors=4)
+            )
+        with pytest.raises(ValueError):
+            rdf_streaming.compute_streaming(box, source, 0)
+        with pytest.raises(ValueError):
+            rdf_streaming.compute_streaming(box, points, 4)
+
+    @pytest.mark.parametrize("count_precision", ["uint32", "uint64"])
+    def test_compute_streaming_domains(self, count_precision):
+        box, points = freud.data.make_random_system(12, 2000, seed=1)
+        r_max = 2.5
+        rdf = freud.density.RDF(40, r_max).compute((box, points))
+
+        def source(begin, end):
+            fractions = box.make_fractional(points)[:, 0] % 1
+            return points[(fractions >= begin) & (fractions < end)]
+
+        # Emulate the processes of a domain decomposition, first recording
+        # the counts of each domain and then summing them.
+        num_slabs = 7
+        domains = [range(0, 2), range(2, 2), range(2, 7)]
+        local_counts = []
+        for slabs in domains:
+            rdf_domain = freud.density.RDF(40, r_max)
+            rdf_domain.count_precision = count_precision
+            rdf_domain.compute_streaming(
+                box,
+                source,
+                num_slabs,
+                slabs=slabs,
+                allreduce=lambda counts: local_counts.append(counts.copy()),
+            )
+        assert all(counts.dtype == np.uint64 for counts in local_counts)
+        total_counts = np.sum(local_counts, axis=0)
+        npt.assert_array_equal(total_counts[:-2], rdf.bin_counts)
+        npt.assert_array_equal(total_counts[-2:], len(points))
+
+        def allreduce(counts):
+            counts[:] = total_counts
+
+        for slabs in domains:
+            rdf_domain = freud.density.RDF(40, r_max)
+            rdf_domain.count_precision = count_precision
+            rdf_domain.compute_streaming(
+                box, source, num_slabs, slabs=slabs, allreduce=allreduce
+            )
+            npt.assert_array_equal(rdf_domain.bin_counts, rdf.bin_counts)
+            npt.assert_allclose(rdf_domain.rdf, rdf.rdf, rtol=1e-6)
+
+        # Without an allreduce, a process only holds the bonds of its slabs.
+        rdf_domain.compute_streaming(box, source, num_slabs, slabs=range(0, 2))
+        npt.assert_array_equal(rdf_domain.bin_counts, local_counts[0][:-2])
+
+        def failing_allreduce(counts):
+            raise OSError("lost rank")
+
+        with pytest.raises(OSError):
+            rdf_domain.compute_streaming(
+                box, source, num_slabs, allreduce=failing_allreduce
+            )
+        with pytest.raises(ValueError):
+            rdf_domain.compute_streaming(box, source, num_slabs, slabs=range(0, 7, 2))
+        with pytest.raises(ValueError):
+            rdf_domain.compute_streaming(box, source, num_slabs, slabs=range(8, 9))
+
+    @pytest.mark.parametrize("count_precision", ["uint32", "uint64"])
+    def test_blocks(self, count_precision):
+        frames = [
+            freud.data.make_random_system(10, 300, seed=seed) for seed in range(7)
+        ]
+        block_size = 3
+        rdf = freud.density.RDF(30, 3, block_size=block_size)
+        rdf.count_precision = count_precision
+        assert rdf.block_size == block_size
+        for frame in frames:
+            rdf.compute(frame, reset=False)
+
+        # The blocks match separate RDFs of each block of frames, and the
+        # incomplete last block is not included.
+        block_rdfs = []
+        for start in range(0, len(frames) - block_size + 1, block_size):
+            block_rdf = freud.density.RDF(30, 3)
+            for frame in frames[start : start + block_size]:
+                block_rdf.compute(frame, reset=False)
+            block_rdfs.append(block_rdf.rdf)
+        block_rdfs = np.array(block_rdfs)
+        assert rdf.num_blocks == len(block_rdfs)
+        npt.assert_allclose(
+            rdf.block_mean, block_rdfs.mean(axis=0), rtol=1e-5, atol=1e-6
+        )
+        npt.assert_allclose(
+            rdf.block_standard_error,
+            block_rdfs.std(axis=0, ddof=1) / np.sqrt(len(block_rdfs)),
+            rtol=1e-4,
+            atol=1e-6,
+        )
+
+        # A reset discards the blocks.
+        rdf.compute(frames[0])
+        assert rdf.num_blocks == 0
+        assert np.all(np.isnan(rdf.block_mean))
+        assert np.all(np.isnan(rdf.block_standard_error))
+
+        with pytest.raises(AttributeError):
+            freud.density.RDF(30, 3).compute(frames[0]).block_mean
+
 
 class TestRDFManagedArray(ManagedArrayTestBase):
     def build_object(self):
@@ -129,6 +129,17 @@ class TestSphereVoxelization:
         with pytest.raises(ValueError):
             vox.compute((test_box, test_points))
 
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_file(self, tmp_path, is2D):
+        box, points = freud.data.make_random_system(20, 50, is2D=is2D, seed=0)
+        vox = freud.density.SphereVoxelization(32, 2.0)
+        vox.compute((box, points))
+        filename = str(tmp_path / "voxels.bin")
+        vox_file = freud.density.SphereVoxelization(32, 2.0)
+        vox_file.compute((box, points), filename=filename, slab_width=3)
+        assert isinstance(vox_file.voxels, np.memmap)
+        np.testing.assert_array_equal(vox_file.voxels, vox.voxels)
+
     def test_repr(self):
         vox = freud.density.SphereVoxelization(100, 10.0)
         assert str(vox) == str(eval(repr(vox)))
@@ -34,6 +34,21 @@ class TestDiffractionPattern:
         # should be different.
         assert reset == np.allclose(dp_check.diffraction, dp_reference.diffraction)
 
+    def test_multiple_views(self):
+        box, positions = freud.data.UnitCell.fcc().generate_system(4)
+        views = rowan.random.rand(3)
+        dp_batched = freud.diffraction.DiffractionPattern(grid_size=64)
+        dp_batched.compute((box, positions), view_orientation=views)
+
+        dp_sequential = freud.diffraction.DiffractionPattern(grid_size=64)
+        for i, view in enumerate(views):
+            dp_sequential.compute((box, positions), view_orientation=view, reset=i == 0)
+
+        npt.assert_allclose(
+            dp_batched.diffraction, dp_sequential.diffraction, rtol=1e-6, atol=1e-12
+        )
+        npt.assert_allclose(dp_batched.k_vectors, dp_sequential.k_vectors)
+
     def test_attribute_access(self):
         grid_size = 234
         output_size = 123
@@ -0,0 +1,84 @@
+import matplotlib
+import numpy as np
+import numpy.testing as npt
+import pytest
+
+import freud
+
+matplotlib.use("agg")
+
+
+def direct_structure_factor(box, points, bins, k_max, k_min):
+    """Compute S(k) by looping over all reciprocal lattice vectors."""
+    box_matrix = box.to_matrix()
+    reciprocal = 2 * np.pi * np.linalg.inv(box_matrix).T
+    max_index = int(np.ceil(k_max * np.max(np.linalg.norm(box_matrix, axis=0))))
+    indices = np.arange(-max_index, max_index + 1)
+    hkl = np.stack(np.meshgrid(indices, indices, indices), axis=-1).reshape(-1, 3)
+    k_vectors = hkl @ reciprocal.T
+    k_magnitudes = np.linalg.norm(k_vectors, axis=-1)
+    keep = (k_magnitudes >= k_min) & (k_magnitudes < k_max)
+    k_vectors, k_magnitudes = k_vectors[keep], k_magnitudes[keep]
+    rho_k = np.exp(1j * k_vectors @ points.T).sum(axis=-1)
+    S_k_all = np.abs(rho_k) ** 2 / len(points)
+    bin_edges = np.linspace(k_min, k_max, bins + 1)
+    sums, _ = np.histogram(k_magnitudes, bins=bin_edges, weights=S_k_all)
+    counts, _ = np.histogram(k_magnitudes, bins=bin_edges)
+    return np.divide(sums, counts, out=np.zeros(bins), where=counts > 0), counts
+
+
+class TestStaticStructureFactorDirect:
+    def test_compute(self):
+        box, points = freud.data.make_random_system(4, 30, seed=1)
+        bins, k_max, k_min = 10, 6, 0.5
+        sf = freud.diffraction.StaticStructureFactorDirect(bins, k_max, k_min)
+        sf.compute((box, points))
+        S_k, counts = direct_structure_factor(box, points, bins, k_max, k_min)
+        npt.assert_allclose(sf.S_k, S_k, rtol=1e-4, atol=1e-5)
+        # Only one of each pair of opposite wavevectors is counted.
+        npt.assert_array_equal(2 * sf.bin_counts, counts)
+        npt.assert_allclose(sf.min_valid_k, 2 * np.pi / 4, rtol=1e-6)
+
+    def test_accumulation(self):
+        sf = freud.diffraction.StaticStructureFactorDirect(10, 6)
+        sf_accumulated = freud.diffraction.StaticStructureFactorDirect(10, 6)
+        systems = [freud.data.make_random_system(4, 30, seed=i) for i in range(2)]
+        S_k = []
+        for system in systems:
+            S_k.append(sf.compute(system).S_k)
+            sf_accumulated.compute(system, reset=False)
+        npt.assert_allclose(sf_accumulated.S_k, np.mean(S_k, axis=0), rtol=1e-5)
+
+    def test_crystal_peak(self):
+        box, points = freud.data.UnitCell.sc().generate_system(5)
+        sf = freud.diffraction.StaticStructureFactorDirect(100, 7)
+        sf.compute((box, points))
+        # The first Bragg peak of the simple cubic lattice is at 2 pi.
+        peak_bin = np.searchsorted(sf.bin_edges, 2 * np.pi) - 1
+        assert np.argmax(sf.S_k) == peak_bin
+
+    def test_attribute_access(self):
+        sf = freud.diffraction.StaticStructureFactorDirect(10, 6, 1)
+        assert sf.k_max == 6
+        assert sf.k_min == 1
+        assert len(sf.bin_centers) == 10
+        assert len(sf.bin_edges) == 11
+        with pytest.raises(AttributeError):
+            sf.S_k
+        with pytest.raises(AttributeError):
+            sf.plot()
+        sf.compute(freud.data.make_random_system(4, 30))
+        sf.S_k
+        sf.box
+        sf.plot()
+        sf._repr_png_()
+
+    def test_invalid_arguments(self):
+        with pytest.raises(ValueError):
+            freud.diffraction.StaticStructureFactorDirect(0, 6)
+        with pytest.raises(ValueError):
+            freud.diffraction.StaticStructureFactorDirect(10, 1, 2)
+
+    def test_repr(self):
+        sf = freud.diffraction.StaticStructureFactorDirect(10, 6, 1)
+        assert str(sf) == str(eval(repr(sf)))
@@ -0,0 +1,64 @@
+import matplotlib
+import numpy as np
+import numpy.testing as npt
+import pytest
+
+import freud
+
+matplotlib.use("agg")
+
+
+class TestStaticStructureFactorRDF:
+    def test_ideal_gas(self):
+        """S(k) of uncorrelated points is 1 at wavelengths below r_max."""
+        box, points = freud.data.make_random_system(20, 4000, seed=1)
+        sf = freud.diffraction.StaticStructureFactorRDF(20, 20, 8, k_min=5)
+        sf.compute((box, points))
+        npt.assert_allclose(sf.S_k, 1, atol=0.1)
+
+    def test_matches_direct(self):
+        """The transform of the pair distances matches the direct sum."""
+        box, points = freud.data.UnitCell.fcc().generate_system(
+            8, sigma_noise=0.1, seed=2
+        )
+        bins, k_max, k_min = 20, 12, 4
+        sf_rdf = freud.diffraction.StaticStructureFactorRDF(
+            bins, k_max, box.Lx / 2 - 1e-3, k_min=k_min
+        )
+        sf_rdf.compute((box, points))
+        sf_direct = freud.diffraction.StaticStructureFactorDirect(bins, k_max, k_min)
+        sf_direct.compute((box, points))
+        # The Lorch window broadens the peak, so it may shift by one bin.
+        peak = np.argmax(sf_direct.S_k)
+        assert abs(np.argmax(sf_rdf.S_k) - peak) <= 1
+
+    def test_accumulation(self):
+        systems = [freud.data.make_random_system(10, 500, seed=i) for i in range(2)]
+        sf = freud.diffraction.StaticStructureFactorRDF(10, 10, 4)
+        sf_accumulated = freud.diffraction.StaticStructureFactorRDF(10, 10, 4)
+        S_k = []
+        for system in systems:
+            S_k.append(sf.compute(system).S_k)
+            sf_accumulated.compute(system, reset=False)
+        npt.assert_allclose(sf_accumulated.S_k, np.mean(S_k, axis=0), rtol=1e-4)
+
+    def test_attribute_access(self):
+        sf = freud.diffraction.StaticStructureFactorRDF(10, 6, 3, k_min=1, r_bins=50)
+        npt.assert_allclose(sf.k_max, 6)
+        npt.assert_allclose(sf.k_min, 1)
+        assert sf.r_bins == 50
+        assert sf.lorch_window
+        assert len(sf.bin_centers) == 10
+        with pytest.raises(AttributeError):
+            sf.S_k
+        sf.compute(freud.data.make_random_system(10, 100))
+        sf.S_k
+        sf.box
+        sf.plot()
+        sf._repr_png_()
+
+    def test_repr(self):
+        sf = freud.diffraction.StaticStructureFactorRDF(
+            10, 6, 3, k_min=1, r_bins=50, lorch_window=False
+        )
+        assert str(sf) == str(eval(repr(sf)))
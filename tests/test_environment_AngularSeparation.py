@@ -1,6 +1,7 @@
 import numpy as np
 import numpy.testing as npt
 import pytest
+import rowan
 
 import freud
 
@@ -48,6 +49,25 @@ class TestAngularSeparationGlobal:
             for j in [0, 1]:
                 npt.assert_allclose(ang.angles[i][j], np.pi / 16, atol=1e-6)
 
+    def test_max_only(self):
+        np.random.seed(0)
+        global_ors = rowan.random.rand(50).astype(np.float32)
+        ors = rowan.random.rand(100).astype(np.float32)
+        equivalent_orientations = np.array(
+            [[1, 0, 0, 0], [0, 1, 0, 0], [-1, 0, 0, 0], [0, -1, 0, 0]], dtype=np.float32
+        )
+
+        ang = freud.environment.AngularSeparationGlobal()
+        ang.compute(global_ors, ors, equivalent_orientations)
+        angles = ang.angles
+        npt.assert_array_equal(ang.min_indices, np.argmin(angles, axis=1))
+        npt.assert_allclose(ang.min_angles, np.min(angles, axis=1))
+
+        ang.compute(global_ors, ors, equivalent_orientations, max_only=True)
+        assert ang.angles.shape == (0, 50)
+        npt.assert_array_equal(ang.min_indices, np.argmin(angles, axis=1))
+        npt.assert_allclose(ang.min_angles, np.min(angles, axis=1))
+
     def test_repr(self):
         ang = freud.environment.AngularSeparationGlobal()
         assert str(ang) == str(eval(repr(ang)))
@@ -78,6 +78,35 @@ class TestInterface:
         assert test_twelve.point_count == 12
         assert len(test_twelve.point_ids) == 12
 
+    def test_random_system(self):
+        """Compare the interface to the unique indices of a NeighborList."""
+        box, points = freud.data.make_random_system(10, 2000, seed=0)
+        query_points = points[:500]
+        points = points[500:]
+        query_args = dict(r_max=0.8)
+        nlist = (
+            freud.locality.AABBQuery(box, points)
+            .query(query_points, query_args)
+            .toNeighborList()
+        )
+
+        inter = freud.interface.Interface()
+        inter.compute((box, points), query_points, neighbors=query_args)
+        np.testing.assert_array_equal(
+            inter.point_ids, np.unique(nlist.point_indices)
+        )
+        np.testing.assert_array_equal(
+            inter.query_point_ids, np.unique(nlist.query_point_indices)
+        )
+        assert inter.point_count == len(inter.point_ids)
+        assert inter.query_point_count == len(inter.query_point_ids)
+
+        # The same interface is found from the NeighborList.
+        inter.compute((box, points), query_points, neighbors=nlist)
+        np.testing.assert_array_equal(
+            inter.point_ids, np.unique(nlist.point_indices)
+        )
+
     def test_repr(self):
         inter = freud.interface.Interface()
         assert str(inter) == str(eval(repr(inter)))
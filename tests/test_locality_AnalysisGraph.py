@@ -0,0 +1,129 @@
+import numpy as np
+import numpy.testing as npt
+import pytest
+
+import freud
+
+
+class TestAnalysisGraph:
+    def setup_method(self):
+        self.frames = [
+            freud.data.make_random_system(10, 400, seed=seed) for seed in range(4)
+        ]
+        self.rdf_args = dict(r_max=3, exclude_ii=True)
+        self.ql_args = dict(num_neighbors=12, exclude_ii=True)
+        self.cluster_args = dict(r_max=1.2, exclude_ii=True)
+
+    def _make_graph(self):
+        self.rdf = freud.density.RDF(30, 3)
+        self.ql = freud.order.Steinhardt(6)
+        self.cl = freud.cluster.Cluster()
+        self.cl_props = freud.cluster.ClusterProperties()
+        graph = freud.locality.AnalysisGraph()
+        rdf_neighbors = graph.add_neighbors(dict(r_max=3))
+        ql_neighbors = graph.add_neighbors(dict(num_neighbors=12))
+        cluster_neighbors = graph.add_neighbors(dict(r_max=1.2))
+        graph.add(self.rdf, neighbors=rdf_neighbors)
+        graph.add(self.ql, neighbors=ql_neighbors)
+        clusters = graph.add(self.cl, neighbors=cluster_neighbors)
+        graph.add(self.cl_props, clusters=clusters)
+        return graph
+
+    def test_matches_loop(self):
+        graph = self._make_graph()
+        assert len(graph.nodes) == 7
+        graph.compute(self.frames)
+        assert graph.num_frames == len(self.frames)
+
+        rdf = freud.density.RDF(30, 3)
+        for system in self.frames:
+            rdf.compute(system, neighbors=self.rdf_args, reset=False)
+        npt.assert_array_equal(self.rdf.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(self.rdf.rdf, rdf.rdf, rtol=1e-6)
+
+        # The per-frame computes hold the results of the last frame.
+        system = self.frames[-1]
+        ql = freud.order.Steinhardt(6)
+        ql.compute(system, neighbors=self.ql_args)
+        npt.assert_allclose(self.ql.ql, ql.ql, rtol=1e-6)
+        cl = freud.cluster.Cluster()
+        cl.compute(system, neighbors=self.cluster_args)
+        npt.assert_array_equal(self.cl.cluster_idx, cl.cluster_idx)
+        cl_props = freud.cluster.ClusterProperties()
+        cl_props.compute(system, cl.cluster_idx)
+        npt.assert_allclose(self.cl_props.centers, cl_props.centers, atol=1e-5)
+
+        # Computing again resets the accumulated histogram.
+        graph.compute(self.frames)
+        npt.assert_array_equal(self.rdf.bin_counts, rdf.bin_counts)
+        graph.compute(self.frames, reset=False)
+        npt.assert_array_equal(self.rdf.bin_counts, 2 * rdf.bin_counts)
+
+    def test_callback(self):
+        graph = self._make_graph()
+        num_clusters = []
+        graph.compute(
+            self.frames,
+            callback=lambda frame: num_clusters.append(self.cl.num_clusters),
+        )
+        expected = []
+        for system in self.frames:
+            cl = freud.cluster.Cluster()
+            cl.compute(system, neighbors=self.cluster_args)
+            expected.append(cl.num_clusters)
+        assert num_clusters == expected
+
+        indices = []
+
+        def stop(frame):
+            indices.append(frame)
+            if frame == 1:
+                raise ZeroDivisionError
+
+        with pytest.raises(ZeroDivisionError):
+            graph.compute(self.frames, callback=stop)
+        assert indices == [0, 1]
+
+    def test_solid_liquid(self):
+        sl = freud.order.SolidLiquid(6, 0.7, 6)
+        cl_props = freud.cluster.ClusterProperties()
+        graph = freud.locality.AnalysisGraph()
+        neighbors = graph.add_neighbors(dict(num_neighbors=12))
+        clusters = graph.add(sl, neighbors=neighbors)
+        graph.add(cl_props, clusters=clusters)
+        graph.compute(self.frames)
+
+        system = self.frames[-1]
+        expected = freud.order.SolidLiquid(6, 0.7, 6)
+        expected.compute(system, neighbors=self.ql_args)
+        npt.assert_array_equal(sl.cluster_idx, expected.cluster_idx)
+        expected_props = freud.cluster.ClusterProperties()
+        expected_props.compute(system, expected.cluster_idx)
+        npt.assert_array_equal(cl_props.sizes, expected_props.sizes)
+
+    def test_invalid(self):
+        graph = freud.locality.AnalysisGraph()
+        neighbors = graph.add_neighbors(dict(r_max=3))
+        rdf = graph.add(freud.density.RDF(30, 3), neighbors=neighbors)
+        with pytest.raises(TypeError):
+            graph.add(freud.density.LocalDensity(3, 1), neighbors=neighbors)
+        with pytest.raises(ValueError):
+            graph.add(freud.density.RDF(30, 3))
+        with pytest.raises(ValueError):
+            graph.add(freud.density.RDF(30, 3), neighbors=rdf)
+        with pytest.raises(ValueError):
+            graph.add(freud.density.RDF(30, 3), neighbors=10)
+        with pytest.raises(ValueError):
+            graph.add(freud.cluster.ClusterProperties(), clusters=neighbors)
+        with pytest.raises(ValueError):
+            graph.add(freud.cluster.ClusterProperties(), clusters=rdf)
+        with pytest.raises(ValueError):
+            graph.add(freud.density.RDF(30, 3), neighbors=neighbors, after=[10])
+        assert len(graph.nodes) == 2
+
+        with pytest.raises(AttributeError):
+            graph.num_frames
+
+    def test_repr(self):
+        graph = freud.locality.AnalysisGraph()
+        assert str(graph) == str(eval(repr(graph)))
@@ -0,0 +1,77 @@
+import numpy as np
+import numpy.testing as npt
+import pytest
+
+import freud
+
+
+def _bond_set(nlist):
+    return set(map(tuple, np.asarray(nlist[:])))
+
+
+class TestCachedNeighborList:
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_matches_query(self, is2D):
+        L, N, r_max, skin = 10, 500, 1.5, 0.4
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=0)
+        np.random.seed(1)
+        cnl = freud.locality.CachedNeighborList(r_max, skin)
+        for _ in range(20):
+            step = np.random.uniform(-0.02, 0.02, size=(N, 3))
+            if is2D:
+                step[:, 2] = 0
+            points = box.wrap(points + step)
+            cnl.compute((box, points))
+            expected = (
+                freud.locality.LinkCell(box, points)
+                .query(points, dict(r_max=r_max, exclude_ii=True))
+                .toNeighborList()
+            )
+            assert _bond_set(cnl.nlist) == _bond_set(expected)
+            npt.assert_allclose(
+                np.sort(cnl.nlist.distances), np.sort(expected.distances), atol=1e-5
+            )
+        # Small steps should reuse the cached bonds for most frames.
+        assert 1 <= cnl.num_builds < 20
+
+    def test_query_points(self):
+        L, N, r_max, skin = 10, 200, 2.0, 0.5
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        _, query_points = freud.data.make_random_system(L, N // 2, seed=1)
+        cnl = freud.locality.CachedNeighborList(r_max, skin)
+        cnl.compute((box, points), query_points)
+        expected = (
+            freud.locality.LinkCell(box, points)
+            .query(query_points, dict(r_max=r_max))
+            .toNeighborList()
+        )
+        assert _bond_set(cnl.nlist) == _bond_set(expected)
+
+        # Moving the query points beyond the skin forces a rebuild.
+        cnl.compute((box, points), box.wrap(query_points + [1.1 * skin, 0, 0]))
+        assert cnl.num_builds == 2
+
+    def test_rebuild_conditions(self):
+        L, N = 10, 100
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        cnl = freud.locality.CachedNeighborList(1.5, 0.5)
+        cnl.compute((box, points))
+        cnl.compute((box, points))
+        assert cnl.num_builds == 1
+        cnl.compute((freud.box.Box.cube(L + 1), points))
+        assert cnl.num_builds == 2
+        cnl.compute((freud.box.Box.cube(L + 1), points[:-1]))
+        assert cnl.num_builds == 3
+        cnl.reset()
+        cnl.compute((freud.box.Box.cube(L + 1), points[:-1]))
+        assert cnl.num_builds == 4
+
+    def test_invalid(self):
+        with pytest.raises(ValueError):
+            freud.locality.CachedNeighborList(0, 0.5)
+        with pytest.raises(ValueError):
+            freud.locality.CachedNeighborList(1, -0.5)
+
+    def test_repr(self):
+        cnl = freud.locality.CachedNeighborList(1.5, 0.5)
+        assert str(cnl) == str(eval(repr(cnl)))
@@ -286,3 +286,142 @@ class TestNeighborList:
         nlist = self.nq.query(self.nq.points[:-1], self.query_args).toNeighborList()
         assert nlist.num_query_points == len(self.nq.points) - 1
         assert nlist.num_points == len(self.nq.points)
+
+    def test_file(self, tmp_path):
+        filename = str(tmp_path / "nlist.bin")
+        weights = np.arange(len(self.nlist), dtype=np.float32)
+        nlist = freud.locality.NeighborList.from_arrays(
+            self.N + 3,
+            self.N,
+            self.nlist.query_point_indices,
+            self.nlist.point_indices,
+            self.nlist.distances,
+            weights,
+        )
+        nlist.save(filename)
+
+        def check(loaded, expected):
+            assert loaded.num_query_points == expected.num_query_points
+            assert loaded.num_points == expected.num_points
+            npt.assert_array_equal(loaded[:], expected[:])
+            npt.assert_array_equal(loaded.distances, expected.distances)
+            npt.assert_array_equal(loaded.weights, expected.weights)
+            npt.assert_array_equal(loaded.neighbor_counts, expected.neighbor_counts)
+            npt.assert_array_equal(loaded.segments, expected.segments)
+
+        for mmap in [True, False]:
+            check(freud.locality.NeighborList.from_file(filename, mmap), nlist)
+
+        # Filtering a mapped list must not change the file.
+        mapped = freud.locality.NeighborList.from_file(filename)
+        mapped.filter_r(2)
+        assert len(mapped) < len(nlist)
+        check(freud.locality.NeighborList.from_file(filename), nlist)
+
+        # Query results written in chunks match the in-memory list.
+        points = self.nq.points
+        for chunk_size in [1, 7, 1000]:
+            self.nq.query(points, self.query_args).toNeighborListFile(
+                filename, chunk_size
+            )
+            check(freud.locality.NeighborList.from_file(filename), self.nlist)
+        self.nq.query(points, self.query_args).toNeighborListFile(
+            filename, sort_by_distance=True
+        )
+        check(
+            freud.locality.NeighborList.from_file(filename),
+            self.nq.query(points, self.query_args).toNeighborList(True),
+        )
+
+        # Computes accept mapped lists.
+        rdf = freud.density.RDF(10, 3)
+        rdf.compute(self.nq, neighbors=self.nlist)
+        expected = rdf.bin_counts.copy()
+        rdf.compute(self.nq, neighbors=freud.locality.NeighborList.from_file(filename))
+        npt.assert_array_equal(rdf.bin_counts, expected)
+
+        with pytest.raises(RuntimeError):
+            freud.locality.NeighborList.from_file(str(tmp_path / "missing.bin"))
+
+    def test_compact(self):
+        nlist = self.nq.query(self.nq.points, dict(r_max=2.5)).toNeighborList()
+        expected = nlist.copy()
+        full_usage = nlist.memory_usage
+        rdf = freud.density.RDF(10, 2.5)
+        expected_rdf = rdf.compute(self.nq, neighbors=nlist).bin_counts.copy()
+
+        for quantize_distances in [False, True]:
+            compact = nlist.copy().compact(quantize_distances)
+            assert compact.is_compact
+            assert compact.memory_usage < full_usage
+            bin_counts = rdf.compute(self.nq, neighbors=compact).bin_counts
+            if quantize_distances:
+                # Quantized distances may fall into neighboring bins.
+                assert np.sum(bin_counts) == np.sum(expected_rdf)
+            else:
+                npt.assert_array_equal(bin_counts, expected_rdf)
+            assert compact.is_compact
+
+            # Accessing the bond arrays restores the full layout.
+            npt.assert_array_equal(compact[:], expected[:])
+            assert not compact.is_compact
+            npt.assert_allclose(
+                compact.distances, expected.distances, atol=2.5 / 65535
+            )
+            npt.assert_array_equal(compact.weights, 1)
+
+        # Weights other than 1 are kept.
+        weights = np.linspace(1, 2, len(expected), dtype=np.float32)
+        nlist = freud.locality.NeighborList.from_arrays(
+            self.N,
+            self.N,
+            expected.query_point_indices,
+            expected.point_indices,
+            expected.distances,
+            weights,
+        ).compact()
+        npt.assert_array_equal(nlist.weights, weights)
+
+    def test_symmetrize(self):
+        nlist = self.nlist.copy().symmetrize()
+        pairs = set(zip(self.nlist.query_point_indices, self.nlist.point_indices))
+        pairs |= {(j, i) for i, j in pairs}
+        assert set(map(tuple, nlist[:])) == pairs
+        assert len(nlist) == len(pairs)
+        npt.assert_allclose(
+            nlist.distances,
+            self.nq.box.compute_distances(
+                self.nq.points[nlist.query_point_indices],
+                self.nq.points[nlist.point_indices],
+            ),
+            rtol=1e-5,
+        )
+
+        # Bonds of each query point are sorted by point index.
+        for i in range(self.N):
+            point_indices = nlist.point_indices[nlist.query_point_indices == i]
+            npt.assert_array_equal(point_indices, np.sort(point_indices))
+
+        with pytest.raises(ValueError):
+            freud.locality.NeighborList.from_arrays(
+                3, 4, [0], [1], [1.0]
+            ).symmetrize()
+
+    def test_union_intersection(self):
+        ball = self.nq.query(self.nq.points, dict(r_max=2, exclude_ii=True))
+        ball = ball.toNeighborList()
+        knn_pairs = set(zip(self.nlist.query_point_indices, self.nlist.point_indices))
+        ball_pairs = set(zip(ball.query_point_indices, ball.point_indices))
+
+        union = self.nlist.copy().union(ball)
+        assert set(map(tuple, union[:])) == knn_pairs | ball_pairs
+        assert len(union) == len(knn_pairs | ball_pairs)
+
+        intersection = self.nlist.copy().intersection(ball)
+        assert set(map(tuple, intersection[:])) == knn_pairs & ball_pairs
+        assert len(intersection) == len(knn_pairs & ball_pairs)
+        npt.assert_array_less(intersection.distances, 2)
+
+        other = freud.locality.NeighborList.from_arrays(3, 4, [0], [1], [1.0])
+        with pytest.raises(ValueError):
+            self.nlist.copy().union(other)
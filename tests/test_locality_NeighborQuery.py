@@ -319,6 +319,34 @@ class NeighborQueryTest:
 
         npt.assert_equal(set(result_list), set(list_nlist))
 
+    def test_query_to_nlist_sorted(self):
+        """Test that generated NeighborLists contain the queried bonds sorted
+        by query point index and then by point index or distance."""
+        L = 10  # Box Dimensions
+        N = 400  # number of particles
+
+        box, ref_points = freud.data.make_random_system(L, N, seed=0)
+        _, points = freud.data.make_random_system(L, N, seed=1)
+
+        nq = self.build_query_object(box, ref_points, L / 10)
+
+        for query_args in (
+            dict(mode="ball", r_max=2),
+            dict(mode="ball", r_max=2, r_min=0.5),
+            dict(mode="nearest", num_neighbors=6),
+        ):
+            result_list = sorted(nq.query(points, query_args))
+            nlist = nq.query(points, query_args).toNeighborList()
+            npt.assert_equal(nlist.query_point_indices, [b[0] for b in result_list])
+            npt.assert_equal(nlist.point_indices, [b[1] for b in result_list])
+            npt.assert_allclose(nlist.distances, [b[2] for b in result_list])
+
+            nlist = nq.query(points, query_args).toNeighborList(True)
+            result_list = sorted(result_list, key=lambda b: (b[0], b[2], b[1]))
+            npt.assert_equal(nlist.query_point_indices, [b[0] for b in result_list])
+            npt.assert_equal(nlist.point_indices, [b[1] for b in result_list])
+            npt.assert_allclose(nlist.distances, [b[2] for b in result_list])
+
     def test_reciprocal(self):
         """Test that, for a random set of points, for each (i, j) neighbor
         pair there also exists a (j, i) neighbor pair for one set of points"""
@@ -457,6 +485,112 @@ class NeighborQueryTest:
                 print(f"Failed neighbor counts, random seed: {seed} (i={i})")
                 raise
 
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_exhaustive_nearest(self, is2D):
+        # Batched nearest neighbor queries must find the same neighbors as an
+        # exhaustive search.
+        L, N, k, r_min = (10, 500, 8, 0.2)
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=1)
+        all_vectors = points[:, np.newaxis, :] - points[np.newaxis, :, :]
+        all_vectors = box.wrap(all_vectors.reshape((-1, 3))).reshape(all_vectors.shape)
+        all_distances = np.linalg.norm(all_vectors, axis=-1)
+        all_distances[all_distances < r_min] = np.inf
+
+        nq = self.build_query_object(box, points, L / 10)
+        nlist = nq.query(
+            points, dict(num_neighbors=k, r_min=r_min, exclude_ii=True)
+        ).toNeighborList()
+        npt.assert_equal(nlist.neighbor_counts, k)
+        for i in range(N):
+            distances = np.sort(nlist.distances[nlist.query_point_indices == i])
+            npt.assert_allclose(
+                distances, np.sort(all_distances[:, i])[:k], rtol=1e-5
+            )
+
+    @pytest.mark.parametrize("is2D", [False, True])
+    def test_sort_query_points(self, is2D):
+        # Processing query points in spatial order must not change the
+        # neighbor lists or the results of computes that loop over all bonds.
+        L, N = (10, 2000)
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=2)
+        _, query_points = freud.data.make_random_system(L, N // 3, is2D=is2D, seed=3)
+        nq = self.build_query_object(box, points, 1.5)
+        assert not nq.sort_query_points
+
+        queries = [
+            (points, dict(r_max=1.5, exclude_ii=True)),
+            (query_points, dict(r_max=1.5)),
+            (points, dict(num_neighbors=6, exclude_ii=True)),
+            (query_points, dict(num_neighbors=6)),
+        ]
+        nlists = [nq.query(qp, qargs).toNeighborList() for qp, qargs in queries]
+        rdf = freud.density.RDF(bins=20, r_max=1.5).compute(nq)
+        bin_counts = rdf.bin_counts.copy()
+
+        nq.sort_query_points = True
+        assert nq.sort_query_points
+        for (qp, qargs), nlist in zip(queries, nlists):
+            sorted_nlist = nq.query(qp, qargs).toNeighborList()
+            npt.assert_array_equal(sorted_nlist[:], nlist[:])
+            npt.assert_array_equal(sorted_nlist.distances, nlist.distances)
+        rdf = freud.density.RDF(bins=20, r_max=1.5).compute(nq)
+        npt.assert_array_equal(rdf.bin_counts, bin_counts)
+
+    @pytest.mark.parametrize(
+        "region",
+        [
+            dict(lower=(0, 0, 0.4), upper=(1, 1, 0.6)),
+            dict(lower=(0.8, 0, 0), upper=(0.2, 1, 1)),
+            dict(center=(0.9, 0.5, 0.5), radius=3),
+        ],
+    )
+    def test_query_region(self, region):
+        box, points = freud.data.make_random_system(10, 2000, seed=4)
+        nq = self.build_query_object(box, points, 2)
+        fractions = box.make_fractional(points)
+        fractions -= np.floor(fractions)
+        if "radius" in region:
+            deltas = box.wrap(points - box.make_absolute(region["center"]))
+            inside = np.linalg.norm(deltas, axis=-1) <= region["radius"]
+        else:
+            lower, upper = np.array(region["lower"]), np.array(region["upper"])
+            inside = np.all(
+                np.where(
+                    lower <= upper,
+                    (fractions >= lower) & (fractions < upper),
+                    (fractions >= lower) | (fractions < upper),
+                ),
+                axis=-1,
+            )
+        assert 0 < np.sum(inside) < len(points)
+
+        for query_args in [dict(r_max=2), dict(num_neighbors=6)]:
+            query_args["exclude_ii"] = True
+            nlist = nq.query(points, query_args).toNeighborList()
+            expected = nlist.copy().filter(inside[nlist.query_point_indices])
+            region_args = dict(query_args, region=region)
+            region_nlist = nq.query(points, region_args).toNeighborList()
+            npt.assert_array_equal(region_nlist[:], expected[:])
+            npt.assert_allclose(region_nlist.distances, expected.distances)
+            assert len(list(nq.query(points, region_args))) == len(expected)
+
+        # The RDF is normalized by the query points inside of the region.
+        rdf = freud.density.RDF(bins=20, r_max=2)
+        rdf.compute(nq, neighbors=dict(r_max=2, exclude_ii=True, region=region))
+        expected_rdf = freud.density.RDF(bins=20, r_max=2)
+        expected_rdf.compute(nq, neighbors=expected)
+        npt.assert_array_equal(rdf.bin_counts, expected_rdf.bin_counts)
+        npt.assert_allclose(
+            rdf.rdf, expected_rdf.rdf * len(points) / np.sum(inside), rtol=1e-5
+        )
+
+        with pytest.raises(ValueError):
+            nq.query(points, dict(r_max=2, region=dict(lower=(0, 0, 0))))
+        with pytest.raises(ValueError):
+            nq.query(
+                points, dict(r_max=2, region=dict(center=(0.5, 0.5, 0.5), radius=0))
+            )
+
     def test_attributes(self):
         """Ensure that mixing old and new APIs throws an error"""
         L = 10
@@ -602,6 +736,71 @@ class TestNeighborQueryAABB(NeighborQueryTest):
     def build_query_object(cls, box, ref_points, r_max=None):
         return freud.locality.AABBQuery(box, ref_points)
 
+    def test_update(self):
+        """Check that updating an AABBQuery gives the same neighbors as
+        constructing a new one."""
+        N = 500
+        L = 10
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        aq = freud.locality.AABBQuery(box, points)
+        ball_args = dict(r_max=1, exclude_ii=True)
+        nearest_args = dict(num_neighbors=6, exclude_ii=True)
+
+        np.random.seed(0)
+        for scale in [0.05, 0.05, 2]:
+            # The last step moves the points far enough to rebuild the tree.
+            points = box.wrap(points + np.random.normal(scale=scale, size=points.shape))
+            aq.update(points)
+            new_aq = freud.locality.AABBQuery(box, points)
+            for query_args in [ball_args, nearest_args]:
+                nlist1 = aq.query(points, query_args).toNeighborList()
+                nlist2 = new_aq.query(points, query_args).toNeighborList()
+                assert nlist_equal(nlist1, nlist2)
+            npt.assert_allclose(aq.points, points)
+
+        # Changing the box and the number of points rebuilds the tree.
+        box, points = freud.data.make_random_system(L * 1.5, 2 * N, seed=1)
+        nlist1 = aq.update(points, box).query(points, ball_args).toNeighborList()
+        nlist2 = (
+            freud.locality.AABBQuery(box, points)
+            .query(points, ball_args)
+            .toNeighborList()
+        )
+        assert nlist_equal(nlist1, nlist2)
+        assert aq.box == box
+
+    @pytest.mark.parametrize("is2D", (False, True))
+    def test_unwrapped_points(self, is2D):
+        """Check that points outside of a triclinic box find the same
+        neighbors as their wrapped positions, since the periodic images
+        searched for each query point depend on the positions of the
+        points."""
+        if is2D:
+            box = freud.box.Box(6, 7, xy=0.3, is2D=True)
+        else:
+            box = freud.box.Box(6, 7, 8, 0.3, 0.2, -0.4)
+        rng = np.random.default_rng(0)
+        fractions = rng.random((500, 3))
+        if is2D:
+            fractions[:, 2] = 0
+        points = box.make_absolute(fractions)
+        images = rng.integers(-1, 2, size=points.shape)
+        if is2D:
+            images[:, 2] = 0
+        unwrapped = box.unwrap(points, images)
+        for query_args in [dict(r_max=1.5), dict(num_neighbors=8, r_max=2.5)]:
+            nlist1 = (
+                freud.locality.AABBQuery(box, points)
+                .query(points, query_args)
+                .toNeighborList()
+            )
+            nlist2 = (
+                freud.locality.AABBQuery(box, unwrapped)
+                .query(points, query_args)
+                .toNeighborList()
+            )
+            assert nlist_equal(nlist1, nlist2)
+
     def test_throws(self):
         """Test that specifying too large an r_max value throws an error"""
         L = 5
@@ -691,6 +890,117 @@ class TestNeighborQueryLinkCell(NeighborQueryTest):
         nlist2 = lc.query(points, dict(r_max=r_max, exclude_ii=True)).toNeighborList()
         assert nlist_equal(nlist1, nlist2)
 
+    def test_update(self):
+        """Check that updating a LinkCell gives the same neighbors as
+        constructing a new one."""
+        N = 500
+        L = 10
+        r_max = 1
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        lc = freud.locality.LinkCell(box, points, 1.0)
+        query_args = dict(r_max=r_max, exclude_ii=True)
+
+        np.random.seed(0)
+        for step in range(5):
+            points = box.wrap(points + np.random.normal(scale=0.05, size=points.shape))
+            nlist1 = lc.update(points).query(points, query_args).toNeighborList()
+            nlist2 = (
+                freud.locality.LinkCell(box, points, 1.0)
+                .query(points, query_args)
+                .toNeighborList()
+            )
+            assert nlist_equal(nlist1, nlist2)
+            npt.assert_allclose(lc.points, points)
+
+        # Changing the box and the number of points rebuilds the cell list.
+        box, points = freud.data.make_random_system(L * 1.5, 2 * N, seed=1)
+        nlist1 = lc.update(points, box).query(points, query_args).toNeighborList()
+        nlist2 = (
+            freud.locality.LinkCell(box, points, 1.0)
+            .query(points, query_args)
+            .toNeighborList()
+        )
+        assert nlist_equal(nlist1, nlist2)
+        assert lc.box == box
+        assert lc.cell_width == 1.0
+
+        # Invalid updates leave the LinkCell unchanged.
+        with pytest.raises(RuntimeError):
+            lc.update(points, freud.box.Box.cube(1.5))
+        assert lc.box == box
+        npt.assert_allclose(lc.points, points)
+
+
+class TestNeighborQueryTyped(NeighborQueryTest):
+    @classmethod
+    def build_query_object(cls, box, ref_points, r_max=None):
+        types = np.arange(len(ref_points)) % 3
+        return freud.locality.TypedNeighborQuery(box, ref_points, types)
+
+    def test_attributes_types(self):
+        box, points = freud.data.make_random_system(10, 100, seed=0)
+        types = np.arange(100) % 3
+        tq = freud.locality.TypedNeighborQuery(box, points, types, n_types=4)
+        npt.assert_array_equal(tq.types, types)
+        assert tq.n_types == 4
+        npt.assert_array_equal(tq.type_counts, [34, 33, 33, 0])
+
+        with pytest.raises(ValueError):
+            freud.locality.TypedNeighborQuery(box, points, types, n_types=2)
+
+    @pytest.mark.parametrize(
+        "query_args",
+        [
+            dict(r_max=2.5, exclude_ii=True),
+            dict(r_max=2.5, r_min=0.5, exclude_ii=False),
+            dict(num_neighbors=6, exclude_ii=True),
+            dict(num_neighbors=6, exclude_ii=False),
+        ],
+    )
+    def test_point_type(self, query_args):
+        """Check that the neighbors of a type match those found by an
+        AABBQuery of the points of that type."""
+        box, points = freud.data.make_random_system(10, 300, seed=0)
+        types = np.random.default_rng(0).integers(0, 3, 300)
+        tq = freud.locality.TypedNeighborQuery(box, points, types)
+
+        all_types = tq.query(points, query_args).toNeighborList()
+        aq = freud.locality.AABBQuery(box, points)
+        assert nlist_equal(all_types, aq.query(points, query_args).toNeighborList())
+
+        for point_type in range(3):
+            nlist = tq.query(
+                points, dict(query_args, point_type=point_type)
+            ).toNeighborList()
+            npt.assert_array_equal(types[nlist.point_indices], point_type)
+
+            # The query points are not excluded from a query of a subset
+            # of the points, so one more neighbor is searched for instead.
+            (subset,) = np.nonzero(types == point_type)
+            subset_args = dict(query_args, exclude_ii=False)
+            if query_args["exclude_ii"] and "num_neighbors" in query_args:
+                subset_args["num_neighbors"] += 1
+            subset_nlist = (
+                freud.locality.AABBQuery(box, points[subset])
+                .query(points, subset_args)
+                .toNeighborList()
+            )
+            expected = {
+                (i, subset[j])
+                for i, j in subset_nlist[:]
+                if not query_args["exclude_ii"] or i != subset[j]
+            }
+            if query_args["exclude_ii"] and "num_neighbors" in query_args:
+                assert {tuple(bond) for bond in nlist[:]} <= expected
+                npt.assert_array_equal(nlist.neighbor_counts, 6)
+            else:
+                assert {tuple(bond) for bond in nlist[:]} == expected
+
+        with pytest.raises(RuntimeError):
+            tq.query(points, dict(r_max=2, point_type=3)).toNeighborList()
+        with pytest.raises(RuntimeError):
+            aq.query(points, dict(r_max=2, point_type=0)).toNeighborList()
+
 
 class TestMultipleMethods:
     """Check that different methods of making a NeighborList give the same
@@ -0,0 +1,74 @@
+import numpy.testing as npt
+import pytest
+
+import freud
+
+
+def _assert_same_nlist(nlist, expected):
+    npt.assert_array_equal(nlist.query_point_indices, expected.query_point_indices)
+    npt.assert_array_equal(nlist.point_indices, expected.point_indices)
+    npt.assert_allclose(nlist.distances, expected.distances, rtol=1e-6)
+
+
+class TestNeighborQueryPlan:
+    QUERIES = [
+        dict(r_max=2.5),
+        dict(r_max=1.5),
+        dict(r_max=2.0, r_min=0.5),
+        dict(num_neighbors=6),
+        dict(num_neighbors=12, exclude_ii=False),
+    ]
+
+    @pytest.mark.parametrize(
+        "nq_class", [freud.locality.AABBQuery, freud.locality.LinkCell]
+    )
+    def test_matches_queries(self, nq_class):
+        box, points = freud.data.make_random_system(10, 1000, seed=0)
+        nq = nq_class(box, points)
+        plan = freud.locality.NeighborQueryPlan()
+        indices = [plan.add_query(query_args) for query_args in self.QUERIES]
+        assert indices == list(range(len(self.QUERIES)))
+        plan.compute(nq)
+        # All queries are served from the widest ball query.
+        assert plan.num_passes == 1
+        for query_args, nlist in zip(self.QUERIES, plan.nlists):
+            query_args = dict(query_args)
+            query_args.setdefault("exclude_ii", True)
+            _assert_same_nlist(nlist, nq.query(points, query_args).toNeighborList())
+
+    def test_query_points(self):
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        _, query_points = freud.data.make_random_system(10, 100, seed=1)
+        nq = freud.locality.AABBQuery(box, points)
+        plan = freud.locality.NeighborQueryPlan()
+        for query_args in self.QUERIES:
+            plan.add_query(query_args)
+        plan.compute(nq, query_points)
+        for query_args, nlist in zip(self.QUERIES, plan.nlists):
+            _assert_same_nlist(
+                nlist, nq.query(query_points, query_args).toNeighborList()
+            )
+
+    def test_nearest_fallback(self):
+        box, points = freud.data.make_random_system(10, 200, seed=0)
+        nq = freud.locality.AABBQuery(box, points)
+        plan = freud.locality.NeighborQueryPlan()
+        # The ball query cannot hold 20 neighbors of every point at this
+        # density, so a single nearest neighbor query serves both.
+        queries = [dict(r_max=1), dict(num_neighbors=20), dict(num_neighbors=8)]
+        for query_args in queries:
+            plan.add_query(query_args)
+        plan.compute(nq)
+        assert plan.num_passes == 2
+        for query_args, nlist in zip(queries, plan.nlists):
+            query_args = dict(query_args, exclude_ii=True)
+            _assert_same_nlist(nlist, nq.query(points, query_args).toNeighborList())
+
+    def test_invalid_query(self):
+        plan = freud.locality.NeighborQueryPlan()
+        with pytest.raises(ValueError):
+            plan.add_query(dict(r_cut=1))
+
+    def test_repr(self):
+        plan = freud.locality.NeighborQueryPlan()
+        assert str(plan) == str(eval(repr(plan)))
@@ -328,6 +328,135 @@ class TestVoronoi:
         )
         npt.assert_allclose(wrapped_distances, vor.nlist.distances)
 
+    @pytest.mark.parametrize("is2D", [True, False])
+    def test_skip_polytopes(self, is2D):
+        # Test that skipping the polytopes leaves the volumes and neighbors
+        # unchanged, including for systems large enough to be split into
+        # blocks
+        L = 30  # Box length
+        N = 40000  # Number of particles
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=1)
+        vor = freud.locality.Voronoi()
+        vor.compute((box, points))
+        volumes = vor.volumes
+        nlist = vor.nlist
+        npt.assert_allclose(np.sum(volumes), box.volume, rtol=1e-6)
+
+        vor.compute((box, points), compute_polytopes=False)
+        npt.assert_equal(len(vor.polytopes), len(points))
+        assert all(len(polytope) == 0 for polytope in vor.polytopes)
+        npt.assert_equal(vor.volumes, volumes)
+        npt.assert_equal(vor.nlist[:], nlist[:])
+        npt.assert_equal(vor.nlist.weights, nlist.weights)
+
+    @pytest.mark.parametrize("is2D", [True, False])
+    def test_update(self, is2D):
+        # Test that updating the cells after moving a few points gives the
+        # same results as computing all cells again
+        L = 10  # Box length
+        N = 4000  # Number of particles
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=2)
+        vor = freud.locality.Voronoi()
+        vor.update((box, points))
+        assert vor.num_computed_cells == N
+
+        vor.update((box, points))
+        assert vor.num_computed_cells == 0
+
+        np.random.seed(3)
+        moved = np.random.choice(N, 10, replace=False)
+        displacements = np.random.uniform(-0.2, 0.2, (len(moved), 3))
+        if is2D:
+            displacements[:, 2] = 0
+        points[moved] = box.wrap(points[moved] + displacements)
+        vor.update((box, points))
+        assert len(moved) <= vor.num_computed_cells < N
+
+        expected = freud.locality.Voronoi().compute((box, points))
+        npt.assert_allclose(vor.volumes, expected.volumes, rtol=1e-5)
+        npt.assert_equal(vor.nlist[:], expected.nlist[:])
+        npt.assert_allclose(vor.nlist.weights, expected.nlist.weights, rtol=1e-5)
+        for polytope, expected_polytope in zip(vor.polytopes, expected.polytopes):
+            npt.assert_allclose(polytope, expected_polytope, atol=1e-6)
+
+    def test_statistics(self):
+        # Test the statistics of the cubic cells of a simple cubic lattice
+        a = 1.5
+        box, points = freud.data.UnitCell.sc().generate_system(4, scale=a)
+        vor = freud.locality.Voronoi()
+        vor.compute((box, points))
+        with pytest.raises(AttributeError):
+            vor.surface_areas
+        with pytest.raises(AttributeError):
+            vor.asphericities
+
+        vor.compute((box, points), compute_statistics=True)
+        N = len(points)
+        npt.assert_allclose(vor.surface_areas, np.full(N, 6 * a ** 2), rtol=1e-5)
+        identity = np.tile(np.eye(3), (N, 1, 1))
+        npt.assert_allclose(vor.surface_tensors, 2 * a ** 2 / 3 * identity, atol=1e-4)
+        npt.assert_allclose(vor.curvature_tensors, np.pi * a / 3 * identity, atol=1e-4)
+        npt.assert_allclose(vor.asphericities, np.ones(N), rtol=1e-4)
+
+    @pytest.mark.parametrize("is2D", [True, False])
+    def test_statistics_random(self, is2D):
+        L = 10  # Box length
+        N = 4000  # Number of particles
+        box, points = freud.data.make_random_system(L, N, is2D=is2D, seed=4)
+        vor = freud.locality.Voronoi()
+        vor.compute((box, points), compute_statistics=True)
+
+        # The surface area of each cell is the sum of its bond weights, and the
+        # trace of the surface tensor is the surface area over the dimension.
+        nlist = vor.nlist
+        weights = np.bincount(
+            nlist.query_point_indices, weights=nlist.weights, minlength=N
+        )
+        npt.assert_allclose(vor.surface_areas, weights, rtol=1e-5)
+        npt.assert_allclose(
+            np.trace(vor.surface_tensors, axis1=1, axis2=2),
+            vor.surface_areas / box.dimensions,
+            rtol=1e-5,
+        )
+        if is2D:
+            # The normal of every polygon turns by a full circle.
+            npt.assert_allclose(
+                np.trace(vor.curvature_tensors, axis1=1, axis2=2),
+                np.full(N, np.pi),
+                rtol=1e-5,
+            )
+            npt.assert_allclose(vor.surface_tensors[:, 2], 0, atol=1e-12)
+        assert np.all(vor.asphericities > 0)
+        assert np.all(vor.asphericities <= 1)
+
+        # Updating the cells after moving a few points gives the same
+        # statistics as computing all cells again.
+        np.random.seed(5)
+        moved = np.random.choice(N, 10, replace=False)
+        displacements = np.random.uniform(-0.2, 0.2, (len(moved), 3))
+        if is2D:
+            displacements[:, 2] = 0
+        points[moved] = box.wrap(points[moved] + displacements)
+        vor.update((box, points), compute_statistics=True)
+        assert vor.num_computed_cells < N
+        expected = freud.locality.Voronoi().compute(
+            (box, points), compute_statistics=True
+        )
+        npt.assert_allclose(vor.surface_areas, expected.surface_areas, rtol=1e-5)
+        npt.assert_allclose(
+            vor.surface_tensors, expected.surface_tensors, rtol=1e-5, atol=1e-8
+        )
+        npt.assert_allclose(
+            vor.curvature_tensors, expected.curvature_tensors, rtol=1e-5, atol=1e-8
+        )
+        npt.assert_allclose(vor.asphericities, expected.asphericities, rtol=1e-4)
+
+        # Turning the statistics off leaves them unavailable.
+        vor.update((box, points))
+        assert vor.num_computed_cells == N
+        with pytest.raises(AttributeError):
+            vor.curvature_tensors
+
     def test_repr(self):
         vor = freud.locality.Voronoi()
         assert str(vor) == str(eval(repr(vor)))
@@ -83,3 +83,88 @@ class TestMSD:
         assert str(msd) == str(eval(repr(msd)))
         msd2 = freud.msd.MSD(box=freud.box.Box(1, 2, 3, 4, 5, 6), mode="direct")
         assert str(msd2) == str(eval(repr(msd2)))
+
+    def test_unwrap(self):
+        """Test that positions are unwrapped with their images."""
+        box = freud.box.Box.cube(5)
+        np.random.seed(0)
+        unwrapped = np.cumsum(np.random.normal(scale=0.5, size=(20, 4, 3)), axis=0)
+        images = np.floor((unwrapped + 2.5) / 5).astype(np.int32)
+        positions = unwrapped - 5 * images
+
+        msd = freud.msd.MSD(box)
+        msd_unwrapped = freud.msd.MSD()
+        npt.assert_allclose(
+            msd.compute(positions, images).msd,
+            msd_unwrapped.compute(unwrapped).msd,
+            atol=1e-4,
+        )
+
+    def test_accumulation_requires_same_frames(self):
+        positions = np.random.rand(10, 3, 3)
+        msd = freud.msd.MSD()
+        msd.compute(positions)
+        with pytest.raises(ValueError):
+            msd.compute(positions[:5], reset=False)
+
+
+class TestMultiTauMSD:
+    def test_attribute_access(self):
+        msd = freud.msd.MultiTauMSD()
+        with pytest.raises(AttributeError):
+            msd.msd
+        with pytest.raises(AttributeError):
+            msd.plot()
+        assert msd._repr_png_() is None
+
+        msd.compute(np.zeros((2, 3)))
+        msd.msd
+        msd.lags
+        msd.counts
+        msd._repr_png_()
+
+    def test_matches_window_mode(self):
+        """Lags measured at every time origin equal the windowed MSD."""
+        np.random.seed(1)
+        num_frames = 100
+        positions = np.cumsum(np.random.normal(size=(num_frames, 5, 3)), axis=0)
+        window_msd = freud.msd.MSD().compute(positions).msd
+
+        points_per_level = 8
+        msd = freud.msd.MultiTauMSD(points_per_level=points_per_level)
+        for i, frame in enumerate(positions):
+            msd.compute(frame, reset=(i == 0))
+        assert msd.num_frames == num_frames
+
+        lags = msd.lags
+        assert lags[0] == 0
+        assert np.all(np.diff(lags) > 0)
+        short = lags < points_per_level
+        npt.assert_allclose(msd.msd[short], window_msd[lags[short]], rtol=1e-4)
+        npt.assert_array_equal(msd.counts[short], num_frames - lags[short])
+
+        # Long lags are averaged over the time origins of their level.
+        for lag, value, count in zip(lags[~short], msd.msd[~short], msd.counts[~short]):
+            spacing = 2
+            while lag // spacing >= points_per_level:
+                spacing *= 2
+            origins = np.arange(0, num_frames - lag, spacing)
+            assert count == len(origins)
+            expected = np.mean(
+                np.sum((positions[origins + lag] - positions[origins]) ** 2, axis=-1)
+            )
+            npt.assert_allclose(value, expected, rtol=1e-4)
+
+    def test_invalid(self):
+        with pytest.raises(ValueError):
+            freud.msd.MultiTauMSD(points_per_level=1)
+        with pytest.raises(ValueError):
+            freud.msd.MultiTauMSD(level_ratio=1)
+        msd = freud.msd.MultiTauMSD()
+        msd.compute(np.zeros((3, 3)))
+        with pytest.raises(ValueError):
+            msd.compute(np.zeros((4, 3)), reset=False)
+
+    def test_repr(self):
+        msd = freud.msd.MultiTauMSD(freud.box.Box.cube(3), points_per_level=4)
+        assert str(msd) == str(eval(repr(msd)))
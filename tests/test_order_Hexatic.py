@@ -218,3 +218,35 @@ class TestHexatic:
         hop._repr_png_()
         hop.plot()
         plt.close("all")
+
+    def test_compute_bond_orders(self):
+        boxlen = 10
+        N = 500
+        box, points = freud.data.make_random_system(boxlen, N, is2D=True, seed=0)
+        query_args = dict(mode="nearest", num_neighbors=6, exclude_ii=True)
+        computes = [
+            freud.order.Hexatic(6),
+            freud.order.Translational(6),
+            freud.order.Steinhardt([4, 6], average=True),
+        ]
+        separate = [
+            freud.order.Hexatic(6),
+            freud.order.Translational(6),
+            freud.order.Steinhardt([4, 6], average=True),
+        ]
+        assert (
+            freud.order.compute_bond_orders((box, points), computes, query_args)
+            == computes
+        )
+        for compute in separate:
+            compute.compute((box, points), query_args)
+        for fused, single in zip(computes, separate):
+            npt.assert_allclose(fused.particle_order, single.particle_order)
+        npt.assert_allclose(computes[2].ql, separate[2].ql)
+
+        with pytest.raises(TypeError):
+            freud.order.compute_bond_orders(
+                (box, points), [freud.order.Nematic([1, 0, 0])]
+            )
+        with pytest.raises(ValueError):
+            freud.order.compute_bond_orders((box, points), [])
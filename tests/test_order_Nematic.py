@@ -91,6 +91,21 @@ class TestNematicOrder:
         npt.assert_allclose(op_perp.nematic_tensor, np.diag([-0.5, 1, -0.5]), atol=1e-1)
         assert not np.all(op_perp.nematic_tensor == np.diag([-0.5, 1, -0.5]))
 
+    def test_skip_particle_tensor(self):
+        np.random.seed(0)
+        orientations = rowan.random.rand(100)
+        u = np.array([1, 0, 0])
+        op = freud.order.Nematic(u)
+        op.compute(orientations)
+        order = op.order
+        nematic_tensor = op.nematic_tensor
+        assert op.particle_tensor.shape == (100, 3, 3)
+
+        op.compute(orientations, compute_particle_tensor=False)
+        npt.assert_allclose(op.order, order, rtol=1e-6)
+        npt.assert_allclose(op.nematic_tensor, nematic_tensor, atol=1e-6)
+        assert op.particle_tensor.shape == (0, 3, 3)
+
     def test_repr(self):
         u = np.array([1, 0, 0])
         op = freud.order.Nematic(u)
@@ -80,6 +80,35 @@ class TestRotationalAutocorrelation:
         npt.assert_allclose(ra2.compute(orientations, orientations).order, 1, rtol=1e-6)
         npt.assert_allclose(ra6.compute(orientations, orientations).order, 1, rtol=1e-6)
 
+    def test_compute_trajectory(self):
+        """Compare the autocorrelation at every lag to pairs of frames."""
+        np.random.seed(7)
+        n_frames, N = 12, 20
+        steps = rowan.normalize(
+            np.array([1, 0, 0, 0]) + 0.2 * np.random.randn(n_frames, N, 4)
+        )
+        orientations = np.empty((n_frames, N, 4))
+        orientations[0] = rowan.random.rand(N)
+        for t in range(1, n_frames):
+            orientations[t] = rowan.multiply(orientations[t - 1], steps[t])
+
+        for l in [2, 6]:
+            ra = freud.order.RotationalAutocorrelation(l)
+            with pytest.raises(AttributeError):
+                ra.autocorrelation
+            ra.compute_trajectory(orientations)
+            assert ra.autocorrelation.shape == (n_frames,)
+
+            pair = freud.order.RotationalAutocorrelation(l)
+            expected = np.zeros(n_frames)
+            for lag in range(n_frames):
+                for t in range(n_frames - lag):
+                    pair.compute(orientations[t], orientations[t + lag])
+                    expected[lag] += pair.order
+                expected[lag] /= n_frames - lag
+            npt.assert_allclose(ra.autocorrelation, expected, atol=1e-5)
+            npt.assert_allclose(ra.autocorrelation[0], 1, rtol=1e-5)
+
     def test_repr(self):
         ra2 = freud.order.RotationalAutocorrelation(2)
         assert str(ra2) == str(eval(repr(ra2)))
@@ -330,9 +330,41 @@ class TestSteinhardt:
             npt.assert_allclose(w6.particle_order[0], w6_unrotated_order, rtol=1e-5)
             npt.assert_allclose(w6.particle_order[0], PERFECT_FCC_W6, rtol=1e-5)
 
+    @pytest.mark.parametrize("average", [False, True])
+    @pytest.mark.parametrize("wl", [False, True])
+    def test_multiple_l(self, average, wl):
+        """Computing several l together matches computing each l alone."""
+        box, points = freud.data.UnitCell.fcc().generate_system(
+            4, sigma_noise=0.05, seed=0
+        )
+        ls = [4, 6, 8]
+        neighbors = {"num_neighbors": 12, "exclude_ii": True}
+        comp = freud.order.Steinhardt(ls, average=average, wl=wl)
+        comp.compute((box, points), neighbors=neighbors)
+        assert comp.l == ls
+        assert comp.particle_order.shape == (len(points), len(ls))
+        assert comp.ql.shape == (len(points), len(ls))
+        assert len(comp.order) == len(ls)
+        assert len(comp.particle_harmonics) == len(ls)
+        for l_index, sph_l in enumerate(ls):
+            single = freud.order.Steinhardt(sph_l, average=average, wl=wl)
+            single.compute((box, points), neighbors=neighbors)
+            npt.assert_allclose(
+                comp.particle_order[:, l_index], single.particle_order, atol=1e-6
+            )
+            npt.assert_allclose(comp.ql[:, l_index], single.ql, atol=1e-6)
+            npt.assert_allclose(comp.order[l_index], single.order, atol=1e-6)
+            npt.assert_allclose(
+                comp.particle_harmonics[l_index], single.particle_harmonics, atol=1e-6
+            )
+        comp.plot()
+        plt.close("all")
+
     def test_repr(self):
         comp = freud.order.Steinhardt(6)
         assert str(comp) == str(eval(repr(comp)))
+        comp = freud.order.Steinhardt([4, 6])
+        assert str(comp) == str(eval(repr(comp)))
         # Use non-default arguments for all parameters
         comp = freud.order.Steinhardt(6, average=True, wl=True, weighted=True)
         assert str(comp) == str(eval(repr(comp)))
@@ -1,3 +1,8 @@
+import concurrent.futures
+
+import numpy.testing as npt
+import pytest
+
 import freud
 
 
@@ -30,3 +35,126 @@ class TestParallel:
         # After the context manager, the number of threads should revert
         # to its previous value.
         assert freud.parallel.get_num_threads() == 1
+
+    def test_concurrent_computes(self):
+        """Test computes running concurrently from Python threads."""
+        query_args = dict(r_max=3, exclude_ii=True)
+
+        def compute_rdf(seed):
+            frame_box, frame_points = freud.data.make_random_system(
+                10, 500, seed=seed
+            )
+            rdf = freud.density.RDF(50, 3)
+            rdf.compute((frame_box, frame_points), neighbors=query_args)
+            return rdf.bin_counts
+
+        expected = [compute_rdf(seed) for seed in range(8)]
+        with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+            results = list(executor.map(compute_rdf, range(8)))
+        for result, expected_result in zip(results, expected):
+            npt.assert_array_equal(result, expected_result)
+
+    @pytest.mark.parametrize("compact", [False, True])
+    def test_concurrent_shared_nlist(self, compact):
+        """Test computes sharing a NeighborList that is updated lazily."""
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        query_args = dict(r_max=3, exclude_ii=True)
+        nlist = (
+            freud.locality.AABBQuery(box, points)
+            .query(points, query_args)
+            .toNeighborList()
+        )
+        rdf = freud.density.RDF(50, 3)
+        expected = rdf.compute((box, points), neighbors=nlist).bin_counts.copy()
+
+        def compute_rdf(shared_nlist):
+            rdf = freud.density.RDF(50, 3)
+            rdf.compute((box, points), neighbors=shared_nlist)
+            # Reading the bonds converts a compact list to the full layout.
+            assert len(shared_nlist.point_indices) == len(nlist)
+            return rdf.bin_counts
+
+        for _ in range(4):
+            shared_nlist = freud.locality.NeighborList.from_arrays(
+                len(points),
+                len(points),
+                nlist.query_point_indices,
+                nlist.point_indices,
+                nlist.distances,
+            )
+            if compact:
+                shared_nlist.compact()
+            with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+                results = list(executor.map(compute_rdf, [shared_nlist] * 8))
+            for result in results:
+                npt.assert_array_equal(result, expected)
+
+    def test_task_arena(self):
+        """Test running computes in task arenas."""
+        nodes = freud.parallel.get_numa_nodes()
+        assert len(nodes) > 0
+
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        query_args = dict(r_max=3, exclude_ii=True)
+        rdf = freud.density.RDF(50, 3)
+        expected = rdf.compute((box, points), neighbors=query_args).bin_counts.copy()
+
+        arena = freud.parallel.TaskArena(num_threads=2)
+        assert arena.numa_node == -1
+        assert arena.num_threads == 2
+        assert not arena.pin_threads
+        with arena:
+            rdf.compute((box, points), neighbors=query_args)
+        npt.assert_array_equal(rdf.bin_counts, expected)
+
+        # One arena per NUMA node, entered from several Python threads.
+        arenas = [
+            freud.parallel.TaskArena(
+                numa_node=None if node == -1 else node, pin_threads=True
+            )
+            for node in nodes
+        ]
+
+        def compute_in_arena(index):
+            with arenas[index % len(arenas)]:
+                return freud.density.RDF(50, 3).compute(
+                    (box, points), neighbors=query_args
+                ).bin_counts
+
+        with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+            results = list(executor.map(compute_in_arena, range(len(arenas))))
+        for result in results:
+            npt.assert_array_equal(result, expected)
+
+    def test_loop_policy(self):
+        """Test that loop policies do not change the results of computes."""
+        assert freud.parallel.get_loop_policy() == ("auto", 1)
+
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        query_args = dict(r_max=3, exclude_ii=True)
+        rdf = freud.density.RDF(50, 3)
+        ld = freud.density.LocalDensity(3, 1)
+        rdf.compute((box, points), neighbors=query_args)
+        expected_rdf = rdf.bin_counts.copy()
+        expected_ld = ld.compute((box, points)).density.copy()
+
+        try:
+            for partitioner in ["auto", "simple", "static"]:
+                for grain_size in [1, 7, 1000]:
+                    freud.parallel.set_loop_policy(partitioner, grain_size)
+                    assert freud.parallel.get_loop_policy() == (
+                        partitioner,
+                        grain_size,
+                    )
+                    rdf.compute((box, points), neighbors=query_args)
+                    npt.assert_array_equal(rdf.bin_counts, expected_rdf)
+                    ld.compute((box, points))
+                    npt.assert_allclose(ld.density, expected_ld)
+
+            with pytest.raises(ValueError):
+                freud.parallel.set_loop_policy("affinity")
+            with pytest.raises(ValueError):
+                freud.parallel.set_loop_policy("simple", 0)
+        finally:
+            freud.parallel.set_loop_policy()
+        assert freud.parallel.get_loop_policy() == ("auto", 1)
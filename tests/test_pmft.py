@@ -188,6 +188,26 @@ class PMFTTestBase:
 
         assert np.isclose(np.nanmean(rdf), 1, rtol=2e-2, atol=2e-2)
 
+    def test_lazy_reduction(self):
+        """Verify that the outputs do not depend on the order they are read."""
+        N = 500
+        system = freud.data.make_random_system(10, N, self.ndim == 2, seed=0)
+        orientations = (
+            rowan.random.rand(N) if self.ndim == 3 else np.random.rand(N) * 2 * np.pi
+        )
+        counts_first = self.make_pmft()
+        pmft_first = self.make_pmft()
+        for _ in range(2):
+            counts_first.compute(system, orientations, reset=False)
+            pmft_first.compute(system, orientations, reset=False)
+            bin_counts = np.copy(counts_first.bin_counts)
+            npt.assert_array_equal(counts_first.bin_counts, bin_counts)
+            pmft = np.copy(pmft_first.pmft)
+            npt.assert_array_equal(pmft_first.bin_counts, bin_counts)
+            npt.assert_array_equal(counts_first.pmft, pmft)
+            with np.errstate(divide="ignore"):
+                npt.assert_allclose(pmft, -np.log(pmft_first._pcf), rtol=1e-6)
+
 
 class PMFT2DTestBase(PMFTTestBase):
     def test_2d_box_3d_points(self):
@@ -918,6 +938,73 @@ class TestPMFTXYZ(PMFTTestBase):
         )
         npt.assert_array_equal(points_to_set(pmft.bin_counts), bins)
 
+    def test_accumulation_strategies(self):
+        box, points = freud.data.make_random_system(self.L, 100, seed=0)
+        orientations = rowan.random.rand(len(points))
+        pmft = freud.pmft.PMFTXYZ(*self.limits, self.bins)
+        pmft.compute((box, points), orientations)
+        # Few bonds in many bins are not accumulated into dense copies.
+        assert pmft.accumulation_strategy in ("atomic", "tiled")
+        expected = pmft.bin_counts.copy()
+
+        for strategy in ["dense", "atomic", "tiled"]:
+            pmft = freud.pmft.PMFTXYZ(*self.limits, self.bins)
+            pmft.accumulation_strategy = strategy
+            pmft.compute((box, points), orientations)
+            assert pmft.accumulation_strategy == strategy
+            npt.assert_array_equal(pmft.bin_counts, expected)
+
+    def test_cubic_equiv_orientations(self):
+        """Test that the rotations of a cube are binned like any other
+        equivalent orientations, although they are folded into the orbits of
+        the bins."""
+        # The 24 rotations of a cube.
+        equiv_orientations = [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, 0], [0, 0, 0, 1]]
+        for i in range(4):
+            for j in range(i + 1, 4):
+                for sign in [1, -1]:
+                    q = np.zeros(4)
+                    q[i], q[j] = 1, sign
+                    equiv_orientations.append(q / np.sqrt(2))
+        for signs in np.ndindex(2, 2, 2):
+            equiv_orientations.append(
+                np.concatenate([[1], 1 - 2 * np.asarray(signs)]) / 2
+            )
+        equiv_orientations = np.asarray(equiv_orientations, dtype=np.float32)
+
+        # Bonds near the centers of bins, seen from query points rotated like
+        # the cube, are binned far from the bin edges.
+        max_width = 3
+        nbins = 12
+        width = 2 * max_width / nbins
+        np.random.seed(0)
+        num_query_points = 100
+        bins = np.random.randint(nbins, size=(num_query_points, 3))
+        jitter = np.random.uniform(-0.2, 0.2, size=(num_query_points, 3))
+        bond_vectors = -max_width + (bins + 0.5 + jitter) * width
+        query_orientations = equiv_orientations[
+            np.random.randint(len(equiv_orientations), size=num_query_points)
+        ]
+        points = np.zeros((1, 3), dtype=np.float32)
+        query_points = -rowan.rotate(query_orientations, bond_vectors)
+
+        pmft = freud.pmft.PMFTXYZ(max_width, max_width, max_width, nbins)
+        pmft.compute(
+            (freud.box.Box.cube(self.L), points),
+            query_orientations,
+            query_points,
+            neighbors={"mode": "ball", "r_max": 2 * max_width},
+            equiv_orientations=equiv_orientations,
+        )
+
+        edges = np.linspace(-max_width, max_width, nbins + 1)
+        expected = np.zeros((nbins, nbins, nbins))
+        for q in equiv_orientations:
+            expected += np.histogramdd(
+                rowan.rotate(q, bond_vectors), bins=(edges, edges, edges)
+            )[0]
+        npt.assert_array_equal(pmft.bin_counts, expected)
+
 
 class TestPMFTR12ManagedArray(ManagedArrayTestBase):
     def build_object(self):
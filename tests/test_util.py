@@ -1,3 +1,4 @@
+import json
 from collections import namedtuple
 
 import numpy as np
@@ -117,3 +118,136 @@ class TestCommon:
         npt.assert_allclose(box.xz, 5, rtol=1e-6, err_msg="TiltXZFail")
         npt.assert_allclose(box.yz, 6, rtol=1e-6, err_msg="TiltYZFail")
         assert box.dimensions == 3
+
+    def test_buffer_pool(self):
+        box, points = freud.data.make_random_system(10, 100, seed=0)
+        gd = freud.density.GaussianDensity(32, 2, 1)
+        gd.compute((box, points))
+        freud.util.get_buffer_pool_statistics(reset=True)
+        for _ in range(3):
+            # Holding a view of the density forces the next compute to allocate
+            # a new array, and releasing it returns the memory to the pool.
+            density = gd.density
+            gd.compute((box, points))
+            npt.assert_allclose(gd.density, density, rtol=1e-6)
+        del density
+        stats = freud.util.get_buffer_pool_statistics()
+        assert stats["reuses"] > 0
+        assert stats["cached_bytes"] > 0
+
+        try:
+            freud.util.set_buffer_pool_limit(0)
+            assert freud.util.get_buffer_pool_statistics()["cached_bytes"] == 0
+            freud.util.get_buffer_pool_statistics(reset=True)
+            for _ in range(3):
+                density = gd.density
+                gd.compute((box, points))
+            assert freud.util.get_buffer_pool_statistics()["reuses"] == 0
+        finally:
+            freud.util.set_buffer_pool_limit(2**30)
+
+    def test_profile(self, tmp_path):
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        query_args = dict(r_max=3, exclude_ii=True)
+        rdf = freud.density.RDF(50, 3)
+        assert not freud.util.is_profiling_enabled()
+        rdf.compute((box, points), neighbors=query_args)
+        assert rdf.profile == {}
+
+        try:
+            freud.util.set_profiling_enabled()
+            assert freud.util.is_profiling_enabled()
+            for _ in range(2):
+                rdf.compute((box, points), neighbors=query_args, reset=False)
+            rdf.bin_counts
+        finally:
+            freud.util.set_profiling_enabled(False)
+
+        profile = rdf.profile
+        assert profile["compute"]["calls"] == 2
+        assert profile["compute"]["time"] > 0
+        assert profile["output"]["calls"] == 1
+        if freud.util.is_profiling_available():
+            num_bonds = len(
+                freud.locality.AABBQuery(box, points)
+                .query(points, query_args)
+                .toNeighborList()
+            )
+            assert profile["bonds"]["count"] == 2 * num_bonds
+            assert profile["bond loop"]["calls"] == 2
+            assert profile["reduction"]["calls"] == 1
+
+        filename = str(tmp_path / "trace.json")
+        freud.util.export_chrome_trace(filename, [rdf, freud.density.RDF(50, 3)])
+        with open(filename) as trace_file:
+            events = json.load(trace_file)["traceEvents"]
+        compute_events = [event for event in events if event["name"] == "compute"]
+        assert len(compute_events) == 2
+        assert all(event["pid"] == 0 for event in compute_events)
+
+        rdf.reset_profile()
+        assert rdf.profile == {}
+
+    def test_compute_async(self):
+        frames = [freud.data.make_random_system(10, 300, seed=i) for i in range(4)]
+        query_args = dict(num_neighbors=12, exclude_ii=True)
+
+        # The inputs are copied, so the buffer can be overwritten at once.
+        buffer = np.empty_like(frames[0][1])
+        rdf = freud.density.RDF(50, 3)
+        ql = freud.order.Steinhardt(6)
+        rdf_futures = []
+        ql_futures = []
+        for box, points in frames:
+            buffer[:] = points
+            rdf_futures.append(rdf.compute_async((box, buffer), reset=False))
+            ql_futures.append(
+                ql.compute_async(
+                    (box, buffer),
+                    neighbors=query_args,
+                    result=lambda ql: ql.particle_order.copy(),
+                )
+            )
+            buffer[:] = 0
+        assert all(future.result() is rdf for future in rdf_futures)
+
+        expected_rdf = freud.density.RDF(50, 3)
+        expected_ql = freud.order.Steinhardt(6)
+        for system, future in zip(frames, ql_futures):
+            expected_rdf.compute(system, reset=False)
+            expected_ql.compute(system, neighbors=query_args)
+            npt.assert_allclose(future.result(), expected_ql.particle_order)
+        npt.assert_array_equal(rdf.bin_counts, expected_rdf.bin_counts)
+
+        # Systems are resolved when the compute is submitted, so a reused
+        # frame object or the buffer of a NeighborQuery can be changed at once.
+        class Frame:
+            pass
+
+        frame = Frame()
+        frame.box, frame.points = frames[0][0], frames[0][1].copy()
+        buffer[:] = frames[1][1]
+        nq = freud.locality._RawPoints(frames[1][0], buffer)
+        frame_future = ql.compute_async(
+            frame, neighbors=query_args, result=lambda ql: ql.particle_order.copy()
+        )
+        nq_future = ql.compute_async(
+            system=nq, neighbors=query_args, result=lambda ql: ql.particle_order.copy()
+        )
+        frame.box, frame.points[:] = frames[2][0], 0
+        buffer[:] = 0
+        for system, future in zip(frames, [frame_future, nq_future]):
+            expected_ql.compute(system, neighbors=query_args)
+            npt.assert_allclose(future.result(), expected_ql.particle_order)
+
+        arena = freud.parallel.TaskArena(num_threads=2)
+        future = ql.compute_async(frames[0], neighbors=query_args, arena=arena)
+        assert future.result() is ql
+
+        # Errors of the compute are raised by the future, and do not stop the
+        # following computes.
+        future = ql.compute_async((frames[0][0], np.zeros((10, 2))))
+        following = ql.compute_async(frames[0], neighbors=query_args)
+        with pytest.raises(ValueError):
+            future.result()
+        assert following.result() is ql